@@ -510,6 +510,7 @@ static int __kprobes do_page_fault(unsigned long far, unsigned long esr,
 	unsigned int mm_flags = FAULT_FLAG_DEFAULT;
 	unsigned long addr = untagged_addr(far);
 	struct vm_area_struct *vma;
+	bool vma_retried = false;
 	int si_code;
 
 	if (kprobe_page_fault(regs, esr))
@@ -564,6 +565,7 @@ static int __kprobes do_page_fault(unsigned long far, unsigned long esr,
 	if (!(mm_flags & FAULT_FLAG_USER))
 		goto lock_mmap;
 
+retry_vma:
 	vma = lock_vma_under_rcu(mm, addr);
 	if (!vma)
 		goto lock_mmap;
@@ -593,6 +595,18 @@ static int __kprobes do_page_fault(unsigned long far, unsigned long esr,
 			goto no_context;
 		return 0;
 	}
+
+	/*
+	 * The lock was most likely dropped to wait for I/O or for
+	 * userfaultfd, which is done now. Try once more under the VMA
+	 * lock before taking mmap_lock. FAULT_FLAG_TRIED keeps the second
+	 * attempt from dropping the lock again.
+	 */
+	if (!vma_retried) {
+		vma_retried = true;
+		mm_flags |= FAULT_FLAG_TRIED;
+		goto retry_vma;
+	}
 lock_mmap:
 
 retry:
@@ -1331,6 +1331,60 @@ static void gcm_process_assoc(const struct aes_gcm_key *key, u8 ghash_acc[16],
 		aes_gcm_aad_update(key, ghash_acc, buf, pos, flags);
 }
 
+/*
+ * Requests whose associated data, text and tag are each in a single segment of
+ * up to this size are processed directly, without a skcipher_walk.  This
+ * covers the largest TLS record; longer requests use the walk, which lets us
+ * leave the FPU section between pages.
+ */
+#define GCM_LINEAR_MAX	(16384 + 256)
+
+static bool gcm_is_linear(struct scatterlist *sg, unsigned int len)
+{
+	return len <= GCM_LINEAR_MAX && sg->length >= len &&
+	       !PageHighMem(sg_page(sg));
+}
+
+/*
+ * En/decrypt a request whose src and dst are each one linear buffer, e.g. an
+ * ESP packet or a TLS record in a linear skb.  This avoids the walk and the
+ * scatterlist copies of the tag, and does everything in one FPU section.
+ */
+static __always_inline int
+gcm_crypt_linear(struct aead_request *req, const struct aes_gcm_key *key,
+		 u32 le_ctr[4], unsigned int assoclen, int taglen, int flags)
+{
+	const u8 *src = sg_virt(req->src);
+	u8 *dst = sg_virt(req->dst);
+	unsigned int datalen = req->cryptlen;
+	u8 ghash_acc[16];
+	u8 tag[16];
+	int err = 0;
+
+	if (!(flags & FLAG_ENC)) {
+		datalen -= taglen;
+		memcpy(tag, src + req->assoclen + datalen, taglen);
+	}
+
+	kernel_fpu_begin();
+	memset(ghash_acc, 0, sizeof(ghash_acc));
+	if (assoclen)
+		aes_gcm_aad_update(key, ghash_acc, src, assoclen, flags);
+	if (datalen)
+		aes_gcm_update(key, le_ctr, ghash_acc, src + req->assoclen,
+			       dst + req->assoclen, datalen, flags);
+	if (flags & FLAG_ENC)
+		aes_gcm_enc_final(key, le_ctr, ghash_acc, assoclen, datalen,
+				  flags);
+	else if (!aes_gcm_dec_final(key, le_ctr, ghash_acc, assoclen,
+				    datalen, tag, taglen, flags))
+		err = -EBADMSG;
+	kernel_fpu_end();
+
+	if (flags & FLAG_ENC)
+		memcpy(dst + req->assoclen + datalen, ghash_acc, taglen);
+	return err;
+}
 
 /* __always_inline to optimize out the branches based on @flags */
 static __always_inline int
@@ -1361,6 +1415,13 @@ gcm_crypt(struct aead_request *req, int flags)
 		le_ctr[3] = get_unaligned_be32(req->iv + 0);
 	}
 
+	taglen = crypto_aead_authsize(tfm);
+	if (gcm_is_linear(req->src, req->assoclen + req->cryptlen) &&
+	    gcm_is_linear(req->dst, req->assoclen + req->cryptlen +
+				    ((flags & FLAG_ENC) ? taglen : -taglen)))
+		return gcm_crypt_linear(req, key, le_ctr, assoclen, taglen,
+					flags);
+
 	/* Begin walking through the plaintext or ciphertext. */
 	if (flags & FLAG_ENC)
 		err = skcipher_walk_aead_encrypt(&walk, req, false);
@@ -1414,7 +1475,6 @@ gcm_crypt(struct aead_request *req, int flags)
 		goto out;
 
 	/* Finalize */
-	taglen = crypto_aead_authsize(tfm);
 	if (flags & FLAG_ENC) {
 		/* Finish computing the auth tag. */
 		aes_gcm_enc_final(key, le_ctr, ghash_acc, assoclen,
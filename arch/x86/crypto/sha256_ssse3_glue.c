@@ -40,6 +40,7 @@
 #include <linux/string.h>
 #include <asm/cpu_device_id.h>
 #include <asm/simd.h>
+#include <asm/unaligned.h>
 
 asmlinkage void sha256_transform_ssse3(struct sha256_state *state,
 				       const u8 *data, int blocks);
@@ -357,6 +358,91 @@ static int sha256_ni_digest(struct shash_desc *desc, const u8 *data,
 	       sha256_ni_finup(desc, data, len, out);
 }
 
+asmlinkage void sha256_ni_transform2x(u32 *state_a, u32 *state_b,
+				      const u8 *data_a, const u8 *data_b,
+				      size_t nblocks);
+
+/*
+ * Finish two messages of the same length, which continue from the same state
+ * in @desc, with the 2-way interleaved transform.
+ */
+static int sha256_ni_finup_mb(struct shash_desc *desc,
+			      const u8 * const data[], unsigned int len,
+			      u8 * const outs[], unsigned int num_msgs)
+{
+	struct sha256_state *sctx = shash_desc_ctx(desc);
+	unsigned int partial = sctx->count % SHA256_BLOCK_SIZE;
+	u8 blocks[2][2 * SHA256_BLOCK_SIZE];
+	const u8 *a = data[0], *b = data[1];
+	__be64 bits = cpu_to_be64((sctx->count + len) << 3);
+	u32 state_a[8], state_b[8];
+	unsigned int nblocks;
+	unsigned int i;
+
+	if (!crypto_simd_usable()) {
+		struct sha256_state orig = *sctx;
+		int err = 0;
+
+		for (i = 0; i < num_msgs && !err; i++) {
+			*sctx = orig;
+			err = crypto_sha256_finup(desc, data[i], len, outs[i]);
+		}
+		return err;
+	}
+
+	memcpy(state_a, sctx->state, sizeof(state_a));
+	memcpy(state_b, sctx->state, sizeof(state_b));
+
+	kernel_fpu_begin();
+
+	if (partial && partial + len >= SHA256_BLOCK_SIZE) {
+		unsigned int n = SHA256_BLOCK_SIZE - partial;
+
+		memcpy(blocks[0], sctx->buf, partial);
+		memcpy(&blocks[0][partial], a, n);
+		memcpy(blocks[1], sctx->buf, partial);
+		memcpy(&blocks[1][partial], b, n);
+		sha256_ni_transform2x(state_a, state_b, blocks[0], blocks[1], 1);
+		a += n;
+		b += n;
+		len -= n;
+		partial = 0;
+	}
+
+	nblocks = len / SHA256_BLOCK_SIZE;
+	sha256_ni_transform2x(state_a, state_b, a, b, nblocks);
+	a += nblocks * SHA256_BLOCK_SIZE;
+	b += nblocks * SHA256_BLOCK_SIZE;
+	len %= SHA256_BLOCK_SIZE;
+
+	/* What is left of the buffer and the data, then the padding */
+	memset(blocks, 0, sizeof(blocks));
+	memcpy(blocks[0], sctx->buf, partial);
+	memcpy(&blocks[0][partial], a, len);
+	memcpy(blocks[1], sctx->buf, partial);
+	memcpy(&blocks[1][partial], b, len);
+	blocks[0][partial + len] = 0x80;
+	blocks[1][partial + len] = 0x80;
+	nblocks = partial + len < SHA256_BLOCK_SIZE - sizeof(bits) ? 1 : 2;
+	memcpy(&blocks[0][nblocks * SHA256_BLOCK_SIZE - sizeof(bits)],
+	       &bits, sizeof(bits));
+	memcpy(&blocks[1][nblocks * SHA256_BLOCK_SIZE - sizeof(bits)],
+	       &bits, sizeof(bits));
+	sha256_ni_transform2x(state_a, state_b, blocks[0], blocks[1], nblocks);
+
+	kernel_fpu_end();
+
+	for (i = 0; i < 8; i++) {
+		put_unaligned_be32(state_a[i], outs[0] + i * sizeof(__be32));
+		put_unaligned_be32(state_b[i], outs[1] + i * sizeof(__be32));
+	}
+
+	memzero_explicit(blocks, sizeof(blocks));
+	memzero_explicit(state_a, sizeof(state_a));
+	memzero_explicit(state_b, sizeof(state_b));
+	return 0;
+}
+
 static struct shash_alg sha256_ni_algs[] = { {
 	.digestsize	=	SHA256_DIGEST_SIZE,
 	.init		=	sha256_base_init,
@@ -364,6 +450,8 @@ static struct shash_alg sha256_ni_algs[] = { {
 	.final		=	sha256_ni_final,
 	.finup		=	sha256_ni_finup,
 	.digest		=	sha256_ni_digest,
+	.finup_mb	=	sha256_ni_finup_mb,
+	.mb_max_msgs	=	2,
 	.descsize	=	sizeof(struct sha256_state),
 	.base		=	{
 		.cra_name	=	"sha256",
@@ -41,6 +41,12 @@ int __vdso_clock_gettime(clockid_t clock, struct __kernel_timespec *ts)
 int clock_gettime(clockid_t, struct __kernel_timespec *)
 	__attribute__((weak, alias("__vdso_clock_gettime")));
 
+int __vdso_clock_gettime_multi(const clockid_t *clocks,
+			       struct __kernel_timespec *ts, unsigned int nr)
+{
+	return __cvdso_clock_gettime_multi(clocks, ts, nr);
+}
+
 int __vdso_clock_getres(clockid_t clock,
 			struct __kernel_timespec *res)
 {
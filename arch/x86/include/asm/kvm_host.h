@@ -1556,6 +1556,15 @@ struct kvm_vm_stat {
 		};
 		atomic64_t pages[KVM_NR_PAGE_SIZES];
 	};
+	/* KVM_PRE_FAULT_MEMORY mappings, by the level they were made at */
+	union {
+		struct {
+			atomic64_t pre_fault_4k;
+			atomic64_t pre_fault_2m;
+			atomic64_t pre_fault_1g;
+		};
+		atomic64_t pre_fault[KVM_NR_PAGE_SIZES];
+	};
 	u64 nx_lpage_splits;
 	u64 max_mmu_page_hash_collisions;
 	u64 max_mmu_rmap_size;
@@ -1581,6 +1590,7 @@ struct kvm_vcpu_stat {
 	u64 nmi_window_exits;
 	u64 l1d_flush;
 	u64 halt_exits;
+	u64 halt_fastpath_exits;
 	u64 request_irq_exits;
 	u64 irq_exits;
 	u64 host_state_reload;
@@ -1598,6 +1608,7 @@ struct kvm_vcpu_stat {
 	u64 preemption_other;
 	u64 guest_mode;
 	u64 notify_window_exits;
+	u64 fastpath_exits;
 };
 
 struct x86_instruction_info;
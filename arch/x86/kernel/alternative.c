@@ -2226,7 +2226,11 @@ noinstr int poke_int3_handler(struct pt_regs *regs)
 	return ret;
 }
 
-#define TP_VEC_MAX (PAGE_SIZE / sizeof(struct text_poke_loc))
+/*
+ * Every batch costs three rounds of IPIs to all CPUs, and enabling ftrace
+ * on many functions at once goes through here in batches of TP_VEC_MAX.
+ */
+#define TP_VEC_MAX (4 * PAGE_SIZE / sizeof(struct text_poke_loc))
 static struct text_poke_loc tp_vec[TP_VEC_MAX];
 static int tp_vec_nr;
 
@@ -4764,6 +4764,9 @@ long kvm_arch_vcpu_pre_fault_memory(struct kvm_vcpu *vcpu,
 	if (r < 0)
 		return r;
 
+	if (level <= KVM_NR_PAGE_SIZES)
+		atomic64_inc(&vcpu->kvm->stat.pre_fault[level - 1]);
+
 	/*
 	 * If the mapping that covers range->gpa can use a huge page, it
 	 * may start below it or end after range->gpa + range->size.
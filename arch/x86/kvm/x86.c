@@ -241,6 +241,9 @@ const struct _kvm_stats_desc kvm_vm_stats_desc[] = {
 	STATS_DESC_ICOUNTER(VM, pages_4k),
 	STATS_DESC_ICOUNTER(VM, pages_2m),
 	STATS_DESC_ICOUNTER(VM, pages_1g),
+	STATS_DESC_COUNTER(VM, pre_fault_4k),
+	STATS_DESC_COUNTER(VM, pre_fault_2m),
+	STATS_DESC_COUNTER(VM, pre_fault_1g),
 	STATS_DESC_ICOUNTER(VM, nx_lpage_splits),
 	STATS_DESC_PCOUNTER(VM, max_mmu_rmap_size),
 	STATS_DESC_PCOUNTER(VM, max_mmu_page_hash_collisions)
@@ -274,6 +277,7 @@ const struct _kvm_stats_desc kvm_vcpu_stats_desc[] = {
 	STATS_DESC_COUNTER(VCPU, nmi_window_exits),
 	STATS_DESC_COUNTER(VCPU, l1d_flush),
 	STATS_DESC_COUNTER(VCPU, halt_exits),
+	STATS_DESC_COUNTER(VCPU, halt_fastpath_exits),
 	STATS_DESC_COUNTER(VCPU, request_irq_exits),
 	STATS_DESC_COUNTER(VCPU, irq_exits),
 	STATS_DESC_COUNTER(VCPU, host_state_reload),
@@ -291,6 +295,7 @@ const struct _kvm_stats_desc kvm_vcpu_stats_desc[] = {
 	STATS_DESC_COUNTER(VCPU, preemption_other),
 	STATS_DESC_IBOOLEAN(VCPU, guest_mode),
 	STATS_DESC_COUNTER(VCPU, notify_window_exits),
+	STATS_DESC_COUNTER(VCPU, fastpath_exits),
 };
 
 const struct kvm_stats_header kvm_vcpu_stats_header = {
@@ -11103,6 +11108,8 @@ static int vcpu_enter_guest(struct kvm_vcpu *vcpu)
 
 		exit_fastpath = kvm_x86_call(vcpu_run)(vcpu,
 						       req_immediate_exit);
+		if (exit_fastpath != EXIT_FASTPATH_NONE)
+			++vcpu->stat.fastpath_exits;
 		if (likely(exit_fastpath != EXIT_FASTPATH_REENTER_GUEST))
 			break;
 
@@ -13217,6 +13224,31 @@ int kvm_arch_vcpu_runnable(struct kvm_vcpu *vcpu)
 	return kvm_vcpu_running(vcpu) || kvm_vcpu_has_events(vcpu);
 }
 
+/*
+ * The fast path for HLT with a wake event already pending, e.g. an idle
+ * guest which halts right after an IPI was posted to it.  Skip the HLT and
+ * leave the vCPU runnable, instead of marking it halted only for the run
+ * loop to find it runnable again after going through kvm_vcpu_halt().  The
+ * pending event is injected by the next vcpu_enter_guest() as usual.
+ */
+fastpath_t handle_fastpath_hlt(struct kvm_vcpu *vcpu)
+{
+	if (!lapic_in_kernel(vcpu) ||
+	    (vcpu->guest_debug & KVM_GUESTDBG_SINGLESTEP))
+		return EXIT_FASTPATH_NONE;
+
+	if (!kvm_vcpu_has_events(vcpu))
+		return EXIT_FASTPATH_NONE;
+
+	kvm_skip_emulated_instruction(vcpu);
+	vcpu->arch.pv.pv_unhalted = false;
+	++vcpu->stat.halt_exits;
+	++vcpu->stat.halt_fastpath_exits;
+
+	return EXIT_FASTPATH_EXIT_HANDLED;
+}
+EXPORT_SYMBOL_GPL(handle_fastpath_hlt);
+
 bool kvm_arch_dy_has_pending_interrupt(struct kvm_vcpu *vcpu)
 {
 	return kvm_vcpu_apicv_active(vcpu) &&
@@ -1217,6 +1217,7 @@ void do_user_addr_fault(struct pt_regs *regs,
 	struct mm_struct *mm;
 	vm_fault_t fault;
 	unsigned int flags = FAULT_FLAG_DEFAULT;
+	bool vma_retried = false;
 
 	tsk = current;
 	mm = tsk->mm;
@@ -1326,6 +1327,7 @@ void do_user_addr_fault(struct pt_regs *regs,
 	if (!(flags & FAULT_FLAG_USER))
 		goto lock_mmap;
 
+retry_vma:
 	vma = lock_vma_under_rcu(mm, address);
 	if (!vma)
 		goto lock_mmap;
@@ -1355,6 +1357,18 @@ void do_user_addr_fault(struct pt_regs *regs,
 						 ARCH_DEFAULT_PKEY);
 		return;
 	}
+
+	/*
+	 * The lock was most likely dropped to wait for I/O or for
+	 * userfaultfd, which is done now. Try once more under the VMA
+	 * lock before taking mmap_lock. FAULT_FLAG_TRIED keeps the second
+	 * attempt from dropping the lock again.
+	 */
+	if (!vma_retried) {
+		vma_retried = true;
+		flags |= FAULT_FLAG_TRIED;
+		goto retry_vma;
+	}
 lock_mmap:
 
 retry:
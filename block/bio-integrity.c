@@ -147,6 +147,8 @@ void bio_integrity_unmap_user(struct bio *bio)
 		kfree(bvec_virt(bip->bip_vec));
 		return;
 	}
+	if (bip->bip_flags & BIP_USER_FIXED)
+		return;
 
 	bio_integrity_unpin_bvec(bip->bip_vec, bip->bip_max_vcnt,
 			bio_data_dir(bio) == READ);
@@ -369,6 +371,70 @@ int bio_integrity_map_user(struct bio *bio, void __user *ubuf, ssize_t bytes,
 }
 EXPORT_SYMBOL_GPL(bio_integrity_map_user);
 
+/**
+ * bio_integrity_map_iter - Map a bvec iter as integrity payload
+ * @bio:	bio to attach the payload to
+ * @iter:	ITER_BVEC pointing at the integrity metadata
+ * @seed:	initial reference tag
+ *
+ * Description: Use the pages of a bvec iter, typically from an io_uring
+ * registered buffer, directly as integrity payload. The caller keeps the
+ * pages pinned until the bio completes, no references are taken here.
+ * Returns -EOPNOTSUPP if the payload would need a bounce buffer, in which
+ * case the caller should fall back to bio_integrity_map_user().
+ */
+int bio_integrity_map_iter(struct bio *bio, struct iov_iter *iter, u32 seed)
+{
+	struct request_queue *q = bdev_get_queue(bio->bi_bdev);
+	unsigned int align = blk_lim_dma_alignment_and_pad(&q->limits);
+	const struct bio_vec *bv = iter->bvec;
+	size_t bytes = iov_iter_count(iter), left, skip;
+	struct bio_integrity_payload *bip;
+	int i, nr_vecs;
+
+	if (WARN_ON_ONCE(!iov_iter_is_bvec(iter)))
+		return -EINVAL;
+	if (bio_integrity(bio))
+		return -EINVAL;
+	if (bytes >> SECTOR_SHIFT > queue_max_hw_sectors(q))
+		return -E2BIG;
+	if (!iov_iter_is_aligned(iter, align, align))
+		return -EOPNOTSUPP;
+
+	/* count the segments covered by the iter */
+	left = bytes;
+	skip = iter->iov_offset;
+	for (nr_vecs = 0; left; nr_vecs++) {
+		left -= min_t(size_t, bv[nr_vecs].bv_len - skip, left);
+		skip = 0;
+	}
+	if (nr_vecs > BIO_MAX_VECS ||
+	    nr_vecs > queue_max_integrity_segments(q))
+		return -EOPNOTSUPP;
+
+	bip = bio_integrity_alloc(bio, GFP_KERNEL, nr_vecs);
+	if (IS_ERR(bip))
+		return PTR_ERR(bip);
+
+	left = bytes;
+	skip = iter->iov_offset;
+	for (i = 0; i < nr_vecs; i++) {
+		size_t len = min_t(size_t, bv[i].bv_len - skip, left);
+
+		bvec_set_page(&bip->bip_vec[i], bv[i].bv_page, len,
+			      bv[i].bv_offset + skip);
+		left -= len;
+		skip = 0;
+	}
+
+	bip->bip_flags |= BIP_USER_FIXED;
+	bip->bip_iter.bi_sector = seed;
+	bip->bip_iter.bi_size = bytes;
+	bip->bip_vcnt = nr_vecs;
+	return 0;
+}
+EXPORT_SYMBOL_GPL(bio_integrity_map_iter);
+
 /**
  * bio_integrity_prep - Prepare bio for integrity I/O
  * @bio:	bio to prepare
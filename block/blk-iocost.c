@@ -44,7 +44,9 @@
  * /sys/fs/cgroup/io.cost.model.
  *
  * If needed, tools/cgroup/iocost_coef_gen.py can be used to generate
- * device-specific coefficients.
+ * device-specific coefficients.  Alternatively, writing "ctrl=calib" makes
+ * the controller keep refining the coefficients in effect from the device
+ * times of completed IOs.
  *
  * 2. Control Strategy
  *
@@ -312,6 +314,15 @@ enum {
 
 	/* if apart further than 16M, consider randio for linear model */
 	LCOEF_RANDIO_PAGES	= 4096,
+
+	/*
+	 * With ctrl=calib, refit the linear model from the completions of
+	 * each window of this length.  A direction is only updated if it saw
+	 * enough IOs, and every update can at most halve or double the
+	 * current coefficients and is then averaged with them.
+	 */
+	IOC_CALIB_NSEC		= 1LLU * NSEC_PER_SEC,
+	IOC_CALIB_MIN_IOS	= 256,
 };
 
 enum ioc_running {
@@ -356,6 +367,19 @@ enum {
 	NR_I_LCOEFS,
 };
 
+/* per-direction completion sums for online cost model calibration */
+enum {
+	CALIB_SEQ_NR,
+	CALIB_SEQ_PAGES,
+	CALIB_SEQ_NS,
+	CALIB_RAND_NR,
+	CALIB_RAND_PAGES,
+	CALIB_RAND_NS,
+	CALIB_PAGES_SQ,
+	CALIB_PAGES_NS,
+	NR_CALIB_SUMS,
+};
+
 enum {
 	LCOEF_RPAGE,
 	LCOEF_RSEQIO,
@@ -400,6 +424,9 @@ struct ioc_pcpu_stat {
 
 	local64_t			rq_wait_ns;
 	u64				last_rq_wait_ns;
+
+	local64_t			calib[2][NR_CALIB_SUMS];
+	u64				last_calib[2][NR_CALIB_SUMS];
 };
 
 /* per device */
@@ -445,6 +472,12 @@ struct ioc {
 	int				autop_idx;
 	bool				user_qos_params:1;
 	bool				user_cost_model:1;
+	bool				calib_cost_model:1;
+
+	/* online cost model calibration, see ioc_calibrate() */
+	u64				calib_sums[2][NR_CALIB_SUMS];
+	u64				calib_start_ns;
+	sector_t			calib_last_pos[2];	/* to detect randio */
 };
 
 struct iocg_pcpu_stat {
@@ -1613,6 +1646,20 @@ static void ioc_lat_stat(struct ioc *ioc, u32 *missed_ppm_ar, u32 *rq_wait_pct_p
 		this_rq_wait_ns = local64_read(&stat->rq_wait_ns);
 		rq_wait_ns += this_rq_wait_ns - stat->last_rq_wait_ns;
 		stat->last_rq_wait_ns = this_rq_wait_ns;
+
+		if (!ioc->calib_cost_model)
+			continue;
+
+		for (rw = READ; rw <= WRITE; rw++) {
+			int i;
+
+			for (i = 0; i < NR_CALIB_SUMS; i++) {
+				u64 this = local64_read(&stat->calib[rw][i]);
+
+				ioc->calib_sums[rw][i] += this - stat->last_calib[rw][i];
+				stat->last_calib[rw][i] = this;
+			}
+		}
 	}
 
 	for (rw = READ; rw <= WRITE; rw++) {
@@ -1628,6 +1675,96 @@ static void ioc_lat_stat(struct ioc *ioc, u32 *missed_ppm_ar, u32 *rq_wait_pct_p
 				   ioc->period_us * NSEC_PER_USEC);
 }
 
+/*
+ * Move @cur towards @fit, by at most a factor of two and then only a quarter
+ * of the way, so that a single noisy window can't wreck the model.
+ */
+static u64 calib_step(u64 cur, u64 fit)
+{
+	if (!cur)
+		return max_t(u64, fit, 1);
+
+	fit = clamp_t(u64, fit, cur / 2, cur * 2);
+	return max_t(u64, (cur * 3 + fit) / 4, 1);
+}
+
+/*
+ * Fit the linear model of one direction from the completions of the last
+ * window.  The per-page cost is the least squares slope of device time
+ * over IO size and the seq and rand base costs are what remains of their
+ * mean device times.  Device times overlap when several IOs are in flight,
+ * so they are scaled by the average queue depth, @depth_pct / 100.
+ */
+static void ioc_calibrate_dir(struct ioc *ioc, int rw, u64 depth_pct)
+{
+	const u64 *s = ioc->calib_sums[rw];
+	u64 *u = &ioc->params.i_lcoefs[rw == READ ? I_LCOEF_RBPS : I_LCOEF_WBPS];
+	u64 nr = s[CALIB_SEQ_NR] + s[CALIB_RAND_NR];
+	u64 pages = s[CALIB_SEQ_PAGES] + s[CALIB_RAND_PAGES];
+	u64 ns = s[CALIB_SEQ_NS] + s[CALIB_RAND_NS];
+	u64 page_ps, var, cov;
+	int i;
+
+	if (nr < IOC_CALIB_MIN_IOS)
+		return;
+
+	/* all in picoseconds, ns per 4k page is too coarse on fast devices */
+	var = s[CALIB_PAGES_SQ] - mul_u64_u64_div_u64(pages, pages, nr);
+	cov = s[CALIB_PAGES_NS] - mul_u64_u64_div_u64(pages, ns, nr);
+	if (var && (s64)cov > 0) {
+		page_ps = mul_u64_u64_div_u64(cov, 1000 * 100, var * depth_pct);
+		if (page_ps)
+			u[0] = calib_step(u[0], div64_u64((u64)IOC_PAGE_SIZE *
+							  NSEC_PER_SEC * 1000,
+							  page_ps));
+	}
+
+	/* use the possibly just updated bps for the size component */
+	page_ps = u[0] ? div64_u64((u64)IOC_PAGE_SIZE * NSEC_PER_SEC * 1000,
+				   u[0]) : 0;
+
+	for (i = 0; i < 2; i++) {
+		const u64 *c = &s[i ? CALIB_RAND_NR : CALIB_SEQ_NR];
+		u64 io_ps, size_ps;
+
+		if (c[0] < IOC_CALIB_MIN_IOS)
+			continue;
+
+		/* c[] is nr, pages, ns */
+		io_ps = mul_u64_u64_div_u64(c[2], 1000 * 100, c[0] * depth_pct);
+		size_ps = div64_u64(c[1] * page_ps, c[0]);
+		io_ps = (io_ps > size_ps ? io_ps - size_ps : 0) + page_ps;
+		if (io_ps)
+			u[1 + i] = calib_step(u[1 + i],
+					      div64_u64(NSEC_PER_SEC * 1000ULL,
+							io_ps));
+	}
+}
+
+static void ioc_calibrate(struct ioc *ioc, struct ioc_now *now)
+{
+	u64 window_ns = now->now_ns - ioc->calib_start_ns;
+	u64 busy_ns, depth_pct;
+
+	lockdep_assert_held(&ioc->lock);
+
+	if (!ioc->calib_cost_model || window_ns < IOC_CALIB_NSEC)
+		return;
+
+	busy_ns = ioc->calib_sums[READ][CALIB_SEQ_NS] +
+		  ioc->calib_sums[READ][CALIB_RAND_NS] +
+		  ioc->calib_sums[WRITE][CALIB_SEQ_NS] +
+		  ioc->calib_sums[WRITE][CALIB_RAND_NS];
+	depth_pct = max_t(u64, div64_u64(busy_ns * 100, window_ns), 100);
+
+	ioc_calibrate_dir(ioc, READ, depth_pct);
+	ioc_calibrate_dir(ioc, WRITE, depth_pct);
+	ioc_refresh_lcoefs(ioc);
+
+	memset(ioc->calib_sums, 0, sizeof(ioc->calib_sums));
+	ioc->calib_start_ns = now->now_ns;
+}
+
 /* was iocg idle this period? */
 static bool iocg_is_idle(struct ioc_gq *iocg)
 {
@@ -2433,6 +2570,7 @@ static void ioc_timer_fn(struct timer_list *timer)
 			      prev_busy_level, missed_ppm);
 
 	ioc_refresh_params(ioc, false);
+	ioc_calibrate(ioc, &now);
 
 	ioc_forgive_debts(ioc, usage_us_sum, nr_debtors, &now);
 
@@ -2835,6 +2973,26 @@ static void ioc_rqos_done(struct rq_qos *rqos, struct request *rq)
 
 	local64_add(rq_wait_ns, &ccs->rq_wait_ns);
 
+	if (ioc->calib_cost_model && rq->io_start_time_ns) {
+		u64 dev_ns = blk_time_get_ns() - rq->io_start_time_ns;
+		u64 pages = max_t(u64, blk_rq_bytes(rq) >> IOC_PAGE_SHIFT, 1);
+		sector_t pos = blk_rq_pos(rq);
+		sector_t last = READ_ONCE(ioc->calib_last_pos[rw]);
+		local64_t *c = ccs->calib[rw];
+		u64 seek_pages = (pos > last ? pos - last : last - pos) >>
+				 IOC_SECT_TO_PAGE_SHIFT;
+		int base = seek_pages > LCOEF_RANDIO_PAGES ? CALIB_RAND_NR :
+							     CALIB_SEQ_NR;
+
+		local64_inc(&c[base]);
+		local64_add(pages, &c[base + 1]);
+		local64_add(dev_ns, &c[base + 2]);
+		local64_add(pages * pages, &c[CALIB_PAGES_SQ]);
+		local64_add(pages * dev_ns, &c[CALIB_PAGES_NS]);
+		WRITE_ONCE(ioc->calib_last_pos[rw],
+			   blk_rq_pos(rq) + blk_rq_sectors(rq));
+	}
+
 	put_cpu_ptr(ccs);
 }
 
@@ -3368,7 +3526,8 @@ static u64 ioc_cost_model_prfill(struct seq_file *sf,
 	seq_printf(sf, "%s ctrl=%s model=linear "
 		   "rbps=%llu rseqiops=%llu rrandiops=%llu "
 		   "wbps=%llu wseqiops=%llu wrandiops=%llu\n",
-		   dname, ioc->user_cost_model ? "user" : "auto",
+		   dname, ioc->calib_cost_model ? "calib" :
+		   ioc->user_cost_model ? "user" : "auto",
 		   u[I_LCOEF_RBPS], u[I_LCOEF_RSEQIOPS], u[I_LCOEF_RRANDIOPS],
 		   u[I_LCOEF_WBPS], u[I_LCOEF_WSEQIOPS], u[I_LCOEF_WRANDIOPS]);
 	spin_unlock_irq(&ioc->lock);
@@ -3407,7 +3566,7 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 	struct request_queue *q;
 	struct ioc *ioc;
 	u64 u[NR_I_LCOEFS];
-	bool user;
+	bool user, calib;
 	char *body, *p;
 	int ret;
 
@@ -3438,6 +3597,7 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 	spin_lock_irq(&ioc->lock);
 	memcpy(u, ioc->params.i_lcoefs, sizeof(u));
 	user = ioc->user_cost_model;
+	calib = ioc->calib_cost_model;
 
 	while ((p = strsep(&body, " \t\n"))) {
 		substring_t args[MAX_OPT_ARGS];
@@ -3451,12 +3611,16 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 		switch (match_token(p, cost_ctrl_tokens, args)) {
 		case COST_CTRL:
 			match_strlcpy(buf, &args[0], sizeof(buf));
-			if (!strcmp(buf, "auto"))
-				user = false;
-			else if (!strcmp(buf, "user"))
+			if (!strcmp(buf, "auto")) {
+				user = calib = false;
+			} else if (!strcmp(buf, "user")) {
 				user = true;
-			else
+				calib = false;
+			} else if (!strcmp(buf, "calib")) {
+				user = calib = true;
+			} else {
 				goto einval;
+			}
 			continue;
 		case COST_MODEL:
 			match_strlcpy(buf, &args[0], sizeof(buf));
@@ -3480,6 +3644,12 @@ static ssize_t ioc_cost_model_write(struct kernfs_open_file *of, char *input,
 	} else {
 		ioc->user_cost_model = false;
 	}
+	/* calibration starts from the model in effect and owns it from then on */
+	if (calib && !ioc->calib_cost_model) {
+		memset(ioc->calib_sums, 0, sizeof(ioc->calib_sums));
+		ioc->calib_start_ns = blk_time_get_ns();
+	}
+	ioc->calib_cost_model = calib;
 	ioc_refresh_params(ioc, true);
 	spin_unlock_irq(&ioc->lock);
 
@@ -143,12 +143,29 @@ static ssize_t queue_state_write(void *data, const char __user *buf,
 	return count;
 }
 
+static int queue_bio_splits_show(void *data, struct seq_file *m)
+{
+	struct request_queue *q = data;
+	unsigned long splits[2] = { };
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct blk_mq_ctx *ctx = per_cpu_ptr(q->queue_ctx, cpu);
+
+		splits[0] += READ_ONCE(ctx->bio_splits[0]);
+		splits[1] += READ_ONCE(ctx->bio_splits[1]);
+	}
+	seq_printf(m, "read %lu\nwrite %lu\n", splits[0], splits[1]);
+	return 0;
+}
+
 static const struct blk_mq_debugfs_attr blk_mq_debugfs_queue_attrs[] = {
 	{ "poll_stat", 0400, queue_poll_stat_show },
 	{ "requeue_list", 0400, .seq_ops = &queue_requeue_list_seq_ops },
 	{ "pm_only", 0600, queue_pm_only_show, NULL },
 	{ "state", 0600, queue_state_show, queue_state_write },
 	{ "zone_wplugs", 0400, queue_zone_wplugs_show, NULL },
+	{ "bio_splits", 0400, queue_bio_splits_show, NULL },
 	{ },
 };
 
@@ -534,6 +551,16 @@ CTX_RQ_SEQ_OPS(default, HCTX_TYPE_DEFAULT);
 CTX_RQ_SEQ_OPS(read, HCTX_TYPE_READ);
 CTX_RQ_SEQ_OPS(poll, HCTX_TYPE_POLL);
 
+static int ctx_tag_alloc_show(void *data, struct seq_file *m)
+{
+	struct blk_mq_ctx *ctx = data;
+
+	seq_printf(m, "batch_gets %lu\n", READ_ONCE(ctx->tag_batch_gets));
+	seq_printf(m, "batch_tags %lu\n", READ_ONCE(ctx->tag_batch_tags));
+	seq_printf(m, "single_gets %lu\n", READ_ONCE(ctx->tag_single_gets));
+	return 0;
+}
+
 static int blk_mq_debugfs_show(struct seq_file *m, void *v)
 {
 	const struct blk_mq_debugfs_attr *attr = m->private;
@@ -619,6 +646,7 @@ static const struct blk_mq_debugfs_attr blk_mq_debugfs_ctx_attrs[] = {
 	{"default_rq_list", 0400, .seq_ops = &ctx_default_rq_list_seq_ops},
 	{"read_rq_list", 0400, .seq_ops = &ctx_read_rq_list_seq_ops},
 	{"poll_rq_list", 0400, .seq_ops = &ctx_poll_rq_list_seq_ops},
+	{"tag_alloc", 0400, ctx_tag_alloc_show},
 	{},
 };
 
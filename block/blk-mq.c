@@ -430,6 +430,8 @@ __blk_mq_alloc_requests_batch(struct blk_mq_alloc_data *data)
 	/* caller already holds a reference, add for remainder */
 	percpu_ref_get_many(&data->q->q_usage_counter, nr - 1);
 	data->nr_tags -= nr;
+	data->ctx->tag_batch_gets++;
+	data->ctx->tag_batch_tags += nr;
 
 	return rq_list_pop(data->cached_rq);
 }
@@ -510,6 +512,7 @@ static struct request *__blk_mq_alloc_requests(struct blk_mq_alloc_data *data)
 		msleep(3);
 		goto retry;
 	}
+	data->ctx->tag_single_gets++;
 
 	if (!(data->rq_flags & RQF_SCHED_TAGS))
 		blk_mq_inc_active_requests(data->hctx);
@@ -2982,9 +2985,13 @@ void blk_mq_submit_bio(struct bio *bio)
 	}
 
 	if (unlikely(bio_may_exceed_limits(bio, &q->limits))) {
+		struct bio *orig = bio;
+
 		bio = __bio_split_to_limits(bio, &q->limits, &nr_segs);
 		if (!bio)
 			goto queue_exit;
+		if (bio != orig)
+			blk_mq_get_ctx(q)->bio_splits[op_is_write(bio->bi_opf)]++;
 	}
 	if (!bio_integrity_prep(bio))
 		goto queue_exit;
@@ -28,6 +28,13 @@ struct blk_mq_ctx {
 	struct request_queue	*queue;
 	struct blk_mq_ctxs      *ctxs;
 	struct kobject		kobj;
+
+	/* tag allocation statistics, exported through debugfs */
+	unsigned long		tag_batch_gets;
+	unsigned long		tag_batch_tags;
+	unsigned long		tag_single_gets;
+	/* bios split to the queue limits, indexed by op_is_write() */
+	unsigned long		bio_splits[2];
 } ____cacheline_aligned_in_smp;
 
 enum {
@@ -71,6 +71,8 @@ static int crypto_acomp_init_tfm(struct crypto_tfm *tfm)
 
 	acomp->compress = alg->compress;
 	acomp->decompress = alg->decompress;
+	acomp->batch_compress = alg->batch_compress;
+	acomp->batch_decompress = alg->batch_decompress;
 	acomp->dst_free = alg->dst_free;
 	acomp->reqsize = alg->reqsize;
 
@@ -153,6 +155,58 @@ void acomp_request_free(struct acomp_req *req)
 }
 EXPORT_SYMBOL_GPL(acomp_request_free);
 
+static int acomp_batch_status(const int errors[], unsigned int nr)
+{
+	unsigned int i;
+
+	for (i = 0; i < nr; i++) {
+		if (errors[i] && errors[i] != -EINPROGRESS &&
+		    errors[i] != -EBUSY)
+			return errors[i];
+	}
+	return 0;
+}
+
+int crypto_acomp_batch_compress(struct acomp_req *reqs[], int errors[],
+				unsigned int nr)
+{
+	struct crypto_acomp *acomp;
+	unsigned int i;
+
+	if (!nr)
+		return 0;
+
+	acomp = crypto_acomp_reqtfm(reqs[0]);
+	if (acomp->batch_compress)
+		acomp->batch_compress(reqs, errors, nr);
+	else
+		for (i = 0; i < nr; i++)
+			errors[i] = acomp->compress(reqs[i]);
+
+	return acomp_batch_status(errors, nr);
+}
+EXPORT_SYMBOL_GPL(crypto_acomp_batch_compress);
+
+int crypto_acomp_batch_decompress(struct acomp_req *reqs[], int errors[],
+				  unsigned int nr)
+{
+	struct crypto_acomp *acomp;
+	unsigned int i;
+
+	if (!nr)
+		return 0;
+
+	acomp = crypto_acomp_reqtfm(reqs[0]);
+	if (acomp->batch_decompress)
+		acomp->batch_decompress(reqs, errors, nr);
+	else
+		for (i = 0; i < nr; i++)
+			errors[i] = acomp->decompress(reqs[i]);
+
+	return acomp_batch_status(errors, nr);
+}
+EXPORT_SYMBOL_GPL(crypto_acomp_batch_decompress);
+
 void comp_prepare_alg(struct comp_alg_common *alg)
 {
 	struct crypto_alg *base = &alg->base;
@@ -15,6 +15,7 @@
 #include <linux/slab.h>
 #include <linux/kobject.h>
 #include <linux/cpu.h>
+#include <linux/topology.h>
 #include <crypto/pcrypt.h>
 
 static struct padata_instance *pencrypt;
@@ -30,7 +31,8 @@ struct pcrypt_instance_ctx {
 
 struct pcrypt_aead_ctx {
 	struct crypto_aead *child;
-	unsigned int cb_cpu;
+	unsigned int cb_index;
+	int cb_cpu;
 };
 
 static inline struct pcrypt_instance_ctx *pcrypt_tfm_ictx(
@@ -89,6 +91,33 @@ static void pcrypt_aead_enc(struct padata_priv *padata)
 	padata_do_serial(padata);
 }
 
+/*
+ * Return the CPU the requests of a tfm complete on. padata only keeps the
+ * requests of a tfm in order if they all share one callback CPU, so it is
+ * picked once, among the online CPUs of the node the first request is
+ * submitted on, and kept. Fall back to all online CPUs if the node has none.
+ */
+static int pcrypt_aead_cb_cpu(struct pcrypt_aead_ctx *ctx)
+{
+	const struct cpumask *mask = cpumask_of_node(numa_node_id());
+	int cpu = READ_ONCE(ctx->cb_cpu), old;
+	unsigned int nr;
+
+	if (cpu >= 0)
+		return cpu;
+
+	nr = cpumask_weight_and(mask, cpu_online_mask);
+	if (!nr) {
+		mask = cpu_online_mask;
+		nr = cpumask_weight(mask);
+	}
+	cpu = cpumask_nth_and(ctx->cb_index % nr, mask, cpu_online_mask);
+
+	/* Another request may have picked one first */
+	old = cmpxchg(&ctx->cb_cpu, -1, cpu);
+	return old >= 0 ? old : cpu;
+}
+
 static int pcrypt_aead_encrypt(struct aead_request *req)
 {
 	int err;
@@ -99,8 +128,10 @@ static int pcrypt_aead_encrypt(struct aead_request *req)
 	struct pcrypt_aead_ctx *ctx = crypto_aead_ctx(aead);
 	u32 flags = aead_request_flags(req);
 	struct pcrypt_instance_ctx *ictx;
+	int cb_cpu;
 
 	ictx = pcrypt_tfm_ictx(aead);
+	cb_cpu = pcrypt_aead_cb_cpu(ctx);
 
 	memset(padata, 0, sizeof(struct padata_priv));
 
@@ -114,7 +145,10 @@ static int pcrypt_aead_encrypt(struct aead_request *req)
 			       req->cryptlen, req->iv);
 	aead_request_set_ad(creq, req->assoclen);
 
-	err = padata_do_parallel(ictx->psenc, padata, &ctx->cb_cpu);
+	err = padata_do_parallel(ictx->psenc, padata, &cb_cpu);
+	/* Keep the fallback padata chose if the CPU went away */
+	if (unlikely(cb_cpu != READ_ONCE(ctx->cb_cpu)))
+		WRITE_ONCE(ctx->cb_cpu, cb_cpu);
 	if (!err)
 		return -EINPROGRESS;
 	if (err == -EBUSY)
@@ -148,8 +182,10 @@ static int pcrypt_aead_decrypt(struct aead_request *req)
 	struct pcrypt_aead_ctx *ctx = crypto_aead_ctx(aead);
 	u32 flags = aead_request_flags(req);
 	struct pcrypt_instance_ctx *ictx;
+	int cb_cpu;
 
 	ictx = pcrypt_tfm_ictx(aead);
+	cb_cpu = pcrypt_aead_cb_cpu(ctx);
 
 	memset(padata, 0, sizeof(struct padata_priv));
 
@@ -163,7 +199,10 @@ static int pcrypt_aead_decrypt(struct aead_request *req)
 			       req->cryptlen, req->iv);
 	aead_request_set_ad(creq, req->assoclen);
 
-	err = padata_do_parallel(ictx->psdec, padata, &ctx->cb_cpu);
+	err = padata_do_parallel(ictx->psdec, padata, &cb_cpu);
+	/* Keep the fallback padata chose if the CPU went away */
+	if (unlikely(cb_cpu != READ_ONCE(ctx->cb_cpu)))
+		WRITE_ONCE(ctx->cb_cpu, cb_cpu);
 	if (!err)
 		return -EINPROGRESS;
 	if (err == -EBUSY)
@@ -174,18 +213,13 @@ static int pcrypt_aead_decrypt(struct aead_request *req)
 
 static int pcrypt_aead_init_tfm(struct crypto_aead *tfm)
 {
-	int cpu, cpu_index;
 	struct aead_instance *inst = aead_alg_instance(tfm);
 	struct pcrypt_instance_ctx *ictx = aead_instance_ctx(inst);
 	struct pcrypt_aead_ctx *ctx = crypto_aead_ctx(tfm);
 	struct crypto_aead *cipher;
 
-	cpu_index = (unsigned int)atomic_inc_return(&ictx->tfm_count) %
-		    cpumask_weight(cpu_online_mask);
-
-	ctx->cb_cpu = cpumask_first(cpu_online_mask);
-	for (cpu = 0; cpu < cpu_index; cpu++)
-		ctx->cb_cpu = cpumask_next(ctx->cb_cpu, cpu_online_mask);
+	ctx->cb_index = (unsigned int)atomic_inc_return(&ictx->tfm_count);
+	ctx->cb_cpu = -1;
 
 	cipher = crypto_spawn_aead(&ictx->spawn);
 
@@ -75,6 +75,37 @@ int crypto_shash_finup(struct shash_desc *desc, const u8 *data,
 }
 EXPORT_SYMBOL_GPL(crypto_shash_finup);
 
+int crypto_shash_finup_mb(struct shash_desc *desc, const u8 * const data[],
+			  unsigned int len, u8 * const outs[],
+			  unsigned int num_msgs)
+{
+	struct crypto_shash *tfm = desc->tfm;
+	struct shash_alg *alg = crypto_shash_alg(tfm);
+	SHASH_DESC_ON_STACK(tmp, tfm);
+	unsigned int i;
+	int err = 0;
+
+	if (num_msgs > 1 && num_msgs <= alg->mb_max_msgs)
+		return alg->finup_mb(desc, data, len, outs, num_msgs);
+
+	/* Not worth it, or too many messages: chunk them, or go one by one */
+	tmp->tfm = tfm;
+	for (i = 0; i < num_msgs && !err; ) {
+		unsigned int n = min(num_msgs - i, alg->mb_max_msgs);
+
+		memcpy(shash_desc_ctx(tmp), shash_desc_ctx(desc),
+		       crypto_shash_descsize(tfm));
+		if (n > 1)
+			err = alg->finup_mb(tmp, &data[i], len, &outs[i], n);
+		else
+			err = alg->finup(tmp, data[i], len, outs[i]);
+		i += n;
+	}
+	shash_desc_zero(tmp);
+	return err;
+}
+EXPORT_SYMBOL_GPL(crypto_shash_finup_mb);
+
 static int shash_default_digest(struct shash_desc *desc, const u8 *data,
 				unsigned int len, u8 *out)
 {
@@ -314,6 +345,9 @@ static int shash_prepare_alg(struct shash_alg *alg)
 	if ((alg->export && !alg->import) || (alg->import && !alg->export))
 		return -EINVAL;
 
+	if (alg->finup_mb ? alg->mb_max_msgs < 2 : alg->mb_max_msgs > 1)
+		return -EINVAL;
+
 	err = hash_prepare_alg(&alg->halg);
 	if (err)
 		return err;
@@ -340,6 +374,8 @@ static int shash_prepare_alg(struct shash_alg *alg)
 		alg->halg.statesize = alg->descsize;
 	if (!alg->setkey)
 		alg->setkey = shash_no_setkey;
+	if (!alg->finup_mb)
+		alg->mb_max_msgs = 1;
 
 	return 0;
 }
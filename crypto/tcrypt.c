@@ -19,6 +19,7 @@
 
 #define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
 
+#include <crypto/acompress.h>
 #include <crypto/aead.h>
 #include <crypto/hash.h>
 #include <crypto/skcipher.h>
@@ -1436,6 +1437,192 @@ static void test_cipher_speed(const char *algo, int enc, unsigned int secs,
 				   false);
 }
 
+struct test_mb_acomp_data {
+	struct scatterlist sg;
+	struct scatterlist sgout;
+	struct crypto_wait wait;
+	char *src;
+	char *dst;
+	unsigned int clen;
+};
+
+static int do_mult_acomp_op(struct test_mb_acomp_data *data,
+			    struct acomp_req **reqs, int comp, u32 num_mb,
+			    int *rc)
+{
+	int i, err = 0;
+
+	for (i = 0; i < num_mb; i++) {
+		struct test_mb_acomp_data *cur = &data[i];
+
+		if (comp) {
+			sg_init_one(&cur->sg, cur->src, PAGE_SIZE);
+			sg_init_one(&cur->sgout, cur->dst, 2 * PAGE_SIZE);
+			acomp_request_set_params(reqs[i], &cur->sg, &cur->sgout,
+						 PAGE_SIZE, 2 * PAGE_SIZE);
+		} else {
+			sg_init_one(&cur->sg, cur->dst, cur->clen);
+			sg_init_one(&cur->sgout, cur->src, PAGE_SIZE);
+			acomp_request_set_params(reqs[i], &cur->sg, &cur->sgout,
+						 cur->clen, PAGE_SIZE);
+		}
+	}
+
+	/* Submit the whole batch, then wait for all requests to finish */
+	if (comp)
+		crypto_acomp_batch_compress(reqs, rc, num_mb);
+	else
+		crypto_acomp_batch_decompress(reqs, rc, num_mb);
+
+	for (i = 0; i < num_mb; i++) {
+		rc[i] = crypto_wait_req(rc[i], &data[i].wait);
+
+		if (rc[i]) {
+			pr_info("batched request %d error %d\n", i, rc[i]);
+			err = rc[i];
+		} else if (comp) {
+			data[i].clen = reqs[i]->dlen;
+		}
+	}
+
+	return err;
+}
+
+static int test_mb_acomp_jiffies(struct test_mb_acomp_data *data,
+				 struct acomp_req **reqs, int comp, int secs,
+				 u32 num_mb, int *rc)
+{
+	unsigned long start, end;
+	int bcount;
+	int ret = 0;
+
+	for (start = jiffies, end = start + secs * HZ, bcount = 0;
+	     time_before(jiffies, end); bcount++) {
+		ret = do_mult_acomp_op(data, reqs, comp, num_mb, rc);
+		if (ret)
+			return ret;
+	}
+
+	pr_cont("%d operations in %d seconds (%llu bytes)\n",
+		bcount * num_mb, secs, (u64)bcount * PAGE_SIZE * num_mb);
+	return 0;
+}
+
+static int test_mb_acomp_cycles(struct test_mb_acomp_data *data,
+				struct acomp_req **reqs, int comp, u32 num_mb,
+				int *rc)
+{
+	unsigned long cycles = 0;
+	int ret = 0;
+	int i;
+
+	/* Warm-up run. */
+	for (i = 0; i < 4; i++) {
+		ret = do_mult_acomp_op(data, reqs, comp, num_mb, rc);
+		if (ret)
+			return ret;
+	}
+
+	/* The real thing. */
+	for (i = 0; i < 8; i++) {
+		cycles_t start, end;
+
+		start = get_cycles();
+		ret = do_mult_acomp_op(data, reqs, comp, num_mb, rc);
+		end = get_cycles();
+
+		if (ret)
+			return ret;
+
+		cycles += end - start;
+	}
+
+	pr_cont("1 operation in %lu cycles (%lu bytes)\n",
+		(cycles + 4) / (8 * num_mb), PAGE_SIZE);
+	return 0;
+}
+
+/*
+ * Compress and decompress batches of num_mb pages with
+ * crypto_acomp_batch_compress() and crypto_acomp_batch_decompress().
+ */
+static void test_mb_acomp_speed(const char *algo, int secs, u32 num_mb)
+{
+	struct test_mb_acomp_data *data;
+	struct crypto_acomp *tfm;
+	struct acomp_req **reqs;
+	unsigned int i, j;
+	int *rc;
+	int ret;
+
+	data = kcalloc(num_mb, sizeof(*data), GFP_KERNEL);
+	reqs = kcalloc(num_mb, sizeof(*reqs), GFP_KERNEL);
+	rc = kcalloc(num_mb, sizeof(*rc), GFP_KERNEL);
+	if (!data || !reqs || !rc)
+		goto out_free_data;
+
+	tfm = crypto_alloc_acomp(algo, 0, 0);
+	if (IS_ERR(tfm)) {
+		pr_err("failed to load transform for %s: %ld\n",
+			algo, PTR_ERR(tfm));
+		goto out_free_data;
+	}
+
+	for (i = 0; i < num_mb; ++i) {
+		data[i].src = kmalloc(PAGE_SIZE, GFP_KERNEL);
+		data[i].dst = kmalloc(2 * PAGE_SIZE, GFP_KERNEL);
+		reqs[i] = acomp_request_alloc(tfm);
+		if (!data[i].src || !data[i].dst || !reqs[i]) {
+			pr_err("alg: acomp: Failed to allocate request for %s\n",
+			       algo);
+			goto out;
+		}
+
+		/* Something in between all zeroes and random */
+		for (j = 0; j < PAGE_SIZE; j++)
+			data[i].src[j] = (j % 61) ^ ((j * 7 + i) >> 9);
+
+		acomp_request_set_callback(reqs[i], CRYPTO_TFM_REQ_MAY_BACKLOG,
+					   crypto_req_done, &data[i].wait);
+		crypto_init_wait(&data[i].wait);
+	}
+
+	pr_info("testing speed of batched %s (%s), %u requests of %lu bytes\n",
+		algo, get_driver_name(crypto_acomp, tfm), num_mb, PAGE_SIZE);
+
+	for (i = 0; i < 2; i++) {
+		int comp = !i;
+
+		pr_info("%s: ", comp ? "compression" : "decompression");
+		if (secs) {
+			ret = test_mb_acomp_jiffies(data, reqs, comp, secs,
+						    num_mb, rc);
+			cond_resched();
+		} else {
+			ret = test_mb_acomp_cycles(data, reqs, comp, num_mb,
+						   rc);
+		}
+		if (ret) {
+			pr_err("%s failed: %d\n",
+			       comp ? "compression" : "decompression", ret);
+			break;
+		}
+	}
+
+out:
+	for (i = 0; i < num_mb; ++i) {
+		if (reqs[i])
+			acomp_request_free(reqs[i]);
+		kfree(data[i].src);
+		kfree(data[i].dst);
+	}
+	crypto_free_acomp(tfm);
+out_free_data:
+	kfree(rc);
+	kfree(reqs);
+	kfree(data);
+}
+
 static inline int tcrypt_test(const char *alg)
 {
 	int ret;
@@ -2816,6 +3003,13 @@ static int do_test(const char *alg, u32 type, u32 mask, int m, u32 num_mb)
 				       speed_template_16_32, num_mb);
 		break;
 
+	case 611:
+		test_mb_acomp_speed("deflate", sec, num_mb);
+		test_mb_acomp_speed("lzo", sec, num_mb);
+		test_mb_acomp_speed("lz4", sec, num_mb);
+		test_mb_acomp_speed("zstd", sec, num_mb);
+		break;
+
 	}
 
 	return ret;
@@ -1884,6 +1884,103 @@ static int test_hash_vs_generic_impl(const char *generic_driver,
 }
 #endif /* !CONFIG_CRYPTO_MANAGER_EXTRA_TESTS */
 
+/*
+ * Check crypto_shash_finup_mb() against crypto_shash_finup() on each message,
+ * for every message length up to a few blocks and the 4K blocks verity hashes,
+ * every amount of data already in the state up to a block, and from 1 to one
+ * more than mb_max_msgs messages, with SIMD and, for the fallback, without.
+ */
+static int test_shash_finup_mb(const char *driver, struct shash_desc *desc)
+{
+	struct crypto_shash *tfm = desc->tfm;
+	const unsigned int max_msgs = crypto_shash_mb_max_msgs(tfm) + 1;
+	const unsigned int digestsize = crypto_shash_digestsize(tfm);
+	const unsigned int blocksize = crypto_shash_blocksize(tfm);
+	const unsigned int maxlen = max(3 * blocksize, 4096U);
+	const u8 **data = NULL;
+	u8 **outs = NULL;
+	struct shash_desc *ref = NULL;
+	u8 *buf = NULL, *expected = NULL;
+	unsigned int prefix, len, n, i;
+	bool nosimd;
+	int err;
+
+	if (max_msgs <= 2)
+		return 0;
+
+	err = -ENOMEM;
+	data = kcalloc(max_msgs, sizeof(*data), GFP_KERNEL);
+	outs = kcalloc(max_msgs, sizeof(*outs), GFP_KERNEL);
+	ref = kmalloc(sizeof(*ref) + crypto_shash_descsize(tfm), GFP_KERNEL);
+	buf = kmalloc(blocksize + max_msgs * maxlen, GFP_KERNEL);
+	expected = kmalloc(2 * max_msgs * digestsize, GFP_KERNEL);
+	if (!data || !outs || !ref || !buf || !expected)
+		goto out;
+	ref->tfm = tfm;
+
+	get_random_bytes(buf, blocksize + max_msgs * maxlen);
+	for (i = 0; i < max_msgs; i++) {
+		data[i] = &buf[blocksize + i * maxlen];
+		outs[i] = &expected[(max_msgs + i) * digestsize];
+	}
+
+	for (nosimd = false; ; nosimd = true) {
+		for (prefix = 0; prefix <= blocksize; prefix++) {
+			for (len = 0; len <= maxlen; len++) {
+				if (len == 3 * blocksize + 1)
+					len = maxlen;
+				for (n = 1; n <= max_msgs; n++) {
+					err = crypto_shash_init(desc) ?:
+					      crypto_shash_update(desc, buf, prefix);
+					if (err)
+						goto failed;
+					for (i = 0; i < n && !err; i++) {
+						memcpy(shash_desc_ctx(ref),
+						       shash_desc_ctx(desc),
+						       crypto_shash_descsize(tfm));
+						err = crypto_shash_finup(ref, data[i], len,
+									 &expected[i * digestsize]);
+					}
+					if (err)
+						goto failed;
+
+					if (nosimd)
+						crypto_disable_simd_for_test();
+					err = crypto_shash_finup_mb(desc, data, len,
+								    outs, n);
+					if (nosimd)
+						crypto_reenable_simd_for_test();
+					if (err)
+						goto failed;
+
+					if (memcmp(expected, outs[0], n * digestsize)) {
+						pr_err("alg: shash: %s finup_mb() differs from finup() for %u messages of %u bytes after %u bytes, nosimd=%d\n",
+						       driver, n, len, prefix, nosimd);
+						err = -EINVAL;
+						goto out;
+					}
+				}
+			}
+			cond_resched();
+		}
+		if (nosimd || !IS_ENABLED(CONFIG_CRYPTO_MANAGER_EXTRA_TESTS))
+			break;
+	}
+	err = 0;
+	goto out;
+
+failed:
+	pr_err("alg: shash: %s finup_mb() test failed with err %d\n",
+	       driver, err);
+out:
+	kfree(expected);
+	kfree(buf);
+	kfree(ref);
+	kfree(outs);
+	kfree(data);
+	return err;
+}
+
 static int alloc_shash(const char *driver, u32 type, u32 mask,
 		       struct crypto_shash **tfm_ret,
 		       struct shash_desc **desc_ret)
@@ -1993,6 +2090,8 @@ static int __alg_test_hash(const struct hash_testvec *vecs,
 	}
 	err = test_hash_vs_generic_impl(generic_driver, maxkeysize, req,
 					desc, tsgl, hashstate);
+	if (!err && desc)
+		err = test_shash_finup_mb(driver, desc);
 out:
 	kfree(hashstate);
 	if (tsgl) {
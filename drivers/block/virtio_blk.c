@@ -348,9 +348,21 @@ static inline void virtblk_request_done(struct request *req)
 	blk_mq_end_request(req, status);
 }
 
+static void virtblk_complete_batch(struct io_comp_batch *iob)
+{
+	struct request *req;
+
+	rq_list_for_each(&iob->req_list, req) {
+		virtblk_unmap_data(req, blk_mq_rq_to_pdu(req));
+		virtblk_cleanup_cmd(req);
+	}
+	blk_mq_end_request_batch(iob);
+}
+
 static void virtblk_done(struct virtqueue *vq)
 {
 	struct virtio_blk *vblk = vq->vdev->priv;
+	DEFINE_IO_COMP_BATCH(iob);
 	bool req_done = false;
 	int qid = vq->index;
 	struct virtblk_req *vbr;
@@ -363,9 +375,21 @@ static void virtblk_done(struct virtqueue *vq)
 		while ((vbr = virtqueue_get_buf(vblk->vqs[qid].vq, &len)) != NULL) {
 			struct request *req = blk_mq_rq_from_pdu(vbr);
 
-			if (likely(!blk_should_fake_timeout(req->q)))
-				blk_mq_complete_request(req);
 			req_done = true;
+			if (unlikely(blk_should_fake_timeout(req->q)))
+				continue;
+			if (blk_mq_complete_request_remote(req))
+				continue;
+			/*
+			 * Complete requests which finish on this CPU together
+			 * once the lock is dropped.  Zone append needs the
+			 * written sector copied back, which only the single
+			 * request completion does.
+			 */
+			if (req_op(req) == REQ_OP_ZONE_APPEND ||
+			    !blk_mq_add_to_batch(req, &iob, virtblk_vbr_status(vbr),
+						 virtblk_complete_batch))
+				virtblk_request_done(req);
 		}
 	} while (!virtqueue_enable_cb(vq));
 
@@ -373,6 +397,9 @@ static void virtblk_done(struct virtqueue *vq)
 	if (req_done)
 		blk_mq_start_stopped_hw_queues(vblk->disk->queue, true);
 	spin_unlock_irqrestore(&vblk->vqs[qid].lock, flags);
+
+	if (!rq_list_empty(iob.req_list))
+		virtblk_complete_batch(&iob);
 }
 
 static void virtio_commit_rqs(struct blk_mq_hw_ctx *hctx)
@@ -1190,17 +1217,6 @@ static void virtblk_map_queues(struct blk_mq_tag_set *set)
 	}
 }
 
-static void virtblk_complete_batch(struct io_comp_batch *iob)
-{
-	struct request *req;
-
-	rq_list_for_each(&iob->req_list, req) {
-		virtblk_unmap_data(req, blk_mq_rq_to_pdu(req));
-		virtblk_cleanup_cmd(req);
-	}
-	blk_mq_end_request_batch(iob);
-}
-
 static int virtblk_poll(struct blk_mq_hw_ctx *hctx, struct io_comp_batch *iob)
 {
 	struct virtio_blk *vblk = hctx->queue->queuedata;
@@ -16,9 +16,11 @@
 #include <linux/tick.h>
 #include <linux/slab.h>
 #include <linux/sched/cpufreq.h>
+#include <linux/sched/smt.h>
 #include <linux/list.h>
 #include <linux/cpu.h>
 #include <linux/cpufreq.h>
+#include <linux/cpuset.h>
 #include <linux/sysfs.h>
 #include <linux/types.h>
 #include <linux/fs.h>
@@ -219,6 +221,7 @@ struct global_params {
  * @hwp_boost_min:	Last HWP boosted min performance
  * @suspended:		Whether or not the driver has been suspended.
  * @hwp_notify_work:	workqueue for HWP notifications.
+ * @capacity_perf:	Highest perf used for scale invariance
  *
  * This structure stores per CPU instance data for all CPUs.
  */
@@ -257,6 +260,7 @@ struct cpudata {
 	u32 hwp_boost_min;
 	bool suspended;
 	struct delayed_work hwp_notify_work;
+	unsigned int capacity_perf;
 };
 
 static struct cpudata **all_cpu_data;
@@ -295,6 +299,8 @@ static int hwp_mode_bdw __ro_after_init;
 static bool per_cpu_limits __ro_after_init;
 static bool hwp_forced __ro_after_init;
 static bool hwp_boost __read_mostly;
+static bool no_cas __ro_after_init;
+static bool hybrid_cas __ro_after_init;
 
 static struct cpufreq_driver *intel_pstate_driver __read_mostly;
 
@@ -439,7 +445,9 @@ static void intel_pstate_init_acpi_perf_limits(struct cpufreq_policy *policy)
 	int i;
 
 	if (hwp_active) {
-		intel_pstate_set_itmt_prio(policy->cpu);
+		/* Asym capacity replaces ITMT on hybrid systems, if enabled. */
+		if (!hybrid_cas)
+			intel_pstate_set_itmt_prio(policy->cpu);
 		return;
 	}
 
@@ -592,6 +600,130 @@ static void intel_pstate_hybrid_hwp_adjust(struct cpudata *cpu)
 	cpu->pstate.min_pstate = intel_pstate_freq_to_hwp(cpu, freq);
 }
 
+/* Serializes updates of the hybrid CPU capacities. */
+static DEFINE_MUTEX(hybrid_capacity_lock);
+
+/* Highest capacity_perf among the CPUs seen so far. */
+static unsigned int hybrid_max_cap_perf;
+
+static void hybrid_rebuild_sched_domains_fn(struct work_struct *work)
+{
+	rebuild_sched_domains();
+}
+
+/* Deferred because CPU capacities are updated under the CPU hotplug lock. */
+static DECLARE_WORK(hybrid_rebuild_work, hybrid_rebuild_sched_domains_fn);
+
+static void hybrid_get_capacity_perf(struct cpudata *cpu)
+{
+	if (READ_ONCE(global.no_turbo)) {
+		cpu->capacity_perf = cpu->pstate.max_pstate_physical;
+		return;
+	}
+
+	cpu->capacity_perf = HWP_HIGHEST_PERF(READ_ONCE(cpu->hwp_cap_cached));
+}
+
+static void hybrid_set_cpu_capacity(struct cpudata *cpu)
+{
+	arch_set_cpu_capacity(cpu->cpu, cpu->capacity_perf, hybrid_max_cap_perf,
+			      cpu->capacity_perf,
+			      cpu->pstate.max_pstate_physical);
+
+	pr_debug("CPU%d: perf = %u, max. perf = %u, base perf = %d\n", cpu->cpu,
+		 cpu->capacity_perf, hybrid_max_cap_perf,
+		 cpu->pstate.max_pstate_physical);
+}
+
+static void hybrid_set_capacity_of_cpus(void)
+{
+	int cpunum;
+
+	for_each_online_cpu(cpunum) {
+		struct cpudata *cpu = all_cpu_data[cpunum];
+
+		if (cpu && cpu->capacity_perf)
+			hybrid_set_cpu_capacity(cpu);
+	}
+}
+
+/**
+ * hybrid_update_capacity - Update the capacity of a CPU coming online.
+ * @cpu: Target CPU.
+ *
+ * The capacity of every CPU is its highest HWP performance level relative to
+ * the maximum one across all CPUs, which also takes care of the efficiency
+ * difference between core types as HWP performance levels are in the same
+ * units on all of them.  If @cpu raises the maximum, all of the capacities are
+ * recomputed.
+ */
+static void hybrid_update_capacity(struct cpudata *cpu)
+{
+	if (!hybrid_cas)
+		return;
+
+	guard(mutex)(&hybrid_capacity_lock);
+
+	hybrid_get_capacity_perf(cpu);
+	if (!cpu->capacity_perf)
+		return;
+
+	if (cpu->capacity_perf > hybrid_max_cap_perf) {
+		hybrid_max_cap_perf = cpu->capacity_perf;
+		hybrid_set_capacity_of_cpus();
+	} else {
+		hybrid_set_cpu_capacity(cpu);
+	}
+
+	schedule_work(&hybrid_rebuild_work);
+}
+
+/* Recompute all of the capacities, e.g. after toggling turbo. */
+static void hybrid_refresh_cpu_capacity_scaling(void)
+{
+	int cpunum;
+
+	if (!hybrid_cas)
+		return;
+
+	guard(mutex)(&hybrid_capacity_lock);
+
+	hybrid_max_cap_perf = 0;
+
+	for_each_online_cpu(cpunum) {
+		struct cpudata *cpu = all_cpu_data[cpunum];
+
+		if (!cpu)
+			continue;
+
+		hybrid_get_capacity_perf(cpu);
+		if (cpu->capacity_perf > hybrid_max_cap_perf)
+			hybrid_max_cap_perf = cpu->capacity_perf;
+	}
+
+	if (hybrid_max_cap_perf)
+		hybrid_set_capacity_of_cpus();
+
+	schedule_work(&hybrid_rebuild_work);
+}
+
+/**
+ * hybrid_init_cpu_capacity_scaling - Choose between asym capacity and ITMT.
+ *
+ * On hybrid processors, let the scheduler use asymmetric CPU capacity, and
+ * hence capacity-aware wakeup placement and misfit migration, instead of ITMT
+ * priorities.  Because the capacity of SMT siblings is not deterministic even
+ * approximately, keep using ITMT when SMT is active.
+ */
+static void __init hybrid_init_cpu_capacity_scaling(void)
+{
+	if (no_cas || !boot_cpu_has(X86_FEATURE_HYBRID_CPU) ||
+	    sched_smt_active())
+		return;
+
+	hybrid_cas = arch_enable_hybrid_capacity_scale();
+}
+
 static bool turbo_is_disabled(void)
 {
 	u64 misc_en;
@@ -1333,6 +1465,7 @@ static ssize_t store_no_turbo(struct kobject *a, struct kobj_attribute *b,
 
 	intel_pstate_update_limits_for_all();
 	arch_set_max_freq_ratio(no_turbo);
+	hybrid_refresh_cpu_capacity_scaling();
 
 unlock_driver:
 	mutex_unlock(&intel_pstate_driver_lock);
@@ -2705,6 +2838,8 @@ static int intel_pstate_cpu_online(struct cpufreq_policy *policy)
 		cpu->suspended = false;
 	}
 
+	hybrid_update_capacity(cpu);
+
 	return 0;
 }
 
@@ -2746,6 +2881,8 @@ static int __intel_pstate_cpu_init(struct cpufreq_policy *policy)
 
 	intel_pstate_init_acpi_perf_limits(policy);
 
+	hybrid_update_capacity(cpu);
+
 	policy->fast_switch_possible = true;
 
 	return 0;
@@ -3533,6 +3670,7 @@ static int __init intel_pstate_init(void)
 			pr_debug("hybrid scaling factor: %d\n", hybrid_scaling_factor);
 		}
 
+		hybrid_init_cpu_capacity_scaling();
 	}
 
 	mutex_lock(&intel_pstate_driver_lock);
@@ -3582,6 +3720,8 @@ static int __init intel_pstate_setup(char *str)
 		hwp_only = 1;
 	if (!strcmp(str, "per_cpu_perf_limits"))
 		per_cpu_limits = true;
+	if (!strcmp(str, "no_cas"))
+		no_cas = true;
 
 #ifdef CONFIG_ACPI
 	if (!strcmp(str, "support_acpi_ppc"))
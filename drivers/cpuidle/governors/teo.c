@@ -90,14 +90,26 @@
  *      select the given idle state instead of the candidate one.
  *
  * 3. By default, select the candidate state.
+ *
+ * With CONFIG_CPU_IDLE_GOV_TEO_IRQ and teo.irq_sources=1, the governor also
+ * keeps a separate set of bins for each of a few interrupts that most recently
+ * woke up the CPU.  If the last wakeup was caused by one of them and its bins
+ * have collected enough samples, they are used in the steps above instead of
+ * the per-CPU ones, since the idle period following e.g. a network interrupt
+ * tends to look like the previous idle periods following that interrupt.  The
+ * cpu_idle_irq_predict trace event reports how well this worked.
  */
 
 #include <linux/cpuidle.h>
+#include <linux/interrupt.h>
 #include <linux/jiffies.h>
 #include <linux/kernel.h>
+#include <linux/moduleparam.h>
 #include <linux/sched/clock.h>
 #include <linux/tick.h>
 
+#include <trace/events/power.h>
+
 #include "gov.h"
 
 /*
@@ -117,6 +129,26 @@ struct teo_bin {
 	unsigned int hits;
 };
 
+#ifdef CONFIG_CPU_IDLE_GOV_TEO_IRQ
+/* Number of wakeup interrupts tracked per CPU. */
+#define TEO_NR_IRQ_SOURCES	4
+
+/* Decayed sample weight needed before the bins of a source are used. */
+#define TEO_IRQ_MIN_TOTAL	(4 * PULSE)
+
+/**
+ * struct teo_irq_source - Metrics of idle periods entered after an interrupt.
+ * @irq: Interrupt number, -1 if the slot is unused.
+ * @total: Grand total of the "intercepts" and "hits" metrics for all bins.
+ * @state_bins: Idle state data bins for this interrupt.
+ */
+struct teo_irq_source {
+	int irq;
+	unsigned int total;
+	struct teo_bin state_bins[CPUIDLE_STATE_MAX];
+};
+#endif
+
 /**
  * struct teo_cpu - CPU data used by the TEO cpuidle governor.
  * @time_span_ns: Time between idle state selection and post-wakeup update.
@@ -124,6 +156,9 @@ struct teo_bin {
  * @state_bins: Idle state data bins for this CPU.
  * @total: Grand total of the "intercepts" and "hits" metrics for all bins.
  * @tick_hits: Number of "hits" after TICK_NSEC.
+ * @idle_entry_ns: Time of the last idle state selection.
+ * @cur_source: Interrupt source the current idle period is accounted to.
+ * @irq_sources: Per interrupt source metrics.
  */
 struct teo_cpu {
 	s64 time_span_ns;
@@ -131,10 +166,145 @@ struct teo_cpu {
 	struct teo_bin state_bins[CPUIDLE_STATE_MAX];
 	unsigned int total;
 	unsigned int tick_hits;
+#ifdef CONFIG_CPU_IDLE_GOV_TEO_IRQ
+	u64 idle_entry_ns;
+	struct teo_irq_source *cur_source;
+	struct teo_irq_source irq_sources[TEO_NR_IRQ_SOURCES];
+#endif
 };
 
 static DEFINE_PER_CPU(struct teo_cpu, teo_cpus);
 
+#ifdef CONFIG_CPU_IDLE_GOV_TEO_IRQ
+static bool teo_irq_sources __read_mostly;
+module_param_named(irq_sources, teo_irq_sources, bool, 0444);
+
+/**
+ * teo_find_irq_source - Find the metrics of the interrupt that woke up the CPU.
+ * @cpu_data: Governor data for the target CPU.
+ *
+ * Return the source slot of the first interrupt recorded after the last idle
+ * entry, which is the one that woke the CPU up, recycling the least used slot
+ * for a new interrupt, or NULL if the CPU was not woken up by a (tracked)
+ * interrupt.
+ */
+static struct teo_irq_source *teo_find_irq_source(struct teo_cpu *cpu_data)
+{
+	struct teo_irq_source *src, *victim = NULL;
+	int i, irq;
+
+	if (!teo_irq_sources)
+		return NULL;
+
+	irq = irq_timings_first_irq(cpu_data->idle_entry_ns);
+	if (irq < 0)
+		return NULL;
+
+	for (i = 0; i < TEO_NR_IRQ_SOURCES; i++) {
+		src = &cpu_data->irq_sources[i];
+		if (src->irq == irq)
+			return src;
+
+		if (!victim || src->total < victim->total)
+			victim = src;
+	}
+
+	memset(victim, 0, sizeof(*victim));
+	victim->irq = irq;
+
+	return victim;
+}
+
+/**
+ * teo_update_irq_source - Update interrupt source metrics after wakeup.
+ * @drv: cpuidle driver containing state data.
+ * @dev: Target CPU.
+ * @idx_timer: Bin fallen into by the sleep length.
+ * @idx_duration: Bin fallen into by the measured idle duration.
+ */
+static void teo_update_irq_source(struct cpuidle_driver *drv,
+				  struct cpuidle_device *dev,
+				  int idx_timer, int idx_duration)
+{
+	struct teo_cpu *cpu_data = per_cpu_ptr(&teo_cpus, dev->cpu);
+	struct teo_irq_source *src = cpu_data->cur_source;
+	int i;
+
+	if (!src)
+		return;
+
+	src->total = 0;
+
+	for (i = 0; i < drv->state_count; i++) {
+		struct teo_bin *bin = &src->state_bins[i];
+
+		bin->hits -= bin->hits >> DECAY_SHIFT;
+		bin->intercepts -= bin->intercepts >> DECAY_SHIFT;
+
+		src->total += bin->hits + bin->intercepts;
+	}
+
+	/* The extra tick bin is not tracked per source. */
+	idx_timer = min(idx_timer, drv->state_count - 1);
+
+	if (idx_timer == idx_duration)
+		src->state_bins[idx_timer].hits += PULSE;
+	else
+		src->state_bins[idx_duration].intercepts += PULSE;
+
+	src->total += PULSE;
+
+	trace_cpu_idle_irq_predict(dev->cpu, src->irq, dev->last_state_idx,
+				   idx_duration);
+
+	cpu_data->cur_source = NULL;
+}
+
+static void teo_init_irq_sources(struct teo_cpu *cpu_data)
+{
+	int i;
+
+	for (i = 0; i < TEO_NR_IRQ_SOURCES; i++)
+		cpu_data->irq_sources[i].irq = -1;
+}
+
+/**
+ * teo_select_bins - Pick the metrics to base the idle state selection on.
+ * @cpu_data: Governor data for the target CPU.
+ * @total: Grand total of the metrics in the returned bins.
+ *
+ * Must be called with interrupts off right before entering idle, since it
+ * records the idle entry time the next wakeup source is looked up from.
+ */
+static struct teo_bin *teo_select_bins(struct teo_cpu *cpu_data,
+				       unsigned int *total)
+{
+	struct teo_irq_source *src = teo_find_irq_source(cpu_data);
+
+	cpu_data->idle_entry_ns = cpu_data->time_span_ns;
+	cpu_data->cur_source = src;
+	if (src && src->total >= TEO_IRQ_MIN_TOTAL) {
+		*total = src->total;
+		return src->state_bins;
+	}
+
+	*total = cpu_data->total;
+	return cpu_data->state_bins;
+}
+#else
+static inline void teo_update_irq_source(struct cpuidle_driver *drv,
+					 struct cpuidle_device *dev,
+					 int idx_timer, int idx_duration) {}
+static inline void teo_init_irq_sources(struct teo_cpu *cpu_data) {}
+
+static struct teo_bin *teo_select_bins(struct teo_cpu *cpu_data,
+				       unsigned int *total)
+{
+	*total = cpu_data->total;
+	return cpu_data->state_bins;
+}
+#endif
+
 /**
  * teo_update - Update CPU metrics after wakeup.
  * @drv: cpuidle driver containing state data.
@@ -234,6 +404,8 @@ static void teo_update(struct cpuidle_driver *drv, struct cpuidle_device *dev)
 
 end:
 	cpu_data->total += PULSE;
+
+	teo_update_irq_source(drv, dev, idx_timer, idx_duration);
 }
 
 static bool teo_state_ok(int i, struct cpuidle_driver *drv)
@@ -281,6 +453,8 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 	s64 latency_req = cpuidle_governor_latency_req(dev->cpu);
 	ktime_t delta_tick = TICK_NSEC / 2;
 	unsigned int tick_intercept_sum = 0;
+	unsigned int total;
+	struct teo_bin *bins;
 	unsigned int idx_intercept_sum = 0;
 	unsigned int intercept_sum = 0;
 	unsigned int idx_hit_sum = 0;
@@ -303,6 +477,8 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 	 */
 	cpu_data->sleep_length_ns = KTIME_MAX;
 
+	bins = teo_select_bins(cpu_data, &total);
+
 	/* Check if there is any choice in the first place. */
 	if (drv->state_count < 2) {
 		idx = 0;
@@ -314,7 +490,7 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 
 	/* Compute the sums of metrics for early wakeup pattern detection. */
 	for (i = 1; i < drv->state_count; i++) {
-		struct teo_bin *prev_bin = &cpu_data->state_bins[i-1];
+		struct teo_bin *prev_bin = &bins[i-1];
 		struct cpuidle_state *s = &drv->states[i];
 
 		/*
@@ -356,7 +532,7 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 	}
 
 	tick_intercept_sum = intercept_sum +
-			cpu_data->state_bins[drv->state_count-1].intercepts;
+			bins[drv->state_count-1].intercepts;
 
 	/*
 	 * If the sum of the intercepts metric for all of the idle states
@@ -366,7 +542,7 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 	 * better choice.
 	 */
 	prev_intercept_idx = idx;
-	if (2 * idx_intercept_sum > cpu_data->total - idx_hit_sum) {
+	if (2 * idx_intercept_sum > total - idx_hit_sum) {
 		int first_suitable_idx = idx;
 
 		/*
@@ -380,7 +556,7 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 		intercept_sum = 0;
 
 		for (i = idx - 1; i >= 0; i--) {
-			struct teo_bin *bin = &cpu_data->state_bins[i];
+			struct teo_bin *bin = &bins[i];
 
 			intercept_sum += bin->intercepts;
 
@@ -469,7 +645,7 @@ static int teo_select(struct cpuidle_driver *drv, struct cpuidle_device *dev,
 	 * total wakeup events, do not stop the tick.
 	 */
 	if (drv->states[idx].target_residency_ns < TICK_NSEC &&
-	    tick_intercept_sum > cpu_data->total / 2 + cpu_data->total / 8)
+	    tick_intercept_sum > total / 2 + total / 8)
 		duration_ns = TICK_NSEC / 2;
 
 end:
@@ -531,6 +707,7 @@ static int teo_enable_device(struct cpuidle_driver *drv,
 	struct teo_cpu *cpu_data = per_cpu_ptr(&teo_cpus, dev->cpu);
 
 	memset(cpu_data, 0, sizeof(*cpu_data));
+	teo_init_irq_sources(cpu_data);
 
 	return 0;
 }
@@ -545,6 +722,10 @@ static struct cpuidle_governor teo_governor = {
 
 static int __init teo_governor_init(void)
 {
+#ifdef CONFIG_CPU_IDLE_GOV_TEO_IRQ
+	if (teo_irq_sources)
+		irq_timings_enable();
+#endif
 	return cpuidle_register_governor(&teo_governor);
 }
 
@@ -1127,10 +1127,11 @@ static int iaa_compress(struct crypto_tfm *tfm,	struct acomp_req *req,
 			dma_addr_t src_addr, unsigned int slen,
 			dma_addr_t dst_addr, unsigned int *dlen,
 			u32 *compression_crc,
-			bool disable_async)
+			bool disable_async, struct idxd_desc **poll_desc)
 {
 	struct iaa_device_compression_mode *active_compression_mode;
 	struct iaa_compression_ctx *ctx = crypto_tfm_ctx(tfm);
+	bool async = !disable_async && (ctx->async_mode || poll_desc);
 	struct iaa_device *iaa_device;
 	struct idxd_desc *idxd_desc;
 	struct iax_hw_desc *desc;
@@ -1148,7 +1149,8 @@ static int iaa_compress(struct crypto_tfm *tfm,	struct acomp_req *req,
 
 	active_compression_mode = get_iaa_device_compression_mode(iaa_device, ctx->mode);
 
-	idxd_desc = idxd_alloc_desc(wq, IDXD_OP_BLOCK);
+	/* A batch must not wait for the descriptors it is holding itself */
+	idxd_desc = idxd_alloc_desc(wq, poll_desc ? IDXD_OP_NONBLOCK : IDXD_OP_BLOCK);
 	if (IS_ERR(idxd_desc)) {
 		dev_dbg(dev, "idxd descriptor allocation failed\n");
 		dev_dbg(dev, "iaa compress failed: ret=%ld\n", PTR_ERR(idxd_desc));
@@ -1170,7 +1172,7 @@ static int iaa_compress(struct crypto_tfm *tfm,	struct acomp_req *req,
 	desc->src2_size = sizeof(struct aecs_comp_table_record);
 	desc->completion_addr = idxd_desc->compl_dma;
 
-	if (ctx->use_irq && !disable_async) {
+	if (ctx->use_irq && !disable_async && !poll_desc) {
 		desc->flags |= IDXD_OP_FLAG_RCI;
 
 		idxd_desc->crypto.req = req;
@@ -1183,8 +1185,11 @@ static int iaa_compress(struct crypto_tfm *tfm,	struct acomp_req *req,
 			" src_addr %llx, dst_addr %llx\n", __func__,
 			active_compression_mode->name,
 			src_addr, dst_addr);
-	} else if (ctx->async_mode && !disable_async)
+	} else if (poll_desc && !disable_async) {
+		*poll_desc = idxd_desc;
+	} else if (async) {
 		req->base.data = idxd_desc;
+	}
 
 	dev_dbg(dev, "%s: compression mode %s,"
 		" desc->src1_addr %llx, desc->src1_size %d,"
@@ -1204,7 +1209,7 @@ static int iaa_compress(struct crypto_tfm *tfm,	struct acomp_req *req,
 	update_total_comp_calls();
 	update_wq_comp_calls(wq);
 
-	if (ctx->async_mode && !disable_async) {
+	if (async) {
 		ret = -EINPROGRESS;
 		dev_dbg(dev, "%s: returning -EINPROGRESS\n", __func__);
 		goto out;
@@ -1224,7 +1229,7 @@ static int iaa_compress(struct crypto_tfm *tfm,	struct acomp_req *req,
 
 	*compression_crc = idxd_desc->iax_completion->crc;
 
-	if (!ctx->async_mode || disable_async)
+	if (!async)
 		idxd_free_desc(wq, idxd_desc);
 out:
 	return ret;
@@ -1366,10 +1371,11 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 			  struct idxd_wq *wq,
 			  dma_addr_t src_addr, unsigned int slen,
 			  dma_addr_t dst_addr, unsigned int *dlen,
-			  bool disable_async)
+			  bool disable_async, struct idxd_desc **poll_desc)
 {
 	struct iaa_device_compression_mode *active_compression_mode;
 	struct iaa_compression_ctx *ctx = crypto_tfm_ctx(tfm);
+	bool async = !disable_async && (ctx->async_mode || poll_desc);
 	struct iaa_device *iaa_device;
 	struct idxd_desc *idxd_desc;
 	struct iax_hw_desc *desc;
@@ -1387,7 +1393,7 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 
 	active_compression_mode = get_iaa_device_compression_mode(iaa_device, ctx->mode);
 
-	idxd_desc = idxd_alloc_desc(wq, IDXD_OP_BLOCK);
+	idxd_desc = idxd_alloc_desc(wq, poll_desc ? IDXD_OP_NONBLOCK : IDXD_OP_BLOCK);
 	if (IS_ERR(idxd_desc)) {
 		dev_dbg(dev, "idxd descriptor allocation failed\n");
 		dev_dbg(dev, "iaa decompress failed: ret=%ld\n",
@@ -1408,7 +1414,7 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 	desc->src1_size = slen;
 	desc->completion_addr = idxd_desc->compl_dma;
 
-	if (ctx->use_irq && !disable_async) {
+	if (ctx->use_irq && !disable_async && !poll_desc) {
 		desc->flags |= IDXD_OP_FLAG_RCI;
 
 		idxd_desc->crypto.req = req;
@@ -1421,8 +1427,11 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 			" src_addr %llx, dst_addr %llx\n", __func__,
 			active_compression_mode->name,
 			src_addr, dst_addr);
-	} else if (ctx->async_mode && !disable_async)
+	} else if (poll_desc && !disable_async) {
+		*poll_desc = idxd_desc;
+	} else if (async) {
 		req->base.data = idxd_desc;
+	}
 
 	dev_dbg(dev, "%s: decompression mode %s,"
 		" desc->src1_addr %llx, desc->src1_size %d,"
@@ -1442,7 +1451,7 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 	update_total_decomp_calls();
 	update_wq_decomp_calls(wq);
 
-	if (ctx->async_mode && !disable_async) {
+	if (async) {
 		ret = -EINPROGRESS;
 		dev_dbg(dev, "%s: returning -EINPROGRESS\n", __func__);
 		goto out;
@@ -1470,7 +1479,7 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 
 	*dlen = req->dlen;
 
-	if (!ctx->async_mode || disable_async)
+	if (!async)
 		idxd_free_desc(wq, idxd_desc);
 
 	/* Update stats */
@@ -1485,7 +1494,8 @@ static int iaa_decompress(struct crypto_tfm *tfm, struct acomp_req *req,
 	goto out;
 }
 
-static int iaa_comp_acompress(struct acomp_req *req)
+static int __iaa_comp_acompress(struct acomp_req *req,
+				struct idxd_desc **poll_desc)
 {
 	struct iaa_compression_ctx *compression_ctx;
 	struct crypto_tfm *tfm = req->base.tfm;
@@ -1570,7 +1580,8 @@ static int iaa_comp_acompress(struct acomp_req *req)
 		req->dst, req->dlen, sg_dma_len(req->dst));
 
 	ret = iaa_compress(tfm, req, wq, src_addr, req->slen, dst_addr,
-			   &req->dlen, &compression_crc, disable_async);
+			   &req->dlen, &compression_crc, disable_async,
+			   poll_desc);
 	if (ret == -EINPROGRESS)
 		return ret;
 
@@ -1674,7 +1685,7 @@ static int iaa_comp_adecompress_alloc_dest(struct acomp_req *req)
 		" req->dlen %d, sg_dma_len(sg) %d\n", dst_addr, nr_sgs,
 		req->dst, req->dlen, sg_dma_len(req->dst));
 	ret = iaa_decompress(tfm, req, wq, src_addr, req->slen,
-			     dst_addr, &req->dlen, true);
+			     dst_addr, &req->dlen, true, NULL);
 	if (ret == -EOVERFLOW) {
 		dma_unmap_sg(dev, req->dst, sg_nents(req->dst), DMA_FROM_DEVICE);
 		req->dlen *= 2;
@@ -1698,7 +1709,8 @@ static int iaa_comp_adecompress_alloc_dest(struct acomp_req *req)
 	return ret;
 }
 
-static int iaa_comp_adecompress(struct acomp_req *req)
+static int __iaa_comp_adecompress(struct acomp_req *req,
+				  struct idxd_desc **poll_desc)
 {
 	struct crypto_tfm *tfm = req->base.tfm;
 	dma_addr_t src_addr, dst_addr;
@@ -1765,7 +1777,7 @@ static int iaa_comp_adecompress(struct acomp_req *req)
 		req->dst, req->dlen, sg_dma_len(req->dst));
 
 	ret = iaa_decompress(tfm, req, wq, src_addr, req->slen,
-			     dst_addr, &req->dlen, false);
+			     dst_addr, &req->dlen, false, poll_desc);
 	if (ret == -EINPROGRESS)
 		return ret;
 
@@ -1781,6 +1793,139 @@ static int iaa_comp_adecompress(struct acomp_req *req)
 	return ret;
 }
 
+static int iaa_comp_acompress(struct acomp_req *req)
+{
+	return __iaa_comp_acompress(req, NULL);
+}
+
+static int iaa_comp_adecompress(struct acomp_req *req)
+{
+	return __iaa_comp_adecompress(req, NULL);
+}
+
+/*
+ * Wait for a request that a batch submitted without an interrupt and
+ * finish it the way the synchronous paths above do.
+ */
+static int iaa_comp_poll(struct acomp_req *req, struct idxd_desc *idxd_desc,
+			 bool compress)
+{
+	struct iaa_compression_ctx *compression_ctx;
+	struct idxd_wq *wq = idxd_desc->wq;
+	dma_addr_t src_addr, dst_addr;
+	struct iaa_wq *iaa_wq;
+	u32 compression_crc;
+	struct device *dev;
+	int ret;
+
+	compression_ctx = crypto_tfm_ctx(req->base.tfm);
+	iaa_wq = idxd_wq_get_private(wq);
+	dev = &wq->idxd->pdev->dev;
+
+	ret = check_completion(dev, idxd_desc->iax_completion, compress, false);
+	if (ret) {
+		dev_dbg(dev, "%s: check_completion failed ret=%d\n", __func__, ret);
+		if (!compress &&
+		    idxd_desc->iax_completion->status == IAA_ANALYTICS_ERROR) {
+			pr_warn("%s: falling back to deflate-generic decompress, "
+				"analytics error code %x\n", __func__,
+				idxd_desc->iax_completion->error_code);
+			ret = deflate_generic_decompress(req);
+		}
+	} else {
+		req->dlen = idxd_desc->iax_completion->output_size;
+	}
+	compression_crc = idxd_desc->iax_completion->crc;
+	idxd_free_desc(wq, idxd_desc);
+
+	/* Update stats */
+	if (!ret && compress) {
+		update_total_comp_bytes_out(req->dlen);
+		update_wq_comp_bytes(wq, req->dlen);
+	} else if (!ret) {
+		update_total_decomp_bytes_in(req->slen);
+		update_wq_decomp_bytes(wq, req->slen);
+	}
+
+	if (!ret && compress && compression_ctx->verify_compress) {
+		ret = iaa_remap_for_verify(dev, iaa_wq, req, &src_addr, &dst_addr);
+		if (ret) {
+			dev_dbg(dev, "%s: compress verify remap failed ret=%d\n", __func__, ret);
+			goto out;
+		}
+
+		ret = iaa_compress_verify(req->base.tfm, req, wq, src_addr,
+					  req->slen, dst_addr, &req->dlen,
+					  compression_crc);
+		if (ret)
+			dev_dbg(dev, "%s: compress verify failed ret=%d\n", __func__, ret);
+
+		dma_unmap_sg(dev, req->dst, sg_nents(req->dst), DMA_TO_DEVICE);
+		dma_unmap_sg(dev, req->src, sg_nents(req->src), DMA_FROM_DEVICE);
+
+		goto out;
+	}
+
+	dma_unmap_sg(dev, req->dst, sg_nents(req->dst), DMA_FROM_DEVICE);
+	dma_unmap_sg(dev, req->src, sg_nents(req->src), DMA_TO_DEVICE);
+out:
+	iaa_wq_put(wq);
+
+	return ret;
+}
+
+/* Requests queued before waiting for the first of them */
+#define IAA_BATCH_MAX	8
+
+/*
+ * Queue the descriptors of up to IAA_BATCH_MAX requests before waiting for
+ * any of them, so that the engines work on them in parallel. The results
+ * are returned synchronously, whatever the sync_mode.
+ */
+static void iaa_comp_abatch(struct acomp_req *reqs[], int errors[],
+			    unsigned int nr, bool compress)
+{
+	struct idxd_desc *descs[IAA_BATCH_MAX];
+	unsigned int i, j, n;
+
+	for (i = 0; i < nr; i += n) {
+		for (n = 0; n < IAA_BATCH_MAX && i + n < nr; n++) {
+			errors[i + n] = compress ?
+				__iaa_comp_acompress(reqs[i + n], &descs[n]) :
+				__iaa_comp_adecompress(reqs[i + n], &descs[n]);
+			/* Out of descriptors, retry once ours are reaped */
+			if (errors[i + n] == -EAGAIN)
+				break;
+		}
+
+		/* None of them are ours, wait like a single request would */
+		if (!n) {
+			errors[i] = compress ? iaa_comp_acompress(reqs[i]) :
+					       iaa_comp_adecompress(reqs[i]);
+			n = 1;
+			continue;
+		}
+
+		for (j = 0; j < n; j++) {
+			if (errors[i + j] == -EINPROGRESS)
+				errors[i + j] = iaa_comp_poll(reqs[i + j], descs[j],
+							      compress);
+		}
+	}
+}
+
+static void iaa_comp_abatch_compress(struct acomp_req *reqs[], int errors[],
+				     unsigned int nr)
+{
+	iaa_comp_abatch(reqs, errors, nr, true);
+}
+
+static void iaa_comp_abatch_decompress(struct acomp_req *reqs[], int errors[],
+				       unsigned int nr)
+{
+	iaa_comp_abatch(reqs, errors, nr, false);
+}
+
 static void compression_ctx_init(struct iaa_compression_ctx *ctx)
 {
 	ctx->verify_compress = iaa_verify_compress;
@@ -1812,6 +1957,8 @@ static struct acomp_alg iaa_acomp_fixed_deflate = {
 	.init			= iaa_comp_init_fixed,
 	.compress		= iaa_comp_acompress,
 	.decompress		= iaa_comp_adecompress,
+	.batch_compress		= iaa_comp_abatch_compress,
+	.batch_decompress	= iaa_comp_abatch_decompress,
 	.dst_free               = dst_free,
 	.base			= {
 		.cra_name		= "deflate",
@@ -1145,9 +1145,17 @@ static int amdgpu_cs_vm_handling(struct amdgpu_cs_parser *p)
 		if (bo_va == NULL)
 			continue;
 
-		r = amdgpu_vm_bo_update(adev, bo_va, false);
-		if (r)
-			return r;
+		/*
+		 * Skip the update when the BO didn't move and no mapping
+		 * changed since the last one, most BOs of a submission are
+		 * unchanged. Still wait for that last update below.
+		 */
+		if (bo_va->base.moved || bo_va->cleared ||
+		    !list_empty(&bo_va->invalids)) {
+			r = amdgpu_vm_bo_update(adev, bo_va, false);
+			if (r)
+				return r;
+		}
 
 		r = amdgpu_sync_fence(&p->sync, bo_va->last_pt_update);
 		if (r)
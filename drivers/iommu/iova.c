@@ -16,7 +16,40 @@
 /* The anchor node sits above the top of the usable address space */
 #define IOVA_ANCHOR	~0UL
 
-#define IOVA_RANGE_CACHE_MAX_SIZE 6	/* log of max cached IOVA range size (in pages) */
+/* log of max cached IOVA range size (in pages) */
+#define IOVA_RANGE_CACHE_DEFAULT_SIZE	6
+#define IOVA_RANGE_CACHE_MAX_SIZE	11
+
+/*
+ * Devices which map large buffers, e.g. NICs doing LRO into 256K buffers,
+ * miss the rcaches on every mapping with the default size and fall back
+ * to the rbtree.  Allow caching larger ranges at the cost of two more
+ * magazines per CPU for every additional size in every domain.
+ */
+static unsigned int iova_rcache_sizes = IOVA_RANGE_CACHE_DEFAULT_SIZE;
+
+static int iova_rcache_sizes_set(const char *val, const struct kernel_param *kp)
+{
+	unsigned int n;
+	int ret;
+
+	ret = kstrtouint(val, 0, &n);
+	if (ret)
+		return ret;
+
+	if (n < IOVA_RANGE_CACHE_DEFAULT_SIZE || n > IOVA_RANGE_CACHE_MAX_SIZE)
+		return -EINVAL;
+
+	return param_set_uint(val, kp);
+}
+
+static const struct kernel_param_ops iova_rcache_sizes_ops = {
+	.set = iova_rcache_sizes_set,
+	.get = param_get_uint,
+};
+module_param_cb(rcache_sizes, &iova_rcache_sizes_ops, &iova_rcache_sizes, 0444);
+MODULE_PARM_DESC(rcache_sizes,
+	"Number of power-of-two IOVA range sizes cached per CPU (6-11, default 6)");
 
 static bool iova_rcache_insert(struct iova_domain *iovad,
 			       unsigned long pfn,
@@ -385,7 +418,7 @@ alloc_iova_fast(struct iova_domain *iovad, unsigned long size,
 	 * rounding up anything cacheable to make sure that can't happen. The
 	 * order of the unadjusted size will still match upon freeing.
 	 */
-	if (size < (1 << (IOVA_RANGE_CACHE_MAX_SIZE - 1)))
+	if (size < (1 << (iova_rcache_sizes - 1)))
 		size = roundup_pow_of_two(size);
 
 	iova_pfn = iova_rcache_get(iovad, size, limit_pfn + 1);
@@ -594,7 +627,7 @@ static struct kmem_cache *iova_magazine_cache;
 
 unsigned long iova_rcache_range(void)
 {
-	return PAGE_SIZE << (IOVA_RANGE_CACHE_MAX_SIZE - 1);
+	return PAGE_SIZE << (iova_rcache_sizes - 1);
 }
 
 static struct iova_magazine *iova_magazine_alloc(gfp_t flags)
@@ -709,13 +742,13 @@ int iova_domain_init_rcaches(struct iova_domain *iovad)
 	unsigned int cpu;
 	int i, ret;
 
-	iovad->rcaches = kcalloc(IOVA_RANGE_CACHE_MAX_SIZE,
+	iovad->rcaches = kcalloc(iova_rcache_sizes,
 				 sizeof(struct iova_rcache),
 				 GFP_KERNEL);
 	if (!iovad->rcaches)
 		return -ENOMEM;
 
-	for (i = 0; i < IOVA_RANGE_CACHE_MAX_SIZE; ++i) {
+	for (i = 0; i < iova_rcache_sizes; ++i) {
 		struct iova_cpu_rcache *cpu_rcache;
 		struct iova_rcache *rcache;
 
@@ -803,7 +836,7 @@ static bool iova_rcache_insert(struct iova_domain *iovad, unsigned long pfn,
 {
 	unsigned int log_size = order_base_2(size);
 
-	if (log_size >= IOVA_RANGE_CACHE_MAX_SIZE)
+	if (log_size >= iova_rcache_sizes)
 		return false;
 
 	return __iova_rcache_insert(iovad, &iovad->rcaches[log_size], pfn);
@@ -859,7 +892,7 @@ static unsigned long iova_rcache_get(struct iova_domain *iovad,
 {
 	unsigned int log_size = order_base_2(size);
 
-	if (log_size >= IOVA_RANGE_CACHE_MAX_SIZE)
+	if (log_size >= iova_rcache_sizes)
 		return 0;
 
 	return __iova_rcache_get(&iovad->rcaches[log_size], limit_pfn - size);
@@ -874,7 +907,7 @@ static void free_iova_rcaches(struct iova_domain *iovad)
 	struct iova_cpu_rcache *cpu_rcache;
 	unsigned int cpu;
 
-	for (int i = 0; i < IOVA_RANGE_CACHE_MAX_SIZE; ++i) {
+	for (int i = 0; i < iova_rcache_sizes; ++i) {
 		rcache = &iovad->rcaches[i];
 		if (!rcache->cpu_rcaches)
 			break;
@@ -903,7 +936,7 @@ static void free_cpu_cached_iovas(unsigned int cpu, struct iova_domain *iovad)
 	unsigned long flags;
 	int i;
 
-	for (i = 0; i < IOVA_RANGE_CACHE_MAX_SIZE; ++i) {
+	for (i = 0; i < iova_rcache_sizes; ++i) {
 		rcache = &iovad->rcaches[i];
 		cpu_rcache = per_cpu_ptr(rcache->cpu_rcaches, cpu);
 		spin_lock_irqsave(&cpu_rcache->lock, flags);
@@ -921,7 +954,7 @@ static void free_global_cached_iovas(struct iova_domain *iovad)
 	struct iova_rcache *rcache;
 	unsigned long flags;
 
-	for (int i = 0; i < IOVA_RANGE_CACHE_MAX_SIZE; ++i) {
+	for (int i = 0; i < iova_rcache_sizes; ++i) {
 		rcache = &iovad->rcaches[i];
 		spin_lock_irqsave(&rcache->lock, flags);
 		while (rcache->depot) {
@@ -16,6 +16,7 @@
 #include <linux/key.h>
 #include <linux/bio.h>
 #include <linux/blkdev.h>
+#include <linux/blk-crypto.h>
 #include <linux/blk-integrity.h>
 #include <linux/mempool.h>
 #include <linux/slab.h>
@@ -141,7 +142,8 @@ struct iv_elephant_private {
 enum flags { DM_CRYPT_SUSPENDED, DM_CRYPT_KEY_VALID,
 	     DM_CRYPT_SAME_CPU, DM_CRYPT_HIGH_PRIORITY,
 	     DM_CRYPT_NO_OFFLOAD, DM_CRYPT_NO_READ_WORKQUEUE,
-	     DM_CRYPT_NO_WRITE_WORKQUEUE, DM_CRYPT_WRITE_INLINE };
+	     DM_CRYPT_NO_WRITE_WORKQUEUE, DM_CRYPT_WRITE_INLINE,
+	     DM_CRYPT_INLINE_CRYPT };
 
 enum cipher_flags {
 	CRYPT_MODE_INTEGRITY_AEAD,	/* Use authenticated mode for cipher */
@@ -230,6 +232,10 @@ struct crypt_config {
 	struct mutex bio_alloc_lock;
 
 	u8 *authenc_key; /* space for keys in authenc() format (if used) */
+
+	/* set if the underlying device does the crypto, see inline_crypt */
+	struct blk_crypto_key *blk_key;
+
 	u8 key[] __counted_by(key_size);
 };
 
@@ -2783,6 +2789,114 @@ static void crypt_page_free(void *page, void *pool_data)
 	percpu_counter_sub(&cc->n_allocated_pages, 1);
 }
 
+#ifdef CONFIG_BLK_INLINE_ENCRYPTION
+/*
+ * With inline_crypt, aes-xts-plain64 mappings hand the key to blk-crypto and
+ * let the underlying device encrypt and decrypt, skipping the crypto API and
+ * the kcryptd workqueues entirely.  plain64 uses the sector number as IV,
+ * which is exactly how blk-crypto increments the data unit number, as long as
+ * the IV is counted in units of sector_size.
+ *
+ * This prepares the key and has to run before the keyring key copy is wiped.
+ */
+static int crypt_inline_init_key(struct crypt_config *cc)
+{
+	const char *alg = crypto_tfm_alg_name(crypto_skcipher_tfm(any_tfm(cc)));
+	int ret;
+
+	if (crypt_integrity_aead(cc) || cc->integrity_iv_size ||
+	    cc->used_tag_size || cc->tfms_count != 1 || cc->key_size != 64 ||
+	    cc->iv_gen_ops != &crypt_iv_plain64_ops || strcmp(alg, "xts(aes)") ||
+	    (cc->sector_size != (1 << SECTOR_SHIFT) &&
+	     !test_bit(CRYPT_IV_LARGE_SECTORS, &cc->cipher_flags)))
+		return -EINVAL;
+
+	cc->blk_key = kzalloc(sizeof(*cc->blk_key), GFP_KERNEL);
+	if (!cc->blk_key)
+		return -ENOMEM;
+
+	ret = blk_crypto_init_key(cc->blk_key, cc->key,
+				  BLK_ENCRYPTION_MODE_AES_256_XTS,
+				  sizeof(u64), cc->sector_size);
+	if (ret) {
+		kfree_sensitive(cc->blk_key);
+		cc->blk_key = NULL;
+	}
+	return ret;
+}
+
+/*
+ * Only use the key if the device supports it natively: the blk-crypto
+ * software fallback would just be a slower way of doing what dm-crypt does.
+ * Without hardware support, do the crypto in the submitting and completing
+ * contexts instead of bouncing through the kcryptd workqueues.
+ */
+static void crypt_inline_start(struct crypt_config *cc)
+{
+	if (!cc->blk_key)
+		return;
+
+	if (blk_crypto_config_supported_natively(cc->dev->bdev,
+						 &cc->blk_key->crypto_cfg) &&
+	    !blk_crypto_start_using_key(cc->dev->bdev, cc->blk_key))
+		return;
+
+	DMINFO("%s: no inline encryption support, using no_read_workqueue and no_write_workqueue",
+	       cc->dev->name);
+	kfree_sensitive(cc->blk_key);
+	cc->blk_key = NULL;
+	set_bit(DM_CRYPT_NO_READ_WORKQUEUE, &cc->flags);
+	set_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags);
+}
+
+static void crypt_inline_dtr(struct crypt_config *cc)
+{
+	if (!cc->blk_key)
+		return;
+
+	/* the constructor may have failed before opening the device */
+	if (cc->dev)
+		blk_crypto_evict_key(cc->dev->bdev, cc->blk_key);
+	kfree_sensitive(cc->blk_key);
+	cc->blk_key = NULL;
+}
+
+static int crypt_inline_map(struct dm_target *ti, struct bio *bio)
+{
+	struct crypt_config *cc = ti->private;
+	u64 dun[BLK_CRYPTO_DUN_ARRAY_SIZE] = { };
+	sector_t sector = dm_target_offset(ti, bio->bi_iter.bi_sector);
+
+	dun[0] = sector + cc->iv_offset;
+	if (test_bit(CRYPT_IV_LARGE_SECTORS, &cc->cipher_flags))
+		dun[0] >>= cc->sector_shift;
+
+	bio_set_dev(bio, cc->dev->bdev);
+	bio->bi_iter.bi_sector = cc->start + sector;
+	bio_crypt_set_ctx(bio, cc->blk_key, dun, GFP_NOIO);
+
+	return DM_MAPIO_REMAPPED;
+}
+#else
+static int crypt_inline_init_key(struct crypt_config *cc)
+{
+	return -EOPNOTSUPP;
+}
+
+static void crypt_inline_start(struct crypt_config *cc)
+{
+}
+
+static void crypt_inline_dtr(struct crypt_config *cc)
+{
+}
+
+static int crypt_inline_map(struct dm_target *ti, struct bio *bio)
+{
+	return DM_MAPIO_KILL;
+}
+#endif
+
 static void crypt_dtr(struct dm_target *ti)
 {
 	struct crypt_config *cc = ti->private;
@@ -2817,6 +2931,8 @@ static void crypt_dtr(struct dm_target *ti)
 	if (cc->iv_gen_ops && cc->iv_gen_ops->dtr)
 		cc->iv_gen_ops->dtr(cc);
 
+	crypt_inline_dtr(cc);
+
 	if (cc->dev)
 		dm_put_device(ti, cc->dev);
 
@@ -3154,6 +3270,14 @@ static int crypt_ctr_cipher(struct dm_target *ti, char *cipher_in, char *key)
 		}
 	}
 
+	if (test_bit(DM_CRYPT_INLINE_CRYPT, &cc->flags)) {
+		ret = crypt_inline_init_key(cc);
+		if (ret < 0) {
+			ti->error = "Cipher not supported for inline_crypt";
+			return ret;
+		}
+	}
+
 	/* wipe the kernel key payload copy */
 	if (cc->key_string)
 		memset(cc->key, 0, cc->key_size * sizeof(u8));
@@ -3166,7 +3290,7 @@ static int crypt_ctr_optional(struct dm_target *ti, unsigned int argc, char **ar
 	struct crypt_config *cc = ti->private;
 	struct dm_arg_set as;
 	static const struct dm_arg _args[] = {
-		{0, 9, "Invalid number of feature args"},
+		{0, 10, "Invalid number of feature args"},
 	};
 	unsigned int opt_params, val;
 	const char *opt_string, *sval;
@@ -3202,6 +3326,8 @@ static int crypt_ctr_optional(struct dm_target *ti, unsigned int argc, char **ar
 			set_bit(DM_CRYPT_NO_READ_WORKQUEUE, &cc->flags);
 		else if (!strcasecmp(opt_string, "no_write_workqueue"))
 			set_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags);
+		else if (!strcasecmp(opt_string, "inline_crypt"))
+			set_bit(DM_CRYPT_INLINE_CRYPT, &cc->flags);
 		else if (sscanf(opt_string, "integrity:%u:", &val) == 1) {
 			if (val == 0 || val > MAX_TAG_SIZE) {
 				ti->error = "Invalid integrity arguments";
@@ -3390,6 +3516,8 @@ static int crypt_ctr(struct dm_target *ti, unsigned int argc, char **argv)
 	}
 	cc->start = tmpll;
 
+	crypt_inline_start(cc);
+
 	if (bdev_is_zoned(cc->dev->bdev)) {
 		/*
 		 * For zoned block devices, we need to preserve the issuer write
@@ -3516,6 +3644,9 @@ static int crypt_map(struct dm_target *ti, struct bio *bio)
 		return DM_MAPIO_REMAPPED;
 	}
 
+	if (cc->blk_key)
+		return crypt_inline_map(ti, bio);
+
 	/*
 	 * Check if bio is too large, split as needed.
 	 */
@@ -3607,6 +3738,7 @@ static void crypt_status(struct dm_target *ti, status_type_t type,
 		num_feature_args += test_bit(DM_CRYPT_NO_OFFLOAD, &cc->flags);
 		num_feature_args += test_bit(DM_CRYPT_NO_READ_WORKQUEUE, &cc->flags);
 		num_feature_args += test_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags);
+		num_feature_args += test_bit(DM_CRYPT_INLINE_CRYPT, &cc->flags);
 		num_feature_args += cc->sector_size != (1 << SECTOR_SHIFT);
 		num_feature_args += test_bit(CRYPT_IV_LARGE_SECTORS, &cc->cipher_flags);
 		if (cc->used_tag_size)
@@ -3625,6 +3757,8 @@ static void crypt_status(struct dm_target *ti, status_type_t type,
 				DMEMIT(" no_read_workqueue");
 			if (test_bit(DM_CRYPT_NO_WRITE_WORKQUEUE, &cc->flags))
 				DMEMIT(" no_write_workqueue");
+			if (test_bit(DM_CRYPT_INLINE_CRYPT, &cc->flags))
+				DMEMIT(" inline_crypt");
 			if (cc->used_tag_size)
 				DMEMIT(" integrity:%u:%s", cc->used_tag_size, cc->cipher_auth);
 			if (cc->sector_size != (1 << SECTOR_SHIFT))
@@ -3647,6 +3781,7 @@ static void crypt_status(struct dm_target *ti, status_type_t type,
 		       'y' : 'n');
 		DMEMIT(",iv_large_sectors=%c", test_bit(CRYPT_IV_LARGE_SECTORS, &cc->cipher_flags) ?
 		       'y' : 'n');
+		DMEMIT(",inline_crypt=%c", cc->blk_key ? 'y' : 'n');
 
 		if (cc->used_tag_size)
 			DMEMIT(",integrity_tag_size=%u,cipher_auth=%s",
@@ -3709,6 +3844,10 @@ static int crypt_message(struct dm_target *ti, unsigned int argc, char **argv,
 			DMWARN("not suspended during key manipulation.");
 			return -EINVAL;
 		}
+		if (cc->blk_key) {
+			DMWARN("key manipulation not supported with inline_crypt.");
+			return -EINVAL;
+		}
 		if (argc == 3 && !strcasecmp(argv[1], "set")) {
 			/* The key size may not be changed. */
 			key_size = get_key_size(&argv[2]);
@@ -3758,7 +3897,7 @@ static void crypt_io_hints(struct dm_target *ti, struct queue_limits *limits)
 
 static struct target_type crypt_target = {
 	.name   = "crypt",
-	.version = {1, 27, 0},
+	.version = {1, 28, 0},
 	.module = THIS_MODULE,
 	.ctr    = crypt_ctr,
 	.dtr    = crypt_dtr,
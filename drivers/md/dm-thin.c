@@ -259,6 +259,11 @@ struct pool {
 	unsigned long last_commit_jiffies;
 	unsigned int ref_count;
 
+	/* metadata commit latency, protected by lock */
+	u64 nr_commits;
+	u64 commit_ns_total;
+	u64 commit_ns_max;
+
 	spinlock_t lock;
 	struct bio_list deferred_flush_bios;
 	struct bio_list deferred_flush_completions;
@@ -1484,12 +1489,22 @@ static void check_for_data_space(struct pool *pool)
  */
 static int commit(struct pool *pool)
 {
+	u64 start, ns;
 	int r;
 
 	if (get_pool_mode(pool) >= PM_OUT_OF_METADATA_SPACE)
 		return -EINVAL;
 
+	start = ktime_get_ns();
 	r = dm_pool_commit_metadata(pool->pmd);
+	ns = ktime_get_ns() - start;
+
+	spin_lock_irq(&pool->lock);
+	pool->nr_commits++;
+	pool->commit_ns_total += ns;
+	pool->commit_ns_max = max(pool->commit_ns_max, ns);
+	spin_unlock_irq(&pool->lock);
+
 	if (r)
 		metadata_operation_failed(pool, "dm_pool_commit_metadata", r);
 	else {
@@ -3832,6 +3847,34 @@ static int process_release_metadata_snap_mesg(unsigned int argc, char **argv, st
 	return r;
 }
 
+/*
+ * Reports the number of metadata commits and their total and maximum
+ * duration in microseconds.
+ */
+static int process_commit_stats_mesg(unsigned int argc, char **argv,
+				     struct pool *pool, char *result,
+				     unsigned int maxlen)
+{
+	u64 nr_commits, total_ns, max_ns;
+	unsigned int sz = 0;
+	int r;
+
+	r = check_arg_count(argc, 1);
+	if (r)
+		return r;
+
+	spin_lock_irq(&pool->lock);
+	nr_commits = pool->nr_commits;
+	total_ns = pool->commit_ns_total;
+	max_ns = pool->commit_ns_max;
+	spin_unlock_irq(&pool->lock);
+
+	DMEMIT("%llu %llu %llu\n", nr_commits,
+	       div_u64(total_ns, NSEC_PER_USEC), div_u64(max_ns, NSEC_PER_USEC));
+
+	return 1;
+}
+
 /*
  * Messages supported:
  *   create_thin	<dev_id>
@@ -3840,6 +3883,7 @@ static int process_release_metadata_snap_mesg(unsigned int argc, char **argv, st
  *   set_transaction_id <current_trans_id> <new_trans_id>
  *   reserve_metadata_snap
  *   release_metadata_snap
+ *   commit_stats
  */
 static int pool_message(struct dm_target *ti, unsigned int argc, char **argv,
 			char *result, unsigned int maxlen)
@@ -3848,6 +3892,9 @@ static int pool_message(struct dm_target *ti, unsigned int argc, char **argv,
 	struct pool_c *pt = ti->private;
 	struct pool *pool = pt->pool;
 
+	if (!strcasecmp(argv[0], "commit_stats"))
+		return process_commit_stats_mesg(argc, argv, pool, result, maxlen);
+
 	if (get_pool_mode(pool) >= PM_OUT_OF_METADATA_SPACE) {
 		DMERR("%s: unable to service pool target messages in READ_ONLY or FAIL mode",
 		      dm_device_name(pool->pool_md));
@@ -4112,7 +4159,7 @@ static struct target_type pool_target = {
 	.name = "thin-pool",
 	.features = DM_TARGET_SINGLETON | DM_TARGET_ALWAYS_WRITEABLE |
 		    DM_TARGET_IMMUTABLE,
-	.version = {1, 23, 0},
+	.version = {1, 24, 0},
 	.module = THIS_MODULE,
 	.ctr = pool_ctr,
 	.dtr = pool_dtr,
@@ -4497,7 +4544,7 @@ static void thin_io_hints(struct dm_target *ti, struct queue_limits *limits)
 
 static struct target_type thin_target = {
 	.name = "thin",
-	.version = {1, 23, 0},
+	.version = {1, 24, 0},
 	.module	= THIS_MODULE,
 	.ctr = thin_ctr,
 	.dtr = thin_dtr,
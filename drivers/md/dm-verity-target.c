@@ -485,6 +485,73 @@ static int verity_handle_data_hash_mismatch(struct dm_verity *v,
 	return 0;
 }
 
+static void verity_clear_pending_blocks(struct dm_verity_io *io)
+{
+	int i;
+
+	for (i = io->num_pending - 1; i >= 0; i--)
+		kunmap_local(io->pending_blocks[i].data);
+	io->num_pending = 0;
+}
+
+/*
+ * Hash the pending data blocks, all at once if the hash implementation
+ * supports it, and check them against the hashes from the tree.
+ */
+static int verity_verify_pending_blocks(struct dm_verity *v,
+					struct dm_verity_io *io,
+					struct bio *bio)
+{
+	const unsigned int block_size = 1 << v->data_dev_block_bits;
+	const u8 *data[DM_VERITY_MAX_PENDING_DATA_BLOCKS];
+	u8 *real_digests[DM_VERITY_MAX_PENDING_DATA_BLOCKS];
+	unsigned int i;
+	int r;
+
+	if (io->num_pending == 1) {
+		struct pending_block *block = &io->pending_blocks[0];
+
+		r = verity_hash(v, io, block->data, block_size,
+				block->real_digest, !io->in_bh);
+	} else {
+		struct shash_desc *desc = verity_io_hash_req(v, io);
+
+		for (i = 0; i < io->num_pending; i++) {
+			data[i] = io->pending_blocks[i].data;
+			real_digests[i] = io->pending_blocks[i].real_digest;
+		}
+		desc->tfm = v->shash_tfm;
+		r = crypto_shash_import(desc, v->initial_hashstate) ?:
+		    crypto_shash_finup_mb(desc, data, block_size, real_digests,
+					  io->num_pending);
+		if (unlikely(r))
+			DMERR("Error hashing blocks: %d", r);
+	}
+	if (unlikely(r))
+		goto out;
+
+	for (i = 0; i < io->num_pending; i++) {
+		struct pending_block *block = &io->pending_blocks[i];
+
+		if (likely(memcmp(block->real_digest, block->want_digest,
+				  v->digest_size) == 0)) {
+			if (v->validated_blocks)
+				set_bit(block->blkno, v->validated_blocks);
+			continue;
+		}
+		/* Recheck and FEC look at the digests in the io */
+		memcpy(verity_io_want_digest(v, io), block->want_digest,
+		       v->digest_size);
+		r = verity_handle_data_hash_mismatch(v, io, bio, block->blkno,
+						     block->data);
+		if (unlikely(r))
+			break;
+	}
+out:
+	verity_clear_pending_blocks(io);
+	return r;
+}
+
 /*
  * Verify one "dm_verity_io" structure.
  */
@@ -496,6 +563,7 @@ static int verity_verify_io(struct dm_verity_io *io)
 	struct bvec_iter *iter;
 	struct bio *bio = dm_bio_from_per_bio_data(io, v->ti->per_io_data_size);
 	unsigned int b;
+	int r;
 
 	if (static_branch_unlikely(&use_bh_wq_enabled) && io->in_bh) {
 		/*
@@ -509,8 +577,8 @@ static int verity_verify_io(struct dm_verity_io *io)
 
 	for (b = 0; b < io->n_blocks;
 	     b++, bio_advance_iter(bio, iter, block_size)) {
-		int r;
 		sector_t cur_block = io->block + b;
+		struct pending_block *block;
 		bool is_zero;
 		struct bio_vec bv;
 		void *data;
@@ -519,11 +587,11 @@ static int verity_verify_io(struct dm_verity_io *io)
 		    likely(test_bit(cur_block, v->validated_blocks)))
 			continue;
 
-		r = verity_hash_for_block(v, io, cur_block,
-					  verity_io_want_digest(v, io),
+		block = &io->pending_blocks[io->num_pending];
+		r = verity_hash_for_block(v, io, cur_block, block->want_digest,
 					  &is_zero);
 		if (unlikely(r < 0))
-			return r;
+			goto error;
 
 		bv = bio_iter_iovec(bio, *iter);
 		if (unlikely(bv.bv_len < block_size)) {
@@ -534,7 +602,8 @@ static int verity_verify_io(struct dm_verity_io *io)
 			 * data block size to be greater than PAGE_SIZE.
 			 */
 			DMERR_LIMIT("unaligned io (data block spans pages)");
-			return -EIO;
+			r = -EIO;
+			goto error;
 		}
 
 		data = bvec_kmap_local(&bv);
@@ -549,28 +618,22 @@ static int verity_verify_io(struct dm_verity_io *io)
 			continue;
 		}
 
-		r = verity_hash(v, io, data, block_size,
-				verity_io_real_digest(v, io), !io->in_bh);
-		if (unlikely(r < 0)) {
-			kunmap_local(data);
-			return r;
-		}
-
-		if (likely(memcmp(verity_io_real_digest(v, io),
-				  verity_io_want_digest(v, io), v->digest_size) == 0)) {
-			if (v->validated_blocks)
-				set_bit(cur_block, v->validated_blocks);
-			kunmap_local(data);
-			continue;
+		block->data = data;
+		block->blkno = cur_block;
+		if (++io->num_pending == v->mb_max_msgs) {
+			r = verity_verify_pending_blocks(v, io, bio);
+			if (unlikely(r))
+				return r;
 		}
-		r = verity_handle_data_hash_mismatch(v, io, bio, cur_block,
-						     data);
-		kunmap_local(data);
-		if (unlikely(r))
-			return r;
 	}
 
+	if (io->num_pending)
+		return verity_verify_pending_blocks(v, io, bio);
 	return 0;
+
+error:
+	verity_clear_pending_blocks(io);
+	return r;
 }
 
 /*
@@ -754,6 +817,7 @@ static int verity_map(struct dm_target *ti, struct bio *bio)
 	io->orig_bi_end_io = bio->bi_end_io;
 	io->block = bio->bi_iter.bi_sector >> (v->data_dev_block_bits - SECTOR_SHIFT);
 	io->n_blocks = bio->bi_iter.bi_size >> v->data_dev_block_bits;
+	io->num_pending = 0;
 
 	bio->bi_end_io = verity_end_io;
 	bio->bi_private = io;
@@ -1192,6 +1256,9 @@ static int verity_setup_hash_alg(struct dm_verity *v, const char *alg_name)
 		v->digest_size = crypto_shash_digestsize(shash);
 		v->hash_reqsize = sizeof(struct shash_desc) +
 				  crypto_shash_descsize(shash);
+		v->mb_max_msgs = min_t(unsigned int,
+				       crypto_shash_mb_max_msgs(shash),
+				       DM_VERITY_MAX_PENDING_DATA_BLOCKS);
 		DMINFO("%s using shash \"%s\"", alg_name, driver_name);
 	} else {
 		v->ahash_tfm = ahash;
@@ -1199,6 +1266,7 @@ static int verity_setup_hash_alg(struct dm_verity *v, const char *alg_name)
 		v->digest_size = crypto_ahash_digestsize(ahash);
 		v->hash_reqsize = sizeof(struct ahash_request) +
 				  crypto_ahash_reqsize(ahash);
+		v->mb_max_msgs = 1;
 		DMINFO("%s using ahash \"%s\"", alg_name, driver_name);
 	}
 	if ((1 << v->hash_dev_block_bits) < v->digest_size * 2) {
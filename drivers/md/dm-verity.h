@@ -19,6 +19,9 @@
 
 #define DM_VERITY_MAX_LEVELS		63
 
+/* The maximum number of data blocks which are hashed at once */
+#define DM_VERITY_MAX_PENDING_DATA_BLOCKS	2
+
 enum verity_mode {
 	DM_VERITY_MODE_EIO,
 	DM_VERITY_MODE_LOGGING,
@@ -59,6 +62,7 @@ struct dm_verity {
 	bool use_bh_wq:1;	/* try to verify in BH wq before normal work-queue */
 	unsigned int digest_size;	/* digest size for the current hash algorithm */
 	unsigned int hash_reqsize; /* the size of temporary space for crypto */
+	unsigned int mb_max_msgs; /* data blocks to hash at once */
 	enum verity_mode mode;	/* mode for handling verification errors */
 	unsigned int corrupted_errs;/* Number of errors for corrupted blocks */
 
@@ -94,6 +98,15 @@ struct dm_verity_io {
 	u8 real_digest[HASH_MAX_DIGESTSIZE];
 	u8 want_digest[HASH_MAX_DIGESTSIZE];
 
+	/* Data blocks which are mapped and waiting to be hashed together */
+	struct pending_block {
+		void *data;
+		sector_t blkno;
+		u8 want_digest[HASH_MAX_DIGESTSIZE];
+		u8 real_digest[HASH_MAX_DIGESTSIZE];
+	} pending_blocks[DM_VERITY_MAX_PENDING_DATA_BLOCKS];
+	unsigned int num_pending;
+
 	/*
 	 * This struct is followed by a variable-sized hash request of size
 	 * v->hash_reqsize, either a struct ahash_request or a struct shash_desc
@@ -1000,6 +1000,7 @@ static void stripe_add_to_batch_list(struct r5conf *conf,
 	}
 
 	atomic_inc(&sh->count);
+	this_cpu_inc(conf->percpu->batched);
 unlock_out:
 	unlock_two_stripes(head, sh);
 out:
@@ -6004,6 +6005,7 @@ static enum stripe_result make_stripe_request(struct mddev *mddev,
 	}
 
 	if (stripe_can_batch(sh)) {
+		this_cpu_inc(conf->percpu->batch_candidates);
 		stripe_add_to_batch_list(conf, sh, ctx->batch_last);
 		if (ctx->batch_last)
 			raid5_release_stripe(ctx->batch_last);
@@ -7135,6 +7137,31 @@ stripe_cache_active_show(struct mddev *mddev, char *page)
 static struct md_sysfs_entry
 raid5_stripecache_active = __ATTR_RO(stripe_cache_active);
 
+static ssize_t
+stripe_batch_stats_show(struct mddev *mddev, char *page)
+{
+	unsigned long candidates = 0, batched = 0;
+	struct r5conf *conf;
+	int cpu, ret = 0;
+
+	spin_lock(&mddev->lock);
+	conf = mddev->private;
+	if (conf) {
+		for_each_possible_cpu(cpu) {
+			struct raid5_percpu *percpu = per_cpu_ptr(conf->percpu, cpu);
+
+			candidates += READ_ONCE(percpu->batch_candidates);
+			batched += READ_ONCE(percpu->batched);
+		}
+		ret = sprintf(page, "%lu %lu\n", candidates, batched);
+	}
+	spin_unlock(&mddev->lock);
+	return ret;
+}
+
+static struct md_sysfs_entry
+raid5_stripe_batch_stats = __ATTR_RO(stripe_batch_stats);
+
 static ssize_t
 raid5_show_group_thread_cnt(struct mddev *mddev, char *page)
 {
@@ -7205,6 +7232,7 @@ raid5_group_thread_cnt = __ATTR(group_thread_cnt, S_IRUGO | S_IWUSR,
 static struct attribute *raid5_attrs[] =  {
 	&raid5_stripecache_size.attr,
 	&raid5_stripecache_active.attr,
+	&raid5_stripe_batch_stats.attr,
 	&raid5_preread_bypass_threshold.attr,
 	&raid5_group_thread_cnt.attr,
 	&raid5_skip_copy.attr,
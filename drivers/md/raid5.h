@@ -569,6 +569,9 @@ struct raid5_percpu {
 				     */
 	int             scribble_obj_size;
 	local_lock_t    lock;
+	/* full stripe writes that could be batched, and that were */
+	unsigned long	batch_candidates;
+	unsigned long	batched;
 };
 
 struct r5conf {
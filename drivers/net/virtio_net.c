@@ -110,6 +110,9 @@ struct virtnet_rq_stats {
 	u64_stats_t xdp_redirects;
 	u64_stats_t xdp_drops;
 	u64_stats_t kicks;
+	u64_stats_t refills;
+	u64_stats_t refill_bufs;
+	u64_stats_t kicks_suppressed;
 };
 
 #define VIRTNET_SQ_STAT(name, m) {name, offsetof(struct virtnet_sq_stats, m), -1}
@@ -143,6 +146,9 @@ static const struct virtnet_stat_desc virtnet_rq_stats_desc[] = {
 	VIRTNET_RQ_STAT("xdp_redirects", xdp_redirects),
 	VIRTNET_RQ_STAT("xdp_drops",     xdp_drops),
 	VIRTNET_RQ_STAT("kicks",         kicks),
+	VIRTNET_RQ_STAT("refills",       refills),
+	VIRTNET_RQ_STAT("refill_bufs",   refill_bufs),
+	VIRTNET_RQ_STAT("kicks_suppressed", kicks_suppressed),
 };
 
 static const struct virtnet_stat_desc virtnet_sq_stats_desc_qstat[] = {
@@ -2560,10 +2566,15 @@ static int add_recvbuf_mergeable(struct virtnet_info *vi,
 static bool try_fill_recv(struct virtnet_info *vi, struct receive_queue *rq,
 			  gfp_t gfp)
 {
+	unsigned long flags;
+	unsigned int nr = 0;
+	bool kicked;
 	int err;
 
 	if (rq->xsk_pool) {
 		err = virtnet_add_recvbuf_xsk(vi, rq, rq->xsk_pool, gfp);
+		if (err > 0)
+			nr = err;
 		goto kick;
 	}
 
@@ -2577,16 +2588,21 @@ static bool try_fill_recv(struct virtnet_info *vi, struct receive_queue *rq,
 
 		if (err)
 			break;
+		nr++;
 	} while (rq->vq->num_free);
 
 kick:
-	if (virtqueue_kick_prepare(rq->vq) && virtqueue_notify(rq->vq)) {
-		unsigned long flags;
+	/* all buffers added above are published with a single notification */
+	kicked = virtqueue_kick_prepare(rq->vq) && virtqueue_notify(rq->vq);
 
-		flags = u64_stats_update_begin_irqsave(&rq->stats.syncp);
+	flags = u64_stats_update_begin_irqsave(&rq->stats.syncp);
+	u64_stats_inc(&rq->stats.refills);
+	u64_stats_add(&rq->stats.refill_bufs, nr);
+	if (kicked)
 		u64_stats_inc(&rq->stats.kicks);
-		u64_stats_update_end_irqrestore(&rq->stats.syncp, flags);
-	}
+	else if (nr)
+		u64_stats_inc(&rq->stats.kicks_suppressed);
+	u64_stats_update_end_irqrestore(&rq->stats.syncp, flags);
 
 	return err != -ENOMEM;
 }
@@ -112,6 +112,24 @@ static struct request *nvme_alloc_user_request(struct request_queue *q,
 	return req;
 }
 
+/*
+ * With a fixed buffer, metadata that lives inside the same registered buffer
+ * is mapped from it directly, without pinning its pages again for each
+ * command. Returns -EFAULT if the metadata is outside the registered buffer.
+ */
+static int nvme_map_fixed_meta(struct bio *bio, void __user *meta_buffer,
+		unsigned meta_len, u32 meta_seed, struct io_uring_cmd *ioucmd)
+{
+	struct iov_iter iter;
+	int ret;
+
+	ret = io_uring_cmd_import_fixed((u64)(uintptr_t)meta_buffer, meta_len,
+			bio_data_dir(bio), &iter, ioucmd);
+	if (ret < 0)
+		return ret;
+	return bio_integrity_map_iter(bio, &iter, meta_seed);
+}
+
 static int nvme_map_user_request(struct request *req, u64 ubuffer,
 		unsigned bufflen, void __user *meta_buffer, unsigned meta_len,
 		u32 meta_seed, struct io_uring_cmd *ioucmd, unsigned int flags)
@@ -146,8 +164,14 @@ static int nvme_map_user_request(struct request *req, u64 ubuffer,
 	if (bdev) {
 		bio_set_dev(bio, bdev);
 		if (meta_buffer && meta_len) {
-			ret = bio_integrity_map_user(bio, meta_buffer, meta_len,
-						     meta_seed);
+			ret = -EFAULT;
+			if (ioucmd && (ioucmd->flags & IORING_URING_CMD_FIXED))
+				ret = nvme_map_fixed_meta(bio, meta_buffer,
+						meta_len, meta_seed, ioucmd);
+			/* not in the fixed buffer, or it needs bouncing */
+			if (ret == -EFAULT || ret == -EOPNOTSUPP)
+				ret = bio_integrity_map_user(bio, meta_buffer,
+						meta_len, meta_seed);
 			if (ret)
 				goto out_unmap;
 			req->cmd_flags |= REQ_INTEGRITY;
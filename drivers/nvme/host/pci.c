@@ -521,11 +521,11 @@ static inline bool nvme_pci_use_sgls(struct nvme_dev *dev, struct request *req,
 	return true;
 }
 
-static void nvme_free_prps(struct nvme_dev *dev, struct request *req)
+static void nvme_free_prps(struct nvme_dev *dev, struct request *req,
+		dma_addr_t dma_addr)
 {
 	const int last_prp = NVME_CTRL_PAGE_SIZE / sizeof(__le64) - 1;
 	struct nvme_iod *iod = blk_mq_rq_to_pdu(req);
-	dma_addr_t dma_addr = iod->first_dma;
 	int i;
 
 	for (i = 0; i < iod->nr_allocations; i++) {
@@ -537,6 +537,21 @@ static void nvme_free_prps(struct nvme_dev *dev, struct request *req)
 	}
 }
 
+static void nvme_free_descriptors(struct nvme_dev *dev, struct request *req,
+		dma_addr_t dma_addr)
+{
+	struct nvme_iod *iod = blk_mq_rq_to_pdu(req);
+
+	if (iod->nr_allocations == 0)
+		dma_pool_free(dev->prp_small_pool, iod->list[0].sg_list,
+			      dma_addr);
+	else if (iod->nr_allocations == 1)
+		dma_pool_free(dev->prp_page_pool, iod->list[0].sg_list,
+			      dma_addr);
+	else
+		nvme_free_prps(dev, req, dma_addr);
+}
+
 static void nvme_unmap_data(struct nvme_dev *dev, struct request *req)
 {
 	struct nvme_iod *iod = blk_mq_rq_to_pdu(req);
@@ -544,21 +559,17 @@ static void nvme_unmap_data(struct nvme_dev *dev, struct request *req)
 	if (iod->dma_len) {
 		dma_unmap_page(dev->dev, iod->first_dma, iod->dma_len,
 			       rq_dma_dir(req));
+		/* single segment with a PRP list, see nvme_setup_prp_list_simple() */
+		if (iod->nr_allocations >= 0)
+			nvme_free_descriptors(dev, req,
+					le64_to_cpu(iod->cmd.common.dptr.prp2));
 		return;
 	}
 
 	WARN_ON_ONCE(!iod->sgt.nents);
 
 	dma_unmap_sgtable(dev->dev, &iod->sgt, rq_dma_dir(req), 0);
-
-	if (iod->nr_allocations == 0)
-		dma_pool_free(dev->prp_small_pool, iod->list[0].sg_list,
-			      iod->first_dma);
-	else if (iod->nr_allocations == 1)
-		dma_pool_free(dev->prp_page_pool, iod->list[0].sg_list,
-			      iod->first_dma);
-	else
-		nvme_free_prps(dev, req);
+	nvme_free_descriptors(dev, req, iod->first_dma);
 	mempool_free(iod->sgt.sgl, dev->iod_mempool);
 }
 
@@ -657,7 +668,7 @@ static blk_status_t nvme_pci_setup_prps(struct nvme_dev *dev,
 	cmnd->dptr.prp2 = cpu_to_le64(iod->first_dma);
 	return BLK_STS_OK;
 free_prps:
-	nvme_free_prps(dev, req);
+	nvme_free_prps(dev, req, iod->first_dma);
 	return BLK_STS_RESOURCE;
 bad_sgl:
 	WARN(DO_ONCE(nvme_print_sgl, iod->sgt.sgl, iod->sgt.nents),
@@ -748,6 +759,78 @@ static blk_status_t nvme_setup_prp_simple(struct nvme_dev *dev,
 	return BLK_STS_OK;
 }
 
+/*
+ * A single physically contiguous segment that needs a PRP list, e.g. a large
+ * I/O from a registered buffer backed by huge pages.  Build the list straight
+ * from the one DMA mapping instead of going through a scatterlist.
+ */
+static blk_status_t nvme_setup_prp_list_simple(struct nvme_dev *dev,
+		struct request *req, struct nvme_rw_command *cmnd,
+		struct bio_vec *bv)
+{
+	struct nvme_iod *iod = blk_mq_rq_to_pdu(req);
+	unsigned int offset = bv->bv_offset & (NVME_CTRL_PAGE_SIZE - 1);
+	int length = bv->bv_len - (NVME_CTRL_PAGE_SIZE - offset);
+	struct dma_pool *pool;
+	dma_addr_t dma_addr, prp_dma;
+	__le64 *prp_list;
+	int nprps, i;
+
+	iod->first_dma = dma_map_bvec(dev->dev, bv, rq_dma_dir(req), 0);
+	if (dma_mapping_error(dev->dev, iod->first_dma))
+		return BLK_STS_RESOURCE;
+	iod->dma_len = bv->bv_len;
+	dma_addr = iod->first_dma + (NVME_CTRL_PAGE_SIZE - offset);
+
+	nprps = DIV_ROUND_UP(length, NVME_CTRL_PAGE_SIZE);
+	if (nprps <= (256 / 8)) {
+		pool = dev->prp_small_pool;
+		iod->nr_allocations = 0;
+	} else {
+		pool = dev->prp_page_pool;
+		iod->nr_allocations = 1;
+	}
+
+	prp_list = dma_pool_alloc(pool, GFP_ATOMIC, &prp_dma);
+	if (!prp_list) {
+		iod->nr_allocations = -1;
+		goto out_unmap;
+	}
+	iod->list[0].prp_list = prp_list;
+
+	/* prp2 is also where nvme_unmap_data() finds the list again */
+	cmnd->dptr.prp1 = cpu_to_le64(iod->first_dma);
+	cmnd->dptr.prp2 = cpu_to_le64(prp_dma);
+
+	i = 0;
+	for (;;) {
+		if (i == NVME_CTRL_PAGE_SIZE >> 3) {
+			__le64 *old_prp_list = prp_list;
+
+			prp_list = dma_pool_alloc(pool, GFP_ATOMIC, &prp_dma);
+			if (!prp_list)
+				goto free_prps;
+			iod->list[iod->nr_allocations++].prp_list = prp_list;
+			prp_list[0] = old_prp_list[i - 1];
+			old_prp_list[i - 1] = cpu_to_le64(prp_dma);
+			i = 1;
+		}
+		prp_list[i++] = cpu_to_le64(dma_addr);
+		dma_addr += NVME_CTRL_PAGE_SIZE;
+		length -= NVME_CTRL_PAGE_SIZE;
+		if (length <= 0)
+			break;
+	}
+	return BLK_STS_OK;
+
+free_prps:
+	nvme_free_prps(dev, req, le64_to_cpu(cmnd->dptr.prp2));
+	iod->nr_allocations = -1;
+out_unmap:
+	dma_unmap_page(dev->dev, iod->first_dma, iod->dma_len, rq_dma_dir(req));
+	return BLK_STS_RESOURCE;
+}
+
 static blk_status_t nvme_setup_sgl_simple(struct nvme_dev *dev,
 		struct request *req, struct nvme_rw_command *cmnd,
 		struct bio_vec *bv)
@@ -787,6 +870,9 @@ static blk_status_t nvme_map_data(struct nvme_dev *dev, struct request *req,
 			    nvme_ctrl_sgl_supported(&dev->ctrl))
 				return nvme_setup_sgl_simple(dev, req,
 							     &cmnd->rw, &bv);
+
+			return nvme_setup_prp_list_simple(dev, req,
+							  &cmnd->rw, &bv);
 		}
 	}
 
@@ -44,6 +44,15 @@ static bool wq_unbound;
 module_param(wq_unbound, bool, 0644);
 MODULE_PARM_DESC(wq_unbound, "Use unbound workqueue for nvme-tcp IO context (default false)");
 
+/*
+ * Move the io_work of a queue to the CPU its socket receives data on, so that
+ * the RX softirq, the PDU processing and the request completion share a CPU
+ * instead of bouncing the work (and the queue cachelines) between two.
+ */
+static bool wq_follow_rx;
+module_param(wq_follow_rx, bool, 0644);
+MODULE_PARM_DESC(wq_follow_rx, "Run nvme-tcp IO context on the socket RX CPU (default false)");
+
 /*
  * TLS handshake timeout
  */
@@ -964,8 +973,13 @@ static void nvme_tcp_data_ready(struct sock *sk)
 	read_lock_bh(&sk->sk_callback_lock);
 	queue = sk->sk_user_data;
 	if (likely(queue && queue->rd_enabled) &&
-	    !test_bit(NVME_TCP_Q_POLLING, &queue->flags))
+	    !test_bit(NVME_TCP_Q_POLLING, &queue->flags)) {
+		/* we are called from the RX softirq, on the RX CPU */
+		if (wq_follow_rx && !wq_unbound &&
+		    queue->io_cpu != raw_smp_processor_id())
+			WRITE_ONCE(queue->io_cpu, raw_smp_processor_id());
 		queue_work_on(queue->io_cpu, nvme_tcp_wq, &queue->io_work);
+	}
 	read_unlock_bh(&sk->sk_callback_lock);
 }
 
@@ -338,6 +338,40 @@ static struct vfio_pfn *vfio_find_vpfn(struct vfio_dma *dma, dma_addr_t iova)
 	return NULL;
 }
 
+/*
+ * Count the externally pinned pages, which are already accounted against
+ * the user, in [iova, iova + npage pages).
+ */
+static long vfio_vpfn_pages(struct vfio_dma *dma, dma_addr_t iova, long npage)
+{
+	dma_addr_t end = iova + ((dma_addr_t)npage << PAGE_SHIFT);
+	struct rb_node *node = dma->pfn_list.rb_node, *first = NULL;
+	struct vfio_pfn *vpfn;
+	long count = 0;
+
+	/* Find the leftmost vpfn in the range. */
+	while (node) {
+		vpfn = rb_entry(node, struct vfio_pfn, node);
+
+		if (vpfn->iova < iova) {
+			node = node->rb_right;
+		} else {
+			if (vpfn->iova < end)
+				first = node;
+			node = node->rb_left;
+		}
+	}
+
+	for (node = first; node; node = rb_next(node)) {
+		vpfn = rb_entry(node, struct vfio_pfn, node);
+		if (vpfn->iova >= end)
+			break;
+		count++;
+	}
+
+	return count;
+}
+
 static void vfio_link_pfn(struct vfio_dma *dma,
 			  struct vfio_pfn *new)
 {
@@ -503,6 +537,33 @@ static void vfio_batch_unpin(struct vfio_batch *batch, struct vfio_dma *dma)
 	}
 }
 
+/*
+ * Return the number of pages at the start of the batch which are
+ * physically contiguous and of the same reserved state as the first.
+ */
+static long vfio_batch_contig_pages(struct vfio_batch *batch)
+{
+	struct page **pages = &batch->pages[batch->offset];
+	unsigned long pfn;
+	bool rsvd;
+	long i;
+
+	/* A single entry may be a VM_PFNMAP pfn with no struct page. */
+	if (batch->size == 1)
+		return 1;
+
+	pfn = page_to_pfn(pages[0]);
+	rsvd = is_invalid_reserved_pfn(pfn);
+
+	for (i = 1; i < batch->size; i++) {
+		if (page_to_pfn(pages[i]) != pfn + i ||
+		    is_invalid_reserved_pfn(pfn + i) != rsvd)
+			break;
+	}
+
+	return i;
+}
+
 static void vfio_batch_fini(struct vfio_batch *batch)
 {
 	if (batch->capacity == VFIO_BATCH_MAX_CAPACITY)
@@ -649,32 +710,44 @@ static long vfio_pin_pages_remote(struct vfio_dma *dma, unsigned long vaddr,
 		 * !VM_PFNMAP vma.
 		 */
 		while (true) {
+			long nr_pages, acct_pages = 0;
+
 			if (pfn != *pfn_base + pinned ||
 			    rsvd != is_invalid_reserved_pfn(pfn))
 				goto out;
 
+			/*
+			 * Consume the physically contiguous run at the start
+			 * of the batch, e.g. the rest of a large folio, in one
+			 * go rather than page by page.
+			 */
+			nr_pages = min_t(long, vfio_batch_contig_pages(batch), npage);
+
 			/*
 			 * Reserved pages aren't counted against the user,
 			 * externally pinned pages are already counted against
 			 * the user.
 			 */
-			if (!rsvd && !vfio_find_vpfn(dma, iova)) {
+			if (!rsvd)
+				acct_pages = nr_pages - vfio_vpfn_pages(dma, iova, nr_pages);
+
+			if (acct_pages) {
 				if (!dma->lock_cap &&
-				    mm->locked_vm + lock_acct + 1 > limit) {
+				    mm->locked_vm + lock_acct + acct_pages > limit) {
 					pr_warn("%s: RLIMIT_MEMLOCK (%ld) exceeded\n",
 						__func__, limit << PAGE_SHIFT);
 					ret = -ENOMEM;
 					goto unpin_out;
 				}
-				lock_acct++;
+				lock_acct += acct_pages;
 			}
 
-			pinned++;
-			npage--;
-			vaddr += PAGE_SIZE;
-			iova += PAGE_SIZE;
-			batch->offset++;
-			batch->size--;
+			pinned += nr_pages;
+			npage -= nr_pages;
+			vaddr += PAGE_SIZE * nr_pages;
+			iova += PAGE_SIZE * nr_pages;
+			batch->offset += nr_pages;
+			batch->size -= nr_pages;
 
 			if (!batch->size)
 				break;
@@ -714,14 +787,24 @@ static long vfio_unpin_pages_remote(struct vfio_dma *dma, dma_addr_t iova,
 				    bool do_accounting)
 {
 	long unlocked = 0, locked = 0;
-	long i;
 
-	for (i = 0; i < npage; i++, iova += PAGE_SIZE) {
-		if (put_pfn(pfn++, dma->prot)) {
-			unlocked++;
-			if (vfio_find_vpfn(dma, iova))
-				locked++;
+	while (npage) {
+		bool rsvd = is_invalid_reserved_pfn(pfn);
+		long nr = 1;
+
+		while (nr < npage && is_invalid_reserved_pfn(pfn + nr) == rsvd)
+			nr++;
+
+		if (!rsvd) {
+			unpin_user_page_range_dirty_lock(pfn_to_page(pfn), nr,
+							 dma->prot & IOMMU_WRITE);
+			unlocked += nr;
+			locked += vfio_vpfn_pages(dma, iova, nr);
 		}
+
+		pfn += nr;
+		iova += (dma_addr_t)nr << PAGE_SHIFT;
+		npage -= nr;
 	}
 
 	if (do_accounting)
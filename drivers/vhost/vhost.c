@@ -386,6 +386,10 @@ static void vhost_vq_reset(struct vhost_dev *dev,
 	rcu_assign_pointer(vq->worker, NULL);
 	vhost_vring_call_reset(&vq->call_ctx);
 	__vhost_vq_meta_reset(vq);
+	vq->used_batches = 0;
+	vq->used_bufs = 0;
+	vq->signals = 0;
+	vq->signals_suppressed = 0;
 }
 
 static bool vhost_run_work_list(void *data)
@@ -2058,6 +2062,19 @@ long vhost_vring_ioctl(struct vhost_dev *d, unsigned int ioctl, void __user *arg
 	case VHOST_GET_VRING_ENDIAN:
 		r = vhost_get_vring_endian(vq, idx, argp);
 		break;
+	case VHOST_GET_VRING_STATS: {
+		struct vhost_vring_stats st = {
+			.index = idx,
+			.used_batches = vq->used_batches,
+			.used_bufs = vq->used_bufs,
+			.signals = vq->signals,
+			.signals_suppressed = vq->signals_suppressed,
+		};
+
+		if (copy_to_user(argp, &st, sizeof(st)))
+			r = -EFAULT;
+		break;
+	}
 	case VHOST_SET_VRING_BUSYLOOP_TIMEOUT:
 		if (copy_from_user(&s, argp, sizeof(s))) {
 			r = -EFAULT;
@@ -2752,6 +2769,9 @@ int vhost_add_used_n(struct vhost_virtqueue *vq, struct vring_used_elem *heads,
 {
 	int start, n, r;
 
+	vq->used_batches++;
+	vq->used_bufs += count;
+
 	start = vq->last_used_idx & (vq->num - 1);
 	n = vq->num - start;
 	if (n < count) {
@@ -2822,9 +2842,16 @@ static bool vhost_notify(struct vhost_dev *dev, struct vhost_virtqueue *vq)
 /* This actually signals the guest, using eventfd. */
 void vhost_signal(struct vhost_dev *dev, struct vhost_virtqueue *vq)
 {
+	if (!vq->call_ctx.ctx)
+		return;
+
 	/* Signal the Guest tell them we used something up. */
-	if (vq->call_ctx.ctx && vhost_notify(dev, vq))
+	if (vhost_notify(dev, vq)) {
 		eventfd_signal(vq->call_ctx.ctx);
+		vq->signals++;
+	} else {
+		vq->signals_suppressed++;
+	}
 }
 EXPORT_SYMBOL_GPL(vhost_signal);
 
@@ -148,6 +148,12 @@ struct vhost_virtqueue {
 	bool user_be;
 #endif
 	u32 busyloop_timeout;
+
+	/* Protected by virtqueue mutex. */
+	u64 used_batches;
+	u64 used_bufs;
+	u64 signals;
+	u64 signals_suppressed;
 };
 
 struct vhost_msg_node {
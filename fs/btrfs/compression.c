@@ -894,6 +894,69 @@ struct list_head *btrfs_get_workspace(int type, unsigned int level)
 	return workspace;
 }
 
+/*
+ * Idle workspaces of the generic managers are kept around for reuse, up to
+ * one per online CPU.  Under memory pressure release all but one of them per
+ * type, the last one is kept to preserve the forward progress guarantee of
+ * the preallocated workspace.
+ */
+static struct shrinker *btrfs_ws_shrinker;
+
+static const int btrfs_generic_ws_types[] = {
+	BTRFS_COMPRESS_NONE,
+	BTRFS_COMPRESS_ZLIB,
+	BTRFS_COMPRESS_LZO,
+};
+
+static unsigned long btrfs_ws_shrink_count(struct shrinker *sh,
+					   struct shrink_control *sc)
+{
+	unsigned long count = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(btrfs_generic_ws_types); i++) {
+		struct workspace_manager *wsm;
+		int free_ws;
+
+		wsm = btrfs_compress_op[btrfs_generic_ws_types[i]]->workspace_manager;
+		free_ws = READ_ONCE(wsm->free_ws);
+		if (free_ws > 1)
+			count += free_ws - 1;
+	}
+
+	return count;
+}
+
+static unsigned long btrfs_ws_shrink_scan(struct shrinker *sh,
+					  struct shrink_control *sc)
+{
+	unsigned long freed = 0;
+
+	for (int i = 0; i < ARRAY_SIZE(btrfs_generic_ws_types); i++) {
+		const int type = btrfs_generic_ws_types[i];
+		struct workspace_manager *wsm;
+		LIST_HEAD(remove);
+		struct list_head *ws, *next;
+
+		wsm = btrfs_compress_op[type]->workspace_manager;
+		spin_lock(&wsm->ws_lock);
+		while (wsm->free_ws > 1 && freed < sc->nr_to_scan) {
+			ws = wsm->idle_ws.prev;
+			list_move(ws, &remove);
+			wsm->free_ws--;
+			freed++;
+		}
+		spin_unlock(&wsm->ws_lock);
+
+		list_for_each_safe(ws, next, &remove) {
+			list_del(ws);
+			free_workspace(type, ws);
+			atomic_dec(&wsm->total_ws);
+		}
+	}
+
+	return freed ? freed : SHRINK_STOP;
+}
+
 static struct list_head *get_workspace(int type, int level)
 {
 	switch (type) {
@@ -1096,6 +1159,16 @@ int __init btrfs_init_compress(void)
 	btrfs_init_workspace_manager(BTRFS_COMPRESS_LZO);
 	zstd_init_workspace_manager();
 
+	btrfs_ws_shrinker = shrinker_alloc(0, "btrfs-compr-ws");
+	if (btrfs_ws_shrinker) {
+		btrfs_ws_shrinker->count_objects = btrfs_ws_shrink_count;
+		btrfs_ws_shrinker->scan_objects = btrfs_ws_shrink_scan;
+		btrfs_ws_shrinker->seeks = DEFAULT_SEEKS;
+		shrinker_register(btrfs_ws_shrinker);
+	} else {
+		pr_warn("BTRFS: cannot register compression workspace shrinker\n");
+	}
+
 	spin_lock_init(&compr_pool.lock);
 	INIT_LIST_HEAD(&compr_pool.list);
 	compr_pool.count = 0;
@@ -1115,6 +1188,7 @@ void __cold btrfs_exit_compress(void)
 	/* For now scan drains all pages and does not touch the parameters. */
 	btrfs_compr_pool_scan(NULL, NULL);
 	shrinker_free(compr_pool.shrinker);
+	shrinker_free(btrfs_ws_shrinker);
 
 	btrfs_cleanup_workspace_manager(BTRFS_COMPRESS_NONE);
 	btrfs_cleanup_workspace_manager(BTRFS_COMPRESS_ZLIB);
@@ -755,6 +755,7 @@ blk_status_t btrfs_csum_one_bio(struct btrfs_bio *bbio)
 	unsigned int blockcount;
 	int i;
 	unsigned nofs_flag;
+	u64 start;
 
 	nofs_flag = memalloc_nofs_save();
 	sums = kvzalloc(btrfs_ordered_sum_size(fs_info, bio->bi_iter.bi_size),
@@ -771,24 +772,30 @@ blk_status_t btrfs_csum_one_bio(struct btrfs_bio *bbio)
 	index = 0;
 
 	shash->tfm = fs_info->csum_shash;
+	start = ktime_get_ns();
 
 	bio_for_each_segment(bvec, bio, iter) {
 		blockcount = BTRFS_BYTES_TO_BLKS(fs_info,
 						 bvec.bv_len + fs_info->sectorsize
 						 - 1);
 
+		/* A single page segment, map it once for all of its blocks. */
+		data = bvec_kmap_local(&bvec);
 		for (i = 0; i < blockcount; i++) {
-			data = bvec_kmap_local(&bvec);
 			crypto_shash_digest(shash,
 					    data + (i * fs_info->sectorsize),
 					    fs_info->sectorsize,
 					    sums->sums + index);
-			kunmap_local(data);
 			index += fs_info->csum_size;
 		}
-
+		kunmap_local(data);
 	}
 
+	/* Every bio adds well above the default batch, fold less often */
+	percpu_counter_add_batch(&fs_info->csum_write_bytes, sums->len, SZ_16M);
+	percpu_counter_add_batch(&fs_info->csum_write_ns,
+				 ktime_get_ns() - start, NSEC_PER_MSEC);
+
 	bbio->sums = sums;
 	btrfs_add_ordered_sum(ordered, sums);
 	return 0;
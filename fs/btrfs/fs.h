@@ -392,6 +392,24 @@ enum btrfs_exclusive_operation {
 	BTRFS_EXCLOP_SWAP_ACTIVATE,
 };
 
+/*
+ * Phases of btrfs_commit_transaction() accounted in struct btrfs_commit_stats.
+ * They are contiguous, so their durations add up to the commit duration.
+ */
+enum btrfs_commit_phase {
+	/* Flush delalloc and delayed items, wait for writers to leave */
+	BTRFS_COMMIT_PHASE_FLUSH,
+	/* Create pending snapshots, run delayed items and delayed refs */
+	BTRFS_COMMIT_PHASE_DELAYED_REFS,
+	/* Commit fs and cowonly roots, qgroup accounting */
+	BTRFS_COMMIT_PHASE_ROOTS,
+	/* Write and wait the transaction and the super blocks */
+	BTRFS_COMMIT_PHASE_WRITEBACK,
+	/* Unpin extents and release the transaction */
+	BTRFS_COMMIT_PHASE_FINISH,
+	BTRFS_COMMIT_PHASE_NR,
+};
+
 /* Store data about transaction commits, exported via sysfs. */
 struct btrfs_commit_stats {
 	/* Total number of commits */
@@ -402,6 +420,9 @@ struct btrfs_commit_stats {
 	u64 last_commit_dur;
 	/* The total commit duration in ns */
 	u64 total_commit_dur;
+	/* The last and total duration of each commit phase in ns */
+	u64 last_phase_dur[BTRFS_COMMIT_PHASE_NR];
+	u64 total_phase_dur[BTRFS_COMMIT_PHASE_NR];
 };
 
 struct btrfs_fs_info {
@@ -845,6 +866,10 @@ struct btrfs_fs_info {
 	/* Updates are not protected by any lock */
 	struct btrfs_commit_stats commit_stats;
 
+	/* Data bytes checksummed at write time and the time spent doing so */
+	struct percpu_counter csum_write_bytes;
+	struct percpu_counter csum_write_ns;
+
 	/*
 	 * Last generation where we dropped a non-relocation root.
 	 * Use btrfs_set_last_root_drop_gen() and btrfs_get_last_root_drop_gen()
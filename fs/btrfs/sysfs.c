@@ -1133,20 +1133,42 @@ static ssize_t btrfs_sectorsize_show(struct kobject *kobj,
 
 BTRFS_ATTR(, sectorsize, btrfs_sectorsize_show);
 
+static const char * const btrfs_commit_phase_names[BTRFS_COMMIT_PHASE_NR] = {
+	[BTRFS_COMMIT_PHASE_FLUSH]		= "flush",
+	[BTRFS_COMMIT_PHASE_DELAYED_REFS]	= "delayed_refs",
+	[BTRFS_COMMIT_PHASE_ROOTS]		= "roots",
+	[BTRFS_COMMIT_PHASE_WRITEBACK]		= "writeback",
+	[BTRFS_COMMIT_PHASE_FINISH]		= "finish",
+};
+
 static ssize_t btrfs_commit_stats_show(struct kobject *kobj,
 				       struct kobj_attribute *a, char *buf)
 {
 	struct btrfs_fs_info *fs_info = to_fs_info(kobj);
+	struct btrfs_commit_stats *stats = &fs_info->commit_stats;
+	ssize_t ret;
+	int i;
 
-	return sysfs_emit(buf,
+	ret = sysfs_emit(buf,
 		"commits %llu\n"
 		"last_commit_ms %llu\n"
 		"max_commit_ms %llu\n"
 		"total_commit_ms %llu\n",
-		fs_info->commit_stats.commit_count,
-		div_u64(fs_info->commit_stats.last_commit_dur, NSEC_PER_MSEC),
-		div_u64(fs_info->commit_stats.max_commit_dur, NSEC_PER_MSEC),
-		div_u64(fs_info->commit_stats.total_commit_dur, NSEC_PER_MSEC));
+		stats->commit_count,
+		div_u64(stats->last_commit_dur, NSEC_PER_MSEC),
+		div_u64(stats->max_commit_dur, NSEC_PER_MSEC),
+		div_u64(stats->total_commit_dur, NSEC_PER_MSEC));
+
+	for (i = 0; i < BTRFS_COMMIT_PHASE_NR; i++)
+		ret += sysfs_emit_at(buf, ret, "last_%s_ms %llu\n",
+				     btrfs_commit_phase_names[i],
+				     div_u64(stats->last_phase_dur[i], NSEC_PER_MSEC));
+	for (i = 0; i < BTRFS_COMMIT_PHASE_NR; i++)
+		ret += sysfs_emit_at(buf, ret, "total_%s_ms %llu\n",
+				     btrfs_commit_phase_names[i],
+				     div_u64(stats->total_phase_dur[i], NSEC_PER_MSEC));
+
+	return ret;
 }
 
 static ssize_t btrfs_commit_stats_store(struct kobject *kobj,
@@ -1248,6 +1270,23 @@ static ssize_t btrfs_checksum_show(struct kobject *kobj,
 
 BTRFS_ATTR(, checksum, btrfs_checksum_show);
 
+static ssize_t btrfs_csum_stats_show(struct kobject *kobj,
+				     struct kobj_attribute *a, char *buf)
+{
+	struct btrfs_fs_info *fs_info = to_fs_info(kobj);
+	u64 bytes = percpu_counter_sum_positive(&fs_info->csum_write_bytes);
+	u64 ns = percpu_counter_sum_positive(&fs_info->csum_write_ns);
+
+	return sysfs_emit(buf,
+		"write_bytes %llu\n"
+		"write_ns %llu\n"
+		"write_mbps %llu\n",
+		bytes, ns,
+		ns ? div64_u64(bytes * NSEC_PER_USEC, ns) : 0);
+}
+
+BTRFS_ATTR(, csum_stats, btrfs_csum_stats_show);
+
 static ssize_t btrfs_exclusive_operation_show(struct kobject *kobj,
 		struct kobj_attribute *a, char *buf)
 {
@@ -1444,6 +1483,7 @@ static const struct attribute *btrfs_attrs[] = {
 	BTRFS_ATTR_PTR(, quota_override),
 	BTRFS_ATTR_PTR(, metadata_uuid),
 	BTRFS_ATTR_PTR(, checksum),
+	BTRFS_ATTR_PTR(, csum_stats),
 	BTRFS_ATTR_PTR(, exclusive_operation),
 	BTRFS_ATTR_PTR(, generation),
 	BTRFS_ATTR_PTR(, read_policy),
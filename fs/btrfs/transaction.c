@@ -2153,13 +2153,33 @@ static void add_pending_snapshot(struct btrfs_trans_handle *trans)
 	list_add(&trans->pending_snapshot->list, &cur_trans->pending_snapshots);
 }
 
-static void update_commit_stats(struct btrfs_fs_info *fs_info, ktime_t interval)
+static void update_commit_stats(struct btrfs_fs_info *fs_info, ktime_t interval,
+				const u64 *phase_dur)
 {
+	int i;
+
 	fs_info->commit_stats.commit_count++;
 	fs_info->commit_stats.last_commit_dur = interval;
 	fs_info->commit_stats.max_commit_dur =
 			max_t(u64, fs_info->commit_stats.max_commit_dur, interval);
 	fs_info->commit_stats.total_commit_dur += interval;
+
+	for (i = 0; i < BTRFS_COMMIT_PHASE_NR; i++) {
+		fs_info->commit_stats.last_phase_dur[i] = phase_dur[i];
+		fs_info->commit_stats.total_phase_dur[i] += phase_dur[i];
+	}
+}
+
+/*
+ * Account the time since *phase_start to @phase and start the next phase.
+ */
+static void commit_phase_end(u64 *phase_dur, enum btrfs_commit_phase phase,
+			     u64 *phase_start)
+{
+	u64 now = ktime_get_ns();
+
+	phase_dur[phase] = now - *phase_start;
+	*phase_start = now;
 }
 
 int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
@@ -2170,6 +2190,8 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 	int ret;
 	ktime_t start_time;
 	ktime_t interval;
+	u64 phase_dur[BTRFS_COMMIT_PHASE_NR];
+	u64 phase_start;
 
 	ASSERT(refcount_read(&trans->use_count) == 1);
 	btrfs_trans_state_lockdep_acquire(fs_info, BTRFS_LOCKDEP_TRANS_COMMIT_PREP);
@@ -2304,6 +2326,7 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 	 * the time spent waiting on a previous commit
 	 */
 	start_time = ktime_get_ns();
+	phase_start = start_time;
 
 	extwriter_counter_dec(cur_trans, trans->type);
 
@@ -2363,6 +2386,7 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 	btrfs_might_wait_for_event(fs_info, btrfs_trans_num_writers);
 	wait_event(cur_trans->writer_wait,
 		   atomic_read(&cur_trans->num_writers) == 1);
+	commit_phase_end(phase_dur, BTRFS_COMMIT_PHASE_FLUSH, &phase_start);
 
 	/*
 	 * Make lockdep happy by acquiring the state locks after
@@ -2419,6 +2443,7 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 	ret = btrfs_run_delayed_refs(trans, U64_MAX);
 	if (ret)
 		goto unlock_reloc;
+	commit_phase_end(phase_dur, BTRFS_COMMIT_PHASE_DELAYED_REFS, &phase_start);
 
 	/*
 	 * make sure none of the code above managed to slip in a
@@ -2494,6 +2519,7 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 	clear_bit(BTRFS_FS_LOG2_ERR, &fs_info->flags);
 
 	btrfs_trans_release_chunk_metadata(trans);
+	commit_phase_end(phase_dur, BTRFS_COMMIT_PHASE_ROOTS, &phase_start);
 
 	/*
 	 * Before changing the transaction state to TRANS_STATE_UNBLOCKED and
@@ -2535,6 +2561,7 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 	mutex_unlock(&fs_info->tree_log_mutex);
 	if (ret)
 		goto scrub_continue;
+	commit_phase_end(phase_dur, BTRFS_COMMIT_PHASE_WRITEBACK, &phase_start);
 
 	/*
 	 * We needn't acquire the lock here because there is no other task
@@ -2570,7 +2597,8 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 
 	trace_btrfs_transaction_commit(fs_info);
 
-	interval = ktime_get_ns() - start_time;
+	commit_phase_end(phase_dur, BTRFS_COMMIT_PHASE_FINISH, &phase_start);
+	interval = phase_start - start_time;
 
 	btrfs_scrub_continue(fs_info);
 
@@ -2579,7 +2607,7 @@ int btrfs_commit_transaction(struct btrfs_trans_handle *trans)
 
 	kmem_cache_free(btrfs_trans_handle_cachep, trans);
 
-	update_commit_stats(fs_info, interval);
+	update_commit_stats(fs_info, interval, phase_dur);
 
 	return ret;
 
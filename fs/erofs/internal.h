@@ -129,6 +129,10 @@ struct erofs_sb_info {
 	struct inode *managed_cache;
 
 	struct erofs_sb_lz4_info lz4;
+
+	/* decompressed bytes and time spent per algorithm */
+	atomic64_t decomp_bytes[Z_EROFS_COMPRESSION_MAX];
+	atomic64_t decomp_ns[Z_EROFS_COMPRESSION_MAX];
 #endif	/* CONFIG_EROFS_FS_ZIP */
 	struct inode *packed_inode;
 	struct erofs_dev_context *devs;
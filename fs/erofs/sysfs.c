@@ -7,11 +7,13 @@
 #include <linux/kobject.h>
 
 #include "internal.h"
+#include "compress.h"
 
 enum {
 	attr_feature,
 	attr_pointer_ui,
 	attr_pointer_bool,
+	attr_decompress_stats,
 };
 
 enum {
@@ -57,11 +59,13 @@ static struct erofs_attr erofs_attr_##_name = {			\
 
 #ifdef CONFIG_EROFS_FS_ZIP
 EROFS_ATTR_RW_UI(sync_decompress, erofs_mount_opts);
+EROFS_ATTR_FUNC(decompress_stats, 0444);
 #endif
 
 static struct attribute *erofs_attrs[] = {
 #ifdef CONFIG_EROFS_FS_ZIP
 	ATTR_LIST(sync_decompress),
+	ATTR_LIST(decompress_stats),
 #endif
 	NULL,
 };
@@ -104,6 +108,27 @@ static unsigned char *__struct_ptr(struct erofs_sb_info *sbi,
 	return NULL;
 }
 
+#ifdef CONFIG_EROFS_FS_ZIP
+static ssize_t erofs_decompress_stats_show(struct erofs_sb_info *sbi,
+					   char *buf)
+{
+	ssize_t len = 0;
+	int i;
+
+	for (i = 0; i < Z_EROFS_COMPRESSION_MAX; ++i) {
+		u64 bytes = atomic64_read(&sbi->decomp_bytes[i]);
+		u64 ns = atomic64_read(&sbi->decomp_ns[i]);
+
+		if (!z_erofs_decomp[i] || !(sbi->available_compr_algs & BIT(i)))
+			continue;
+		len += sysfs_emit_at(buf, len, "%s %llu bytes %llu ns %llu MB/s\n",
+				     z_erofs_decomp[i]->name, bytes, ns,
+				     ns ? div64_u64(bytes * NSEC_PER_USEC, ns) : 0);
+	}
+	return len;
+}
+#endif
+
 static ssize_t erofs_attr_show(struct kobject *kobj,
 				struct attribute *attr, char *buf)
 {
@@ -123,6 +148,10 @@ static ssize_t erofs_attr_show(struct kobject *kobj,
 		if (!ptr)
 			return 0;
 		return sysfs_emit(buf, "%d\n", *(bool *)ptr);
+#ifdef CONFIG_EROFS_FS_ZIP
+	case attr_decompress_stats:
+		return erofs_decompress_stats_show(sbi, buf);
+#endif
 	}
 	return 0;
 }
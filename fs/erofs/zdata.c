@@ -1224,6 +1224,7 @@ static int z_erofs_decompress_pcluster(struct z_erofs_decompress_backend *be,
 	int i, j, jtop, err2;
 	struct page *page;
 	bool overlapped;
+	u64 start;
 
 	mutex_lock(&pcl->lock);
 	be->nr_pages = PAGE_ALIGN(pcl->length + pcl->pageofs_out) >> PAGE_SHIFT;
@@ -1255,7 +1256,8 @@ static int z_erofs_decompress_pcluster(struct z_erofs_decompress_backend *be,
 	err2 = z_erofs_parse_in_bvecs(be, &overlapped);
 	if (err2)
 		err = err2;
-	if (!err)
+	if (!err) {
+		start = ktime_get_ns();
 		err = decomp->decompress(&(struct z_erofs_decompress_req) {
 					.sb = be->sb,
 					.in = be->compressed_pages,
@@ -1272,6 +1274,13 @@ static int z_erofs_decompress_pcluster(struct z_erofs_decompress_backend *be,
 						GFP_KERNEL | __GFP_NOFAIL :
 						GFP_NOWAIT | __GFP_NORETRY
 				 }, be->pagepool);
+		if (pcl->algorithmformat < Z_EROFS_COMPRESSION_MAX) {
+			atomic64_add(pcl->length,
+				     &sbi->decomp_bytes[pcl->algorithmformat]);
+			atomic64_add(ktime_get_ns() - start,
+				     &sbi->decomp_ns[pcl->algorithmformat]);
+		}
+	}
 
 	/* must handle all compressed pages before actual file pages */
 	if (z_erofs_is_inline_pcluster(pcl)) {
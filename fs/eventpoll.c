@@ -455,12 +455,26 @@ static bool ep_busy_loop(struct eventpoll *ep, int nonblock)
 		 * it back in when we have moved a socket with a valid NAPI
 		 * ID onto the ready list.
 		 */
+		if (prefer_busy_poll)
+			napi_resume_irqs(napi_id);
 		ep->napi_id = 0;
 		return false;
 	}
 	return false;
 }
 
+/*
+ * The application found events and will be back shortly: keep the NAPI
+ * IRQs suspended until it goes idle or irq_suspend_timeout expires.
+ */
+static void ep_suspend_napi_irqs(struct eventpoll *ep)
+{
+	unsigned int napi_id = READ_ONCE(ep->napi_id);
+
+	if (napi_id >= MIN_NAPI_ID && READ_ONCE(ep->prefer_busy_poll))
+		napi_suspend_irqs(napi_id);
+}
+
 /*
  * Set epoll busy poll NAPI ID from sk.
  */
@@ -545,6 +559,10 @@ static inline bool ep_busy_loop(struct eventpoll *ep, int nonblock)
 	return false;
 }
 
+static inline void ep_suspend_napi_irqs(struct eventpoll *ep)
+{
+}
+
 static inline void ep_set_busy_poll_napi_id(struct epitem *epi)
 {
 }
@@ -2003,8 +2021,11 @@ static int ep_poll(struct eventpoll *ep, struct epoll_event __user *events,
 			 * trying again in search of more luck.
 			 */
 			res = ep_send_events(ep, events, maxevents);
-			if (res)
+			if (res) {
+				if (res > 0)
+					ep_suspend_napi_irqs(ep);
 				return res;
+			}
 		}
 
 		if (timed_out)
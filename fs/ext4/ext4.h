@@ -176,6 +176,12 @@ enum criteria {
 	EXT4_MB_NUM_CRS
 };
 
+/*
+ * Number of log2 buckets for the groups scanned per allocation histogram,
+ * the last one counts everything from 2^(EXT4_MB_SCAN_HIST_BUCKETS - 1) up.
+ */
+#define EXT4_MB_SCAN_HIST_BUCKETS	8
+
 /*
  * Flags used in mballoc's allocation_context flags field.
  *
@@ -1614,6 +1620,7 @@ struct ext4_sb_info {
 	atomic_t s_bal_ex_scanned;	/* total extents scanned */
 	atomic_t s_bal_cX_ex_scanned[EXT4_MB_NUM_CRS];	/* total extents scanned */
 	atomic_t s_bal_groups_scanned;	/* number of groups scanned */
+	atomic_t s_bal_groups_scanned_hist[EXT4_MB_SCAN_HIST_BUCKETS];
 	atomic_t s_bal_goals;	/* goal hits */
 	atomic_t s_bal_len_goals;	/* len goal hits */
 	atomic_t s_bal_breaks;	/* too long searches */
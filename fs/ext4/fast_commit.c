@@ -1087,7 +1087,7 @@ __releases(&sbi->s_fc_lock)
 	return ret;
 }
 
-static int ext4_fc_perform_commit(journal_t *journal)
+static int ext4_fc_perform_commit(journal_t *journal, int *nr_inodes)
 {
 	struct super_block *sb = journal->j_private;
 	struct ext4_sb_info *sbi = EXT4_SB(sb);
@@ -1141,6 +1141,7 @@ static int ext4_fc_perform_commit(journal_t *journal)
 		if (!ext4_test_inode_state(inode, EXT4_STATE_FC_COMMITTING))
 			continue;
 
+		(*nr_inodes)++;
 		spin_unlock(&sbi->s_fc_lock);
 		ret = ext4_fc_write_inode_data(inode, &crc);
 		if (ret)
@@ -1160,7 +1161,8 @@ static int ext4_fc_perform_commit(journal_t *journal)
 }
 
 static void ext4_fc_update_stats(struct super_block *sb, int status,
-				 u64 commit_time, int nblks, tid_t commit_tid)
+				 u64 commit_time, int nblks, int nr_inodes,
+				 tid_t commit_tid)
 {
 	struct ext4_fc_stats *stats = &EXT4_SB(sb)->s_fc_stats;
 
@@ -1169,6 +1171,9 @@ static void ext4_fc_update_stats(struct super_block *sb, int status,
 	if (status == EXT4_FC_STATUS_OK) {
 		stats->fc_num_commits++;
 		stats->fc_numblks += nblks;
+		stats->fc_num_inodes += nr_inodes;
+		if (nr_inodes > stats->fc_max_inodes)
+			stats->fc_max_inodes = nr_inodes;
 		if (likely(stats->s_fc_avg_commit_time))
 			stats->s_fc_avg_commit_time =
 				(commit_time +
@@ -1196,7 +1201,7 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 {
 	struct super_block *sb = journal->j_private;
 	struct ext4_sb_info *sbi = EXT4_SB(sb);
-	int nblks = 0, ret, bsize = journal->j_blocksize;
+	int nblks = 0, nr_inodes = 0, ret, bsize = journal->j_blocksize;
 	int subtid = atomic_read(&sbi->s_fc_subtid);
 	int status = EXT4_FC_STATUS_OK, fc_bufs_before = 0;
 	ktime_t start_time, commit_time;
@@ -1215,7 +1220,7 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 		if (atomic_read(&sbi->s_fc_subtid) <= subtid &&
 		    tid_gt(commit_tid, journal->j_commit_sequence))
 			goto restart_fc;
-		ext4_fc_update_stats(sb, EXT4_FC_STATUS_SKIPPED, 0, 0,
+		ext4_fc_update_stats(sb, EXT4_FC_STATUS_SKIPPED, 0, 0, 0,
 				commit_tid);
 		return 0;
 	} else if (ret) {
@@ -1223,7 +1228,7 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 		 * Commit couldn't start. Just update stats and perform a
 		 * full commit.
 		 */
-		ext4_fc_update_stats(sb, EXT4_FC_STATUS_FAILED, 0, 0,
+		ext4_fc_update_stats(sb, EXT4_FC_STATUS_FAILED, 0, 0, 0,
 				commit_tid);
 		return jbd2_complete_transaction(journal, commit_tid);
 	}
@@ -1238,7 +1243,7 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 	}
 
 	fc_bufs_before = (sbi->s_fc_bytes + bsize - 1) / bsize;
-	ret = ext4_fc_perform_commit(journal);
+	ret = ext4_fc_perform_commit(journal, &nr_inodes);
 	if (ret < 0) {
 		status = EXT4_FC_STATUS_FAILED;
 		goto fallback;
@@ -1256,12 +1261,13 @@ int ext4_fc_commit(journal_t *journal, tid_t commit_tid)
 	 * don't react too strongly to vast changes in the commit time
 	 */
 	commit_time = ktime_to_ns(ktime_sub(ktime_get(), start_time));
-	ext4_fc_update_stats(sb, status, commit_time, nblks, commit_tid);
+	ext4_fc_update_stats(sb, status, commit_time, nblks, nr_inodes,
+			     commit_tid);
 	return ret;
 
 fallback:
 	ret = jbd2_fc_end_commit_fallback(journal);
-	ext4_fc_update_stats(sb, status, 0, 0, commit_tid);
+	ext4_fc_update_stats(sb, status, 0, 0, 0, commit_tid);
 	return ret;
 }
 
@@ -2289,6 +2295,10 @@ int ext4_fc_info_show(struct seq_file *seq, void *v)
 	for (i = 0; i < EXT4_FC_REASON_MAX; i++)
 		seq_printf(seq, "\"%s\":\t%d\n", fc_ineligible_reasons[i],
 			stats->fc_ineligible_reason_count[i]);
+	seq_printf(seq,
+		"Batching:\n%lu inodes\n%u max_inodes\n%lu skipped\n",
+		stats->fc_num_inodes, stats->fc_max_inodes,
+		stats->fc_skipped_commits);
 
 	return 0;
 }
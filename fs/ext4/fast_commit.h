@@ -122,6 +122,8 @@ struct ext4_fc_stats {
 	unsigned long fc_failed_commits;
 	unsigned long fc_skipped_commits;
 	unsigned long fc_numblks;
+	unsigned long fc_num_inodes;	/* inodes written by fast commits */
+	unsigned int fc_max_inodes;	/* most inodes in one fast commit */
 	u64 s_fc_avg_commit_time;
 };
 
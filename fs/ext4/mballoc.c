@@ -3110,6 +3110,18 @@ int ext4_seq_mb_stats_show(struct seq_file *seq, void *offset)
 	seq_printf(seq, "\tgroups_scanned: %u\n",
 		   atomic_read(&sbi->s_bal_groups_scanned));
 
+	seq_puts(seq, "\tgroups_scanned_per_req:\n");
+	for (int i = 0; i < EXT4_MB_SCAN_HIST_BUCKETS; i++) {
+		if (i == EXT4_MB_SCAN_HIST_BUCKETS - 1)
+			seq_printf(seq, "\t\t%u+: ", 1U << i);
+		else if (i)
+			seq_printf(seq, "\t\t%u-%u: ", 1U << i, (2U << i) - 1);
+		else
+			seq_puts(seq, "\t\t0-1: ");
+		seq_printf(seq, "%u\n",
+			   atomic_read(&sbi->s_bal_groups_scanned_hist[i]));
+	}
+
 	/* CR_POWER2_ALIGNED stats */
 	seq_puts(seq, "\tcr_p2_aligned_stats:\n");
 	seq_printf(seq, "\t\thits: %llu\n",
@@ -4607,6 +4619,9 @@ static void ext4_mb_collect_stats(struct ext4_allocation_context *ac)
 		}
 
 		atomic_add(ac->ac_groups_scanned, &sbi->s_bal_groups_scanned);
+		atomic_inc(&sbi->s_bal_groups_scanned_hist[
+			min_t(unsigned int, ilog2(ac->ac_groups_scanned | 1),
+			      EXT4_MB_SCAN_HIST_BUCKETS - 1)]);
 		if (ac->ac_g_ex.fe_start == ac->ac_b_ex.fe_start &&
 				ac->ac_g_ex.fe_group == ac->ac_b_ex.fe_group)
 			atomic_inc(&sbi->s_bal_goals);
@@ -208,13 +208,18 @@ static unsigned int fuse_req_hash(u64 unique)
 
 /*
  * A new request is available, wake fiq->waitq
+ *
+ * The wakeup is done after dropping fiq->lock, so the woken reader doesn't
+ * immediately spin on the lock the waker still holds. The request is already
+ * on the queue, and readers recheck the queue under the lock, so no wakeup
+ * can be lost. The caller holds a connection reference, keeping fiq alive.
  */
 static void fuse_dev_wake_and_unlock(struct fuse_iqueue *fiq)
 __releases(fiq->lock)
 {
+	spin_unlock(&fiq->lock);
 	wake_up(&fiq->waitq);
 	kill_fasync(&fiq->fasync, SIGIO, POLL_IN);
-	spin_unlock(&fiq->lock);
 }
 
 const struct fuse_iqueue_ops fuse_dev_fiq_ops = {
@@ -2078,6 +2083,7 @@ static ssize_t fuse_dev_splice_write(struct pipe_inode_info *pipe,
 		obuf = &bufs[nbuf];
 
 		if (rem >= ibuf->len) {
+			pipe_buf_uncharge(pipe, ibuf);
 			*obuf = *ibuf;
 			ibuf->ops = NULL;
 			tail++;
@@ -2088,6 +2094,7 @@ static ssize_t fuse_dev_splice_write(struct pipe_inode_info *pipe,
 
 			*obuf = *ibuf;
 			obuf->flags &= ~PIPE_BUF_FLAG_GIFT;
+			obuf->flags &= ~PIPE_BUF_FLAG_LARGE;
 			obuf->len = rem;
 			ibuf->offset += obuf->len;
 			ibuf->len -= obuf->len;
@@ -1354,8 +1354,15 @@ static void process_init_reply(struct fuse_mount *fm, struct fuse_args *args,
 			fc->no_flock = 1;
 		}
 
+		/*
+		 * Allow the readahead window to grow to one maximum sized
+		 * request, so that readahead in cached mode is sent as few
+		 * large FUSE_READs rather than being capped by the bdi default.
+		 */
 		fm->sb->s_bdi->ra_pages =
-				min(fm->sb->s_bdi->ra_pages, ra_pages);
+				min_t(unsigned long, ra_pages,
+				      max_t(unsigned long, fm->sb->s_bdi->ra_pages,
+					    fc->max_pages));
 		fc->minor = arg->minor;
 		fc->max_write = arg->minor < 5 ? 4096 : arg->max_write;
 		fc->max_write = max_t(unsigned, 4096, fc->max_write);
@@ -1381,7 +1388,8 @@ void fuse_send_init(struct fuse_mount *fm)
 
 	ia->in.major = FUSE_KERNEL_VERSION;
 	ia->in.minor = FUSE_KERNEL_MINOR_VERSION;
-	ia->in.max_readahead = fm->sb->s_bdi->ra_pages * PAGE_SIZE;
+	ia->in.max_readahead = max_t(unsigned int, fm->sb->s_bdi->ra_pages,
+				     fm->fc->max_pages_limit) * PAGE_SIZE;
 	flags =
 		FUSE_ASYNC_READ | FUSE_POSIX_LOCKS | FUSE_ATOMIC_O_TRUNC |
 		FUSE_EXPORT_SUPPORT | FUSE_BIG_WRITES | FUSE_DONT_MASK |
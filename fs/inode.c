@@ -21,6 +21,7 @@
 #include <linux/list_lru.h>
 #include <linux/iversion.h>
 #include <linux/rw_hint.h>
+#include <linux/sched/numa_balancing.h>
 #include <trace/events/writeback.h>
 #include "internal.h"
 
@@ -700,6 +701,9 @@ static void evict(struct inode *inode)
 	 */
 	inode_wait_for_writeback(inode);
 
+	/* The mapping address may be reused, drop its shared NUMA group */
+	numa_shared_group_forget(&inode->i_data);
+
 	if (op->evict_inode) {
 		op->evict_inode(inode);
 	} else {
@@ -755,6 +755,111 @@ static struct folio *__iomap_get_folio(struct iomap_iter *iter, loff_t pos,
 		return iomap_get_folio(iter, pos, len);
 }
 
+/*
+ * Folios looked up ahead of a buffered write spanning several of them, see
+ * iomap_get_folio_batch().
+ */
+struct iomap_write_batch {
+	struct folio_batch fbatch;
+	unsigned int idx;	/* next folio in fbatch to hand out */
+	pgoff_t next;		/* first index not looked up yet */
+};
+
+static void iomap_write_batch_init(struct iomap_write_batch *batch, loff_t pos)
+{
+	folio_batch_init(&batch->fbatch);
+	batch->idx = 0;
+	batch->next = pos >> PAGE_SHIFT;
+}
+
+static struct folio *iomap_write_batch_next(struct iomap_write_batch *batch)
+{
+	if (batch->idx >= folio_batch_count(&batch->fbatch))
+		return NULL;
+	return batch->fbatch.folios[batch->idx++];
+}
+
+static void iomap_write_batch_reinit(struct iomap_write_batch *batch)
+{
+	folio_batch_reinit(&batch->fbatch);
+	batch->idx = 0;
+}
+
+static void iomap_write_batch_release(struct iomap_write_batch *batch)
+{
+	struct folio *folio;
+
+	while ((folio = iomap_write_batch_next(batch)))
+		folio_put(folio);
+	iomap_write_batch_reinit(batch);
+}
+
+/*
+ * Overwrites of cached ranges look up the folios for the rest of the mapping
+ * a batch at a time rather than walking the page cache for each of them. The
+ * batch only holds references, the folios are locked one by one as the write
+ * gets to them since faulting in the user buffer could need any of them.
+ */
+static struct folio *iomap_get_folio_batch(struct iomap_iter *iter, loff_t pos,
+		size_t len, struct iomap_write_batch *batch)
+{
+	struct address_space *mapping = iter->inode->i_mapping;
+	pgoff_t index = pos >> PAGE_SHIFT;
+	struct folio *folio;
+
+	while ((folio = iomap_write_batch_next(batch))) {
+		if (folio_next_index(folio) > index)
+			break;
+		folio_put(folio);
+	}
+
+	if (!folio && index >= batch->next) {
+		pgoff_t end = (iter->pos + iomap_length(iter) - 1) >> PAGE_SHIFT;
+		pgoff_t start = index;
+
+		iomap_write_batch_reinit(batch);
+		if (filemap_get_folios_range(mapping, &start, end, 0, 0,
+					     &batch->fbatch) > 0) {
+			batch->next = start;
+			folio = iomap_write_batch_next(batch);
+		} else {
+			/* Writing into a hole, the rest is unlikely cached */
+			batch->next = ULONG_MAX;
+		}
+	}
+
+	if (!folio || folio->index > index) {
+		/* Keep it for later, e.g. when retrying a short copy */
+		if (folio)
+			batch->idx--;
+		return iomap_get_folio(iter, pos, len);
+	}
+
+	if (iter->flags & IOMAP_NOWAIT) {
+		if (!folio_trylock(folio)) {
+			folio_put(folio);
+			return ERR_PTR(-EAGAIN);
+		}
+	} else {
+		folio_lock(folio);
+	}
+
+	/* Truncated or replaced since the lookup? */
+	if (unlikely(folio->mapping != mapping ||
+		     !folio_contains(folio, index))) {
+		folio_unlock(folio);
+		folio_put(folio);
+		return iomap_get_folio(iter, pos, len);
+	}
+
+	/* The rest of what FGP_WRITEBEGIN does for a cached folio */
+	if (folio_test_idle(folio))
+		folio_clear_idle(folio);
+	folio_wait_stable(folio);
+
+	return folio;
+}
+
 static void __iomap_put_folio(struct iomap_iter *iter, loff_t pos, size_t ret,
 		struct folio *folio)
 {
@@ -778,7 +883,7 @@ static int iomap_write_begin_inline(const struct iomap_iter *iter,
 }
 
 static int iomap_write_begin(struct iomap_iter *iter, loff_t pos,
-		size_t len, struct folio **foliop)
+		size_t len, struct folio **foliop, struct iomap_write_batch *batch)
 {
 	const struct iomap_folio_ops *folio_ops = iter->iomap.folio_ops;
 	const struct iomap *srcmap = iomap_iter_srcmap(iter);
@@ -795,7 +900,10 @@ static int iomap_write_begin(struct iomap_iter *iter, loff_t pos,
 	if (!mapping_large_folio_support(iter->inode->i_mapping))
 		len = min_t(size_t, len, PAGE_SIZE - offset_in_page(pos));
 
-	folio = __iomap_get_folio(iter, pos, len);
+	if (batch)
+		folio = iomap_get_folio_batch(iter, pos, len, batch);
+	else
+		folio = __iomap_get_folio(iter, pos, len);
 	if (IS_ERR(folio))
 		return PTR_ERR(folio);
 
@@ -917,6 +1025,13 @@ static loff_t iomap_write_iter(struct iomap_iter *iter, struct iov_iter *i)
 	struct address_space *mapping = iter->inode->i_mapping;
 	size_t chunk = mapping_max_folio_size(mapping);
 	unsigned int bdp_flags = (iter->flags & IOMAP_NOWAIT) ? BDP_ASYNC : 0;
+	const struct iomap_folio_ops *folio_ops = iter->iomap.folio_ops;
+	struct iomap_write_batch batch, *wbatch = NULL;
+
+	if (length > PAGE_SIZE && !(folio_ops && folio_ops->get_folio)) {
+		iomap_write_batch_init(&batch, pos);
+		wbatch = &batch;
+	}
 
 	do {
 		struct folio *folio;
@@ -953,7 +1068,7 @@ static loff_t iomap_write_iter(struct iomap_iter *iter, struct iov_iter *i)
 			break;
 		}
 
-		status = iomap_write_begin(iter, pos, bytes, &folio);
+		status = iomap_write_begin(iter, pos, bytes, &folio, wbatch);
 		if (unlikely(status)) {
 			iomap_write_failed(iter->inode, pos, bytes);
 			break;
@@ -1013,6 +1128,9 @@ static loff_t iomap_write_iter(struct iomap_iter *iter, struct iov_iter *i)
 		}
 	} while (iov_iter_count(i) && length);
 
+	if (wbatch)
+		iomap_write_batch_release(wbatch);
+
 	if (status == -EAGAIN) {
 		iov_iter_revert(i, total_written);
 		return -EAGAIN;
@@ -1348,7 +1466,7 @@ static loff_t iomap_unshare_iter(struct iomap_iter *iter)
 		size_t bytes = min_t(u64, SIZE_MAX, length);
 		bool ret;
 
-		status = iomap_write_begin(iter, pos, bytes, &folio);
+		status = iomap_write_begin(iter, pos, bytes, &folio, NULL);
 		if (unlikely(status))
 			return status;
 		if (iomap->flags & IOMAP_F_STALE)
@@ -1411,7 +1529,7 @@ static loff_t iomap_zero_iter(struct iomap_iter *iter, bool *did_zero)
 		size_t bytes = min_t(u64, SIZE_MAX, length);
 		bool ret;
 
-		status = iomap_write_begin(iter, pos, bytes, &folio);
+		status = iomap_write_begin(iter, pos, bytes, &folio, NULL);
 		if (status)
 			return status;
 		if (iter->iomap.flags & IOMAP_F_STALE)
@@ -1693,6 +1811,8 @@ static int iomap_submit_ioend(struct iomap_writepage_ctx *wpc, int error)
 	if (wpc->ops->prepare_ioend)
 		error = wpc->ops->prepare_ioend(wpc->ioend, error);
 
+	trace_iomap_submit_ioend(wpc->ioend->io_inode, wpc->ioend->io_offset,
+			wpc->ioend->io_size);
 	if (error) {
 		wpc->ioend->io_bio.bi_status = errno_to_blk_status(error);
 		bio_endio(&wpc->ioend->io_bio);
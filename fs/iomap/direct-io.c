@@ -11,6 +11,7 @@
 #include <linux/iomap.h>
 #include <linux/backing-dev.h>
 #include <linux/uio.h>
+#include <linux/slab.h>
 #include <linux/task_io_accounting_ops.h>
 #include "trace.h"
 
@@ -52,6 +53,8 @@ struct iomap_dio {
 	};
 };
 
+static struct kmem_cache *iomap_dio_cache;
+
 static struct bio *iomap_dio_alloc_bio(const struct iomap_iter *iter,
 		struct iomap_dio *dio, unsigned short nr_vecs, blk_opf_t opf)
 {
@@ -128,7 +131,7 @@ ssize_t iomap_dio_complete(struct iomap_dio *dio)
 			ret += dio->done_before;
 	}
 	trace_iomap_dio_complete(iocb, dio->error, ret);
-	kfree(dio);
+	kmem_cache_free(iomap_dio_cache, dio);
 	return ret;
 }
 EXPORT_SYMBOL_GPL(iomap_dio_complete);
@@ -561,7 +564,7 @@ __iomap_dio_rw(struct kiocb *iocb, struct iov_iter *iter,
 	if (!iomi.len)
 		return NULL;
 
-	dio = kmalloc(sizeof(*dio), GFP_KERNEL);
+	dio = kmem_cache_alloc(iomap_dio_cache, GFP_KERNEL);
 	if (!dio)
 		return ERR_PTR(-ENOMEM);
 
@@ -732,7 +735,7 @@ __iomap_dio_rw(struct kiocb *iocb, struct iov_iter *iter,
 	return dio;
 
 out_free_dio:
-	kfree(dio);
+	kmem_cache_free(iomap_dio_cache, dio);
 	if (ret)
 		return ERR_PTR(ret);
 	return NULL;
@@ -753,3 +756,10 @@ iomap_dio_rw(struct kiocb *iocb, struct iov_iter *iter,
 	return iomap_dio_complete(dio);
 }
 EXPORT_SYMBOL_GPL(iomap_dio_rw);
+
+static int __init iomap_dio_init(void)
+{
+	iomap_dio_cache = KMEM_CACHE(iomap_dio, SLAB_PANIC);
+	return 0;
+}
+fs_initcall(iomap_dio_init);
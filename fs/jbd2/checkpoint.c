@@ -20,8 +20,20 @@
 #include <linux/errno.h>
 #include <linux/slab.h>
 #include <linux/blkdev.h>
+#include <linux/moduleparam.h>
+#include <linux/sched/mm.h>
+#include <linux/workqueue.h>
 #include <trace/events/jbd2.h>
 
+/*
+ * Percentage of the log in use at which old transactions start being
+ * checkpointed in the background, before handles have to wait for space in
+ * __jbd2_log_wait_for_space().  0 disables background checkpointing.
+ */
+static unsigned int bg_checkpoint_pct;
+module_param(bg_checkpoint_pct, uint, 0644);
+MODULE_PARM_DESC(bg_checkpoint_pct, "Log fill percentage that starts background checkpointing (0 = off)");
+
 /*
  * Unlink a buffer from a transaction checkpoint list.
  *
@@ -117,6 +129,53 @@ __releases(&journal->j_state_lock)
 	}
 }
 
+static bool jbd2_bg_checkpoint_needed(journal_t *journal)
+{
+	unsigned int pct = READ_ONCE(bg_checkpoint_pct);
+	unsigned long used;
+	bool needed;
+
+	if (!pct || pct > 100)
+		return false;
+
+	read_lock(&journal->j_state_lock);
+	used = journal->j_total_len - journal->j_free;
+	needed = !(journal->j_flags & (JBD2_UNMOUNT | JBD2_ABORT)) &&
+		 used * 100 >= (unsigned long)journal->j_total_len * pct;
+	read_unlock(&journal->j_state_lock);
+
+	return needed && READ_ONCE(journal->j_checkpoint_transactions);
+}
+
+/*
+ * Called at the end of every commit.  Kick the background checkpoint work if
+ * the log has filled up beyond bg_checkpoint_pct.
+ */
+void jbd2_log_start_bg_checkpoint(journal_t *journal)
+{
+	if (jbd2_bg_checkpoint_needed(journal))
+		queue_work(system_unbound_wq, &journal->j_checkpoint_work);
+}
+
+void jbd2_bg_checkpoint_work(struct work_struct *work)
+{
+	journal_t *journal = container_of(work, journal_t, j_checkpoint_work);
+	unsigned int nofs = memalloc_nofs_save();
+
+	while (jbd2_bg_checkpoint_needed(journal)) {
+		int ret;
+
+		mutex_lock_io(&journal->j_checkpoint_mutex);
+		ret = jbd2_log_do_checkpoint(journal);
+		mutex_unlock(&journal->j_checkpoint_mutex);
+		if (ret < 0)
+			break;
+		cond_resched();
+	}
+
+	memalloc_nofs_restore(nofs);
+}
+
 static void
 __flush_batch(journal_t *journal, int *batch_count)
 {
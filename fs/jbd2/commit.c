@@ -1163,4 +1163,6 @@ void jbd2_journal_commit_transaction(journal_t *journal)
 	journal->j_stats.run.rs_blocks += stats.run.rs_blocks;
 	journal->j_stats.run.rs_blocks_logged += stats.run.rs_blocks_logged;
 	spin_unlock(&journal->j_history_lock);
+
+	jbd2_log_start_bg_checkpoint(journal);
 }
@@ -1567,6 +1567,7 @@ static journal_t *journal_init_common(struct block_device *bdev,
 	mutex_init(&journal->j_abort_mutex);
 	mutex_init(&journal->j_barrier);
 	mutex_init(&journal->j_checkpoint_mutex);
+	INIT_WORK(&journal->j_checkpoint_work, jbd2_bg_checkpoint_work);
 	spin_lock_init(&journal->j_revoke_lock);
 	spin_lock_init(&journal->j_list_lock);
 	spin_lock_init(&journal->j_history_lock);
@@ -2147,6 +2148,9 @@ int jbd2_journal_destroy(journal_t *journal)
 	if (journal->j_running_transaction)
 		jbd2_journal_commit_transaction(journal);
 
+	/* JBD2_UNMOUNT is set, so the background work won't be queued again */
+	cancel_work_sync(&journal->j_checkpoint_work);
+
 	/* Force any old transactions to disk */
 
 	/* Totally anal locking here... */
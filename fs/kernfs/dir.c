@@ -14,10 +14,16 @@
 #include <linux/slab.h>
 #include <linux/security.h>
 #include <linux/hash.h>
+#include <linux/seqlock.h>
+
+#include <asm/sections.h>
 
 #include "kernfs-internal.h"
 
 static DEFINE_RWLOCK(kernfs_rename_lock);	/* kn->parent and ->name */
+/* lets kernfs_dop_revalidate() check ->parent and ->name locklessly */
+static seqcount_rwlock_t kernfs_rename_seq =
+	SEQCNT_RWLOCK_ZERO(kernfs_rename_seq, &kernfs_rename_lock);
 /*
  * Don't use rename_lock to piggy back on pr_cont_buf. We don't want to
  * call pr_cont() while holding rename_lock. Because sometimes pr_cont()
@@ -1109,10 +1115,37 @@ struct kernfs_node *kernfs_create_empty_dir(struct kernfs_node *parent,
 	return ERR_PTR(rc);
 }
 
+/* Does @dentry still match @kn? Called under RCU or kernfs_rwsem. */
+static bool kernfs_dentry_valid(struct dentry *dentry, struct kernfs_node *kn)
+{
+	struct kernfs_node *parent = READ_ONCE(kn->parent);
+
+	/* The kernfs node has been deactivated */
+	if (!__kernfs_active(kn))
+		return false;
+
+	/* The kernfs node has been moved? */
+	if (kernfs_dentry_node(dentry->d_parent) != parent)
+		return false;
+
+	/* The kernfs node has been renamed */
+	if (strcmp(dentry->d_name.name, READ_ONCE(kn->name)) != 0)
+		return false;
+
+	/* The kernfs node has been moved to a different namespace */
+	if (parent && kernfs_ns_enabled(parent) &&
+	    kernfs_info(dentry->d_sb)->ns != READ_ONCE(kn->ns))
+		return false;
+
+	return true;
+}
+
 static int kernfs_dop_revalidate(struct dentry *dentry, unsigned int flags)
 {
 	struct kernfs_node *kn;
 	struct kernfs_root *root;
+	unsigned int seq;
+	bool valid;
 
 	if (flags & LOOKUP_RCU)
 		return -ECHILD;
@@ -1154,32 +1187,21 @@ static int kernfs_dop_revalidate(struct dentry *dentry, unsigned int flags)
 		return 1;
 	}
 
+	/*
+	 * Revalidating a positive dentry is what every path walk through
+	 * sysfs does, so don't serialize it against directory operations
+	 * with kernfs_rwsem. Nodes and their names are freed after an RCU
+	 * grace period, and renames are caught by kernfs_rename_seq.
+	 */
 	kn = kernfs_dentry_node(dentry);
-	root = kernfs_root(kn);
-	down_read(&root->kernfs_rwsem);
-
-	/* The kernfs node has been deactivated */
-	if (!kernfs_active(kn))
-		goto out_bad;
-
-	/* The kernfs node has been moved? */
-	if (kernfs_dentry_node(dentry->d_parent) != kn->parent)
-		goto out_bad;
-
-	/* The kernfs node has been renamed */
-	if (strcmp(dentry->d_name.name, kn->name) != 0)
-		goto out_bad;
-
-	/* The kernfs node has been moved to a different namespace */
-	if (kn->parent && kernfs_ns_enabled(kn->parent) &&
-	    kernfs_info(dentry->d_sb)->ns != kn->ns)
-		goto out_bad;
+	rcu_read_lock();
+	do {
+		seq = read_seqcount_begin(&kernfs_rename_seq);
+		valid = kernfs_dentry_valid(dentry, kn);
+	} while (read_seqcount_retry(&kernfs_rename_seq, seq));
+	rcu_read_unlock();
 
-	up_read(&root->kernfs_rwsem);
-	return 1;
-out_bad:
-	up_read(&root->kernfs_rwsem);
-	return 0;
+	return valid;
 }
 
 const struct dentry_operations kernfs_dops = {
@@ -1759,27 +1781,32 @@ int kernfs_rename_ns(struct kernfs_node *kn, struct kernfs_node *new_parent,
 
 	/* rename_lock protects ->parent and ->name accessors */
 	write_lock_irq(&kernfs_rename_lock);
+	write_seqcount_begin(&kernfs_rename_seq);
 
 	old_parent = kn->parent;
-	kn->parent = new_parent;
+	WRITE_ONCE(kn->parent, new_parent);
 
-	kn->ns = new_ns;
+	WRITE_ONCE(kn->ns, new_ns);
 	if (new_name) {
 		old_name = kn->name;
-		kn->name = new_name;
+		WRITE_ONCE(kn->name, new_name);
 	}
 
+	write_seqcount_end(&kernfs_rename_seq);
 	write_unlock_irq(&kernfs_rename_lock);
 
 	kn->hash = kernfs_name_hash(kn->name, kn->ns);
 	kernfs_link_sibling(kn);
 
 	kernfs_put(old_parent);
-	kfree_const(old_name);
 
 	error = 0;
  out:
 	up_write(&root->kernfs_rwsem);
+
+	/* kernfs_dop_revalidate() may still be looking at the old name */
+	if (old_name && !is_kernel_rodata((unsigned long)old_name))
+		kfree_rcu_mightsleep(old_name);
 	return error;
 }
 
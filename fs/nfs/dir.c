@@ -768,8 +768,11 @@ void nfs_prime_dcache(struct dentry *parent, struct nfs_entry *entry,
 				goto out;
 			nfs_set_verifier(dentry, dir_verifier);
 			status = nfs_refresh_inode(d_inode(dentry), entry->fattr);
-			if (!status)
+			if (!status) {
 				nfs_setsecurity(d_inode(dentry), entry->fattr);
+				nfs_inc_stats(d_inode(parent),
+					      NFSIOS_RDPLUS_REVALIDATE);
+			}
 			trace_nfs_readdir_lookup_revalidate(d_inode(parent),
 							    dentry, 0, status);
 			goto out;
@@ -797,6 +800,7 @@ void nfs_prime_dcache(struct dentry *parent, struct nfs_entry *entry,
 		dentry = alias;
 	}
 	nfs_set_verifier(dentry, dir_verifier);
+	nfs_inc_stats(d_inode(parent), NFSIOS_RDPLUS_INSTANTIATE);
 	trace_nfs_readdir_lookup(d_inode(parent), dentry, 0);
 out:
 	dput(dentry);
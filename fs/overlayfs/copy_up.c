@@ -254,6 +254,7 @@ static int ovl_copy_up_file(struct ovl_fs *ofs, struct dentry *dentry,
 	loff_t data_pos = -1;
 	loff_t hole_len;
 	bool skip_hole = false;
+	bool try_copy_range = true;
 	int error = 0;
 
 	ovl_path_lowerdata(dentry, &datapath);
@@ -331,6 +332,26 @@ static int ovl_copy_up_file(struct ovl_fs *ofs, struct dentry *dentry,
 		if (error)
 			break;
 
+		/*
+		 * Prefer copy_file_range, which lets filesystems that can do
+		 * it offload the copy (e.g. server side copy). Fall back to
+		 * splice for the rest of the file as soon as it can't be
+		 * used, e.g. because lower and upper are on different
+		 * filesystem types.
+		 */
+		if (try_copy_range) {
+			bytes = vfs_copy_file_range(old_file, old_pos,
+						    new_file, new_pos,
+						    this_len, 0);
+			if (bytes > 0) {
+				old_pos += bytes;
+				new_pos += bytes;
+				len -= bytes;
+				continue;
+			}
+			try_copy_range = false;
+		}
+
 		bytes = do_splice_direct(old_file, &old_pos,
 					 new_file, &new_pos,
 					 this_len, SPLICE_F_MOVE);
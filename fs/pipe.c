@@ -53,6 +53,12 @@
  */
 static unsigned int pipe_max_size = 1048576;
 
+/*
+ * The size of a new pipe, can be set by root in /proc/sys/fs/pipe-default-size.
+ * Unprivileged users still get at most pipe_max_size.
+ */
+static unsigned int pipe_default_size = PIPE_DEF_BUFFERS * PAGE_SIZE;
+
 /* Maximum allocatable pages per user. Hard limit is unset by default, soft
  * matches default values.
  */
@@ -271,7 +277,7 @@ pipe_read(struct kiocb *iocb, struct iov_iter *to)
 	 * (WF_SYNC), because we want them to get going and generate more
 	 * data for us.
 	 */
-	was_full = pipe_full(pipe->head, pipe->tail, pipe->max_usage);
+	was_full = pipe_is_full(pipe);
 	for (;;) {
 		/* Read ->head with a barrier vs post_one_notification() */
 		unsigned int head = smp_load_acquire(&pipe->head);
@@ -391,7 +397,7 @@ pipe_read(struct kiocb *iocb, struct iov_iter *to)
 			return -ERESTARTSYS;
 
 		mutex_lock(&pipe->mutex);
-		was_full = pipe_full(pipe->head, pipe->tail, pipe->max_usage);
+		was_full = pipe_is_full(pipe);
 		wake_next_reader = true;
 	}
 	if (pipe_empty(pipe->head, pipe->tail))
@@ -416,12 +422,7 @@ static inline int is_packetized(struct file *file)
 /* Done while waiting without holding the pipe lock - thus the READ_ONCE() */
 static inline bool pipe_writable(const struct pipe_inode_info *pipe)
 {
-	unsigned int head = READ_ONCE(pipe->head);
-	unsigned int tail = READ_ONCE(pipe->tail);
-	unsigned int max_usage = READ_ONCE(pipe->max_usage);
-
-	return !pipe_full(head, tail, max_usage) ||
-		!READ_ONCE(pipe->readers);
+	return !pipe_is_full(pipe) || !READ_ONCE(pipe->readers);
 }
 
 static ssize_t
@@ -503,7 +504,7 @@ pipe_write(struct kiocb *iocb, struct iov_iter *from)
 		}
 
 		head = pipe->head;
-		if (!pipe_full(head, pipe->tail, pipe->max_usage)) {
+		if (!pipe_is_full(pipe)) {
 			unsigned int mask = pipe->ring_size - 1;
 			struct pipe_buffer *buf;
 			struct page *page = pipe->tmp_page;
@@ -550,7 +551,7 @@ pipe_write(struct kiocb *iocb, struct iov_iter *from)
 				break;
 		}
 
-		if (!pipe_full(head, pipe->tail, pipe->max_usage))
+		if (!pipe_is_full(pipe))
 			continue;
 
 		/* Wait for buffer space to become available. */
@@ -582,7 +583,7 @@ pipe_write(struct kiocb *iocb, struct iov_iter *from)
 		wake_next_writer = true;
 	}
 out:
-	if (pipe_full(pipe->head, pipe->tail, pipe->max_usage))
+	if (pipe_is_full(pipe))
 		wake_next_writer = false;
 	mutex_unlock(&pipe->mutex);
 
@@ -691,7 +692,7 @@ pipe_poll(struct file *filp, poll_table *wait)
 	}
 
 	if (filp->f_mode & FMODE_WRITE) {
-		if (!pipe_full(head, tail, pipe->max_usage))
+		if (!pipe_is_full(pipe))
 			mask |= EPOLLOUT | EPOLLWRNORM;
 		/*
 		 * Most Unices do not set EPOLLERR for FIFOs but on Linux they
@@ -790,7 +791,7 @@ bool pipe_is_unprivileged_user(void)
 struct pipe_inode_info *alloc_pipe_info(void)
 {
 	struct pipe_inode_info *pipe;
-	unsigned long pipe_bufs = PIPE_DEF_BUFFERS;
+	unsigned long pipe_bufs = READ_ONCE(pipe_default_size) >> PAGE_SHIFT;
 	struct user_struct *user = get_current_user();
 	unsigned long user_bufs;
 	unsigned int max_size = READ_ONCE(pipe_max_size);
@@ -1278,7 +1279,7 @@ int pipe_resize_ring(struct pipe_inode_info *pipe, unsigned int nr_slots)
 	tail = pipe->tail;
 
 	n = pipe_occupancy(head, tail);
-	if (nr_slots < n) {
+	if (nr_slots < n + pipe->extra_pages) {
 		spin_unlock_irq(&pipe->rd_wait.lock);
 		kfree(bufs);
 		return -EBUSY;
@@ -1476,6 +1477,25 @@ static int proc_dopipe_max_size(const struct ctl_table *table, int write,
 				 do_proc_dopipe_max_size_conv, NULL);
 }
 
+static int do_proc_dopipe_default_size_conv(unsigned long *lvalp,
+					    unsigned int *valp,
+					    int write, void *data)
+{
+	int err = do_proc_dopipe_max_size_conv(lvalp, valp, write, data);
+
+	if (!err && write)
+		*valp = max_t(unsigned int, *valp,
+			      PIPE_MIN_DEF_BUFFERS * PAGE_SIZE);
+	return err;
+}
+
+static int proc_dopipe_default_size(const struct ctl_table *table, int write,
+				    void *buffer, size_t *lenp, loff_t *ppos)
+{
+	return do_proc_douintvec(table, write, buffer, lenp, ppos,
+				 do_proc_dopipe_default_size_conv, NULL);
+}
+
 static struct ctl_table fs_pipe_sysctls[] = {
 	{
 		.procname	= "pipe-max-size",
@@ -1484,6 +1504,13 @@ static struct ctl_table fs_pipe_sysctls[] = {
 		.mode		= 0644,
 		.proc_handler	= proc_dopipe_max_size,
 	},
+	{
+		.procname	= "pipe-default-size",
+		.data		= &pipe_default_size,
+		.maxlen		= sizeof(pipe_default_size),
+		.mode		= 0644,
+		.proc_handler	= proc_dopipe_default_size,
+	},
 	{
 		.procname	= "pipe-user-pages-hard",
 		.data		= &pipe_user_pages_hard,
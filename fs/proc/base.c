@@ -3217,6 +3217,9 @@ static int proc_pid_ksm_stat(struct seq_file *m, struct pid_namespace *ns,
 		seq_printf(m, "ksm_zero_pages %ld\n", mm_ksm_zero_pages(mm));
 		seq_printf(m, "ksm_merging_pages %lu\n", mm->ksm_merging_pages);
 		seq_printf(m, "ksm_process_profit %ld\n", ksm_process_profit(mm));
+		seq_printf(m, "ksm_pages_scanned %lu\n", mm->ksm_pages_scanned);
+		seq_printf(m, "ksm_scans_skipped %lu\n", mm->ksm_scans_skipped);
+		seq_printf(m, "ksm_scan_yield %u\n", READ_ONCE(mm->ksm_scan_yield));
 		mmput(mm);
 	}
 
@@ -5,6 +5,7 @@
 
 #include <linux/console.h>
 #include <linux/kernel.h>
+#include <linux/math64.h>
 #include <linux/proc_fs.h>
 #include <linux/seq_file.h>
 #include <linux/tty_driver.h>
@@ -105,9 +106,31 @@ static const struct seq_operations consoles_op = {
 	.show	= show_console_dev
 };
 
+/*
+ * This is handler for /proc/console_stats, one line per console with
+ * the number of dropped and delayed records and the longest delay in us.
+ */
+static int show_console_stats(struct seq_file *m, void *v)
+{
+	struct console *con = v;
+
+	seq_printf(m, "%s%d %lu %lu %llu\n", con->name, con->index,
+		   READ_ONCE(con->stat_dropped), READ_ONCE(con->stat_delayed),
+		   div_u64(READ_ONCE(con->stat_max_delay_ns), NSEC_PER_USEC));
+	return 0;
+}
+
+static const struct seq_operations console_stats_op = {
+	.start	= c_start,
+	.next	= c_next,
+	.stop	= c_stop,
+	.show	= show_console_stats
+};
+
 static int __init proc_consoles_init(void)
 {
 	proc_create_seq("consoles", 0, NULL, &consoles_op);
+	proc_create_seq("console_stats", 0, NULL, &console_stats_op);
 	return 0;
 }
 fs_initcall(proc_consoles_init);
@@ -131,6 +131,8 @@ static int meminfo_proc_show(struct seq_file *m, void *v)
 	show_val_kb(m, "VmallocUsed:    ", vmalloc_nr_pages());
 	show_val_kb(m, "VmallocChunk:   ", 0ul);
 	show_val_kb(m, "Percpu:         ", pcpu_nr_pages());
+	seq_printf(m, "KvfreeRcu:      %8lu kB\n",
+		   kvfree_rcu_pending_bytes() >> 10);
 
 	memtest_report_meminfo(m);
 
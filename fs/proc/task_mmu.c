@@ -618,6 +618,82 @@ static int do_procmap_query(struct proc_maps_private *priv, void __user *uarg)
 	return err;
 }
 
+#define PROCMAP_MEMSTAT_VALID_MASK (PROCMAP_MEMSTAT_VM | PROCMAP_MEMSTAT_RSS |	\
+				    PROCMAP_MEMSTAT_SWAP | PROCMAP_MEMSTAT_LOCKED | \
+				    PROCMAP_MEMSTAT_SEGMENTS |			\
+				    PROCMAP_MEMSTAT_PGTABLES)
+
+/*
+ * Binary counterpart of task_mem(): only the counters mm maintains as it
+ * goes are reported, so neither mmap_lock nor a page table walk is needed.
+ */
+static int do_procmap_memstat(struct proc_maps_private *priv, void __user *uarg)
+{
+	struct procmap_memstat karg;
+	struct mm_struct *mm;
+	unsigned long anon, file, shmem;
+	__u64 usize;
+	int err;
+
+	if (copy_from_user(&usize, (void __user *)uarg, sizeof(usize)))
+		return -EFAULT;
+	/* argument struct can never be that large, reject abuse */
+	if (usize > PAGE_SIZE)
+		return -E2BIG;
+	/* argument struct should have at least the mask field */
+	if (usize < offsetofend(struct procmap_memstat, mask))
+		return -EINVAL;
+	err = copy_struct_from_user(&karg, sizeof(karg), uarg, usize);
+	if (err)
+		return err;
+
+	mm = priv->mm;
+	if (!mm || !mmget_not_zero(mm))
+		return -ESRCH;
+
+	karg.mask &= PROCMAP_MEMSTAT_VALID_MASK;
+	memset((void *)&karg + offsetofend(struct procmap_memstat, mask), 0,
+	       sizeof(karg) - offsetofend(struct procmap_memstat, mask));
+
+	if (karg.mask & PROCMAP_MEMSTAT_VM) {
+		karg.vm_size = mm->total_vm;
+		karg.vm_peak = max(karg.vm_size, (__u64)mm->hiwater_vm);
+		karg.vm_size <<= PAGE_SHIFT;
+		karg.vm_peak <<= PAGE_SHIFT;
+	}
+	if (karg.mask & PROCMAP_MEMSTAT_RSS) {
+		anon = get_mm_counter(mm, MM_ANONPAGES);
+		file = get_mm_counter(mm, MM_FILEPAGES);
+		shmem = get_mm_counter(mm, MM_SHMEMPAGES);
+		karg.rss_anon = (__u64)anon << PAGE_SHIFT;
+		karg.rss_file = (__u64)file << PAGE_SHIFT;
+		karg.rss_shmem = (__u64)shmem << PAGE_SHIFT;
+		/* see task_mem() on why hiwater_rss has to be fixed up */
+		karg.rss_peak = (__u64)max(anon + file + shmem,
+					   mm->hiwater_rss) << PAGE_SHIFT;
+	}
+	if (karg.mask & PROCMAP_MEMSTAT_SWAP)
+		karg.swap = (__u64)get_mm_counter(mm, MM_SWAPENTS) << PAGE_SHIFT;
+	if (karg.mask & PROCMAP_MEMSTAT_LOCKED) {
+		karg.locked = (__u64)mm->locked_vm << PAGE_SHIFT;
+		karg.pinned = (__u64)atomic64_read(&mm->pinned_vm) << PAGE_SHIFT;
+	}
+	if (karg.mask & PROCMAP_MEMSTAT_SEGMENTS) {
+		karg.data = (__u64)mm->data_vm << PAGE_SHIFT;
+		karg.stack = (__u64)mm->stack_vm << PAGE_SHIFT;
+		karg.exec = (__u64)mm->exec_vm << PAGE_SHIFT;
+	}
+	if (karg.mask & PROCMAP_MEMSTAT_PGTABLES)
+		karg.pgtables = mm_pgtables_bytes(mm);
+
+	mmput(mm);
+
+	if (copy_to_user(uarg, &karg, min_t(size_t, sizeof(karg), usize)))
+		return -EFAULT;
+
+	return 0;
+}
+
 static long procfs_procmap_ioctl(struct file *file, unsigned int cmd, unsigned long arg)
 {
 	struct seq_file *seq = file->private_data;
@@ -626,6 +702,8 @@ static long procfs_procmap_ioctl(struct file *file, unsigned int cmd, unsigned l
 	switch (cmd) {
 	case PROCMAP_QUERY:
 		return do_procmap_query(priv, (void __user *)arg);
+	case PROCMAP_MEMSTAT:
+		return do_procmap_memstat(priv, (void __user *)arg);
 	default:
 		return -ENOIOCTLCMD;
 	}
@@ -845,6 +845,12 @@ struct poll_list {
 
 #define POLLFD_PER_PAGE  ((PAGE_SIZE-sizeof(struct poll_list)) / sizeof(struct pollfd))
 
+/*
+ * From this many fds on, do_poll() first looks for ready fds without
+ * registering any waiters.
+ */
+#define POLL_PRESCAN_MIN	64
+
 /*
  * Fish for pollable events on the pollfd->fd file descriptor. We're only
  * interested in events matching the pollfd->events mask, and the result
@@ -882,15 +888,17 @@ static inline __poll_t do_pollfd(struct pollfd *pollfd, poll_table *pwait,
 	return mask;
 }
 
-static int do_poll(struct poll_list *list, struct poll_wqueues *wait,
-		   struct timespec64 *end_time)
+static int do_poll(struct poll_list *list, unsigned int nfds,
+		   struct poll_wqueues *wait, struct timespec64 *end_time)
 {
 	poll_table* pt = &wait->pt;
+	poll_queue_proc qproc = pt->_qproc;
 	ktime_t expire, *to = NULL;
 	int timed_out = 0, count = 0;
 	u64 slack = 0;
 	__poll_t busy_flag = net_busy_loop_on() ? POLL_BUSY_LOOP : 0;
 	unsigned long busy_start = 0;
+	bool prescan = false;
 
 	/* Optimise the no-wait case */
 	if (end_time && !end_time->tv_sec && !end_time->tv_nsec) {
@@ -898,6 +906,18 @@ static int do_poll(struct poll_list *list, struct poll_wqueues *wait,
 		timed_out = 1;
 	}
 
+	/*
+	 * Registering a waiter takes a file reference and the waitqueue
+	 * lock, and poll_freewait() undoes it all again before we return.
+	 * With a large set of fds, of which some are usually ready, that
+	 * is most of the cost of a poll() which doesn't sleep, so look for
+	 * ready fds first and only register if there are none.
+	 */
+	if (!timed_out && nfds >= POLL_PRESCAN_MIN) {
+		pt->_qproc = NULL;
+		prescan = true;
+	}
+
 	if (end_time && !timed_out)
 		slack = select_estimate_accuracy(end_time);
 
@@ -928,6 +948,15 @@ static int do_poll(struct poll_list *list, struct poll_wqueues *wait,
 				}
 			}
 		}
+		if (prescan) {
+			prescan = false;
+			if (!count && !signal_pending(current)) {
+				/* Nothing ready, now do the registering pass */
+				pt->_qproc = qproc;
+				continue;
+			}
+		}
+
 		/*
 		 * All waiters have already been registered, so don't provide
 		 * a poll_table->_qproc to them on the next loop iteration.
@@ -1013,7 +1042,7 @@ static int do_sys_poll(struct pollfd __user *ufds, unsigned int nfds,
 	}
 
 	poll_initwait(&table);
-	fdcount = do_poll(head, &table, end_time);
+	fdcount = do_poll(head, nfds, &table, end_time);
 	poll_freewait(&table);
 
 	if (!user_write_access_begin(ufds, nfds * sizeof(*ufds)))
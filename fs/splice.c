@@ -213,7 +213,7 @@ ssize_t splice_to_pipe(struct pipe_inode_info *pipe,
 		goto out;
 	}
 
-	while (!pipe_full(head, tail, pipe->max_usage)) {
+	while (!pipe_is_full(pipe)) {
 		struct pipe_buffer *buf = &pipe->bufs[head & mask];
 
 		buf->page = spd->pages[page_nr];
@@ -253,9 +253,10 @@ ssize_t add_to_pipe(struct pipe_inode_info *pipe, struct pipe_buffer *buf)
 	if (unlikely(!pipe->readers)) {
 		send_sig(SIGPIPE, current, 0);
 		ret = -EPIPE;
-	} else if (pipe_full(head, tail, pipe->max_usage)) {
+	} else if (pipe_is_full(pipe)) {
 		ret = -EAGAIN;
 	} else {
+		buf->flags &= ~PIPE_BUF_FLAG_LARGE;
 		pipe->bufs[head & mask] = *buf;
 		pipe->head = head + 1;
 		return buf->len;
@@ -327,13 +328,11 @@ ssize_t copy_splice_read(struct file *in, loff_t *ppos,
 	struct kiocb kiocb;
 	struct page **pages;
 	ssize_t ret;
-	size_t used, npages, chunk, remain, keep = 0;
+	size_t npages, chunk, remain, keep = 0;
 	int i;
 
 	/* Work out how much data we can actually add into the pipe */
-	used = pipe_occupancy(pipe->head, pipe->tail);
-	npages = max_t(ssize_t, pipe->max_usage - used, 0);
-	len = min_t(size_t, len, npages * PAGE_SIZE);
+	len = min_t(size_t, len, pipe_space(pipe));
 	npages = DIV_ROUND_UP(len, PAGE_SIZE);
 
 	bv = kzalloc(array_size(npages, sizeof(bv[0])) +
@@ -960,16 +959,13 @@ static ssize_t do_splice_read(struct file *in, loff_t *ppos,
 			      struct pipe_inode_info *pipe, size_t len,
 			      unsigned int flags)
 {
-	unsigned int p_space;
-
 	if (unlikely(!(in->f_mode & FMODE_READ)))
 		return -EBADF;
 	if (!len)
 		return 0;
 
 	/* Don't try to read more the pipe has space for. */
-	p_space = pipe->max_usage - pipe_occupancy(pipe->head, pipe->tail);
-	len = min_t(size_t, len, p_space << PAGE_SHIFT);
+	len = min_t(size_t, len, pipe_space(pipe));
 
 	if (unlikely(len > MAX_RW_COUNT))
 		len = MAX_RW_COUNT;
@@ -1268,7 +1264,7 @@ static int wait_for_space(struct pipe_inode_info *pipe, unsigned flags)
 			send_sig(SIGPIPE, current, 0);
 			return -EPIPE;
 		}
-		if (!pipe_full(pipe->head, pipe->tail, pipe->max_usage))
+		if (!pipe_is_full(pipe))
 			return 0;
 		if (flags & SPLICE_F_NONBLOCK)
 			return -EAGAIN;
@@ -1706,13 +1702,13 @@ static int opipe_prep(struct pipe_inode_info *pipe, unsigned int flags)
 	 * Check pipe occupancy without the inode lock first. This function
 	 * is speculative anyways, so missing one is ok.
 	 */
-	if (!pipe_full(pipe->head, pipe->tail, pipe->max_usage))
+	if (!pipe_is_full(pipe))
 		return 0;
 
 	ret = 0;
 	pipe_lock(pipe);
 
-	while (pipe_full(pipe->head, pipe->tail, pipe->max_usage)) {
+	while (pipe_is_full(pipe)) {
 		if (!pipe->readers) {
 			send_sig(SIGPIPE, current, 0);
 			ret = -EPIPE;
@@ -1742,7 +1738,7 @@ static int splice_pipe_to_pipe(struct pipe_inode_info *ipipe,
 {
 	struct pipe_buffer *ibuf, *obuf;
 	unsigned int i_head, o_head;
-	unsigned int i_tail, o_tail;
+	unsigned int i_tail;
 	unsigned int i_mask, o_mask;
 	int ret = 0;
 	bool input_wakeup = false;
@@ -1770,7 +1766,7 @@ static int splice_pipe_to_pipe(struct pipe_inode_info *ipipe,
 	o_mask = opipe->ring_size - 1;
 
 	do {
-		size_t o_len;
+		size_t o_len, room;
 
 		if (!opipe->readers) {
 			send_sig(SIGPIPE, current, 0);
@@ -1780,7 +1776,6 @@ static int splice_pipe_to_pipe(struct pipe_inode_info *ipipe,
 		}
 
 		i_head = ipipe->head;
-		o_tail = opipe->tail;
 
 		if (pipe_empty(i_head, i_tail) && !ipipe->writers)
 			break;
@@ -1789,8 +1784,8 @@ static int splice_pipe_to_pipe(struct pipe_inode_info *ipipe,
 		 * Cannot make any progress, because either the input
 		 * pipe is empty or the output pipe is full.
 		 */
-		if (pipe_empty(i_head, i_tail) ||
-		    pipe_full(o_head, o_tail, opipe->max_usage)) {
+		room = min(len, pipe_space(opipe));
+		if (pipe_empty(i_head, i_tail) || !room) {
 			/* Already processed some buffers, break */
 			if (ret)
 				break;
@@ -1813,10 +1808,11 @@ static int splice_pipe_to_pipe(struct pipe_inode_info *ipipe,
 		ibuf = &ipipe->bufs[i_tail & i_mask];
 		obuf = &opipe->bufs[o_head & o_mask];
 
-		if (len >= ibuf->len) {
+		if (room >= ibuf->len) {
 			/*
 			 * Simply move the whole buffer from ipipe to opipe
 			 */
+			pipe_buf_uncharge(ipipe, ibuf);
 			*obuf = *ibuf;
 			ibuf->ops = NULL;
 			i_tail++;
@@ -1843,14 +1839,16 @@ static int splice_pipe_to_pipe(struct pipe_inode_info *ipipe,
 			 */
 			obuf->flags &= ~PIPE_BUF_FLAG_GIFT;
 			obuf->flags &= ~PIPE_BUF_FLAG_CAN_MERGE;
+			obuf->flags &= ~PIPE_BUF_FLAG_LARGE;
 
-			obuf->len = len;
-			ibuf->offset += len;
-			ibuf->len -= len;
-			o_len = len;
+			obuf->len = room;
+			ibuf->offset += room;
+			ibuf->len -= room;
+			o_len = room;
 			o_head++;
 			opipe->head = o_head;
 		}
+		pipe_buf_charge(opipe, obuf);
 		ret += o_len;
 		len -= o_len;
 	} while (len);
@@ -1879,9 +1877,10 @@ static ssize_t link_pipe(struct pipe_inode_info *ipipe,
 {
 	struct pipe_buffer *ibuf, *obuf;
 	unsigned int i_head, o_head;
-	unsigned int i_tail, o_tail;
+	unsigned int i_tail;
 	unsigned int i_mask, o_mask;
 	ssize_t ret = 0;
+	size_t room;
 
 	/*
 	 * Potential ABBA deadlock, work around it by ordering lock
@@ -1904,14 +1903,13 @@ static ssize_t link_pipe(struct pipe_inode_info *ipipe,
 		}
 
 		i_head = ipipe->head;
-		o_tail = opipe->tail;
 
 		/*
 		 * If we have iterated all input buffers or run out of
 		 * output room, break.
 		 */
-		if (pipe_empty(i_head, i_tail) ||
-		    pipe_full(o_head, o_tail, opipe->max_usage))
+		room = min(len, pipe_space(opipe));
+		if (pipe_empty(i_head, i_tail) || !room)
 			break;
 
 		ibuf = &ipipe->bufs[i_tail & i_mask];
@@ -1935,9 +1933,11 @@ static ssize_t link_pipe(struct pipe_inode_info *ipipe,
 		 */
 		obuf->flags &= ~PIPE_BUF_FLAG_GIFT;
 		obuf->flags &= ~PIPE_BUF_FLAG_CAN_MERGE;
+		obuf->flags &= ~PIPE_BUF_FLAG_LARGE;
 
-		if (obuf->len > len)
-			obuf->len = len;
+		if (obuf->len > room)
+			obuf->len = room;
+		pipe_buf_charge(opipe, obuf);
 		ret += obuf->len;
 		len -= obuf->len;
 
@@ -197,6 +197,50 @@ int fsverity_hash_block(const struct merkle_tree_params *params,
 	return err;
 }
 
+/**
+ * fsverity_hash_blocks() - hash several data or hash blocks at once
+ * @params: the Merkle tree's parameters
+ * @inode: inode for which the hashing is being done
+ * @data: virtual addresses of buffers containing the blocks to hash
+ * @outs: output digests, size 'params->digest_size' bytes each
+ * @num_blocks: number of blocks
+ *
+ * Like fsverity_hash_block(), but for multiple blocks.  If the hash algorithm
+ * implementation can interleave the blocks, this is faster than hashing them
+ * one at a time.
+ *
+ * Return: 0 on success, -errno on failure
+ */
+int fsverity_hash_blocks(const struct merkle_tree_params *params,
+			 const struct inode *inode, const u8 * const data[],
+			 u8 * const outs[], unsigned int num_blocks)
+{
+	SHASH_DESC_ON_STACK(desc, params->hash_alg->tfm);
+	int err;
+
+	if (num_blocks == 1)
+		return fsverity_hash_block(params, inode, data[0], outs[0]);
+
+	desc->tfm = params->hash_alg->tfm;
+
+	if (params->hashstate) {
+		err = crypto_shash_import(desc, params->hashstate);
+		if (err) {
+			fsverity_err(inode,
+				     "Error %d importing hash state", err);
+			return err;
+		}
+	} else {
+		err = crypto_shash_init(desc);
+	}
+	if (!err)
+		err = crypto_shash_finup_mb(desc, data, params->block_size,
+					    outs, num_blocks);
+	if (err)
+		fsverity_err(inode, "Error %d computing block hashes", err);
+	return err;
+}
+
 /**
  * fsverity_hash_buffer() - hash some data
  * @alg: the hash algorithm to use
@@ -12,6 +12,12 @@
 
 static struct workqueue_struct *fsverity_read_workqueue;
 
+/*
+ * The maximum number of data blocks which are hashed at once.  This is
+ * limited by the number of pages we may keep mapped with kmap_local.
+ */
+#define FS_VERITY_MAX_PENDING_BLOCKS	2
+
 /*
  * Returns true if the hash block with index @hblock_idx in the tree, located in
  * @hpage, has already been verified.
@@ -86,11 +92,15 @@ static bool is_hash_block_verified(struct fsverity_info *vi, struct page *hpage,
  * only ascend the tree until an already-verified hash block is seen, and then
  * verify the path to that block.
  *
+ * @data_hash is the hash of the data block, which may have been computed
+ * together with those of other data blocks.
+ *
  * Return: %true if the data block is valid, else %false.
  */
 static bool
 verify_data_block(struct inode *inode, struct fsverity_info *vi,
-		  const void *data, u64 data_pos, unsigned long max_ra_pages)
+		  const void *data, const u8 *data_hash, u64 data_pos,
+		  unsigned long max_ra_pages)
 {
 	const struct merkle_tree_params *params = &vi->tree_params;
 	const unsigned int hsize = params->digest_size;
@@ -115,8 +125,12 @@ verify_data_block(struct inode *inode, struct fsverity_info *vi,
 	 */
 	u64 hidx = data_pos >> params->log_blocksize;
 
-	/* Up to 1 + FS_VERITY_MAX_LEVELS pages may be mapped at once */
-	BUILD_BUG_ON(1 + FS_VERITY_MAX_LEVELS > KM_MAX_IDX);
+	/*
+	 * Up to FS_VERITY_MAX_PENDING_BLOCKS + FS_VERITY_MAX_LEVELS pages may be
+	 * mapped at once
+	 */
+	BUILD_BUG_ON(FS_VERITY_MAX_PENDING_BLOCKS + FS_VERITY_MAX_LEVELS >
+		     KM_MAX_IDX);
 
 	if (unlikely(data_pos >= inode->i_size)) {
 		/*
@@ -221,11 +235,11 @@ verify_data_block(struct inode *inode, struct fsverity_info *vi,
 		put_page(hpage);
 	}
 
-	/* Finally, verify the data block. */
-	if (fsverity_hash_block(params, inode, data, real_hash) != 0)
-		goto error;
-	if (memcmp(want_hash, real_hash, hsize) != 0)
+	/* Finally, verify the data block, which the caller already hashed. */
+	if (memcmp(want_hash, data_hash, hsize) != 0) {
+		memcpy(real_hash, data_hash, hsize);
 		goto corrupted;
+	}
 	return true;
 
 corrupted:
@@ -248,26 +262,50 @@ verify_data_blocks(struct folio *data_folio, size_t len, size_t offset,
 {
 	struct inode *inode = data_folio->mapping->host;
 	struct fsverity_info *vi = inode->i_verity_info;
-	const unsigned int block_size = vi->tree_params.block_size;
+	const struct merkle_tree_params *params = &vi->tree_params;
+	const unsigned int block_size = params->block_size;
+	const unsigned int max_pending =
+		min_t(unsigned int,
+		      crypto_shash_mb_max_msgs(params->hash_alg->tfm),
+		      FS_VERITY_MAX_PENDING_BLOCKS);
 	u64 pos = (u64)data_folio->index << PAGE_SHIFT;
+	u8 hashes[FS_VERITY_MAX_PENDING_BLOCKS][FS_VERITY_MAX_DIGEST_SIZE];
+	u8 *outs[FS_VERITY_MAX_PENDING_BLOCKS];
+	const u8 *data[FS_VERITY_MAX_PENDING_BLOCKS];
+	unsigned int i, n;
 
 	if (WARN_ON_ONCE(len <= 0 || !IS_ALIGNED(len | offset, block_size)))
 		return false;
 	if (WARN_ON_ONCE(!folio_test_locked(data_folio) ||
 			 folio_test_uptodate(data_folio)))
 		return false;
+
+	for (i = 0; i < FS_VERITY_MAX_PENDING_BLOCKS; i++)
+		outs[i] = hashes[i];
+
 	do {
-		void *data;
-		bool valid;
+		bool valid = true;
 
-		data = kmap_local_folio(data_folio, offset);
-		valid = verify_data_block(inode, vi, data, pos + offset,
-					  max_ra_pages);
-		kunmap_local(data);
+		/*
+		 * Hash as many data blocks together as the hash implementation
+		 * can interleave, then verify them against the tree one by one.
+		 */
+		n = min_t(size_t, len / block_size, max_pending);
+		for (i = 0; i < n; i++)
+			data[i] = kmap_local_folio(data_folio,
+						   offset + i * block_size);
+		if (fsverity_hash_blocks(params, inode, data, outs, n) != 0)
+			valid = false;
+		for (i = 0; i < n && valid; i++)
+			valid = verify_data_block(inode, vi, data[i], hashes[i],
+						  pos + offset + i * block_size,
+						  max_ra_pages);
+		for (i = n; i > 0; i--)
+			kunmap_local(data[i - 1]);
 		if (!valid)
 			return false;
-		offset += block_size;
-		len -= block_size;
+		offset += n * block_size;
+		len -= n * block_size;
 	} while (len);
 	return true;
 }
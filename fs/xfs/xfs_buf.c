@@ -1057,6 +1057,20 @@ xfs_buf_rele_uncached(
 	}
 }
 
+static inline bool
+xfs_buf_rele_fast(
+	struct xfs_buf		*bp)
+{
+	int			hold = atomic_read(&bp->b_hold);
+
+	do {
+		if (hold <= 2)
+			return false;
+	} while (!atomic_try_cmpxchg(&bp->b_hold, &hold, hold - 1));
+
+	return true;
+}
+
 static void
 xfs_buf_rele_cached(
 	struct xfs_buf		*bp)
@@ -1071,6 +1085,17 @@ xfs_buf_rele_cached(
 
 	ASSERT(atomic_read(&bp->b_hold) > 0);
 
+	/*
+	 * Fast path: if at least two other references remain after dropping
+	 * ours, this is neither the last nor the second to last reference, so
+	 * there is no LRU or in-flight state to update and nothing that can
+	 * free the buffer underneath us. Drop it without touching b_lock so
+	 * that parallel lookups of hot metadata buffers don't bounce the lock
+	 * cacheline. We must not dereference bp after the decrement.
+	 */
+	if (xfs_buf_rele_fast(bp))
+		return;
+
 	/*
 	 * We grab the b_lock here first to serialise racing xfs_buf_rele()
 	 * calls. The pag_buf_lock being taken on the last reference only
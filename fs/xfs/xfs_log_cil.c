@@ -907,6 +907,8 @@ xlog_cil_committed(
 		spin_unlock(&ctx->cil->xc_push_lock);
 	}
 
+	trace_xfs_cil_push_committed(ctx);
+
 	xlog_cil_ail_insert(ctx, abort);
 
 	xfs_extent_busy_sort(&ctx->busy_extents.extent_list);
@@ -1385,6 +1387,9 @@ xlog_cil_push_work(
 	list_add(&ctx->committing, &cil->xc_committing);
 	spin_unlock(&cil->xc_push_lock);
 
+	ctx->push_start = ktime_get_ns();
+	trace_xfs_cil_push_start(ctx);
+
 	xlog_cil_build_lv_chain(ctx, &whiteouts, &num_iovecs, &num_bytes);
 
 	/*
@@ -1449,6 +1454,8 @@ xlog_cil_push_work(
 	if (error)
 		goto out_abort_free_ticket;
 
+	trace_xfs_cil_push_written(ctx);
+
 	/*
 	 * Grab the ticket from the ctx so we can ungrant it after releasing the
 	 * commit_iclog. The ctx may be freed by the time we return from
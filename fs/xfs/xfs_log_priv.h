@@ -232,6 +232,7 @@ struct xfs_cil_ctx {
 	struct list_head	committing;	/* ctx committing list */
 	struct work_struct	push_work;
 	atomic_t		order_id;
+	u64			push_start;	/* push start time, ns */
 
 	/*
 	 * CPUs that could have added items to the percpu CIL data.  Access is
@@ -65,6 +65,7 @@ struct xlog_recover;
 struct xlog_recover_item;
 struct xlog_rec_header;
 struct xlog_in_core;
+struct xfs_cil_ctx;
 struct xfs_buf_log_format;
 struct xfs_inode_log_format;
 struct xfs_bmbt_irec;
@@ -1352,6 +1353,44 @@ TRACE_EVENT(xfs_log_force,
 		  __entry->lsn, (void *)__entry->caller_ip)
 )
 
+DECLARE_EVENT_CLASS(xfs_cil_push_class,
+	TP_PROTO(struct xfs_cil_ctx *ctx),
+	TP_ARGS(ctx),
+	TP_STRUCT__entry(
+		__field(dev_t, dev)
+		__field(xfs_csn_t, sequence)
+		__field(xfs_lsn_t, start_lsn)
+		__field(xfs_lsn_t, commit_lsn)
+		__field(int, space_used)
+		__field(u64, elapsed_ns)
+	),
+	TP_fast_assign(
+		__entry->dev = ctx->cil->xc_log->l_mp->m_super->s_dev;
+		__entry->sequence = ctx->sequence;
+		__entry->start_lsn = ctx->start_lsn;
+		__entry->commit_lsn = ctx->commit_lsn;
+		__entry->space_used = atomic_read(&ctx->space_used);
+		__entry->elapsed_ns = ctx->push_start ?
+				ktime_get_ns() - ctx->push_start : 0;
+	),
+	TP_printk("dev %d:%d seq %llu start_lsn 0x%llx commit_lsn 0x%llx "
+		  "space_used %d elapsed_ns %llu",
+		  MAJOR(__entry->dev), MINOR(__entry->dev),
+		  __entry->sequence,
+		  __entry->start_lsn,
+		  __entry->commit_lsn,
+		  __entry->space_used,
+		  __entry->elapsed_ns)
+)
+
+#define DEFINE_CIL_PUSH_EVENT(name) \
+DEFINE_EVENT(xfs_cil_push_class, name, \
+	TP_PROTO(struct xfs_cil_ctx *ctx), \
+	TP_ARGS(ctx))
+DEFINE_CIL_PUSH_EVENT(xfs_cil_push_start);
+DEFINE_CIL_PUSH_EVENT(xfs_cil_push_written);
+DEFINE_CIL_PUSH_EVENT(xfs_cil_push_committed);
+
 #define DEFINE_LOG_ITEM_EVENT(name) \
 DEFINE_EVENT(xfs_log_item_class, name, \
 	TP_PROTO(struct xfs_log_item *lip), \
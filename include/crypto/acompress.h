@@ -43,6 +43,8 @@ struct acomp_req {
  *
  * @compress:		Function performs a compress operation
  * @decompress:		Function performs a de-compress operation
+ * @batch_compress:	Function submits a batch of compress operations
+ * @batch_decompress:	Function submits a batch of de-compress operations
  * @dst_free:		Frees destination buffer if allocated inside the
  *			algorithm
  * @reqsize:		Context size for (de)compression requests
@@ -51,6 +53,10 @@ struct acomp_req {
 struct crypto_acomp {
 	int (*compress)(struct acomp_req *req);
 	int (*decompress)(struct acomp_req *req);
+	void (*batch_compress)(struct acomp_req *reqs[], int errors[],
+			       unsigned int nr);
+	void (*batch_decompress)(struct acomp_req *reqs[], int errors[],
+				 unsigned int nr);
 	void (*dst_free)(struct scatterlist *dst);
 	unsigned int reqsize;
 	struct crypto_tfm base;
@@ -265,4 +271,39 @@ static inline int crypto_acomp_decompress(struct acomp_req *req)
 	return crypto_acomp_reqtfm(req)->decompress(req);
 }
 
+/**
+ * crypto_acomp_batch_compress() -- Submit a batch of compress operations
+ *
+ * Function submits @nr compress requests of the same tfm at once, which
+ * lets drivers feed their hardware queues in one go.  The result of each
+ * request is stored in @errors, where -EINPROGRESS and -EBUSY mean that
+ * the request is completed through its callback later, as with
+ * crypto_acomp_compress().  Without driver support the requests are
+ * submitted one by one.
+ *
+ * @reqs:	asynchronous compress requests
+ * @errors:	per-request return values
+ * @nr:		number of requests
+ *
+ * Return:	zero if all requests succeeded or are in progress; otherwise
+ *		the error of the first failed request
+ */
+int crypto_acomp_batch_compress(struct acomp_req *reqs[], int errors[],
+				unsigned int nr);
+
+/**
+ * crypto_acomp_batch_decompress() -- Submit a batch of decompress operations
+ *
+ * Same as crypto_acomp_batch_compress(), for decompression.
+ *
+ * @reqs:	asynchronous compress requests
+ * @errors:	per-request return values
+ * @nr:		number of requests
+ *
+ * Return:	zero if all requests succeeded or are in progress; otherwise
+ *		the error of the first failed request
+ */
+int crypto_acomp_batch_decompress(struct acomp_req *reqs[], int errors[],
+				  unsigned int nr);
+
 #endif
@@ -191,6 +191,12 @@ struct shash_desc {
  *	      This is a counterpart to @init_tfm, used to remove
  *	      various changes set in @init_tfm.
  * @clone_tfm: Copy transform into new object, may allocate memory.
+ * @finup_mb: Finish multiple messages of the same length, which all continue
+ *	      from the state in the descriptor, at once.  This is called with
+ *	      2 to @mb_max_msgs messages and is expected to be faster than
+ *	      that many calls to @finup, typically by interleaving the
+ *	      messages.  Optional.
+ * @mb_max_msgs: Maximum number of messages @finup_mb can take.
  * @descsize: Size of the operational state for the message digest. This state
  * 	      size is the memory size that needs to be allocated for
  *	      shash_desc.__ctx
@@ -213,7 +219,11 @@ struct shash_alg {
 	int (*init_tfm)(struct crypto_shash *tfm);
 	void (*exit_tfm)(struct crypto_shash *tfm);
 	int (*clone_tfm)(struct crypto_shash *dst, struct crypto_shash *src);
+	int (*finup_mb)(struct shash_desc *desc, const u8 * const data[],
+			unsigned int len, u8 * const outs[],
+			unsigned int num_msgs);
 
+	unsigned int mb_max_msgs;
 	unsigned int descsize;
 
 	union {
@@ -747,6 +757,19 @@ static inline unsigned int crypto_shash_digestsize(struct crypto_shash *tfm)
 	return crypto_shash_alg(tfm)->digestsize;
 }
 
+/**
+ * crypto_shash_mb_max_msgs() - obtain the multibuffer limit
+ * @tfm: hash transformation object
+ *
+ * Return: the number of messages crypto_shash_finup_mb() can process at once
+ *	   faster than one by one, or 1 if the algorithm has no multibuffer
+ *	   implementation.
+ */
+static inline unsigned int crypto_shash_mb_max_msgs(struct crypto_shash *tfm)
+{
+	return crypto_shash_alg(tfm)->mb_max_msgs;
+}
+
 static inline unsigned int crypto_shash_statesize(struct crypto_shash *tfm)
 {
 	return crypto_shash_alg(tfm)->statesize;
@@ -944,6 +967,26 @@ int crypto_shash_final(struct shash_desc *desc, u8 *out);
 int crypto_shash_finup(struct shash_desc *desc, const u8 *data,
 		       unsigned int len, u8 *out);
 
+/**
+ * crypto_shash_finup_mb() - finish multiple messages of the same length
+ * @desc: operational state handle, with the data common to all messages
+ *	  already added.  Its state is undefined afterwards.
+ * @data: pointers to the remaining data of each message
+ * @len: length of the remaining data of each message
+ * @outs: output buffers for the message digests
+ * @num_msgs: number of messages
+ *
+ * Compute crypto_shash_finup() of each data[i] on a copy of @desc.  Up to
+ * crypto_shash_mb_max_msgs() messages may be processed in parallel, which is
+ * much faster on some CPUs than hashing them one at a time.
+ *
+ * Context: Any context.
+ * Return: 0 if all message digests were computed; < 0 if an error occurred
+ */
+int crypto_shash_finup_mb(struct shash_desc *desc, const u8 * const data[],
+			  unsigned int len, u8 * const outs[],
+			  unsigned int num_msgs);
+
 static inline void shash_desc_zero(struct shash_desc *desc)
 {
 	memzero_explicit(desc,
@@ -17,6 +17,13 @@
  *
  * @compress:	Function performs a compress operation
  * @decompress:	Function performs a de-compress operation
+ * @batch_compress:	Submit a vector of compress requests at once, storing
+ *		the return value @compress would have given for each request
+ *		in the errors array.  Requests which return -EINPROGRESS or
+ *		-EBUSY complete through their own callbacks, as usual.
+ *		Optional, for hardware which can take a batch of requests
+ *		more cheaply than one at a time.
+ * @batch_decompress:	Same as @batch_compress, for decompression
  * @dst_free:	Frees destination buffer if allocated inside the algorithm
  * @init:	Initialize the cryptographic transformation object.
  *		This function is used to initialize the cryptographic
@@ -37,6 +44,10 @@
 struct acomp_alg {
 	int (*compress)(struct acomp_req *req);
 	int (*decompress)(struct acomp_req *req);
+	void (*batch_compress)(struct acomp_req *reqs[], int errors[],
+			       unsigned int nr);
+	void (*batch_decompress)(struct acomp_req *reqs[], int errors[],
+				 unsigned int nr);
 	void (*dst_free)(struct scatterlist *dst);
 	int (*init)(struct crypto_acomp *tfm);
 	void (*exit)(struct crypto_acomp *tfm);
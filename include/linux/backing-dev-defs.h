@@ -132,6 +132,11 @@ struct bdi_writeback {
 	unsigned long dirty_ratelimit;
 	unsigned long balanced_dirty_ratelimit;
 
+	/* balance_dirty_pages() pauses of tasks dirtying through this wb */
+	atomic_long_t nr_throttled;
+	atomic_long_t throttle_time;	/* total pause time, in jiffies */
+	unsigned long max_throttle_time; /* longest pause, in jiffies */
+
 	struct fprop_local_percpu completions;
 	int dirty_exceeded;
 	enum wb_reason start_all_reason;
@@ -1492,6 +1492,11 @@ struct bpf_prog_aux {
 	struct user_struct *user;
 	u64 load_time; /* ns since boottime */
 	u32 verified_insns;
+	/* verifier states allocated, pruned and kept at peak, see bpf_verifier_env */
+	u32 verified_states;
+	u32 verified_pruned_states;
+	u32 verified_peak_states;
+	u64 verification_time; /* ns spent in bpf_check() */
 	int cgroup_atype; /* enum cgroup_bpf_attach_type */
 	struct bpf_map *cgroup_storage[MAX_BPF_CGROUP_STORAGE_TYPE];
 	char name[BPF_OBJ_NAME_LEN];
@@ -745,6 +745,8 @@ struct bpf_verifier_env {
 	 * memory consumption during verification
 	 */
 	u32 peak_states;
+	/* number of states pruned as equivalent to an explored state */
+	u32 pruned_states;
 	/* longest register parentage chain walked for liveness marking */
 	u32 longest_mark_read_walk;
 	bpfptr_t fd_array;
@@ -402,6 +402,12 @@ struct ceph_osd_backoff {
 
 #define CEPH_LINGER_ID_START	0xffff000000000000ULL
 
+/*
+ * Request latency histogram, log2 buckets in usecs: bucket 0 is < 1us,
+ * bucket i covers [2^(i-1), 2^i) us and the last one is open ended.
+ */
+#define CEPH_OSDC_LAT_BUCKETS	24
+
 struct ceph_osd_client {
 	struct ceph_client     *client;
 
@@ -434,6 +440,9 @@ struct ceph_osd_client {
 
 	struct workqueue_struct	*notify_wq;
 	struct workqueue_struct	*completion_wq;
+
+	atomic64_t		read_lat_hist[CEPH_OSDC_LAT_BUCKETS];
+	atomic64_t		write_lat_hist[CEPH_OSDC_LAT_BUCKETS];
 };
 
 static inline bool ceph_osdmap_flag(struct ceph_osd_client *osdc, int flag)
@@ -515,6 +515,12 @@ struct cgroup {
 	 */
 	struct cgroup	*rstat_flush_next;
 
+	/*
+	 * ktime_get_ns() at the start of the last flush of this subtree,
+	 * see cgroup_rstat_flushed_within().
+	 */
+	u64		rstat_flush_time;
+
 	/* cgroup basic resource statistics */
 	struct cgroup_base_stat last_bstat;
 	struct cgroup_base_stat bstat;
@@ -317,6 +317,9 @@ struct nbcon_write_context {
  * @ospeed:		TTY output speed
  * @seq:		Sequence number of the next ringbuffer record to print
  * @dropped:		Number of unreported dropped ringbuffer records
+ * @stat_dropped:	Total number of dropped ringbuffer records
+ * @stat_delayed:	Number of records printed more than 100ms after being stored
+ * @stat_max_delay_ns:	Longest time between storing and printing a record
  * @data:		Driver private data
  * @node:		hlist node for the console list
  *
@@ -341,6 +344,9 @@ struct console {
 	uint			ospeed;
 	u64			seq;
 	unsigned long		dropped;
+	unsigned long		stat_dropped;
+	unsigned long		stat_delayed;
+	u64			stat_max_delay_ns;
 	void			*data;
 	struct hlist_node	node;
 
@@ -288,6 +288,8 @@ struct damos_watermarks {
  * @nr_applied:	Total number of regions that the scheme is applied.
  * @sz_applied:	Total size of regions that the scheme is applied.
  * @qt_exceeds: Total number of times the quota of the scheme has exceeded.
+ * @sz_promoted: Total size migrated from lower tier nodes to top tier nodes.
+ * @sz_demoted:	Total size migrated from top tier nodes to lower tier nodes.
  */
 struct damos_stat {
 	unsigned long nr_tried;
@@ -295,6 +297,8 @@ struct damos_stat {
 	unsigned long nr_applied;
 	unsigned long sz_applied;
 	unsigned long qt_exceeds;
+	unsigned long sz_promoted;
+	unsigned long sz_demoted;
 };
 
 /**
@@ -396,7 +400,9 @@ struct damos_access_pattern {
  *
  * @target_nid is used to set the migration target node for migrate_hot or
  * migrate_cold actions, which means it's only meaningful when @action is either
- * "migrate_hot" or "migrate_cold".
+ * "migrate_hot" or "migrate_cold".  If it is NUMA_NO_NODE, the target follows
+ * the memory tiers: migrate_hot promotes to the closest top tier node, and
+ * migrate_cold demotes to the next demotion node of the source node.
  *
  * Before applying the &action to a memory region, &struct damon_operations
  * implementation could check pages of the region and skip &action to respect
@@ -964,6 +964,8 @@ struct fown_struct {
  *      the first of these pages is accessed.
  * @ra_pages: Maximum size of a readahead request, copied from the bdi.
  * @mmap_miss: How many mmap accesses missed in the page cache.
+ * @order: Largest folio order the most recent readahead managed to allocate.
+ * @stride: Distance in pages between the two most recent small reads.
  * @prev_pos: The last byte in the most recent read request.
  *
  * When this structure is passed to ->readahead(), the "most recent"
@@ -975,6 +977,8 @@ struct file_ra_state {
 	unsigned int async_size;
 	unsigned int ra_pages;
 	unsigned int mmap_miss;
+	unsigned short order;
+	unsigned short stride;
 	loff_t prev_pos;
 };
 
@@ -431,7 +431,7 @@ static inline bool gfp_compaction_allowed(gfp_t gfp_mask)
 	return IS_ENABLED(CONFIG_COMPACTION) && (gfp_mask & __GFP_IO);
 }
 
-extern gfp_t vma_thp_gfp_mask(struct vm_area_struct *vma);
+extern gfp_t vma_thp_gfp_mask(struct vm_area_struct *vma, int order);
 
 #ifdef CONFIG_CONTIG_ALLOC
 /* The below functions must be run on a range from a single zone. */
@@ -360,6 +360,7 @@ static inline u64 hrtimer_forward_now(struct hrtimer *timer,
 extern int nanosleep_copyout(struct restart_block *, struct timespec64 *);
 extern long hrtimer_nanosleep(ktime_t rqtp, const enum hrtimer_mode mode,
 			      const clockid_t clockid);
+extern u64 hrtimer_user_slack_ns(bool task_slack);
 
 extern int schedule_hrtimeout_range(ktime_t *expires, u64 delta,
 				    const enum hrtimer_mode mode);
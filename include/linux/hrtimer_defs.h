@@ -83,6 +83,8 @@ enum  hrtimer_base_type {
  * @nr_retries:		Total number of hrtimer interrupt retries
  * @nr_hangs:		Total number of hrtimer interrupt hangs
  * @max_hang_time:	Maximum time spent in hrtimer_interrupt
+ * @nr_coalesced:	Total number of timers expired early within their slack
+ *			by the interrupt of another timer
  * @softirq_expiry_lock: Lock which is taken while softirq based hrtimer are
  *			 expired
  * @online:		CPU is online from an hrtimers point of view
@@ -115,6 +117,7 @@ struct hrtimer_cpu_base {
 	unsigned short			nr_retries;
 	unsigned short			nr_hangs;
 	unsigned int			max_hang_time;
+	unsigned int			nr_coalesced;
 #endif
 #ifdef CONFIG_PREEMPT_RT
 	spinlock_t			softirq_expiry_lock;
@@ -120,6 +120,16 @@ extern unsigned long transparent_hugepage_flags;
 extern unsigned long huge_anon_orders_always;
 extern unsigned long huge_anon_orders_madvise;
 extern unsigned long huge_anon_orders_inherit;
+extern unsigned long huge_file_orders_never;
+
+/*
+ * Whether page cache folios of @order may be allocated.  Only the sizes
+ * with a hugepages-<size>kB directory can be disabled.
+ */
+static inline bool thp_file_order_allowed(unsigned int order)
+{
+	return !(READ_ONCE(huge_file_orders_never) & BIT(order));
+}
 
 static inline bool hugepage_global_enabled(void)
 {
@@ -278,6 +288,8 @@ enum mthp_stat_item {
 	MTHP_STAT_SHMEM_ALLOC,
 	MTHP_STAT_SHMEM_FALLBACK,
 	MTHP_STAT_SHMEM_FALLBACK_CHARGE,
+	MTHP_STAT_FILE_ALLOC,
+	MTHP_STAT_FILE_FALLBACK,
 	MTHP_STAT_SPLIT,
 	MTHP_STAT_SPLIT_FAILED,
 	MTHP_STAT_SPLIT_DEFERRED,
@@ -432,6 +444,11 @@ bool unmap_huge_pmd_locked(struct vm_area_struct *vma, unsigned long addr,
 
 #else /* CONFIG_TRANSPARENT_HUGEPAGE */
 
+static inline bool thp_file_order_allowed(unsigned int order)
+{
+	return true;
+}
+
 static inline bool folio_test_pmd_mappable(struct folio *folio)
 {
 	return false;
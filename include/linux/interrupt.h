@@ -823,6 +823,7 @@ static inline void init_irq_proc(void)
 void irq_timings_enable(void);
 void irq_timings_disable(void);
 u64 irq_timings_next_event(u64 now);
+int irq_timings_first_irq(u64 since);
 #endif
 
 struct seq_file;
@@ -210,6 +210,18 @@ struct io_submit_state {
 	struct blk_plug		plug;
 };
 
+/* why a request was handed to io-wq, see io_queue_iowq() */
+enum {
+	/* IOSQE_ASYNC, drain or a link that had to go async */
+	IO_IOWQ_PUNT_FORCED,
+	/* -EAGAIN, and the opcode or file doesn't support poll */
+	IO_IOWQ_PUNT_NOPOLL,
+	/* -EAGAIN, and arming poll failed */
+	IO_IOWQ_PUNT_POLL,
+
+	IO_IOWQ_PUNT_NR,
+};
+
 struct io_alloc_cache {
 	void			**entries;
 	unsigned int		nr_cached;
@@ -278,6 +290,8 @@ struct io_ring_ctx {
 		 */
 		bool			poll_multi_queue;
 		struct io_wq_work_list	iopoll_list;
+		/* IORING_SETUP_HYBRID_IOPOLL, shortest completion time seen */
+		u64			hybrid_poll_time;
 
 		struct io_file_table	file_table;
 		struct io_mapped_ubuf	**user_bufs;
@@ -339,6 +353,8 @@ struct io_ring_ctx {
 
 	struct list_head	io_buffers_comp;
 	struct list_head	cq_overflow_list;
+	/* CQEs ever added to cq_overflow_list, protected by completion_lock */
+	unsigned long		cq_overflowed;
 	struct io_hash_table	cancel_table;
 
 	struct hlist_head	waitid_list;
@@ -392,6 +408,11 @@ struct io_ring_ctx {
 
 	/* io-wq management, e.g. thread count */
 	u32				iowq_limits[2];
+	/* requests started by io-wq, and their summed queueing delay */
+	atomic64_t			iowq_started;
+	atomic64_t			iowq_delay;
+	/* protected by ->uring_lock */
+	unsigned long			iowq_punts[IO_IOWQ_PUNT_NR];
 
 	struct callback_head		poll_wq_task_work;
 	struct list_head		defer_list;
@@ -465,6 +486,7 @@ enum {
 	REQ_F_BL_EMPTY_BIT,
 	REQ_F_BL_NO_RECYCLE_BIT,
 	REQ_F_BUFFERS_COMMIT_BIT,
+	REQ_F_IOPOLL_STATE_BIT,
 
 	/* not a real bit, just to check we're not overflowing the space */
 	__REQ_F_LAST_BIT,
@@ -543,6 +565,8 @@ enum {
 	REQ_F_BL_NO_RECYCLE	= IO_REQ_FLAG(REQ_F_BL_NO_RECYCLE_BIT),
 	/* buffer ring head needs incrementing on put */
 	REQ_F_BUFFERS_COMMIT	= IO_REQ_FLAG(REQ_F_BUFFERS_COMMIT_BIT),
+	/* hybrid iopoll has already slept for this request */
+	REQ_F_IOPOLL_STATE	= IO_REQ_FLAG(REQ_F_IOPOLL_STATE_BIT),
 };
 
 typedef void (*io_req_tw_func_t)(struct io_kiocb *req, struct io_tw_state *ts);
@@ -642,12 +666,18 @@ struct io_kiocb {
 	struct io_task_work		io_task_work;
 	/* for polled requests, i.e. IORING_OP_POLL_ADD and async armed poll */
 	struct hlist_node		hash_node;
-	/* internal polling, see IORING_FEAT_FAST_POLL */
-	struct async_poll		*apoll;
+	union {
+		/* internal polling, see IORING_FEAT_FAST_POLL */
+		struct async_poll	*apoll;
+		/* issue time for IORING_SETUP_HYBRID_IOPOLL, never polled */
+		u64			iopoll_start;
+	};
 	/* opcode allocated if it needs to store data for async defer */
 	void				*async_data;
 	/* linked requests, IFF REQ_F_HARDLINK or REQ_F_LINK are set */
 	atomic_t			poll_refs;
+	/* io-wq enqueue time in ns >> 10, 0 if not punted by io_queue_iowq */
+	u32				iowq_queued;
 	struct io_kiocb			*link;
 	/* custom credentials, valid IFF REQ_F_CREDS is set */
 	const struct cred		*creds;
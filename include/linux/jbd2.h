@@ -865,6 +865,14 @@ struct journal_s
 	 */
 	struct mutex		j_checkpoint_mutex;
 
+	/**
+	 * @j_checkpoint_work:
+	 *
+	 * Checkpoints old transactions in the background once the log fills
+	 * beyond the bg_checkpoint_pct module parameter.
+	 */
+	struct work_struct	j_checkpoint_work;
+
 	/**
 	 * @j_chkpt_bhs:
 	 *
@@ -1664,6 +1672,8 @@ int jbd2_log_do_checkpoint(journal_t *journal);
 int jbd2_trans_will_send_data_barrier(journal_t *journal, tid_t tid);
 
 void __jbd2_log_wait_for_space(journal_t *journal);
+void jbd2_log_start_bg_checkpoint(journal_t *journal);
+void jbd2_bg_checkpoint_work(struct work_struct *work);
 extern void __jbd2_journal_drop_transaction(journal_t *, transaction_t *);
 extern int jbd2_cleanup_journal_tail(journal_t *);
 
@@ -16,6 +16,8 @@ extern void khugepaged_enter_vma(struct vm_area_struct *vma,
 				 unsigned long vm_flags);
 extern void khugepaged_min_free_kbytes_update(void);
 extern bool current_is_khugepaged(void);
+extern void khugepaged_hint_hot(struct mm_struct *mm, unsigned long start,
+				unsigned long end);
 #ifdef CONFIG_SHMEM
 extern int collapse_pte_mapped_thp(struct mm_struct *mm, unsigned long addr,
 				   bool install_pmd);
@@ -63,6 +65,11 @@ static inline bool current_is_khugepaged(void)
 {
 	return false;
 }
+
+static inline void khugepaged_hint_hot(struct mm_struct *mm,
+				       unsigned long start, unsigned long end)
+{
+}
 #endif /* CONFIG_TRANSPARENT_HUGEPAGE */
 
 #endif /* _LINUX_KHUGEPAGED_H */
@@ -173,6 +173,22 @@ struct obj_cgroup {
 	};
 };
 
+/*
+ * Background reclaim driven by memory.reclaim.proactive. The budgets are per
+ * second, zero meaning no budget; @rate zero disables it.
+ */
+struct memcg_proactive_reclaim {
+	struct delayed_work work;
+	unsigned long rate;		/* max pages reclaimed per second */
+	unsigned long psi_us;		/* memory stall budget in usecs */
+	unsigned long refaults;		/* refault budget in pages */
+
+	/* state of the last run */
+	u64 last_stall;
+	unsigned long last_refaults;
+	atomic_long_t reclaimed;	/* total pages reclaimed */
+};
+
 /*
  * The memory controller data structure. The memory controller controls both
  * page cache and RSS per cgroup. We would eventually like to provide
@@ -196,6 +212,9 @@ struct mem_cgroup {
 	/* Range enforcement for interrupt charges */
 	struct work_struct high_work;
 
+	/* memory.reclaim.proactive */
+	struct memcg_proactive_reclaim proactive;
+
 #ifdef CONFIG_ZSWAP
 	unsigned long zswap_max;
 
@@ -969,6 +988,8 @@ unsigned long lruvec_page_state_local(struct lruvec *lruvec,
 				      enum node_stat_item idx);
 
 void mem_cgroup_flush_stats(struct mem_cgroup *memcg);
+void mem_cgroup_flush_stats_bounded(struct mem_cgroup *memcg,
+				    unsigned int max_age_ms);
 void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg);
 
 void __mod_lruvec_kmem_state(void *p, enum node_stat_item idx, int val);
@@ -1425,6 +1446,11 @@ static inline void mem_cgroup_flush_stats(struct mem_cgroup *memcg)
 {
 }
 
+static inline void mem_cgroup_flush_stats_bounded(struct mem_cgroup *memcg,
+						  unsigned int max_age_ms)
+{
+}
+
 static inline void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg)
 {
 }
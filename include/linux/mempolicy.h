@@ -16,6 +16,7 @@
 #include <uapi/linux/mempolicy.h>
 
 struct mm_struct;
+struct access_coordinate;
 
 #define NO_INTERLEAVE_INDEX (-1UL)	/* use task il_prev for interleaving */
 
@@ -178,6 +179,8 @@ static inline bool mpol_is_preferred_many(struct mempolicy *pol)
 
 extern bool apply_policy_zone(struct mempolicy *policy, enum zone_type zone);
 
+int mempolicy_set_node_perf(unsigned int node, struct access_coordinate *coords);
+
 #else
 
 struct mempolicy {};
@@ -298,5 +301,11 @@ static inline bool mpol_is_preferred_many(struct mempolicy *pol)
 	return  false;
 }
 
+static inline int mempolicy_set_node_perf(unsigned int node,
+					  struct access_coordinate *coords)
+{
+	return 0;
+}
+
 #endif /* CONFIG_NUMA */
 #endif
@@ -2875,6 +2875,15 @@ static inline struct ptdesc *pagetable_alloc_noprof(gfp_t gfp, unsigned int orde
 }
 #define pagetable_alloc(...)	alloc_hooks(pagetable_alloc_noprof(__VA_ARGS__))
 
+#ifdef CONFIG_MMU
+struct ptdesc *pagetable_cache_alloc(gfp_t gfp);
+#else
+static inline struct ptdesc *pagetable_cache_alloc(gfp_t gfp)
+{
+	return NULL;
+}
+#endif
+
 /**
  * pagetable_free - Free pagetables
  * @pt:	The page table descriptor
@@ -3573,7 +3582,8 @@ static inline void vma_set_page_prot(struct vm_area_struct *vma)
 void vma_set_file(struct vm_area_struct *vma, struct file *file);
 
 #ifdef CONFIG_NUMA_BALANCING
-unsigned long change_prot_numa(struct vm_area_struct *vma,
+unsigned long change_prot_numa(struct mmu_gather *tlb,
+			struct vm_area_struct *vma,
 			unsigned long start, unsigned long end);
 #endif
 
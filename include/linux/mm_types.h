@@ -899,6 +899,15 @@ struct mm_struct {
 		unsigned long stack_vm;	   /* VM_STACK */
 		unsigned long def_flags;
 
+		/* Threads copying large anonymous VMAs in fork() */
+		unsigned int fork_copy_threads;
+
+#ifdef CONFIG_FUTEX
+		/* Requested size of the private futex hash, see PR_FUTEX_HASH */
+		unsigned int futex_hash_slots;
+		struct futex_private_hash *futex_hash;
+#endif
+
 		/**
 		 * @write_protect_seq: Locked when any thread is write
 		 * protecting pages mapped by this mm to enforce a later COW,
@@ -1002,6 +1011,12 @@ struct mm_struct {
 		 * pages when enabling KSM use_zero_pages.
 		 */
 		atomic_long_t ksm_zero_pages;
+		/* Pages of this process ksmd has scanned */
+		unsigned long ksm_pages_scanned;
+		/* Full scans ksmd skipped for this process as unfruitful */
+		unsigned long ksm_scans_skipped;
+		/* Pages newly merged per 1000 scanned in the last full scan */
+		unsigned int ksm_scan_yield;
 #endif /* CONFIG_KSM */
 #ifdef CONFIG_LRU_GEN_WALKS_MMU
 		struct {
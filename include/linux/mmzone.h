@@ -655,16 +655,20 @@ enum zone_watermarks {
 
 /*
  * One per migratetype for each PAGE_ALLOC_COSTLY_ORDER. Two additional lists
- * are added for THP. One PCP list is used by GPF_MOVABLE, and the other PCP list
- * is used by GFP_UNMOVABLE and GFP_RECLAIMABLE.
+ * are added for THP and for each mTHP order above PAGE_ALLOC_COSTLY_ORDER up
+ * to PCP_MAX_MTHP_ORDER. One PCP list is used by GPF_MOVABLE, and the other
+ * PCP list is used by GFP_UNMOVABLE and GFP_RECLAIMABLE.
  */
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
-#define NR_PCP_THP 2
+#define PCP_MAX_MTHP_ORDER	(PAGE_ALLOC_COSTLY_ORDER + 4)
+#define NR_PCP_HIGH_ORDERS	(PCP_MAX_MTHP_ORDER - PAGE_ALLOC_COSTLY_ORDER + 1)
 #else
-#define NR_PCP_THP 0
+#define NR_PCP_HIGH_ORDERS	0
 #endif
+#define NR_PCP_THP (2 * NR_PCP_HIGH_ORDERS)
 #define NR_LOWORDER_PCP_LISTS (MIGRATE_PCPTYPES * (PAGE_ALLOC_COSTLY_ORDER + 1))
 #define NR_PCP_LISTS (NR_LOWORDER_PCP_LISTS + NR_PCP_THP)
+#define NR_PCP_ORDERS (PAGE_ALLOC_COSTLY_ORDER + 1 + NR_PCP_HIGH_ORDERS)
 
 #define min_wmark_pages(z) (z->_watermark[WMARK_MIN] + z->watermark_boost)
 #define low_wmark_pages(z) (z->_watermark[WMARK_LOW] + z->watermark_boost)
@@ -695,6 +699,10 @@ struct per_cpu_pages {
 	int batch;		/* chunk size for buddy add/remove */
 	u8 flags;		/* protected by pcp->lock */
 	u8 alloc_factor;	/* batch scaling factor during allocate */
+#if NR_PCP_HIGH_ORDERS
+	/* alloc_factor of each order above PAGE_ALLOC_COSTLY_ORDER */
+	u8 high_order_factor[NR_PCP_HIGH_ORDERS];
+#endif
 #ifdef CONFIG_NUMA
 	u8 expire;		/* When 0, remote pagesets are drained */
 #endif
@@ -1334,6 +1342,15 @@ typedef struct pglist_data {
 
 	int kswapd_failures;		/* Number of 'reclaimed == 0' runs */
 
+	/* Helper threads joining kswapd in balance_pgdat() */
+	struct kswapd_worker *kswapd_workers;	/* Protected by kswapd_lock */
+	unsigned int kswapd_nr_workers;	/* Including kswapd */
+	wait_queue_head_t kswapd_workers_wait;
+	bool kswapd_workers_active;
+	int kswapd_workers_priority;
+	bool kswapd_workers_may_writepage;
+	enum zone_type kswapd_workers_zoneidx;
+
 #ifdef CONFIG_COMPACTION
 	int kcompactd_max_order;
 	enum zone_type kcompactd_highest_zoneidx;
@@ -470,6 +470,9 @@ struct module {
 
 	unsigned long taints;	/* same bits as kernel:taint_flags */
 
+	/* Time from the start of loading until the module went live */
+	u64 load_time_ns;
+
 #ifdef CONFIG_GENERIC_BUG
 	/* Support for BUG */
 	unsigned num_bugs;
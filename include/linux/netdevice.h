@@ -338,9 +338,11 @@ struct gro_list {
 
 /*
  * size of gro hash buckets, must less than bit number of
- * napi_struct::gro_bitmask
+ * napi_struct::gro_bitmask. Each bucket holds at most MAX_GRO_SKBS
+ * flows, so this bounds the number of flows held per NAPI; 16 keeps
+ * many concurrent short UDP/QUIC flows from evicting each other.
  */
-#define GRO_HASH_BUCKETS	8
+#define GRO_HASH_BUCKETS	16
 
 /*
  * Structure for NAPI scheduling similar to tasklet but with weighting
@@ -370,6 +372,13 @@ struct napi_struct {
 	struct sk_buff		*skb;
 	struct list_head	rx_list; /* Pending GRO_NORMAL skbs */
 	int			rx_count; /* length of rx_list */
+	/* GRO stats, only written from the poll context */
+	unsigned long		gro_merged;	/* skbs merged into a held flow */
+	unsigned long		gro_held;	/* new flows added to gro_hash */
+	unsigned long		gro_evicted;	/* flows flushed by a full bucket */
+	/* IRQ suspension stats, see napi_suspend_irqs() */
+	unsigned long		irq_suspends;
+	unsigned long		irq_suspend_timeouts;
 	unsigned int		napi_id;
 	struct hrtimer		timer;
 	struct task_struct	*thread;
@@ -390,6 +399,7 @@ enum {
 	NAPI_STATE_PREFER_BUSY_POLL,	/* prefer busy-polling over softirq processing*/
 	NAPI_STATE_THREADED,		/* The poll is performed inside its own thread*/
 	NAPI_STATE_SCHED_THREADED,	/* Napi is currently scheduled in threaded mode */
+	NAPI_STATE_IRQ_SUSPENDED,	/* IRQs suspended by napi_suspend_irqs() */
 };
 
 enum {
@@ -403,6 +413,7 @@ enum {
 	NAPIF_STATE_PREFER_BUSY_POLL	= BIT(NAPI_STATE_PREFER_BUSY_POLL),
 	NAPIF_STATE_THREADED		= BIT(NAPI_STATE_THREADED),
 	NAPIF_STATE_SCHED_THREADED	= BIT(NAPI_STATE_SCHED_THREADED),
+	NAPIF_STATE_IRQ_SUSPENDED	= BIT(NAPI_STATE_IRQ_SUSPENDED),
 };
 
 enum gro_result {
@@ -1889,6 +1900,9 @@ enum netdev_reg_state {
  *	@gro_flush_timeout:	timeout for GRO layer in NAPI
  *	@napi_defer_hard_irqs:	If not zero, provides a counter that would
  *				allow to avoid NIC hard IRQ, on busy queues.
+ *	@irq_suspend_timeout:	If not zero, NAPI IRQs stay suspended for up to
+ *				this many ns while an application keeps
+ *				finding events with prefer_busy_poll
  *
  *	@rx_handler:		handler for received packets
  *	@rx_handler_data: 	XXX: need comments on this one
@@ -2105,6 +2119,7 @@ struct net_device {
 #endif
 	__cacheline_group_end(net_device_read_rx);
 
+	unsigned long		irq_suspend_timeout;
 	char			name[IFNAMSIZ];
 	struct netdev_name_node	*name_node;
 	struct dev_ifalias	__rcu *ifalias;
@@ -3099,6 +3114,8 @@ u16 dev_pick_tx_cpu_id(struct net_device *dev, struct sk_buff *skb,
 
 int __dev_queue_xmit(struct sk_buff *skb, struct net_device *sb_dev);
 int __dev_direct_xmit(struct sk_buff *skb, u16 queue_id);
+int __dev_direct_xmit_bulk(struct sk_buff **skbs, unsigned int n, u16 queue_id,
+			   unsigned int *done);
 
 static inline int dev_queue_xmit(struct sk_buff *skb)
 {
@@ -3219,6 +3236,10 @@ struct softnet_data {
 #endif
 
 	unsigned int		received_rps;
+	/* RFS steering accuracy, counted on the receiving CPU */
+	unsigned int		rfs_steered;	/* sent to the consuming CPU */
+	unsigned int		rfs_held;	/* kept on the old CPU for ordering */
+	unsigned int		rfs_collision;	/* sock flow slot used by another flow */
 	bool			in_net_rx_action;
 	bool			in_napi_threaded_poll;
 
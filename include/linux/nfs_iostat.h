@@ -116,6 +116,8 @@ enum nfs_stat_eventcounters {
 	NFSIOS_DELAY,
 	NFSIOS_PNFS_READ,
 	NFSIOS_PNFS_WRITE,
+	NFSIOS_RDPLUS_REVALIDATE,
+	NFSIOS_RDPLUS_INSTANTIATE,
 	__NFSIOS_COUNTSMAX,
 };
 
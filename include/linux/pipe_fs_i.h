@@ -2,6 +2,8 @@
 #ifndef _LINUX_PIPE_FS_I_H
 #define _LINUX_PIPE_FS_I_H
 
+#include <linux/mm.h>
+
 #define PIPE_DEF_BUFFERS	16
 
 #define PIPE_BUF_FLAG_LRU	0x01	/* page is on the LRU */
@@ -13,6 +15,7 @@
 #ifdef CONFIG_WATCH_QUEUE
 #define PIPE_BUF_FLAG_LOSS	0x40	/* Message loss happened after this buffer */
 #endif
+#define PIPE_BUF_FLAG_LARGE	0x80	/* counted in ->extra_pages of the pipe */
 
 /**
  *	struct pipe_buffer - a linux kernel pipe buffer
@@ -21,6 +24,8 @@
  *	@len: length of data inside the @page
  *	@ops: operations associated with this buffer. See @pipe_buf_operations.
  *	@flags: pipe buffer flags. See above.
+ *	@extra_pages: pages beyond the first charged to the pipe, if
+ *	PIPE_BUF_FLAG_LARGE is set
  *	@private: private data owned by the ops.
  **/
 struct pipe_buffer {
@@ -28,6 +33,7 @@ struct pipe_buffer {
 	unsigned int offset, len;
 	const struct pipe_buf_operations *ops;
 	unsigned int flags;
+	unsigned int extra_pages;
 	unsigned long private;
 };
 
@@ -42,6 +48,8 @@ struct pipe_buffer {
  *	@max_usage: The maximum number of slots that may be used in the ring
  *	@ring_size: total number of buffers (should be a power of 2)
  *	@nr_accounted: The amount this pipe accounts for in user->pipe_bufs
+ *	@extra_pages: Pages beyond the first of the buffers that cover several
+ *	pages, see pipe_space()
  *	@tmp_page: cached released page
  *	@readers: number of current readers of this pipe
  *	@writers: number of current writers of this pipe
@@ -63,6 +71,7 @@ struct pipe_inode_info {
 	unsigned int max_usage;
 	unsigned int ring_size;
 	unsigned int nr_accounted;
+	unsigned int extra_pages;
 	unsigned int readers;
 	unsigned int writers;
 	unsigned int files;
@@ -192,6 +201,74 @@ static inline struct pipe_buffer *pipe_head_buf(const struct pipe_inode_info *pi
 	return pipe_buf(pipe, pipe->head);
 }
 
+/**
+ * pipe_space - Return how many more bytes may be added to the pipe
+ * @pipe: The pipe to access
+ *
+ * A pipe holds at most max_usage pages. Buffers spliced from a large folio
+ * can cover several pages each, and the pages beyond the first are kept in
+ * pipe->extra_pages, so the pipe can run out of space before it runs out of
+ * slots. Can be called without pipe->mutex.
+ */
+static inline size_t pipe_space(const struct pipe_inode_info *pipe)
+{
+	unsigned int head = READ_ONCE(pipe->head);
+	unsigned int tail = READ_ONCE(pipe->tail);
+	unsigned int max_usage = READ_ONCE(pipe->max_usage);
+	unsigned int used = pipe_occupancy(head, tail) +
+			    READ_ONCE(pipe->extra_pages);
+
+	return used < max_usage ? (size_t)(max_usage - used) * PAGE_SIZE : 0;
+}
+
+/**
+ * pipe_is_full - Return true if nothing more may be added to the pipe
+ * @pipe: The pipe to access
+ *
+ * Like pipe_full(), but also true when buffers covering several pages have
+ * used up the size of the pipe.
+ */
+static inline bool pipe_is_full(const struct pipe_inode_info *pipe)
+{
+	return !pipe_space(pipe);
+}
+
+/**
+ * pipe_buf_charge - count a buffer covering several pages against the pipe
+ * @pipe:	the pipe that the buffer is being added to
+ * @buf:	the buffer, with its final length
+ *
+ * Must be called with pipe->mutex held, and undone with pipe_buf_uncharge()
+ * when the buffer leaves the ring.
+ */
+static inline void pipe_buf_charge(struct pipe_inode_info *pipe,
+				   struct pipe_buffer *buf)
+{
+	if (buf->len <= PAGE_SIZE)
+		return;
+
+	buf->flags |= PIPE_BUF_FLAG_LARGE;
+	buf->extra_pages = DIV_ROUND_UP(buf->len, PAGE_SIZE) - 1;
+	WRITE_ONCE(pipe->extra_pages, pipe->extra_pages + buf->extra_pages);
+}
+
+/**
+ * pipe_buf_uncharge - undo pipe_buf_charge()
+ * @pipe:	the pipe that the buffer is leaving
+ * @buf:	the buffer
+ *
+ * Must be called with pipe->mutex held.
+ */
+static inline void pipe_buf_uncharge(struct pipe_inode_info *pipe,
+				     struct pipe_buffer *buf)
+{
+	if (!(buf->flags & PIPE_BUF_FLAG_LARGE))
+		return;
+
+	buf->flags &= ~PIPE_BUF_FLAG_LARGE;
+	WRITE_ONCE(pipe->extra_pages, pipe->extra_pages - buf->extra_pages);
+}
+
 /**
  * pipe_buf_get - get a reference to a pipe_buffer
  * @pipe:	the pipe that the buffer belongs to
@@ -215,6 +292,8 @@ static inline void pipe_buf_release(struct pipe_inode_info *pipe,
 {
 	const struct pipe_buf_operations *ops = buf->ops;
 
+	pipe_buf_uncharge(pipe, buf);
+
 	buf->ops = NULL;
 	ops->release(pipe, buf);
 }
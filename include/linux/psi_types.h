@@ -84,11 +84,11 @@ enum psi_aggregators {
 struct psi_group_cpu {
 	/* 1st cacheline updated by the scheduler */
 
-	/* Aggregator needs to know of concurrent changes */
-	seqcount_t seq ____cacheline_aligned_in_smp;
-
-	/* States of the tasks belonging to this group */
-	unsigned int tasks[NR_PSI_TASK_COUNTS];
+	/*
+	 * States of the tasks belonging to this group. Concurrent changes
+	 * are detected through the per-CPU psi_seq shared by all groups.
+	 */
+	unsigned int tasks[NR_PSI_TASK_COUNTS] ____cacheline_aligned_in_smp;
 
 	/* Aggregate pressure state derived from the tasks */
 	u32 state_mask;
@@ -39,6 +39,7 @@ void kvfree_call_rcu(struct rcu_head *head, void *ptr);
 void rcu_barrier(void);
 void rcu_momentary_dyntick_idle(void);
 void kfree_rcu_scheduler_running(void);
+unsigned long kvfree_rcu_pending_bytes(void);
 bool rcu_gp_might_be_stalled(void);
 
 struct rcu_gp_oldstate {
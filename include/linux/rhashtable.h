@@ -76,6 +76,7 @@ struct rhash_lock_head {};
 struct bucket_table {
 	unsigned int		size;
 	unsigned int		nest;
+	unsigned int		rehash;
 	u32			hash_rnd;
 	struct list_head	walkers;
 	struct rcu_head		rcu;
@@ -551,6 +551,8 @@ struct sched_entity {
 	u64				vruntime;
 	s64				vlag;
 	u64				slice;
+	/* slice was requested through sched_attr::sched_runtime or cgroup */
+	unsigned char			custom_slice;
 
 	u64				nr_migrations;
 
@@ -983,6 +985,10 @@ struct task_struct {
 	/* delay due to memory thrashing */
 	unsigned                        in_thrashing:1;
 #endif
+#ifdef CONFIG_NUMA_BALANCING
+	/* group with other tasks mapping the same shared file, see prctl() */
+	unsigned			numa_shared_group:1;
+#endif
 #ifdef CONFIG_PREEMPT_RT
 	struct netdev_xmit		net_xmit;
 #endif
@@ -1899,6 +1905,14 @@ extern struct task_struct *find_get_task_by_vpid(pid_t nr);
 
 extern int wake_up_state(struct task_struct *tsk, unsigned int state);
 extern int wake_up_process(struct task_struct *tsk);
+
+#if defined(CONFIG_SMP) && !defined(CONFIG_PREEMPT_RT)
+extern void wake_up_batch_begin(void);
+extern void wake_up_batch_end(void);
+#else
+static inline void wake_up_batch_begin(void) { }
+static inline void wake_up_batch_end(void) { }
+#endif
 extern void wake_up_new_task(struct task_struct *tsk);
 
 #ifdef CONFIG_SMP
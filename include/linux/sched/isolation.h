@@ -21,6 +21,7 @@ enum hk_type {
 
 #ifdef CONFIG_CPU_ISOLATION
 DECLARE_STATIC_KEY_FALSE(housekeeping_overridden);
+DECLARE_STATIC_KEY_FALSE(housekeeping_strict);
 extern int housekeeping_any_cpu(enum hk_type type);
 extern const struct cpumask *housekeeping_cpumask(enum hk_type type);
 extern bool housekeeping_enabled(enum hk_type type);
@@ -72,4 +73,17 @@ static inline bool cpu_is_isolated(int cpu)
 	       cpuset_cpu_is_isolated(cpu);
 }
 
+/*
+ * Whether deferrable housekeeping work that would otherwise be queued on
+ * @cpu must be skipped ("isolcpus=strict,...").
+ */
+static inline bool cpu_is_isolated_strict(int cpu)
+{
+#ifdef CONFIG_CPU_ISOLATION
+	if (static_branch_unlikely(&housekeeping_strict))
+		return cpu_is_isolated(cpu);
+#endif
+	return false;
+}
+
 #endif /* _LINUX_SCHED_ISOLATION_H */
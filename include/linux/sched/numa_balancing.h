@@ -25,16 +25,20 @@ enum numa_vmaskip_reason {
 	NUMAB_SKIP_SEQ_COMPLETED,
 };
 
+struct address_space;
+
 #ifdef CONFIG_NUMA_BALANCING
-extern void task_numa_fault(int last_node, int node, int pages, int flags);
+extern void task_numa_fault(int last_node, int node, int pages, int flags,
+			    struct address_space *mapping);
 extern pid_t task_numa_group_id(struct task_struct *p);
 extern void set_numabalancing_state(bool enabled);
 extern void task_numa_free(struct task_struct *p, bool final);
 bool should_numa_migrate_memory(struct task_struct *p, struct folio *folio,
 				int src_nid, int dst_cpu);
+extern void numa_shared_group_forget(struct address_space *mapping);
 #else
 static inline void task_numa_fault(int last_node, int node, int pages,
-				   int flags)
+				   int flags, struct address_space *mapping)
 {
 }
 static inline pid_t task_numa_group_id(struct task_struct *p)
@@ -52,6 +56,9 @@ static inline bool should_numa_migrate_memory(struct task_struct *p,
 {
 	return true;
 }
+static inline void numa_shared_group_forget(struct address_space *mapping)
+{
+}
 #endif
 
 #endif /* _LINUX_SCHED_NUMA_BALANCING_H */
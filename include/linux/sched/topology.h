@@ -77,13 +77,29 @@ extern int sched_domain_level_max;
 
 struct sched_group;
 
+/* log2(us) buckets of the newidle balance cost histograms */
+#define SD_NEWIDLE_HIST_BUCKETS	12
+
 struct sched_domain_shared {
 	atomic_t	ref;
 	atomic_t	nr_busy_cpus;
 	int		has_idle_cores;
 	int		nr_idle_scan;
+	/*
+	 * CPUs of the LLC that are running their idle task. Set on idle
+	 * entry, cleared on idle exit and consulted by select_idle_cpu() so
+	 * that the wakeup path does not have to walk the whole LLC span.
+	 *
+	 * NOTE: this field is variable length, see sched_domain::span.
+	 */
+	unsigned long	idle_cpus[];
 };
 
+static inline struct cpumask *sds_idle_cpus(struct sched_domain_shared *sds)
+{
+	return to_cpumask(sds->idle_cpus);
+}
+
 struct sched_domain {
 	/* These fields must be setup */
 	struct sched_domain __rcu *parent;	/* top domain must be null terminated */
@@ -108,6 +124,7 @@ struct sched_domain {
 	/* idle_balance() stats */
 	u64 max_newidle_lb_cost;
 	unsigned long last_decay_max_lb_cost;
+	unsigned int newidle_ratio;	/* pull success ratio, see newidle_lb_budget() */
 
 #ifdef CONFIG_SCHEDSTATS
 	/* sched_balance_rq() stats */
@@ -139,6 +156,15 @@ struct sched_domain {
 	unsigned int ttwu_wake_remote;
 	unsigned int ttwu_move_affine;
 	unsigned int ttwu_move_balance;
+
+	/* select_idle_cpu() stats */
+	unsigned int sis_mask_count;
+	unsigned int sis_mask_avoided;
+
+	/* sched_balance_newidle() stats */
+	unsigned int newidle_skipped;
+	unsigned int newidle_hist_pulled[SD_NEWIDLE_HIST_BUCKETS];
+	unsigned int newidle_hist_failed[SD_NEWIDLE_HIST_BUCKETS];
 #endif
 #ifdef CONFIG_SCHED_DEBUG
 	char *name;
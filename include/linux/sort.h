@@ -13,4 +13,7 @@ void sort(void *base, size_t num, size_t size,
 	  cmp_func_t cmp_func,
 	  swap_func_t swap_func);
 
+void sort_parallel(void *base, size_t num, size_t size,
+		   cmp_func_t cmp_func);
+
 #endif
@@ -43,6 +43,8 @@ struct svc_pool {
 	struct percpu_counter	sp_messages_arrived;
 	struct percpu_counter	sp_sockets_queued;
 	struct percpu_counter	sp_threads_woken;
+	struct percpu_counter	sp_threads_starved; /* no idle thread to wake */
+	struct percpu_counter	sp_queue_time;	/* xprt queueing time, usecs */
 
 	unsigned long		sp_flags;
 } ____cacheline_aligned_in_smp;
@@ -426,7 +428,7 @@ int		   svc_register(const struct svc_serv *, struct net *, const int,
 
 void		   svc_wake_up(struct svc_serv *);
 void		   svc_reserve(struct svc_rqst *rqstp, int space);
-void		   svc_pool_wake_idle_thread(struct svc_pool *pool);
+bool		   svc_pool_wake_idle_thread(struct svc_pool *pool);
 struct svc_pool   *svc_pool_for_cpu(struct svc_serv *serv);
 char *		   svc_print_addr(struct svc_rqst *, char *, size_t);
 const char *	   svc_proc_name(const struct svc_rqst *rqstp);
@@ -29,11 +29,30 @@
 #define FOR_ALL_ZONES(xx) DMA_ZONE(xx) DMA32_ZONE(xx) xx##_NORMAL, \
 	HIGHMEM_ZONE(xx) xx##_MOVABLE, DEVICE_ZONE(xx)
 
+/* kswapd threads per node, including kswapd itself as worker 0 */
+#define KSWAPD_MAX_WORKERS	8
+
+#define FOR_ALL_KSWAPD_WORKERS(xx) xx##_0, xx##_1, xx##_2, xx##_3, \
+	xx##_4, xx##_5, xx##_6, xx##_7,
+
+/* Orders with pcp lists, see NR_PCP_ORDERS */
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+#define PCP_HIGH_ORDERS(xx) xx##_ORDER4, xx##_ORDER5, xx##_ORDER6, \
+	xx##_ORDER7, xx##_PMD,
+#else
+#define PCP_HIGH_ORDERS(xx)
+#endif
+
+#define FOR_ALL_PCP_ORDERS(xx) xx##_ORDER0, xx##_ORDER1, xx##_ORDER2, \
+	xx##_ORDER3, PCP_HIGH_ORDERS(xx)
+
 enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		FOR_ALL_ZONES(PGALLOC)
 		FOR_ALL_ZONES(ALLOCSTALL)
 		FOR_ALL_ZONES(PGSCAN_SKIP)
 		PGFREE, PGACTIVATE, PGDEACTIVATE, PGLAZYFREE,
+		FOR_ALL_PCP_ORDERS(PCP_ALLOC)
+		FOR_ALL_PCP_ORDERS(PCP_ZONE_LOCK)
 		PGFAULT, PGMAJFAULT,
 		PGLAZYFREED,
 		PGREFILL,
@@ -54,15 +73,20 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 #endif
 		PGINODESTEAL, SLABS_SCANNED, KSWAPD_INODESTEAL,
 		KSWAPD_LOW_WMARK_HIT_QUICKLY, KSWAPD_HIGH_WMARK_HIT_QUICKLY,
+		FOR_ALL_KSWAPD_WORKERS(KSWAPD_WORKER_SCAN)
+		FOR_ALL_KSWAPD_WORKERS(KSWAPD_WORKER_STEAL)
 		PAGEOUTRUN, PGROTATED,
 		DROP_PAGECACHE, DROP_SLAB,
 		OOM_KILL,
+		PGTABLE_CACHE_HIT,
+		PGTABLE_CACHE_MISS,
 #ifdef CONFIG_NUMA_BALANCING
 		NUMA_PTE_UPDATES,
 		NUMA_HUGE_PTE_UPDATES,
 		NUMA_HINT_FAULTS,
 		NUMA_HINT_FAULTS_LOCAL,
 		NUMA_PAGE_MIGRATE,
+		NUMA_TLB_FLUSH,
 #endif
 #ifdef CONFIG_MIGRATION
 		PGMIGRATE_SUCCESS, PGMIGRATE_FAIL,
@@ -108,6 +132,10 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		THP_SCAN_EXCEED_NONE_PTE,
 		THP_SCAN_EXCEED_SWAP_PTE,
 		THP_SCAN_EXCEED_SHARED_PTE,
+		THP_SCAN_RANGE,
+		THP_SCAN_RANGE_HOT,
+		THP_COLLAPSE_RANGE,
+		THP_COLLAPSE_RANGE_HOT,
 #ifdef CONFIG_HAVE_ARCH_TRANSPARENT_HUGEPAGE_PUD
 		THP_SPLIT_PUD,
 #endif
@@ -129,6 +157,14 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		NR_TLB_LOCAL_FLUSH_ALL,
 		NR_TLB_LOCAL_FLUSH_ONE,
 #endif /* CONFIG_DEBUG_TLBFLUSH */
+#ifdef CONFIG_ARCH_WANT_BATCHED_UNMAP_TLB_FLUSH
+		TLB_BATCH_DEFERRED,	/* PTE flushes deferred to a batch */
+		TLB_BATCH_FLUSH_RECLAIM,/* batch flushes, by enum tlb_batch_reason */
+		TLB_BATCH_FLUSH_MIGRATE,
+		TLB_BATCH_FLUSH_KHUGEPAGED,
+		TLB_BATCH_FLUSH_SPLIT,
+		TLB_BATCH_FLUSH_PENDING,/* flush_tlb_batched_pending() flushes */
+#endif
 #ifdef CONFIG_SWAP
 		SWAP_RA,
 		SWAP_RA_HIT,
@@ -144,6 +180,18 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		ZSWPOUT,
 		ZSWPWB,
 #endif
+#ifdef CONFIG_MEMCG
+		MEMCG_STOCK_HIT,	/* charges served from the per-cpu stock */
+		MEMCG_STOCK_MISS,
+		MEMCG_STOCK_DRAIN,	/* stock slots returned to their memcg */
+#endif
+#ifdef CONFIG_MMU
+		VMALLOC_POOL_HIT,	/* area reused from a per-node pool */
+		VMALLOC_POOL_MISS,	/* pool empty, area from the free tree */
+		VMALLOC_PURGE,		/* lazy purges that freed areas */
+		VMALLOC_PURGE_FLUSH,	/* TLB flushes done by lazy purges */
+		VMALLOC_PURGED_AREAS,
+#endif
 #ifdef CONFIG_X86
 		DIRECT_MAP_LEVEL2_SPLIT,
 		DIRECT_MAP_LEVEL3_SPLIT,
@@ -153,6 +201,12 @@ enum vm_event_item { PGPGIN, PGPGOUT, PSWPIN, PSWPOUT,
 		VMA_LOCK_ABORT,
 		VMA_LOCK_RETRY,
 		VMA_LOCK_MISS,
+		VMA_LOCK_RETRY_IO,
+		VMA_LOCK_RETRY_SWAP,
+		VMA_LOCK_RETRY_UFFD,
+		VMA_LOCK_FALLBACK_ANON,
+		VMA_LOCK_FALLBACK_FAULT,
+		VMA_LOCK_FALLBACK_DEVICE,
 #endif
 		NR_VM_EVENT_ITEMS
 };
@@ -130,8 +130,15 @@ static inline void vm_events_fold_cpu(int cpu)
 
 #ifdef CONFIG_PER_VMA_LOCK_STATS
 #define count_vm_vma_lock_event(x) count_vm_event(x)
+/* Why a fault under the per-VMA lock had to drop it and return VM_FAULT_RETRY */
+#define count_vm_vma_lock_fallback(vmf, x)			\
+	do {							\
+		if ((vmf)->flags & FAULT_FLAG_VMA_LOCK)		\
+			count_vm_event(x);			\
+	} while (0)
 #else
 #define count_vm_vma_lock_event(x) do {} while (0)
+#define count_vm_vma_lock_fallback(vmf, x) do { (void)(vmf); } while (0)
 #endif
 
 #define __count_zid_vm_events(item, zid, delta) \
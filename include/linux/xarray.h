@@ -1541,6 +1541,8 @@ void *xas_find_conflict(struct xa_state *);
 bool xas_get_mark(const struct xa_state *, xa_mark_t);
 void xas_set_mark(const struct xa_state *, xa_mark_t);
 void xas_clear_mark(const struct xa_state *, xa_mark_t);
+unsigned int xas_copy_mark_node(struct xa_state *, unsigned long max,
+		xa_mark_t from, xa_mark_t to);
 void *xas_find_marked(struct xa_state *, unsigned long max, xa_mark_t);
 void xas_init_marks(const struct xa_state *);
 
@@ -6,6 +6,7 @@
 #include <linux/netdevice.h>
 #include <linux/rhashtable-types.h>
 #include <linux/rcupdate.h>
+#include <linux/u64_stats_sync.h>
 #include <linux/netfilter.h>
 #include <linux/netfilter/nf_conntrack_tuple_common.h>
 #include <net/flow_offload.h>
@@ -73,6 +74,12 @@ enum nf_flowtable_flags {
 	NF_FLOWTABLE_COUNTER		= 0x2,	/* NFT_FLOWTABLE_COUNTER */
 };
 
+struct nf_flowtable_stats {
+	u64				hit;
+	u64				miss;
+	struct u64_stats_sync		syncp;
+};
+
 struct nf_flowtable {
 	unsigned int			flags;		/* readonly in datapath */
 	int				priority;	/* control path (padding hole) */
@@ -84,6 +91,7 @@ struct nf_flowtable {
 	struct flow_block		flow_block;
 	struct rw_semaphore		flow_block_lock; /* Guards flow_block */
 	possible_net_t			net;
+	struct nf_flowtable_stats __percpu *stats; /* software fast path */
 };
 
 static inline bool nf_flowtable_hw_offload(struct nf_flowtable *flowtable)
@@ -291,6 +299,8 @@ void nf_flow_table_cleanup(struct net_device *dev);
 
 int nf_flow_table_init(struct nf_flowtable *flow_table);
 void nf_flow_table_free(struct nf_flowtable *flow_table);
+void nf_flow_table_stats_read(const struct nf_flowtable *flow_table,
+			      u64 *hit, u64 *miss);
 
 void flow_offload_teardown(struct flow_offload *flow);
 
@@ -377,6 +387,19 @@ static inline bool nf_flow_pppoe_proto(struct sk_buff *skb, __be16 *inner_proto)
 	return true;
 }
 
+static inline void nf_flow_table_stats_inc(struct nf_flowtable *flow_table,
+					   bool hit)
+{
+	struct nf_flowtable_stats *stats = this_cpu_ptr(flow_table->stats);
+
+	u64_stats_update_begin(&stats->syncp);
+	if (hit)
+		stats->hit++;
+	else
+		stats->miss++;
+	u64_stats_update_end(&stats->syncp);
+}
+
 #define NF_FLOW_TABLE_STAT_INC(net, count) __this_cpu_inc((net)->ft.stat->count)
 #define NF_FLOW_TABLE_STAT_DEC(net, count) __this_cpu_dec((net)->ft.stat->count)
 #define NF_FLOW_TABLE_STAT_INC_ATOMIC(net, count)	\
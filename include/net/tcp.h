@@ -325,6 +325,7 @@ int tcp_v4_err(struct sk_buff *skb, u32);
 void tcp_shutdown(struct sock *sk, int how);
 
 int tcp_v4_early_demux(struct sk_buff *skb);
+int tcp_v4_early_demux_hint(struct sk_buff *skb, const struct sk_buff *hint);
 int tcp_v4_rcv(struct sk_buff *skb);
 
 void tcp_remove_empty_skb(struct sock *sk);
@@ -296,6 +296,33 @@ DEFINE_EVENT(cgroup_rstat, cgroup_rstat_cpu_unlock_fastpath,
 	TP_ARGS(cgrp, cpu, contended)
 );
 
+TRACE_EVENT(cgroup_rstat_flush,
+
+	TP_PROTO(struct cgroup *cgrp, u64 duration_ns, int nr_yields),
+
+	TP_ARGS(cgrp, duration_ns, nr_yields),
+
+	TP_STRUCT__entry(
+		__field(	int,		root			)
+		__field(	int,		level			)
+		__field(	u64,		id			)
+		__field(	u64,		duration_ns		)
+		__field(	int,		nr_yields		)
+	),
+
+	TP_fast_assign(
+		__entry->root = cgrp->root->hierarchy_id;
+		__entry->id = cgroup_id(cgrp);
+		__entry->level = cgrp->level;
+		__entry->duration_ns = duration_ns;
+		__entry->nr_yields = nr_yields;
+	),
+
+	TP_printk("root=%d id=%llu level=%d duration_ns=%llu yields=%d",
+		  __entry->root, __entry->id, __entry->level,
+		  __entry->duration_ns, __entry->nr_yields)
+);
+
 #endif /* _TRACE_CGROUP_H */
 
 /* This part must be outside protection */
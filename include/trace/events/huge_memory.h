@@ -90,6 +90,33 @@ TRACE_EVENT(mm_khugepaged_scan_pmd,
 		__entry->unmapped)
 );
 
+TRACE_EVENT(mm_khugepaged_scan_range,
+
+	TP_PROTO(struct mm_struct *mm, unsigned long addr, bool hot, int status),
+
+	TP_ARGS(mm, addr, hot, status),
+
+	TP_STRUCT__entry(
+		__field(struct mm_struct *, mm)
+		__field(unsigned long, addr)
+		__field(bool, hot)
+		__field(int, status)
+	),
+
+	TP_fast_assign(
+		__entry->mm = mm;
+		__entry->addr = addr;
+		__entry->hot = hot;
+		__entry->status = status;
+	),
+
+	TP_printk("mm=%p, addr=0x%lx, hot=%d, status=%s",
+		__entry->mm,
+		__entry->addr,
+		__entry->hot,
+		__print_symbolic(__entry->status, SCAN_STATUS))
+);
+
 TRACE_EVENT(mm_collapse_huge_page,
 
 	TP_PROTO(struct mm_struct *mm, int isolated, int status),
@@ -62,6 +62,34 @@ TRACE_EVENT(cpu_idle_miss,
 		(unsigned long)__entry->state, (__entry->below)?"below":"above")
 );
 
+TRACE_EVENT(cpu_idle_irq_predict,
+
+	TP_PROTO(unsigned int cpu_id, int irq, unsigned int state,
+		 unsigned int ideal),
+
+	TP_ARGS(cpu_id, irq, state, ideal),
+
+	TP_STRUCT__entry(
+		__field(u32,		cpu_id)
+		__field(int,		irq)
+		__field(u32,		state)
+		__field(u32,		ideal)
+	),
+
+	TP_fast_assign(
+		__entry->cpu_id = cpu_id;
+		__entry->irq = irq;
+		__entry->state = state;
+		__entry->ideal = ideal;
+	),
+
+	TP_printk("cpu_id=%lu irq=%d state=%lu ideal=%lu result=%s",
+		  (unsigned long)__entry->cpu_id, __entry->irq,
+		  (unsigned long)__entry->state, (unsigned long)__entry->ideal,
+		  __entry->state == __entry->ideal ? "hit" :
+		  __entry->state > __entry->ideal ? "too_deep" : "too_shallow")
+);
+
 TRACE_EVENT(powernv_throttle,
 
 	TP_PROTO(int chip_id, const char *reason, int pmax),
@@ -553,6 +553,72 @@ DEFINE_EVENT(sched_stat_runtime, sched_stat_runtime,
 	     TP_PROTO(struct task_struct *tsk, u64 runtime),
 	     TP_ARGS(tsk, runtime));
 
+/*
+ * Tracepoint for EEVDF deadline updates: a task consumed its request
+ * and got a new virtual deadline for its (possibly custom) slice.
+ */
+TRACE_EVENT(sched_update_deadline,
+
+	TP_PROTO(struct task_struct *tsk, u64 slice, u64 vruntime, u64 deadline),
+
+	TP_ARGS(tsk, slice, vruntime, deadline),
+
+	TP_STRUCT__entry(
+		__array( char,	comm,	TASK_COMM_LEN	)
+		__field( pid_t,	pid			)
+		__field( u64,	slice			)
+		__field( u64,	vruntime		)
+		__field( u64,	deadline		)
+	),
+
+	TP_fast_assign(
+		memcpy(__entry->comm, tsk->comm, TASK_COMM_LEN);
+		__entry->pid		= tsk->pid;
+		__entry->slice		= slice;
+		__entry->vruntime	= vruntime;
+		__entry->deadline	= deadline;
+	),
+
+	TP_printk("comm=%s pid=%d slice=%Lu [ns] vruntime=%Lu deadline=%Lu",
+		  __entry->comm, __entry->pid,
+		  (unsigned long long)__entry->slice,
+		  (unsigned long long)__entry->vruntime,
+		  (unsigned long long)__entry->deadline)
+);
+
+/*
+ * Tracepoint for the task selected by pick_eevdf(), with its virtual lag
+ * against the runqueue average and whether it was eligible when picked.
+ */
+TRACE_EVENT(sched_pick_eevdf,
+
+	TP_PROTO(struct task_struct *tsk, s64 vlag, u64 deadline, bool eligible),
+
+	TP_ARGS(tsk, vlag, deadline, eligible),
+
+	TP_STRUCT__entry(
+		__array( char,	comm,	TASK_COMM_LEN	)
+		__field( pid_t,	pid			)
+		__field( s64,	vlag			)
+		__field( u64,	deadline		)
+		__field( bool,	eligible		)
+	),
+
+	TP_fast_assign(
+		memcpy(__entry->comm, tsk->comm, TASK_COMM_LEN);
+		__entry->pid		= tsk->pid;
+		__entry->vlag		= vlag;
+		__entry->deadline	= deadline;
+		__entry->eligible	= eligible;
+	),
+
+	TP_printk("comm=%s pid=%d vlag=%Ld deadline=%Lu eligible=%d",
+		  __entry->comm, __entry->pid,
+		  (long long)__entry->vlag,
+		  (unsigned long long)__entry->deadline,
+		  __entry->eligible)
+);
+
 /*
  * Tracepoint for showing priority inheritance modifying a tasks
  * priority.
@@ -442,6 +442,28 @@ TRACE_EVENT(tick_stop,
 	TP_printk("success=%d dependency=%s",  __entry->success, \
 			show_tick_dep_name(__entry->dependency))
 );
+
+/**
+ * tick_restart - called when a nohz_full CPU restarts its stopped tick
+ * @dependency:	the dependency which requires the tick, NONE if the CPU went
+ *		offline
+ */
+TRACE_EVENT(tick_restart,
+
+	TP_PROTO(int dependency),
+
+	TP_ARGS(dependency),
+
+	TP_STRUCT__entry(
+		__field( int ,		dependency )
+	),
+
+	TP_fast_assign(
+		__entry->dependency	= dependency;
+	),
+
+	TP_printk("dependency=%s", show_tick_dep_name(__entry->dependency))
+);
 #endif
 
 #endif /*  _TRACE_TIMER_H */
@@ -400,6 +400,7 @@ struct pm_scan_arg {
 
 /* /proc/<pid>/maps ioctl */
 #define PROCMAP_QUERY	_IOWR(PROCFS_IOCTL_MAGIC, 17, struct procmap_query)
+#define PROCMAP_MEMSTAT	_IOWR(PROCFS_IOCTL_MAGIC, 18, struct procmap_memstat)
 
 enum procmap_query_flags {
 	/*
@@ -552,4 +553,63 @@ struct procmap_query {
 	__u64 build_id_addr;		/* in */
 };
 
+/*
+ * Fields of struct procmap_memstat, to be used in procmap_memstat.mask.
+ */
+enum procmap_memstat_fields {
+	/* vm_size, vm_peak */
+	PROCMAP_MEMSTAT_VM			= 0x01,
+	/* rss_anon, rss_file, rss_shmem, rss_peak */
+	PROCMAP_MEMSTAT_RSS			= 0x02,
+	/* swap */
+	PROCMAP_MEMSTAT_SWAP			= 0x04,
+	/* locked, pinned */
+	PROCMAP_MEMSTAT_LOCKED			= 0x08,
+	/* data, stack, exec */
+	PROCMAP_MEMSTAT_SEGMENTS		= 0x10,
+	/* pgtables */
+	PROCMAP_MEMSTAT_PGTABLES		= 0x20,
+};
+
+/*
+ * Input/output argument structure passed into PROCMAP_MEMSTAT ioctl() call.
+ * It returns the process-wide memory counters that are also reported as
+ * text in /proc/<pid>/status, in binary form.
+ *
+ * All of the counters are maintained by the kernel as the address space
+ * changes, so the query neither walks page tables nor takes mmap_lock, and
+ * its cost does not depend on the size of the process. Counters are read
+ * without synchronization; like /proc/<pid>/status, a snapshot may be
+ * slightly inconsistent between fields. No proportional (PSS) or per-VMA
+ * values are provided, those still need /proc/<pid>/smaps_rollup.
+ *
+ * All sizes are in bytes.
+ */
+struct procmap_memstat {
+	/* Query struct size, for backwards/forward compatibility */
+	__u64 size;
+	/*
+	 * A combination of enum procmap_memstat_fields values selecting the
+	 * fields to fill. Fields that are not requested are set to zero.
+	 *
+	 * Input and output argument: the kernel clears the bits of fields
+	 * it doesn't know about, so the user can tell which fields were
+	 * actually filled.
+	 */
+	__u64 mask;			/* in/out */
+	__u64 vm_size;			/* out */
+	__u64 vm_peak;			/* out */
+	__u64 rss_anon;			/* out */
+	__u64 rss_file;			/* out */
+	__u64 rss_shmem;		/* out */
+	__u64 rss_peak;			/* out */
+	__u64 swap;			/* out */
+	__u64 locked;			/* out */
+	__u64 pinned;			/* out */
+	__u64 data;			/* out */
+	__u64 stack;			/* out */
+	__u64 exec;			/* out */
+	__u64 pgtables;			/* out */
+};
+
 #endif /* _UAPI_LINUX_FS_H */
@@ -377,6 +377,7 @@ enum {
 	IFLA_GSO_IPV4_MAX_SIZE,
 	IFLA_GRO_IPV4_MAX_SIZE,
 	IFLA_DPLL_PIN,
+	IFLA_DUMP_START_IFINDEX,	/* lowest ifindex in a link dump request */
 	__IFLA_MAX
 };
 
@@ -122,7 +122,11 @@
  *                          parameter is 0; if @flags parameter is
  *                          MEMBARRIER_CMD_FLAG_CPU,
  *                          then this operation is performed only
- *                          on CPU indicated by @cpu_id. If this command is
+ *                          on CPU indicated by @cpu_id; if @flags
+ *                          parameter is MEMBARRIER_CMD_FLAG_CPUMASK,
+ *                          then it is performed only on the CPUs set
+ *                          in the @cpumask of @cpu_id bytes passed as
+ *                          fourth argument. If this command is
  *                          not implemented by an architecture, -EINVAL
  *                          is returned. A process needs to register its
  *                          intent to use the private expedited rseq
@@ -164,6 +168,7 @@ enum membarrier_cmd {
 
 enum membarrier_cmd_flag {
 	MEMBARRIER_CMD_FLAG_CPU		= (1 << 0),
+	MEMBARRIER_CMD_FLAG_CPUMASK	= (1 << 1),
 };
 
 #endif /* _UAPI_LINUX_MEMBARRIER_H */
@@ -121,6 +121,11 @@ enum {
 	NETDEV_A_NAPI_ID,
 	NETDEV_A_NAPI_IRQ,
 	NETDEV_A_NAPI_PID,
+	NETDEV_A_NAPI_GRO_MERGED,
+	NETDEV_A_NAPI_GRO_HELD,
+	NETDEV_A_NAPI_GRO_EVICTED,
+	NETDEV_A_NAPI_IRQ_SUSPENDS,
+	NETDEV_A_NAPI_IRQ_SUSPEND_TIMEOUTS,
 
 	__NETDEV_A_NAPI_MAX,
 	NETDEV_A_NAPI_MAX = (__NETDEV_A_NAPI_MAX - 1)
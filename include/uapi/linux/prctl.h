@@ -328,4 +328,27 @@ struct prctl_mm_map {
 # define PR_PPC_DEXCR_CTRL_CLEAR_ONEXEC	0x10 /* Clear the aspect on exec */
 # define PR_PPC_DEXCR_CTRL_MASK		0x1f
 
+/*
+ * Let NUMA balancing group the calling thread with other tasks that map the
+ * same shared file or memfd, even when they do not share an mm.
+ */
+#define PR_SET_NUMA_SHARED_GROUP	74
+#define PR_GET_NUMA_SHARED_GROUP	75
+
+/*
+ * Number of threads, including the forking one, that copy the page tables of
+ * large anonymous mappings in fork(). 0 or 1 keeps the copy single-threaded.
+ */
+#define PR_SET_FORK_COPY_THREADS	76
+#define PR_GET_FORK_COPY_THREADS	77
+# define PR_FORK_COPY_THREADS_MAX	8
+
+/*
+ * Size of the private futex hash of the process, in buckets. It can only be
+ * set while the process is single-threaded; 0 keeps using the global hash.
+ */
+#define PR_FUTEX_HASH			78
+# define PR_FUTEX_HASH_SET_SLOTS	1
+# define PR_FUTEX_HASH_GET_SLOTS	2
+
 #endif /* _LINUX_PRCTL_H */
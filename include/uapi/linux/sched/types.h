@@ -32,6 +32,8 @@
  *  @sched_policy	task's scheduling policy
  *  @sched_nice		task's nice value      (SCHED_NORMAL/BATCH)
  *  @sched_priority	task's static priority (SCHED_FIFO/RR)
+ *  @sched_runtime	task's request size / slice in ns (SCHED_NORMAL/BATCH),
+ *			0 selects the default base slice
  *
  * Certain more advanced scheduling features can be controlled by a
  * predefined set of flags via the attribute:
@@ -107,7 +109,7 @@ struct sched_attr {
 	/* SCHED_FIFO, SCHED_RR */
 	__u32 sched_priority;
 
-	/* SCHED_DEADLINE */
+	/* SCHED_DEADLINE, SCHED_NORMAL/BATCH slice */
 	__u64 sched_runtime;
 	__u64 sched_deadline;
 	__u64 sched_period;
@@ -302,6 +302,13 @@ enum
 	LINUX_MIB_TCPAOKEYNOTFOUND,		/* TCPAOKeyNotFound */
 	LINUX_MIB_TCPAOGOOD,			/* TCPAOGood */
 	LINUX_MIB_TCPAODROPPEDICMPS,		/* TCPAODroppedIcmps */
+	LINUX_MIB_REUSEPORTSELECTCPU,		/* ReuseportSelectCpu */
+	LINUX_MIB_REUSEPORTSELECTNODE,		/* ReuseportSelectNode */
+	LINUX_MIB_REUSEPORTSELECTREMOTE,	/* ReuseportSelectRemote */
+	LINUX_MIB_TCPZEROCOPYRXPAGES,		/* TCPZeroCopyRxPages */
+	LINUX_MIB_TCPZEROCOPYRXCOPY,		/* TCPZeroCopyRxCopy */
+	LINUX_MIB_TCPZEROCOPYRXZAP,		/* TCPZeroCopyRxZap */
+	LINUX_MIB_TCPACKHELD,			/* TCPAckHeld */
 	__LINUX_MIB_MAX
 };
 
@@ -358,6 +365,9 @@ enum
 	LINUX_MIB_TLSRXDEVICERESYNC,		/* TlsRxDeviceResync */
 	LINUX_MIB_TLSDECRYPTRETRY,		/* TlsDecryptRetry */
 	LINUX_MIB_TLSRXNOPADVIOL,		/* TlsRxNoPadViolation */
+	LINUX_MIB_TLSDECRYPTZC,			/* TlsDecryptZeroCopy */
+	LINUX_MIB_TLSDECRYPTASYNC,		/* TlsDecryptAsync */
+	LINUX_MIB_TLSDECRYPTASYNCWAIT,		/* TlsDecryptAsyncWait */
 	__LINUX_MIB_TLSMAX
 };
 
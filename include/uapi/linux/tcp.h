@@ -137,6 +137,8 @@ enum {
 
 #define TCP_IS_MPTCP		43	/* Is MPTCP being used? */
 
+#define TCP_ACK_HOLD		44	/* Bytes of in-order data per ACK */
+
 #define TCP_REPAIR_ON		1
 #define TCP_REPAIR_OFF		0
 #define TCP_REPAIR_OFF_NO_WP	-1	/* Turn off without window probes */
@@ -63,6 +63,20 @@ struct vhost_vring_worker {
 	unsigned int worker_id;
 };
 
+struct vhost_vring_stats {
+	/* vring index */
+	unsigned int index;
+	unsigned int padding;
+	/* Used ring updates, and the number of entries they added */
+	__u64 used_batches;
+	__u64 used_bufs;
+	/* Guest notifications sent, and those skipped by the guest's
+	 * event index or interrupt suppression flag.
+	 */
+	__u64 signals;
+	__u64 signals_suppressed;
+};
+
 /* no alignment requirement */
 struct vhost_iotlb_msg {
 	__u64 iova;
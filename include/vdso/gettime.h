@@ -14,6 +14,8 @@ int __vdso_clock_gettime(clockid_t clock, struct old_timespec32 *ts);
 #else
 int __vdso_clock_getres(clockid_t clock, struct __kernel_timespec *res);
 int __vdso_clock_gettime(clockid_t clock, struct __kernel_timespec *ts);
+int __vdso_clock_gettime_multi(const clockid_t *clocks,
+			       struct __kernel_timespec *ts, unsigned int nr);
 #endif
 
 __kernel_old_time_t __vdso_time(__kernel_old_time_t *t);
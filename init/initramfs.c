@@ -9,9 +9,11 @@
 #include <linux/string.h>
 #include <linux/dirent.h>
 #include <linux/syscalls.h>
+#include <linux/timekeeping.h>
 #include <linux/utime.h>
 #include <linux/file.h>
 #include <linux/kstrtox.h>
+#include <linux/ktime.h>
 #include <linux/memblock.h>
 #include <linux/mm.h>
 #include <linux/namei.h>
@@ -23,6 +25,13 @@
 static __initdata bool csum_present;
 static __initdata u32 io_csum;
 
+/* What the last unpack_to_rootfs() call created, reported when it is done */
+static __initdata struct {
+	unsigned int	segments;
+	unsigned int	entries;
+	u64		bytes;
+} unpack_stats;
+
 static ssize_t __init xwrite(struct file *file, const unsigned char *p,
 		size_t count, loff_t *pos)
 {
@@ -49,6 +58,7 @@ static ssize_t __init xwrite(struct file *file, const unsigned char *p,
 		p += rv;
 		out += rv;
 		count -= rv;
+		unpack_stats.bytes += rv;
 	}
 
 	return out;
@@ -363,6 +373,7 @@ static int __init do_name(void)
 		free_hash();
 		return 0;
 	}
+	unpack_stats.entries++;
 	clean_path(collected, mode);
 	if (S_ISREG(mode)) {
 		int ml = maybe_link();
@@ -487,6 +498,7 @@ static char * __init unpack_to_rootfs(char *buf, unsigned long len)
 	decompress_fn decompress;
 	const char *compress_name;
 	static __initdata char msg_buf[64];
+	ktime_t start = ktime_get();
 
 	header_buf = kmalloc(110, GFP_KERNEL);
 	symlink_buf = kmalloc(PATH_MAX + N_ALIGN(PATH_MAX) + 1, GFP_KERNEL);
@@ -498,6 +510,7 @@ static char * __init unpack_to_rootfs(char *buf, unsigned long len)
 	state = Start;
 	this_header = 0;
 	message = NULL;
+	memset(&unpack_stats, 0, sizeof(unpack_stats));
 	while (!message && len) {
 		loff_t saved_offset = this_header;
 		if (*buf == '0' && !(this_header & 3)) {
@@ -517,8 +530,11 @@ static char * __init unpack_to_rootfs(char *buf, unsigned long len)
 		decompress = decompress_method(buf, len, &compress_name);
 		pr_debug("Detected %s compressed data\n", compress_name);
 		if (decompress) {
-			int res = decompress(buf, len, NULL, flush_buffer, NULL,
-				   &my_inptr, error);
+			int res;
+
+			unpack_stats.segments++;
+			res = decompress(buf, len, NULL, flush_buffer, NULL,
+					 &my_inptr, error);
 			if (res)
 				error("decompressor failed");
 		} else if (compress_name) {
@@ -540,6 +556,12 @@ static char * __init unpack_to_rootfs(char *buf, unsigned long len)
 	kfree(name_buf);
 	kfree(symlink_buf);
 	kfree(header_buf);
+
+	if (unpack_stats.entries)
+		pr_info("Unpacked %u entries, %llu bytes of file data from %u compressed segments in %lld ms\n",
+			unpack_stats.entries, unpack_stats.bytes,
+			unpack_stats.segments,
+			ktime_ms_delta(ktime_get(), start));
 	return message;
 }
 
@@ -88,6 +88,8 @@ __cold void io_uring_show_fdinfo(struct seq_file *m, struct file *file)
 	seq_printf(m, "CqHead:\t%u\n", cq_head);
 	seq_printf(m, "CqTail:\t%u\n", cq_tail);
 	seq_printf(m, "CachedCqTail:\t%u\n", ctx->cached_cq_tail);
+	seq_printf(m, "CqOverflowed:\t%lu\n", READ_ONCE(ctx->cq_overflowed));
+	seq_printf(m, "CqDropped:\t%u\n", READ_ONCE(r->cq_overflow));
 	seq_printf(m, "SQEs:\t%u\n", sq_tail - sq_head);
 	sq_entries = min(sq_tail - sq_head, ctx->sq_entries);
 	for (i = 0; i < sq_entries; i++) {
@@ -165,6 +167,17 @@ __cold void io_uring_show_fdinfo(struct seq_file *m, struct file *file)
 	seq_printf(m, "SqThreadCpu:\t%d\n", sq_cpu);
 	seq_printf(m, "SqTotalTime:\t%llu\n", sq_total_time);
 	seq_printf(m, "SqWorkTime:\t%llu\n", sq_work_time);
+	seq_printf(m, "IoWqStarted:\t%llu\n",
+		   (u64)atomic64_read(&ctx->iowq_started));
+	seq_printf(m, "IoWqDelayTime:\t%llu\n",
+		   div_u64((u64)atomic64_read(&ctx->iowq_delay) << 10,
+			   NSEC_PER_USEC));
+	seq_printf(m, "IoWqPuntForced:\t%lu\n",
+		   READ_ONCE(ctx->iowq_punts[IO_IOWQ_PUNT_FORCED]));
+	seq_printf(m, "IoWqPuntNoPoll:\t%lu\n",
+		   READ_ONCE(ctx->iowq_punts[IO_IOWQ_PUNT_NOPOLL]));
+	seq_printf(m, "IoWqPuntPollFailed:\t%lu\n",
+		   READ_ONCE(ctx->iowq_punts[IO_IOWQ_PUNT_POLL]));
 	seq_printf(m, "UserFiles:\t%u\n", ctx->nr_user_files);
 	for (i = 0; has_lock && i < ctx->nr_user_files; i++) {
 		struct file *f = io_file_from_index(&ctx->file_table, i);
@@ -379,3 +379,70 @@ int io_futex_wake(struct io_kiocb *req, unsigned int issue_flags)
 	io_req_set_res(req, ret, 0);
 	return IOU_OK;
 }
+
+int io_futexv_wake_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
+{
+	struct io_futex *iof = io_kiocb_to_cmd(req, struct io_futex);
+
+	/* Flags are per futex in the vector, the mask is always match-any */
+	if (unlikely(sqe->fd || sqe->buf_index || sqe->file_index ||
+		     sqe->futex_flags || sqe->addr3))
+		return -EINVAL;
+
+	iof->uwaitv = u64_to_user_ptr(READ_ONCE(sqe->addr));
+	iof->futex_val = READ_ONCE(sqe->addr2);
+	iof->futex_nr = READ_ONCE(sqe->len);
+	if (!iof->futex_nr || iof->futex_nr > FUTEX_WAITV_MAX)
+		return -EINVAL;
+	if (!iof->futex_val || iof->futex_val > INT_MAX)
+		return -EINVAL;
+
+	return 0;
+}
+
+/*
+ * Wake up to futex_val waiters on each futex in the vector, the result is
+ * the total number of waiters woken. Like sys_futex_wake(), the val field
+ * of each entry is ignored. Stops at the first invalid entry.
+ */
+int io_futexv_wake(struct io_kiocb *req, unsigned int issue_flags)
+{
+	struct io_futex *iof = io_kiocb_to_cmd(req, struct io_futex);
+	unsigned int i;
+	int ret = 0, woken = 0;
+
+	for (i = 0; i < iof->futex_nr; i++) {
+		struct futex_waitv aux;
+		unsigned int flags;
+
+		if (copy_from_user(&aux, &iof->uwaitv[i], sizeof(aux))) {
+			ret = -EFAULT;
+			break;
+		}
+		if ((aux.flags & ~FUTEX2_VALID_MASK) || aux.__reserved) {
+			ret = -EINVAL;
+			break;
+		}
+		flags = futex2_to_flags(aux.flags);
+		if (!futex_flags_valid(flags)) {
+			ret = -EINVAL;
+			break;
+		}
+
+		ret = futex_wake(u64_to_user_ptr(aux.uaddr),
+				 FLAGS_STRICT | flags, iof->futex_val,
+				 FUTEX_BITSET_MATCH_ANY);
+		if (ret < 0)
+			break;
+		woken += ret;
+	}
+
+	/* report the wakeups we did, unless nothing was woken */
+	if (ret < 0 && !woken) {
+		req_set_fail(req);
+		io_req_set_res(req, ret, 0);
+	} else {
+		io_req_set_res(req, woken, 0);
+	}
+	return IOU_OK;
+}
@@ -468,6 +468,7 @@ static void io_prep_async_work(struct io_kiocb *req)
 
 	req->work.list.next = NULL;
 	atomic_set(&req->work.flags, 0);
+	req->iowq_queued = 0;
 	if (req->flags & REQ_F_FORCE_ASYNC)
 		atomic_or(IO_WQ_WORK_CONCURRENT, &req->work.flags);
 
@@ -506,6 +507,20 @@ static void io_prep_async_link(struct io_kiocb *req)
 	}
 }
 
+static void io_account_iowq_punt(struct io_kiocb *req)
+{
+	const struct io_issue_def *def = &io_issue_defs[req->opcode];
+	int reason;
+
+	if (req->flags & REQ_F_FORCE_ASYNC)
+		reason = IO_IOWQ_PUNT_FORCED;
+	else if ((!def->pollin && !def->pollout) || !io_file_can_poll(req))
+		reason = IO_IOWQ_PUNT_NOPOLL;
+	else
+		reason = IO_IOWQ_PUNT_POLL;
+	req->ctx->iowq_punts[reason]++;
+}
+
 static void io_queue_iowq(struct io_kiocb *req)
 {
 	struct io_kiocb *link = io_prep_linked_timeout(req);
@@ -513,6 +528,7 @@ static void io_queue_iowq(struct io_kiocb *req)
 
 	BUG_ON(!tctx);
 	BUG_ON(!tctx->io_wq);
+	io_account_iowq_punt(req);
 
 	/* init ->work of the whole link before punting */
 	io_prep_async_link(req);
@@ -528,6 +544,7 @@ static void io_queue_iowq(struct io_kiocb *req)
 		atomic_or(IO_WQ_WORK_CANCEL, &req->work.flags);
 
 	trace_io_uring_queue_async_work(req, io_wq_is_hashed(&req->work));
+	req->iowq_queued = (u32)(ktime_get_ns() >> 10) ?: 1;
 	io_wq_enqueue(tctx->io_wq, &req->work);
 	if (link)
 		io_queue_linked_timeout(link);
@@ -730,6 +747,7 @@ static bool io_cqring_event_overflow(struct io_ring_ctx *ctx, u64 user_data,
 		ocqe->cqe.big_cqe[1] = extra2;
 	}
 	list_add_tail(&ocqe->list, &ctx->cq_overflow_list);
+	ctx->cq_overflowed++;
 	return true;
 }
 
@@ -1769,6 +1787,14 @@ void io_wq_submit_work(struct io_wq_work *work)
 	else
 		req_ref_get(req);
 
+	if (req->iowq_queued) {
+		u32 delay = (u32)(ktime_get_ns() >> 10) - req->iowq_queued;
+
+		atomic64_inc(&req->ctx->iowq_started);
+		atomic64_add(delay, &req->ctx->iowq_delay);
+		req->iowq_queued = 0;
+	}
+
 	io_arm_ltimeout(req);
 
 	/* either cancelled or io-wq is dying, so don't touch tctx->iowq */
@@ -2354,6 +2380,7 @@ static bool current_pending_io(void)
 static inline int io_cqring_wait_schedule(struct io_ring_ctx *ctx,
 					  struct io_wait_queue *iowq)
 {
+	ktime_t timeout;
 	int ret;
 
 	if (unlikely(READ_ONCE(ctx->check_cq)))
@@ -2374,10 +2401,11 @@ static inline int io_cqring_wait_schedule(struct io_ring_ctx *ctx,
 	 */
 	if (current_pending_io())
 		current->in_iowait = 1;
+	timeout = min(iowq->timeout, iowq->min_timeout);
 	ret = 0;
-	if (iowq->timeout == KTIME_MAX)
+	if (timeout == KTIME_MAX)
 		schedule();
-	else if (!schedule_hrtimeout(&iowq->timeout, HRTIMER_MODE_ABS))
+	else if (!schedule_hrtimeout(&timeout, HRTIMER_MODE_ABS))
 		ret = -ETIME;
 	current->in_iowait = 0;
 	return ret;
@@ -2388,11 +2416,13 @@ static inline int io_cqring_wait_schedule(struct io_ring_ctx *ctx,
  * application must reap them itself, as they reside on the shared cq ring.
  */
 static int io_cqring_wait(struct io_ring_ctx *ctx, int min_events,
+			  u32 min_wait_usec,
 			  const sigset_t __user *sig, size_t sigsz,
 			  struct __kernel_timespec __user *uts)
 {
 	struct io_wait_queue iowq;
 	struct io_rings *rings = ctx->rings;
+	ktime_t start_time;
 	int ret;
 
 	if (!io_allowed_run_tw(ctx))
@@ -2413,6 +2443,8 @@ static int io_cqring_wait(struct io_ring_ctx *ctx, int min_events,
 	iowq.nr_timeouts = atomic_read(&ctx->cq_timeouts);
 	iowq.cq_tail = READ_ONCE(ctx->rings->cq.head) + min_events;
 	iowq.timeout = KTIME_MAX;
+	iowq.min_timeout = KTIME_MAX;
+	start_time = ktime_get();
 
 	if (uts) {
 		struct timespec64 ts;
@@ -2422,10 +2454,18 @@ static int io_cqring_wait(struct io_ring_ctx *ctx, int min_events,
 			return -EFAULT;
 
 		dt = timespec64_to_ktime(ts);
-		iowq.timeout = ktime_add(dt, ktime_get());
+		iowq.timeout = ktime_add(dt, start_time);
 		io_napi_adjust_timeout(ctx, &iowq, dt);
 	}
 
+	/* only useful if it expires before the overall timeout */
+	if (min_wait_usec) {
+		ktime_t min_timeout = ktime_add_us(start_time, min_wait_usec);
+
+		if (ktime_before(min_timeout, iowq.timeout))
+			iowq.min_timeout = min_timeout;
+	}
+
 	if (sig) {
 #ifdef CONFIG_COMPAT
 		if (in_compat_syscall())
@@ -2467,6 +2507,21 @@ static int io_cqring_wait(struct io_ring_ctx *ctx, int min_events,
 		if (!llist_empty(&ctx->work_llist))
 			io_run_local_work(ctx, nr_wait);
 
+		/*
+		 * The min wait expired before min_events were posted. Return
+		 * if there are any events at all, otherwise keep waiting for
+		 * the first one until the overall timeout.
+		 */
+		if (ret == -ETIME && iowq.min_timeout != KTIME_MAX) {
+			iowq.min_timeout = KTIME_MAX;
+			if (READ_ONCE(rings->cq.head) != READ_ONCE(rings->cq.tail)) {
+				ret = 0;
+				break;
+			}
+			iowq.cq_tail = READ_ONCE(rings->cq.head) + 1;
+			ret = 0;
+		}
+
 		/*
 		 * Non-local task_work will be run on exit to userspace, but
 		 * if we're using DEFER_TASKRUN, then we could have waited
@@ -3114,7 +3169,7 @@ static int io_validate_ext_arg(unsigned flags, const void __user *argp, size_t a
 
 static int io_get_ext_arg(unsigned flags, const void __user *argp, size_t *argsz,
 			  struct __kernel_timespec __user **ts,
-			  const sigset_t __user **sig)
+			  const sigset_t __user **sig, u32 *min_wait_usec)
 {
 	struct io_uring_getevents_arg arg;
 
@@ -3125,6 +3180,7 @@ static int io_get_ext_arg(unsigned flags, const void __user *argp, size_t *argsz
 	if (!(flags & IORING_ENTER_EXT_ARG)) {
 		*sig = (const sigset_t __user *) argp;
 		*ts = NULL;
+		*min_wait_usec = 0;
 		return 0;
 	}
 
@@ -3136,8 +3192,7 @@ static int io_get_ext_arg(unsigned flags, const void __user *argp, size_t *argsz
 		return -EINVAL;
 	if (copy_from_user(&arg, argp, sizeof(arg)))
 		return -EFAULT;
-	if (arg.pad)
-		return -EINVAL;
+	*min_wait_usec = arg.min_wait_usec;
 	*sig = u64_to_user_ptr(arg.sigmask);
 	*argsz = arg.sigmask_sz;
 	*ts = u64_to_user_ptr(arg.ts);
@@ -3247,12 +3302,15 @@ SYSCALL_DEFINE6(io_uring_enter, unsigned int, fd, u32, to_submit,
 		} else {
 			const sigset_t __user *sig;
 			struct __kernel_timespec __user *ts;
+			u32 min_wait_usec;
 
-			ret2 = io_get_ext_arg(flags, argp, &argsz, &ts, &sig);
+			ret2 = io_get_ext_arg(flags, argp, &argsz, &ts, &sig,
+					      &min_wait_usec);
 			if (likely(!ret2)) {
 				min_complete = min(min_complete,
 						   ctx->cq_entries);
-				ret2 = io_cqring_wait(ctx, min_complete, sig,
+				ret2 = io_cqring_wait(ctx, min_complete,
+						      min_wait_usec, sig,
 						      argsz, ts);
 			}
 		}
@@ -3391,6 +3449,11 @@ static __cold int io_uring_create(unsigned entries, struct io_uring_params *p,
 	    && !(p->flags & IORING_SETUP_NO_MMAP))
 		return -EINVAL;
 
+	/* HYBRID_IOPOLL only valid with iopoll enabled */
+	if ((p->flags & (IORING_SETUP_IOPOLL|IORING_SETUP_HYBRID_IOPOLL)) ==
+			IORING_SETUP_HYBRID_IOPOLL)
+		return -EINVAL;
+
 	/*
 	 * Use twice as many entries for the CQ ring. It's possible for the
 	 * application to drive a higher depth than the size of the SQ ring,
@@ -3424,6 +3487,9 @@ static __cold int io_uring_create(unsigned entries, struct io_uring_params *p,
 	if (!ctx)
 		return -ENOMEM;
 
+	if (ctx->flags & IORING_SETUP_HYBRID_IOPOLL)
+		ctx->hybrid_poll_time = LLONG_MAX;
+
 	if ((ctx->flags & IORING_SETUP_DEFER_TASKRUN) &&
 	    !(ctx->flags & IORING_SETUP_IOPOLL) &&
 	    !(ctx->flags & IORING_SETUP_SQPOLL))
@@ -3535,7 +3601,7 @@ static __cold int io_uring_create(unsigned entries, struct io_uring_params *p,
 			IORING_FEAT_EXT_ARG | IORING_FEAT_NATIVE_WORKERS |
 			IORING_FEAT_RSRC_TAGS | IORING_FEAT_CQE_SKIP |
 			IORING_FEAT_LINKED_FILE | IORING_FEAT_REG_REG_RING |
-			IORING_FEAT_RECVSEND_BUNDLE;
+			IORING_FEAT_RECVSEND_BUNDLE | IORING_FEAT_MIN_TIMEOUT;
 
 	if (copy_to_user(params, p, sizeof(*p))) {
 		ret = -EFAULT;
@@ -3603,7 +3669,7 @@ static long io_uring_setup(u32 entries, struct io_uring_params __user *params)
 			IORING_SETUP_SQE128 | IORING_SETUP_CQE32 |
 			IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN |
 			IORING_SETUP_NO_MMAP | IORING_SETUP_REGISTERED_FD_ONLY |
-			IORING_SETUP_NO_SQARRAY))
+			IORING_SETUP_NO_SQARRAY | IORING_SETUP_HYBRID_IOPOLL))
 		return -EINVAL;
 
 	return io_uring_create(entries, &p, params);
@@ -251,16 +251,27 @@ static int io_ring_buffers_peek(struct io_kiocb *req, struct buf_sel_arg *arg,
 
 	req->buf_index = buf->bid;
 	do {
-		/* truncate end piece, if needed */
-		if (buf->len > arg->max_len)
-			buf->len = arg->max_len;
+		u32 len = buf->len;
+
+		/*
+		 * truncate end piece, if needed. With KBUF_MODE_WHOLE, leave it
+		 * for the next selection, but always map at least one buffer.
+		 */
+		if (len > arg->max_len) {
+			if (!(arg->mode & KBUF_MODE_WHOLE)) {
+				len = arg->max_len;
+				buf->len = len;
+			} else if (iov != arg->iovs) {
+				break;
+			}
+		}
 
 		iov->iov_base = u64_to_user_ptr(buf->addr);
-		iov->iov_len = buf->len;
+		iov->iov_len = len;
 		iov++;
 
-		arg->out_len += buf->len;
-		arg->max_len -= buf->len;
+		arg->out_len += len;
+		arg->max_len -= min_t(size_t, len, arg->max_len);
 		if (!arg->max_len)
 			break;
 
@@ -46,6 +46,8 @@ enum {
 	KBUF_MODE_EXPAND	= 1,
 	/* if bigger vec allocated, free old one */
 	KBUF_MODE_FREE		= 2,
+	/* don't truncate the end piece to max_len, stop before it instead */
+	KBUF_MODE_WHOLE		= 4,
 };
 
 struct buf_sel_arg {
@@ -157,6 +157,18 @@ static bool __io_napi_do_busy_loop(struct io_ring_ctx *ctx,
 	return is_stale;
 }
 
+static void io_napi_update_irqs(struct io_ring_ctx *ctx, bool suspend)
+{
+	struct io_napi_entry *e;
+
+	list_for_each_entry_rcu(e, &ctx->napi_list, list) {
+		if (suspend)
+			napi_suspend_irqs(e->napi_id);
+		else
+			napi_resume_irqs(e->napi_id);
+	}
+}
+
 static void io_napi_blocking_busy_loop(struct io_ring_ctx *ctx,
 				       struct io_wait_queue *iowq)
 {
@@ -174,6 +186,11 @@ static void io_napi_blocking_busy_loop(struct io_ring_ctx *ctx,
 	do {
 		is_stale = __io_napi_do_busy_loop(ctx, loop_end_arg);
 	} while (!io_napi_busy_loop_should_end(iowq, start_time) && !loop_end_arg);
+
+	/* Keep IRQs suspended while completions keep coming, re-arm once idle */
+	if (iowq->napi_prefer_busy_poll)
+		io_napi_update_irqs(ctx, io_should_wake(iowq) ||
+					 io_has_work(ctx));
 	rcu_read_unlock();
 
 	io_napi_remove_stale(ctx, is_stale);
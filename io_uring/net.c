@@ -71,7 +71,12 @@ struct io_sr_msg {
 	int				len;
 	unsigned			done_io;
 	unsigned			msg_flags;
-	unsigned			nr_multishot_loops;
+	union {
+		/* recv multishot */
+		unsigned		nr_multishot_loops;
+		/* send bundle, byte limit per bundle or 0 */
+		unsigned		bundle_len;
+	};
 	u16				flags;
 	/* initialised and used only by !msg send variants */
 	u16				addr_len;
@@ -433,6 +438,11 @@ int io_sendmsg_prep(struct io_kiocb *req, const struct io_uring_sqe *sqe)
 		sr->msg_flags |= MSG_WAITALL;
 		sr->buf_group = req->buf_index;
 		req->buf_list = NULL;
+		/* for a bundle, len limits how much each send may pick up */
+		if (sr->len < 0)
+			return -EINVAL;
+		sr->bundle_len = sr->len;
+		sr->len = 0;
 	}
 	if (req->flags & REQ_F_BUFFER_SELECT && sr->len)
 		return -EINVAL;
@@ -609,10 +619,16 @@ int io_send(struct io_kiocb *req, unsigned int issue_flags)
 			arg.mode = KBUF_MODE_FREE;
 		}
 
-		if (!(sr->flags & IORING_RECVSEND_BUNDLE))
+		if (!(sr->flags & IORING_RECVSEND_BUNDLE)) {
 			arg.nr_iovs = 1;
-		else
+		} else {
 			arg.mode |= KBUF_MODE_EXPAND;
+			/* never split a buffer to stay under the limit */
+			if (sr->bundle_len) {
+				arg.max_len = sr->bundle_len;
+				arg.mode |= KBUF_MODE_WHOLE;
+			}
+		}
 
 		ret = io_buffers_select(req, &arg, issue_flags);
 		if (unlikely(ret < 0))
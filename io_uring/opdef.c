@@ -513,6 +513,14 @@ const struct io_issue_def io_issue_defs[] = {
 		.async_size		= sizeof(struct io_async_msghdr),
 #else
 		.prep			= io_eopnotsupp_prep,
+#endif
+	},
+	[IORING_OP_FUTEX_WAKEV] = {
+#if defined(CONFIG_FUTEX)
+		.prep			= io_futexv_wake_prep,
+		.issue			= io_futexv_wake,
+#else
+		.prep			= io_eopnotsupp_prep,
 #endif
 	},
 };
@@ -742,6 +750,9 @@ const struct io_cold_def io_cold_defs[] = {
 	[IORING_OP_LISTEN] = {
 		.name			= "LISTEN",
 	},
+	[IORING_OP_FUTEX_WAKEV] = {
+		.name			= "FUTEX_WAKEV",
+	},
 };
 
 const char *io_uring_get_opcode(u8 opcode)
@@ -855,16 +855,72 @@ static int io_buffer_account_pin(struct io_ring_ctx *ctx, struct page **pages,
 	return ret;
 }
 
+/*
+ * Check if the pinned pages consist of physically contiguous runs over
+ * folios of the same size, where the first folio is mapped up to its end,
+ * the last one from its start and all others in full. If so, keep only the
+ * first page of each folio so every folio becomes a single bvec entry.
+ * io_import_fixed() relies on all but the first and last bvec being
+ * exactly one folio in size.
+ */
+static bool io_coalesce_buffer(struct page **pages, int *nr_pages,
+			       unsigned int *folio_shift)
+{
+	struct folio *folio = page_folio(pages[0]);
+	unsigned int shift = folio_shift(folio);
+	int i, nr_folios = 1;
+
+	if (shift == PAGE_SHIFT)
+		return false;
+
+	for (i = 1; i < *nr_pages; i++) {
+		/* pages must be consecutive within a folio */
+		if (page_folio(pages[i]) == folio) {
+			if (pages[i] != pages[i - 1] + 1)
+				return false;
+			continue;
+		}
+		/* the previous folio must be mapped up to its end ... */
+		if (folio_page_idx(folio, pages[i - 1]) !=
+		    folio_nr_pages(folio) - 1)
+			return false;
+		/* ... and the next one from its start, with the same size */
+		folio = page_folio(pages[i]);
+		if (folio_shift(folio) != shift ||
+		    folio_page_idx(folio, pages[i]) != 0)
+			return false;
+		nr_folios++;
+	}
+
+	/*
+	 * The pages are bound to the folio, it doesn't actually unpin them
+	 * but drops all but one reference per folio, which is usually put
+	 * down by io_buffer_unmap().
+	 */
+	nr_folios = 1;
+	for (i = 1; i < *nr_pages; i++) {
+		if (page_folio(pages[i]) == page_folio(pages[nr_folios - 1]))
+			unpin_user_page(pages[i]);
+		else
+			pages[nr_folios++] = pages[i];
+	}
+
+	*nr_pages = nr_folios;
+	*folio_shift = shift;
+	return true;
+}
+
 static int io_sqe_buffer_register(struct io_ring_ctx *ctx, struct iovec *iov,
 				  struct io_mapped_ubuf **pimu,
 				  struct page **last_hpage)
 {
 	struct io_mapped_ubuf *imu = NULL;
 	struct page **pages = NULL;
+	unsigned int folio_shift = PAGE_SHIFT;
+	bool coalesced = false;
 	unsigned long off;
 	size_t size;
 	int ret, nr_pages, i;
-	struct folio *folio = NULL;
 
 	*pimu = (struct io_mapped_ubuf *)&dummy_ubuf;
 	if (!iov->iov_base)
@@ -879,31 +935,9 @@ static int io_sqe_buffer_register(struct io_ring_ctx *ctx, struct iovec *iov,
 		goto done;
 	}
 
-	/* If it's a huge page, try to coalesce them into a single bvec entry */
-	if (nr_pages > 1) {
-		folio = page_folio(pages[0]);
-		for (i = 1; i < nr_pages; i++) {
-			/*
-			 * Pages must be consecutive and on the same folio for
-			 * this to work
-			 */
-			if (page_folio(pages[i]) != folio ||
-			    pages[i] != pages[i - 1] + 1) {
-				folio = NULL;
-				break;
-			}
-		}
-		if (folio) {
-			/*
-			 * The pages are bound to the folio, it doesn't
-			 * actually unpin them but drops all but one reference,
-			 * which is usually put down by io_buffer_unmap().
-			 * Note, needs a better helper.
-			 */
-			unpin_user_pages(&pages[1], nr_pages - 1);
-			nr_pages = 1;
-		}
-	}
+	/* If it's backed by huge pages, try to use one bvec entry per folio */
+	if (nr_pages > 1)
+		coalesced = io_coalesce_buffer(pages, &nr_pages, &folio_shift);
 
 	imu = kvmalloc(struct_size(imu, bvec, nr_pages), GFP_KERNEL);
 	if (!imu)
@@ -921,17 +955,18 @@ static int io_sqe_buffer_register(struct io_ring_ctx *ctx, struct iovec *iov,
 	imu->ubuf = (unsigned long) iov->iov_base;
 	imu->ubuf_end = imu->ubuf + iov->iov_len;
 	imu->nr_bvecs = nr_pages;
+	imu->folio_shift = folio_shift;
 	*pimu = imu;
 	ret = 0;
 
-	if (folio) {
-		bvec_set_page(&imu->bvec[0], pages[0], size, off);
-		goto done;
-	}
 	for (i = 0; i < nr_pages; i++) {
-		size_t vec_len;
+		size_t vec_len, seg_len = 1UL << folio_shift;
 
-		vec_len = min_t(size_t, size, PAGE_SIZE - off);
+		/* the first folio may be mapped from somewhere in the middle */
+		if (!i && coalesced)
+			seg_len -= folio_page_idx(page_folio(pages[0]), pages[0])
+					<< PAGE_SHIFT;
+		vec_len = min_t(size_t, size, seg_len - off);
 		bvec_set_page(&imu->bvec[i], pages[i], vec_len, off);
 		off = 0;
 		size -= vec_len;
@@ -1042,8 +1077,9 @@ int io_import_fixed(int ddir, struct iov_iter *iter,
 		 * we know that:
 		 *
 		 * 1) it's a BVEC iter, we set it up
-		 * 2) all bvecs are PAGE_SIZE in size, except potentially the
-		 *    first and last bvec
+		 * 2) all bvecs are the same size (PAGE_SIZE, or a folio size if
+		 *    the buffer was coalesced), except potentially the first
+		 *    and last bvec
 		 *
 		 * So just find our index, and adjust the iterator afterwards.
 		 * If the offset is within the first bvec (or the whole first
@@ -1054,11 +1090,6 @@ int io_import_fixed(int ddir, struct iov_iter *iter,
 		const struct bio_vec *bvec = imu->bvec;
 
 		if (offset < bvec->bv_len) {
-			/*
-			 * Note, huge pages buffers consists of one large
-			 * bvec entry and should always go this way. The other
-			 * branch doesn't expect non PAGE_SIZE'd chunks.
-			 */
 			iter->bvec = bvec;
 			iter->count -= offset;
 			iter->iov_offset = offset;
@@ -1067,12 +1098,12 @@ int io_import_fixed(int ddir, struct iov_iter *iter,
 
 			/* skip first vec */
 			offset -= bvec->bv_len;
-			seg_skip = 1 + (offset >> PAGE_SHIFT);
+			seg_skip = 1 + (offset >> imu->folio_shift);
 
 			iter->bvec = bvec + seg_skip;
 			iter->nr_segs -= seg_skip;
 			iter->count -= bvec->bv_len + offset;
-			iter->iov_offset = offset & ~PAGE_MASK;
+			iter->iov_offset = offset & ((1UL << imu->folio_shift) - 1);
 		}
 	}
 
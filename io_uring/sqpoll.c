@@ -319,6 +319,12 @@ static int io_sq_thread(void *data)
 			if (!sqt_spin && (ret > 0 || !wq_list_empty(&ctx->iopoll_list)))
 				sqt_spin = true;
 		}
+		/*
+		 * Rotate the rings so the one served first changes every pass,
+		 * otherwise the head of the list always gets the lowest latency.
+		 */
+		if (cap_entries)
+			list_rotate_left(&sqd->ctx_list);
 		if (io_sq_tw(&retry_list, IORING_TW_CAP_ENTRIES_VALUE))
 			sqt_spin = true;
 
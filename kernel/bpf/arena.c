@@ -48,6 +48,8 @@ struct bpf_arena {
 	struct maple_tree mt;
 	struct list_head vma_list;
 	struct mutex lock;
+	/* number of pages currently allocated, protected by lock */
+	unsigned long nr_pages;
 };
 
 u64 bpf_arena_get_kern_vm_start(struct bpf_arena *arena)
@@ -206,7 +208,9 @@ static int arena_map_check_btf(const struct bpf_map *map, const struct btf *btf,
 
 static u64 arena_map_mem_usage(const struct bpf_map *map)
 {
-	return 0;
+	struct bpf_arena *arena = container_of(map, struct bpf_arena, map);
+
+	return sizeof(*arena) + ((u64)READ_ONCE(arena->nr_pages) << PAGE_SHIFT);
 }
 
 struct vma_list {
@@ -291,6 +295,7 @@ static vm_fault_t arena_vm_fault(struct vm_fault *vmf)
 		__free_page(page);
 		return VM_FAULT_SIGSEGV;
 	}
+	WRITE_ONCE(arena->nr_pages, arena->nr_pages + 1);
 out:
 	page_ref_add(page, 1);
 	vmf->page = page;
@@ -473,6 +478,7 @@ static long arena_alloc_pages(struct bpf_arena *arena, long uaddr, long page_cnt
 			__free_page(pages[i]);
 		goto out;
 	}
+	WRITE_ONCE(arena->nr_pages, arena->nr_pages + page_cnt);
 	kvfree(pages);
 	return clear_lo32(arena->user_vm_start) + uaddr32;
 out:
@@ -536,6 +542,7 @@ static void arena_free_pages(struct bpf_arena *arena, long uaddr, long page_cnt)
 			zap_pages(arena, full_uaddr, 1);
 		vm_area_unmap_pages(arena->kern_vm, kaddr, kaddr + PAGE_SIZE);
 		__free_page(page);
+		WRITE_ONCE(arena->nr_pages, arena->nr_pages - 1);
 	}
 }
 
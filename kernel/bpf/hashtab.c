@@ -2261,6 +2261,109 @@ static u64 htab_map_mem_usage(const struct bpf_map *map)
 	return usage;
 }
 
+/* Longest key batch bpf_map_lookup_elems() accepts */
+#define HTAB_LOOKUP_ELEMS_MAX	64
+
+__bpf_kfunc_start_defs();
+
+/**
+ * bpf_map_lookup_elems() - Look up several keys in a hash map
+ * @p__map: BPF_MAP_TYPE_HASH or BPF_MAP_TYPE_LRU_HASH map
+ * @keys: Array of keys, each of the map's key size
+ * @keys__sz: Size of @keys in bytes, a multiple of the key size
+ * @values: Buffer receiving a copy of the value of each key
+ * @values__sz: Size of @values in bytes, at least one value per key
+ *
+ * The keys are hashed and their buckets and first elements prefetched
+ * before any chain is walked, so that the cache misses of the individual
+ * lookups overlap instead of being taken one after the other. The value
+ * slot of a key that is not in the map is zeroed. Maps with special fields
+ * (spin locks, timers, kptrs...) in their values are not supported.
+ *
+ * Return: The number of keys found, -EINVAL for an unsupported map or
+ * inconsistent sizes, -E2BIG for more than 64 keys.
+ */
+__bpf_kfunc int bpf_map_lookup_elems(void *p__map, const void *keys, u32 keys__sz,
+				     void *values, u32 values__sz)
+{
+	struct bpf_map *map = p__map;
+	struct bpf_htab *htab = container_of(map, struct bpf_htab, map);
+	u32 key_size = map->key_size, value_size = map->value_size;
+	u32 hashes[HTAB_LOOKUP_ELEMS_MAX];
+	struct hlist_nulls_head *head;
+	struct htab_elem *l;
+	int i, nr, found = 0;
+
+	if (map->map_type != BPF_MAP_TYPE_HASH &&
+	    map->map_type != BPF_MAP_TYPE_LRU_HASH)
+		return -EINVAL;
+	if (!IS_ERR_OR_NULL(map->record))
+		return -EINVAL;
+	if (keys__sz % key_size)
+		return -EINVAL;
+
+	nr = keys__sz / key_size;
+	if (nr > HTAB_LOOKUP_ELEMS_MAX)
+		return -E2BIG;
+	if (values__sz < nr * value_size)
+		return -EINVAL;
+
+	WARN_ON_ONCE(!rcu_read_lock_held() && !rcu_read_lock_trace_held() &&
+		     !rcu_read_lock_bh_held());
+
+	for (i = 0; i < nr; i++) {
+		hashes[i] = htab_map_hash(keys + i * key_size, key_size,
+					  htab->hashrnd);
+		prefetch(select_bucket(htab, hashes[i]));
+	}
+
+	for (i = 0; i < nr; i++) {
+		struct hlist_nulls_node *first;
+
+		head = select_bucket(htab, hashes[i]);
+		first = rcu_dereference_raw(hlist_nulls_first_rcu(head));
+		if (!is_a_nulls(first))
+			prefetch(first);
+	}
+
+	for (i = 0; i < nr; i++) {
+		void *value = values + i * value_size;
+
+		head = select_bucket(htab, hashes[i]);
+		l = lookup_nulls_elem_raw(head, hashes[i],
+					  (void *)keys + i * key_size,
+					  key_size, htab->n_buckets);
+		if (!l) {
+			memset(value, 0, value_size);
+			continue;
+		}
+
+		if (htab_is_lru(htab))
+			bpf_lru_node_set_ref(&l->lru_node);
+		copy_map_value(map, value, l->key + round_up(key_size, 8));
+		found++;
+	}
+
+	return found;
+}
+
+__bpf_kfunc_end_defs();
+
+BTF_KFUNCS_START(htab_kfunc_ids)
+BTF_ID_FLAGS(func, bpf_map_lookup_elems)
+BTF_KFUNCS_END(htab_kfunc_ids)
+
+static const struct btf_kfunc_id_set htab_kfunc_set = {
+	.owner = THIS_MODULE,
+	.set   = &htab_kfunc_ids,
+};
+
+static int __init htab_kfunc_init(void)
+{
+	return register_btf_kfunc_id_set(BPF_PROG_TYPE_UNSPEC, &htab_kfunc_set);
+}
+late_initcall(htab_kfunc_init);
+
 BTF_ID_LIST_SINGLE(htab_map_btf_ids, struct, bpf_htab)
 const struct bpf_map_ops htab_map_ops = {
 	.map_meta_equal = bpf_map_meta_equal,
@@ -9,6 +9,7 @@
 #include <linux/bpf.h>
 #include <linux/btf.h>
 #include <linux/err.h>
+#include <linux/prefetch.h>
 #include <linux/slab.h>
 #include <linux/spinlock.h>
 #include <linux/vmalloc.h>
@@ -249,6 +250,17 @@ static void *trie_lookup_elem(struct bpf_map *map, void *_key)
 		unsigned int next_bit;
 		size_t matchlen;
 
+		/* Every level of the trie is a dependent cache miss. The child
+		 * we descend into if @node matches only depends on the key bit
+		 * following the node's prefix, so start fetching it before
+		 * comparing the prefix. The child pointers share the cacheline
+		 * of the node header.
+		 */
+		if (node->prefixlen < trie->max_prefixlen) {
+			next_bit = extract_bit(key->data, node->prefixlen);
+			prefetch(rcu_access_pointer(node->child[next_bit]));
+		}
+
 		/* Determine the longest prefix of @node that matches @key.
 		 * If it's the maximum possible prefix for this trie, we have
 		 * an exact match and can return it directly.
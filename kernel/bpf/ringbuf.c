@@ -420,6 +420,15 @@ static void *__bpf_ringbuf_reserve(struct bpf_ringbuf *rb, u64 size)
 
 	cons_pos = smp_load_acquire(&rb->consumer_pos);
 
+	/* If the ring is already full as far as the consumer is concerned,
+	 * fail without touching the lock. When the consumer falls behind,
+	 * producers on all CPUs would otherwise still serialize on the lock
+	 * only to find that out. producer_pos only moves forward, so the
+	 * check below under the lock would fail as well.
+	 */
+	if (READ_ONCE(rb->producer_pos) + len - cons_pos > rb->mask)
+		return NULL;
+
 	if (in_nmi()) {
 		if (!spin_trylock_irqsave(&rb->spinlock, flags))
 			return NULL;
@@ -2373,7 +2373,10 @@ static void bpf_prog_show_fdinfo(struct seq_file *m, struct file *filp)
 		   "run_time_ns:\t%llu\n"
 		   "run_cnt:\t%llu\n"
 		   "recursion_misses:\t%llu\n"
-		   "verified_insns:\t%u\n",
+		   "verified_insns:\t%u\n"
+		   "verified_states:\t%u\n"
+		   "verified_pruned_states:\t%u\n"
+		   "verification_time_ns:\t%llu\n",
 		   prog->type,
 		   prog->jited,
 		   prog_tag,
@@ -2382,7 +2385,10 @@ static void bpf_prog_show_fdinfo(struct seq_file *m, struct file *filp)
 		   stats.nsecs,
 		   stats.cnt,
 		   stats.misses,
-		   prog->aux->verified_insns);
+		   prog->aux->verified_insns,
+		   prog->aux->verified_states,
+		   prog->aux->verified_pruned_states,
+		   prog->aux->verification_time);
 }
 #endif
 
@@ -4639,6 +4645,10 @@ static int bpf_prog_get_info_by_fd(struct file *file,
 	info.recursion_misses = stats.misses;
 
 	info.verified_insns = prog->aux->verified_insns;
+	info.verified_states = prog->aux->verified_states;
+	info.verified_pruned_states = prog->aux->verified_pruned_states;
+	info.verified_peak_states = prog->aux->verified_peak_states;
+	info.verification_time_ns = prog->aux->verification_time;
 
 	if (!bpf_capable()) {
 		info.jited_prog_len = 0;
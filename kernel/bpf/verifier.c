@@ -17546,6 +17546,7 @@ static int is_state_visited(struct bpf_verifier_env *env, int insn_idx)
 				update_loop_entry(cur, loop_entry);
 hit:
 			sl->hit_cnt++;
+			env->pruned_states++;
 			/* reached equivalent register/stack state,
 			 * prune the search.
 			 * Registers read by the continuation are read by us.
@@ -21728,6 +21729,10 @@ int bpf_check(struct bpf_prog **prog, union bpf_attr *attr, bpfptr_t uattr, __u3
 	env->verification_time = ktime_get_ns() - start_time;
 	print_verification_stats(env);
 	env->prog->aux->verified_insns = env->insn_processed;
+	env->prog->aux->verified_states = env->total_states;
+	env->prog->aux->verified_pruned_states = env->pruned_states;
+	env->prog->aux->verified_peak_states = env->peak_states;
+	env->prog->aux->verification_time = env->verification_time;
 
 	/* preserve original error even if log finalization is successful */
 	err = bpf_vlog_finalize(&env->log, &log_true_size);
@@ -303,7 +303,8 @@ static inline void __cgroup_rstat_unlock(struct cgroup *cgrp, int cpu_in_loop)
 static void cgroup_rstat_flush_locked(struct cgroup *cgrp)
 	__releases(&cgroup_rstat_lock) __acquires(&cgroup_rstat_lock)
 {
-	int cpu;
+	u64 start = ktime_get_ns();
+	int cpu, nr_yields = 0;
 
 	lockdep_assert_held(&cgroup_rstat_lock);
 
@@ -329,8 +330,38 @@ static void cgroup_rstat_flush_locked(struct cgroup *cgrp)
 			if (!cond_resched())
 				cpu_relax();
 			__cgroup_rstat_lock(cgrp, cpu);
+			nr_yields++;
 		}
 	}
+
+	/* updates made after @start may not have been flushed */
+	WRITE_ONCE(cgrp->rstat_flush_time, start);
+	trace_cgroup_rstat_flush(cgrp, ktime_get_ns() - start, nr_yields);
+}
+
+/**
+ * cgroup_rstat_flushed_within - check how old the stats of a cgroup are
+ * @cgrp: target cgroup
+ * @max_age_ns: staleness the caller can live with
+ *
+ * Returns %true if @cgrp's subtree, or that of one of its ancestors, was
+ * flushed within the last @max_age_ns nanoseconds.  Readers that can use
+ * slightly stale stats call this to skip cgroup_rstat_flush() and its
+ * global lock.
+ */
+bool cgroup_rstat_flushed_within(struct cgroup *cgrp, u64 max_age_ns)
+{
+	u64 now = ktime_get_ns();
+
+	if (!max_age_ns)
+		return false;
+
+	for (; cgrp; cgrp = cgroup_parent(cgrp)) {
+		if (now - READ_ONCE(cgrp->rstat_flush_time) <= max_age_ns)
+			return true;
+	}
+
+	return false;
 }
 
 /**
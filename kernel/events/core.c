@@ -8680,6 +8680,36 @@ struct perf_mmap_event {
 	} event_id;
 };
 
+/* PERF_RECORD_MMAP{,2} records written and lost for lack of buffer space */
+struct perf_mmap_records {
+	unsigned long	emitted;
+	unsigned long	dropped;
+};
+
+static DEFINE_PER_CPU(struct perf_mmap_records, perf_mmap_records);
+
+int perf_event_mmap_records_handler(const struct ctl_table *table, int write,
+				    void *buffer, size_t *lenp, loff_t *ppos)
+{
+	unsigned long records[2] = { };
+	struct ctl_table t = *table;
+	int cpu;
+
+	if (write)
+		return -EPERM;
+
+	for_each_possible_cpu(cpu) {
+		struct perf_mmap_records *r = per_cpu_ptr(&perf_mmap_records, cpu);
+
+		records[0] += READ_ONCE(r->emitted);
+		records[1] += READ_ONCE(r->dropped);
+	}
+
+	t.data = records;
+	t.maxlen = sizeof(records);
+	return proc_doulongvec_minmax(&t, write, buffer, lenp, ppos);
+}
+
 static int perf_event_mmap_match(struct perf_event *event,
 				 void *data)
 {
@@ -8718,8 +8748,11 @@ static void perf_event_mmap_output(struct perf_event *event,
 	perf_event_header__init_id(&mmap_event->event_id.header, &sample, event);
 	ret = perf_output_begin(&handle, &sample, event,
 				mmap_event->event_id.header.size);
-	if (ret)
+	if (ret) {
+		this_cpu_inc(perf_mmap_records.dropped);
 		goto out;
+	}
+	this_cpu_inc(perf_mmap_records.emitted);
 
 	mmap_event->event_id.pid = perf_event_pid(event, current);
 	mmap_event->event_id.tid = perf_event_tid(event, current);
@@ -8758,6 +8791,66 @@ static void perf_event_mmap_output(struct perf_event *event,
 	mmap_event->event_id.header.type = type;
 }
 
+/*
+ * Parsing the build ID means looking up and mapping the first page of the
+ * file, on every mmap of it. Processes which keep mapping the same few
+ * libraries or JIT images then pay for it over and over, so remember the
+ * result per file. An entry is only used while the file has not been
+ * modified since it was parsed.
+ */
+#define PERF_BUILD_ID_CACHE_BITS	6
+
+struct perf_build_id_entry {
+	dev_t			dev;
+	unsigned long		ino;
+	u32			gen;
+	struct timespec64	mtime;
+	u32			size;
+	u8			build_id[BUILD_ID_SIZE_MAX];
+};
+
+static struct perf_build_id_entry perf_build_id_cache[1 << PERF_BUILD_ID_CACHE_BITS];
+static DEFINE_SPINLOCK(perf_build_id_lock);
+
+static void perf_event_mmap_build_id(struct perf_mmap_event *mmap_event)
+{
+	struct vm_area_struct *vma = mmap_event->vma;
+	struct inode *inode = file_inode(vma->vm_file);
+	struct timespec64 mtime = inode_get_mtime(inode);
+	dev_t dev = inode->i_sb->s_dev;
+	struct perf_build_id_entry *e;
+	int ret;
+
+	e = &perf_build_id_cache[hash_long(inode->i_ino ^ dev,
+					   PERF_BUILD_ID_CACHE_BITS)];
+
+	spin_lock(&perf_build_id_lock);
+	if (e->ino == inode->i_ino && e->dev == dev &&
+	    e->gen == inode->i_generation && timespec64_equal(&e->mtime, &mtime)) {
+		memcpy(mmap_event->build_id, e->build_id, e->size);
+		mmap_event->build_id_size = e->size;
+		spin_unlock(&perf_build_id_lock);
+		return;
+	}
+	spin_unlock(&perf_build_id_lock);
+
+	ret = build_id_parse(vma, mmap_event->build_id, &mmap_event->build_id_size);
+	/* Anything but -EINVAL, e.g. the page not being cached, may change */
+	if (ret && ret != -EINVAL)
+		return;
+	if (ret)
+		mmap_event->build_id_size = 0;
+
+	spin_lock(&perf_build_id_lock);
+	e->dev = dev;
+	e->ino = inode->i_ino;
+	e->gen = inode->i_generation;
+	e->mtime = mtime;
+	e->size = mmap_event->build_id_size;
+	memcpy(e->build_id, mmap_event->build_id, e->size);
+	spin_unlock(&perf_build_id_lock);
+}
+
 static void perf_event_mmap_event(struct perf_mmap_event *mmap_event)
 {
 	struct vm_area_struct *vma = mmap_event->vma;
@@ -8856,8 +8949,8 @@ static void perf_event_mmap_event(struct perf_mmap_event *mmap_event)
 
 	mmap_event->event_id.header.size = sizeof(mmap_event->event_id) + size;
 
-	if (atomic_read(&nr_build_id_events))
-		build_id_parse(vma, mmap_event->build_id, &mmap_event->build_id_size);
+	if (atomic_read(&nr_build_id_events) && file)
+		perf_event_mmap_build_id(mmap_event);
 
 	perf_iterate_sb(perf_event_mmap_output,
 		       mmap_event,
@@ -38,6 +38,7 @@
 #include <linux/memblock.h>
 #include <linux/fault-inject.h>
 #include <linux/slab.h>
+#include <linux/prctl.h>
 
 #include "futex.h"
 #include "../locking/rtmutex_common.h"
@@ -54,6 +55,25 @@ static struct {
 #define futex_queues   (__futex_data.queues)
 #define futex_hashsize (__futex_data.hashsize)
 
+/*
+ * Private futexes of a multi-threaded process are hashed into a table of its
+ * own, allocated on the node of the thread that creates the second thread.
+ * This keeps unrelated processes from sharing buckets and keeps the buckets
+ * close to the threads using them.
+ *
+ * The table can only be installed while the process is single-threaded, as
+ * no private futex can be queued then, and it is never resized or replaced
+ * afterwards; a futex_q therefore always finds its bucket again. A process
+ * that fails to get a table keeps using the global hash.
+ */
+struct futex_private_hash {
+	unsigned int			hash_mask;
+	struct futex_hash_bucket	queues[];
+};
+
+/* mm->futex_hash_slots value asking to stay on the global hash */
+#define FUTEX_HASH_SLOTS_GLOBAL	UINT_MAX
+
 
 /*
  * Fault injections for futexes.
@@ -107,20 +127,139 @@ late_initcall(fail_futex_debugfs);
 #endif /* CONFIG_FAIL_FUTEX */
 
 /**
- * futex_hash - Return the hash bucket in the global hash
+ * futex_hash - Return the hash bucket for a futex key
  * @key:	Pointer to the futex key for which the hash is calculated
  *
  * We hash on the keys returned from get_futex_key (see below) and return the
- * corresponding hash bucket in the global hash.
+ * corresponding hash bucket in the private hash of the mm for private keys,
+ * if it has one, or in the global hash otherwise.
  */
 struct futex_hash_bucket *futex_hash(union futex_key *key)
 {
 	u32 hash = jhash2((u32 *)key, offsetof(typeof(*key), both.offset) / 4,
 			  key->both.offset);
+	struct futex_private_hash *fph;
+
+	if (!(key->both.offset & (FUT_OFF_INODE | FUT_OFF_MMSHARED)) &&
+	    key->private.mm) {
+		fph = READ_ONCE(key->private.mm->futex_hash);
+		if (fph)
+			return &fph->queues[hash & fph->hash_mask];
+	}
 
 	return &futex_queues[hash & (futex_hashsize - 1)];
 }
 
+static void futex_hash_bucket_init(struct futex_hash_bucket *hb)
+{
+	atomic_set(&hb->waiters, 0);
+	plist_head_init(&hb->chain);
+	spin_lock_init(&hb->lock);
+}
+
+/*
+ * Without a request from the process, size the table with the number of
+ * CPUs: more threads than that cannot operate on futexes concurrently.
+ */
+static unsigned int futex_hash_default_slots(void)
+{
+	unsigned int slots = roundup_pow_of_two(2 * num_online_cpus());
+
+	return clamp_t(unsigned int, slots, 16, futex_hashsize);
+}
+
+/*
+ * Install the private hash of @mm, which must only have one user, the
+ * current task, so that no private futex of it can be queued.
+ */
+static int futex_hash_install(struct mm_struct *mm, unsigned int slots)
+{
+	struct futex_private_hash *fph;
+	unsigned int i;
+
+	fph = kvzalloc_node(struct_size(fph, queues, slots),
+			    GFP_KERNEL_ACCOUNT, numa_node_id());
+	if (!fph)
+		return -ENOMEM;
+
+	fph->hash_mask = slots - 1;
+	for (i = 0; i < slots; i++)
+		futex_hash_bucket_init(&fph->queues[i]);
+
+	WRITE_ONCE(mm->futex_hash, fph);
+	return 0;
+}
+
+static bool futex_hash_can_install(struct mm_struct *mm)
+{
+	if (mm->futex_hash || atomic_read(&mm->mm_users) != 1)
+		return false;
+
+	/* io_uring can leave private futex waits queued without a waiter task */
+#ifdef CONFIG_IO_URING
+	if (current->io_uring)
+		return false;
+#endif
+	return true;
+}
+
+/**
+ * futex_hash_clone - Set up the private futex hash for a new thread
+ * @mm:		The mm the new thread is going to share
+ *
+ * Called for CLONE_VM before the new task takes its reference on @mm.
+ */
+void futex_hash_clone(struct mm_struct *mm)
+{
+	unsigned int slots = mm->futex_hash_slots;
+
+	if (slots == FUTEX_HASH_SLOTS_GLOBAL || !futex_hash_can_install(mm))
+		return;
+
+	/* On failure the process just keeps using the global hash. */
+	futex_hash_install(mm, slots ?: futex_hash_default_slots());
+}
+
+void futex_hash_free(struct mm_struct *mm)
+{
+	kvfree(mm->futex_hash);
+}
+
+/**
+ * futex_hash_prctl - Handle PR_FUTEX_HASH
+ * @op:		PR_FUTEX_HASH_SET_SLOTS or PR_FUTEX_HASH_GET_SLOTS
+ * @slots:	Number of buckets for SET, a power of two, or 0 to keep using
+ *		the global hash
+ *
+ * The size can only be set while the process is single-threaded, the table
+ * is allocated right away in that case.
+ */
+int futex_hash_prctl(unsigned long op, unsigned long slots)
+{
+	struct mm_struct *mm = current->mm;
+	struct futex_private_hash *fph;
+
+	switch (op) {
+	case PR_FUTEX_HASH_SET_SLOTS:
+		if (slots && (!is_power_of_2(slots) || slots > futex_hashsize))
+			return -EINVAL;
+		if (!futex_hash_can_install(mm))
+			return -EBUSY;
+		if (!slots) {
+			mm->futex_hash_slots = FUTEX_HASH_SLOTS_GLOBAL;
+			return 0;
+		}
+		mm->futex_hash_slots = slots;
+		return futex_hash_install(mm, slots);
+
+	case PR_FUTEX_HASH_GET_SLOTS:
+		fph = READ_ONCE(mm->futex_hash);
+		return fph ? fph->hash_mask + 1 : 0;
+	}
+
+	return -EINVAL;
+}
+
 
 /**
  * futex_setup_timer - set up the sleeping hrtimer.
@@ -1162,11 +1301,8 @@ static int __init futex_init(void)
 					       futex_hashsize, futex_hashsize);
 	futex_hashsize = 1UL << futex_shift;
 
-	for (i = 0; i < futex_hashsize; i++) {
-		atomic_set(&futex_queues[i].waiters, 0);
-		plist_head_init(&futex_queues[i].chain);
-		spin_lock_init(&futex_queues[i].lock);
-	}
+	for (i = 0; i < futex_hashsize; i++)
+		futex_hash_bucket_init(&futex_queues[i]);
 
 	return 0;
 }
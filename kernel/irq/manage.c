@@ -592,6 +592,27 @@ irq_set_affinity_notifier(unsigned int irq, struct irq_affinity_notify *notify)
 EXPORT_SYMBOL_GPL(irq_set_affinity_notifier);
 
 #ifndef CONFIG_AUTO_IRQ_AFFINITY
+/*
+ * Keep interrupts which follow the default affinity off isolated and
+ * nohz_full CPUs, unless no other CPU in @mask is left to handle them.
+ */
+static void irq_exclude_isolated(struct cpumask *mask)
+{
+	unsigned int cpu;
+
+	for_each_cpu(cpu, mask) {
+		if (!cpu_is_isolated(cpu))
+			goto exclude;
+	}
+	return;
+
+exclude:
+	for_each_cpu(cpu, mask) {
+		if (cpu_is_isolated(cpu))
+			__cpumask_clear_cpu(cpu, mask);
+	}
+}
+
 /*
  * Generic version of the affinity autoselector.
  */
@@ -623,6 +644,8 @@ int irq_setup_affinity(struct irq_desc *desc)
 	cpumask_and(&mask, cpu_online_mask, set);
 	if (cpumask_empty(&mask))
 		cpumask_copy(&mask, cpu_online_mask);
+	if (set == irq_default_affinity)
+		irq_exclude_isolated(&mask);
 
 	if (node != NUMA_NO_NODE) {
 		const struct cpumask *nodemask = cpumask_of_node(node);
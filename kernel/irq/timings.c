@@ -507,6 +507,36 @@ static inline void irq_timings_store(int irq, struct irqt_stat *irqs, u64 ts)
 	__irq_timings_store(irq, irqs, interval);
 }
 
+/**
+ * irq_timings_first_irq - Return the first interrupt recorded since a time
+ * @since: local_clock() timestamp the interrupt must not be older than
+ *
+ * Must be called with the local irq disabled, like irq_timings_next_event().
+ *
+ * Returns the interrupt number of the oldest interrupt still recorded on the
+ * current CPU that happened at or after @since, -1 if there is none.
+ */
+int irq_timings_first_irq(u64 since)
+{
+	struct irq_timings *irqts = this_cpu_ptr(&irq_timings);
+	u64 value, ts;
+	int i, irq;
+
+	lockdep_assert_irqs_disabled();
+
+	i = max(irqts->count - IRQ_TIMINGS_SIZE, 0);
+	for (; i < irqts->count; i++) {
+		value = irqts->values[i & IRQ_TIMINGS_MASK];
+		irq = irq_timing_decode(value, &ts);
+
+		/* Only 48 bits of the timestamp are encoded, compare modulo that. */
+		if (((ts - since) & GENMASK_ULL(47, 0)) < BIT_ULL(47))
+			return irq;
+	}
+
+	return -1;
+}
+
 /**
  * irq_timings_next_event - Return when the next event is supposed to arrive
  *
@@ -31,6 +31,9 @@
 #include <linux/kernel.h>
 #include <linux/bsearch.h>
 #include <linux/btf_ids.h>
+#include <linux/jhash.h>
+#include <linux/kstrtox.h>
+#include <linux/log2.h>
 
 #include "kallsyms_internal.h"
 
@@ -170,6 +173,87 @@ static unsigned int get_symbol_seq(int index)
 	return seq;
 }
 
+/*
+ * Optional hash index over the symbol names, for tools which resolve tens of
+ * thousands of names at once, e.g. fprobe multi-attach.  A binary search has
+ * to decompress about 18 names per lookup, the index mostly one.  Every slot
+ * holds 1 + the position in the sorted seqs table of the first of the
+ * symbols with a given name, 0 for an empty slot.
+ */
+static bool kallsyms_hash_enabled __initdata;
+static u32 *kallsyms_hash_table;
+static unsigned int kallsyms_hash_mask;
+
+static int __init kallsyms_hash_setup(char *str)
+{
+	return kstrtobool(str, &kallsyms_hash_enabled);
+}
+early_param("kallsyms_hash", kallsyms_hash_setup);
+
+static unsigned int kallsyms_name_hash(const char *name)
+{
+	return jhash(name, strlen(name), 0);
+}
+
+static int kallsyms_hash_lookup(u32 *table, const char *name,
+				unsigned int *start)
+{
+	unsigned int i = kallsyms_name_hash(name) & kallsyms_hash_mask;
+	char namebuf[KSYM_NAME_LEN];
+	unsigned int pos;
+
+	for (; (pos = table[i]); i = (i + 1) & kallsyms_hash_mask) {
+		kallsyms_expand_symbol(get_symbol_offset(get_symbol_seq(pos - 1)),
+				       namebuf, ARRAY_SIZE(namebuf));
+		if (!strcmp(name, namebuf)) {
+			*start = pos - 1;
+			return 0;
+		}
+	}
+
+	return -ESRCH;
+}
+
+static int __init kallsyms_hash_init(void)
+{
+	char namebuf[KSYM_NAME_LEN], prev[KSYM_NAME_LEN] = "";
+	unsigned int i, slot, size;
+	u32 *table;
+
+	if (!kallsyms_hash_enabled || !kallsyms_num_syms)
+		return 0;
+
+	/* Keep the table at most half full */
+	size = roundup_pow_of_two(kallsyms_num_syms * 2);
+	table = kvcalloc(size, sizeof(*table), GFP_KERNEL);
+	if (!table)
+		return -ENOMEM;
+
+	kallsyms_hash_mask = size - 1;
+	for (i = 0; i < kallsyms_num_syms; i++) {
+		kallsyms_expand_symbol(get_symbol_offset(get_symbol_seq(i)),
+				       namebuf, ARRAY_SIZE(namebuf));
+		/* The seqs table is sorted, duplicates are next to each other */
+		if (!strcmp(namebuf, prev))
+			continue;
+		strscpy(prev, namebuf);
+
+		slot = kallsyms_name_hash(namebuf) & kallsyms_hash_mask;
+		while (table[slot])
+			slot = (slot + 1) & kallsyms_hash_mask;
+		table[slot] = i + 1;
+
+		if (!(i & 1023))
+			cond_resched();
+	}
+
+	smp_store_release(&kallsyms_hash_table, table);
+	pr_info("kallsyms: hash index over %u symbols, %zu KiB\n",
+		kallsyms_num_syms, size * sizeof(*table) / 1024);
+	return 0;
+}
+subsys_initcall(kallsyms_hash_init);
+
 static int kallsyms_lookup_names(const char *name,
 				 unsigned int *start,
 				 unsigned int *end)
@@ -178,6 +262,15 @@ static int kallsyms_lookup_names(const char *name,
 	int low, mid, high;
 	unsigned int seq, off;
 	char namebuf[KSYM_NAME_LEN];
+	u32 *table = smp_load_acquire(&kallsyms_hash_table);
+
+	if (table) {
+		if (kallsyms_hash_lookup(table, name, start))
+			return -ESRCH;
+		/* The first of the duplicates is known, only look forward */
+		mid = *start;
+		goto found;
+	}
 
 	low = 0;
 	high = kallsyms_num_syms - 1;
@@ -210,6 +303,7 @@ static int kallsyms_lookup_names(const char *name,
 	}
 	*start = low;
 
+found:
 	if (end) {
 		high = mid;
 		while (high < kallsyms_num_syms - 1) {
@@ -47,6 +47,9 @@ LOCK_EVENT(lock_use_node2)	/* # of locking ops that use 2nd percpu node */
 LOCK_EVENT(lock_use_node3)	/* # of locking ops that use 3rd percpu node */
 LOCK_EVENT(lock_use_node4)	/* # of locking ops that use 4th percpu node */
 LOCK_EVENT(lock_no_node)	/* # of locking ops w/o using percpu node    */
+#ifdef CONFIG_NUMA_AWARE_SPINLOCKS
+LOCK_EVENT(lock_cna_reorder)	/* # of waiters moved ahead for NUMA locality */
+#endif
 #endif /* CONFIG_QUEUED_SPINLOCKS */
 
 /*
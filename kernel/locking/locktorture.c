@@ -29,6 +29,7 @@
 #include <linux/slab.h>
 #include <linux/torture.h>
 #include <linux/reboot.h>
+#include <linux/topology.h>
 
 MODULE_DESCRIPTION("torture test facility for locking");
 MODULE_LICENSE("GPL");
@@ -42,6 +43,7 @@ torture_param(int, nreaders_stress, -1, "Number of read-locking stress-test thre
 torture_param(int, nwriters_stress, -1, "Number of write-locking stress-test threads");
 torture_param(int, onoff_holdoff, 0, "Time after boot before CPU hotplugs (s)");
 torture_param(int, onoff_interval, 0, "Time between CPU hotplugs (s), 0=disable");
+torture_param(int, read_hold_us, -1, "Fixed rwsem read hold time (us), -1=derive from long_hold");
 torture_param(int, rt_boost, 2,
 		   "Do periodic rt-boost. 0=Disable, 1=Only for rt_mutex, 2=For all lock types.");
 torture_param(int, rt_boost_factor, 50, "A factor determining how often rt-boost happens.");
@@ -115,10 +117,12 @@ static struct task_struct **reader_tasks;
 static bool lock_is_write_held;
 static atomic_t lock_is_read_held;
 static unsigned long last_lock_release;
+static int last_lock_node = NUMA_NO_NODE;
 
 struct lock_stress_stats {
 	long n_lock_fail;
 	long n_lock_acquired;
+	long n_lock_same_node;	/* Acquired after a holder on the same node. */
 };
 
 struct call_rcu_chain {
@@ -758,6 +762,18 @@ __acquires(torture_rwsem)
 
 static void torture_rwsem_read_delay(struct torture_random_state *trsp)
 {
+	/*
+	 * A short fixed hold time turns the test into a reader scalability
+	 * benchmark, where the cost of the read-side acquisition dominates.
+	 */
+	if (read_hold_us >= 0) {
+		if (read_hold_us)
+			udelay(read_hold_us);
+		if (!(torture_random(trsp) % (cxt.nrealreaders_stress * 20000)))
+			torture_preempt_schedule();  /* Allow test to be preempted. */
+		return;
+	}
+
 	/* We want a long delay occasionally to force massive contention.  */
 	if (long_hold && !(torture_random(trsp) % (cxt.nrealreaders_stress * 2000 * long_hold)))
 		mdelay(long_hold * 2);
@@ -890,6 +906,9 @@ static int lock_torture_writer(void *arg)
 					  __func__, j1 - j);
 			}
 			lwsp->n_lock_acquired++;
+			if (last_lock_node == numa_node_id())
+				lwsp->n_lock_same_node++;
+			last_lock_node = numa_node_id();
 
 			cxt.cur_ops->write_delay(&rand);
 
@@ -951,7 +970,7 @@ static void __torture_print_stats(char *page,
 	bool fail = false;
 	int i, n_stress;
 	long max = 0, min = statp ? data_race(statp[0].n_lock_acquired) : 0;
-	long long sum = 0;
+	long long sum = 0, same_node = 0;
 
 	n_stress = write ? cxt.nrealwriters_stress : cxt.nrealreaders_stress;
 	for (i = 0; i < n_stress; i++) {
@@ -959,6 +978,7 @@ static void __torture_print_stats(char *page,
 			fail = true;
 		cur = data_race(statp[i].n_lock_acquired);
 		sum += cur;
+		same_node += data_race(statp[i].n_lock_same_node);
 		if (max < cur)
 			max = cur;
 		if (min > cur)
@@ -970,6 +990,9 @@ static void __torture_print_stats(char *page,
 			sum, max, min,
 			!onoff_interval && max / 2 > min ? "???" : "",
 			fail, fail ? "!!!" : "");
+	if (write && nr_node_ids > 1)
+		page += sprintf(page, "Same-node handoffs: %lld/%lld\n",
+				same_node, sum);
 	if (fail)
 		atomic_inc(&cxt.n_lock_torture_errors);
 }
@@ -1045,11 +1068,11 @@ lock_torture_print_module_parms(struct lock_torture_ops *cur_ops,
 
 	cpumask_setall(&cpumask_all);
 	pr_alert("%s" TORTURE_FLAG
-		 "--- %s%s: acq_writer_lim=%d bind_readers=%*pbl bind_writers=%*pbl call_rcu_chains=%d long_hold=%d nested_locks=%d nreaders_stress=%d nwriters_stress=%d onoff_holdoff=%d onoff_interval=%d rt_boost=%d rt_boost_factor=%d shuffle_interval=%d shutdown_secs=%d stat_interval=%d stutter=%d verbose=%d writer_fifo=%d\n",
+		 "--- %s%s: acq_writer_lim=%d bind_readers=%*pbl bind_writers=%*pbl call_rcu_chains=%d long_hold=%d nested_locks=%d nreaders_stress=%d nwriters_stress=%d onoff_holdoff=%d onoff_interval=%d read_hold_us=%d rt_boost=%d rt_boost_factor=%d shuffle_interval=%d shutdown_secs=%d stat_interval=%d stutter=%d verbose=%d writer_fifo=%d\n",
 		 torture_type, tag, cxt.debug_lock ? " [debug]": "",
 		 acq_writer_lim, cpumask_pr_args(rcmp), cpumask_pr_args(wcmp),
 		 call_rcu_chains, long_hold, nested_locks, cxt.nrealreaders_stress,
-		 cxt.nrealwriters_stress, onoff_holdoff, onoff_interval, rt_boost,
+		 cxt.nrealwriters_stress, onoff_holdoff, onoff_interval, read_hold_us, rt_boost,
 		 rt_boost_factor, shuffle_interval, shutdown_secs, stat_interval, stutter,
 		 verbose, writer_fifo);
 }
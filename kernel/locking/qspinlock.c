@@ -78,12 +78,20 @@
  * to have more than 2 levels of slowpath nesting in actual use. We don't
  * want to penalize pvqspinlocks to optimize for a rare case in native
  * qspinlocks.
+ *
+ * The NUMA-aware handoff needs the node of the waiting CPU and a count of
+ * local handoffs in every queue node, which again only fits two of them in
+ * a cacheline.
  */
 struct qnode {
 	struct mcs_spinlock mcs;
 #ifdef CONFIG_PARAVIRT_SPINLOCKS
 	long reserved[2];
 #endif
+#ifdef CONFIG_NUMA_AWARE_SPINLOCKS
+	int numa_node;
+	unsigned int intra_count;
+#endif
 };
 
 /*
@@ -283,6 +291,20 @@ static __always_inline u32  __pv_wait_head_or_lock(struct qspinlock *lock,
 #define pv_kick_node		__pv_kick_node
 #define pv_wait_head_or_lock	__pv_wait_head_or_lock
 
+#ifdef CONFIG_NUMA_AWARE_SPINLOCKS
+#include "qspinlock_cna.h"
+#else
+static __always_inline void __cna_init_node(struct mcs_spinlock *node) { }
+static __always_inline struct mcs_spinlock *
+__cna_order_queue(struct mcs_spinlock *node, struct mcs_spinlock *next)
+{
+	return next;
+}
+#endif
+
+#define cna_init_node		__cna_init_node
+#define cna_order_queue		__cna_order_queue
+
 #ifdef CONFIG_PARAVIRT_SPINLOCKS
 #define queued_spin_lock_slowpath	native_queued_spin_lock_slowpath
 #endif
@@ -434,6 +456,7 @@ void __lockfunc queued_spin_lock_slowpath(struct qspinlock *lock, u32 val)
 	node->locked = 0;
 	node->next = NULL;
 	pv_init_node(node);
+	cna_init_node(node);
 
 	/*
 	 * We touched a (possibly) cold cacheline in the per-cpu queue node;
@@ -504,7 +527,11 @@ void __lockfunc queued_spin_lock_slowpath(struct qspinlock *lock, u32 val)
 	 *
 	 * If PV isn't active, 0 will be returned instead.
 	 *
+	 * Before that, with NUMA-aware handoff enabled, try to move a waiter
+	 * on our node to the front of the queue while we wait anyway.
 	 */
+	next = cna_order_queue(node, next);
+
 	if ((val = pv_wait_head_or_lock(lock, node)))
 		goto locked;
 
@@ -577,6 +604,11 @@ EXPORT_SYMBOL(queued_spin_lock_slowpath);
 #undef pv_kick_node
 #undef pv_wait_head_or_lock
 
+#undef  cna_init_node
+#undef  cna_order_queue
+#define cna_init_node(node)		do { } while (0)
+#define cna_order_queue(node, next)	(next)
+
 #undef  queued_spin_lock_slowpath
 #define queued_spin_lock_slowpath	__pv_queued_spin_lock_slowpath
 
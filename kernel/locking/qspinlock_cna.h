@@ -0,0 +1,156 @@
+/* SPDX-License-Identifier: GPL-2.0 */
+#ifndef _GEN_CNA_LOCK_SLOWPATH
+#define _GEN_CNA_LOCK_SLOWPATH
+
+#include <linux/init.h>
+#include <linux/jump_label.h>
+#include <linux/topology.h>
+
+/*
+ * NUMA-aware handoff for the native queued spinlock slowpath.
+ *
+ * The MCS queue is strictly FIFO, so on a multi-socket machine a contended
+ * lock and the data it protects bounce across the interconnect on nearly
+ * every handoff. While the queue head spins waiting for the owner to go
+ * away, it has nothing better to do; we use that time to look down the
+ * queue for a waiter running on the same NUMA node as the head and move it
+ * right behind the head, so that the next handoff stays local.
+ *
+ * Only the queue head ever rewrites ->next pointers of the nodes behind it:
+ * a waiter only writes ->next of its predecessor once, when it links itself
+ * in, and then spins on its own ->locked. The head therefore may freely
+ * reorder the linked part of the queue, as long as it never moves the last
+ * node, whose ->next can still be set concurrently and which lock->tail
+ * points to.
+ *
+ * To bound the unfairness towards remote waiters, every node carries the
+ * number of consecutive local handoffs that led up to it. Once that count
+ * reaches numa_spinlock_threshold the queue is left alone and handed over
+ * in FIFO order until the lock leaves the node, which resets the count.
+ *
+ * The reordering is off by default and enabled with "numa_spinlock=on" on
+ * machines with more than one NUMA node. It is never used with PV spinlocks.
+ */
+
+/*
+ * Handing the lock over within a node is typically well below a
+ * microsecond, so 64K passes keeps the worst case wait of a remote
+ * waiter in the order of tens of milliseconds.
+ */
+#define CNA_DEFAULT_THRESHOLD	(1U << 16)
+
+/*
+ * Limit the number of nodes the queue head looks at, every one of them is
+ * a cacheline of a different CPU.
+ */
+#define CNA_SCAN_LIMIT		32
+
+static DEFINE_STATIC_KEY_FALSE(numa_spinlock_key);
+
+static bool numa_spinlock __initdata;
+static unsigned int numa_spinlock_threshold __read_mostly = CNA_DEFAULT_THRESHOLD;
+
+static __init int parse_numa_spinlock(char *arg)
+{
+	return kstrtobool(arg, &numa_spinlock);
+}
+early_param("numa_spinlock", parse_numa_spinlock);
+
+static __init int parse_numa_spinlock_threshold(char *arg)
+{
+	return kstrtouint(arg, 0, &numa_spinlock_threshold);
+}
+early_param("numa_spinlock_threshold", parse_numa_spinlock_threshold);
+
+static inline struct qnode *to_qnode(struct mcs_spinlock *node)
+{
+	return container_of(node, struct qnode, mcs);
+}
+
+static __always_inline void __cna_init_node(struct mcs_spinlock *node)
+{
+	to_qnode(node)->intra_count = 0;
+}
+
+/*
+ * Move the first waiter from our node behind @next to the front of the
+ * queue, and return the node the lock is going to be handed to.
+ */
+static noinline struct mcs_spinlock *
+cna_reorder_queue(struct mcs_spinlock *node, struct mcs_spinlock *next)
+{
+	struct qnode *qn = to_qnode(node);
+	struct mcs_spinlock *prev, *cur, *after;
+	int numa_node = qn->numa_node;
+	int scanned;
+
+	if (to_qnode(next)->numa_node == numa_node) {
+		to_qnode(next)->intra_count = qn->intra_count + 1;
+		return next;
+	}
+
+	if (qn->intra_count >= numa_spinlock_threshold)
+		return next;
+
+	prev = next;
+	for (scanned = 0; scanned < CNA_SCAN_LIMIT; scanned++) {
+		cur = READ_ONCE(prev->next);
+		if (!cur)
+			break;
+
+		if (to_qnode(cur)->numa_node != numa_node) {
+			prev = cur;
+			continue;
+		}
+
+		/* @cur may be the tail; it has to stay where it is. */
+		after = READ_ONCE(cur->next);
+		if (!after)
+			break;
+
+		WRITE_ONCE(prev->next, after);
+		WRITE_ONCE(cur->next, next);
+		to_qnode(cur)->intra_count = qn->intra_count + 1;
+		WRITE_ONCE(node->next, cur);
+		lockevent_inc(lock_cna_reorder);
+		return cur;
+	}
+
+	return next;
+}
+
+static __always_inline struct mcs_spinlock *
+__cna_order_queue(struct mcs_spinlock *node, struct mcs_spinlock *next)
+{
+	if (!static_branch_unlikely(&numa_spinlock_key))
+		return next;
+
+	if (!next) {
+		next = READ_ONCE(node->next);
+		if (!next)
+			return NULL;
+	}
+
+	return cna_reorder_queue(node, next);
+}
+
+static __init int cna_init(void)
+{
+	int cpu, idx;
+
+	if (!numa_spinlock || nr_node_ids < 2)
+		return 0;
+
+	for_each_possible_cpu(cpu) {
+		for (idx = 0; idx < MAX_NODES; idx++)
+			per_cpu_ptr(&qnodes[idx], cpu)->numa_node = cpu_to_node(cpu);
+	}
+
+	static_branch_enable(&numa_spinlock_key);
+	pr_info("qspinlock: NUMA-aware handoff enabled, threshold %u\n",
+		numa_spinlock_threshold);
+	return 0;
+}
+early_initcall(cna_init);
+
+#endif /* _GEN_CNA_LOCK_SLOWPATH */
@@ -68,6 +68,7 @@ struct load_info {
 	char *secstrings, *strtab;
 	unsigned long symoffs, stroffs, init_typeoffs, core_typeoffs;
 	bool sig_ok;
+	u64 start_ns;
 #ifdef CONFIG_KALLSYMS
 	unsigned long mod_kallsyms_init_off;
 #endif
@@ -94,6 +95,8 @@ struct find_symbol_arg {
 	const char *name;
 	bool gplok;
 	bool warn;
+	/* Module resolving the symbol, its dependencies are searched first */
+	struct module *user;
 
 	/* Output */
 	struct module *owner;
@@ -297,9 +297,50 @@ static bool find_exported_symbol_in_section(const struct symsearch *syms,
 	return true;
 }
 
+static bool find_exported_symbol_in_module(struct module *mod,
+					   struct find_symbol_arg *fsa)
+{
+	struct symsearch arr[] = {
+		{ mod->syms, mod->syms + mod->num_syms, mod->crcs,
+		  NOT_GPL_ONLY },
+		{ mod->gpl_syms, mod->gpl_syms + mod->num_gpl_syms,
+		  mod->gpl_crcs,
+		  GPL_ONLY },
+	};
+	unsigned int i;
+
+	if (mod->state == MODULE_STATE_UNFORMED)
+		return false;
+
+	for (i = 0; i < ARRAY_SIZE(arr); i++)
+		if (find_exported_symbol_in_section(&arr[i], mod, fsa))
+			return true;
+	return false;
+}
+
+/*
+ * A module typically takes most of its symbols from a handful of other
+ * modules, so look at the ones it already uses before walking the list of
+ * all modules.  Exported symbols are unique, so this finds the same owner.
+ */
+static bool find_symbol_in_targets(struct find_symbol_arg *fsa)
+{
+#ifdef CONFIG_MODULE_UNLOAD
+	struct module_use *use;
+
+	lockdep_assert_held(&module_mutex);
+
+	list_for_each_entry(use, &fsa->user->target_list, target_list)
+		if (find_exported_symbol_in_module(use->target, fsa))
+			return true;
+#endif
+	return false;
+}
+
 /*
  * Find an exported symbol and return it, along with, (optional) crc and
- * (optional) module which owns it.  Needs preempt disabled or module_mutex.
+ * (optional) module which owns it.  Needs preempt disabled or module_mutex,
+ * module_mutex if fsa->user is set.
  */
 bool find_symbol(struct find_symbol_arg *fsa)
 {
@@ -319,22 +360,13 @@ bool find_symbol(struct find_symbol_arg *fsa)
 		if (find_exported_symbol_in_section(&arr[i], NULL, fsa))
 			return true;
 
+	if (fsa->user && find_symbol_in_targets(fsa))
+		return true;
+
 	list_for_each_entry_rcu(mod, &modules, list,
 				lockdep_is_held(&module_mutex)) {
-		struct symsearch arr[] = {
-			{ mod->syms, mod->syms + mod->num_syms, mod->crcs,
-			  NOT_GPL_ONLY },
-			{ mod->gpl_syms, mod->gpl_syms + mod->num_gpl_syms,
-			  mod->gpl_crcs,
-			  GPL_ONLY },
-		};
-
-		if (mod->state == MODULE_STATE_UNFORMED)
-			continue;
-
-		for (i = 0; i < ARRAY_SIZE(arr); i++)
-			if (find_exported_symbol_in_section(&arr[i], mod, fsa))
-				return true;
+		if (find_exported_symbol_in_module(mod, fsa))
+			return true;
 	}
 
 	pr_debug("Failed to find symbol %s\n", fsa->name);
@@ -965,6 +997,16 @@ static ssize_t show_initsize(struct module_attribute *mattr,
 static struct module_attribute modinfo_initsize =
 	__ATTR(initsize, 0444, show_initsize, NULL);
 
+static ssize_t show_load_time(struct module_attribute *mattr,
+			      struct module_kobject *mk, char *buffer)
+{
+	return sprintf(buffer, "%llu\n",
+		       div_u64(READ_ONCE(mk->mod->load_time_ns), NSEC_PER_USEC));
+}
+
+static struct module_attribute modinfo_load_time =
+	__ATTR(load_time_us, 0444, show_load_time, NULL);
+
 static ssize_t show_taint(struct module_attribute *mattr,
 			  struct module_kobject *mk, char *buffer)
 {
@@ -988,6 +1030,7 @@ struct module_attribute *modinfo_attrs[] = {
 	&modinfo_datasize,
 #endif
 	&modinfo_initsize,
+	&modinfo_load_time,
 	&modinfo_taint,
 #ifdef CONFIG_MODULE_UNLOAD
 	&modinfo_refcnt,
@@ -1117,6 +1160,7 @@ static const struct kernel_symbol *resolve_symbol(struct module *mod,
 		.name	= name,
 		.gplok	= !(mod->taints & (1 << TAINT_PROPRIETARY_MODULE)),
 		.warn	= true,
+		.user	= mod,
 	};
 	int err;
 
@@ -2515,6 +2559,7 @@ static noinline int do_init_module(struct module *mod)
 {
 	int ret = 0;
 	struct mod_initfree *freeinit;
+	u64 start_ns = ktime_get_ns();
 #if defined(CONFIG_MODULE_STATS)
 	unsigned int text_size = 0, total_size = 0;
 
@@ -2553,6 +2598,7 @@ static noinline int do_init_module(struct module *mod)
 	}
 
 	/* Now it's a first class citizen! */
+	WRITE_ONCE(mod->load_time_ns, mod->load_time_ns + ktime_get_ns() - start_ns);
 	mod->state = MODULE_STATE_LIVE;
 	blocking_notifier_call_chain(&module_notify_list,
 				     MODULE_STATE_LIVE, mod);
@@ -2859,6 +2905,8 @@ static int load_module(struct load_info *info, const char __user *uargs,
 	long err = 0;
 	char *after_dashes;
 
+	info->start_ns = ktime_get_ns();
+
 	/*
 	 * Do the signature check (if any) first. All that
 	 * the signature check needs is info->len, it does
@@ -3006,6 +3054,9 @@ static int load_module(struct load_info *info, const char __user *uargs,
 	/* Done! */
 	trace_module_load(mod);
 
+	/* do_init_module() adds the time the init function takes */
+	mod->load_time_ns = ktime_get_ns() - info->start_ns;
+
 	return do_init_module(mod);
 
  sysfs_cleanup:
@@ -121,12 +121,14 @@ struct printk_buffers {
  *		nothing to output and this record should be skipped.
  * @seq:	The sequence number of the record used for @pbufs->outbuf.
  * @dropped:	The number of dropped records from reading @seq.
+ * @ts_nsec:	The timestamp of the record used for @pbufs->outbuf.
  */
 struct printk_message {
 	struct printk_buffers	*pbufs;
 	unsigned int		outbuf_len;
 	u64			seq;
 	unsigned long		dropped;
+	u64			ts_nsec;
 };
 
 bool other_cpu_in_panic(void);
@@ -135,4 +137,6 @@ bool printk_get_next_message(struct printk_message *pmsg, u64 seq,
 
 #ifdef CONFIG_PRINTK
 void console_prepend_dropped(struct printk_message *pmsg, unsigned long dropped);
+void console_account_record(struct console *con, struct printk_message *pmsg,
+			    bool printed);
 #endif
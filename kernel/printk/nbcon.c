@@ -923,6 +923,8 @@ static bool nbcon_emit_next_record(struct nbcon_write_context *wctxt)
 		WRITE_ONCE(con->dropped, dropped);
 	}
 
+	console_account_record(con, &pmsg, pmsg.outbuf_len != 0);
+
 	nbcon_seq_try_update(ctxt, pmsg.seq + 1);
 
 	return nbcon_context_exit_unsafe(ctxt);
@@ -2898,6 +2898,7 @@ bool printk_get_next_message(struct printk_message *pmsg, u64 seq,
 
 	pmsg->seq = r.info->seq;
 	pmsg->dropped = r.info->seq - seq;
+	pmsg->ts_nsec = r.info->ts_nsec;
 
 	/* Skip record that has level above the console loglevel. */
 	if (may_suppress && suppress_message_printing(r.info->level))
@@ -2915,6 +2916,44 @@ bool printk_get_next_message(struct printk_message *pmsg, u64 seq,
 	return true;
 }
 
+/*
+ * Records which reach a console later than this after they were stored are
+ * counted as delayed in the console statistics.
+ */
+#define CONSOLE_DELAY_NS	(100 * NSEC_PER_MSEC)
+
+/*
+ * Update the statistics of @con for the record in @pmsg, which has been
+ * written out if @printed is true and skipped otherwise.
+ *
+ * The caller owns the console, but the statistics are read locklessly by
+ * /proc/console_stats, and for nbcon consoles a hostile takeover may race
+ * with the update. They are only meant to be approximate.
+ */
+void console_account_record(struct console *con, struct printk_message *pmsg,
+			    bool printed)
+{
+	s64 delay;
+
+	if (pmsg->dropped) {
+		WRITE_ONCE(con->stat_dropped,
+			   data_race(con->stat_dropped) + pmsg->dropped);
+	}
+
+	if (!printed)
+		return;
+
+	/* local_clock() is not synchronized across CPUs, ignore underflow */
+	delay = local_clock() - pmsg->ts_nsec;
+	if (delay <= 0)
+		return;
+
+	if (delay > CONSOLE_DELAY_NS)
+		WRITE_ONCE(con->stat_delayed, data_race(con->stat_delayed) + 1);
+	if (delay > data_race(con->stat_max_delay_ns))
+		WRITE_ONCE(con->stat_max_delay_ns, delay);
+}
+
 /*
  * Used as the printk buffers for non-panic, serialized console printing.
  * This is for legacy (!CON_NBCON) as well as all boot (CON_BOOT) consoles.
@@ -2955,6 +2994,7 @@ static bool console_emit_next_record(struct console *con, bool *handover, int co
 
 	/* Skip messages of formatted length 0. */
 	if (pmsg.outbuf_len == 0) {
+		console_account_record(con, &pmsg, false);
 		con->seq = pmsg.seq + 1;
 		goto skip;
 	}
@@ -2985,6 +3025,7 @@ static bool console_emit_next_record(struct console *con, bool *handover, int co
 
 	start_critical_timings();
 
+	console_account_record(con, &pmsg, true);
 	con->seq = pmsg.seq + 1;
 
 	*handover = console_lock_spinning_disable_and_check(cookie);
@@ -3614,6 +3655,9 @@ void register_console(struct console *newcon)
 	}
 
 	newcon->dropped = 0;
+	newcon->stat_dropped = 0;
+	newcon->stat_delayed = 0;
+	newcon->stat_max_delay_ns = 0;
 	console_init_seq(newcon, bootcon_registered);
 
 	if (newcon->flags & CON_NBCON)
@@ -570,12 +570,20 @@ void do_trace_rcu_torture_read(const char *rcutorturename,
 			       unsigned long c_old,
 			       unsigned long c);
 void rcu_gp_set_torture_wait(int duration);
+void rcu_sr_normal_get_stats(unsigned long *batches, unsigned long *gp_wakes,
+			     unsigned long *work_wakes);
 #else
 static inline void rcutorture_get_gp_data(int *flags, unsigned long *gp_seq)
 {
 	*flags = 0;
 	*gp_seq = 0;
 }
+static inline void rcu_sr_normal_get_stats(unsigned long *batches,
+					   unsigned long *gp_wakes,
+					   unsigned long *work_wakes)
+{
+	*batches = *gp_wakes = *work_wakes = 0;
+}
 #ifdef CONFIG_RCU_TRACE
 void do_trace_rcu_torture_read(const char *rcutorturename,
 			       struct rcu_head *rhp,
@@ -840,6 +840,7 @@ rcu_scale_cleanup(void)
 	int ngps = 0;
 	u64 *wdp;
 	u64 *wdpp;
+	unsigned long srs_batches, srs_gp_wakes, srs_work_wakes;
 
 	/*
 	 * Would like warning at start, but everything is expedited
@@ -902,6 +903,11 @@ rcu_scale_cleanup(void)
 			 ngps,
 			 rcuscale_seq_diff(b_rcu_gp_test_finished,
 					   b_rcu_gp_test_started));
+		rcu_sr_normal_get_stats(&srs_batches, &srs_gp_wakes, &srs_work_wakes);
+		if (srs_batches)
+			pr_alert("%s%s synchronize_rcu() wait list: batches: %lu woken from GP kthread: %lu woken from kworker: %lu\n",
+				 scale_type, SCALE_FLAG, srs_batches,
+				 srs_gp_wakes, srs_work_wakes);
 		for (i = 0; i < nrealwriters; i++) {
 			if (!writer_durations)
 				break;
@@ -195,6 +195,11 @@ module_param(rcu_unlock_delay, int, 0444);
 static int rcu_min_cached_objs = 5;
 module_param(rcu_min_cached_objs, int, 0444);
 
+// Pending kvfree_rcu() memory per CPU (in KiB) at which batches are not
+// held back for KFREE_DRAIN_JIFFIES anymore.
+static int rcu_kvfree_hurry_kb = 4096;
+module_param(rcu_kvfree_hurry_kb, int, 0644);
+
 // A page shrinker can ask for pages to be freed to make them
 // available for other parts of the system. This usually happens
 // under low memory conditions, and in that case we should also
@@ -1613,8 +1618,12 @@ static void rcu_sr_put_wait_head(struct llist_node *node)
 	atomic_set_release(&sr_wn->inuse, 0);
 }
 
-/* Disabled by default. */
-static int rcu_normal_wake_from_gp;
+/*
+ * Wake synchronize_rcu() users straight from the GP kthread. The default
+ * of -1 enables it on systems with at most RCU_NORMAL_WAKE_AUTO_CPUS CPUs.
+ */
+#define RCU_NORMAL_WAKE_AUTO_CPUS	16
+static int rcu_normal_wake_from_gp = -1;
 module_param(rcu_normal_wake_from_gp, int, 0644);
 static struct workqueue_struct *sync_wq;
 
@@ -1636,6 +1645,7 @@ static void rcu_sr_normal_complete(struct llist_node *node)
 static void rcu_sr_normal_gp_cleanup_work(struct work_struct *work)
 {
 	struct llist_node *done, *rcu, *next, *head;
+	unsigned long woken = 0;
 
 	/*
 	 * This work execution can potentially execute
@@ -1668,12 +1678,17 @@ static void rcu_sr_normal_gp_cleanup_work(struct work_struct *work)
 	llist_for_each_safe(rcu, next, head) {
 		if (!rcu_sr_is_wait_head(rcu)) {
 			rcu_sr_normal_complete(rcu);
+			woken++;
 			continue;
 		}
 
 		rcu_sr_put_wait_head(rcu);
 	}
 
+	/* Workqueue semantics make this the only writer. */
+	WRITE_ONCE(rcu_state.srs_nr_work_wakes,
+		   rcu_state.srs_nr_work_wakes + woken);
+
 	/* Order list manipulations with atomic access. */
 	atomic_dec_return_release(&rcu_state.srs_cleanups_pending);
 }
@@ -1709,6 +1724,9 @@ static void rcu_sr_normal_gp_cleanup(void)
 			break;
 	}
 
+	WRITE_ONCE(rcu_state.srs_nr_batches, rcu_state.srs_nr_batches + 1);
+	WRITE_ONCE(rcu_state.srs_nr_gp_wakes, rcu_state.srs_nr_gp_wakes + done);
+
 	/*
 	 * Fast path, no more users to process except putting the second last
 	 * wait head if no inflight-workers. If there are in-flight workers,
@@ -1779,6 +1797,20 @@ static void rcu_sr_normal_add_req(struct rcu_synchronize *rs)
 	llist_add((struct llist_node *) &rs->head, &rcu_state.srs_next);
 }
 
+/*
+ * Report how many grace periods had synchronize_rcu() users on their wait
+ * list, and how many users were woken by the GP kthread and by the cleanup
+ * work. Intended for rcuscale and stall diagnostics.
+ */
+void rcu_sr_normal_get_stats(unsigned long *batches, unsigned long *gp_wakes,
+			     unsigned long *work_wakes)
+{
+	*batches = data_race(READ_ONCE(rcu_state.srs_nr_batches));
+	*gp_wakes = data_race(READ_ONCE(rcu_state.srs_nr_gp_wakes));
+	*work_wakes = data_race(READ_ONCE(rcu_state.srs_nr_work_wakes));
+}
+EXPORT_SYMBOL_GPL(rcu_sr_normal_get_stats);
+
 /*
  * Initialize a new grace period.  Return false if no grace period required.
  */
@@ -3221,12 +3253,14 @@ EXPORT_SYMBOL_GPL(call_rcu);
  * @list: List node. All blocks are linked between each other
  * @gp_snap: Snapshot of RCU state for objects placed to this bulk
  * @nr_records: Number of active pointers in the array
+ * @nr_bytes: Memory held by the objects in the array
  * @records: Array of the kvfree_rcu() pointers
  */
 struct kvfree_rcu_bulk_data {
 	struct list_head list;
 	struct rcu_gp_oldstate gp_snap;
 	unsigned long nr_records;
+	unsigned long nr_bytes;
 	void *records[];
 };
 
@@ -3243,6 +3277,7 @@ struct kvfree_rcu_bulk_data {
  * @rcu_work: Let queue_rcu_work() invoke workqueue handler after grace period
  * @head_free: List of kfree_rcu() objects waiting for a grace period
  * @head_free_gp_snap: Grace-period snapshot to check for attempted premature frees.
+ * @head_free_bytes: Memory held by the objects on @head_free
  * @bulk_head_free: Bulk-List of kvfree_rcu() objects waiting for a grace period
  * @krcp: Pointer to @kfree_rcu_cpu structure
  */
@@ -3251,6 +3286,7 @@ struct kfree_rcu_cpu_work {
 	struct rcu_work rcu_work;
 	struct rcu_head *head_free;
 	struct rcu_gp_oldstate head_free_gp_snap;
+	unsigned long head_free_bytes;
 	struct list_head bulk_head_free[FREE_N_CHANNELS];
 	struct kfree_rcu_cpu *krcp;
 };
@@ -3259,6 +3295,7 @@ struct kfree_rcu_cpu_work {
  * struct kfree_rcu_cpu - batch up kfree_rcu() requests for RCU grace period
  * @head: List of kfree_rcu() objects not yet waiting for a grace period
  * @head_gp_snap: Snapshot of RCU state for objects placed to "@head"
+ * @head_bytes: Memory held by the objects on "@head"
  * @bulk_head: Bulk-List of kvfree_rcu() objects not yet waiting for a grace period
  * @krw_arr: Array of batches of kfree_rcu() objects waiting for a grace period
  * @lock: Synchronize access to this structure
@@ -3276,6 +3313,7 @@ struct kfree_rcu_cpu_work {
  * @work_in_progress: Indicates that page_cache_work is running
  * @hrtimer: A hrtimer for scheduling a page_cache_work
  * @nr_bkv_objs: number of allocated objects at @bkvcache.
+ * @pending_bytes: Memory held by all objects of this CPU not yet freed
  *
  * This is a per-CPU structure.  The reason that it is not included in
  * the rcu_data structure is to permit this code to be extracted from
@@ -3287,6 +3325,7 @@ struct kfree_rcu_cpu {
 	// through their rcu_head structures.
 	struct rcu_head *head;
 	unsigned long head_gp_snap;
+	unsigned long head_bytes;
 	atomic_t head_count;
 
 	// Objects queued on a bulk-list.
@@ -3305,6 +3344,8 @@ struct kfree_rcu_cpu {
 
 	struct llist_head bkvcache;
 	int nr_bkv_objs;
+
+	atomic_long_t pending_bytes;
 };
 
 static DEFINE_PER_CPU(struct kfree_rcu_cpu, krc) = {
@@ -3364,6 +3405,15 @@ put_cached_bnode(struct kfree_rcu_cpu *krcp,
 	return true;
 }
 
+/*
+ * Size of an object for the pending memory accounting. vmalloc() areas are
+ * accounted as a single page, looking them up would need the vmap locks.
+ */
+static size_t kvfree_rcu_obj_size(void *ptr)
+{
+	return is_vmalloc_addr(ptr) ? PAGE_SIZE : __ksize(ptr);
+}
+
 static int
 drain_page_cache(struct kfree_rcu_cpu *krcp)
 {
@@ -3413,6 +3463,7 @@ kvfree_rcu_bulk(struct kfree_rcu_cpu *krcp,
 		}
 		rcu_lock_release(&rcu_callback_map);
 	}
+	atomic_long_sub(bnode->nr_bytes, &krcp->pending_bytes);
 
 	raw_spin_lock_irqsave(&krcp->lock, flags);
 	if (put_cached_bnode(krcp, bnode))
@@ -3460,6 +3511,7 @@ static void kfree_rcu_work(struct work_struct *work)
 	struct kfree_rcu_cpu *krcp;
 	struct kfree_rcu_cpu_work *krwp;
 	struct rcu_gp_oldstate head_gp_snap;
+	unsigned long head_bytes;
 	int i;
 
 	krwp = container_of(to_rcu_work(work),
@@ -3475,6 +3527,8 @@ static void kfree_rcu_work(struct work_struct *work)
 	head = krwp->head_free;
 	krwp->head_free = NULL;
 	head_gp_snap = krwp->head_free_gp_snap;
+	head_bytes = krwp->head_free_bytes;
+	krwp->head_free_bytes = 0;
 	raw_spin_unlock_irqrestore(&krcp->lock, flags);
 
 	// Handle the first two channels.
@@ -3493,6 +3547,7 @@ static void kfree_rcu_work(struct work_struct *work)
 	 */
 	if (head && !WARN_ON_ONCE(!poll_state_synchronize_rcu_full(&head_gp_snap)))
 		kvfree_rcu_list(head);
+	atomic_long_sub(head_bytes, &krcp->pending_bytes);
 }
 
 static bool
@@ -3535,7 +3590,12 @@ schedule_delayed_monitor_work(struct kfree_rcu_cpu *krcp)
 {
 	long delay, delay_left;
 
-	delay = krc_count(krcp) >= KVFREE_BULK_MAX_ENTR ? 1:KFREE_DRAIN_JIFFIES;
+	// Drain right away when a lot of objects or memory is pending.
+	if (krc_count(krcp) >= KVFREE_BULK_MAX_ENTR ||
+	    atomic_long_read(&krcp->pending_bytes) >= (long)rcu_kvfree_hurry_kb << 10)
+		delay = 1;
+	else
+		delay = KFREE_DRAIN_JIFFIES;
 	if (delayed_work_pending(&krcp->monitor_work)) {
 		delay_left = krcp->monitor_work.timer.expires - jiffies;
 		if (delay < delay_left)
@@ -3551,6 +3611,7 @@ kvfree_rcu_drain_ready(struct kfree_rcu_cpu *krcp)
 	struct list_head bulk_ready[FREE_N_CHANNELS];
 	struct kvfree_rcu_bulk_data *bnode, *n;
 	struct rcu_head *head_ready = NULL;
+	unsigned long head_bytes = 0;
 	unsigned long flags;
 	int i;
 
@@ -3569,6 +3630,8 @@ kvfree_rcu_drain_ready(struct kfree_rcu_cpu *krcp)
 
 	if (krcp->head && poll_state_synchronize_rcu(krcp->head_gp_snap)) {
 		head_ready = krcp->head;
+		head_bytes = krcp->head_bytes;
+		krcp->head_bytes = 0;
 		atomic_set(&krcp->head_count, 0);
 		WRITE_ONCE(krcp->head, NULL);
 	}
@@ -3579,8 +3642,10 @@ kvfree_rcu_drain_ready(struct kfree_rcu_cpu *krcp)
 			kvfree_rcu_bulk(krcp, bnode, i);
 	}
 
-	if (head_ready)
+	if (head_ready) {
 		kvfree_rcu_list(head_ready);
+		atomic_long_sub(head_bytes, &krcp->pending_bytes);
+	}
 }
 
 /*
@@ -3624,6 +3689,8 @@ static void kfree_rcu_monitor(struct work_struct *work)
 			// objects queued on the linked list.
 			if (!krwp->head_free) {
 				krwp->head_free = krcp->head;
+				krwp->head_free_bytes = krcp->head_bytes;
+				krcp->head_bytes = 0;
 				get_state_synchronize_rcu_full(&krwp->head_free_gp_snap);
 				atomic_set(&krcp->head_count, 0);
 				WRITE_ONCE(krcp->head, NULL);
@@ -3723,7 +3790,7 @@ run_page_cache_worker(struct kfree_rcu_cpu *krcp)
 // use a fallback.
 static inline bool
 add_ptr_to_bulk_krc_lock(struct kfree_rcu_cpu **krcp,
-	unsigned long *flags, void *ptr, bool can_alloc)
+	unsigned long *flags, void *ptr, size_t size, bool can_alloc)
 {
 	struct kvfree_rcu_bulk_data *bnode;
 	int idx;
@@ -3763,11 +3830,13 @@ add_ptr_to_bulk_krc_lock(struct kfree_rcu_cpu **krcp,
 
 		// Initialize the new block and attach it.
 		bnode->nr_records = 0;
+		bnode->nr_bytes = 0;
 		list_add(&bnode->list, &(*krcp)->bulk_head[idx]);
 	}
 
 	// Finally insert and update the GP for this page.
 	bnode->records[bnode->nr_records++] = ptr;
+	bnode->nr_bytes += size;
 	get_state_synchronize_rcu_full(&bnode->gp_snap);
 	atomic_inc(&(*krcp)->bulk_count[idx]);
 
@@ -3791,6 +3860,7 @@ void kvfree_call_rcu(struct rcu_head *head, void *ptr)
 	unsigned long flags;
 	struct kfree_rcu_cpu *krcp;
 	bool success;
+	size_t size;
 
 	/*
 	 * Please note there is a limitation for the head-less
@@ -3813,7 +3883,8 @@ void kvfree_call_rcu(struct rcu_head *head, void *ptr)
 	}
 
 	kasan_record_aux_stack_noalloc(ptr);
-	success = add_ptr_to_bulk_krc_lock(&krcp, &flags, ptr, !head);
+	size = kvfree_rcu_obj_size(ptr);
+	success = add_ptr_to_bulk_krc_lock(&krcp, &flags, ptr, size, !head);
 	if (!success) {
 		run_page_cache_worker(krcp);
 
@@ -3824,6 +3895,7 @@ void kvfree_call_rcu(struct rcu_head *head, void *ptr)
 		head->func = ptr;
 		head->next = krcp->head;
 		WRITE_ONCE(krcp->head, head);
+		krcp->head_bytes += size;
 		atomic_inc(&krcp->head_count);
 
 		// Take a snapshot for this krcp.
@@ -3838,6 +3910,7 @@ void kvfree_call_rcu(struct rcu_head *head, void *ptr)
 	 * this object (no scanning or false positives reporting).
 	 */
 	kmemleak_ignore(ptr);
+	atomic_long_add(size, &krcp->pending_bytes);
 
 	// Set timer to drain after KFREE_DRAIN_JIFFIES.
 	if (rcu_scheduler_active == RCU_SCHEDULER_RUNNING)
@@ -3859,6 +3932,21 @@ void kvfree_call_rcu(struct rcu_head *head, void *ptr)
 }
 EXPORT_SYMBOL_GPL(kvfree_call_rcu);
 
+/*
+ * Memory held by objects passed to kvfree_rcu() and not yet freed, for
+ * /proc/meminfo.
+ */
+unsigned long kvfree_rcu_pending_bytes(void)
+{
+	unsigned long bytes = 0;
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		bytes += max(atomic_long_read(&per_cpu_ptr(&krc, cpu)->pending_bytes), 0L);
+
+	return bytes;
+}
+
 static unsigned long
 kfree_rcu_shrink_count(struct shrinker *shrink, struct shrink_control *sc)
 {
@@ -3940,7 +4028,7 @@ static void synchronize_rcu_normal(void)
 
 	trace_rcu_sr_normal(rcu_state.name, &rs.head, TPS("request"));
 
-	if (!READ_ONCE(rcu_normal_wake_from_gp)) {
+	if (READ_ONCE(rcu_normal_wake_from_gp) < 1) {
 		wait_rcu_gp(call_rcu_hurry);
 		goto trace_complete_out;
 	}
@@ -5651,6 +5739,9 @@ void __init rcu_init(void)
 	sync_wq = alloc_workqueue("sync_wq", WQ_MEM_RECLAIM, 0);
 	WARN_ON(!sync_wq);
 
+	if (rcu_normal_wake_from_gp < 0)
+		rcu_normal_wake_from_gp = nr_cpu_ids <= RCU_NORMAL_WAKE_AUTO_CPUS;
+
 	/* Fill in default value for rcutree.qovld boot parameter. */
 	/* -After- the rcu_node ->lock fields are initialized! */
 	if (qovld < 0)
@@ -420,6 +420,9 @@ struct rcu_state {
 	struct sr_wait_node srs_wait_nodes[SR_NORMAL_GP_WAIT_HEAD_MAX];
 	struct work_struct srs_cleanup_work;
 	atomic_t srs_cleanups_pending; /* srs inflight worker cleanups. */
+	unsigned long srs_nr_batches;	/* GPs with synchronize_rcu() users. */
+	unsigned long srs_nr_gp_wakes;	/* Users woken by the GP kthread. */
+	unsigned long srs_nr_work_wakes; /* Users woken by cleanup work. */
 };
 
 /* Values for rcu_state structure's gp_flags field. */
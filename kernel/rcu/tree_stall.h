@@ -901,6 +901,11 @@ void show_rcu_gp_kthreads(void)
 		(long)data_race(READ_ONCE(rcu_get_root()->gp_seq_needed)),
 		data_race(READ_ONCE(rcu_state.gp_max)),
 		data_race(READ_ONCE(rcu_state.gp_flags)));
+	if (data_race(READ_ONCE(rcu_state.srs_nr_batches)))
+		pr_info("\tsynchronize_rcu() wait list: ->srs_nr_batches %lu ->srs_nr_gp_wakes %lu ->srs_nr_work_wakes %lu\n",
+			data_race(READ_ONCE(rcu_state.srs_nr_batches)),
+			data_race(READ_ONCE(rcu_state.srs_nr_gp_wakes)),
+			data_race(READ_ONCE(rcu_state.srs_nr_work_wakes)));
 	rcu_for_each_node_breadth_first(rnp) {
 		if (ULONG_CMP_GE(READ_ONCE(rcu_state.gp_seq), READ_ONCE(rnp->gp_seq_needed)) &&
 		    !data_race(READ_ONCE(rnp->qsmask)) && !data_race(READ_ONCE(rnp->boost_tasks)) &&
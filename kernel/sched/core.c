@@ -1010,9 +1010,17 @@ void wake_q_add_safe(struct wake_q_head *head, struct task_struct *task)
 		put_task_struct(task);
 }
 
+/* Maximum number of wakeups per wake_up_batch_begin() section in wake_up_q() */
+#define WAKE_Q_BATCH		32
+
 void wake_up_q(struct wake_q_head *head)
 {
 	struct wake_q_node *node = head->first;
+	bool batch = node != WAKE_Q_TAIL && node->next != WAKE_Q_TAIL;
+	int nr = 0;
+
+	if (batch)
+		wake_up_batch_begin();
 
 	while (node != WAKE_Q_TAIL) {
 		struct task_struct *task;
@@ -1028,7 +1036,15 @@ void wake_up_q(struct wake_q_head *head)
 		 */
 		wake_up_process(task);
 		put_task_struct(task);
+
+		if (batch && !(++nr % WAKE_Q_BATCH)) {
+			wake_up_batch_end();
+			wake_up_batch_begin();
+		}
 	}
+
+	if (batch)
+		wake_up_batch_end();
 }
 
 /*
@@ -3720,6 +3736,82 @@ bool call_function_single_prep_ipi(int cpu)
  * via sched_ttwu_wakeup() for activation so the wakee incurs the cost
  * of the wakeup instead of the waker.
  */
+#ifndef CONFIG_PREEMPT_RT
+/*
+ * Wakelist IPIs held back by wake_up_batch_begin(). Only used with IRQs
+ * disabled on the local CPU.
+ */
+struct wake_batch {
+	unsigned int		depth;
+	bool			pending;
+	cpumask_var_t		ipi_mask;
+};
+
+static DEFINE_PER_CPU(struct wake_batch, wake_batch);
+
+static bool wake_batch_queue(int cpu, struct llist_node *node)
+{
+	struct wake_batch *wb = this_cpu_ptr(&wake_batch);
+
+	if (!wb->depth)
+		return false;
+
+	__smp_call_single_queue_mask(cpu, node, wb->ipi_mask);
+	wb->pending = true;
+	return true;
+}
+
+/**
+ * wake_up_batch_begin - start batching remote wakeups
+ *
+ * Waking up many tasks in a row, e.g. a wait queue or wake_q fan-out, queues
+ * each wakee on the wakelist of its target CPU and sends that CPU an IPI when
+ * its wakelist was empty. Between wake_up_batch_begin() and wake_up_batch_end()
+ * those IPIs are held back and sent at the end, one multicast IPI for all the
+ * CPUs that got wakees, each of them processing its whole list at once.
+ *
+ * Disables preemption, so the batch should cover a bounded number of wakeups.
+ * Batches nest. A no-op on PREEMPT_RT, where the wakeup paths are preemptible.
+ */
+void wake_up_batch_begin(void)
+{
+	preempt_disable();
+	this_cpu_inc(wake_batch.depth);
+}
+
+/**
+ * wake_up_batch_end - end batching remote wakeups and send held back IPIs
+ */
+void wake_up_batch_end(void)
+{
+	struct wake_batch *wb;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	wb = this_cpu_ptr(&wake_batch);
+	if (!--wb->depth && wb->pending) {
+		wb->pending = false;
+		smp_call_function_kick_mask(wb->ipi_mask);
+		cpumask_clear(wb->ipi_mask);
+	}
+	local_irq_restore(flags);
+	preempt_enable();
+}
+
+static void __init wake_batch_init(int cpu)
+{
+	zalloc_cpumask_var_node(&per_cpu(wake_batch, cpu).ipi_mask,
+				GFP_KERNEL, cpu_to_node(cpu));
+}
+#else
+static inline bool wake_batch_queue(int cpu, struct llist_node *node)
+{
+	return false;
+}
+
+static inline void wake_batch_init(int cpu) { }
+#endif /* !CONFIG_PREEMPT_RT */
+
 static void __ttwu_queue_wakelist(struct task_struct *p, int cpu, int wake_flags)
 {
 	struct rq *rq = cpu_rq(cpu);
@@ -3727,7 +3819,8 @@ static void __ttwu_queue_wakelist(struct task_struct *p, int cpu, int wake_flags
 	p->sched_remote_wakeup = !!(wake_flags & WF_MIGRATED);
 
 	WRITE_ONCE(rq->ttwu_pending, 1);
-	__smp_call_single_queue(cpu, &p->wake_entry.llist);
+	if (!wake_batch_queue(cpu, &p->wake_entry.llist))
+		__smp_call_single_queue(cpu, &p->wake_entry.llist);
 }
 
 void wake_up_if_idle(int cpu)
@@ -4322,7 +4415,8 @@ static void __sched_fork(unsigned long clone_flags, struct task_struct *p)
 	p->se.nr_migrations		= 0;
 	p->se.vruntime			= 0;
 	p->se.vlag			= 0;
-	p->se.slice			= sysctl_sched_base_slice;
+	if (!p->se.custom_slice)
+		p->se.slice		= sysctl_sched_base_slice;
 	INIT_LIST_HEAD(&p->se.group_node);
 
 #ifdef CONFIG_FAIR_GROUP_SCHED
@@ -4570,6 +4664,9 @@ int sched_fork(unsigned long clone_flags, struct task_struct *p)
 		} else if (PRIO_TO_NICE(p->static_prio) < 0)
 			p->static_prio = NICE_TO_PRIO(0);
 
+		p->se.custom_slice = 0;
+		p->se.slice = sysctl_sched_base_slice;
+
 		p->prio = p->normal_prio = p->static_prio;
 		set_load_weight(p, false);
 
@@ -8314,6 +8411,7 @@ void __init sched_init(void)
 #ifdef CONFIG_HOTPLUG_CPU
 		rcuwait_init(&rq->hotplug_wait);
 #endif
+		wake_batch_init(i);
 #endif /* CONFIG_SMP */
 		hrtick_rq_init(rq);
 		atomic_set(&rq->nr_iowait, 0);
@@ -9446,6 +9544,21 @@ static int cpu_idle_write_s64(struct cgroup_subsys_state *css,
 {
 	return sched_group_set_idle(css_tg(css), idle);
 }
+
+static u64 cpu_latency_slice_read_u64(struct cgroup_subsys_state *css,
+				      struct cftype *cft)
+{
+	return div_u64(css_tg(css)->slice, NSEC_PER_USEC);
+}
+
+static int cpu_latency_slice_write_u64(struct cgroup_subsys_state *css,
+				       struct cftype *cft, u64 slice_us)
+{
+	if (slice_us > div_u64(SCHED_SLICE_MAX, NSEC_PER_USEC))
+		return -EINVAL;
+
+	return sched_group_set_slice(css_tg(css), slice_us * NSEC_PER_USEC);
+}
 #endif
 
 static struct cftype cpu_legacy_files[] = {
@@ -9533,9 +9646,17 @@ static int cpu_extra_stat_show(struct seq_file *sf,
 			   "nr_throttled %d\n"
 			   "throttled_usec %llu\n"
 			   "nr_bursts %d\n"
-			   "burst_usec %llu\n",
+			   "burst_usec %llu\n"
+			   "throttle_events_lt_1ms %u\n"
+			   "throttle_events_lt_10ms %u\n"
+			   "throttle_events_lt_100ms %u\n"
+			   "throttle_events_ge_100ms %u\n",
 			   cfs_b->nr_periods, cfs_b->nr_throttled,
-			   throttled_usec, cfs_b->nr_burst, burst_usec);
+			   throttled_usec, cfs_b->nr_burst, burst_usec,
+			   cfs_b->throttle_events_hist[0],
+			   cfs_b->throttle_events_hist[1],
+			   cfs_b->throttle_events_hist[2],
+			   cfs_b->throttle_events_hist[3]);
 	}
 #endif
 	return 0;
@@ -9699,6 +9820,12 @@ static struct cftype cpu_files[] = {
 		.read_s64 = cpu_idle_read_s64,
 		.write_s64 = cpu_idle_write_s64,
 	},
+	{
+		.name = "latency_slice",
+		.flags = CFTYPE_NOT_ON_ROOT,
+		.read_u64 = cpu_latency_slice_read_u64,
+		.write_u64 = cpu_latency_slice_write_u64,
+	},
 #endif
 #ifdef CONFIG_CFS_BANDWIDTH
 	{
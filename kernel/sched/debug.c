@@ -408,6 +408,27 @@ static const struct file_operations sd_flags_fops = {
 	.release	= single_release,
 };
 
+#ifdef CONFIG_SCHEDSTATS
+static int sd_newidle_hist_show(struct seq_file *m, void *v)
+{
+	struct sched_domain *sd = m->private;
+	int i;
+
+	seq_printf(m, "ratio %u/%u skipped %u\n",
+		   sd->newidle_ratio, NEWIDLE_RATIO_ONE, sd->newidle_skipped);
+	seq_puts(m, "cost_us pulled failed\n");
+	for (i = 0; i < SD_NEWIDLE_HIST_BUCKETS; i++) {
+		seq_printf(m, "%s%lu %u %u\n",
+			   i == SD_NEWIDLE_HIST_BUCKETS - 1 ? ">=" : "<",
+			   i == SD_NEWIDLE_HIST_BUCKETS - 1 ? 1UL << (i - 1) : 1UL << i,
+			   sd->newidle_hist_pulled[i], sd->newidle_hist_failed[i]);
+	}
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(sd_newidle_hist);
+#endif
+
 static void register_sd(struct sched_domain *sd, struct dentry *parent)
 {
 #define SDM(type, mode, member)	\
@@ -426,6 +447,9 @@ static void register_sd(struct sched_domain *sd, struct dentry *parent)
 	debugfs_create_file("flags", 0444, parent, &sd->flags, &sd_flags_fops);
 	debugfs_create_file("groups_flags", 0444, parent, &sd->groups->flags, &sd_flags_fops);
 	debugfs_create_u32("level", 0444, parent, (u32 *)&sd->level);
+#ifdef CONFIG_SCHEDSTATS
+	debugfs_create_file("newidle_hist", 0444, parent, sd, &sd_newidle_hist_fops);
+#endif
 }
 
 void update_sched_domain_debugfs(void)
@@ -969,6 +993,14 @@ void print_numa_stats(struct seq_file *m, int node, unsigned long tsf,
 	SEQ_printf(m, "task_private=%lu task_shared=%lu ", tpf, tsf);
 	SEQ_printf(m, "group_private=%lu group_shared=%lu\n", gpf, gsf);
 }
+
+void print_numa_group_stats(struct seq_file *m, pid_t gid, int nr_tasks,
+			    int active_nodes, unsigned long shared_joins)
+{
+	SEQ_printf(m, "numa_group gid=%d nr_tasks=%d active_nodes=%d ",
+		   gid, nr_tasks, active_nodes);
+	SEQ_printf(m, "shared_joins=%lu\n", shared_joins);
+}
 #endif
 
 
@@ -1004,6 +1036,8 @@ void proc_sched_show_task(struct task_struct *p, struct pid_namespace *ns,
 	PN(se.exec_start);
 	PN(se.vruntime);
 	PN(se.sum_exec_runtime);
+	PN(se.slice);
+	P(se.custom_slice);
 
 	nr_switches = p->nvcsw + p->nivcsw;
 
@@ -39,6 +39,7 @@
 #include <linux/sched/nohz.h>
 
 #include <linux/cpuidle.h>
+#include <linux/hash.h>
 #include <linux/interrupt.h>
 #include <linux/memory-tiers.h>
 #include <linux/mempolicy.h>
@@ -50,6 +51,7 @@
 #include <linux/rbtree_augmented.h>
 
 #include <asm/switch_to.h>
+#include <asm/tlb.h>
 
 #include "sched.h"
 #include "stats.h"
@@ -936,6 +938,13 @@ static struct sched_entity *pick_eevdf(struct cfs_rq *cfs_rq)
 	if (!best || (curr && entity_before(curr, best)))
 		best = curr;
 
+	if (trace_sched_pick_eevdf_enabled() && best && entity_is_task(best)) {
+		trace_sched_pick_eevdf(task_of(best),
+				       avg_vruntime(cfs_rq) - best->vruntime,
+				       best->deadline,
+				       entity_eligible(cfs_rq, best));
+	}
+
 	return best;
 }
 
@@ -982,15 +991,21 @@ static void update_deadline(struct cfs_rq *cfs_rq, struct sched_entity *se)
 	/*
 	 * For EEVDF the virtual time slope is determined by w_i (iow.
 	 * nice) while the request time r_i is determined by
-	 * sysctl_sched_base_slice.
+	 * sysctl_sched_base_slice, unless a custom slice was requested
+	 * through sched_attr::sched_runtime or cpu.latency_slice.
 	 */
-	se->slice = sysctl_sched_base_slice;
+	if (!se->custom_slice)
+		se->slice = sysctl_sched_base_slice;
 
 	/*
 	 * EEVDF: vd_i = ve_i + r_i / w_i
 	 */
 	se->deadline = se->vruntime + calc_delta_fair(se->slice, se);
 
+	if (entity_is_task(se))
+		trace_sched_update_deadline(task_of(se), se->slice,
+					    se->vruntime, se->deadline);
+
 	/*
 	 * The task has consumed its request, reschedule.
 	 */
@@ -1378,6 +1393,10 @@ struct numa_group {
 	struct rcu_head rcu;
 	unsigned long total_faults;
 	unsigned long max_faults_cpu;
+	/* tasks that joined through a shared mapping, see task_numa_shared_group() */
+	unsigned long nr_shared_joins;
+	/* published in numa_shared_groups[] at some point */
+	bool shared;
 	/*
 	 * faults[] array is split into two regions: faults_mem and faults_cpu.
 	 *
@@ -2914,44 +2933,95 @@ static inline int get_numa_group(struct numa_group *grp)
 	return refcount_inc_not_zero(&grp->refcount);
 }
 
+static void numa_shared_group_unpublish(struct numa_group *grp);
+
 static inline void put_numa_group(struct numa_group *grp)
 {
-	if (refcount_dec_and_test(&grp->refcount))
+	if (refcount_dec_and_test(&grp->refcount)) {
+		if (grp->shared)
+			numa_shared_group_unpublish(grp);
 		kfree_rcu(grp, rcu);
+	}
 }
 
-static void task_numa_group(struct task_struct *p, int cpupid, int flags,
-			int *priv)
+/*
+ * Make sure current has a numa_group, creating a singleton one from its own
+ * fault statistics if needed.
+ */
+static bool task_numa_group_init(struct task_struct *p)
 {
-	struct numa_group *grp, *my_grp;
-	struct task_struct *tsk;
-	bool join = false;
-	int cpu = cpupid_to_cpu(cpupid);
+	struct numa_group *grp;
+	unsigned int size;
 	int i;
 
-	if (unlikely(!deref_curr_numa_group(p))) {
-		unsigned int size = sizeof(struct numa_group) +
-				    NR_NUMA_HINT_FAULT_STATS *
-				    nr_node_ids * sizeof(unsigned long);
+	if (likely(deref_curr_numa_group(p)))
+		return true;
 
-		grp = kzalloc(size, GFP_KERNEL | __GFP_NOWARN);
-		if (!grp)
-			return;
+	size = sizeof(struct numa_group) +
+	       NR_NUMA_HINT_FAULT_STATS * nr_node_ids * sizeof(unsigned long);
 
-		refcount_set(&grp->refcount, 1);
-		grp->active_nodes = 1;
-		grp->max_faults_cpu = 0;
-		spin_lock_init(&grp->lock);
-		grp->gid = p->pid;
+	grp = kzalloc(size, GFP_KERNEL | __GFP_NOWARN);
+	if (!grp)
+		return false;
 
-		for (i = 0; i < NR_NUMA_HINT_FAULT_STATS * nr_node_ids; i++)
-			grp->faults[i] = p->numa_faults[i];
+	refcount_set(&grp->refcount, 1);
+	grp->active_nodes = 1;
+	grp->max_faults_cpu = 0;
+	spin_lock_init(&grp->lock);
+	grp->gid = p->pid;
+
+	for (i = 0; i < NR_NUMA_HINT_FAULT_STATS * nr_node_ids; i++)
+		grp->faults[i] = p->numa_faults[i];
+
+	grp->total_faults = p->total_numa_faults;
+
+	grp->nr_tasks++;
+	rcu_assign_pointer(p->numa_group, grp);
 
-		grp->total_faults = p->total_numa_faults;
+	return true;
+}
+
+/*
+ * Move current from @my_grp into @grp, the caller holds a reference on @grp
+ * which is transferred to p->numa_group.
+ */
+static void task_numa_group_join(struct task_struct *p,
+				 struct numa_group *my_grp,
+				 struct numa_group *grp)
+{
+	int i;
 
-		grp->nr_tasks++;
-		rcu_assign_pointer(p->numa_group, grp);
+	WARN_ON_ONCE(irqs_disabled());
+	double_lock_irq(&my_grp->lock, &grp->lock);
+
+	for (i = 0; i < NR_NUMA_HINT_FAULT_STATS * nr_node_ids; i++) {
+		my_grp->faults[i] -= p->numa_faults[i];
+		grp->faults[i] += p->numa_faults[i];
 	}
+	my_grp->total_faults -= p->total_numa_faults;
+	grp->total_faults += p->total_numa_faults;
+
+	my_grp->nr_tasks--;
+	grp->nr_tasks++;
+
+	spin_unlock(&my_grp->lock);
+	spin_unlock_irq(&grp->lock);
+
+	rcu_assign_pointer(p->numa_group, grp);
+
+	put_numa_group(my_grp);
+}
+
+static void task_numa_group(struct task_struct *p, int cpupid, int flags,
+			int *priv)
+{
+	struct numa_group *grp, *my_grp;
+	struct task_struct *tsk;
+	bool join = false;
+	int cpu = cpupid_to_cpu(cpupid);
+
+	if (!task_numa_group_init(p))
+		return;
 
 	rcu_read_lock();
 	tsk = READ_ONCE(cpu_rq(cpu)->curr);
@@ -2999,30 +3069,160 @@ static void task_numa_group(struct task_struct *p, int cpupid, int flags,
 	if (!join)
 		return;
 
-	WARN_ON_ONCE(irqs_disabled());
-	double_lock_irq(&my_grp->lock, &grp->lock);
+	task_numa_group_join(p, my_grp, grp);
+	return;
 
-	for (i = 0; i < NR_NUMA_HINT_FAULT_STATS * nr_node_ids; i++) {
-		my_grp->faults[i] -= p->numa_faults[i];
-		grp->faults[i] += p->numa_faults[i];
+no_join:
+	rcu_read_unlock();
+	return;
+}
+
+/*
+ * Opt-in (PR_SET_NUMA_SHARED_GROUP) grouping of tasks that share a file
+ * backed mapping, such as a memfd or shmem segment, but not an mm.
+ *
+ * task_numa_group() only finds the last task that touched a folio if that
+ * task is running on its CPU at the time of the fault, which rarely happens
+ * for independent processes. Instead remember one numa_group per backing
+ * address_space in a small hash table and have opted-in tasks join it on
+ * their first shared fault; a colliding mapping simply evicts the previous
+ * entry.
+ *
+ * The table holds no reference: an entry is removed when its group is freed
+ * or its inode evicted, whichever comes first. Entries are immutable and
+ * only ever removed with xchg()/cmpxchg(), so exactly one remover frees each.
+ */
+#define NUMA_SHARED_GROUP_BITS	8
+
+struct numa_shared_entry {
+	struct address_space	*mapping;
+	struct numa_group	*grp;
+	struct rcu_head		rcu;
+};
+
+static struct numa_shared_entry __rcu *numa_shared_groups[1 << NUMA_SHARED_GROUP_BITS];
+/* Serializes publishing, so that racing faults agree on one group */
+static DEFINE_SPINLOCK(numa_shared_lock);
+
+static void numa_shared_entry_remove(struct numa_shared_entry __rcu **slot,
+				     struct numa_shared_entry *entry)
+{
+	if (cmpxchg((struct numa_shared_entry **)slot, entry, NULL) == entry)
+		kfree_rcu(entry, rcu);
+}
+
+/* @grp is being freed, drop the entries still pointing to it */
+static void numa_shared_group_unpublish(struct numa_group *grp)
+{
+	struct numa_shared_entry *entry;
+	int i;
+
+	rcu_read_lock();
+	for (i = 0; i < ARRAY_SIZE(numa_shared_groups); i++) {
+		entry = rcu_dereference(numa_shared_groups[i]);
+		if (entry && entry->grp == grp)
+			numa_shared_entry_remove(&numa_shared_groups[i], entry);
 	}
-	my_grp->total_faults -= p->total_numa_faults;
-	grp->total_faults += p->total_numa_faults;
+	rcu_read_unlock();
+}
 
-	my_grp->nr_tasks--;
-	grp->nr_tasks++;
+/**
+ * numa_shared_group_forget - forget the numa_group of a mapping
+ * @mapping: the address_space of an inode being evicted
+ *
+ * The table is keyed on the address_space pointer, which may be reused for
+ * another inode once this one is freed.
+ */
+void numa_shared_group_forget(struct address_space *mapping)
+{
+	struct numa_shared_entry __rcu **slot;
+	struct numa_shared_entry *entry;
 
-	spin_unlock(&my_grp->lock);
-	spin_unlock_irq(&grp->lock);
+	slot = &numa_shared_groups[hash_ptr(mapping, NUMA_SHARED_GROUP_BITS)];
 
-	rcu_assign_pointer(p->numa_group, grp);
+	rcu_read_lock();
+	entry = rcu_dereference(*slot);
+	if (entry && entry->mapping == mapping)
+		numa_shared_entry_remove(slot, entry);
+	rcu_read_unlock();
+}
 
-	put_numa_group(my_grp);
-	return;
+/*
+ * Return a referenced group keyed on @mapping, or NULL if @my_grp already is
+ * (or has just been published as) the group for @mapping.
+ */
+static struct numa_group *numa_shared_group_get(struct address_space *mapping,
+						struct numa_group *my_grp)
+{
+	struct numa_shared_entry __rcu **slot;
+	struct numa_shared_entry *entry, *new;
+	struct numa_group *grp;
 
-no_join:
+	slot = &numa_shared_groups[hash_ptr(mapping, NUMA_SHARED_GROUP_BITS)];
+
+	rcu_read_lock();
+	entry = rcu_dereference(*slot);
+	if (entry && entry->mapping == mapping) {
+		grp = entry->grp;
+		if (grp == my_grp) {
+			rcu_read_unlock();
+			return NULL;
+		}
+		if (get_numa_group(grp)) {
+			rcu_read_unlock();
+			return grp;
+		}
+	}
 	rcu_read_unlock();
-	return;
+
+	new = kmalloc(sizeof(*new), GFP_KERNEL | __GFP_NOWARN);
+	if (!new)
+		return NULL;
+	new->mapping = mapping;
+	new->grp = my_grp;
+
+	spin_lock(&numa_shared_lock);
+	entry = rcu_dereference_protected(*slot,
+				lockdep_is_held(&numa_shared_lock));
+	if (entry && entry->mapping == mapping && get_numa_group(entry->grp)) {
+		/* Somebody else published a group meanwhile. */
+		grp = entry->grp;
+		spin_unlock(&numa_shared_lock);
+		kfree(new);
+		return grp;
+	}
+
+	/* Our caller holds a reference, @my_grp cannot be going away */
+	my_grp->shared = true;
+	entry = unrcu_pointer(xchg(slot, RCU_INITIALIZER(new)));
+	spin_unlock(&numa_shared_lock);
+
+	if (entry)
+		kfree_rcu(entry, rcu);
+
+	return NULL;
+}
+
+static void task_numa_shared_group(struct task_struct *p,
+				   struct address_space *mapping)
+{
+	struct numa_group *grp, *my_grp;
+
+	if (!task_numa_group_init(p))
+		return;
+
+	my_grp = deref_curr_numa_group(p);
+	grp = numa_shared_group_get(mapping, my_grp);
+	if (!grp)
+		return;
+
+	if (grp == my_grp) {
+		put_numa_group(grp);
+		return;
+	}
+
+	task_numa_group_join(p, my_grp, grp);
+	WRITE_ONCE(grp->nr_shared_joins, grp->nr_shared_joins + 1);
 }
 
 /*
@@ -3068,7 +3268,8 @@ void task_numa_free(struct task_struct *p, bool final)
 /*
  * Got a PROT_NONE fault for a page on @node.
  */
-void task_numa_fault(int last_cpupid, int mem_node, int pages, int flags)
+void task_numa_fault(int last_cpupid, int mem_node, int pages, int flags,
+		     struct address_space *mapping)
 {
 	struct task_struct *p = current;
 	bool migrated = flags & TNF_MIGRATED;
@@ -3106,6 +3307,13 @@ void task_numa_fault(int last_cpupid, int mem_node, int pages, int flags)
 		memset(p->numa_faults_locality, 0, sizeof(p->numa_faults_locality));
 	}
 
+	/*
+	 * Tasks that opted into grouping by shared backing object join the
+	 * group of @mapping regardless of who touched the folio last.
+	 */
+	if (mapping && p->numa_shared_group && !(flags & TNF_NO_GROUP))
+		task_numa_shared_group(p, mapping);
+
 	/*
 	 * First accesses are treated as private, otherwise consider accesses
 	 * to be private if the accessing pid has not changed
@@ -3205,9 +3413,10 @@ static void task_numa_work(struct callback_head *work)
 	u64 runtime = p->se.sum_exec_runtime;
 	struct vm_area_struct *vma;
 	unsigned long start, end;
-	unsigned long nr_pte_updates = 0;
+	unsigned long nr_pte_updates = 0, total_updates = 0;
 	long pages, virtpages;
 	struct vma_iterator vmi;
+	struct mmu_gather tlb;
 	bool vma_pids_skipped;
 	bool vma_pids_forced = false;
 
@@ -3262,6 +3471,9 @@ static void task_numa_work(struct callback_head *work)
 	if (!mmap_read_trylock(mm))
 		return;
 
+	/* One TLB flush for everything changed below, see change_prot_numa() */
+	tlb_gather_mmu(&tlb, mm);
+
 	/*
 	 * VMAs are skipped if the current PID has not trapped a fault within
 	 * the VMA recently. Allow scanning to be forced if there is no
@@ -3372,7 +3584,8 @@ static void task_numa_work(struct callback_head *work)
 			start = max(start, vma->vm_start);
 			end = ALIGN(start + (pages << PAGE_SHIFT), HPAGE_SIZE);
 			end = min(end, vma->vm_end);
-			nr_pte_updates = change_prot_numa(vma, start, end);
+			nr_pte_updates = change_prot_numa(&tlb, vma, start, end);
+			total_updates += nr_pte_updates;
 
 			/*
 			 * Try to scan sysctl_numa_balancing_size worth of
@@ -3425,6 +3638,10 @@ static void task_numa_work(struct callback_head *work)
 		mm->numa_scan_offset = start;
 	else
 		reset_ptenuma_scan(p);
+
+	tlb_finish_mmu(&tlb);
+	if (total_updates)
+		count_vm_numa_event(NUMA_TLB_FLUSH);
 	mmap_read_unlock(mm);
 
 	/*
@@ -5178,7 +5395,8 @@ place_entity(struct cfs_rq *cfs_rq, struct sched_entity *se, int flags)
 	u64 vslice, vruntime = avg_vruntime(cfs_rq);
 	s64 lag = 0;
 
-	se->slice = sysctl_sched_base_slice;
+	if (!se->custom_slice)
+		se->slice = sysctl_sched_base_slice;
 	vslice = calc_delta_fair(se->slice, se);
 
 	/*
@@ -5585,6 +5803,35 @@ static inline u64 sched_cfs_bandwidth_slice(void)
 	return (u64)sysctl_sched_cfs_bandwidth_slice * NSEC_PER_USEC;
 }
 
+/*
+ * The runtime a cfs_rq takes from the global pool at a time.  With a quota
+ * smaller than slice * nr_cpus, full slices let a few CPUs drain the pool
+ * while the group's threads on the other CPUs are throttled right away, so
+ * shrink the slice towards an even share of the quota, but not below 1ms.
+ */
+static inline u64 cfs_bandwidth_slice(struct cfs_bandwidth *cfs_b)
+{
+	u64 slice = sched_cfs_bandwidth_slice();
+	u64 share;
+
+	if (cfs_b->quota == RUNTIME_INF)
+		return slice;
+
+	share = div_u64(cfs_b->quota, num_online_cpus());
+	return clamp(share, min_t(u64, slice, NSEC_PER_MSEC), slice);
+}
+
+static inline unsigned int cfs_throttle_hist_bucket(u64 delta)
+{
+	if (delta < NSEC_PER_MSEC)
+		return 0;
+	if (delta < 10 * NSEC_PER_MSEC)
+		return 1;
+	if (delta < 100 * NSEC_PER_MSEC)
+		return 2;
+	return 3;
+}
+
 /*
  * Replenish runtime according to assigned quota. We use sched_clock_cpu
  * directly instead of rq->clock to avoid adding additional synchronization
@@ -5650,7 +5897,7 @@ static int assign_cfs_rq_runtime(struct cfs_rq *cfs_rq)
 	int ret;
 
 	raw_spin_lock(&cfs_b->lock);
-	ret = __assign_cfs_rq_runtime(cfs_b, cfs_rq, sched_cfs_bandwidth_slice());
+	ret = __assign_cfs_rq_runtime(cfs_b, cfs_rq, cfs_bandwidth_slice(cfs_b));
 	raw_spin_unlock(&cfs_b->lock);
 
 	return ret;
@@ -5863,7 +6110,10 @@ void unthrottle_cfs_rq(struct cfs_rq *cfs_rq)
 
 	raw_spin_lock(&cfs_b->lock);
 	if (cfs_rq->throttled_clock) {
-		cfs_b->throttled_time += rq_clock(rq) - cfs_rq->throttled_clock;
+		u64 delta = rq_clock(rq) - cfs_rq->throttled_clock;
+
+		cfs_b->throttled_time += delta;
+		cfs_b->throttle_events_hist[cfs_throttle_hist_bucket(delta)]++;
 		cfs_rq->throttled_clock = 0;
 	}
 	list_del_rcu(&cfs_rq->throttled_list);
@@ -7265,6 +7515,37 @@ static inline int __select_idle_cpu(int cpu, struct task_struct *p)
 	return -1;
 }
 
+/*
+ * Record whether @rq is running its idle task in the LLC-wide idle mask
+ * consumed by select_idle_cpu(). Only touch the shared cacheline when the
+ * bit actually changes.
+ */
+void update_idle_cpumask(struct rq *rq, bool idle)
+{
+	struct sched_domain_shared *sds;
+	int cpu = cpu_of(rq);
+	struct cpumask *mask;
+
+	if (!sched_feat(SIS_IDLE_MASK))
+		return;
+
+	rcu_read_lock();
+	sds = rcu_dereference(per_cpu(sd_llc_shared, cpu));
+	if (!sds)
+		goto unlock;
+
+	mask = sds_idle_cpus(sds);
+	if (cpumask_test_cpu(cpu, mask) == idle)
+		goto unlock;
+
+	if (idle)
+		cpumask_set_cpu(cpu, mask);
+	else
+		cpumask_clear_cpu(cpu, mask);
+unlock:
+	rcu_read_unlock();
+}
+
 #ifdef CONFIG_SCHED_SMT
 DEFINE_STATIC_KEY_FALSE(sched_smt_present);
 EXPORT_SYMBOL_GPL(sched_smt_present);
@@ -7407,17 +7688,38 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 	struct cpumask *cpus = this_cpu_cpumask_var_ptr(select_rq_mask);
 	int i, cpu, idle_cpu = -1, nr = INT_MAX;
 	struct sched_domain_shared *sd_share;
+	bool idle_mask = false;
 
 	cpumask_and(cpus, sched_domain_span(sd), p->cpus_ptr);
 
-	if (sched_feat(SIS_UTIL)) {
-		sd_share = rcu_dereference(per_cpu(sd_llc_shared, target));
-		if (sd_share) {
-			/* because !--nr is the condition to stop scan */
-			nr = READ_ONCE(sd_share->nr_idle_scan) + 1;
-			/* overloaded LLC is unlikely to have idle cpu/core */
-			if (nr == 1)
-				return -1;
+	sd_share = rcu_dereference(per_cpu(sd_llc_shared, target));
+
+	if (sched_feat(SIS_UTIL) && sd_share) {
+		/* because !--nr is the condition to stop scan */
+		nr = READ_ONCE(sd_share->nr_idle_scan) + 1;
+		/* overloaded LLC is unlikely to have idle cpu/core */
+		if (nr == 1)
+			return -1;
+	}
+
+	/*
+	 * Only visit the CPUs that went idle since they last ran a task;
+	 * every candidate is still validated by __select_idle_cpu() or
+	 * select_idle_core(), the mask merely prunes the walk.
+	 */
+	if (sched_feat(SIS_IDLE_MASK) && sd_share) {
+		unsigned int nr_span = 0;
+
+		if (schedstat_enabled())
+			nr_span = cpumask_weight(cpus);
+
+		cpumask_and(cpus, cpus, sds_idle_cpus(sd_share));
+		idle_mask = true;
+
+		if (schedstat_enabled()) {
+			schedstat_inc(sd->sis_mask_count);
+			schedstat_add(sd->sis_mask_avoided,
+				      nr_span - cpumask_weight(cpus));
 		}
 	}
 
@@ -7463,6 +7765,24 @@ static int select_idle_cpu(struct task_struct *p, struct sched_domain *sd, bool
 	if (has_idle_core)
 		set_idle_cores(target, false);
 
+	/*
+	 * The idle mask only has the CPUs running their idle task. A CPU that
+	 * runs nothing but SCHED_IDLE tasks is as good a target, so look among
+	 * the rest of the LLC before giving up.
+	 */
+	if (idle_mask && idle_cpu == -1) {
+		cpumask_and(cpus, sched_domain_span(sd), p->cpus_ptr);
+		cpumask_andnot(cpus, cpus, sds_idle_cpus(sd_share));
+
+		for_each_cpu_wrap(cpu, cpus, target + 1) {
+			if (--nr <= 0)
+				return -1;
+			idle_cpu = __select_idle_cpu(cpu, p);
+			if ((unsigned int)idle_cpu < nr_cpumask_bits)
+				break;
+		}
+	}
+
 	return idle_cpu;
 }
 
@@ -11734,12 +12054,57 @@ static inline bool update_newidle_cost(struct sched_domain *sd, u64 cost)
 		sd->max_newidle_lb_cost = (sd->max_newidle_lb_cost * 253) / 256;
 		sd->last_decay_max_lb_cost = jiffies;
 
+		/*
+		 * Likewise let the success ratio drift back up, so that a
+		 * domain which stopped being tried gets another chance.
+		 */
+		sd->newidle_ratio += (NEWIDLE_RATIO_ONE - sd->newidle_ratio) >> 3;
+
 		return true;
 	}
 
 	return false;
 }
 
+/*
+ * Idle time we expect to need before newidle balancing @sd is worth it.
+ *
+ * The raw cost is sd->max_newidle_lb_cost, but an attempt only pays off when
+ * it actually pulls something. Inflate the cost by the inverse of the recent
+ * success ratio (capped at 32x), so that domains which keep failing, usually
+ * the wide NUMA ones, need proportionally longer expected idle periods.
+ */
+static inline u64 newidle_lb_budget(struct sched_domain *sd)
+{
+	unsigned int ratio = max(sd->newidle_ratio, NEWIDLE_RATIO_ONE >> 5);
+
+	if (!sched_feat(NEWIDLE_BUDGET))
+		return sd->max_newidle_lb_cost;
+
+	return div_u64(sd->max_newidle_lb_cost << NEWIDLE_RATIO_SHIFT, ratio);
+}
+
+static inline void update_newidle_ratio(struct sched_domain *sd, u64 cost,
+					bool pulled)
+{
+	/* EWMA with a 1/8 weight for the latest attempt */
+	sd->newidle_ratio -= sd->newidle_ratio >> 3;
+	if (pulled)
+		sd->newidle_ratio += NEWIDLE_RATIO_ONE >> 3;
+
+#ifdef CONFIG_SCHEDSTATS
+	if (schedstat_enabled()) {
+		int idx = min_t(int, fls64(div_u64(cost, NSEC_PER_USEC)),
+				SD_NEWIDLE_HIST_BUCKETS - 1);
+
+		if (pulled)
+			__schedstat_inc(sd->newidle_hist_pulled[idx]);
+		else
+			__schedstat_inc(sd->newidle_hist_failed[idx]);
+	}
+#endif
+}
+
 /*
  * It checks each scheduling domain to see if it is due to be balanced,
  * and initiates a balancing operation if so.
@@ -12396,7 +12761,7 @@ static int sched_balance_newidle(struct rq *this_rq, struct rq_flags *rf)
 	sd = rcu_dereference_check_sched_domain(this_rq->sd);
 
 	if (!get_rd_overloaded(this_rq->rd) ||
-	    (sd && this_rq->avg_idle < sd->max_newidle_lb_cost)) {
+	    (sd && this_rq->avg_idle < newidle_lb_budget(sd))) {
 
 		if (sd)
 			update_next_balance(sd, &next_balance);
@@ -12417,8 +12782,10 @@ static int sched_balance_newidle(struct rq *this_rq, struct rq_flags *rf)
 
 		update_next_balance(sd, &next_balance);
 
-		if (this_rq->avg_idle < curr_cost + sd->max_newidle_lb_cost)
+		if (this_rq->avg_idle < curr_cost + newidle_lb_budget(sd)) {
+			schedstat_inc(sd->newidle_skipped);
 			break;
+		}
 
 		if (sd->flags & SD_BALANCE_NEWIDLE) {
 
@@ -12429,6 +12796,7 @@ static int sched_balance_newidle(struct rq *this_rq, struct rq_flags *rf)
 			t1 = sched_clock_cpu(this_cpu);
 			domain_cost = t1 - t0;
 			update_newidle_cost(sd, domain_cost);
+			update_newidle_ratio(sd, domain_cost, pulled_task > 0);
 
 			curr_cost += domain_cost;
 			t0 = t1;
@@ -13091,6 +13459,35 @@ int sched_group_set_shares(struct task_group *tg, unsigned long shares)
 	return ret;
 }
 
+int sched_group_set_slice(struct task_group *tg, u64 slice)
+{
+	int i;
+
+	if (tg == &root_task_group)
+		return -EINVAL;
+
+	if (slice && (slice < SCHED_SLICE_MIN || slice > SCHED_SLICE_MAX))
+		return -EINVAL;
+
+	mutex_lock(&shares_mutex);
+	tg->slice = slice;
+
+	for_each_possible_cpu(i) {
+		struct sched_entity *se = tg->se[i];
+		struct rq *rq = cpu_rq(i);
+		struct rq_flags rf;
+
+		/* Takes effect on the next deadline update or placement. */
+		rq_lock_irqsave(rq, &rf);
+		se->custom_slice = !!slice;
+		se->slice = slice ?: sysctl_sched_base_slice;
+		rq_unlock_irqrestore(rq, &rf);
+	}
+
+	mutex_unlock(&shares_mutex);
+	return 0;
+}
+
 int sched_group_set_idle(struct task_group *tg, long idle)
 {
 	int i;
@@ -13255,6 +13652,11 @@ void show_numa_stats(struct task_struct *p, struct seq_file *m)
 
 	rcu_read_lock();
 	ng = rcu_dereference(p->numa_group);
+	if (ng) {
+		print_numa_group_stats(m, ng->gid, READ_ONCE(ng->nr_tasks),
+				       READ_ONCE(ng->active_nodes),
+				       READ_ONCE(ng->nr_shared_joins));
+	}
 	for_each_online_node(node) {
 		if (p->numa_faults) {
 			tsf = p->numa_faults[task_faults_idx(NUMA_MEM, node, 0)];
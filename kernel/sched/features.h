@@ -51,6 +51,18 @@ SCHED_FEAT(TTWU_QUEUE, true)
  */
 SCHED_FEAT(SIS_UTIL, true)
 
+/*
+ * Restrict select_idle_cpu() to the CPUs recorded as idle in
+ * sd_llc_shared->idle_cpus instead of scanning the entire LLC.
+ */
+SCHED_FEAT(SIS_IDLE_MASK, true)
+
+/*
+ * Scale the newidle balance cost of a domain by the inverse of its recent
+ * pull success ratio.
+ */
+SCHED_FEAT(NEWIDLE_BUDGET, true)
+
 /*
  * Issue a WARN when we do multiple update_rq_clock() calls
  * in a single rq->lock section. Default disabled because the
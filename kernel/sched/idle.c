@@ -452,10 +452,12 @@ static void wakeup_preempt_idle(struct rq *rq, struct task_struct *p, int flags)
 
 static void put_prev_task_idle(struct rq *rq, struct task_struct *prev)
 {
+	update_idle_cpumask(rq, false);
 }
 
 static void set_next_task_idle(struct rq *rq, struct task_struct *next, bool first)
 {
+	update_idle_cpumask(rq, true);
 	update_idle_core(rq);
 	schedstat_inc(rq->sched_goidle);
 }
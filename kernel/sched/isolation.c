@@ -23,6 +23,15 @@ enum hk_flags {
 DEFINE_STATIC_KEY_FALSE(housekeeping_overridden);
 EXPORT_SYMBOL_GPL(housekeeping_overridden);
 
+/*
+ * "isolcpus=strict,..." keeps deferrable per-CPU housekeeping work off the
+ * isolated CPUs even where that work is normally queued on every CPU, at
+ * the price of leaving per-CPU caches on them undrained until they drain
+ * themselves.
+ */
+DEFINE_STATIC_KEY_FALSE(housekeeping_strict);
+static bool housekeeping_strict_setup __initdata;
+
 struct housekeeping {
 	cpumask_var_t cpumasks[HK_TYPE_MAX];
 	unsigned long flags;
@@ -96,6 +105,8 @@ void __init housekeeping_init(void)
 		return;
 
 	static_branch_enable(&housekeeping_overridden);
+	if (housekeeping_strict_setup)
+		static_branch_enable(&housekeeping_strict);
 
 	if (housekeeping.flags & HK_FLAG_TICK)
 		sched_tick_offload_init();
@@ -228,6 +239,12 @@ static int __init housekeeping_isolcpus_setup(char *str)
 			continue;
 		}
 
+		if (!strncmp(str, "strict,", 7)) {
+			str += 7;
+			housekeeping_strict_setup = true;
+			continue;
+		}
+
 		/*
 		 * Skip unknown sub-parameter and validate that it is not
 		 * containing an invalid character.
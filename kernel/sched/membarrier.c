@@ -311,7 +311,30 @@ static int membarrier_global_expedited(void)
 	return 0;
 }
 
-static int membarrier_private_expedited(int flags, int cpu_id)
+static int membarrier_get_user_cpumask(const unsigned long __user *user_mask,
+				       unsigned int len, struct cpumask *mask)
+{
+	if (len < cpumask_size())
+		cpumask_clear(mask);
+	else if (len > cpumask_size())
+		len = cpumask_size();
+
+#ifdef CONFIG_COMPAT
+	if (in_compat_syscall())
+		return compat_get_bitmap(cpumask_bits(mask),
+					 (const compat_ulong_t __user *)user_mask,
+					 len * BITS_PER_BYTE);
+#endif
+	return copy_from_user(mask, user_mask, len) ? -EFAULT : 0;
+}
+
+/*
+ * @user_mask, if not NULL, is a user-supplied mask of @len bytes restricting
+ * the CPUs to IPI, in which case @cpu_id is -1.
+ */
+static int membarrier_private_expedited(int flags, int cpu_id,
+					const unsigned long __user *user_mask,
+					unsigned int len)
 {
 	cpumask_var_t tmpmask;
 	struct mm_struct *mm = current->mm;
@@ -356,6 +379,15 @@ static int membarrier_private_expedited(int flags, int cpu_id)
 	if (cpu_id < 0 && !zalloc_cpumask_var(&tmpmask, GFP_KERNEL))
 		return -ENOMEM;
 
+	if (user_mask) {
+		int ret = membarrier_get_user_cpumask(user_mask, len, tmpmask);
+
+		if (ret) {
+			free_cpumask_var(tmpmask);
+			return ret;
+		}
+	}
+
 	SERIALIZE_IPI();
 	cpus_read_lock();
 
@@ -371,6 +403,24 @@ static int membarrier_private_expedited(int flags, int cpu_id)
 			goto out;
 		}
 		rcu_read_unlock();
+	} else if (user_mask) {
+		int cpu;
+
+		/*
+		 * Only look at the requested CPUs, so the cost scales with the
+		 * size of the mask rather than with the number of CPUs.
+		 */
+		cpumask_and(tmpmask, tmpmask, cpu_online_mask);
+
+		rcu_read_lock();
+		for_each_cpu(cpu, tmpmask) {
+			struct task_struct *p;
+
+			p = rcu_dereference(cpu_rq(cpu)->curr);
+			if (!p || p->mm != mm)
+				__cpumask_clear_cpu(cpu, tmpmask);
+		}
+		rcu_read_unlock();
 	} else {
 		int cpu;
 
@@ -593,10 +643,15 @@ static int membarrier_get_registrations(void)
  *          MEMBARRIER_CMD_PRIVATE_EXPEDITED_RSEQ: in the latter
  *          case it can be MEMBARRIER_CMD_FLAG_CPU, indicating that @cpu_id
  *          contains the CPU on which to interrupt (= restart)
- *          the RSEQ critical section.
+ *          the RSEQ critical section, or MEMBARRIER_CMD_FLAG_CPUMASK,
+ *          indicating that @cpumask contains the CPUs on which to do so.
  * @cpu_id: if @flags == MEMBARRIER_CMD_FLAG_CPU, indicates the cpu on which
  *          RSEQ CS should be interrupted (@cmd must be
- *          MEMBARRIER_CMD_PRIVATE_EXPEDITED_RSEQ).
+ *          MEMBARRIER_CMD_PRIVATE_EXPEDITED_RSEQ). If @flags ==
+ *          MEMBARRIER_CMD_FLAG_CPUMASK, the size of @cpumask in bytes.
+ * @cpumask: if @flags == MEMBARRIER_CMD_FLAG_CPUMASK, the CPU mask, in the
+ *          same format as for sched_setaffinity(), restricting the CPUs on
+ *          which RSEQ CS should be interrupted. Ignored otherwise.
  *
  * If this system call is not implemented, -ENOSYS is returned. If the
  * command specified does not exist, not available on the running
@@ -622,11 +677,15 @@ static int membarrier_get_registrations(void)
  *        smp_mb()           X           O            O
  *        sys_membarrier()   O           O            O
  */
-SYSCALL_DEFINE3(membarrier, int, cmd, unsigned int, flags, int, cpu_id)
+SYSCALL_DEFINE4(membarrier, int, cmd, unsigned int, flags, int, cpu_id,
+		const unsigned long __user *, cpumask)
 {
+	unsigned int len = 0;
+
 	switch (cmd) {
 	case MEMBARRIER_CMD_PRIVATE_EXPEDITED_RSEQ:
-		if (unlikely(flags && flags != MEMBARRIER_CMD_FLAG_CPU))
+		if (unlikely(flags && flags != MEMBARRIER_CMD_FLAG_CPU &&
+			     flags != MEMBARRIER_CMD_FLAG_CPUMASK))
 			return -EINVAL;
 		break;
 	default:
@@ -634,6 +693,14 @@ SYSCALL_DEFINE3(membarrier, int, cmd, unsigned int, flags, int, cpu_id)
 			return -EINVAL;
 	}
 
+	if (flags & MEMBARRIER_CMD_FLAG_CPUMASK) {
+		if (cpu_id <= 0)
+			return -EINVAL;
+		len = cpu_id;
+	} else {
+		cpumask = NULL;
+	}
+
 	if (!(flags & MEMBARRIER_CMD_FLAG_CPU))
 		cpu_id = -1;
 
@@ -658,15 +725,17 @@ SYSCALL_DEFINE3(membarrier, int, cmd, unsigned int, flags, int, cpu_id)
 	case MEMBARRIER_CMD_REGISTER_GLOBAL_EXPEDITED:
 		return membarrier_register_global_expedited();
 	case MEMBARRIER_CMD_PRIVATE_EXPEDITED:
-		return membarrier_private_expedited(0, cpu_id);
+		return membarrier_private_expedited(0, cpu_id, NULL, 0);
 	case MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED:
 		return membarrier_register_private_expedited(0);
 	case MEMBARRIER_CMD_PRIVATE_EXPEDITED_SYNC_CORE:
-		return membarrier_private_expedited(MEMBARRIER_FLAG_SYNC_CORE, cpu_id);
+		return membarrier_private_expedited(MEMBARRIER_FLAG_SYNC_CORE,
+						    cpu_id, NULL, 0);
 	case MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED_SYNC_CORE:
 		return membarrier_register_private_expedited(MEMBARRIER_FLAG_SYNC_CORE);
 	case MEMBARRIER_CMD_PRIVATE_EXPEDITED_RSEQ:
-		return membarrier_private_expedited(MEMBARRIER_FLAG_RSEQ, cpu_id);
+		return membarrier_private_expedited(MEMBARRIER_FLAG_RSEQ, cpu_id,
+						    cpumask, len);
 	case MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED_RSEQ:
 		return membarrier_register_private_expedited(MEMBARRIER_FLAG_RSEQ);
 	case MEMBARRIER_CMD_GET_REGISTRATIONS:
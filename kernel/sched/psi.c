@@ -176,13 +176,37 @@ static void psi_avgs_work(struct work_struct *work);
 
 static void poll_timer_fn(struct timer_list *t);
 
-static void group_init(struct psi_group *group)
+/*
+ * A task state change updates every cgroup level the task belongs to on its
+ * CPU. Rather than bumping a seqcount per group and level, all groups on a
+ * CPU share one; the writer opens it once per state change, and aggregators
+ * snapshotting any group on that CPU retry if it moved.
+ */
+static DEFINE_PER_CPU(seqcount_t, psi_seq) = SEQCNT_ZERO(psi_seq);
+
+static inline void psi_write_begin(int cpu)
 {
-	int cpu;
+	write_seqcount_begin(per_cpu_ptr(&psi_seq, cpu));
+}
 
+static inline void psi_write_end(int cpu)
+{
+	write_seqcount_end(per_cpu_ptr(&psi_seq, cpu));
+}
+
+static inline u32 psi_read_begin(int cpu)
+{
+	return read_seqcount_begin(per_cpu_ptr(&psi_seq, cpu));
+}
+
+static inline bool psi_read_retry(int cpu, u32 seq)
+{
+	return read_seqcount_retry(per_cpu_ptr(&psi_seq, cpu), seq);
+}
+
+static void group_init(struct psi_group *group)
+{
 	group->enabled = true;
-	for_each_possible_cpu(cpu)
-		seqcount_init(&per_cpu_ptr(group->pcpu, cpu)->seq);
 	group->avg_last_update = sched_clock();
 	group->avg_next_update = group->avg_last_update + psi_period;
 	mutex_init(&group->avgs_lock);
@@ -262,14 +286,14 @@ static void get_recent_times(struct psi_group *group, int cpu,
 
 	/* Snapshot a coherent view of the CPU state */
 	do {
-		seq = read_seqcount_begin(&groupc->seq);
+		seq = psi_read_begin(cpu);
 		now = cpu_clock(cpu);
 		memcpy(times, groupc->times, sizeof(groupc->times));
 		state_mask = groupc->state_mask;
 		state_start = groupc->state_start;
 		if (cpu == current_cpu)
 			memcpy(tasks, groupc->tasks, sizeof(groupc->tasks));
-	} while (read_seqcount_retry(&groupc->seq, seq));
+	} while (psi_read_retry(cpu, seq));
 
 	/* Calculate state time deltas against the previous snapshot */
 	for (s = 0; s < NR_PSI_STATES; s++) {
@@ -787,8 +811,9 @@ static void psi_group_change(struct psi_group *group, int cpu,
 	 * assess the aggregate resource states this CPU's tasks
 	 * have been in since the last change, and account any
 	 * SOME and FULL time these may have resulted in.
+	 *
+	 * The caller holds the CPU's psi_seq write section.
 	 */
-	write_seqcount_begin(&groupc->seq);
 
 	/*
 	 * Start with TSK_ONCPU, which doesn't have a corresponding
@@ -841,7 +866,6 @@ static void psi_group_change(struct psi_group *group, int cpu,
 
 		groupc->state_mask = state_mask;
 
-		write_seqcount_end(&groupc->seq);
 		return;
 	}
 
@@ -862,8 +886,6 @@ static void psi_group_change(struct psi_group *group, int cpu,
 
 	groupc->state_mask = state_mask;
 
-	write_seqcount_end(&groupc->seq);
-
 	if (state_mask & group->rtpoll_states)
 		psi_schedule_rtpoll_work(group, 1, false);
 
@@ -908,10 +930,12 @@ void psi_task_change(struct task_struct *task, int clear, int set)
 
 	now = cpu_clock(cpu);
 
+	psi_write_begin(cpu);
 	group = task_psi_group(task);
 	do {
 		psi_group_change(group, cpu, clear, set, now, true);
 	} while ((group = group->parent));
+	psi_write_end(cpu);
 }
 
 void psi_task_switch(struct task_struct *prev, struct task_struct *next,
@@ -921,6 +945,8 @@ void psi_task_switch(struct task_struct *prev, struct task_struct *next,
 	int cpu = task_cpu(prev);
 	u64 now = cpu_clock(cpu);
 
+	psi_write_begin(cpu);
+
 	if (next->pid) {
 		psi_flags_change(next, 0, TSK_ONCPU);
 		/*
@@ -989,6 +1015,8 @@ void psi_task_switch(struct task_struct *prev, struct task_struct *next,
 				psi_group_change(group, cpu, clear, set, now, wake_clock);
 		}
 	}
+
+	psi_write_end(cpu);
 }
 
 #ifdef CONFIG_IRQ_TIME_ACCOUNTING
@@ -1018,22 +1046,22 @@ void psi_account_irqtime(struct rq *rq, struct task_struct *curr, struct task_st
 		return;
 	rq->psi_irq_time = irq;
 
+	psi_write_begin(cpu);
+
 	do {
 		if (!group->enabled)
 			continue;
 
 		groupc = per_cpu_ptr(group->pcpu, cpu);
 
-		write_seqcount_begin(&groupc->seq);
-
 		record_times(groupc, now);
 		groupc->times[PSI_IRQ_FULL] += delta;
 
-		write_seqcount_end(&groupc->seq);
-
 		if (group->rtpoll_states & (1 << PSI_IRQ_FULL))
 			psi_schedule_rtpoll_work(group, 1, false);
 	} while ((group = group->parent));
+
+	psi_write_end(cpu);
 }
 #endif
 
@@ -1227,7 +1255,9 @@ void psi_cgroup_restart(struct psi_group *group)
 
 		rq_lock_irq(rq, &rf);
 		now = cpu_clock(cpu);
+		psi_write_begin(cpu);
 		psi_group_change(group, cpu, 0, 0, now, true);
+		psi_write_end(cpu);
 		rq_unlock_irq(rq, &rf);
 	}
 }
@@ -367,6 +367,8 @@ extern void dl_server_init(struct sched_dl_entity *dl_se, struct rq *rq,
 
 extern struct list_head task_groups;
 
+#define CFS_THROTTLE_HIST_BUCKETS	4
+
 struct cfs_bandwidth {
 #ifdef CONFIG_CFS_BANDWIDTH
 	raw_spinlock_t		lock;
@@ -390,6 +392,8 @@ struct cfs_bandwidth {
 	int			nr_burst;
 	u64			throttled_time;
 	u64			burst_time;
+	/* Per-cfs_rq throttle durations: <1ms, <10ms, <100ms, >=100ms */
+	unsigned int		throttle_events_hist[CFS_THROTTLE_HIST_BUCKETS];
 #endif
 };
 
@@ -407,6 +411,9 @@ struct task_group {
 	/* A positive value indicates that this is a SCHED_IDLE group. */
 	int			idle;
 
+	/* Custom slice of the group entities in ns, 0 for the default. */
+	u64			slice;
+
 #ifdef	CONFIG_SMP
 	/*
 	 * load_avg can be heavily contended at clock tick time, so put
@@ -527,6 +534,7 @@ extern void sched_move_task(struct task_struct *tsk);
 extern int sched_group_set_shares(struct task_group *tg, unsigned long shares);
 
 extern int sched_group_set_idle(struct task_group *tg, long idle);
+extern int sched_group_set_slice(struct task_group *tg, u64 slice);
 
 #ifdef CONFIG_SMP
 extern void set_task_rq_fair(struct sched_entity *se,
@@ -1448,6 +1456,12 @@ do {						\
 	flags = _raw_spin_rq_lock_irqsave(rq);	\
 } while (0)
 
+#ifdef CONFIG_SMP
+extern void update_idle_cpumask(struct rq *rq, bool idle);
+#else
+static inline void update_idle_cpumask(struct rq *rq, bool idle) { }
+#endif
+
 #ifdef CONFIG_SCHED_SMT
 extern void __update_idle_core(struct rq *rq);
 
@@ -2602,6 +2616,20 @@ extern const_debug unsigned int sysctl_sched_migration_cost;
 
 extern unsigned int sysctl_sched_base_slice;
 
+/*
+ * Bounds for a custom slice requested through sched_attr::sched_runtime or
+ * cpu.latency_slice: 0.1ms (HZ=1000 * 10) to 100ms (HZ=100 / 10).
+ */
+#define SCHED_SLICE_MIN		(NSEC_PER_MSEC / 10)
+#define SCHED_SLICE_MAX		(NSEC_PER_MSEC * 100)
+
+/*
+ * Fixed point pull success ratio of newidle balancing per sched_domain,
+ * NEWIDLE_RATIO_ONE meaning every attempt pulled a task.
+ */
+#define NEWIDLE_RATIO_SHIFT	10
+#define NEWIDLE_RATIO_ONE	(1U << NEWIDLE_RATIO_SHIFT)
+
 #ifdef CONFIG_SCHED_DEBUG
 extern int sysctl_resched_latency_warn_ms;
 extern int sysctl_resched_latency_warn_once;
@@ -2932,6 +2960,9 @@ extern void show_numa_stats(struct task_struct *p, struct seq_file *m);
 extern void
 print_numa_stats(struct seq_file *m, int node, unsigned long tsf,
 		 unsigned long tpf, unsigned long gsf, unsigned long gpf);
+extern void
+print_numa_group_stats(struct seq_file *m, pid_t gid, int nr_tasks,
+		       int active_nodes, unsigned long shared_joins);
 # endif /* CONFIG_NUMA_BALANCING */
 #else /* !CONFIG_SCHED_DEBUG: */
 static inline void resched_latency_warn(int cpu, u64 latency) { }
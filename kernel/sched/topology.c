@@ -1626,6 +1626,7 @@ sd_init(struct sched_domain_topology_level *tl,
 		.balance_interval	= sd_weight,
 		.max_newidle_lb_cost	= 0,
 		.last_decay_max_lb_cost	= jiffies,
+		.newidle_ratio		= NEWIDLE_RATIO_ONE,
 		.child			= child,
 #ifdef CONFIG_SCHED_DEBUG
 		.name			= tl->name,
@@ -1681,6 +1682,12 @@ sd_init(struct sched_domain_topology_level *tl,
 		sd->shared = *per_cpu_ptr(sdd->sds, sd_id);
 		atomic_inc(&sd->shared->ref);
 		atomic_set(&sd->shared->nr_busy_cpus, sd_weight);
+		/*
+		 * Start out assuming every CPU is idle; CPUs clear their bit
+		 * on the next idle exit and the wakeup path re-checks every
+		 * candidate anyway.
+		 */
+		cpumask_copy(sds_idle_cpus(sd->shared), sd_span);
 	}
 
 	sd->private = sdd;
@@ -2248,7 +2255,7 @@ static int __sdt_alloc(const struct cpumask *cpu_map)
 
 			*per_cpu_ptr(sdd->sd, j) = sd;
 
-			sds = kzalloc_node(sizeof(struct sched_domain_shared),
+			sds = kzalloc_node(sizeof(struct sched_domain_shared) + cpumask_size(),
 					GFP_KERNEL, cpu_to_node(j));
 			if (!sds)
 				return -ENOMEM;
@@ -101,11 +101,21 @@ static int __wake_up_common_lock(struct wait_queue_head *wq_head, unsigned int m
 {
 	unsigned long flags;
 	int remaining;
+	bool batch;
 
 	spin_lock_irqsave(&wq_head->lock, flags);
+	/*
+	 * Waking more than one entry, e.g. all the epoll items of a socket,
+	 * sends one IPI per target CPU at the end instead of one per wakee.
+	 */
+	batch = !list_empty(&wq_head->head) && !list_is_singular(&wq_head->head);
+	if (batch)
+		wake_up_batch_begin();
 	remaining = __wake_up_common(wq_head, mode, nr_exclusive, wake_flags,
 			key);
 	spin_unlock_irqrestore(&wq_head->lock, flags);
+	if (batch)
+		wake_up_batch_end();
 
 	return nr_exclusive - remaining;
 }
@@ -166,6 +166,9 @@ struct notification {
  * @allow_compat: A bitmap where each bit represents whether the
  *		  filter will always allow the syscall, for the
  *		  compat architecture.
+ *
+ * The filter's @cache covers the filter together with all of its
+ * predecessors, @own_cache covers the filter on its own.
  */
 struct action_cache {
 	DECLARE_BITMAP(allow_native, SECCOMP_ARCH_NATIVE_NR);
@@ -182,6 +185,12 @@ static inline bool seccomp_cache_check_allow(const struct seccomp_filter *sfilte
 	return false;
 }
 
+static inline bool seccomp_cache_check_allow_own(const struct seccomp_filter *sfilter,
+						 const struct seccomp_data *sd)
+{
+	return false;
+}
+
 static inline void seccomp_cache_prepare(struct seccomp_filter *sfilter)
 {
 }
@@ -204,6 +213,7 @@ static inline void seccomp_cache_prepare(struct seccomp_filter *sfilter)
  *	   or equal to @refs. Hence, reaching 0 for @users does not mean
  *	   the filter can be freed.
  * @cache: cache of arch/syscall mappings to actions
+ * @own_cache: cache of arch/syscall mappings this filter alone always allows
  * @log: true if all actions except for SECCOMP_RET_ALLOW should be logged
  * @wait_killable_recv: Put notifying process in killable state once the
  *			notification is received by the userspace listener.
@@ -229,6 +239,7 @@ struct seccomp_filter {
 	bool log;
 	bool wait_killable_recv;
 	struct action_cache cache;
+	struct action_cache own_cache;
 	struct seccomp_filter *prev;
 	struct bpf_prog *prog;
 	struct notification *notif;
@@ -359,18 +370,10 @@ static inline bool seccomp_cache_check_allow_bitmap(const void *bitmap,
 	return test_bit(syscall_nr, bitmap);
 }
 
-/**
- * seccomp_cache_check_allow - lookup seccomp cache
- * @sfilter: The seccomp filter
- * @sd: The seccomp data to lookup the cache with
- *
- * Returns true if the seccomp_data is cached and allowed.
- */
-static inline bool seccomp_cache_check_allow(const struct seccomp_filter *sfilter,
-					     const struct seccomp_data *sd)
+static inline bool __seccomp_cache_check_allow(const struct action_cache *cache,
+					       const struct seccomp_data *sd)
 {
 	int syscall_nr = sd->nr;
-	const struct action_cache *cache = &sfilter->cache;
 
 #ifndef SECCOMP_ARCH_COMPAT
 	/* A native-only architecture doesn't need to check sd->arch. */
@@ -391,6 +394,33 @@ static inline bool seccomp_cache_check_allow(const struct seccomp_filter *sfilte
 	WARN_ON_ONCE(true);
 	return false;
 }
+
+/**
+ * seccomp_cache_check_allow - lookup seccomp cache
+ * @sfilter: The seccomp filter
+ * @sd: The seccomp data to lookup the cache with
+ *
+ * Returns true if the seccomp_data is cached and allowed.
+ */
+static inline bool seccomp_cache_check_allow(const struct seccomp_filter *sfilter,
+					     const struct seccomp_data *sd)
+{
+	return __seccomp_cache_check_allow(&sfilter->cache, sd);
+}
+
+/**
+ * seccomp_cache_check_allow_own - lookup the cache of a single filter
+ * @sfilter: The seccomp filter
+ * @sd: The seccomp data to lookup the cache with
+ *
+ * Returns true if @sfilter on its own always allows the seccomp_data,
+ * regardless of the filters installed before it.
+ */
+static inline bool seccomp_cache_check_allow_own(const struct seccomp_filter *sfilter,
+						 const struct seccomp_data *sd)
+{
+	return __seccomp_cache_check_allow(&sfilter->own_cache, sd);
+}
 #endif /* SECCOMP_ARCH_NATIVE */
 
 #define ACTION_ONLY(ret) ((s32)((ret) & (SECCOMP_RET_ACTION_FULL)))
@@ -423,11 +453,19 @@ static u32 seccomp_run_filters(const struct seccomp_data *sd,
 	 * value always takes priority (ignoring the DATA).
 	 */
 	for (; f; f = f->prev) {
-		u32 cur_ret = bpf_prog_run_pin_on_cpu(f->prog, sd);
+		u32 cur_ret;
 
+		/* This filter cannot lower the result, skip running it. */
+		if (seccomp_cache_check_allow_own(f, sd))
+			continue;
+
+		cur_ret = bpf_prog_run_pin_on_cpu(f->prog, sd);
 		if (ACTION_ONLY(cur_ret) < ACTION_ONLY(ret)) {
 			ret = cur_ret;
 			*match = f;
+			/* Nothing takes priority over killing the process. */
+			if (ACTION_ONLY(ret) == SECCOMP_RET_KILL_PROCESS)
+				break;
 		}
 	}
 	return ret;
@@ -813,38 +851,34 @@ static bool seccomp_is_const_allow(struct sock_fprog_kern *fprog,
 }
 
 static void seccomp_cache_prepare_bitmap(struct seccomp_filter *sfilter,
-					 void *bitmap, const void *bitmap_prev,
+					 void *bitmap, void *bitmap_own,
+					 const void *bitmap_prev,
 					 size_t bitmap_size, int arch)
 {
 	struct sock_fprog_kern *fprog = sfilter->prog->orig_prog;
 	struct seccomp_data sd;
 	int nr;
 
-	if (bitmap_prev) {
-		/* The new filter must be as restrictive as the last. */
-		bitmap_copy(bitmap, bitmap_prev, bitmap_size);
-	} else {
-		/* Before any filters, all syscalls are always allowed. */
-		bitmap_fill(bitmap, bitmap_size);
-	}
-
+	/*
+	 * Emulate every syscall, not only those the previous filters allow,
+	 * so that this filter can be skipped on its own in
+	 * seccomp_run_filters().
+	 * Non-atomic bitops are fine, the filter is not visible yet.
+	 */
+	bitmap_zero(bitmap_own, bitmap_size);
 	for (nr = 0; nr < bitmap_size; nr++) {
-		/* No bitmap change: not a cacheable action. */
-		if (!test_bit(nr, bitmap))
-			continue;
-
 		sd.nr = nr;
 		sd.arch = arch;
 
-		/* No bitmap change: continue to always allow. */
 		if (seccomp_is_const_allow(fprog, &sd))
-			continue;
+			__set_bit(nr, bitmap_own);
+	}
 
-		/*
-		 * Not a cacheable action: always run filters.
-		 * atomic clear_bit() not needed, filter not visible yet.
-		 */
-		__clear_bit(nr, bitmap);
+	if (bitmap_prev) {
+		/* The new filter must be as restrictive as the last. */
+		bitmap_and(bitmap, bitmap_prev, bitmap_own, bitmap_size);
+	} else {
+		bitmap_copy(bitmap, bitmap_own, bitmap_size);
 	}
 }
 
@@ -861,12 +895,14 @@ static void seccomp_cache_prepare(struct seccomp_filter *sfilter)
 		sfilter->prev ? &sfilter->prev->cache : NULL;
 
 	seccomp_cache_prepare_bitmap(sfilter, cache->allow_native,
+				     sfilter->own_cache.allow_native,
 				     cache_prev ? cache_prev->allow_native : NULL,
 				     SECCOMP_ARCH_NATIVE_NR,
 				     SECCOMP_ARCH_NATIVE);
 
 #ifdef SECCOMP_ARCH_COMPAT
 	seccomp_cache_prepare_bitmap(sfilter, cache->allow_compat,
+				     sfilter->own_cache.allow_compat,
 				     cache_prev ? cache_prev->allow_compat : NULL,
 				     SECCOMP_ARCH_COMPAT_NR,
 				     SECCOMP_ARCH_COMPAT);
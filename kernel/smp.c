@@ -347,7 +347,9 @@ static __always_inline void csd_unlock(call_single_data_t *csd)
 
 static DEFINE_PER_CPU_SHARED_ALIGNED(call_single_data_t, csd_data);
 
-void __smp_call_single_queue(int cpu, struct llist_node *node)
+/* Returns true if @cpu needs to be sent an IPI to process @node. */
+static __always_inline bool
+__smp_call_single_enqueue(int cpu, struct llist_node *node)
 {
 	/*
 	 * We have to check the type of the CSD before queueing it, because
@@ -379,10 +381,64 @@ void __smp_call_single_queue(int cpu, struct llist_node *node)
 	 * locking and barrier primitives. Generic code isn't really
 	 * equipped to do the right thing...
 	 */
-	if (llist_add(node, &per_cpu(call_single_queue, cpu)))
+	return llist_add(node, &per_cpu(call_single_queue, cpu));
+}
+
+void __smp_call_single_queue(int cpu, struct llist_node *node)
+{
+	if (__smp_call_single_enqueue(cpu, node))
 		send_call_function_single_ipi(cpu);
 }
 
+/**
+ * __smp_call_single_queue_mask - Enqueue without sending the IPI
+ * @cpu: The CPU to run @node on
+ * @node: The llist_node to enqueue, see __smp_call_single_queue()
+ * @ipi_mask: Mask to mark @cpu in if it needs an IPI
+ *
+ * Must be called with interrupts disabled. Once @cpu is marked, the IPI is
+ * owed by the caller, who must send it through smp_call_function_kick_mask()
+ * shortly after, from the same CPU and without enabling preemption in
+ * between. Interrupts may be enabled meanwhile, but @ipi_mask may only be
+ * modified with interrupts disabled. This allows to kick a set of CPUs with
+ * a single multicast IPI.
+ */
+void __smp_call_single_queue_mask(int cpu, struct llist_node *node,
+				  struct cpumask *ipi_mask)
+{
+	if (__smp_call_single_enqueue(cpu, node))
+		__cpumask_set_cpu(cpu, ipi_mask);
+}
+
+/**
+ * smp_call_function_kick_mask - Send the IPIs owed for queued entries
+ * @mask: The CPUs marked by __smp_call_single_queue_mask()
+ *
+ * CPUs polling on their need_resched flag are kicked without an IPI and
+ * cleared from @mask. Must be called with interrupts disabled.
+ */
+void smp_call_function_kick_mask(struct cpumask *mask)
+{
+	unsigned int cpu, last_cpu = 0, nr_cpus = 0;
+
+	for_each_cpu(cpu, mask) {
+		if (!call_function_single_prep_ipi(cpu)) {
+			__cpumask_clear_cpu(cpu, mask);
+			continue;
+		}
+		nr_cpus++;
+		last_cpu = cpu;
+	}
+
+	if (nr_cpus == 1) {
+		trace_ipi_send_cpu(last_cpu, _RET_IP_,
+				   generic_smp_call_function_single_interrupt);
+		arch_send_call_function_single_ipi(last_cpu);
+	} else if (nr_cpus > 1) {
+		send_call_function_ipi_mask(mask);
+	}
+}
+
 /*
  * Insert a previously allocated call_single_data_t element
  * for execution on the given CPU. data must already have
@@ -17,6 +17,7 @@
 #include <linux/kmod.h>
 #include <linux/ksm.h>
 #include <linux/perf_event.h>
+#include <linux/futex.h>
 #include <linux/resource.h>
 #include <linux/kernel.h>
 #include <linux/workqueue.h>
@@ -2773,6 +2774,40 @@ SYSCALL_DEFINE5(prctl, int, option, unsigned long, arg2, unsigned long, arg3,
 		error = !!test_bit(MMF_VM_MERGE_ANY, &me->mm->flags);
 		break;
 #endif
+#ifdef CONFIG_NUMA_BALANCING
+	case PR_SET_NUMA_SHARED_GROUP:
+		if (arg2 > 1 || arg3 || arg4 || arg5)
+			return -EINVAL;
+
+		me->numa_shared_group = arg2;
+		break;
+	case PR_GET_NUMA_SHARED_GROUP:
+		if (arg2 || arg3 || arg4 || arg5)
+			return -EINVAL;
+
+		error = me->numa_shared_group;
+		break;
+#endif
+#ifdef CONFIG_MMU
+	case PR_SET_FORK_COPY_THREADS:
+		if (arg2 > PR_FORK_COPY_THREADS_MAX || arg3 || arg4 || arg5)
+			return -EINVAL;
+
+		WRITE_ONCE(me->mm->fork_copy_threads, arg2);
+		break;
+	case PR_GET_FORK_COPY_THREADS:
+		if (arg2 || arg3 || arg4 || arg5)
+			return -EINVAL;
+
+		error = READ_ONCE(me->mm->fork_copy_threads);
+		break;
+#endif
+	case PR_FUTEX_HASH:
+		if (arg4 || arg5)
+			return -EINVAL;
+
+		error = futex_hash_prctl(arg2, arg3);
+		break;
 	case PR_RISCV_V_SET_CONTROL:
 		error = RISCV_V_SET_CONTROL(arg2);
 		break;
@@ -1999,6 +1999,11 @@ static struct ctl_table kern_table[] = {
 		.extra1		= SYSCTL_ZERO,
 		.extra2		= SYSCTL_ONE_THOUSAND,
 	},
+	{
+		.procname	= "perf_event_mmap_records",
+		.mode		= 0444,
+		.proc_handler	= perf_event_mmap_records_handler,
+	},
 #endif
 	{
 		.procname	= "panic_on_warn",
@@ -568,6 +568,62 @@ static int taskstats_user_cmd(struct sk_buff *skb, struct genl_info *info)
 		return -EINVAL;
 }
 
+/*
+ * Dump the stats of every task in the caller's pid namespace, one
+ * TASKSTATS_CMD_NEW message per task, in the same format as a
+ * TASKSTATS_CMD_ATTR_PID reply. This saves monitoring tools a request
+ * (or several /proc/<pid> files) per task. Tasks are visited in pid
+ * order and cb->args[0] holds the next pid to look at, so that the dump
+ * resumes where the previous skb filled up.
+ */
+static int taskstats_user_dump(struct sk_buff *skb, struct netlink_callback *cb)
+{
+	struct pid_namespace *ns = task_active_pid_ns(current);
+	struct task_struct *tsk;
+	struct taskstats *stats;
+	struct pid *pid;
+	void *reply;
+	pid_t nr;
+
+	for (nr = cb->args[0]; ; nr++) {
+		rcu_read_lock();
+		pid = find_ge_pid(nr, ns);
+		if (!pid) {
+			rcu_read_unlock();
+			break;
+		}
+		nr = pid_nr_ns(pid, ns);
+		tsk = pid_task(pid, PIDTYPE_PID);
+		if (tsk)
+			get_task_struct(tsk);
+		rcu_read_unlock();
+		if (!tsk)
+			continue;
+
+		reply = genlmsg_put(skb, NETLINK_CB(cb->skb).portid,
+				    cb->nlh->nlmsg_seq, &family, NLM_F_MULTI,
+				    TASKSTATS_CMD_NEW);
+		if (!reply) {
+			put_task_struct(tsk);
+			break;
+		}
+		stats = mk_reply(skb, TASKSTATS_TYPE_PID, nr);
+		if (!stats) {
+			genlmsg_cancel(skb, reply);
+			put_task_struct(tsk);
+			break;
+		}
+		fill_stats(current_user_ns(), ns, tsk, stats);
+		put_task_struct(tsk);
+		genlmsg_end(skb, reply);
+
+		cond_resched();
+	}
+
+	cb->args[0] = nr;
+	return skb->len;
+}
+
 static struct taskstats *taskstats_tgid_alloc(struct task_struct *tsk)
 {
 	struct signal_struct *sig = tsk->signal;
@@ -668,6 +724,7 @@ static const struct genl_ops taskstats_ops[] = {
 		.cmd		= TASKSTATS_CMD_GET,
 		.validate = GENL_DONT_VALIDATE_STRICT | GENL_DONT_VALIDATE_DUMP,
 		.doit		= taskstats_user_cmd,
+		.dumpit		= taskstats_user_dump,
 		.policy		= taskstats_cmd_get_policy,
 		.maxattr	= ARRAY_SIZE(taskstats_cmd_get_policy) - 1,
 		.flags		= GENL_ADMIN_PERM,
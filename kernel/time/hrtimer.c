@@ -34,6 +34,7 @@
 #include <linux/debugobjects.h>
 #include <linux/sched/signal.h>
 #include <linux/sched/sysctl.h>
+#include <linux/sysctl.h>
 #include <linux/sched/rt.h>
 #include <linux/sched/deadline.h>
 #include <linux/sched/nohz.h>
@@ -1750,6 +1751,11 @@ static void __hrtimer_run_queues(struct hrtimer_cpu_base *cpu_base, ktime_t now,
 			if (basenow < hrtimer_get_softexpires_tv64(timer))
 				break;
 
+#ifdef CONFIG_HIGH_RES_TIMERS
+			/* Expired within its slack, saving an interrupt */
+			if (basenow < hrtimer_get_expires_tv64(timer))
+				cpu_base->nr_coalesced++;
+#endif
 			__run_hrtimer(cpu_base, base, timer, &basenow, flags);
 			if (active_mask == HRTIMER_ACTIVE_SOFT)
 				hrtimer_sync_wait_running(cpu_base, flags);
@@ -2066,6 +2072,55 @@ static long __sched hrtimer_nanosleep_restart(struct restart_block *restart)
 	return ret;
 }
 
+/*
+ * Additional slack given to user space timers (nanosleep and timerfd) of
+ * non-RT tasks, so that expiries within this window are handled by a
+ * single hrtimer interrupt. /proc/timer_list shows per CPU how many timers
+ * were expired ahead of their hard expiry time in the interrupt of an
+ * earlier timer (nr_coalesced).
+ */
+static unsigned long sysctl_hrtimer_coalesce_ns __read_mostly;
+
+/**
+ * hrtimer_user_slack_ns - Slack for a user space armed timer
+ * @task_slack:	Apply the task's timer slack even when no coalescing
+ *		window is configured
+ *
+ * Return: The slack to arm a timer on behalf of current with: 0 for RT
+ * tasks, otherwise the task's timer slack plus the coalescing window.
+ */
+u64 hrtimer_user_slack_ns(bool task_slack)
+{
+	u64 window = READ_ONCE(sysctl_hrtimer_coalesce_ns);
+
+	if (rt_task(current) || (!window && !task_slack))
+		return 0;
+
+	return current->timer_slack_ns + window;
+}
+
+#ifdef CONFIG_SYSCTL
+static unsigned long hrtimer_coalesce_max = 10 * NSEC_PER_MSEC;
+
+static struct ctl_table hrtimer_sysctl[] = {
+	{
+		.procname	= "hrtimer_coalesce_ns",
+		.data		= &sysctl_hrtimer_coalesce_ns,
+		.maxlen		= sizeof(unsigned long),
+		.mode		= 0644,
+		.proc_handler	= proc_doulongvec_minmax,
+		.extra2		= &hrtimer_coalesce_max,
+	},
+};
+
+static int __init hrtimer_sysctl_init(void)
+{
+	register_sysctl_init("kernel", hrtimer_sysctl);
+	return 0;
+}
+late_initcall(hrtimer_sysctl_init);
+#endif
+
 long hrtimer_nanosleep(ktime_t rqtp, const enum hrtimer_mode mode,
 		       const clockid_t clockid)
 {
@@ -2074,9 +2129,7 @@ long hrtimer_nanosleep(ktime_t rqtp, const enum hrtimer_mode mode,
 	int ret = 0;
 	u64 slack;
 
-	slack = current->timer_slack_ns;
-	if (rt_task(current))
-		slack = 0;
+	slack = hrtimer_user_slack_ns(true);
 
 	hrtimer_init_sleeper_on_stack(&t, clockid, mode);
 	hrtimer_set_expires_range_ns(&t.timer, rqtp, slack);
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * KUnit test for clock reads racing with timekeeper updates.
+ *
+ * One kthread per online CPU reads the clock in a tight loop while the tick
+ * updates the timekeeper, so every HZ update is a concurrent writer. Reads
+ * through ktime_get() retry on tk_core.seq and must never go backwards. The
+ * latched ktime_get_mono_fast_ns() is run for comparison; it may go
+ * backwards by design. The aggregate read rates are reported.
+ */
+
+#include <kunit/test.h>
+#include <linux/completion.h>
+#include <linux/cpumask.h>
+#include <linux/delay.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/timekeeping.h>
+
+/* Seconds each variant reads the clock for */
+#define KTIME_GET_TEST_DURATION	1
+
+struct ktime_get_worker {
+	struct task_struct	*task;
+	struct completion	done;
+	bool			fast;
+	unsigned long		ops;
+	unsigned long		backwards;
+};
+
+static bool stop_test;
+
+static int ktime_get_thread(void *arg)
+{
+	struct ktime_get_worker *w = arg;
+	u64 prev = 0, now;
+
+	while (!READ_ONCE(stop_test)) {
+		if (w->fast)
+			now = ktime_get_mono_fast_ns();
+		else
+			now = ktime_to_ns(ktime_get());
+
+		if (now < prev)
+			w->backwards++;
+		prev = now;
+
+		if (!(++w->ops & 1023))
+			cond_resched();
+	}
+
+	complete(&w->done);
+
+	/* Wait to be stopped, so that the task is still around for us */
+	while (!kthread_should_stop())
+		schedule_timeout_interruptible(HZ);
+	return 0;
+}
+
+/* Returns the number of reads that went backwards */
+static unsigned long ktime_get_run(struct kunit *test, bool fast)
+{
+	unsigned int i, started = 0, nr_threads = num_online_cpus();
+	unsigned long ops = 0, backwards = 0;
+	struct ktime_get_worker *workers;
+	int cpu;
+
+	workers = kunit_kcalloc(test, nr_threads, sizeof(*workers), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_NULL(test, workers);
+
+	WRITE_ONCE(stop_test, false);
+
+	for_each_online_cpu(cpu) {
+		struct ktime_get_worker *w = &workers[started];
+
+		/* CPUs may have come online since nr_threads was read */
+		if (started == nr_threads)
+			break;
+		init_completion(&w->done);
+		w->fast = fast;
+		w->task = kthread_run_on_cpu(ktime_get_thread, w, cpu,
+					     "ktime_get_kunit/%u");
+		if (IS_ERR(w->task))
+			break;
+		started++;
+	}
+
+	if (started)
+		ssleep(KTIME_GET_TEST_DURATION);
+	WRITE_ONCE(stop_test, true);
+
+	for (i = 0; i < started; i++) {
+		wait_for_completion(&workers[i].done);
+		kthread_stop(workers[i].task);
+		ops += workers[i].ops;
+		backwards += workers[i].backwards;
+	}
+
+	KUNIT_EXPECT_EQ_MSG(test, started, nr_threads,
+			    "failed to start all threads");
+	kunit_info(test, "%s, %u threads: %lu reads/s, %lu went backwards\n",
+		   fast ? "ktime_get_mono_fast_ns" : "ktime_get", started,
+		   ops / KTIME_GET_TEST_DURATION, backwards);
+
+	return backwards;
+}
+
+static void ktime_get_monotonic_test(struct kunit *test)
+{
+	KUNIT_EXPECT_EQ(test, ktime_get_run(test, false), 0);
+}
+
+static void ktime_get_mono_fast_ns_test(struct kunit *test)
+{
+	ktime_get_run(test, true);
+}
+
+static struct kunit_case ktime_get_test_cases[] = {
+	KUNIT_CASE_SLOW(ktime_get_monotonic_test),
+	KUNIT_CASE_SLOW(ktime_get_mono_fast_ns_test),
+	{}
+};
+
+static struct kunit_suite ktime_get_test_suite = {
+	.name = "ktime_get",
+	.test_cases = ktime_get_test_cases,
+};
+
+kunit_test_suite(ktime_get_test_suite);
+MODULE_DESCRIPTION("KUnit test for ktime_get() against timekeeper updates");
+MODULE_LICENSE("GPL");
@@ -13,6 +13,19 @@ struct timer_events {
 	u64	global;
 };
 
+/*
+ * mod_timer() statistics: rearms done without the base lock, rearms which
+ * took the base lock, and timers requeued at expiry because their expiry
+ * was pushed out while they were queued.
+ */
+struct timer_mod_stats {
+	unsigned long	lockless;
+	unsigned long	locked;
+	unsigned long	requeued;
+};
+
+extern void timer_get_mod_stats(unsigned int cpu, struct timer_mod_stats *stats);
+
 #ifdef CONFIG_GENERIC_CLOCKEVENTS
 
 # define TICK_DO_TIMER_NONE	-1
@@ -326,60 +326,73 @@ bool tick_nohz_full_running;
 EXPORT_SYMBOL_GPL(tick_nohz_full_running);
 static atomic_t tick_dep_mask;
 
-static bool check_tick_dependency(atomic_t *dep)
+/*
+ * Return the first dependency set in @dep, or TICK_DEP_MASK_NONE.
+ */
+static int check_tick_dependency(atomic_t *dep)
 {
 	int val = atomic_read(dep);
 
 	if (val & TICK_DEP_MASK_POSIX_TIMER) {
 		trace_tick_stop(0, TICK_DEP_MASK_POSIX_TIMER);
-		return true;
+		return TICK_DEP_MASK_POSIX_TIMER;
 	}
 
 	if (val & TICK_DEP_MASK_PERF_EVENTS) {
 		trace_tick_stop(0, TICK_DEP_MASK_PERF_EVENTS);
-		return true;
+		return TICK_DEP_MASK_PERF_EVENTS;
 	}
 
 	if (val & TICK_DEP_MASK_SCHED) {
 		trace_tick_stop(0, TICK_DEP_MASK_SCHED);
-		return true;
+		return TICK_DEP_MASK_SCHED;
 	}
 
 	if (val & TICK_DEP_MASK_CLOCK_UNSTABLE) {
 		trace_tick_stop(0, TICK_DEP_MASK_CLOCK_UNSTABLE);
-		return true;
+		return TICK_DEP_MASK_CLOCK_UNSTABLE;
 	}
 
 	if (val & TICK_DEP_MASK_RCU) {
 		trace_tick_stop(0, TICK_DEP_MASK_RCU);
-		return true;
+		return TICK_DEP_MASK_RCU;
 	}
 
 	if (val & TICK_DEP_MASK_RCU_EXP) {
 		trace_tick_stop(0, TICK_DEP_MASK_RCU_EXP);
-		return true;
+		return TICK_DEP_MASK_RCU_EXP;
 	}
 
-	return false;
+	return TICK_DEP_MASK_NONE;
 }
 
-static bool can_stop_full_tick(int cpu, struct tick_sched *ts)
+/*
+ * Return whether the tick can be stopped. If not, @dep is set to the
+ * dependency that keeps it running (TICK_DEP_MASK_NONE for an offline
+ * CPU).
+ */
+static bool can_stop_full_tick(int cpu, struct tick_sched *ts, int *dep)
 {
 	lockdep_assert_irqs_disabled();
 
+	*dep = TICK_DEP_MASK_NONE;
 	if (unlikely(!cpu_online(cpu)))
 		return false;
 
-	if (check_tick_dependency(&tick_dep_mask))
+	*dep = check_tick_dependency(&tick_dep_mask);
+	if (*dep)
 		return false;
 
-	if (check_tick_dependency(&ts->tick_dep_mask))
+	*dep = check_tick_dependency(&ts->tick_dep_mask);
+	if (*dep)
 		return false;
 
-	if (check_tick_dependency(&current->tick_dep_mask))
+	*dep = check_tick_dependency(&current->tick_dep_mask);
+	if (*dep)
 		return false;
 
-	if (check_tick_dependency(&current->signal->tick_dep_mask))
+	*dep = check_tick_dependency(&current->signal->tick_dep_mask);
+	if (*dep)
 		return false;
 
 	return true;
@@ -1107,11 +1120,14 @@ static void __tick_nohz_full_update_tick(struct tick_sched *ts,
 {
 #ifdef CONFIG_NO_HZ_FULL
 	int cpu = smp_processor_id();
+	int dep;
 
-	if (can_stop_full_tick(cpu, ts))
+	if (can_stop_full_tick(cpu, ts, &dep)) {
 		tick_nohz_full_stop_tick(ts, cpu);
-	else if (tick_sched_flag_test(ts, TS_FLAG_STOPPED))
+	} else if (tick_sched_flag_test(ts, TS_FLAG_STOPPED)) {
+		trace_tick_restart(dep);
 		tick_nohz_restart_sched_tick(ts, now);
+	}
 #endif
 }
 
@@ -751,7 +751,10 @@ static inline void tk_update_ktime_data(struct timekeeper *tk)
 }
 
 /* must hold timekeeper_lock */
-static void timekeeping_update(struct timekeeper *tk, unsigned int action)
+/*
+ * Update the derived data of @tk which is read under tk_core.seq.
+ */
+static void timekeeping_update_core(struct timekeeper *tk, unsigned int action)
 {
 	if (action & TK_CLEAR_NTP) {
 		tk->ntp_error = 0;
@@ -761,15 +764,31 @@ static void timekeeping_update(struct timekeeper *tk, unsigned int action)
 	tk_update_leap_state(tk);
 	tk_update_ktime_data(tk);
 
+	tk->tkr_mono.base_real = tk->tkr_mono.base + tk->offs_real;
+
+	if (action & TK_CLOCK_WAS_SET)
+		tk->clock_was_set_seq++;
+}
+
+/*
+ * Propagate @tk to the vDSO data, the pvclock notifier and the NMI safe fast
+ * timekeepers. Called within the tk_core.seq write section, so that none of
+ * them is ever observed ahead of tk_core.
+ */
+static void timekeeping_update_sync(struct timekeeper *tk, unsigned int action)
+{
 	update_vsyscall(tk);
 	update_pvclock_gtod(tk, action & TK_CLOCK_WAS_SET);
 
-	tk->tkr_mono.base_real = tk->tkr_mono.base + tk->offs_real;
 	update_fast_timekeeper(&tk->tkr_mono, &tk_fast_mono);
 	update_fast_timekeeper(&tk->tkr_raw,  &tk_fast_raw);
+}
+
+static void timekeeping_update(struct timekeeper *tk, unsigned int action)
+{
+	timekeeping_update_core(tk, action);
+	timekeeping_update_sync(tk, action);
 
-	if (action & TK_CLOCK_WAS_SET)
-		tk->clock_was_set_seq++;
 	/*
 	 * The mirroring of the data to the shadow-timekeeper needs
 	 * to happen last here to ensure we don't over-write the
@@ -2330,6 +2349,13 @@ static bool timekeeping_advance(enum timekeeping_adv_mode mode)
 	 */
 	clock_set |= accumulate_nsecs_to_secs(tk);
 
+	/*
+	 * Prepare the data readers of tk_core need on the shadow timekeeper
+	 * before the write section, which makes all ktime_get*() readers
+	 * retry.
+	 */
+	timekeeping_update_core(tk, clock_set);
+
 	write_seqcount_begin(&tk_core.seq);
 	/*
 	 * Update the real timekeeper.
@@ -2341,7 +2367,7 @@ static bool timekeeping_advance(enum timekeeping_adv_mode mode)
 	 * memcpy under the tk_core.seq against one before we start
 	 * updating.
 	 */
-	timekeeping_update(tk, clock_set);
+	timekeeping_update_sync(tk, clock_set);
 	memcpy(real_tk, tk, sizeof(*tk));
 	/* The memcpy must come last. Do not put anything here! */
 	write_seqcount_end(&tk_core.seq);
@@ -261,12 +261,32 @@ struct timer_base {
 	bool			next_expiry_recalc;
 	bool			is_idle;
 	bool			timers_pending;
+	unsigned long		requeued;
 	DECLARE_BITMAP(pending_map, WHEEL_SIZE);
 	struct hlist_head	vectors[WHEEL_SIZE];
 } ____cacheline_aligned;
 
 static DEFINE_PER_CPU(struct timer_base, timer_bases[NR_BASES]);
 
+static DEFINE_PER_CPU(struct timer_mod_stats, timer_mod_stats);
+
+/**
+ * timer_get_mod_stats - Retrieve the mod_timer() statistics of a CPU
+ * @cpu:	The CPU to read the statistics of
+ * @stats:	Where to store the snapshot
+ */
+void timer_get_mod_stats(unsigned int cpu, struct timer_mod_stats *stats)
+{
+	struct timer_mod_stats *s = per_cpu_ptr(&timer_mod_stats, cpu);
+	int i;
+
+	stats->lockless = READ_ONCE(s->lockless);
+	stats->locked = READ_ONCE(s->locked);
+	stats->requeued = 0;
+	for (i = 0; i < NR_BASES; i++)
+		stats->requeued += READ_ONCE(per_cpu(timer_bases[i], cpu).requeued);
+}
+
 #ifdef CONFIG_NO_HZ_COMMON
 
 static DEFINE_STATIC_KEY_FALSE(timers_nohz_active);
@@ -650,10 +670,11 @@ trigger_dyntick_cpu(struct timer_base *base, struct timer_list *timer)
 /*
  * Enqueue the timer into the hash bucket, mark it pending in
  * the bitmap, store the index in the timer flags then wake up
- * the target CPU if needed.
+ * the target CPU if needed and @kick is set.
  */
 static void enqueue_timer(struct timer_base *base, struct timer_list *timer,
-			  unsigned int idx, unsigned long bucket_expiry)
+			  unsigned int idx, unsigned long bucket_expiry,
+			  bool kick)
 {
 
 	hlist_add_head(&timer->entry, base->vectors + idx);
@@ -675,7 +696,8 @@ static void enqueue_timer(struct timer_base *base, struct timer_list *timer,
 		base->next_expiry = bucket_expiry;
 		base->timers_pending = true;
 		base->next_expiry_recalc = false;
-		trigger_dyntick_cpu(base, timer);
+		if (kick)
+			trigger_dyntick_cpu(base, timer);
 	}
 }
 
@@ -685,7 +707,7 @@ static void internal_add_timer(struct timer_base *base, struct timer_list *timer
 	unsigned int idx;
 
 	idx = calc_wheel_index(timer->expires, base->clk, &bucket_expiry);
-	enqueue_timer(base, timer, idx, bucket_expiry);
+	enqueue_timer(base, timer, idx, bucket_expiry, true);
 }
 
 #ifdef CONFIG_DEBUG_OBJECTS_TIMERS
@@ -1061,6 +1083,49 @@ static struct timer_base *lock_timer_base(struct timer_list *timer,
 #define MOD_TIMER_REDUCE		0x02
 #define MOD_TIMER_NOTPENDING		0x04
 
+/*
+ * Push out the expiry of a pending timer without taking the base lock.
+ *
+ * Timers which are rearmed over and over to a later expiry (networking
+ * retransmit and keepalive timers, watchdogs) mostly never expire, yet every
+ * rearm which crosses a bucket boundary pays for a base lock round trip and
+ * a dequeue/enqueue. Instead, only the expiry time is updated here and the
+ * timer is left in its bucket. When the bucket expires, expire_timers()
+ * notices that the expiry has moved and requeues the timer according to the
+ * new expiry time instead of running the callback.
+ *
+ * This is only done when the new expiry is later than the current one and
+ * the timer stays within the range of its current level, so that the
+ * requeued timer never ends up with a coarser granularity than it would get
+ * from a regular enqueue. The last level is excluded as its timers may be
+ * expired before their expiry time (see WHEEL_TIMEOUT_CUTOFF).
+ *
+ * The cmpxchg() implies a full barrier, which pairs with the smp_mb() in
+ * expire_timers(): either the timer is still seen as pending here and
+ * expire_timers() then observes the new expiry time, or the timer was
+ * already dequeued and we take the locked slow path.
+ */
+static inline bool mod_timer_lockless(struct timer_list *timer,
+				      unsigned long old, unsigned long expires)
+{
+	unsigned int lvl = timer_get_idx(timer) / LVL_SIZE;
+
+	if (lvl >= LVL_DEPTH - 1 || !time_after(expires, old))
+		return false;
+
+	if (expires - jiffies >= LVL_START(lvl + 1))
+		return false;
+
+	if (cmpxchg(&timer->expires, old, expires) != old)
+		return false;
+
+	if (!timer_pending(timer))
+		return false;
+
+	this_cpu_inc(timer_mod_stats.lockless);
+	return true;
+}
+
 static inline int
 __mod_timer(struct timer_list *timer, unsigned long expires, unsigned int options)
 {
@@ -1082,12 +1147,15 @@ __mod_timer(struct timer_list *timer, unsigned long expires, unsigned int option
 		 * larger granularity than you would get from adding a new
 		 * timer with this expiry.
 		 */
-		long diff = timer->expires - expires;
+		unsigned long old = READ_ONCE(timer->expires);
+		long diff = old - expires;
 
 		if (!diff)
 			return 1;
 		if (options & MOD_TIMER_REDUCE && diff <= 0)
 			return 1;
+		if (!options && mod_timer_lockless(timer, old, expires))
+			return 1;
 
 		/*
 		 * We lock timer base and calculate the bucket index right
@@ -1118,9 +1186,11 @@ __mod_timer(struct timer_list *timer, unsigned long expires, unsigned int option
 		/*
 		 * Retrieve and compare the array index of the pending
 		 * timer. If it matches set the expiry to the new value so a
-		 * subsequent call will exit in the expires check above.
+		 * subsequent call will exit in the expires check above. The
+		 * timer might have expired or been requeued since the check
+		 * above, detach_timer() leaves the stale index in place.
 		 */
-		if (idx == timer_get_idx(timer)) {
+		if (timer_pending(timer) && idx == timer_get_idx(timer)) {
 			if (!(options & MOD_TIMER_REDUCE))
 				timer->expires = expires;
 			else if (time_after(timer->expires, expires))
@@ -1169,6 +1239,7 @@ __mod_timer(struct timer_list *timer, unsigned long expires, unsigned int option
 	}
 
 	debug_timer_activate(timer);
+	this_cpu_inc(timer_mod_stats.locked);
 
 	timer->expires = expires;
 	/*
@@ -1178,7 +1249,7 @@ __mod_timer(struct timer_list *timer, unsigned long expires, unsigned int option
 	 * the wheel index via internal_add_timer().
 	 */
 	if (idx != UINT_MAX && clk == base->clk)
-		enqueue_timer(base, timer, idx, bucket_expiry);
+		enqueue_timer(base, timer, idx, bucket_expiry, true);
 	else
 		internal_add_timer(base, timer);
 
@@ -1807,6 +1878,25 @@ static void call_timer_fn(struct timer_list *timer,
 	}
 }
 
+/*
+ * Requeue a timer whose expiry was pushed out by mod_timer_lockless() while
+ * it was queued. When the timer migration code expires the base of an idle
+ * CPU remotely, that CPU must not be kicked for a non pinned timer: the
+ * migration code reevaluates the next expiry of the base right afterwards.
+ * The requeue is accounted in the base, i.e. to the CPU owning it.
+ */
+static void requeue_timer(struct timer_base *base, struct timer_list *timer)
+{
+	unsigned long bucket_expiry;
+	unsigned int idx;
+
+	debug_timer_activate(timer);
+	idx = calc_wheel_index(timer->expires, base->clk, &bucket_expiry);
+	enqueue_timer(base, timer, idx, bucket_expiry,
+		      base->cpu == smp_processor_id());
+	base->requeued++;
+}
+
 static void expire_timers(struct timer_base *base, struct hlist_head *head)
 {
 	/*
@@ -1819,12 +1909,27 @@ static void expire_timers(struct timer_base *base, struct hlist_head *head)
 	while (!hlist_empty(head)) {
 		struct timer_list *timer;
 		void (*fn)(struct timer_list *);
+		unsigned int lvl;
 
 		timer = hlist_entry(head->first, struct timer_list, entry);
 
-		base->running_timer = timer;
+		lvl = timer_get_idx(timer) / LVL_SIZE;
 		detach_timer(timer, true);
 
+		/*
+		 * Pairs with the cmpxchg() in mod_timer_lockless(). If the
+		 * expiry was pushed out while the timer was queued, requeue
+		 * it instead of running the callback.
+		 */
+		smp_mb();
+		if (lvl < LVL_DEPTH - 1 &&
+		    time_after_eq(READ_ONCE(timer->expires), base->clk)) {
+			requeue_timer(base, timer);
+			continue;
+		}
+
+		base->running_timer = timer;
+
 		fn = timer->function;
 
 		if (WARN_ON_ONCE(!fn)) {
@@ -136,6 +136,7 @@ static void print_cpu(struct seq_file *m, int cpu, u64 now)
 	P(nr_retries);
 	P(nr_hangs);
 	P(max_hang_time);
+	P(nr_coalesced);
 #endif
 #undef P
 #undef P_ns
@@ -174,6 +175,16 @@ static void print_cpu(struct seq_file *m, int cpu, u64 now)
 
 #undef P
 #undef P_ns
+
+	{
+		struct timer_mod_stats st;
+
+		timer_get_mod_stats(cpu, &st);
+		SEQ_printf(m, " timer wheel:\n");
+		SEQ_printf(m, "  .%-15s: %lu\n", "mod_lockless", st.lockless);
+		SEQ_printf(m, "  .%-15s: %lu\n", "mod_locked", st.locked);
+		SEQ_printf(m, "  .%-15s: %lu\n", "requeued", st.requeued);
+	}
 	SEQ_printf(m, "\n");
 }
 
@@ -94,6 +94,80 @@ static u64 bpf_kprobe_multi_entry_ip(struct bpf_run_ctx *ctx);
 static u64 bpf_uprobe_multi_cookie(struct bpf_run_ctx *ctx);
 static u64 bpf_uprobe_multi_entry_ip(struct bpf_run_ctx *ctx);
 
+/*
+ * Programs attached to kprobe, uprobe and tracepoint perf events are
+ * registered with a dispatcher, so that running them from trace_call_bpf()
+ * is a direct call rather than a retpolined indirect one. Programs that do
+ * not fit into the dispatcher are still called indirectly.
+ *
+ * Updating the dispatcher patches a static call and waits for an RCU grace
+ * period, which is neither something to do under perf_event ctx->mutex nor
+ * on every attach and detach syscall, so the updates are queued in order and
+ * applied from a work item.
+ */
+DEFINE_BPF_DISPATCHER(trace)
+
+struct bpf_trace_dispatcher_op {
+	struct list_head	list;
+	struct bpf_prog		*from;
+	struct bpf_prog		*to;
+};
+
+static LIST_HEAD(bpf_trace_dispatcher_ops);
+static DEFINE_SPINLOCK(bpf_trace_dispatcher_lock);
+
+static void bpf_trace_dispatcher_workfn(struct work_struct *work)
+{
+	struct bpf_trace_dispatcher_op *op, *tmp;
+	LIST_HEAD(ops);
+
+	spin_lock(&bpf_trace_dispatcher_lock);
+	list_splice_init(&bpf_trace_dispatcher_ops, &ops);
+	spin_unlock(&bpf_trace_dispatcher_lock);
+
+	list_for_each_entry_safe(op, tmp, &ops, list) {
+		bpf_dispatcher_change_prog(BPF_DISPATCHER_PTR(trace), op->from, op->to);
+		if (op->from)
+			bpf_prog_put(op->from);
+		if (op->to)
+			bpf_prog_put(op->to);
+		kfree(op);
+	}
+}
+
+static DECLARE_WORK(bpf_trace_dispatcher_work, bpf_trace_dispatcher_workfn);
+
+static void bpf_trace_dispatcher_change(struct bpf_prog *from, struct bpf_prog *to,
+					gfp_t gfp)
+{
+	struct bpf_trace_dispatcher_op *op;
+
+	if (!IS_ENABLED(CONFIG_BPF_JIT))
+		return;
+
+	op = kmalloc(sizeof(*op), gfp);
+	if (!op)
+		return;
+
+	op->from = from;
+	op->to = to;
+	if (from)
+		bpf_prog_inc(from);
+	if (to)
+		bpf_prog_inc(to);
+
+	spin_lock(&bpf_trace_dispatcher_lock);
+	list_add_tail(&op->list, &bpf_trace_dispatcher_ops);
+	spin_unlock(&bpf_trace_dispatcher_lock);
+	schedule_work(&bpf_trace_dispatcher_work);
+}
+
+static __always_inline u32 bpf_prog_run_trace(const struct bpf_prog *prog,
+					      const void *ctx)
+{
+	return __bpf_prog_run(prog, ctx, BPF_DISPATCHER_FUNC(trace));
+}
+
 /**
  * trace_call_bpf - invoke BPF program
  * @call: tracepoint event
@@ -145,7 +219,7 @@ unsigned int trace_call_bpf(struct trace_event_call *call, void *ctx)
 	 */
 	rcu_read_lock();
 	ret = bpf_prog_run_array(rcu_dereference(call->prog_array),
-				 ctx, bpf_prog_run);
+				 ctx, bpf_prog_run_trace);
 	rcu_read_unlock();
 
  out:
@@ -2286,6 +2360,9 @@ int perf_event_attach_bpf_prog(struct perf_event *event,
 	rcu_assign_pointer(event->tp_event->prog_array, new_array);
 	bpf_prog_array_free_sleepable(old_array);
 
+	/* If this fails, the program is just called indirectly */
+	bpf_trace_dispatcher_change(NULL, prog, GFP_KERNEL);
+
 unlock:
 	mutex_unlock(&bpf_event_mutex);
 	return ret;
@@ -2313,6 +2390,9 @@ void perf_event_detach_bpf_prog(struct perf_event *event)
 		bpf_prog_array_free_sleepable(old_array);
 	}
 
+	/* The dispatcher holds a reference, make sure it is dropped */
+	bpf_trace_dispatcher_change(event->prog, NULL, GFP_KERNEL | __GFP_NOFAIL);
+
 	bpf_prog_put(event->prog);
 	event->prog = NULL;
 
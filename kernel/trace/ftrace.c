@@ -2941,8 +2941,15 @@ void __weak arch_ftrace_update_code(int command)
 	ftrace_run_stop_machine(command);
 }
 
+/* Number of function record code updates and how long they took, in ns */
+unsigned long		ftrace_code_update_cnt;
+u64			ftrace_code_update_last;
+u64			ftrace_code_update_max;
+
 static void ftrace_run_update_code(int command)
 {
+	u64 start = ktime_get_ns();
+
 	ftrace_arch_code_modify_prepare();
 
 	/*
@@ -2954,6 +2961,10 @@ static void ftrace_run_update_code(int command)
 	arch_ftrace_update_code(command);
 
 	ftrace_arch_code_modify_post_process();
+
+	ftrace_code_update_last = ktime_get_ns() - start;
+	ftrace_code_update_max = max(ftrace_code_update_max, ftrace_code_update_last);
+	ftrace_code_update_cnt++;
 }
 
 static void ftrace_run_modify_code(struct ftrace_ops *ops, int command,
@@ -33,6 +33,8 @@ static struct trace_buffer *buffer;
 static struct task_struct *producer;
 static struct task_struct *consumer;
 static unsigned long read;
+/* time the consumer spent reading, in nsecs */
+static u64 read_time;
 
 static unsigned int disable_reader;
 module_param(disable_reader, uint, 0644);
@@ -187,11 +189,13 @@ static void ring_buffer_consumer(void)
 	read_events ^= 1;
 
 	read = 0;
+	read_time = 0;
 	/*
 	 * Continue running until the producer specifically asks to stop
 	 * and is ready for the completion.
 	 */
 	while (!READ_ONCE(reader_finish)) {
+		ktime_t start = ktime_get();
 		int found = 1;
 
 		while (found && !test_error) {
@@ -214,6 +218,7 @@ static void ring_buffer_consumer(void)
 
 			}
 		}
+		read_time += ktime_to_ns(ktime_sub(ktime_get(), start));
 
 		/* Wait till the producer wakes us up when there is more data
 		 * available or when the producer wants us to finish reading.
@@ -331,6 +336,16 @@ static void ring_buffer_producer(void)
 	else
 		trace_printk("Read:     %ld  (by %s)\n", read,
 			read_events ? "events" : "pages");
+	if (!disable_reader) {
+		u64 read_usecs = div_u64(read_time, NSEC_PER_USEC);
+
+		trace_printk("Read time: %llu (usecs)\n", read_usecs);
+		/* Reader throughput while it was actually reading */
+		if (read_usecs)
+			trace_printk("Reads per millisec: %llu (by %s)\n",
+				     div64_u64((u64)read * USEC_PER_MSEC, read_usecs),
+				     read_events ? "events" : "pages");
+	}
 	trace_printk("Entries:  %lld\n", entries);
 	trace_printk("Total:    %lld\n", entries + overruns + read);
 	trace_printk("Missed:   %ld\n", missed);
@@ -8418,6 +8418,27 @@ static const struct file_operations tracing_dyn_info_fops = {
 	.read		= tracing_read_dyn_info,
 	.llseek		= generic_file_llseek,
 };
+
+static ssize_t
+tracing_read_dyn_update_info(struct file *filp, char __user *ubuf,
+			     size_t cnt, loff_t *ppos)
+{
+	char buf[96];
+	int r;
+
+	r = scnprintf(buf, sizeof(buf), "updates: %lu last: %llu us max: %llu us\n",
+		      READ_ONCE(ftrace_code_update_cnt),
+		      div_u64(READ_ONCE(ftrace_code_update_last), NSEC_PER_USEC),
+		      div_u64(READ_ONCE(ftrace_code_update_max), NSEC_PER_USEC));
+
+	return simple_read_from_buffer(ubuf, cnt, ppos, buf, r);
+}
+
+static const struct file_operations tracing_dyn_update_info_fops = {
+	.open		= tracing_open_generic,
+	.read		= tracing_read_dyn_update_info,
+	.llseek		= generic_file_llseek,
+};
 #endif /* CONFIG_DYNAMIC_FTRACE */
 
 #if defined(CONFIG_TRACER_SNAPSHOT) && defined(CONFIG_DYNAMIC_FTRACE)
@@ -9887,6 +9908,8 @@ static __init void tracer_init_tracefs_work_func(struct work_struct *work)
 #ifdef CONFIG_DYNAMIC_FTRACE
 	trace_create_file("dyn_ftrace_total_info", TRACE_MODE_READ, NULL,
 			NULL, &tracing_dyn_info_fops);
+	trace_create_file("dyn_ftrace_update_info", TRACE_MODE_READ, NULL,
+			NULL, &tracing_dyn_update_info_fops);
 #endif
 
 	create_trace_instances(NULL);
@@ -35,6 +35,7 @@
 #include <linux/workqueue.h>
 #include <linux/slab.h>
 #include <linux/cpu.h>
+#include <linux/debugfs.h>
 #include <linux/notifier.h>
 #include <linux/kthread.h>
 #include <linux/hardirq.h>
@@ -51,6 +52,7 @@
 #include <linux/uaccess.h>
 #include <linux/sched/isolation.h>
 #include <linux/sched/debug.h>
+#include <linux/seq_file.h>
 #include <linux/nmi.h>
 #include <linux/kvm_para.h>
 #include <linux/delay.h>
@@ -223,6 +225,10 @@ struct worker_pool {
 	struct hlist_node	hash_node;	/* PL: unbound_pool_hash node */
 	int			refcnt;		/* PL: refcnt for unbound pools */
 
+	struct list_head	steal_node;	/* PR: node on wq_steal_pools */
+	unsigned long		nr_stolen;	/* L: work items stolen by us */
+	unsigned long		nr_lost;	/* L: work items stolen from us */
+
 	/*
 	 * Destruction of pool is RCU protected to allow dereferences
 	 * from get_work_pool().
@@ -433,6 +439,17 @@ static struct kmem_cache *pwq_cache;
 static struct wq_pod_type wq_pod_types[WQ_AFFN_NR_TYPES];
 static enum wq_affn_scope wq_affn_dfl = WQ_AFFN_CACHE;
 
+/*
+ * Workers of an unbound pool which run out of work may steal pending work items
+ * from a busy sibling pool, i.e. one for the same workqueue attributes but a
+ * different pod within the same pod of this scope. -1 disables stealing. See
+ * steal_work().
+ */
+static int wq_steal_scope = -1;
+
+/* maximum number of pending work items looked at per steal attempt */
+#define WQ_STEAL_SCAN		8
+
 /* buf for wq_update_unbound_pod_attrs(), protected by CPU hotplug exclusion */
 static struct workqueue_attrs *unbound_wq_update_pwq_attrs_buf;
 
@@ -443,6 +460,7 @@ static DEFINE_RAW_SPINLOCK(wq_mayday_lock);	/* protects wq->maydays list */
 static struct rcuwait manager_wait = __RCUWAIT_INITIALIZER(manager_wait);
 
 static LIST_HEAD(workqueues);		/* PR: list of all workqueues */
+static LIST_HEAD(wq_steal_pools);	/* PR: unbound pools which may steal */
 static bool workqueue_freezing;		/* PL: have wqs started freezing? */
 
 /* PL: mirror the cpu_online_mask excluding the CPU in the midst of hotplugging */
@@ -3323,6 +3341,160 @@ static void set_pf_worker(bool val)
 	mutex_unlock(&wq_pool_attach_mutex);
 }
 
+/* Do @pool and @victim share a pod of the stealing scope @scope? */
+static bool pool_steal_sibling(struct worker_pool *pool,
+			       struct worker_pool *victim, int scope)
+{
+	const struct wq_pod_type *pt = &wq_pod_types[scope];
+
+	if (victim == pool || !pt->nr_pods)
+		return false;
+
+	return pt->cpu_pod[cpumask_first(pool->attrs->__pod_cpumask)] ==
+		pt->cpu_pod[cpumask_first(victim->attrs->__pod_cpumask)];
+}
+
+/**
+ * steal_work_from - move a pending work item from @victim to @pool
+ * @pool: thief worker_pool
+ * @victim: busy sibling worker_pool
+ *
+ * Look at the first %WQ_STEAL_SCAN work items on @victim's worklist and move
+ * the first one which can safely run on @pool. Work items of ordered
+ * workqueues, barriers and work items with barriers linked to them are left
+ * alone. So are work items still executing on @victim, which would just end up
+ * back on @victim to guarantee non-reentrancy.
+ *
+ * The work item is moved with both pool locks held, so flushers and cancelers
+ * always find it either on @victim or on @pool. As pool locks don't nest,
+ * @pool's lock is only trylocked. The move changes the pwq, so it is only done
+ * while no flush_workqueue() is in progress on either pwq and both are on the
+ * same work color, which keeps the flush color of the work item unchanged.
+ *
+ * CONTEXT:
+ * IRQ disabled, RCU read locked.
+ *
+ * Return: %true if a work item was moved.
+ */
+static bool steal_work_from(struct worker_pool *pool, struct worker_pool *victim)
+{
+	int cpu = cpumask_first(pool->attrs->__pod_cpumask);
+	struct work_struct *work;
+	bool stolen = false;
+	int scanned = 0;
+
+	raw_spin_lock(&victim->lock);
+
+	/* an idle worker is about to take care of the worklist */
+	if (victim->nr_idle)
+		goto out_unlock_victim;
+
+	if (!raw_spin_trylock(&pool->lock))
+		goto out_unlock_victim;
+
+	list_for_each_entry(work, &victim->worklist, entry) {
+		unsigned long work_data = *work_data_bits(work);
+		struct pool_workqueue *pwq = get_work_pwq(work);
+		struct workqueue_struct *wq = pwq->wq;
+		struct pool_workqueue *new_pwq;
+
+		if (++scanned > WQ_STEAL_SCAN)
+			break;
+
+		if (work_data & (WORK_STRUCT_INACTIVE | WORK_STRUCT_LINKED))
+			continue;
+
+		if (wq->flags & (__WQ_ORDERED | __WQ_DESTROYING | __WQ_DRAINING))
+			continue;
+
+		/* must be the pwq @work would be queued to from @cpu */
+		new_pwq = rcu_dereference(*per_cpu_ptr(wq->cpu_pwq, cpu));
+		if (new_pwq->pool != pool || !new_pwq->refcnt)
+			continue;
+
+		if (pwq->flush_color != -1 || new_pwq->flush_color != -1 ||
+		    get_work_color(work_data) != new_pwq->work_color)
+			continue;
+
+		if (find_worker_executing_work(victim, work))
+			continue;
+
+		if (!list_empty(&new_pwq->inactive_works) ||
+		    !pwq_tryinc_nr_active(new_pwq, false))
+			continue;
+
+		debug_work_deactivate(work);
+		list_del_init(&work->entry);
+		victim->nr_lost++;
+
+		new_pwq->nr_in_flight[new_pwq->work_color]++;
+		if (list_empty(&pool->worklist))
+			pool->watchdog_ts = jiffies;
+		trace_workqueue_activate_work(work);
+		insert_work(new_pwq, work, &pool->worklist,
+			    work_color_to_flags(new_pwq->work_color));
+
+		/* may drop the last reference to @pwq, must be the last step */
+		pwq_dec_nr_in_flight(pwq, work_data);
+		stolen = true;
+		break;
+	}
+
+	raw_spin_unlock(&pool->lock);
+out_unlock_victim:
+	raw_spin_unlock(&victim->lock);
+	return stolen;
+}
+
+/**
+ * steal_work - steal a pending work item from a busy sibling pool
+ * @worker: worker which is about to go idle
+ *
+ * A work item queued on an unbound pool waits there until one of the pool's
+ * workers is done with what it's executing or a new worker is created, even
+ * if a pool of a neighbouring pod sits idle. If workqueue.steal_affinity_scope
+ * is set, let @worker take one pending work item from a sibling pool which has
+ * no idle workers before going to sleep. Strict affinity pools neither steal
+ * nor get stolen from.
+ *
+ * CONTEXT:
+ * raw_spin_lock_irq(pool->lock) which may be released and regrabbed.
+ *
+ * Return: %true if a work item was moved to @worker's pool.
+ */
+static bool steal_work(struct worker *worker)
+{
+	struct worker_pool *pool = worker->pool, *victim;
+	int scope = READ_ONCE(wq_steal_scope);
+	bool stolen = false;
+
+	lockdep_assert_held(&pool->lock);
+
+	if (scope < 0 || pool->cpu >= 0 || list_empty(&pool->steal_node))
+		return false;
+
+	raw_spin_unlock(&pool->lock);
+	rcu_read_lock();
+
+	list_for_each_entry_rcu(victim, &wq_steal_pools, steal_node) {
+		if (!pool_steal_sibling(pool, victim, scope) ||
+		    list_empty(&victim->worklist) || data_race(victim->nr_idle))
+			continue;
+
+		if (steal_work_from(pool, victim)) {
+			stolen = true;
+			break;
+		}
+	}
+
+	rcu_read_unlock();
+	raw_spin_lock(&pool->lock);
+
+	if (stolen)
+		pool->nr_stolen++;
+	return stolen;
+}
+
 /**
  * worker_thread - the worker thread function
  * @__worker: self
@@ -3395,6 +3567,10 @@ static int worker_thread(void *__worker)
 
 	worker_set_flags(worker, WORKER_PREP);
 sleep:
+	/* see if a busy sibling pool has something for us before sleeping */
+	if (steal_work(worker))
+		goto recheck;
+
 	/*
 	 * pool->lock is held and there's no work to process and no need to
 	 * manage, sleep.  Workers are woken up only while holding
@@ -4120,6 +4296,7 @@ static bool start_flush_work(struct work_struct *work, struct wq_barrier *barr,
 	struct workqueue_struct *wq;
 
 	rcu_read_lock();
+retry:
 	pool = get_work_pool(work);
 	if (!pool) {
 		rcu_read_unlock();
@@ -4130,8 +4307,15 @@ static bool start_flush_work(struct work_struct *work, struct wq_barrier *barr,
 	/* see the comment in try_to_grab_pending() with the same code */
 	pwq = get_work_pwq(work);
 	if (pwq) {
-		if (unlikely(pwq->pool != pool))
-			goto already_gone;
+		/*
+		 * @work was queued on another pool since get_work_pool(),
+		 * e.g. moved there by steal_work_from(). Follow it, as that
+		 * is the instance to wait for.
+		 */
+		if (unlikely(pwq->pool != pool)) {
+			raw_spin_unlock_irq(&pool->lock);
+			goto retry;
+		}
 	} else {
 		worker = find_worker_executing_work(pool, work);
 		if (!worker)
@@ -4754,6 +4938,7 @@ static int init_worker_pool(struct worker_pool *pool)
 	ida_init(&pool->worker_ida);
 	INIT_HLIST_NODE(&pool->hash_node);
 	pool->refcnt = 1;
+	INIT_LIST_HEAD(&pool->steal_node);
 
 	/* shouldn't fail above this point */
 	pool->attrs = alloc_workqueue_attrs();
@@ -4908,6 +5093,8 @@ static void put_unbound_pool(struct worker_pool *pool)
 	if (pool->id >= 0)
 		idr_remove(&worker_pool_idr, pool->id);
 	hash_del(&pool->hash_node);
+	if (!list_empty(&pool->steal_node))
+		list_del_rcu(&pool->steal_node);
 
 	/*
 	 * Become the manager and destroy all workers.  This prevents
@@ -5014,6 +5201,8 @@ static struct worker_pool *get_unbound_pool(const struct workqueue_attrs *attrs)
 
 	/* install */
 	hash_add(unbound_pool_hash, &pool->hash_node, hash);
+	if (!pool->attrs->affn_strict)
+		list_add_tail_rcu(&pool->steal_node, &wq_steal_pools);
 
 	return pool;
 fail:
@@ -6946,6 +7135,73 @@ static const struct kernel_param_ops wq_affn_dfl_ops = {
 
 module_param_cb(default_affinity_scope, &wq_affn_dfl_ops, NULL, 0644);
 
+static int wq_steal_scope_set(const char *val, const struct kernel_param *kp)
+{
+	int affn;
+
+	if (sysfs_streq(val, "none")) {
+		WRITE_ONCE(wq_steal_scope, -1);
+		return 0;
+	}
+
+	affn = parse_affn_scope(val);
+	if (affn != WQ_AFFN_CACHE && affn != WQ_AFFN_NUMA)
+		return -EINVAL;
+
+	WRITE_ONCE(wq_steal_scope, affn);
+	return 0;
+}
+
+static int wq_steal_scope_get(char *buffer, const struct kernel_param *kp)
+{
+	int scope = READ_ONCE(wq_steal_scope);
+
+	return scnprintf(buffer, PAGE_SIZE, "%s\n",
+			 scope < 0 ? "none" : wq_affn_names[scope]);
+}
+
+static const struct kernel_param_ops wq_steal_scope_ops = {
+	.set	= wq_steal_scope_set,
+	.get	= wq_steal_scope_get,
+};
+
+module_param_cb(steal_affinity_scope, &wq_steal_scope_ops, NULL, 0644);
+
+#ifdef CONFIG_DEBUG_FS
+static int wq_steal_stats_show(struct seq_file *m, void *v)
+{
+	struct worker_pool *pool;
+	int pi;
+
+	seq_puts(m, "pool   node     stolen       lost cpus\n");
+
+	rcu_read_lock();
+	for_each_pool(pool, pi) {
+		if (pool->cpu >= 0 || list_empty(&pool->steal_node))
+			continue;
+
+		seq_printf(m, "%-6d %4d %10lu %10lu %*pbl\n", pool->id,
+			   pool->node, data_race(pool->nr_stolen),
+			   data_race(pool->nr_lost),
+			   cpumask_pr_args(pool->attrs->__pod_cpumask));
+	}
+	rcu_read_unlock();
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(wq_steal_stats);
+
+static int __init wq_debugfs_init(void)
+{
+	struct dentry *dir = debugfs_create_dir("workqueue", NULL);
+
+	debugfs_create_file("steal_stats", 0444, dir, NULL,
+			    &wq_steal_stats_fops);
+	return 0;
+}
+late_initcall(wq_debugfs_init);
+#endif	/* CONFIG_DEBUG_FS */
+
 #ifdef CONFIG_SYSFS
 /*
  * Workqueues with WQ_SYSFS flag set is visible to userland via
@@ -6302,6 +6302,8 @@ void __init maple_tree_init(void)
 	maple_node_cache = kmem_cache_create("maple_node",
 			sizeof(struct maple_node), sizeof(struct maple_node),
 			SLAB_PANIC, NULL);
+	/* Nodes are allocated and freed in bulk; failure is harmless */
+	kmem_cache_setup_sheaves(maple_node_cache, 32);
 }
 
 /**
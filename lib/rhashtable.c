@@ -28,6 +28,8 @@
 
 #define HASH_DEFAULT_SIZE	64UL
 #define HASH_MIN_SIZE		4U
+/* Number of buckets moved by one run of the deferred worker. */
+#define RHT_REHASH_BATCH	4096U
 
 union nested_table {
 	union nested_table __rcu *table;
@@ -328,10 +330,17 @@ static int rhashtable_rehash_table(struct rhashtable *ht)
 	if (!new_tbl)
 		return 0;
 
-	for (old_hash = 0; old_hash < old_tbl->size; old_hash++) {
+	for (old_hash = old_tbl->rehash; old_hash < old_tbl->size; old_hash++) {
+		/* Let inserters and other users of the mutex make progress. */
+		if (old_hash - old_tbl->rehash >= RHT_REHASH_BATCH) {
+			old_tbl->rehash = old_hash;
+			return -EAGAIN;
+		}
 		err = rhashtable_rehash_chain(ht, old_hash);
-		if (err)
+		if (err) {
+			old_tbl->rehash = old_hash;
 			return err;
+		}
 		cond_resched();
 	}
 
@@ -0,0 +1,132 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Parallel sort for large arrays: sort chunks on several CPUs with sort(),
+ * then merge the sorted runs.
+ */
+
+#include <linux/cpumask.h>
+#include <linux/export.h>
+#include <linux/kernel.h>
+#include <linux/log2.h>
+#include <linux/minmax.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/sort.h>
+#include <linux/string.h>
+#include <linux/workqueue.h>
+
+/* Arrays shorter than this are not worth splitting across CPUs. */
+#define SORT_PARALLEL_MIN	(1UL << 16)
+#define SORT_PARALLEL_MAX_CHUNKS	16U
+
+struct sort_chunk {
+	struct work_struct work;
+	void *base;
+	size_t num;
+	size_t size;
+	cmp_func_t cmp_func;
+};
+
+static void sort_chunk_fn(struct work_struct *work)
+{
+	struct sort_chunk *chunk = container_of(work, struct sort_chunk, work);
+
+	sort(chunk->base, chunk->num, chunk->size, chunk->cmp_func, NULL);
+}
+
+static void merge_runs(void *dst, const void *a, size_t na,
+		       const void *b, size_t nb, size_t size,
+		       cmp_func_t cmp_func)
+{
+	while (na && nb) {
+		if (cmp_func(b, a) < 0) {
+			memcpy(dst, b, size);
+			b += size;
+			nb--;
+		} else {
+			memcpy(dst, a, size);
+			a += size;
+			na--;
+		}
+		dst += size;
+	}
+	memcpy(dst, a, na * size);
+	memcpy(dst + na * size, b, nb * size);
+}
+
+/**
+ * sort_parallel - sort a large array using several CPUs
+ * @base: pointer to data to sort
+ * @num: number of elements
+ * @size: size of each element
+ * @cmp_func: pointer to comparison function
+ *
+ * Splits the array into one chunk per CPU (up to 16), sorts the chunks
+ * with sort() on the unbound workqueue, and merges them through a
+ * temporary buffer.  Elements are moved with memcpy(), so there is no
+ * swap_func.  Small arrays, uniprocessor systems and allocation failures
+ * fall back to a plain sort().  The sort is not stable.
+ *
+ * Context: Process context, may sleep.
+ */
+void sort_parallel(void *base, size_t num, size_t size, cmp_func_t cmp_func)
+{
+	struct sort_chunk *chunks = NULL;
+	unsigned int nr, i, w;
+	void *tmp = NULL, *src, *dst;
+	size_t per_chunk;
+
+	might_sleep();
+
+	nr = min_t(unsigned int, rounddown_pow_of_two(num_online_cpus()),
+		   SORT_PARALLEL_MAX_CHUNKS);
+	if (num < SORT_PARALLEL_MIN || nr < 2)
+		goto serial;
+
+	tmp = kvmalloc_array(num, size, GFP_KERNEL);
+	chunks = kcalloc(nr, sizeof(*chunks), GFP_KERNEL);
+	if (!tmp || !chunks)
+		goto serial;
+
+	per_chunk = DIV_ROUND_UP(num, nr);
+	for (i = 0; i < nr; i++) {
+		size_t start = min(i * per_chunk, num);
+
+		chunks[i].base = base + start * size;
+		chunks[i].num = min(start + per_chunk, num) - start;
+		chunks[i].size = size;
+		chunks[i].cmp_func = cmp_func;
+		INIT_WORK(&chunks[i].work, sort_chunk_fn);
+		queue_work(system_unbound_wq, &chunks[i].work);
+	}
+	for (i = 0; i < nr; i++)
+		flush_work(&chunks[i].work);
+
+	/* Merge pairs of sorted runs, doubling the run length each pass. */
+	src = base;
+	dst = tmp;
+	for (w = 1; w < nr; w *= 2) {
+		for (i = 0; i < nr; i += 2 * w) {
+			size_t lo = min(i * per_chunk, num);
+			size_t mid = min((i + w) * per_chunk, num);
+			size_t hi = min((i + 2 * w) * per_chunk, num);
+
+			merge_runs(dst + lo * size, src + lo * size, mid - lo,
+				   src + mid * size, hi - mid, size, cmp_func);
+			cond_resched();
+		}
+		swap(src, dst);
+	}
+	if (src != base)
+		memcpy(base, src, num * size);
+
+	kfree(chunks);
+	kvfree(tmp);
+	return;
+
+serial:
+	kfree(chunks);
+	kvfree(tmp);
+	sort(base, num, size, cmp_func, NULL);
+}
+EXPORT_SYMBOL(sort_parallel);
@@ -48,6 +48,7 @@ atomic_t maple_tree_tests_passed;
 /* #define BENCH_FORK */
 /* #define BENCH_MAS_FOR_EACH */
 /* #define BENCH_MAS_PREV */
+/* #define BENCH_MAS_APPEND */
 
 #ifdef __KERNEL__
 #define mt_set_non_kernel(x)		do {} while (0)
@@ -1852,6 +1853,44 @@ static noinline void __init bench_mas_prev(struct maple_tree *mt)
 
 }
 #endif
+#if defined(BENCH_MAS_APPEND)
+/* Build and tear down a munmap style detach tree, one index per entry. */
+static noinline void __init bench_mas_append(struct maple_tree *mt)
+{
+	int i, j, count = 10000, nr_entries = 1000;
+	MA_STATE(mas, mt, 0, 0);
+
+	for (i = 0; i < count; i++) {
+		mas_lock(&mas);
+		mas_set(&mas, 0);
+		for (j = 0; j < nr_entries; j++) {
+			__mas_set_range(&mas, j, j);
+			mas_store_gfp(&mas, xa_mk_value(j), GFP_KERNEL);
+		}
+		mas_unlock(&mas);
+		mtree_destroy(mt);
+	}
+}
+#endif
+/* check_mas_append - append entries at increasing indices without a reset */
+static noinline void __init check_mas_append(struct maple_tree *mt)
+{
+	int i, nr_entries = 1000;
+	MA_STATE(mas, mt, 0, 0);
+
+	mas_lock(&mas);
+	for (i = 0; i < nr_entries; i++) {
+		__mas_set_range(&mas, i, i);
+		MT_BUG_ON(mt, mas_store_gfp(&mas, xa_mk_value(i), GFP_KERNEL));
+	}
+	mas_unlock(&mas);
+
+	for (i = 0; i < nr_entries; i++)
+		MT_BUG_ON(mt, mtree_load(mt, i) != xa_mk_value(i));
+	MT_BUG_ON(mt, mtree_load(mt, nr_entries) != NULL);
+	mt_validate(mt);
+}
+
 /* check_forking - simulate the kernel forking sequence with the tree. */
 static noinline void __init check_forking(void)
 {
@@ -3709,11 +3748,22 @@ static int __init maple_tree_seed(void)
 	mtree_destroy(&tree);
 	goto skip;
 #endif
+#if defined(BENCH_MAS_APPEND)
+#define BENCH
+	mt_init_flags(&tree, 0);
+	bench_mas_append(&tree);
+	mtree_destroy(&tree);
+	goto skip;
+#endif
 
 	mt_init_flags(&tree, MT_FLAGS_ALLOC_RANGE);
 	check_root_expand(&tree);
 	mtree_destroy(&tree);
 
+	mt_init_flags(&tree, 0);
+	check_mas_append(&tree);
+	mtree_destroy(&tree);
+
 	mt_init_flags(&tree, MT_FLAGS_ALLOC_RANGE);
 	check_iteration(&tree);
 	mtree_destroy(&tree);
@@ -0,0 +1,163 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Measure alloc_percpu() and free_percpu() throughput against the number
+ * of CPUs allocating at the same time.
+ *
+ * For 1, 2, 4, ... up to max_cpus CPUs, one thread per CPU allocates
+ * batch areas of the given size, frees them and repeats, nr_loops times.
+ * The module reports the rate at each step and unloads itself.
+ */
+#define pr_fmt(fmt) KBUILD_MODNAME ": " fmt
+
+#include <linux/atomic.h>
+#include <linux/completion.h>
+#include <linux/cpumask.h>
+#include <linux/kthread.h>
+#include <linux/ktime.h>
+#include <linux/module.h>
+#include <linux/moduleparam.h>
+#include <linux/percpu.h>
+#include <linux/slab.h>
+
+#define MAX_BATCH	256
+
+static unsigned int max_cpus;
+module_param(max_cpus, uint, 0444);
+MODULE_PARM_DESC(max_cpus, "Max number of allocating CPUs (default: all online)");
+
+static unsigned int size = 8;
+module_param(size, uint, 0444);
+MODULE_PARM_DESC(size, "Size of each area in bytes (default: 8)");
+
+static unsigned int batch = 16;
+module_param(batch, uint, 0444);
+MODULE_PARM_DESC(batch, "Areas allocated before freeing them (default: 16)");
+
+static unsigned int nr_loops = 10000;
+module_param(nr_loops, uint, 0444);
+MODULE_PARM_DESC(nr_loops, "Batches per thread (default: 10000)");
+
+static atomic_t nr_running;
+static atomic_t nr_failed;
+static DECLARE_COMPLETION(all_started);
+static DECLARE_COMPLETION(all_done);
+
+static int bench_thread(void *data)
+{
+	void __percpu **ptrs = data;
+	unsigned int i, j;
+
+	if (atomic_dec_and_test(&nr_running))
+		complete_all(&all_started);
+	else
+		wait_for_completion(&all_started);
+
+	for (i = 0; i < nr_loops; i++) {
+		for (j = 0; j < batch; j++) {
+			ptrs[j] = __alloc_percpu(size, __alignof__(u64));
+			if (!ptrs[j])
+				atomic_inc(&nr_failed);
+		}
+		for (j = 0; j < batch; j++)
+			free_percpu(ptrs[j]);
+		cond_resched();
+	}
+
+	return 0;
+}
+
+static int run_bench(unsigned int nr_cpus)
+{
+	struct task_struct **tasks;
+	void __percpu **ptrs;
+	unsigned int i, cpu;
+	ktime_t start;
+	u64 ns, ops;
+	int ret = 0;
+
+	tasks = kcalloc(nr_cpus, sizeof(*tasks), GFP_KERNEL);
+	ptrs = kcalloc(nr_cpus * batch, sizeof(*ptrs), GFP_KERNEL);
+	if (!tasks || !ptrs) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	reinit_completion(&all_started);
+	atomic_set(&nr_running, nr_cpus + 1);
+	atomic_set(&nr_failed, 0);
+
+	i = 0;
+	for_each_online_cpu(cpu) {
+		if (i == nr_cpus)
+			break;
+
+		tasks[i] = kthread_create_on_cpu(bench_thread, ptrs + i * batch,
+						 cpu, "percpu_bench/%u");
+		if (IS_ERR(tasks[i])) {
+			ret = PTR_ERR(tasks[i]);
+			tasks[i] = NULL;
+			break;
+		}
+		get_task_struct(tasks[i]);
+		wake_up_process(tasks[i]);
+		i++;
+	}
+
+	/* don't wait for threads that were not started */
+	if (i < nr_cpus)
+		atomic_sub(nr_cpus - i, &nr_running);
+
+	if (atomic_dec_and_test(&nr_running))
+		complete_all(&all_started);
+	else
+		wait_for_completion(&all_started);
+	start = ktime_get();
+
+	/* kthread_stop() waits for each thread to return */
+	for (i = 0; i < nr_cpus && tasks[i]; i++) {
+		kthread_stop(tasks[i]);
+		put_task_struct(tasks[i]);
+	}
+	ns = ktime_to_ns(ktime_sub(ktime_get(), start));
+
+	if (ret) {
+		pr_err("failed to start thread for %u cpus: %d\n", nr_cpus, ret);
+		goto out;
+	}
+
+	ops = (u64)nr_cpus * nr_loops * batch;
+	pr_info("cpus %3u: %llu allocs/sec, %llu ns/alloc+free, %d failed\n",
+		nr_cpus, div64_u64(ops * NSEC_PER_SEC, max_t(u64, ns, 1)),
+		div64_u64(ns * nr_cpus, max_t(u64, ops, 1)),
+		atomic_read(&nr_failed));
+out:
+	kfree(ptrs);
+	kfree(tasks);
+	return ret;
+}
+
+static int __init test_percpu_alloc_init(void)
+{
+	unsigned int nr_cpus, limit = num_online_cpus();
+
+	if (!size || !batch || batch > MAX_BATCH)
+		return -EINVAL;
+
+	if (max_cpus && max_cpus < limit)
+		limit = max_cpus;
+
+	pr_info("size %u batch %u loops %u\n", size, batch, nr_loops);
+
+	for (nr_cpus = 1; ; nr_cpus = min(nr_cpus * 2, limit)) {
+		if (run_bench(nr_cpus))
+			break;
+		if (nr_cpus == limit)
+			break;
+	}
+
+	return -EAGAIN; /* Fail will directly unload the module */
+}
+module_init(test_percpu_alloc_init);
+
+MODULE_LICENSE("GPL");
+MODULE_DESCRIPTION("percpu allocator scalability benchmark");
@@ -212,7 +212,7 @@ static s64 __init test_rhashtable(struct rhashtable *ht, struct test_obj *array,
 	struct test_obj *obj;
 	int err;
 	unsigned int i, insert_retries = 0;
-	s64 start, end;
+	s64 start, end, t, max_insert = 0;
 
 	/*
 	 * Insertion Test:
@@ -224,7 +224,11 @@ static s64 __init test_rhashtable(struct rhashtable *ht, struct test_obj *array,
 		struct test_obj *obj = &array[i];
 
 		obj->value.id = i * 2;
+		t = ktime_get_ns();
 		err = insert_retry(ht, obj, test_rht_params);
+		t = ktime_get_ns() - t;
+		if (t > max_insert)
+			max_insert = t;
 		if (err > 0)
 			insert_retries += err;
 		else if (err)
@@ -234,6 +238,7 @@ static s64 __init test_rhashtable(struct rhashtable *ht, struct test_obj *array,
 	if (insert_retries)
 		pr_info("  %u insertions retried due to memory pressure\n",
 			insert_retries);
+	pr_info("  Max insert latency: %lld ns\n", max_insert);
 
 	test_bucket_stats(ht, entries);
 	rcu_read_lock();
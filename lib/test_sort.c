@@ -45,8 +45,33 @@ static void test_sort(struct kunit *test)
 		KUNIT_ASSERT_LE(test, a[i], a[i + 1]);
 }
 
+#define TEST_LEN_PARALLEL (1 << 18)
+
+static void test_sort_parallel(struct kunit *test)
+{
+	int *a, i, r = 1;
+
+	a = kvmalloc_array(TEST_LEN_PARALLEL, sizeof(*a), GFP_KERNEL);
+	KUNIT_ASSERT_NOT_ERR_OR_NULL(test, a);
+
+	for (i = 0; i < TEST_LEN_PARALLEL; i++) {
+		r = (r * 725861) % 6599;
+		a[i] = r;
+	}
+
+	sort_parallel(a, TEST_LEN_PARALLEL - 1, sizeof(*a), cmpint);
+
+	for (i = 0; i < TEST_LEN_PARALLEL - 2; i++) {
+		if (a[i] > a[i + 1])
+			break;
+	}
+	kvfree(a);
+	KUNIT_EXPECT_EQ(test, i, TEST_LEN_PARALLEL - 2);
+}
+
 static struct kunit_case sort_test_cases[] = {
 	KUNIT_CASE(test_sort),
+	KUNIT_CASE(test_sort_parallel),
 	{}
 };
 
@@ -0,0 +1,133 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Measure the rate of mod_timer() on a pending timer which keeps being
+ * pushed out, the pattern of networking retransmit and keepalive timers.
+ *
+ * One kthread per online CPU (or nr_threads of them) rearms its own timer
+ * to jiffies + timeout_ms in a tight loop for duration seconds. With the
+ * default timeout the timers never expire. The aggregate rate is printed
+ * when the module is loaded; the module always fails to load so that the
+ * test can be repeated. The per-CPU split between lockless and locked
+ * rearms is shown in /proc/timer_list.
+ */
+
+#define pr_fmt(fmt)	KBUILD_MODNAME ": " fmt
+
+#include <linux/completion.h>
+#include <linux/cpumask.h>
+#include <linux/delay.h>
+#include <linux/jiffies.h>
+#include <linux/kthread.h>
+#include <linux/module.h>
+#include <linux/sched.h>
+#include <linux/slab.h>
+#include <linux/timer.h>
+
+static unsigned int nr_threads;
+module_param(nr_threads, uint, 0444);
+MODULE_PARM_DESC(nr_threads, "Number of threads (default: number of online CPUs)");
+
+static unsigned int duration = 5;
+module_param(duration, uint, 0444);
+MODULE_PARM_DESC(duration, "Test duration in seconds (default: 5)");
+
+static unsigned int timeout_ms = 200;
+module_param(timeout_ms, uint, 0444);
+MODULE_PARM_DESC(timeout_ms, "Timeout the timers are rearmed to (default: 200)");
+
+struct timer_mod_worker {
+	struct task_struct	*task;
+	struct timer_list	timer;
+	struct completion	done;
+	unsigned long		ops;
+	unsigned long		fired;
+};
+
+static bool stop_test;
+
+static void timer_mod_fn(struct timer_list *t)
+{
+	struct timer_mod_worker *w = from_timer(w, t, timer);
+
+	WRITE_ONCE(w->fired, w->fired + 1);
+}
+
+static int timer_mod_thread(void *arg)
+{
+	struct timer_mod_worker *w = arg;
+	unsigned long timeout = msecs_to_jiffies(timeout_ms);
+
+	mod_timer(&w->timer, jiffies + timeout);
+
+	while (!READ_ONCE(stop_test)) {
+		mod_timer(&w->timer, jiffies + timeout);
+		if (!(++w->ops & 1023))
+			cond_resched();
+	}
+
+	timer_delete_sync(&w->timer);
+	complete(&w->done);
+
+	/* Wait to be stopped, so that the task is still around for us */
+	while (!kthread_should_stop())
+		schedule_timeout_interruptible(HZ);
+	return 0;
+}
+
+static int __init test_timer_mod_init(void)
+{
+	struct timer_mod_worker *workers;
+	unsigned long ops = 0, fired = 0;
+	unsigned int i, started = 0;
+	int cpu;
+
+	if (!nr_threads)
+		nr_threads = num_online_cpus();
+
+	workers = kcalloc(nr_threads, sizeof(*workers), GFP_KERNEL);
+	if (!workers)
+		return -ENOMEM;
+
+	WRITE_ONCE(stop_test, false);
+
+	cpu = cpumask_first(cpu_online_mask);
+	for (i = 0; i < nr_threads; i++) {
+		struct timer_mod_worker *w = &workers[i];
+
+		timer_setup(&w->timer, timer_mod_fn, 0);
+		init_completion(&w->done);
+		w->task = kthread_run_on_cpu(timer_mod_thread, w, cpu,
+					     "test_timer_mod/%u");
+		if (IS_ERR(w->task)) {
+			pr_err("failed to start thread %u\n", i);
+			break;
+		}
+		started++;
+
+		cpu = cpumask_next(cpu, cpu_online_mask);
+		if (cpu >= nr_cpu_ids)
+			cpu = cpumask_first(cpu_online_mask);
+	}
+
+	if (started)
+		ssleep(duration);
+	WRITE_ONCE(stop_test, true);
+
+	for (i = 0; i < started; i++) {
+		wait_for_completion(&workers[i].done);
+		kthread_stop(workers[i].task);
+		ops += workers[i].ops;
+		fired += READ_ONCE(workers[i].fired);
+	}
+
+	if (started && duration)
+		pr_info("%u threads, timeout %u ms: %lu mod_timer/s, %lu expired\n",
+			started, timeout_ms, ops / duration, fired);
+
+	kfree(workers);
+	return -EAGAIN;
+}
+module_init(test_timer_mod_init);
+
+MODULE_DESCRIPTION("Test module measuring mod_timer() rearm rate");
+MODULE_LICENSE("GPL");
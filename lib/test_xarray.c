@@ -1344,6 +1344,32 @@ static noinline void check_find_4(struct xarray *xa)
 	xa_erase_index(xa, ULONG_MAX);
 }
 
+static noinline void check_find_copy_mark(struct xarray *xa)
+{
+	XA_STATE(xas, xa, 0);
+	unsigned long i, max = 300;
+	unsigned int nr = 0;
+	void *entry;
+
+	for (i = 0; i < 1000; i += 3) {
+		xa_store_index(xa, i, GFP_KERNEL);
+		if (i % 2)
+			xa_set_mark(xa, i, XA_MARK_0);
+	}
+
+	xas_lock(&xas);
+	xas_for_each_marked(&xas, entry, max, XA_MARK_0)
+		nr += xas_copy_mark_node(&xas, max, XA_MARK_0, XA_MARK_1);
+	xas_unlock(&xas);
+
+	for (i = 0; i < 1000; i += 3)
+		XA_BUG_ON(xa, xa_get_mark(xa, i, XA_MARK_1) !=
+				(i % 2 && i <= max));
+	XA_BUG_ON(xa, nr != (max / 3 + 1) / 2);
+	XA_BUG_ON(xa, !xa_marked(xa, XA_MARK_1));
+	xa_destroy(xa);
+}
+
 static noinline void check_find(struct xarray *xa)
 {
 	unsigned i;
@@ -1352,6 +1378,7 @@ static noinline void check_find(struct xarray *xa)
 	check_find_2(xa);
 	check_find_3(xa);
 	check_find_4(xa);
+	check_find_copy_mark(xa);
 
 	for (i = 2; i < 10; i++)
 		check_multi_find_1(xa, i);
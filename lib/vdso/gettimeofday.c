@@ -285,6 +285,94 @@ __cvdso_clock_gettime(clockid_t clock, struct __kernel_timespec *ts)
 	return __cvdso_clock_gettime_data(__arch_get_vdso_data(), clock, ts);
 }
 
+/*
+ * Read @nr clocks from a single snapshot of the time data and a single
+ * counter read, so that the timestamps are consistent with each other and
+ * the cost of the sequence count section and counter access is paid once.
+ * Anything the snapshot cannot handle (an unsupported clock, a time
+ * namespace, a clocksource without vDSO support) reads the clocks one by
+ * one instead.
+ */
+static __maybe_unused int
+__cvdso_clock_gettime_multi_data(const struct vdso_data *vd,
+				 const clockid_t *clocks,
+				 struct __kernel_timespec *ts, unsigned int nr)
+{
+	const struct vdso_data *vdh = &vd[CS_HRES_COARSE];
+	unsigned int i;
+	u32 msk = 0;
+	u64 cycles;
+	u32 seq;
+	int ret;
+
+	if (!__arch_vdso_hres_capable())
+		goto fallback;
+
+	for (i = 0; i < nr; i++) {
+		if (unlikely((u32) clocks[i] >= MAX_CLOCKS))
+			goto fallback;
+		msk |= 1U << clocks[i];
+	}
+	if (unlikely(msk & ~(VDSO_HRES | VDSO_COARSE | VDSO_RAW)))
+		goto fallback;
+
+	do {
+		/* See the comment in do_hres() */
+		while (unlikely((seq = READ_ONCE(vdh->seq)) & 1)) {
+			if (IS_ENABLED(CONFIG_TIME_NS) &&
+			    vdh->clock_mode == VDSO_CLOCKMODE_TIMENS)
+				goto fallback;
+			cpu_relax();
+		}
+		smp_rmb();
+
+		if (unlikely(!vdso_clocksource_ok(vdh)))
+			goto fallback;
+
+		cycles = __arch_get_hw_counter(vdh->clock_mode, vdh);
+		if (unlikely(!vdso_cycles_ok(cycles)))
+			goto fallback;
+
+		/* CS_RAW is updated within the same sequence count section */
+		for (i = 0; i < nr; i++) {
+			clockid_t clk = clocks[i];
+			const struct vdso_data *v = (BIT(clk) & VDSO_RAW) ?
+						    &vd[CS_RAW] : vdh;
+			const struct vdso_timestamp *vdso_ts = &v->basetime[clk];
+
+			ts[i].tv_sec = vdso_ts->sec;
+			if (BIT(clk) & VDSO_COARSE)
+				ts[i].tv_nsec = vdso_ts->nsec;
+			else
+				ts[i].tv_nsec = vdso_calc_ns(v, cycles, vdso_ts->nsec);
+		}
+	} while (unlikely(vdso_read_retry(vdh, seq)));
+
+	for (i = 0; i < nr; i++) {
+		u64 ns = ts[i].tv_nsec;
+
+		ts[i].tv_sec += __iter_div_u64_rem(ns, NSEC_PER_SEC, &ns);
+		ts[i].tv_nsec = ns;
+	}
+	return 0;
+
+fallback:
+	for (i = 0; i < nr; i++) {
+		ret = __cvdso_clock_gettime_data(vd, clocks[i], &ts[i]);
+		if (ret)
+			return ret;
+	}
+	return 0;
+}
+
+static __maybe_unused int
+__cvdso_clock_gettime_multi(const clockid_t *clocks,
+			    struct __kernel_timespec *ts, unsigned int nr)
+{
+	return __cvdso_clock_gettime_multi_data(__arch_get_vdso_data(), clocks,
+						ts, nr);
+}
+
 #ifdef BUILD_VDSO32
 static __maybe_unused int
 __cvdso_clock_gettime32_data(const struct vdso_data *vd, clockid_t clock,
@@ -894,6 +894,48 @@ void xas_set_mark(const struct xa_state *xas, xa_mark_t mark)
 }
 EXPORT_SYMBOL_GPL(xas_set_mark);
 
+/**
+ * xas_copy_mark_node() - Copy a mark to another for the rest of this node.
+ * @xas: XArray operation state.
+ * @max: Highest index which may be marked.
+ * @from: Mark to copy.
+ * @to: Mark to set.
+ *
+ * Sets @to on this entry and on every later entry of the same leaf node
+ * which has @from set, then moves @xas to the last slot of the node so that
+ * the next call to xas_find_marked() continues with the following node.
+ * This avoids a lookup per entry when copying a mark across a densely
+ * marked range.  If the node extends beyond @max, or @xas is not in a leaf
+ * node, only this entry is marked.
+ *
+ * Context: Any context.  Expects xa_lock to be held.
+ * Return: The number of entries which were processed.
+ */
+unsigned int xas_copy_mark_node(struct xa_state *xas, unsigned long max,
+		xa_mark_t from, xa_mark_t to)
+{
+	struct xa_node *node = xas->xa_node;
+	unsigned int offset = xas->xa_offset;
+	unsigned int nr = 0;
+
+	if (xas_invalid(xas))
+		return 0;
+
+	xas_set_mark(xas, to);
+	if (!node || node->shift || (xas->xa_index | XA_CHUNK_MASK) > max)
+		return 1;
+
+	for_each_set_bit_from(offset, node_marks(node, from), XA_CHUNK_SIZE) {
+		node_set_mark(node, offset, to);
+		nr++;
+	}
+
+	xas->xa_index |= XA_CHUNK_MASK;
+	xas->xa_offset = XA_CHUNK_MASK;
+	return nr;
+}
+EXPORT_SYMBOL_GPL(xas_copy_mark_node);
+
 /**
  * xas_clear_mark() - Clears the mark on this entry and its parents.
  * @xas: XArray operation state.
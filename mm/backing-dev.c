@@ -167,6 +167,11 @@ static void wb_stats_show(struct seq_file *m, struct bdi_writeback *wb,
 		   "WbDirtied:         %10lu kB\n"
 		   "WbWritten:         %10lu kB\n"
 		   "WbWriteBandwidth:  %10lu kBps\n"
+		   "WbDirtyRatelimit:  %10lu kBps\n"
+		   "WbBalancedRatelimit: %8lu kBps\n"
+		   "WbThrottled:       %10lu\n"
+		   "WbThrottleTime:    %10u ms\n"
+		   "WbMaxThrottleTime: %10u ms\n"
 		   "b_dirty:           %10lu\n"
 		   "b_io:              %10lu\n"
 		   "b_more_io:         %10lu\n"
@@ -183,6 +188,11 @@ static void wb_stats_show(struct seq_file *m, struct bdi_writeback *wb,
 		   K(stats->nr_dirtied),
 		   K(stats->nr_written),
 		   K(wb->avg_write_bandwidth),
+		   K(READ_ONCE(wb->dirty_ratelimit)),
+		   K(READ_ONCE(wb->balanced_dirty_ratelimit)),
+		   atomic_long_read(&wb->nr_throttled),
+		   jiffies_to_msecs(atomic_long_read(&wb->throttle_time)),
+		   jiffies_to_msecs(READ_ONCE(wb->max_throttle_time)),
 		   stats->nr_dirty,
 		   stats->nr_io,
 		   stats->nr_more_io,
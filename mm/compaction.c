@@ -2951,7 +2951,7 @@ static int compact_nodes(void)
 	int ret, nid;
 
 	/* Flush pending updates to the LRU lists */
-	lru_add_drain_all();
+	lru_add_drain_all_besteffort();
 
 	for_each_online_node(nid) {
 		ret = compact_node(NODE_DATA(nid), false);
@@ -3019,7 +3019,7 @@ static ssize_t compact_store(struct device *dev,
 
 	if (nid >= 0 && nid < nr_node_ids && node_online(nid)) {
 		/* Flush pending updates to the LRU lists */
-		lru_add_drain_all();
+		lru_add_drain_all_besteffort();
 
 		compact_node(NODE_DATA(nid), false);
 	}
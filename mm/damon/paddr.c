@@ -412,8 +412,69 @@ static unsigned int damon_pa_migrate_folio_list(struct list_head *folio_list,
 	return nr_migrated;
 }
 
+/*
+ * Find the top tier node closest to @nid, for promoting hot folios of the
+ * lower tier node @nid.
+ */
+static int damon_pa_promotion_node(int nid)
+{
+	int n, dist, best = NUMA_NO_NODE, best_dist = INT_MAX;
+
+	if (node_is_toptier(nid))
+		return NUMA_NO_NODE;
+
+	for_each_node_state(n, N_MEMORY) {
+		if (!node_is_toptier(n))
+			continue;
+
+		dist = node_distance(nid, n);
+		if (dist < best_dist) {
+			best = n;
+			best_dist = dist;
+		}
+	}
+
+	return best;
+}
+
+/*
+ * Without a target node, migrate_hot promotes to the closest top tier node
+ * and migrate_cold demotes to the next demotion node of the memory tiers.
+ */
+static int damon_pa_migrate_target(struct damos *s, int nid)
+{
+	if (s->target_nid != NUMA_NO_NODE)
+		return s->target_nid;
+
+	if (s->action == DAMOS_MIGRATE_HOT)
+		return damon_pa_promotion_node(nid);
+
+	return next_demotion_node(nid);
+}
+
+static unsigned int damon_pa_migrate_node_folios(struct list_head *folio_list,
+						 int nid, struct damos *s)
+{
+	int target_nid = damon_pa_migrate_target(s, nid);
+	unsigned int nr_migrated;
+	unsigned long sz;
+
+	nr_migrated = damon_pa_migrate_folio_list(folio_list, NODE_DATA(nid),
+						  target_nid);
+	if (!nr_migrated)
+		return 0;
+
+	sz = (unsigned long)nr_migrated * PAGE_SIZE;
+	if (!node_is_toptier(nid) && node_is_toptier(target_nid))
+		s->stat.sz_promoted += sz;
+	else if (node_is_toptier(nid) && !node_is_toptier(target_nid))
+		s->stat.sz_demoted += sz;
+
+	return nr_migrated;
+}
+
 static unsigned long damon_pa_migrate_pages(struct list_head *folio_list,
-					    int target_nid)
+					    struct damos *s)
 {
 	int nid;
 	unsigned long nr_migrated = 0;
@@ -434,15 +495,12 @@ static unsigned long damon_pa_migrate_pages(struct list_head *folio_list,
 			continue;
 		}
 
-		nr_migrated += damon_pa_migrate_folio_list(&node_folio_list,
-							   NODE_DATA(nid),
-							   target_nid);
+		nr_migrated += damon_pa_migrate_node_folios(&node_folio_list,
+							    nid, s);
 		nid = folio_nid(lru_to_folio(folio_list));
 	} while (!list_empty(folio_list));
 
-	nr_migrated += damon_pa_migrate_folio_list(&node_folio_list,
-						   NODE_DATA(nid),
-						   target_nid);
+	nr_migrated += damon_pa_migrate_node_folios(&node_folio_list, nid, s);
 
 	memalloc_noreclaim_restore(noreclaim_flag);
 
@@ -469,7 +527,7 @@ static unsigned long damon_pa_migrate(struct damon_region *r, struct damos *s)
 put_folio:
 		folio_put(folio);
 	}
-	applied = damon_pa_migrate_pages(&folio_list, s->target_nid);
+	applied = damon_pa_migrate_pages(&folio_list, s);
 	cond_resched();
 	return applied * PAGE_SIZE;
 }
@@ -9,6 +9,7 @@
 
 #include <linux/highmem.h>
 #include <linux/hugetlb.h>
+#include <linux/khugepaged.h>
 #include <linux/mman.h>
 #include <linux/mmu_notifier.h>
 #include <linux/page_idle.h>
@@ -650,6 +651,28 @@ static unsigned long damos_madvise(struct damon_target *target,
 }
 #endif	/* CONFIG_ADVISE_SYSCALLS */
 
+/*
+ * The region is hot enough to deserve huge pages, so also ask khugepaged to
+ * collapse it now rather than whenever its scan gets around to it.
+ */
+static unsigned long damos_hugepage(struct damon_target *target,
+		struct damon_region *r)
+{
+	unsigned long applied = damos_madvise(target, r, MADV_HUGEPAGE);
+	struct mm_struct *mm;
+
+	if (!applied)
+		return 0;
+
+	mm = damon_get_mm(target);
+	if (mm) {
+		khugepaged_hint_hot(mm, r->ar.start, r->ar.end);
+		mmput(mm);
+	}
+
+	return applied;
+}
+
 static unsigned long damon_va_apply_scheme(struct damon_ctx *ctx,
 		struct damon_target *t, struct damon_region *r,
 		struct damos *scheme)
@@ -667,8 +690,7 @@ static unsigned long damon_va_apply_scheme(struct damon_ctx *ctx,
 		madv_action = MADV_PAGEOUT;
 		break;
 	case DAMOS_HUGEPAGE:
-		madv_action = MADV_HUGEPAGE;
-		break;
+		return damos_hugepage(t, r);
 	case DAMOS_NOHUGEPAGE:
 		madv_action = MADV_NOHUGEPAGE;
 		break;
@@ -1703,6 +1703,8 @@ vm_fault_t __folio_lock_or_retry(struct folio *folio, struct vm_fault *vmf)
 		if (flags & FAULT_FLAG_RETRY_NOWAIT)
 			return VM_FAULT_RETRY;
 
+		count_vm_vma_lock_fallback(vmf, folio_test_swapcache(folio) ?
+					   VMA_LOCK_RETRY_SWAP : VMA_LOCK_RETRY_IO);
 		release_fault_lock(vmf);
 		if (flags & FAULT_FLAG_KILLABLE)
 			folio_wait_locked_killable(folio);
@@ -1860,6 +1862,43 @@ void *filemap_get_entry(struct address_space *mapping, pgoff_t index)
 	return folio;
 }
 
+/*
+ * Apply @fgp_flags to a folio found in the page cache. Returns -EAGAIN if it
+ * couldn't be locked without waiting and -ENOENT if it has been truncated.
+ */
+static int filemap_prepare_folio(struct address_space *mapping,
+		struct folio *folio, pgoff_t index, fgf_t fgp_flags)
+{
+	if (fgp_flags & FGP_LOCK) {
+		if (fgp_flags & FGP_NOWAIT) {
+			if (!folio_trylock(folio))
+				return -EAGAIN;
+		} else {
+			folio_lock(folio);
+		}
+
+		/* Has the page been truncated? */
+		if (unlikely(folio->mapping != mapping)) {
+			folio_unlock(folio);
+			return -ENOENT;
+		}
+		VM_BUG_ON_FOLIO(!folio_contains(folio, index), folio);
+	}
+
+	if (fgp_flags & FGP_ACCESSED)
+		folio_mark_accessed(folio);
+	else if (fgp_flags & FGP_WRITE) {
+		/* Clear idle flag for buffer write */
+		if (folio_test_idle(folio))
+			folio_clear_idle(folio);
+	}
+
+	if (fgp_flags & FGP_STABLE)
+		folio_wait_stable(folio);
+
+	return 0;
+}
+
 /**
  * __filemap_get_folio - Find and get a reference to a folio.
  * @mapping: The address_space to search.
@@ -1880,6 +1919,7 @@ struct folio *__filemap_get_folio(struct address_space *mapping, pgoff_t index,
 		fgf_t fgp_flags, gfp_t gfp)
 {
 	struct folio *folio;
+	int err;
 
 repeat:
 	folio = filemap_get_entry(mapping, index);
@@ -1888,39 +1928,16 @@ struct folio *__filemap_get_folio(struct address_space *mapping, pgoff_t index,
 	if (!folio)
 		goto no_page;
 
-	if (fgp_flags & FGP_LOCK) {
-		if (fgp_flags & FGP_NOWAIT) {
-			if (!folio_trylock(folio)) {
-				folio_put(folio);
-				return ERR_PTR(-EAGAIN);
-			}
-		} else {
-			folio_lock(folio);
-		}
-
-		/* Has the page been truncated? */
-		if (unlikely(folio->mapping != mapping)) {
-			folio_unlock(folio);
-			folio_put(folio);
-			goto repeat;
-		}
-		VM_BUG_ON_FOLIO(!folio_contains(folio, index), folio);
-	}
-
-	if (fgp_flags & FGP_ACCESSED)
-		folio_mark_accessed(folio);
-	else if (fgp_flags & FGP_WRITE) {
-		/* Clear idle flag for buffer write */
-		if (folio_test_idle(folio))
-			folio_clear_idle(folio);
+	err = filemap_prepare_folio(mapping, folio, index, fgp_flags);
+	if (err) {
+		folio_put(folio);
+		if (err == -EAGAIN)
+			return ERR_PTR(-EAGAIN);
+		goto repeat;
 	}
-
-	if (fgp_flags & FGP_STABLE)
-		folio_wait_stable(folio);
 no_page:
 	if (!folio && (fgp_flags & FGP_CREAT)) {
 		unsigned order = FGF_GET_ORDER(fgp_flags);
-		int err;
 
 		if ((fgp_flags & FGP_WRITE) && mapping_can_writeback(mapping))
 			gfp |= __GFP_WRITE;
@@ -1945,19 +1962,29 @@ struct folio *__filemap_get_folio(struct address_space *mapping, pgoff_t index,
 			gfp_t alloc_gfp = gfp;
 
 			err = -ENOMEM;
+			if (order > 1 && !thp_file_order_allowed(order))
+				continue;
 			if (order > 0)
 				alloc_gfp |= __GFP_NORETRY | __GFP_NOWARN;
 			folio = filemap_alloc_folio(alloc_gfp, order);
-			if (!folio)
+			if (!folio) {
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+				count_mthp_stat(order, MTHP_STAT_FILE_FALLBACK);
+#endif
 				continue;
+			}
 
 			/* Init accessed so avoid atomic mark_page_accessed later */
 			if (fgp_flags & FGP_ACCESSED)
 				__folio_set_referenced(folio);
 
 			err = filemap_add_folio(mapping, folio, index, gfp);
-			if (!err)
+			if (!err) {
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+				count_mthp_stat(order, MTHP_STAT_FILE_ALLOC);
+#endif
 				break;
+			}
 			folio_put(folio);
 			folio = NULL;
 		} while (order-- > 0);
@@ -2213,6 +2240,120 @@ unsigned filemap_get_folios_contig(struct address_space *mapping,
 }
 EXPORT_SYMBOL(filemap_get_folios_contig);
 
+/*
+ * Grab references to the folios that are contiguously cached from @index up
+ * to @end, in one walk. Stops at the first hole or exceptional entry.
+ */
+static void filemap_get_range_batch(struct address_space *mapping,
+		pgoff_t index, pgoff_t end, struct folio_batch *fbatch)
+{
+	XA_STATE(xas, &mapping->i_pages, index);
+	struct folio *folio;
+
+	rcu_read_lock();
+	for (folio = xas_load(&xas); folio; folio = xas_next(&xas)) {
+		if (xas_retry(&xas, folio))
+			continue;
+		if (xas.xa_index > end || xa_is_value(folio))
+			break;
+		if (xa_is_sibling(folio))
+			break;
+		if (!folio_try_get(folio))
+			goto retry;
+
+		if (unlikely(folio != xas_reload(&xas)))
+			goto put_folio;
+
+		if (!folio_batch_add(fbatch, folio))
+			break;
+		xas_advance(&xas, folio_next_index(folio) - 1);
+		continue;
+put_folio:
+		folio_put(folio);
+retry:
+		xas_reset(&xas);
+	}
+	rcu_read_unlock();
+}
+
+/**
+ * filemap_get_folios_range - Get a batch of contiguous folios for a range
+ * @mapping:	The address_space to search
+ * @start:	The starting page index
+ * @end:	The final page index (inclusive)
+ * @fgp_flags:	%FGP flags, as for __filemap_get_folio()
+ * @gfp:	Memory allocation flags to use if %FGP_CREAT is specified
+ * @fbatch:	The batch to fill
+ *
+ * Works like calling __filemap_get_folio() for each folio from @start up to
+ * @end, except the folios already in the page cache are looked up in a single
+ * walk of the xarray rather than one walk per folio. If %FGP_CREAT is
+ * specified, holes are filled with new folios, otherwise the batch ends at the
+ * first hole. The batch also ends early when it is full, or under %FGP_NOWAIT
+ * at a folio that can't be locked without waiting.
+ *
+ * Folios are locked in ascending index order if %FGP_LOCK is specified, the
+ * caller must not hold any folio locks of @mapping beyond @start.
+ *
+ * Return: The number of folios added to @fbatch, or a negative errno if not
+ * even the folio at @start could be obtained.
+ * Also update @start to index the folio following the last one in @fbatch.
+ */
+int filemap_get_folios_range(struct address_space *mapping, pgoff_t *start,
+		pgoff_t end, fgf_t fgp_flags, gfp_t gfp, struct folio_batch *fbatch)
+{
+	unsigned int nr = folio_batch_count(fbatch);
+	pgoff_t index = *start;
+	struct folio *folio;
+	int err = 0;
+
+	while (index <= end && folio_batch_space(fbatch)) {
+		unsigned int i = folio_batch_count(fbatch);
+
+		filemap_get_range_batch(mapping, index, end, fbatch);
+
+		for (; i < folio_batch_count(fbatch); i++) {
+			folio = fbatch->folios[i];
+			err = filemap_prepare_folio(mapping, folio, index,
+						    fgp_flags);
+			if (err)
+				break;
+			index = folio_next_index(folio);
+		}
+
+		if (err) {
+			/* Drop the folios we couldn't get ready */
+			while (folio_batch_count(fbatch) > i)
+				folio_put(fbatch->folios[--fbatch->nr]);
+			if (err == -EAGAIN)
+				break;
+			/* Truncated under us, look again */
+			err = 0;
+			continue;
+		}
+
+		if (index > end || !folio_batch_space(fbatch) ||
+		    !(fgp_flags & FGP_CREAT))
+			break;
+
+		/* Fill the hole at @index */
+		folio = __filemap_get_folio(mapping, index, fgp_flags, gfp);
+		if (IS_ERR(folio)) {
+			err = PTR_ERR(folio);
+			break;
+		}
+		folio_batch_add(fbatch, folio);
+		index = folio_next_index(folio);
+	}
+
+	*start = index;
+	nr = folio_batch_count(fbatch) - nr;
+	if (!nr && err)
+		return err;
+	return nr;
+}
+EXPORT_SYMBOL(filemap_get_folios_range);
+
 /**
  * filemap_get_folios_tag - Get a batch of folios matching @tag
  * @mapping:    The address_space to search
@@ -2813,29 +2954,35 @@ EXPORT_SYMBOL(generic_file_read_iter);
 size_t splice_folio_into_pipe(struct pipe_inode_info *pipe,
 			      struct folio *folio, loff_t fpos, size_t size)
 {
-	struct page *page;
 	size_t spliced = 0, offset = offset_in_folio(folio, fpos);
 
-	page = folio_page(folio, offset / PAGE_SIZE);
 	size = min(size, folio_size(folio) - offset);
-	offset %= PAGE_SIZE;
 
-	while (spliced < size &&
-	       !pipe_full(pipe->head, pipe->tail, pipe->max_usage)) {
+	while (spliced < size && !pipe_is_full(pipe)) {
 		struct pipe_buffer *buf = pipe_head_buf(pipe);
-		size_t part = min_t(size_t, PAGE_SIZE - offset, size - spliced);
+		size_t part = min_t(size_t, PAGE_SIZE - offset % PAGE_SIZE,
+				    size - spliced);
+
+		/*
+		 * A buffer can cover several pages of a large folio, so that
+		 * it takes one pipe slot and one reference rather than one
+		 * per page, as long as the pipe does not end up holding more
+		 * than its size. Highmem pages have to be mapped one by one.
+		 */
+		if (!IS_ENABLED(CONFIG_HIGHMEM))
+			part = min(size - spliced, pipe_space(pipe));
 
 		*buf = (struct pipe_buffer) {
 			.ops	= &page_cache_pipe_buf_ops,
-			.page	= page,
-			.offset	= offset,
+			.page	= folio_page(folio, offset / PAGE_SIZE),
+			.offset	= offset % PAGE_SIZE,
 			.len	= part,
 		};
+		pipe_buf_charge(pipe, buf);
 		folio_get(folio);
 		pipe->head++;
-		page++;
 		spliced += part;
-		offset = 0;
+		offset += part;
 	}
 
 	return spliced;
@@ -2938,7 +3085,7 @@ ssize_t filemap_splice_read(struct file *in, loff_t *ppos,
 			total_spliced += n;
 			*ppos += n;
 			in->f_ra.prev_pos = *ppos;
-			if (pipe_full(pipe->head, pipe->tail, pipe->max_usage))
+			if (pipe_is_full(pipe))
 				goto out;
 		}
 
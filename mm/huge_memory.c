@@ -80,6 +80,18 @@ unsigned long huge_zero_pfn __read_mostly = ~0UL;
 unsigned long huge_anon_orders_always __read_mostly;
 unsigned long huge_anon_orders_madvise __read_mostly;
 unsigned long huge_anon_orders_inherit __read_mostly;
+unsigned long huge_file_orders_never __read_mostly;
+
+/* Per-size "defrag" setting; THPSIZE_DEFRAG_INHERIT uses the global one. */
+enum thpsize_defrag {
+	THPSIZE_DEFRAG_INHERIT,
+	THPSIZE_DEFRAG_ALWAYS,
+	THPSIZE_DEFRAG_DEFER,
+	THPSIZE_DEFRAG_DEFER_MADVISE,
+	THPSIZE_DEFRAG_MADVISE,
+	THPSIZE_DEFRAG_NEVER,
+};
+static unsigned char thpsize_defrag[ilog2(MAX_PTRS_PER_PTE) + 1] __read_mostly;
 
 unsigned long __thp_vma_allowable_orders(struct vm_area_struct *vma,
 					 unsigned long vm_flags,
@@ -528,8 +540,82 @@ static ssize_t thpsize_enabled_store(struct kobject *kobj,
 static struct kobj_attribute thpsize_enabled_attr =
 	__ATTR(enabled, 0644, thpsize_enabled_show, thpsize_enabled_store);
 
+static const char * const thpsize_defrag_names[] = {
+	[THPSIZE_DEFRAG_INHERIT]	= "inherit",
+	[THPSIZE_DEFRAG_ALWAYS]		= "always",
+	[THPSIZE_DEFRAG_DEFER]		= "defer",
+	[THPSIZE_DEFRAG_DEFER_MADVISE]	= "defer+madvise",
+	[THPSIZE_DEFRAG_MADVISE]	= "madvise",
+	[THPSIZE_DEFRAG_NEVER]		= "never",
+};
+
+static ssize_t thpsize_defrag_show(struct kobject *kobj,
+				   struct kobj_attribute *attr, char *buf)
+{
+	int order = to_thpsize(kobj)->order;
+	int defrag = READ_ONCE(thpsize_defrag[order]);
+	int i, len = 0;
+
+	for (i = 0; i < ARRAY_SIZE(thpsize_defrag_names); i++)
+		len += sysfs_emit_at(buf, len, i == defrag ? "[%s]%c" : "%s%c",
+				     thpsize_defrag_names[i],
+				     i == ARRAY_SIZE(thpsize_defrag_names) - 1 ?
+				     '\n' : ' ');
+
+	return len;
+}
+
+static ssize_t thpsize_defrag_store(struct kobject *kobj,
+				    struct kobj_attribute *attr,
+				    const char *buf, size_t count)
+{
+	int order = to_thpsize(kobj)->order;
+	int defrag;
+
+	defrag = sysfs_match_string(thpsize_defrag_names, buf);
+	if (defrag < 0)
+		return defrag;
+
+	WRITE_ONCE(thpsize_defrag[order], defrag);
+	return count;
+}
+
+static struct kobj_attribute thpsize_defrag_attr =
+	__ATTR(defrag, 0644, thpsize_defrag_show, thpsize_defrag_store);
+
+static ssize_t thpsize_file_enabled_show(struct kobject *kobj,
+					 struct kobj_attribute *attr, char *buf)
+{
+	int order = to_thpsize(kobj)->order;
+
+	return sysfs_emit(buf, "%s\n", test_bit(order, &huge_file_orders_never) ?
+			  "always [never]" : "[always] never");
+}
+
+static ssize_t thpsize_file_enabled_store(struct kobject *kobj,
+					  struct kobj_attribute *attr,
+					  const char *buf, size_t count)
+{
+	int order = to_thpsize(kobj)->order;
+
+	if (sysfs_streq(buf, "always"))
+		clear_bit(order, &huge_file_orders_never);
+	else if (sysfs_streq(buf, "never"))
+		set_bit(order, &huge_file_orders_never);
+	else
+		return -EINVAL;
+
+	return count;
+}
+
+static struct kobj_attribute thpsize_file_enabled_attr =
+	__ATTR(file_enabled, 0644, thpsize_file_enabled_show,
+	       thpsize_file_enabled_store);
+
 static struct attribute *thpsize_attrs[] = {
 	&thpsize_enabled_attr.attr,
+	&thpsize_defrag_attr.attr,
+	&thpsize_file_enabled_attr.attr,
 #ifdef CONFIG_SHMEM
 	&thpsize_shmem_enabled_attr.attr,
 #endif
@@ -579,6 +665,8 @@ DEFINE_MTHP_STAT_ATTR(swpout_fallback, MTHP_STAT_SWPOUT_FALLBACK);
 DEFINE_MTHP_STAT_ATTR(shmem_alloc, MTHP_STAT_SHMEM_ALLOC);
 DEFINE_MTHP_STAT_ATTR(shmem_fallback, MTHP_STAT_SHMEM_FALLBACK);
 DEFINE_MTHP_STAT_ATTR(shmem_fallback_charge, MTHP_STAT_SHMEM_FALLBACK_CHARGE);
+DEFINE_MTHP_STAT_ATTR(file_alloc, MTHP_STAT_FILE_ALLOC);
+DEFINE_MTHP_STAT_ATTR(file_fallback, MTHP_STAT_FILE_FALLBACK);
 DEFINE_MTHP_STAT_ATTR(split, MTHP_STAT_SPLIT);
 DEFINE_MTHP_STAT_ATTR(split_failed, MTHP_STAT_SPLIT_FAILED);
 DEFINE_MTHP_STAT_ATTR(split_deferred, MTHP_STAT_SPLIT_DEFERRED);
@@ -592,6 +680,8 @@ static struct attribute *stats_attrs[] = {
 	&shmem_alloc_attr.attr,
 	&shmem_fallback_attr.attr,
 	&shmem_fallback_charge_attr.attr,
+	&file_alloc_attr.attr,
+	&file_fallback_attr.attr,
 	&split_attr.attr,
 	&split_failed_attr.attr,
 	&split_deferred_attr.attr,
@@ -1033,30 +1123,49 @@ static vm_fault_t __do_huge_pmd_anonymous_page(struct vm_fault *vmf,
  *	    available
  * never: never stall for any thp allocation
  */
-gfp_t vma_thp_gfp_mask(struct vm_area_struct *vma)
+static enum thpsize_defrag thp_defrag_mode(int order)
 {
-	const bool vma_madvised = vma && (vma->vm_flags & VM_HUGEPAGE);
+	enum thpsize_defrag defrag = THPSIZE_DEFRAG_INHERIT;
 
-	/* Always do synchronous compaction */
-	if (test_bit(TRANSPARENT_HUGEPAGE_DEFRAG_DIRECT_FLAG, &transparent_hugepage_flags))
-		return GFP_TRANSHUGE | (vma_madvised ? 0 : __GFP_NORETRY);
+	if (order > 0 && order < ARRAY_SIZE(thpsize_defrag))
+		defrag = READ_ONCE(thpsize_defrag[order]);
+	if (defrag != THPSIZE_DEFRAG_INHERIT)
+		return defrag;
 
-	/* Kick kcompactd and fail quickly */
+	if (test_bit(TRANSPARENT_HUGEPAGE_DEFRAG_DIRECT_FLAG, &transparent_hugepage_flags))
+		return THPSIZE_DEFRAG_ALWAYS;
 	if (test_bit(TRANSPARENT_HUGEPAGE_DEFRAG_KSWAPD_FLAG, &transparent_hugepage_flags))
-		return GFP_TRANSHUGE_LIGHT | __GFP_KSWAPD_RECLAIM;
-
-	/* Synchronous compaction if madvised, otherwise kick kcompactd */
+		return THPSIZE_DEFRAG_DEFER;
 	if (test_bit(TRANSPARENT_HUGEPAGE_DEFRAG_KSWAPD_OR_MADV_FLAG, &transparent_hugepage_flags))
+		return THPSIZE_DEFRAG_DEFER_MADVISE;
+	if (test_bit(TRANSPARENT_HUGEPAGE_DEFRAG_REQ_MADV_FLAG, &transparent_hugepage_flags))
+		return THPSIZE_DEFRAG_MADVISE;
+	return THPSIZE_DEFRAG_NEVER;
+}
+
+gfp_t vma_thp_gfp_mask(struct vm_area_struct *vma, int order)
+{
+	const bool vma_madvised = vma && (vma->vm_flags & VM_HUGEPAGE);
+
+	switch (thp_defrag_mode(order)) {
+	case THPSIZE_DEFRAG_ALWAYS:
+		/* Always do synchronous compaction */
+		return GFP_TRANSHUGE | (vma_madvised ? 0 : __GFP_NORETRY);
+	case THPSIZE_DEFRAG_DEFER:
+		/* Kick kcompactd and fail quickly */
+		return GFP_TRANSHUGE_LIGHT | __GFP_KSWAPD_RECLAIM;
+	case THPSIZE_DEFRAG_DEFER_MADVISE:
+		/* Synchronous compaction if madvised, otherwise kick kcompactd */
 		return GFP_TRANSHUGE_LIGHT |
 			(vma_madvised ? __GFP_DIRECT_RECLAIM :
 					__GFP_KSWAPD_RECLAIM);
-
-	/* Only do synchronous compaction if madvised */
-	if (test_bit(TRANSPARENT_HUGEPAGE_DEFRAG_REQ_MADV_FLAG, &transparent_hugepage_flags))
+	case THPSIZE_DEFRAG_MADVISE:
+		/* Only do synchronous compaction if madvised */
 		return GFP_TRANSHUGE_LIGHT |
 		       (vma_madvised ? __GFP_DIRECT_RECLAIM : 0);
-
-	return GFP_TRANSHUGE_LIGHT;
+	default:
+		return GFP_TRANSHUGE_LIGHT;
+	}
 }
 
 /* Caller must hold page table lock. */
@@ -1129,7 +1238,7 @@ vm_fault_t do_huge_pmd_anonymous_page(struct vm_fault *vmf)
 		}
 		return ret;
 	}
-	gfp = vma_thp_gfp_mask(vma);
+	gfp = vma_thp_gfp_mask(vma, HPAGE_PMD_ORDER);
 	folio = vma_alloc_folio(gfp, HPAGE_PMD_ORDER, vma, haddr, true);
 	if (unlikely(!folio)) {
 		count_vm_event(THP_FAULT_FALLBACK);
@@ -1728,7 +1837,8 @@ vm_fault_t do_huge_pmd_numa_page(struct vm_fault *vmf)
 	if (!migrate_misplaced_folio(folio, vma, target_nid)) {
 		flags |= TNF_MIGRATED;
 		nid = target_nid;
-		task_numa_fault(last_cpupid, nid, HPAGE_PMD_NR, flags);
+		task_numa_fault(last_cpupid, nid, HPAGE_PMD_NR, flags,
+				vma_numa_group_mapping(vma));
 		return 0;
 	}
 
@@ -1749,7 +1859,8 @@ vm_fault_t do_huge_pmd_numa_page(struct vm_fault *vmf)
 	spin_unlock(vmf->ptl);
 
 	if (nid != NUMA_NO_NODE)
-		task_numa_fault(last_cpupid, nid, HPAGE_PMD_NR, flags);
+		task_numa_fault(last_cpupid, nid, HPAGE_PMD_NR, flags,
+				vma_numa_group_mapping(vma));
 	return 0;
 }
 
@@ -2710,7 +2821,7 @@ static void unmap_folio(struct folio *folio)
 	else
 		try_to_unmap(folio, ttu_flags | TTU_IGNORE_MLOCK);
 
-	try_to_unmap_flush();
+	try_to_unmap_flush(TLB_BATCH_SPLIT);
 }
 
 static bool __discard_anon_folio_pmd_locked(struct vm_area_struct *vma,
@@ -986,6 +986,7 @@ static inline struct file *maybe_unlock_mmap_for_io(struct vm_fault *vmf,
 	if (fault_flag_allow_retry_first(flags) &&
 	    !(flags & FAULT_FLAG_RETRY_NOWAIT)) {
 		fpin = get_file(vmf->vma->vm_file);
+		count_vm_vma_lock_fallback(vmf, VMA_LOCK_RETRY_IO);
 		release_fault_lock(vmf);
 	}
 	return fpin;
@@ -1148,15 +1149,26 @@ struct tlbflush_unmap_batch;
  */
 extern struct workqueue_struct *mm_percpu_wq;
 
+/*
+ * Who flushes the TLB entries deferred with TTU_BATCH_FLUSH. Indexes the
+ * tlb_batch_flush_* vmstat events.
+ */
+enum tlb_batch_reason {
+	TLB_BATCH_RECLAIM,
+	TLB_BATCH_MIGRATE,
+	TLB_BATCH_KHUGEPAGED,
+	TLB_BATCH_SPLIT,
+};
+
 #ifdef CONFIG_ARCH_WANT_BATCHED_UNMAP_TLB_FLUSH
-void try_to_unmap_flush(void);
-void try_to_unmap_flush_dirty(void);
+void try_to_unmap_flush(enum tlb_batch_reason reason);
+void try_to_unmap_flush_dirty(enum tlb_batch_reason reason);
 void flush_tlb_batched_pending(struct mm_struct *mm);
 #else
-static inline void try_to_unmap_flush(void)
+static inline void try_to_unmap_flush(enum tlb_batch_reason reason)
 {
 }
-static inline void try_to_unmap_flush_dirty(void)
+static inline void try_to_unmap_flush_dirty(enum tlb_batch_reason reason)
 {
 }
 static inline void flush_tlb_batched_pending(struct mm_struct *mm)
@@ -1220,6 +1232,18 @@ void __vunmap_range_noflush(unsigned long start, unsigned long end);
 int numa_migrate_prep(struct folio *folio, struct vm_fault *vmf,
 		      unsigned long addr, int page_nid, int *flags);
 
+/*
+ * Backing object NUMA balancing may group tasks on, for shared file backed
+ * mappings (including memfd and shmem).
+ */
+static inline struct address_space *vma_numa_group_mapping(struct vm_area_struct *vma)
+{
+	if (!(vma->vm_flags & VM_SHARED) || !vma->vm_file)
+		return NULL;
+
+	return vma->vm_file->f_mapping;
+}
+
 void free_zone_device_folio(struct folio *folio);
 int migrate_device_coherent_page(struct page *page);
 
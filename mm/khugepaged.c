@@ -130,6 +130,26 @@ static struct khugepaged_scan khugepaged_scan = {
 	.mm_head = LIST_HEAD_INIT(khugepaged_scan.mm_head),
 };
 
+#define KHUGEPAGED_MAX_HOT_HINTS	256
+
+/**
+ * struct khugepaged_hot_hint - address range reported hot, scanned first
+ * @list: entry in khugepaged_hot_list
+ * @mm: the mm, pinned with mmgrab()
+ * @start: PMD aligned start of the range
+ * @end: PMD aligned end of the range
+ */
+struct khugepaged_hot_hint {
+	struct list_head list;
+	struct mm_struct *mm;
+	unsigned long start;
+	unsigned long end;
+};
+
+/* Protected by khugepaged_mm_lock */
+static LIST_HEAD(khugepaged_hot_list);
+static unsigned int khugepaged_nr_hot;
+
 #ifdef CONFIG_SYSFS
 static ssize_t scan_sleep_millisecs_show(struct kobject *kobj,
 					 struct kobj_attribute *attr,
@@ -2038,7 +2058,7 @@ static int collapse_file(struct mm_struct *mm, unsigned long addr,
 	 * If collapse is unsuccessful, does flush actually need to be done?
 	 * Do it anyway, to clear the state.
 	 */
-	try_to_unmap_flush();
+	try_to_unmap_flush(TLB_BATCH_KHUGEPAGED);
 
 	if (result == SCAN_SUCCEED && nr_none &&
 	    !shmem_charge(mapping->host, nr_none))
@@ -2329,6 +2349,216 @@ static int hpage_collapse_scan_file(struct mm_struct *mm, unsigned long addr,
 }
 #endif
 
+/*
+ * Scan and possibly collapse the PMD range at @address. Called with mmap_lock
+ * held for read; *@mmap_locked is cleared if it was released.
+ */
+static int khugepaged_scan_range(struct mm_struct *mm,
+				 struct vm_area_struct *vma,
+				 unsigned long address, bool hot,
+				 bool *mmap_locked, struct collapse_control *cc)
+{
+	int result;
+
+	if (IS_ENABLED(CONFIG_SHMEM) && vma->vm_file) {
+		struct file *file = get_file(vma->vm_file);
+		pgoff_t pgoff = linear_page_index(vma, address);
+
+		mmap_read_unlock(mm);
+		*mmap_locked = false;
+		result = hpage_collapse_scan_file(mm, address, file, pgoff, cc);
+		fput(file);
+		if (result == SCAN_PTE_MAPPED_HUGEPAGE) {
+			mmap_read_lock(mm);
+			if (hpage_collapse_test_exit_or_disable(mm)) {
+				result = SCAN_ANY_PROCESS;
+			} else {
+				result = collapse_pte_mapped_thp(mm, address,
+								 false);
+				if (result == SCAN_PMD_MAPPED)
+					result = SCAN_SUCCEED;
+			}
+			mmap_read_unlock(mm);
+		}
+	} else {
+		result = hpage_collapse_scan_pmd(mm, vma, address,
+						 mmap_locked, cc);
+	}
+
+	count_vm_event(hot ? THP_SCAN_RANGE_HOT : THP_SCAN_RANGE);
+	if (result == SCAN_SUCCEED) {
+		++khugepaged_pages_collapsed;
+		count_vm_event(hot ? THP_COLLAPSE_RANGE_HOT : THP_COLLAPSE_RANGE);
+	}
+	trace_mm_khugepaged_scan_range(mm, address, hot, result);
+
+	return result;
+}
+
+/**
+ * khugepaged_hint_hot - ask khugepaged to collapse a hot range soon
+ * @mm: the mm the range belongs to
+ * @start: start address of the range
+ * @end: end address of the range
+ *
+ * The PMD aligned part of [@start, @end) is scanned ahead of the round-robin
+ * walk over all mms on the next khugepaged wakeup. This is meant for access
+ * information such as DAMON's: khugepaged on its own may take hours to get
+ * back to a busy heap on a host with many processes.
+ *
+ * Hints are best effort and are dropped when too many are pending.
+ */
+void khugepaged_hint_hot(struct mm_struct *mm, unsigned long start,
+			 unsigned long end)
+{
+	struct khugepaged_hot_hint *hint, *new;
+
+	start = round_up(start, HPAGE_PMD_SIZE);
+	end = round_down(end, HPAGE_PMD_SIZE);
+	if (start >= end || !test_bit(MMF_VM_HUGEPAGE, &mm->flags) ||
+	    !hugepage_pmd_enabled())
+		return;
+
+	new = kmalloc(sizeof(*new), GFP_KERNEL | __GFP_NOWARN);
+	if (!new)
+		return;
+
+	spin_lock(&khugepaged_mm_lock);
+	list_for_each_entry(hint, &khugepaged_hot_list, list) {
+		if (hint->mm == mm && start <= hint->end && end >= hint->start) {
+			hint->start = min(hint->start, start);
+			hint->end = max(hint->end, end);
+			goto unlock;
+		}
+	}
+	if (khugepaged_nr_hot >= KHUGEPAGED_MAX_HOT_HINTS)
+		goto unlock;
+
+	mmgrab(mm);
+	new->mm = mm;
+	new->start = start;
+	new->end = end;
+	list_add_tail(&new->list, &khugepaged_hot_list);
+	khugepaged_nr_hot++;
+	new = NULL;
+unlock:
+	spin_unlock(&khugepaged_mm_lock);
+	kfree(new);
+}
+
+static struct khugepaged_hot_hint *khugepaged_next_hot(void)
+{
+	struct khugepaged_hot_hint *hint;
+
+	spin_lock(&khugepaged_mm_lock);
+	hint = list_first_entry_or_null(&khugepaged_hot_list,
+					struct khugepaged_hot_hint, list);
+	if (hint) {
+		list_del(&hint->list);
+		khugepaged_nr_hot--;
+	}
+	spin_unlock(&khugepaged_mm_lock);
+
+	return hint;
+}
+
+static void khugepaged_free_hot(struct khugepaged_hot_hint *hint)
+{
+	mmdrop(hint->mm);
+	kfree(hint);
+}
+
+/*
+ * Put a partially scanned hint back at the head of the list so that the next
+ * pass resumes where this one ran out of budget.
+ */
+static void khugepaged_requeue_hot(struct khugepaged_hot_hint *hint)
+{
+	if (hint->start >= hint->end ||
+	    hpage_collapse_test_exit_or_disable(hint->mm)) {
+		khugepaged_free_hot(hint);
+		return;
+	}
+
+	spin_lock(&khugepaged_mm_lock);
+	list_add(&hint->list, &khugepaged_hot_list);
+	khugepaged_nr_hot++;
+	spin_unlock(&khugepaged_mm_lock);
+}
+
+static unsigned int khugepaged_scan_hot_range(struct khugepaged_hot_hint *hint,
+					      unsigned int pages, int *result,
+					      struct collapse_control *cc)
+{
+	struct mm_struct *mm = hint->mm;
+	unsigned int progress = 1;
+	bool mmap_locked;
+
+	if (!mmap_read_trylock(mm))
+		return progress;
+
+	while (hint->start < hint->end && progress < pages) {
+		unsigned long address = hint->start;
+		struct vm_area_struct *vma;
+
+		cond_resched();
+		if (unlikely(hpage_collapse_test_exit_or_disable(mm))) {
+			hint->start = hint->end;
+			break;
+		}
+
+		hint->start += HPAGE_PMD_SIZE;
+		vma = vma_lookup(mm, address);
+		if (!vma || address < round_up(vma->vm_start, HPAGE_PMD_SIZE) ||
+		    address + HPAGE_PMD_SIZE > vma->vm_end ||
+		    !thp_vma_allowable_order(vma, vma->vm_flags,
+					     TVA_ENFORCE_SYSFS, PMD_ORDER)) {
+			progress++;
+			continue;
+		}
+
+		mmap_locked = true;
+		*result = khugepaged_scan_range(mm, vma, address, true,
+						&mmap_locked, cc);
+		progress += HPAGE_PMD_NR;
+		if (*result == SCAN_ALLOC_HUGE_PAGE_FAIL) {
+			/* Retry this range once allocation succeeds again */
+			hint->start = address;
+			if (mmap_locked)
+				mmap_read_unlock(mm);
+			return progress;
+		}
+		if (!mmap_locked && !mmap_read_trylock(mm))
+			return progress;
+	}
+	mmap_read_unlock(mm);
+
+	return progress;
+}
+
+/*
+ * Scan the ranges reported by khugepaged_hint_hot() first. At most half of
+ * @pages goes to the hints so that the round-robin walk over all mms always
+ * makes progress, whatever rate the hints come in at.
+ */
+static unsigned int khugepaged_scan_hot(unsigned int pages, int *result,
+					struct collapse_control *cc)
+{
+	struct khugepaged_hot_hint *hint;
+	unsigned int progress = 0;
+
+	pages = max(pages / 2, 1U);
+	while (progress < pages && (hint = khugepaged_next_hot())) {
+		progress += khugepaged_scan_hot_range(hint, pages - progress,
+						      result, cc);
+		khugepaged_requeue_hot(hint);
+		if (*result == SCAN_ALLOC_HUGE_PAGE_FAIL)
+			break;
+	}
+
+	return progress;
+}
+
 static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 					    struct collapse_control *cc)
 	__releases(&khugepaged_mm_lock)
@@ -2403,33 +2633,9 @@ static unsigned int khugepaged_scan_mm_slot(unsigned int pages, int *result,
 			VM_BUG_ON(khugepaged_scan.address < hstart ||
 				  khugepaged_scan.address + HPAGE_PMD_SIZE >
 				  hend);
-			if (IS_ENABLED(CONFIG_SHMEM) && vma->vm_file) {
-				struct file *file = get_file(vma->vm_file);
-				pgoff_t pgoff = linear_page_index(vma,
-						khugepaged_scan.address);
-
-				mmap_read_unlock(mm);
-				mmap_locked = false;
-				*result = hpage_collapse_scan_file(mm,
-					khugepaged_scan.address, file, pgoff, cc);
-				fput(file);
-				if (*result == SCAN_PTE_MAPPED_HUGEPAGE) {
-					mmap_read_lock(mm);
-					if (hpage_collapse_test_exit_or_disable(mm))
-						goto breakouterloop;
-					*result = collapse_pte_mapped_thp(mm,
-						khugepaged_scan.address, false);
-					if (*result == SCAN_PMD_MAPPED)
-						*result = SCAN_SUCCEED;
-					mmap_read_unlock(mm);
-				}
-			} else {
-				*result = hpage_collapse_scan_pmd(mm, vma,
-					khugepaged_scan.address, &mmap_locked, cc);
-			}
-
-			if (*result == SCAN_SUCCEED)
-				++khugepaged_pages_collapsed;
+			*result = khugepaged_scan_range(mm, vma,
+					khugepaged_scan.address, false,
+					&mmap_locked, cc);
 
 			/* move to next address */
 			khugepaged_scan.address += HPAGE_PMD_SIZE;
@@ -2498,7 +2704,13 @@ static void khugepaged_do_scan(struct collapse_control *cc)
 	bool wait = true;
 	int result = SCAN_SUCCEED;
 
-	lru_add_drain_all();
+	lru_add_drain_all_besteffort();
+
+	progress = khugepaged_scan_hot(pages, &result, cc);
+	if (result == SCAN_ALLOC_HUGE_PAGE_FAIL) {
+		wait = false;
+		khugepaged_alloc_sleep();
+	}
 
 	while (true) {
 		cond_resched();
@@ -2561,6 +2773,7 @@ static void khugepaged_wait_work(void)
 
 static int khugepaged(void *none)
 {
+	struct khugepaged_hot_hint *hint;
 	struct khugepaged_mm_slot *mm_slot;
 
 	set_freezable();
@@ -2577,6 +2790,9 @@ static int khugepaged(void *none)
 	if (mm_slot)
 		collect_mm_slot(mm_slot);
 	spin_unlock(&khugepaged_mm_lock);
+
+	while ((hint = khugepaged_next_hot()))
+		khugepaged_free_hot(hint);
 	return 0;
 }
 
@@ -123,10 +123,20 @@ typedef u8 rmap_age_t;
  * struct ksm_mm_slot - ksm information per mm that is being scanned
  * @slot: hash lookup from mm to mm_slot
  * @rmap_list: head for this mm_slot's singly-linked list of rmap_items
+ * @pass_scanned: pages scanned in this mm during the current full scan
+ * @last_merged: merged pages of this mm when its last full scan ended
+ * @skip_order: log2 of the full scans to skip after the next fruitless one
+ * @remaining_skips: how many full scans to skip this mm for
+ * @scanned: this mm has been through a full scan
  */
 struct ksm_mm_slot {
 	struct mm_slot slot;
 	struct ksm_rmap_item *rmap_list;
+	unsigned long pass_scanned;
+	unsigned long last_merged;
+	unsigned int skip_order;
+	unsigned int remaining_skips;
+	bool scanned;
 };
 
 /**
@@ -301,6 +311,15 @@ atomic_long_t ksm_zero_pages = ATOMIC_LONG_INIT(0);
 /* The number of pages that have been skipped due to "smart scanning" */
 static unsigned long ksm_pages_skipped;
 
+/* Max full scans an mm that never merges is skipped for, as a power of 2 */
+#define KSM_MM_MAX_SKIP_ORDER 3
+
+/* The number of full scans of an mm skipped due to "smart scanning" */
+static unsigned long ksm_mm_scans_skipped;
+
+/* Percentage of a CPU ksmd may use, 0 for no limit */
+static unsigned int ksm_cpu_budget;
+
 /* Don't scan more than max pages per batch. */
 static unsigned long ksm_advisor_max_pages_to_scan = 30000;
 
@@ -2475,6 +2494,88 @@ static bool should_skip_rmap_item(struct page *page,
 	return true;
 }
 
+/* Pages of @mm that are currently merged, with KSM zero pages */
+static unsigned long mm_ksm_merged_pages(struct mm_struct *mm)
+{
+	return mm->ksm_merging_pages + mm_ksm_zero_pages(mm);
+}
+
+/*
+ * Determines if a whole mm should be skipped for the current full scan.
+ * An mm whose last full scan merged none of its pages is skipped for 1, 2,
+ * 4 and up to 8 full scans, leaving the pages_to_scan budget to the mms
+ * that merge.
+ *
+ * @mm_slot: mm_slot of the mm to check
+ */
+static bool should_skip_mm_slot(struct ksm_mm_slot *mm_slot)
+{
+	struct mm_struct *mm = mm_slot->slot.mm;
+	struct ksm_rmap_item *rmap_item;
+
+	/* Let an exiting mm be scanned, so it gets removed */
+	if (!ksm_smart_scan || !mm_slot->remaining_skips || ksm_test_exit(mm))
+		return false;
+
+	/*
+	 * Scanning other mms merged pages of this one into the stable tree,
+	 * so its unstable tree nodes are worth keeping: stop the backoff.
+	 */
+	if (mm_ksm_merged_pages(mm) > mm_slot->last_merged) {
+		mm_slot->remaining_skips = 0;
+		mm_slot->skip_order = 0;
+		return false;
+	}
+
+	/*
+	 * Unstable tree nodes must not survive into the next full scan,
+	 * see remove_rmap_item_from_tree().
+	 */
+	for (rmap_item = mm_slot->rmap_list; rmap_item;
+	     rmap_item = rmap_item->rmap_list) {
+		if (rmap_item->address & UNSTABLE_FLAG)
+			remove_rmap_item_from_tree(rmap_item);
+	}
+
+	mm_slot->remaining_skips--;
+	mm->ksm_scans_skipped++;
+	ksm_mm_scans_skipped++;
+	return true;
+}
+
+/*
+ * Called when a full scan of an mm is done: record its merge yield and,
+ * if none of its pages got merged since its last full scan, how many of the
+ * next full scans to skip it for. Pages count whether they were merged by
+ * scanning this mm or another one. The first full scan of an mm only fills
+ * the unstable tree, so it never starts the backoff.
+ */
+static void mm_slot_end_scan(struct ksm_mm_slot *mm_slot)
+{
+	unsigned long merged = mm_ksm_merged_pages(mm_slot->slot.mm);
+	unsigned long gained = 0;
+
+	if (merged > mm_slot->last_merged)
+		gained = merged - mm_slot->last_merged;
+
+	if (mm_slot->pass_scanned)
+		WRITE_ONCE(mm_slot->slot.mm->ksm_scan_yield,
+			   min(gained, mm_slot->pass_scanned) * 1000 /
+			   mm_slot->pass_scanned);
+
+	if (gained || !mm_slot->scanned) {
+		mm_slot->skip_order = 0;
+	} else if (mm_slot->pass_scanned) {
+		mm_slot->remaining_skips = 1U << mm_slot->skip_order;
+		if (mm_slot->skip_order < KSM_MM_MAX_SKIP_ORDER)
+			mm_slot->skip_order++;
+	}
+
+	mm_slot->scanned = true;
+	mm_slot->last_merged = merged;
+	mm_slot->pass_scanned = 0;
+}
+
 static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 {
 	struct mm_struct *mm;
@@ -2543,6 +2644,17 @@ static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 next_mm:
 		ksm_scan.address = 0;
 		ksm_scan.rmap_list = &mm_slot->rmap_list;
+		if (should_skip_mm_slot(mm_slot)) {
+			spin_lock(&ksm_mmlist_lock);
+			slot = list_entry(mm_slot->slot.mm_node.next,
+					  struct mm_slot, mm_node);
+			mm_slot = mm_slot_entry(slot, struct ksm_mm_slot, slot);
+			ksm_scan.mm_slot = mm_slot;
+			spin_unlock(&ksm_mmlist_lock);
+			if (mm_slot != &ksm_mm_head)
+				goto next_mm;
+			goto scan_done;
+		}
 	}
 
 	slot = &mm_slot->slot;
@@ -2607,6 +2719,7 @@ static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 	 * because there were no VM_MERGEABLE vmas with such addresses.
 	 */
 	remove_trailing_rmap_items(ksm_scan.rmap_list);
+	mm_slot_end_scan(mm_slot);
 
 	spin_lock(&ksm_mmlist_lock);
 	slot = list_entry(mm_slot->slot.mm_node.next,
@@ -2648,6 +2761,7 @@ static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 	if (mm_slot != &ksm_mm_head)
 		goto next_mm;
 
+scan_done:
 	advisor_stop_scan();
 
 	trace_ksm_stop_scan(ksm_scan.seqnr, ksm_rmap_items);
@@ -2662,6 +2776,7 @@ static struct ksm_rmap_item *scan_get_next_rmap_item(struct page **page)
 static void ksm_do_scan(unsigned int scan_npages)
 {
 	struct ksm_rmap_item *rmap_item;
+	struct ksm_mm_slot *mm_slot;
 	struct page *page;
 
 	while (scan_npages-- && likely(!freezing(current))) {
@@ -2669,12 +2784,37 @@ static void ksm_do_scan(unsigned int scan_npages)
 		rmap_item = scan_get_next_rmap_item(&page);
 		if (!rmap_item)
 			return;
+
+		/* The cursor only moves past an mm once all of it is scanned */
+		mm_slot = ksm_scan.mm_slot;
+
 		cmp_and_merge_page(page, rmap_item);
 		put_page(page);
 		ksm_pages_scanned++;
+
+		mm_slot->pass_scanned++;
+		rmap_item->mm->ksm_pages_scanned++;
 	}
 }
 
+/*
+ * Extend the sleep after a batch that took @busy_ns of CPU time so that
+ * ksmd stays within ksm_cpu_budget percent of a CPU.
+ */
+static unsigned int ksm_budget_sleep_ms(unsigned int sleep_ms, u64 busy_ns)
+{
+	unsigned int budget = READ_ONCE(ksm_cpu_budget);
+	u64 min_sleep_ms;
+
+	if (!budget || budget >= 100)
+		return sleep_ms;
+
+	min_sleep_ms = div_u64(busy_ns * (100 - budget),
+			       (u64)budget * NSEC_PER_MSEC);
+
+	return max_t(u64, sleep_ms, min(min_sleep_ms, (u64)MSEC_PER_SEC));
+}
+
 static int ksmd_should_run(void)
 {
 	return (ksm_run & KSM_RUN_MERGE) && !list_empty(&ksm_mm_head.slot.mm_node);
@@ -2683,22 +2823,26 @@ static int ksmd_should_run(void)
 static int ksm_scan_thread(void *nothing)
 {
 	unsigned int sleep_ms;
+	u64 cpu_time;
 
 	set_freezable();
 	set_user_nice(current, 5);
 
 	while (!kthread_should_stop()) {
+		cpu_time = task_sched_runtime(current);
 		mutex_lock(&ksm_thread_mutex);
 		wait_while_offlining();
 		if (ksmd_should_run())
 			ksm_do_scan(ksm_thread_pages_to_scan);
 		mutex_unlock(&ksm_thread_mutex);
+		cpu_time = task_sched_runtime(current) - cpu_time;
 
 		if (ksmd_should_run()) {
 			sleep_ms = READ_ONCE(ksm_thread_sleep_millisecs);
 			wait_event_freezable_timeout(ksm_iter_wait,
 				sleep_ms != READ_ONCE(ksm_thread_sleep_millisecs),
-				msecs_to_jiffies(sleep_ms));
+				msecs_to_jiffies(ksm_budget_sleep_ms(sleep_ms,
+								     cpu_time)));
 		} else {
 			wait_event_freezable(ksm_thread_wait,
 				ksmd_should_run() || kthread_should_stop());
@@ -3656,6 +3800,37 @@ static ssize_t smart_scan_store(struct kobject *kobj,
 }
 KSM_ATTR(smart_scan);
 
+static ssize_t mm_scans_skipped_show(struct kobject *kobj,
+				     struct kobj_attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%lu\n", ksm_mm_scans_skipped);
+}
+KSM_ATTR_RO(mm_scans_skipped);
+
+static ssize_t cpu_budget_show(struct kobject *kobj,
+			       struct kobj_attribute *attr, char *buf)
+{
+	return sysfs_emit(buf, "%u\n", ksm_cpu_budget);
+}
+
+static ssize_t cpu_budget_store(struct kobject *kobj,
+				struct kobj_attribute *attr,
+				const char *buf, size_t count)
+{
+	unsigned int value;
+	int err;
+
+	err = kstrtouint(buf, 10, &value);
+	if (err || value > 100)
+		return -EINVAL;
+
+	WRITE_ONCE(ksm_cpu_budget, value);
+	wake_up_interruptible(&ksm_iter_wait);
+
+	return count;
+}
+KSM_ATTR(cpu_budget);
+
 static ssize_t advisor_mode_show(struct kobject *kobj,
 				 struct kobj_attribute *attr, char *buf)
 {
@@ -3802,6 +3977,8 @@ static struct attribute *ksm_attrs[] = {
 	&use_zero_pages_attr.attr,
 	&general_profit_attr.attr,
 	&smart_scan_attr.attr,
+	&mm_scans_skipped_attr.attr,
+	&cpu_budget_attr.attr,
 	&advisor_mode_attr.attr,
 	&advisor_max_cpu_attr.attr,
 	&advisor_min_pages_to_scan_attr.attr,
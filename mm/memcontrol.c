@@ -38,6 +38,8 @@
 #include <linux/page-flags.h>
 #include <linux/backing-dev.h>
 #include <linux/bit_spinlock.h>
+#include <linux/btf.h>
+#include <linux/btf_ids.h>
 #include <linux/rcupdate.h>
 #include <linux/limits.h>
 #include <linux/export.h>
@@ -61,6 +63,7 @@
 #include <linux/seq_buf.h>
 #include <linux/sched/isolation.h>
 #include <linux/kmemleak.h>
+#include <linux/random.h>
 #include "internal.h"
 #include <net/sock.h>
 #include <net/ip.h>
@@ -513,6 +516,13 @@ static u64 flush_last_time;
 
 #define FLUSH_TIME (2UL*HZ)
 
+/*
+ * How old the stats shown in memory.stat may be, in milliseconds.  Frequent
+ * readers then don't contend with reclaim for the rstat lock.
+ */
+static unsigned int memcg_stat_max_age_ms;
+module_param_named(stat_max_age_ms, memcg_stat_max_age_ms, uint, 0644);
+
 /*
  * Accessors to ensure that preemption is disabled on PREEMPT_RT because it can
  * not rely on this as part of an acquired spinlock_t lock. These functions are
@@ -599,6 +609,32 @@ void mem_cgroup_flush_stats(struct mem_cgroup *memcg)
 		do_flush_stats(memcg);
 }
 
+/*
+ * mem_cgroup_flush_stats_bounded - flush the stats of a memcg subtree unless
+ * they are recent enough
+ * @memcg: root of the subtree to flush
+ * @max_age_ms: how old the stats of @memcg may be
+ *
+ * Like mem_cgroup_flush_stats(), but skips the flush if @memcg's subtree, or
+ * a subtree containing it, was flushed in the last @max_age_ms milliseconds.
+ * 0 always flushes above the update threshold.
+ */
+void mem_cgroup_flush_stats_bounded(struct mem_cgroup *memcg,
+				    unsigned int max_age_ms)
+{
+	if (mem_cgroup_disabled())
+		return;
+
+	if (!memcg)
+		memcg = root_mem_cgroup;
+
+	if (cgroup_rstat_flushed_within(memcg->css.cgroup,
+					(u64)max_age_ms * NSEC_PER_MSEC))
+		return;
+
+	mem_cgroup_flush_stats(memcg);
+}
+
 void mem_cgroup_flush_stats_ratelimited(struct mem_cgroup *memcg)
 {
 	/* Only flush if the periodic flusher is one full cycle late */
@@ -1426,6 +1462,136 @@ unsigned long memcg_page_state_local_output(struct mem_cgroup *memcg, int item)
 		memcg_page_state_output_unit(item);
 }
 
+/*
+ * BPF kfuncs to read memory.current and memory.stat items, so that a
+ * cgroup iterator can dump the stats of a whole subtree in one read()
+ * in whatever compact form the reader wants, instead of an open(),
+ * read() and close() of the text files of every cgroup.
+ *
+ * They take the cgroup rather than the memcg so that they can be used
+ * on the cgroup handed out by the iterator directly; the memcg is the
+ * effective one of @cgrp. Unknown items read as 0.
+ */
+static struct mem_cgroup *bpf_cgroup_memcg(struct cgroup *cgrp)
+{
+	if (mem_cgroup_disabled())
+		return NULL;
+	return mem_cgroup_from_css(cgroup_e_css(cgrp, &memory_cgrp_subsys));
+}
+
+__bpf_kfunc_start_defs();
+
+/**
+ * bpf_mem_cgroup_page_state - read a memory.stat state item of a cgroup
+ * @cgrp: the cgroup
+ * @idx: a node_stat_item or memcg_stat_item
+ *
+ * Return: the value in the units of memory.stat, i.e. bytes for sizes.
+ */
+__bpf_kfunc u64 bpf_mem_cgroup_page_state(struct cgroup *cgrp, int idx)
+{
+	struct mem_cgroup *memcg;
+	u64 val = 0;
+
+	if (idx < 0 || idx >= MEMCG_NR_STAT || memcg_stats_index(idx) < 0)
+		return 0;
+
+	rcu_read_lock();
+	memcg = bpf_cgroup_memcg(cgrp);
+	if (memcg)
+		val = memcg_page_state_output(memcg, idx);
+	rcu_read_unlock();
+
+	return val;
+}
+
+/**
+ * bpf_mem_cgroup_vm_events - read a memory.stat event item of a cgroup
+ * @cgrp: the cgroup
+ * @event: a vm_event_item
+ */
+__bpf_kfunc u64 bpf_mem_cgroup_vm_events(struct cgroup *cgrp, int event)
+{
+	struct mem_cgroup *memcg;
+	u64 val = 0;
+
+	if (event < 0 || event >= NR_VM_EVENT_ITEMS ||
+	    memcg_events_index(event) < 0)
+		return 0;
+
+	rcu_read_lock();
+	memcg = bpf_cgroup_memcg(cgrp);
+	if (memcg)
+		val = memcg_events(memcg, event);
+	rcu_read_unlock();
+
+	return val;
+}
+
+/**
+ * bpf_mem_cgroup_usage - read memory.current of a cgroup
+ * @cgrp: the cgroup
+ *
+ * Return: the memory usage in bytes.
+ */
+__bpf_kfunc u64 bpf_mem_cgroup_usage(struct cgroup *cgrp)
+{
+	struct mem_cgroup *memcg;
+	u64 val = 0;
+
+	rcu_read_lock();
+	memcg = bpf_cgroup_memcg(cgrp);
+	if (memcg)
+		val = (u64)page_counter_read(&memcg->memory) * PAGE_SIZE;
+	rcu_read_unlock();
+
+	return val;
+}
+
+/**
+ * bpf_mem_cgroup_flush_stats - flush the memory stats of a cgroup subtree
+ * @cgrp: root of the subtree
+ *
+ * To be called once for the root of the walk, before reading the stats of
+ * its descendants with the kfuncs above.
+ */
+__bpf_kfunc void bpf_mem_cgroup_flush_stats(struct cgroup *cgrp)
+{
+	struct mem_cgroup *memcg;
+
+	rcu_read_lock();
+	memcg = bpf_cgroup_memcg(cgrp);
+	if (memcg && !css_tryget(&memcg->css))
+		memcg = NULL;
+	rcu_read_unlock();
+
+	if (memcg) {
+		mem_cgroup_flush_stats(memcg);
+		css_put(&memcg->css);
+	}
+}
+
+__bpf_kfunc_end_defs();
+
+BTF_KFUNCS_START(bpf_memcg_kfunc_ids)
+BTF_ID_FLAGS(func, bpf_mem_cgroup_page_state, KF_TRUSTED_ARGS)
+BTF_ID_FLAGS(func, bpf_mem_cgroup_vm_events, KF_TRUSTED_ARGS)
+BTF_ID_FLAGS(func, bpf_mem_cgroup_usage, KF_TRUSTED_ARGS)
+BTF_ID_FLAGS(func, bpf_mem_cgroup_flush_stats, KF_TRUSTED_ARGS | KF_SLEEPABLE)
+BTF_KFUNCS_END(bpf_memcg_kfunc_ids)
+
+static const struct btf_kfunc_id_set bpf_memcg_kfunc_set = {
+	.owner          = THIS_MODULE,
+	.set            = &bpf_memcg_kfunc_ids,
+};
+
+static int __init bpf_memcg_kfunc_init(void)
+{
+	return register_btf_kfunc_id_set(BPF_PROG_TYPE_TRACING,
+					 &bpf_memcg_kfunc_set);
+}
+late_initcall(bpf_memcg_kfunc_init);
+
 static void memcg_stat_format(struct mem_cgroup *memcg, struct seq_buf *s)
 {
 	int i;
@@ -1440,7 +1606,7 @@ static void memcg_stat_format(struct mem_cgroup *memcg, struct seq_buf *s)
 	 *
 	 * Current memory state:
 	 */
-	mem_cgroup_flush_stats(memcg);
+	mem_cgroup_flush_stats_bounded(memcg, READ_ONCE(memcg_stat_max_age_ms));
 
 	for (i = 0; i < ARRAY_SIZE(memory_stats); i++) {
 		u64 size;
@@ -1693,10 +1859,20 @@ void mem_cgroup_print_oom_group(struct mem_cgroup *memcg)
 	pr_cont(" are going to be killed due to memory.oom.group set\n");
 }
 
+/*
+ * Charges of up to NR_MEMCG_STOCK memcgs are cached per cpu, so cpus that
+ * switch between a few containers don't drain the stock all the time.  The
+ * batch of a memcg grows while it keeps running its stock dry on this cpu,
+ * up to MEMCG_CHARGE_BATCH_MAX, and is reset when its slot is drained.
+ */
+#define NR_MEMCG_STOCK 7
+#define MEMCG_CHARGE_BATCH_MAX (4 * MEMCG_CHARGE_BATCH)
+
 struct memcg_stock_pcp {
 	local_lock_t stock_lock;
-	struct mem_cgroup *cached; /* this never be root cgroup */
-	unsigned int nr_pages;
+	struct mem_cgroup *cached[NR_MEMCG_STOCK]; /* this never be root cgroup */
+	unsigned int nr_pages[NR_MEMCG_STOCK];
+	unsigned int batch[NR_MEMCG_STOCK];
 
 	struct obj_cgroup *cached_objcg;
 	struct pglist_data *cached_pgdat;
@@ -1721,31 +1897,49 @@ static bool obj_stock_flush_required(struct memcg_stock_pcp *stock,
  * consume_stock: Try to consume stocked charge on this cpu.
  * @memcg: memcg to consume from.
  * @nr_pages: how many pages to charge.
+ * @batch: if not NULL, set to the batch to charge @memcg by on failure.
  *
- * The charges will only happen if @memcg matches the current cpu's memcg
+ * The charges will only happen if @memcg is in the current cpu's memcg
  * stock, and at least @nr_pages are available in that stock.  Failure to
  * service an allocation will refill the stock.
  *
  * returns true if successful, false otherwise.
  */
-static bool consume_stock(struct mem_cgroup *memcg, unsigned int nr_pages)
+static bool consume_stock(struct mem_cgroup *memcg, unsigned int nr_pages,
+			  unsigned int *batch)
 {
 	struct memcg_stock_pcp *stock;
 	unsigned int stock_pages;
 	unsigned long flags;
 	bool ret = false;
+	int i;
 
-	if (nr_pages > MEMCG_CHARGE_BATCH)
+	if (batch)
+		*batch = MEMCG_CHARGE_BATCH;
+
+	if (nr_pages > MEMCG_CHARGE_BATCH_MAX)
 		return ret;
 
 	local_lock_irqsave(&memcg_stock.stock_lock, flags);
 
 	stock = this_cpu_ptr(&memcg_stock);
-	stock_pages = READ_ONCE(stock->nr_pages);
-	if (memcg == READ_ONCE(stock->cached) && stock_pages >= nr_pages) {
-		WRITE_ONCE(stock->nr_pages, stock_pages - nr_pages);
-		ret = true;
+	for (i = 0; i < NR_MEMCG_STOCK; i++) {
+		if (memcg != READ_ONCE(stock->cached[i]))
+			continue;
+
+		stock_pages = READ_ONCE(stock->nr_pages[i]);
+		if (stock_pages >= nr_pages) {
+			WRITE_ONCE(stock->nr_pages[i], stock_pages - nr_pages);
+			ret = true;
+		} else if (batch) {
+			/* @memcg ran out of stock on this cpu, charge more */
+			stock->batch[i] = min(stock->batch[i] * 2,
+					      MEMCG_CHARGE_BATCH_MAX);
+			*batch = stock->batch[i];
+		}
+		break;
 	}
+	__count_vm_event(ret ? MEMCG_STOCK_HIT : MEMCG_STOCK_MISS);
 
 	local_unlock_irqrestore(&memcg_stock.stock_lock, flags);
 
@@ -1753,12 +1947,12 @@ static bool consume_stock(struct mem_cgroup *memcg, unsigned int nr_pages)
 }
 
 /*
- * Returns stocks cached in percpu and reset cached information.
+ * Returns the stock cached in slot @i and resets its cached information.
  */
-static void drain_stock(struct memcg_stock_pcp *stock)
+static void drain_stock_slot(struct memcg_stock_pcp *stock, int i)
 {
-	unsigned int stock_pages = READ_ONCE(stock->nr_pages);
-	struct mem_cgroup *old = READ_ONCE(stock->cached);
+	unsigned int stock_pages = READ_ONCE(stock->nr_pages[i]);
+	struct mem_cgroup *old = READ_ONCE(stock->cached[i]);
 
 	if (!old)
 		return;
@@ -1768,11 +1962,23 @@ static void drain_stock(struct memcg_stock_pcp *stock)
 		if (do_memsw_account())
 			page_counter_uncharge(&old->memsw, stock_pages);
 
-		WRITE_ONCE(stock->nr_pages, 0);
+		WRITE_ONCE(stock->nr_pages[i], 0);
+		__count_vm_event(MEMCG_STOCK_DRAIN);
 	}
 
 	css_put(&old->css);
-	WRITE_ONCE(stock->cached, NULL);
+	WRITE_ONCE(stock->cached[i], NULL);
+}
+
+/*
+ * Returns stocks cached in percpu and reset cached information.
+ */
+static void drain_stock(struct memcg_stock_pcp *stock)
+{
+	int i;
+
+	for (i = 0; i < NR_MEMCG_STOCK; i++)
+		drain_stock_slot(stock, i);
 }
 
 static void drain_local_stock(struct work_struct *dummy)
@@ -1805,18 +2011,33 @@ static void __refill_stock(struct mem_cgroup *memcg, unsigned int nr_pages)
 {
 	struct memcg_stock_pcp *stock;
 	unsigned int stock_pages;
+	int i, empty = -1;
 
 	stock = this_cpu_ptr(&memcg_stock);
-	if (READ_ONCE(stock->cached) != memcg) { /* reset if necessary */
-		drain_stock(stock);
+	for (i = 0; i < NR_MEMCG_STOCK; i++) {
+		struct mem_cgroup *cached = READ_ONCE(stock->cached[i]);
+
+		if (cached == memcg)
+			break;
+		if (!cached && empty < 0)
+			empty = i;
+	}
+
+	if (i == NR_MEMCG_STOCK) { /* take a free slot, or evict one */
+		i = empty;
+		if (i < 0) {
+			i = get_random_u32_below(NR_MEMCG_STOCK);
+			drain_stock_slot(stock, i);
+		}
 		css_get(&memcg->css);
-		WRITE_ONCE(stock->cached, memcg);
+		WRITE_ONCE(stock->cached[i], memcg);
+		stock->batch[i] = MEMCG_CHARGE_BATCH;
 	}
-	stock_pages = READ_ONCE(stock->nr_pages) + nr_pages;
-	WRITE_ONCE(stock->nr_pages, stock_pages);
+	stock_pages = READ_ONCE(stock->nr_pages[i]) + nr_pages;
+	WRITE_ONCE(stock->nr_pages[i], stock_pages);
 
-	if (stock_pages > MEMCG_CHARGE_BATCH)
-		drain_stock(stock);
+	if (stock_pages > stock->batch[i])
+		drain_stock_slot(stock, i);
 }
 
 static void refill_stock(struct mem_cgroup *memcg, unsigned int nr_pages)
@@ -1851,13 +2072,18 @@ void drain_all_stock(struct mem_cgroup *root_memcg)
 		struct memcg_stock_pcp *stock = &per_cpu(memcg_stock, cpu);
 		struct mem_cgroup *memcg;
 		bool flush = false;
+		int i;
 
 		rcu_read_lock();
-		memcg = READ_ONCE(stock->cached);
-		if (memcg && READ_ONCE(stock->nr_pages) &&
-		    mem_cgroup_is_descendant(memcg, root_memcg))
-			flush = true;
-		else if (obj_stock_flush_required(stock, root_memcg))
+		for (i = 0; i < NR_MEMCG_STOCK; i++) {
+			memcg = READ_ONCE(stock->cached[i]);
+			if (memcg && READ_ONCE(stock->nr_pages[i]) &&
+			    mem_cgroup_is_descendant(memcg, root_memcg)) {
+				flush = true;
+				break;
+			}
+		}
+		if (!flush && obj_stock_flush_required(stock, root_memcg))
 			flush = true;
 		rcu_read_unlock();
 
@@ -2156,7 +2382,7 @@ void mem_cgroup_handle_over_high(gfp_t gfp_mask)
 int try_charge_memcg(struct mem_cgroup *memcg, gfp_t gfp_mask,
 		     unsigned int nr_pages)
 {
-	unsigned int batch = max(MEMCG_CHARGE_BATCH, nr_pages);
+	unsigned int batch = 0;
 	int nr_retries = MAX_RECLAIM_RETRIES;
 	struct mem_cgroup *mem_over_limit;
 	struct page_counter *counter;
@@ -2168,8 +2394,10 @@ int try_charge_memcg(struct mem_cgroup *memcg, gfp_t gfp_mask,
 	unsigned long pflags;
 
 retry:
-	if (consume_stock(memcg, nr_pages))
+	/* Pick the batch on the first try, keep it once it was cut down */
+	if (consume_stock(memcg, nr_pages, batch ? NULL : &batch))
 		return 0;
+	batch = max(batch, nr_pages);
 
 	if (!do_memsw_account() ||
 	    page_counter_try_charge(&memcg->memsw, batch, &counter)) {
@@ -3529,6 +3757,8 @@ static void mem_cgroup_free(struct mem_cgroup *memcg)
 	__mem_cgroup_free(memcg);
 }
 
+static void memcg_proactive_work_fn(struct work_struct *work);
+
 static struct mem_cgroup *mem_cgroup_alloc(struct mem_cgroup *parent)
 {
 	struct memcg_vmstats_percpu *statc, *pstatc;
@@ -3573,6 +3803,7 @@ static struct mem_cgroup *mem_cgroup_alloc(struct mem_cgroup *parent)
 		goto fail;
 
 	INIT_WORK(&memcg->high_work, high_work_func);
+	INIT_DELAYED_WORK(&memcg->proactive.work, memcg_proactive_work_fn);
 	vmpressure_init(&memcg->vmpressure);
 	memcg->socket_pressure = jiffies;
 	memcg1_memcg_init(memcg);
@@ -3700,6 +3931,8 @@ static void mem_cgroup_css_offline(struct cgroup_subsys_state *css)
 
 	memcg1_css_offline(memcg);
 
+	cancel_delayed_work_sync(&memcg->proactive.work);
+
 	page_counter_set_min(&memcg->memory, 0);
 	page_counter_set_low(&memcg->memory, 0);
 
@@ -4315,6 +4548,196 @@ static ssize_t memory_reclaim(struct kernfs_open_file *of, char *buf,
 	return nbytes;
 }
 
+/*
+ * Proactive reclaim runs at the PSI averaging period, which is also how often
+ * the PSI stall totals it's based on are updated.
+ */
+#define MEMCG_PROACTIVE_INTERVAL	(2 * HZ)
+
+/* Serializes memory.reclaim.proactive updates */
+static DEFINE_MUTEX(memcg_proactive_mutex);
+
+static u64 memcg_proactive_stall(struct mem_cgroup *memcg)
+{
+#ifdef CONFIG_PSI
+	struct psi_group *group = cgroup_psi(memcg->css.cgroup);
+
+	if (!group)
+		return 0;
+	return READ_ONCE(group->total[PSI_AVGS][PSI_MEM_SOME]);
+#else
+	return 0;
+#endif
+}
+
+static unsigned long memcg_proactive_refaults(struct mem_cgroup *memcg)
+{
+	mem_cgroup_flush_stats_ratelimited(memcg);
+
+	return memcg_page_state(memcg, WORKINGSET_REFAULT_ANON) +
+	       memcg_page_state(memcg, WORKINGSET_REFAULT_FILE);
+}
+
+/*
+ * Scale @nr down linearly with how much of @budget was used in the last
+ * period, down to nothing once it's used up.
+ */
+static unsigned long memcg_proactive_scale(unsigned long nr, u64 used,
+					   unsigned long budget)
+{
+	if (!budget)
+		return nr;
+	if (used >= budget)
+		return 0;
+	return div64_u64((u64)nr * (budget - used), budget);
+}
+
+/*
+ * Reclaim up to memory.reclaim.proactive's rate every period as long as the
+ * cgroup stays within its memory stall and refault budgets, so the working
+ * set is trimmed to what the workload can afford to lose. Under MGLRU this
+ * ages and evicts generations through the regular memcg reclaim path.
+ */
+static void memcg_proactive_work_fn(struct work_struct *work)
+{
+	struct memcg_proactive_reclaim *pr =
+		container_of(to_delayed_work(work), struct memcg_proactive_reclaim, work);
+	struct mem_cgroup *memcg = container_of(pr, struct mem_cgroup, proactive);
+	unsigned long secs = MEMCG_PROACTIVE_INTERVAL / HZ;
+	unsigned long rate = READ_ONCE(pr->rate);
+	unsigned long refaults, nr_to_reclaim;
+	u64 stall;
+
+	if (!rate)
+		return;
+
+	stall = memcg_proactive_stall(memcg);
+	refaults = memcg_proactive_refaults(memcg);
+
+	nr_to_reclaim = memcg_proactive_scale(rate * secs,
+			div_u64(stall - pr->last_stall, NSEC_PER_USEC * secs),
+			READ_ONCE(pr->psi_us));
+	nr_to_reclaim = memcg_proactive_scale(nr_to_reclaim,
+			(refaults - pr->last_refaults) / secs,
+			READ_ONCE(pr->refaults));
+
+	if (nr_to_reclaim) {
+		unsigned long reclaimed;
+
+		reclaimed = try_to_free_mem_cgroup_pages(memcg, nr_to_reclaim,
+					GFP_KERNEL,
+					MEMCG_RECLAIM_MAY_SWAP | MEMCG_RECLAIM_PROACTIVE,
+					NULL);
+		atomic_long_add(reclaimed, &pr->reclaimed);
+	}
+
+	/* the reclaim itself counts against the next period's budgets */
+	pr->last_stall = stall;
+	pr->last_refaults = refaults;
+
+	queue_delayed_work(system_unbound_wq, &pr->work, MEMCG_PROACTIVE_INTERVAL);
+}
+
+static int memory_reclaim_proactive_show(struct seq_file *m, void *v)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_seq(m);
+	struct memcg_proactive_reclaim *pr = &memcg->proactive;
+	unsigned long rate = READ_ONCE(pr->rate);
+
+	if (!rate)
+		seq_puts(m, "none\n");
+	else
+		seq_printf(m, "rate=%lu psi=%lu refault=%lu\n",
+			   rate * PAGE_SIZE, READ_ONCE(pr->psi_us),
+			   READ_ONCE(pr->refaults));
+
+	seq_printf(m, "reclaimed %lu\n",
+		   atomic_long_read(&pr->reclaimed) * PAGE_SIZE);
+	return 0;
+}
+
+enum {
+	MEMORY_PROACTIVE_RATE = 0,
+	MEMORY_PROACTIVE_PSI,
+	MEMORY_PROACTIVE_REFAULT,
+	MEMORY_PROACTIVE_NULL,
+};
+
+static const match_table_t proactive_tokens = {
+	{ MEMORY_PROACTIVE_RATE, "rate=%s"},
+	{ MEMORY_PROACTIVE_PSI, "psi=%u"},
+	{ MEMORY_PROACTIVE_REFAULT, "refault=%u"},
+	{ MEMORY_PROACTIVE_NULL, NULL },
+};
+
+/*
+ * "rate=<bytes> [psi=<usecs>] [refault=<pages>]", all per second, enables
+ * proactive reclaim of up to rate bytes per second for as long as the memory
+ * "some" stall time and the number of refaults per second stay below their
+ * budgets. "none" disables it.
+ */
+static ssize_t memory_reclaim_proactive_write(struct kernfs_open_file *of,
+					      char *buf, size_t nbytes,
+					      loff_t off)
+{
+	struct mem_cgroup *memcg = mem_cgroup_from_css(of_css(of));
+	struct memcg_proactive_reclaim *pr = &memcg->proactive;
+	unsigned long rate = 0, psi_us = 0, refaults = 0;
+	substring_t args[MAX_OPT_ARGS];
+	char *start, *end;
+	unsigned int val;
+
+	buf = strstrip(buf);
+
+	if (strcmp(buf, "none")) {
+		while ((start = strsep(&buf, " ")) != NULL) {
+			if (!strlen(start))
+				continue;
+			switch (match_token(start, proactive_tokens, args)) {
+			case MEMORY_PROACTIVE_RATE:
+				rate = memparse(args[0].from, &end) / PAGE_SIZE;
+				if (end != args[0].to)
+					return -EINVAL;
+				break;
+			case MEMORY_PROACTIVE_PSI:
+				if (match_uint(&args[0], &val))
+					return -EINVAL;
+				if (!cgroup_psi_enabled())
+					return -EOPNOTSUPP;
+				psi_us = val;
+				break;
+			case MEMORY_PROACTIVE_REFAULT:
+				if (match_uint(&args[0], &val))
+					return -EINVAL;
+				refaults = val;
+				break;
+			default:
+				return -EINVAL;
+			}
+		}
+
+		if (!rate)
+			return -EINVAL;
+	}
+
+	guard(mutex)(&memcg_proactive_mutex);
+
+	cancel_delayed_work_sync(&pr->work);
+
+	WRITE_ONCE(pr->psi_us, psi_us);
+	WRITE_ONCE(pr->refaults, refaults);
+	WRITE_ONCE(pr->rate, rate);
+
+	if (rate) {
+		pr->last_stall = memcg_proactive_stall(memcg);
+		pr->last_refaults = memcg_proactive_refaults(memcg);
+		queue_delayed_work(system_unbound_wq, &pr->work,
+				   MEMCG_PROACTIVE_INTERVAL);
+	}
+
+	return nbytes;
+}
+
 static struct cftype memory_files[] = {
 	{
 		.name = "current",
@@ -4383,6 +4806,12 @@ static struct cftype memory_files[] = {
 		.flags = CFTYPE_NS_DELEGATABLE,
 		.write = memory_reclaim,
 	},
+	{
+		.name = "reclaim.proactive",
+		.flags = CFTYPE_NOT_ON_ROOT | CFTYPE_NS_DELEGATABLE,
+		.seq_show = memory_reclaim_proactive_show,
+		.write = memory_reclaim_proactive_write,
+	},
 	{ }	/* terminate */
 };
 
@@ -78,6 +78,7 @@
 #include <linux/ptrace.h>
 #include <linux/vmalloc.h>
 #include <linux/sched/sysctl.h>
+#include <linux/prctl.h>
 
 #include <trace/events/kmem.h>
 
@@ -1349,11 +1350,127 @@ vma_needs_copy(struct vm_area_struct *dst_vma, struct vm_area_struct *src_vma)
 	return false;
 }
 
-int
-copy_page_range(struct vm_area_struct *dst_vma, struct vm_area_struct *src_vma)
+static int copy_pgd_range(struct vm_area_struct *dst_vma,
+		struct vm_area_struct *src_vma, unsigned long addr,
+		unsigned long end)
 {
 	pgd_t *src_pgd, *dst_pgd;
 	unsigned long next;
+
+	dst_pgd = pgd_offset(dst_vma->vm_mm, addr);
+	src_pgd = pgd_offset(src_vma->vm_mm, addr);
+	do {
+		next = pgd_addr_end(addr, end);
+		if (pgd_none_or_clear_bad(src_pgd))
+			continue;
+		if (unlikely(copy_p4d_range(dst_vma, src_vma, dst_pgd, src_pgd,
+					    addr, next)))
+			return -ENOMEM;
+	} while (dst_pgd++, src_pgd++, addr = next, addr != end);
+
+	return 0;
+}
+
+/*
+ * Large anonymous VMAs of processes that asked for it with
+ * PR_SET_FORK_COPY_THREADS have their page tables copied by several threads,
+ * each taking PUD_SIZE chunks that share no page tables with the others. The
+ * forking thread holds both mmap_locks for the workers for the duration.
+ */
+#define FORK_COPY_MIN_CHUNKS	4
+
+struct fork_copy_job {
+	struct vm_area_struct *dst_vma;
+	struct vm_area_struct *src_vma;
+	struct mem_cgroup *memcg;
+	atomic_long_t next_chunk;
+	int ret;
+};
+
+struct fork_copy_work {
+	struct work_struct work;
+	struct fork_copy_job *job;
+};
+
+static bool copy_page_range_parallel(struct vm_area_struct *src_vma)
+{
+	unsigned long size = src_vma->vm_end - src_vma->vm_start;
+
+	return READ_ONCE(src_vma->vm_mm->fork_copy_threads) > 1 &&
+	       vma_is_anonymous(src_vma) &&
+	       size >= FORK_COPY_MIN_CHUNKS * PUD_SIZE;
+}
+
+static void fork_copy_run(struct fork_copy_job *job)
+{
+	unsigned long start = job->src_vma->vm_start;
+	unsigned long end = job->src_vma->vm_end;
+	unsigned long base = start & PUD_MASK;
+	struct mem_cgroup *old_memcg;
+
+	/* page tables are charged like the forking thread's would be */
+	old_memcg = set_active_memcg(job->memcg);
+
+	while (!READ_ONCE(job->ret)) {
+		unsigned long chunk = atomic_long_fetch_inc(&job->next_chunk);
+		unsigned long addr = base + chunk * PUD_SIZE;
+		unsigned long next;
+		int ret;
+
+		if (addr >= end || addr < base)
+			break;
+		next = min(addr + PUD_SIZE, end);
+		addr = max(addr, start);
+
+		ret = copy_pgd_range(job->dst_vma, job->src_vma, addr, next);
+		if (ret)
+			WRITE_ONCE(job->ret, ret);
+		cond_resched();
+	}
+
+	set_active_memcg(old_memcg);
+}
+
+static void fork_copy_workfn(struct work_struct *work)
+{
+	fork_copy_run(container_of(work, struct fork_copy_work, work)->job);
+}
+
+static int copy_page_range_mt(struct vm_area_struct *dst_vma,
+		struct vm_area_struct *src_vma)
+{
+	struct fork_copy_work works[PR_FORK_COPY_THREADS_MAX - 1];
+	struct fork_copy_job job = {
+		.dst_vma	= dst_vma,
+		.src_vma	= src_vma,
+		.memcg		= get_mem_cgroup_from_mm(dst_vma->vm_mm),
+		.next_chunk	= ATOMIC_LONG_INIT(0),
+	};
+	unsigned int nr, i;
+
+	nr = min(READ_ONCE(src_vma->vm_mm->fork_copy_threads),
+		 num_online_cpus()) - 1;
+
+	for (i = 0; i < nr; i++) {
+		INIT_WORK_ONSTACK(&works[i].work, fork_copy_workfn);
+		works[i].job = &job;
+		queue_work(system_unbound_wq, &works[i].work);
+	}
+
+	fork_copy_run(&job);
+
+	for (i = 0; i < nr; i++) {
+		flush_work(&works[i].work);
+		destroy_work_on_stack(&works[i].work);
+	}
+
+	mem_cgroup_put(job.memcg);
+	return job.ret;
+}
+
+int
+copy_page_range(struct vm_area_struct *dst_vma, struct vm_area_struct *src_vma)
+{
 	unsigned long addr = src_vma->vm_start;
 	unsigned long end = src_vma->vm_end;
 	struct mm_struct *dst_mm = dst_vma->vm_mm;
@@ -1401,20 +1518,12 @@ copy_page_range(struct vm_area_struct *dst_vma, struct vm_area_struct *src_vma)
 		raw_write_seqcount_begin(&src_mm->write_protect_seq);
 	}
 
-	ret = 0;
-	dst_pgd = pgd_offset(dst_mm, addr);
-	src_pgd = pgd_offset(src_mm, addr);
-	do {
-		next = pgd_addr_end(addr, end);
-		if (pgd_none_or_clear_bad(src_pgd))
-			continue;
-		if (unlikely(copy_p4d_range(dst_vma, src_vma, dst_pgd, src_pgd,
-					    addr, next))) {
-			untrack_pfn_clear(dst_vma);
-			ret = -ENOMEM;
-			break;
-		}
-	} while (dst_pgd++, src_pgd++, addr = next, addr != end);
+	if (copy_page_range_parallel(src_vma))
+		ret = copy_page_range_mt(dst_vma, src_vma);
+	else
+		ret = copy_pgd_range(dst_vma, src_vma, addr, end);
+	if (ret)
+		untrack_pfn_clear(dst_vma);
 
 	if (is_cow) {
 		raw_write_seqcount_end(&src_mm->write_protect_seq);
@@ -3271,6 +3380,7 @@ static inline vm_fault_t vmf_can_call_fault(const struct vm_fault *vmf)
 
 	if (vma->vm_ops->map_pages || !(vmf->flags & FAULT_FLAG_VMA_LOCK))
 		return 0;
+	count_vm_vma_lock_event(VMA_LOCK_FALLBACK_FAULT);
 	vma_end_read(vma);
 	return VM_FAULT_RETRY;
 }
@@ -3299,6 +3409,7 @@ vm_fault_t vmf_anon_prepare(struct vm_fault *vmf)
 		return 0;
 	if (vmf->flags & FAULT_FLAG_VMA_LOCK) {
 		if (!mmap_read_trylock(vma->vm_mm)) {
+			count_vm_vma_lock_event(VMA_LOCK_FALLBACK_ANON);
 			vma_end_read(vma);
 			return VM_FAULT_RETRY;
 		}
@@ -4046,6 +4157,7 @@ vm_fault_t do_swap_page(struct vm_fault *vmf)
 				 * migrate_to_ram is not yet ready to operate
 				 * under VMA lock.
 				 */
+				count_vm_vma_lock_event(VMA_LOCK_FALLBACK_DEVICE);
 				vma_end_read(vma);
 				ret = VM_FAULT_RETRY;
 				goto out;
@@ -4491,9 +4603,9 @@ static struct folio *alloc_anon_folio(struct vm_fault *vmf)
 		goto fallback;
 
 	/* Try allocating the highest of the remaining orders. */
-	gfp = vma_thp_gfp_mask(vma);
 	while (orders) {
 		addr = ALIGN_DOWN(vmf->address, PAGE_SIZE << order);
+		gfp = vma_thp_gfp_mask(vma, order);
 		folio = vma_alloc_folio(gfp, order, vma, addr, true);
 		if (folio) {
 			if (mem_cgroup_charge(folio, vma->vm_mm, gfp)) {
@@ -5375,7 +5487,8 @@ static vm_fault_t do_numa_page(struct vm_fault *vmf)
 	if (!migrate_misplaced_folio(folio, vma, target_nid)) {
 		nid = target_nid;
 		flags |= TNF_MIGRATED;
-		task_numa_fault(last_cpupid, nid, nr_pages, flags);
+		task_numa_fault(last_cpupid, nid, nr_pages, flags,
+				vma_numa_group_mapping(vma));
 		return 0;
 	}
 
@@ -5402,7 +5515,8 @@ static vm_fault_t do_numa_page(struct vm_fault *vmf)
 	pte_unmap_unlock(vmf->pte, vmf->ptl);
 
 	if (nid != NUMA_NO_NODE)
-		task_numa_fault(last_cpupid, nid, nr_pages, flags);
+		task_numa_fault(last_cpupid, nid, nr_pages, flags,
+				vma_numa_group_mapping(vma));
 	return 0;
 }
 
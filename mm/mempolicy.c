@@ -105,6 +105,7 @@
 #include <linux/security.h>
 #include <linux/syscalls.h>
 #include <linux/ctype.h>
+#include <linux/gcd.h>
 #include <linux/mm_inline.h>
 #include <linux/mmu_notifier.h>
 #include <linux/printk.h>
@@ -141,29 +142,110 @@ static struct mempolicy preferred_node_policy[MAX_NUMNODES];
 /*
  * iw_table is the sysfs-set interleave weight table, a value of 0 denotes
  * system-default value should be used. A NULL iw_table also denotes that
- * system-default values should be used. Until the system-default table
- * is implemented, the system-default is always 1.
+ * system-default values should be used.
  *
- * iw_table is RCU protected
+ * iw_default is the system-default table, derived from the bandwidth that
+ * HMAT or the CXL driver reports for each node. A NULL iw_default, or a 0
+ * entry in it, denotes a system-default weight of 1.
+ *
+ * Both tables are RCU protected and updated under iw_table_lock, which
+ * also protects node_bw_table.
  */
 static u8 __rcu *iw_table;
+static u8 __rcu *iw_default;
+static unsigned int *node_bw_table;
 static DEFINE_MUTEX(iw_table_lock);
 
+/* Default weight of the node with the highest bandwidth */
+#define IW_DEFAULT_MAX_WEIGHT	32
+
+static u8 __get_il_weight(u8 *table, u8 *dflt, int node)
+{
+	u8 weight = table ? table[node] : 0;
+
+	/* if value in iw_table is 0, use system default */
+	if (!weight && dflt)
+		weight = dflt[node];
+	return weight ? weight : 1;
+}
+
 static u8 get_il_weight(int node)
 {
-	u8 *table;
 	u8 weight;
 
 	rcu_read_lock();
-	table = rcu_dereference(iw_table);
-	/* if no iw_table, use system default */
-	weight = table ? table[node] : 1;
-	/* if value in iw_table is 0, use system default */
-	weight = weight ? weight : 1;
+	weight = __get_il_weight(rcu_dereference(iw_table),
+				 rcu_dereference(iw_default), node);
 	rcu_read_unlock();
 	return weight;
 }
 
+/**
+ * mempolicy_set_node_perf - Update the default weights from node bandwidth
+ * @node: Node whose performance coordinates were reported
+ * @coords: Performance coordinates from the node to its nearest CPU
+ *
+ * Scale the default weighted interleave weight of every node with a known
+ * bandwidth to its share of the highest bandwidth, so that bandwidth bound
+ * workloads spread over DRAM and CXL memory without manual tuning. Weights
+ * set through sysfs take precedence over the defaults.
+ *
+ * Return: 0 on success, -errno on failure.
+ */
+int mempolicy_set_node_perf(unsigned int node, struct access_coordinate *coords)
+{
+	unsigned int bw, max_bw = 0, div = 0;
+	u8 *new, *old;
+	int nid;
+
+	if (node >= nr_node_ids)
+		return -EINVAL;
+
+	bw = coords->read_bandwidth;
+	if (coords->write_bandwidth)
+		bw = min(bw, coords->write_bandwidth);
+
+	new = kzalloc(nr_node_ids, GFP_KERNEL);
+	if (!new)
+		return -ENOMEM;
+
+	mutex_lock(&iw_table_lock);
+	if (!node_bw_table) {
+		node_bw_table = kcalloc(nr_node_ids, sizeof(*node_bw_table),
+					GFP_KERNEL);
+		if (!node_bw_table) {
+			mutex_unlock(&iw_table_lock);
+			kfree(new);
+			return -ENOMEM;
+		}
+	}
+	node_bw_table[node] = bw;
+
+	for_each_node(nid)
+		max_bw = max(max_bw, node_bw_table[nid]);
+
+	for_each_node(nid) {
+		if (!node_bw_table[nid])
+			continue;
+		new[nid] = max_t(u64, 1,
+				 DIV_ROUND_CLOSEST_ULL((u64)node_bw_table[nid] *
+						       IW_DEFAULT_MAX_WEIGHT, max_bw));
+		div = gcd(div, new[nid]);
+	}
+	/* 32:16 interleaves like 2:1, but with fewer node switches */
+	if (div > 1)
+		for_each_node(nid)
+			new[nid] /= div;
+
+	old = rcu_dereference_protected(iw_default,
+					lockdep_is_held(&iw_table_lock));
+	rcu_assign_pointer(iw_default, new);
+	mutex_unlock(&iw_table_lock);
+	synchronize_rcu();
+	kfree(old);
+	return 0;
+}
+
 /**
  * numa_nearest_node - Find nearest node by state
  * @node: Node id to start the search
@@ -667,20 +749,20 @@ static int queue_folios_hugetlb(pte_t *pte, unsigned long hmask,
  * an architecture makes a different choice, it will need further
  * changes to the core.
  */
-unsigned long change_prot_numa(struct vm_area_struct *vma,
+/*
+ * The TLB flush is left to the caller's tlb_finish_mmu(), so that a scan over
+ * several VMAs can be flushed at once.
+ */
+unsigned long change_prot_numa(struct mmu_gather *tlb,
+			struct vm_area_struct *vma,
 			unsigned long addr, unsigned long end)
 {
-	struct mmu_gather tlb;
 	long nr_updated;
 
-	tlb_gather_mmu(&tlb, vma->vm_mm);
-
-	nr_updated = change_protection(&tlb, vma, addr, end, MM_CP_PROT_NUMA);
+	nr_updated = change_protection(tlb, vma, addr, end, MM_CP_PROT_NUMA);
 	if (nr_updated > 0)
 		count_vm_numa_events(NUMA_PTE_UPDATES, nr_updated);
 
-	tlb_finish_mmu(&tlb);
-
 	return nr_updated;
 }
 #endif /* CONFIG_NUMA_BALANCING */
@@ -1979,7 +2061,7 @@ static unsigned int weighted_interleave_nid(struct mempolicy *pol, pgoff_t ilx)
 {
 	nodemask_t nodemask;
 	unsigned int target, nr_nodes;
-	u8 *table;
+	u8 *table, *dflt;
 	unsigned int weight_total = 0;
 	u8 weight;
 	int nid;
@@ -1990,21 +2072,16 @@ static unsigned int weighted_interleave_nid(struct mempolicy *pol, pgoff_t ilx)
 
 	rcu_read_lock();
 	table = rcu_dereference(iw_table);
+	dflt = rcu_dereference(iw_default);
 	/* calculate the total weight */
-	for_each_node_mask(nid, nodemask) {
-		/* detect system default usage */
-		weight = table ? table[nid] : 1;
-		weight = weight ? weight : 1;
-		weight_total += weight;
-	}
+	for_each_node_mask(nid, nodemask)
+		weight_total += __get_il_weight(table, dflt, nid);
 
 	/* Calculate the node offset based on totals */
 	target = ilx % weight_total;
 	nid = first_node(nodemask);
 	while (target) {
-		/* detect system default usage */
-		weight = table ? table[nid] : 1;
-		weight = weight ? weight : 1;
+		weight = __get_il_weight(table, dflt, nid);
 		if (target < weight)
 			break;
 		target -= weight;
@@ -2262,7 +2339,8 @@ struct page *alloc_pages_mpol_noprof(gfp_t gfp, unsigned int order,
 
 	page = __alloc_pages_noprof(gfp, order, nid, nodemask);
 
-	if (unlikely(pol->mode == MPOL_INTERLEAVE) && page) {
+	if (unlikely(pol->mode == MPOL_INTERLEAVE ||
+		     pol->mode == MPOL_WEIGHTED_INTERLEAVE) && page) {
 		/* skip NUMA_INTERLEAVE_HIT update if numa stats is disabled */
 		if (static_branch_likely(&vm_numa_stat_key) &&
 		    page_to_nid(page) == nid) {
@@ -2396,7 +2474,7 @@ static unsigned long alloc_pages_bulk_array_weighted_interleave(gfp_t gfp,
 	unsigned long nr_allocated = 0;
 	unsigned long rounds;
 	unsigned long node_pages, delta;
-	u8 *table, *weights, weight;
+	u8 *table, *dflt, *weights, weight;
 	unsigned int weight_total = 0;
 	unsigned long rem_pages = nr_pages;
 	nodemask_t nodes;
@@ -2447,16 +2525,14 @@ static unsigned long alloc_pages_bulk_array_weighted_interleave(gfp_t gfp,
 
 	rcu_read_lock();
 	table = rcu_dereference(iw_table);
-	if (table)
-		memcpy(weights, table, nr_node_ids);
+	dflt = rcu_dereference(iw_default);
+	for_each_node_mask(node, nodes)
+		weights[node] = __get_il_weight(table, dflt, node);
 	rcu_read_unlock();
 
-	/* calculate total, detect system default usage */
-	for_each_node_mask(node, nodes) {
-		if (!weights[node])
-			weights[node] = 1;
+	/* calculate total */
+	for_each_node_mask(node, nodes)
 		weight_total += weights[node];
-	}
 
 	/*
 	 * Calculate rounds/partial rounds to minimize __alloc_pages_bulk calls.
@@ -1799,7 +1799,7 @@ static int migrate_pages_batch(struct list_head *from,
 	stats->nr_failed_pages += nr_retry_pages;
 move:
 	/* Flush TLBs for all unmapped folios */
-	try_to_unmap_flush();
+	try_to_unmap_flush(TLB_BATCH_MIGRATE);
 
 	retry = 1;
 	for (pass = 0; pass < nr_pass && retry; pass++) {
@@ -2678,7 +2678,11 @@ do_vmi_align_munmap(struct vma_iterator *vmi, struct vm_area_struct *vma,
 				goto end_split_failed;
 		}
 		vma_start_write(next);
-		mas_set(&mas_detach, count);
+		/*
+		 * Entries are appended at increasing indices, so continue from
+		 * the last leaf instead of walking from the root every time.
+		 */
+		__mas_set_range(&mas_detach, count, count);
 		error = mas_store_gfp(&mas_detach, next, GFP_KERNEL);
 		if (error)
 			goto munmap_gather_failed;
@@ -511,7 +511,15 @@ static long change_protection_range(struct mmu_gather *tlb,
 					  cp_flags);
 	} while (pgd++, addr = next, addr != end);
 
-	tlb_end_vma(tlb, vma);
+	/*
+	 * A stale TLB entry only delays the next NUMA hinting fault, so let
+	 * the NUMA scanner flush all the VMAs it changed at once instead of
+	 * sending one round of IPIs per VMA. tlb_end_vma() is still needed
+	 * where the flush depends on the VMA's flags.
+	 */
+	if (!(cp_flags & MM_CP_PROT_NUMA) ||
+	    (vma->vm_flags & (VM_EXEC | VM_PFNMAP)))
+		tlb_end_vma(tlb, vma);
 
 	return pages;
 }
@@ -1591,6 +1591,18 @@ static unsigned long dirty_poll_interval(unsigned long dirty,
 	return 1;
 }
 
+/*
+ * Account a balance_dirty_pages() pause for the wb stats in debugfs. The
+ * maximum is updated racily, a lost update only delays a new maximum.
+ */
+static void wb_account_throttle(struct bdi_writeback *wb, unsigned long slept)
+{
+	atomic_long_inc(&wb->nr_throttled);
+	atomic_long_add(slept, &wb->throttle_time);
+	if (slept > READ_ONCE(wb->max_throttle_time))
+		WRITE_ONCE(wb->max_throttle_time, slept);
+}
+
 static unsigned long wb_max_pause(struct bdi_writeback *wb,
 				  unsigned long wb_dirty)
 {
@@ -1847,6 +1859,7 @@ static int balance_dirty_pages(struct bdi_writeback *wb,
 	struct backing_dev_info *bdi = wb->bdi;
 	bool strictlimit = bdi->capabilities & BDI_CAP_STRICTLIMIT;
 	unsigned long start_time = jiffies;
+	unsigned long sleep_start;
 	int ret = 0;
 
 	for (;;) {
@@ -2003,8 +2016,10 @@ static int balance_dirty_pages(struct bdi_writeback *wb,
 			break;
 		}
 		__set_current_state(TASK_KILLABLE);
-		bdi->last_bdp_sleep = jiffies;
+		sleep_start = jiffies;
+		bdi->last_bdp_sleep = sleep_start;
 		io_schedule_timeout(pause);
+		wb_account_throttle(wb, jiffies - sleep_start);
 
 		current->dirty_paused_when = now + pause;
 		current->nr_dirtied = 0;
@@ -2417,10 +2432,12 @@ void tag_pages_for_writeback(struct address_space *mapping,
 
 	xas_lock_irq(&xas);
 	xas_for_each_marked(&xas, page, end, PAGECACHE_TAG_DIRTY) {
-		xas_set_mark(&xas, PAGECACHE_TAG_TOWRITE);
-		if (++tagged % XA_CHECK_SCHED)
+		tagged += xas_copy_mark_node(&xas, end, PAGECACHE_TAG_DIRTY,
+					     PAGECACHE_TAG_TOWRITE);
+		if (tagged < XA_CHECK_SCHED)
 			continue;
 
+		tagged = 0;
 		xas_pause(&xas);
 		xas_unlock_irq(&xas);
 		cond_resched();
@@ -503,17 +503,31 @@ static void bad_page(struct page *page, const char *reason)
 	add_taint(TAINT_BAD_PAGE, LOCKDEP_NOW_UNRELIABLE);
 }
 
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+/*
+ * The mTHP orders up to PCP_MAX_MTHP_ORDER below the PMD order have a pair of
+ * lists each, and the PMD order has the last pair.
+ */
+static inline unsigned int pcp_high_order_index(unsigned int order)
+{
+	if (order <= PCP_MAX_MTHP_ORDER && order < HPAGE_PMD_ORDER)
+		return order - PAGE_ALLOC_COSTLY_ORDER - 1;
+
+	VM_BUG_ON(order != HPAGE_PMD_ORDER);
+	return NR_PCP_HIGH_ORDERS - 1;
+}
+#endif
+
 static inline unsigned int order_to_pindex(int migratetype, int order)
 {
 	bool __maybe_unused movable;
 
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
 	if (order > PAGE_ALLOC_COSTLY_ORDER) {
-		VM_BUG_ON(order != HPAGE_PMD_ORDER);
-
 		movable = migratetype == MIGRATE_MOVABLE;
 
-		return NR_LOWORDER_PCP_LISTS + movable;
+		return NR_LOWORDER_PCP_LISTS + 2 * pcp_high_order_index(order) +
+		       movable;
 	}
 #else
 	VM_BUG_ON(order > PAGE_ALLOC_COSTLY_ORDER);
@@ -527,8 +541,14 @@ static inline int pindex_to_order(unsigned int pindex)
 	int order = pindex / MIGRATE_PCPTYPES;
 
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
-	if (pindex >= NR_LOWORDER_PCP_LISTS)
-		order = HPAGE_PMD_ORDER;
+	if (pindex >= NR_LOWORDER_PCP_LISTS) {
+		unsigned int index = (pindex - NR_LOWORDER_PCP_LISTS) / 2;
+
+		if (index == NR_PCP_HIGH_ORDERS - 1)
+			order = HPAGE_PMD_ORDER;
+		else
+			order = PAGE_ALLOC_COSTLY_ORDER + 1 + index;
+	}
 #else
 	VM_BUG_ON(order > PAGE_ALLOC_COSTLY_ORDER);
 #endif
@@ -536,6 +556,17 @@ static inline int pindex_to_order(unsigned int pindex)
 	return order;
 }
 
+/* Index of the order in the per order pcp counters, below NR_PCP_ORDERS */
+static inline unsigned int pcp_order_index(unsigned int order)
+{
+	BUILD_BUG_ON(PCP_ZONE_LOCK_ORDER0 - PCP_ALLOC_ORDER0 != NR_PCP_ORDERS);
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	if (order > PAGE_ALLOC_COSTLY_ORDER)
+		return PAGE_ALLOC_COSTLY_ORDER + 1 + pcp_high_order_index(order);
+#endif
+	return order;
+}
+
 static inline bool pcp_allowed_order(unsigned int order)
 {
 	if (order <= PAGE_ALLOC_COSTLY_ORDER)
@@ -543,10 +574,29 @@ static inline bool pcp_allowed_order(unsigned int order)
 #ifdef CONFIG_TRANSPARENT_HUGEPAGE
 	if (order == HPAGE_PMD_ORDER)
 		return true;
+	if (order <= PCP_MAX_MTHP_ORDER && order < HPAGE_PMD_ORDER)
+		return true;
 #endif
 	return false;
 }
 
+/*
+ * Allocations of orders above PAGE_ALLOC_COSTLY_ORDER scale their pcp batch
+ * by their own factor, so that a burst of e.g. 64K folio allocations doesn't
+ * grow the batch of the order-0 allocations, and vice versa.
+ */
+static inline u8 *pcp_alloc_factor(struct per_cpu_pages *pcp,
+				   unsigned int order)
+{
+	if (!order)
+		return &pcp->alloc_factor;
+#if NR_PCP_HIGH_ORDERS
+	if (order > PAGE_ALLOC_COSTLY_ORDER)
+		return &pcp->high_order_factor[pcp_high_order_index(order)];
+#endif
+	return NULL;
+}
+
 /*
  * Higher-order pages are called "compound pages".  They are structured thusly:
  *
@@ -2566,6 +2616,10 @@ static void free_unref_page_commit(struct zone *zone, struct per_cpu_pages *pcp,
 	 * allocations.
 	 */
 	pcp->alloc_factor >>= 1;
+#if NR_PCP_HIGH_ORDERS
+	if (order > PAGE_ALLOC_COSTLY_ORDER)
+		pcp->high_order_factor[pcp_high_order_index(order)] >>= 1;
+#endif
 	__count_vm_events(PGFREE, 1 << order);
 	pindex = order_to_pindex(migratetype, order);
 	list_add(&page->pcp_list, &pcp->lists[pindex]);
@@ -2900,6 +2954,7 @@ static int nr_pcp_alloc(struct per_cpu_pages *pcp, struct zone *zone, int order)
 {
 	int high, base_batch, batch, max_nr_alloc;
 	int high_max, high_min;
+	u8 *alloc_factor = pcp_alloc_factor(pcp, order);
 
 	base_batch = READ_ONCE(pcp->batch);
 	high_min = READ_ONCE(pcp->high_min);
@@ -2910,10 +2965,10 @@ static int nr_pcp_alloc(struct per_cpu_pages *pcp, struct zone *zone, int order)
 	if (unlikely(high < base_batch))
 		return 1;
 
-	if (order)
-		batch = base_batch;
+	if (alloc_factor)
+		batch = (base_batch << *alloc_factor);
 	else
-		batch = (base_batch << pcp->alloc_factor);
+		batch = base_batch;
 
 	/*
 	 * If we had larger pcp->high, we could avoid to allocate from
@@ -2922,15 +2977,16 @@ static int nr_pcp_alloc(struct per_cpu_pages *pcp, struct zone *zone, int order)
 	if (high_min != high_max && !test_bit(ZONE_BELOW_HIGH, &zone->flags))
 		high = pcp->high = min(high + batch, high_max);
 
-	if (!order) {
+	if (alloc_factor) {
 		max_nr_alloc = max(high - pcp->count - base_batch, base_batch);
 		/*
 		 * Double the number of pages allocated each time there is
-		 * subsequent allocation of order-0 pages without any freeing.
+		 * subsequent allocation of order-0 pages, or of pages of the
+		 * same high order, without any freeing.
 		 */
 		if (batch <= max_nr_alloc &&
-		    pcp->alloc_factor < CONFIG_PCP_BATCH_SCALE_MAX)
-			pcp->alloc_factor++;
+		    *alloc_factor < CONFIG_PCP_BATCH_SCALE_MAX)
+			(*alloc_factor)++;
 		batch = min(batch, max_nr_alloc);
 	}
 
@@ -2961,6 +3017,9 @@ struct page *__rmqueue_pcplist(struct zone *zone, unsigned int order,
 			int batch = nr_pcp_alloc(pcp, zone, order);
 			int alloced;
 
+			__count_vm_event(PCP_ZONE_LOCK_ORDER0 +
+					 pcp_order_index(order));
+
 			alloced = rmqueue_bulk(zone, order,
 					batch, list,
 					migratetype, alloc_flags);
@@ -2993,6 +3052,8 @@ static struct page *rmqueue_pcplist(struct zone *preferred_zone,
 	pcp = pcp_spin_trylock(zone->per_cpu_pageset);
 	if (!pcp) {
 		pcp_trylock_finish(UP_flags);
+		/* rmqueue() falls back to zone->lock, a failed refill counted already */
+		count_vm_event(PCP_ZONE_LOCK_ORDER0 + pcp_order_index(order));
 		return NULL;
 	}
 
@@ -3008,6 +3069,7 @@ static struct page *rmqueue_pcplist(struct zone *preferred_zone,
 	pcp_trylock_finish(UP_flags);
 	if (page) {
 		__count_zid_vm_events(PGALLOC, page_zonenum(page), 1 << order);
+		__count_vm_event(PCP_ALLOC_ORDER0 + pcp_order_index(order));
 		zone_statistics(preferred_zone, zone, 1);
 	}
 	return page;
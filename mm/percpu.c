@@ -1725,6 +1725,160 @@ static void pcpu_alloc_tag_free_hook(struct pcpu_chunk *chunk, int off, size_t s
 }
 #endif
 
+/*
+ * Small areas freed by free_percpu() are kept in a per-CPU cache, one array
+ * per size, and handed out again without taking pcpu_alloc_mutex or
+ * pcpu_lock.  Cached areas stay allocated, and therefore populated, in
+ * their chunk.  pcpu_drain_slot_caches() returns them when the allocator
+ * runs out of space.
+ */
+#define PCPU_CACHE_MAX_BITS	16	/* areas up to 64 bytes */
+#define PCPU_CACHE_SLOTS	8
+
+struct pcpu_slot_cache {
+	spinlock_t lock;
+	u8 nr[PCPU_CACHE_MAX_BITS];
+	void __percpu *slots[PCPU_CACHE_MAX_BITS][PCPU_CACHE_SLOTS];
+};
+
+static DEFINE_PER_CPU(struct pcpu_slot_cache, pcpu_slot_cache);
+static bool pcpu_slot_cache_enabled __read_mostly;
+
+static void pcpu_release_area(struct pcpu_chunk *chunk, int off,
+			      void __percpu *ptr);
+
+/**
+ * pcpu_slot_cache_get - allocate an area from this CPU's cache
+ * @bits: size of area in PCPU_MIN_ALLOC_SIZE units
+ * @align: alignment of area in bytes
+ * @chunkp: output, chunk of the area
+ * @offp: output, offset of the area in @chunkp
+ *
+ * RETURNS:
+ * %true if an area was found.
+ */
+static bool pcpu_slot_cache_get(size_t bits, size_t align,
+				struct pcpu_chunk **chunkp, int *offp)
+{
+	void __percpu *ptr = NULL;
+	struct pcpu_slot_cache *pc;
+	void __percpu **slots;
+	unsigned long flags;
+	void *addr;
+	int i, n;
+
+	if (!READ_ONCE(pcpu_slot_cache_enabled) || bits > PCPU_CACHE_MAX_BITS)
+		return false;
+
+	pc = raw_cpu_ptr(&pcpu_slot_cache);
+	slots = pc->slots[bits - 1];
+
+	spin_lock_irqsave(&pc->lock, flags);
+	n = pc->nr[bits - 1];
+	/* chunks are page aligned and @align is at most PAGE_SIZE */
+	for (i = n - 1; i >= 0; i--) {
+		if (IS_ALIGNED((unsigned long)__pcpu_ptr_to_addr(slots[i]),
+			       align)) {
+			ptr = slots[i];
+			slots[i] = slots[n - 1];
+			pc->nr[bits - 1] = n - 1;
+			break;
+		}
+	}
+	spin_unlock_irqrestore(&pc->lock, flags);
+
+	if (!ptr)
+		return false;
+
+	addr = __pcpu_ptr_to_addr(ptr);
+	*chunkp = pcpu_chunk_addr_search(addr);
+	*offp = addr - (*chunkp)->base_addr;
+	return true;
+}
+
+/**
+ * pcpu_slot_cache_put - keep a freed area in this CPU's cache
+ * @chunk: chunk of the area
+ * @ptr: percpu pointer of the area
+ * @size: size of the area in bytes
+ *
+ * RETURNS:
+ * %true if the area was cached, %false if it has to be freed.
+ */
+static bool pcpu_slot_cache_put(struct pcpu_chunk *chunk, void __percpu *ptr,
+				int size)
+{
+	size_t bits = size >> PCPU_MIN_ALLOC_SHIFT;
+	struct pcpu_slot_cache *pc;
+	unsigned long flags;
+	bool cached = false;
+	int n;
+
+	/* leave chunks that are being reclaimed alone */
+	if (!READ_ONCE(pcpu_slot_cache_enabled) || bits > PCPU_CACHE_MAX_BITS ||
+	    chunk == pcpu_reserved_chunk || READ_ONCE(chunk->isolated))
+		return false;
+
+	pc = raw_cpu_ptr(&pcpu_slot_cache);
+
+	spin_lock_irqsave(&pc->lock, flags);
+	n = pc->nr[bits - 1];
+	if (n < PCPU_CACHE_SLOTS) {
+		pc->slots[bits - 1][n] = ptr;
+		pc->nr[bits - 1] = n + 1;
+		cached = true;
+	}
+	spin_unlock_irqrestore(&pc->lock, flags);
+
+	return cached;
+}
+
+/**
+ * pcpu_drain_slot_caches - free the areas cached on all CPUs
+ *
+ * CONTEXT:
+ * Can sleep.  Must not be called with pcpu_lock held.
+ *
+ * RETURNS:
+ * %true if any area was freed.
+ */
+static bool pcpu_drain_slot_caches(void)
+{
+	void __percpu *ptrs[PCPU_CACHE_SLOTS];
+	struct pcpu_slot_cache *pc;
+	struct pcpu_chunk *chunk;
+	unsigned long flags;
+	bool drained = false;
+	int cpu, i, n;
+	void *addr;
+
+	if (!READ_ONCE(pcpu_slot_cache_enabled))
+		return false;
+
+	for_each_possible_cpu(cpu) {
+		pc = per_cpu_ptr(&pcpu_slot_cache, cpu);
+
+		for (i = 0; i < PCPU_CACHE_MAX_BITS; i++) {
+			spin_lock_irqsave(&pc->lock, flags);
+			n = pc->nr[i];
+			memcpy(ptrs, pc->slots[i], n * sizeof(ptrs[0]));
+			pc->nr[i] = 0;
+			spin_unlock_irqrestore(&pc->lock, flags);
+
+			while (n--) {
+				addr = __pcpu_ptr_to_addr(ptrs[n]);
+				chunk = pcpu_chunk_addr_search(addr);
+				pcpu_release_area(chunk, addr - chunk->base_addr,
+						  ptrs[n]);
+				drained = true;
+			}
+		}
+		cond_resched();
+	}
+
+	return drained;
+}
+
 /**
  * pcpu_alloc - the percpu allocator
  * @size: size of area to allocate in bytes
@@ -1784,6 +1938,9 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 	if (unlikely(!pcpu_memcg_pre_alloc_hook(size, gfp, &objcg)))
 		return NULL;
 
+	if (!reserved && pcpu_slot_cache_get(bits, align, &chunk, &off))
+		goto area_cached;
+
 	if (!is_atomic) {
 		/*
 		 * pcpu_balance_workfn() allocates memory under this mutex,
@@ -1846,8 +2003,13 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 		goto fail;
 	}
 
-	/* No space left.  Create a new chunk. */
+	/* No space left.  Try the cached areas, then create a new chunk. */
 	if (list_empty(&pcpu_chunk_lists[pcpu_free_slot])) {
+		if (pcpu_drain_slot_caches()) {
+			spin_lock_irqsave(&pcpu_lock, flags);
+			goto restart;
+		}
+
 		chunk = pcpu_create_chunk(pcpu_gfp);
 		if (!chunk) {
 			err = "failed to allocate new chunk";
@@ -1894,6 +2056,7 @@ void __percpu *pcpu_alloc_noprof(size_t size, size_t align, bool reserved,
 	if (pcpu_nr_empty_pop_pages < PCPU_EMPTY_POP_PAGES_LOW)
 		pcpu_schedule_balance_work();
 
+area_cached:
 	/* clear the areas and return address relative to base address */
 	for_each_possible_cpu(cpu)
 		memset((void *)pcpu_chunk_addr(chunk, cpu, 0) + off, 0, size);
@@ -2205,6 +2368,11 @@ static void pcpu_balance_workfn(struct work_struct *work)
 	 * appropriate.
 	 */
 	mutex_lock(&pcpu_alloc_mutex);
+
+	/* atomic allocations can't drain the caches themselves */
+	if (READ_ONCE(pcpu_atomic_alloc_failed))
+		pcpu_drain_slot_caches();
+
 	spin_lock_irq(&pcpu_lock);
 
 	pcpu_balance_free(false);
@@ -2247,38 +2415,18 @@ size_t pcpu_alloc_size(void __percpu *ptr)
 	return (end - bit_off) * PCPU_MIN_ALLOC_SIZE;
 }
 
-/**
- * free_percpu - free percpu area
- * @ptr: pointer to area to free
- *
- * Free percpu area @ptr.
- *
- * CONTEXT:
- * Can be called from atomic context.
+/*
+ * Give the area at @off in @chunk back to the chunk, after the hooks of
+ * free_percpu() have run.
  */
-void free_percpu(void __percpu *ptr)
+static void pcpu_release_area(struct pcpu_chunk *chunk, int off,
+			      void __percpu *ptr)
 {
-	void *addr;
-	struct pcpu_chunk *chunk;
 	unsigned long flags;
-	int size, off;
 	bool need_balance = false;
 
-	if (!ptr)
-		return;
-
-	kmemleak_free_percpu(ptr);
-
-	addr = __pcpu_ptr_to_addr(ptr);
-	chunk = pcpu_chunk_addr_search(addr);
-	off = addr - chunk->base_addr;
-
 	spin_lock_irqsave(&pcpu_lock, flags);
-	size = pcpu_free_area(chunk, off);
-
-	pcpu_alloc_tag_free_hook(chunk, off, size);
-
-	pcpu_memcg_free_hook(chunk, off, size);
+	pcpu_free_area(chunk, off);
 
 	/*
 	 * If there are more than one fully free chunks, wake up grim reaper.
@@ -2305,6 +2453,41 @@ void free_percpu(void __percpu *ptr)
 	if (need_balance)
 		pcpu_schedule_balance_work();
 }
+
+/**
+ * free_percpu - free percpu area
+ * @ptr: pointer to area to free
+ *
+ * Free percpu area @ptr.
+ *
+ * CONTEXT:
+ * Can be called from atomic context.
+ */
+void free_percpu(void __percpu *ptr)
+{
+	void *addr;
+	struct pcpu_chunk *chunk;
+	int size, off;
+
+	if (!ptr)
+		return;
+
+	kmemleak_free_percpu(ptr);
+
+	addr = __pcpu_ptr_to_addr(ptr);
+	chunk = pcpu_chunk_addr_search(addr);
+	off = addr - chunk->base_addr;
+	size = pcpu_alloc_size(ptr);
+
+	pcpu_alloc_tag_free_hook(chunk, off, size);
+
+	pcpu_memcg_free_hook(chunk, off, size);
+
+	if (pcpu_slot_cache_put(chunk, ptr, size))
+		return;
+
+	pcpu_release_area(chunk, off, ptr);
+}
 EXPORT_SYMBOL_GPL(free_percpu);
 
 bool __is_kernel_percpu_address(unsigned long addr, unsigned long *can_addr)
@@ -3431,6 +3614,12 @@ unsigned long pcpu_nr_pages(void)
  */
 static int __init percpu_enable_async(void)
 {
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		spin_lock_init(&per_cpu_ptr(&pcpu_slot_cache, cpu)->lock);
+	WRITE_ONCE(pcpu_slot_cache_enabled, true);
+
 	pcpu_async_enabled = true;
 	return 0;
 }
@@ -13,9 +13,176 @@
 #include <linux/swap.h>
 #include <linux/swapops.h>
 #include <linux/mm_inline.h>
+#include <linux/cpuhotplug.h>
+#include <linux/local_lock.h>
+#include <linux/memcontrol.h>
+#include <linux/sysctl.h>
+#include <linux/workqueue.h>
 #include <asm/pgalloc.h>
 #include <asm/tlb.h>
 
+/*
+ * A small per-CPU pool of zeroed pages for user PTE tables. It is refilled in
+ * bulk from a workqueue, so that faults and fork populating new page tables
+ * neither go to the page allocator nor zero the page on the spot.
+ */
+#define PGTABLE_CACHE_MAX	64
+#define PGTABLE_CACHE_DEFAULT	16
+
+struct pgtable_cache {
+	local_lock_t lock;
+	unsigned int count;
+	struct page *pages[PGTABLE_CACHE_MAX];
+	struct work_struct refill;
+};
+
+static DEFINE_PER_CPU(struct pgtable_cache, pgtable_cache) = {
+	.lock = INIT_LOCAL_LOCK(lock),
+};
+
+/* Zero until pgtable_cache_init() has set up the refill work */
+static unsigned int pgtable_cache_size __read_mostly;
+
+struct ptdesc *pagetable_cache_alloc(gfp_t gfp)
+{
+	unsigned int size = READ_ONCE(pgtable_cache_size);
+	struct pgtable_cache *pc;
+	struct page *page = NULL;
+
+	/* The pool holds zeroed ZONE_NORMAL pages */
+	if (!size || !(gfp & __GFP_ZERO) || (gfp & (__GFP_DMA | __GFP_DMA32)))
+		return NULL;
+
+	local_lock(&pgtable_cache.lock);
+	pc = this_cpu_ptr(&pgtable_cache);
+	if (pc->count)
+		page = pc->pages[--pc->count];
+	if (pc->count < size / 2)
+		queue_work_on(smp_processor_id(), system_wq, &pc->refill);
+	local_unlock(&pgtable_cache.lock);
+
+	if (!page) {
+		count_vm_event(PGTABLE_CACHE_MISS);
+		return NULL;
+	}
+
+	/*
+	 * Leave the failure to the page allocator fallback. The page is still
+	 * zeroed, so put it back rather than refilling it later.
+	 */
+	if ((gfp & __GFP_ACCOUNT) && memcg_kmem_charge_page(page, gfp, 0)) {
+		local_lock(&pgtable_cache.lock);
+		pc = this_cpu_ptr(&pgtable_cache);
+		if (pc->count < size) {
+			pc->pages[pc->count++] = page;
+			page = NULL;
+		}
+		local_unlock(&pgtable_cache.lock);
+
+		if (page)
+			__free_page(page);
+		return NULL;
+	}
+
+	count_vm_event(PGTABLE_CACHE_HIT);
+	return page_ptdesc(page);
+}
+
+static void pgtable_cache_refill(struct work_struct *work)
+{
+	struct pgtable_cache *pc = container_of(work, struct pgtable_cache, refill);
+	unsigned int size = READ_ONCE(pgtable_cache_size);
+	struct page *pages[PGTABLE_CACHE_MAX] = { };
+	unsigned int nr, i = 0;
+
+	nr = size - min(size, READ_ONCE(pc->count));
+	if (!nr)
+		return;
+
+	nr = alloc_pages_bulk_array(GFP_KERNEL | __GFP_ZERO | __GFP_NORETRY |
+				    __GFP_NOWARN, nr, pages);
+
+	local_lock(&pgtable_cache.lock);
+	/* Hotplug may have moved us off the pool's CPU */
+	if (pc == this_cpu_ptr(&pgtable_cache)) {
+		while (i < nr && pc->count < size)
+			pc->pages[pc->count++] = pages[i++];
+	}
+	local_unlock(&pgtable_cache.lock);
+
+	while (i < nr)
+		__free_page(pages[i++]);
+}
+
+static void pgtable_cache_trim(struct work_struct *unused)
+{
+	unsigned int size = READ_ONCE(pgtable_cache_size);
+	struct page *pages[PGTABLE_CACHE_MAX];
+	struct pgtable_cache *pc;
+	unsigned int nr = 0;
+
+	local_lock(&pgtable_cache.lock);
+	pc = this_cpu_ptr(&pgtable_cache);
+	while (pc->count > size)
+		pages[nr++] = pc->pages[--pc->count];
+	local_unlock(&pgtable_cache.lock);
+
+	while (nr)
+		__free_page(pages[--nr]);
+}
+
+static int pgtable_cache_cpu_dead(unsigned int cpu)
+{
+	struct pgtable_cache *pc = per_cpu_ptr(&pgtable_cache, cpu);
+
+	while (pc->count)
+		__free_page(pc->pages[--pc->count]);
+	return 0;
+}
+
+static int pgtable_cache_size_handler(const struct ctl_table *table, int write,
+		void *buffer, size_t *length, loff_t *ppos)
+{
+	unsigned int old = READ_ONCE(pgtable_cache_size);
+	int ret;
+
+	ret = proc_douintvec_minmax(table, write, buffer, length, ppos);
+	/* A larger size is picked up by the next refill */
+	if (!ret && write && READ_ONCE(pgtable_cache_size) < old)
+		schedule_on_each_cpu(pgtable_cache_trim);
+	return ret;
+}
+
+static const unsigned int pgtable_cache_max = PGTABLE_CACHE_MAX;
+
+static struct ctl_table pgtable_cache_sysctls[] = {
+	{
+		.procname	= "pgtable_cache_size",
+		.data		= &pgtable_cache_size,
+		.maxlen		= sizeof(pgtable_cache_size),
+		.mode		= 0644,
+		.proc_handler	= pgtable_cache_size_handler,
+		.extra1		= SYSCTL_ZERO,
+		.extra2		= (void *)&pgtable_cache_max,
+	},
+};
+
+static int __init pgtable_cache_init(void)
+{
+	int cpu;
+
+	for_each_possible_cpu(cpu)
+		INIT_WORK(&per_cpu_ptr(&pgtable_cache, cpu)->refill,
+			  pgtable_cache_refill);
+
+	cpuhp_setup_state_nocalls(CPUHP_BP_PREPARE_DYN, "mm/pgtable_cache:dead",
+				  NULL, pgtable_cache_cpu_dead);
+	register_sysctl_init("vm", pgtable_cache_sysctls);
+	WRITE_ONCE(pgtable_cache_size, PGTABLE_CACHE_DEFAULT);
+	return 0;
+}
+core_initcall(pgtable_cache_init);
+
 /*
  * If a p?d_bad entry is found while walking page tables, report
  * the error, before resetting entry to p?d_none.  Usually (but
@@ -416,8 +416,12 @@ static inline int ra_alloc_folio(struct readahead_control *ractl, pgoff_t index,
 	int err;
 	struct folio *folio = filemap_alloc_folio(gfp, order);
 
-	if (!folio)
+	if (!folio) {
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+		count_mthp_stat(order, MTHP_STAT_FILE_FALLBACK);
+#endif
 		return -ENOMEM;
+	}
 	mark = round_down(mark, 1UL << order);
 	if (index == mark)
 		folio_set_readahead(folio);
@@ -427,6 +431,9 @@ static inline int ra_alloc_folio(struct readahead_control *ractl, pgoff_t index,
 		return err;
 	}
 
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	count_mthp_stat(order, MTHP_STAT_FILE_ALLOC);
+#endif
 	ractl->_nr_pages += 1UL << order;
 	ractl->_workingset |= folio_test_workingset(folio);
 	return 0;
@@ -440,12 +447,14 @@ void page_cache_ra_order(struct readahead_control *ractl,
 	pgoff_t index = start;
 	pgoff_t limit = (i_size_read(mapping->host) - 1) >> PAGE_SHIFT;
 	pgoff_t mark = index + ra->size - ra->async_size;
-	unsigned int nofs;
+	unsigned int nofs, done_order = 0;
 	int err = 0;
 	gfp_t gfp = readahead_gfp_mask(mapping);
 
-	if (!mapping_large_folio_support(mapping) || ra->size < 4)
+	if (!mapping_large_folio_support(mapping) || ra->size < 4) {
+		ra->order = 0;
 		goto fallback;
+	}
 
 	limit = min(limit, index + ra->size - 1);
 
@@ -467,11 +476,23 @@ void page_cache_ra_order(struct readahead_control *ractl,
 		/* Don't allocate pages past EOF */
 		while (index + (1UL << order) - 1 > limit)
 			order--;
+		/* Skip sizes disabled in hugepages-<size>kB/file_enabled */
+		while (order > 1 && !thp_file_order_allowed(order))
+			order--;
 		err = ra_alloc_folio(ractl, index, mark, order, gfp);
 		if (err)
 			break;
+		done_order = max(done_order, order);
 		index += 1UL << order;
 	}
+	/*
+	 * Remember the largest order this window actually got, so that a new
+	 * stream does not have to ramp up from order-0 again. Step down after
+	 * an allocation failure so that the next window backs off too.
+	 */
+	if (err == -ENOMEM)
+		done_order = min(done_order, new_order > 2 ? new_order - 2 : 0);
+	ra->order = done_order;
 
 	read_pages(ractl);
 	filemap_invalidate_unlock_shared(mapping);
@@ -556,9 +577,24 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	contig_count = index - miss - 1;
 	/*
 	 * Standalone, small random read. Read as is, and do not pollute the
-	 * readahead state.
+	 * readahead state, unless it lies as far beyond the previous read as
+	 * that one did beyond its predecessor. Such a strided stream gets large
+	 * folios like a sequential one.
 	 */
 	if (contig_count <= req_count) {
+		unsigned long stride = index - prev_index;
+
+		if (stride > USHRT_MAX)
+			stride = 0;
+		if (stride && stride == ra->stride) {
+			/* page_cache_ra_order() wants at least 4 pages */
+			ra->start = index;
+			ra->size = max_t(unsigned long, req_count, 4);
+			ra->async_size = 0;
+			page_cache_ra_order(ractl, ra, ra->order);
+			return;
+		}
+		ra->stride = stride;
 		do_page_cache_ra(ractl, req_count, 0);
 		return;
 	}
@@ -573,7 +609,7 @@ void page_cache_sync_ra(struct readahead_control *ractl,
 	ra->async_size = 1;
 readit:
 	ractl->_index = ra->start;
-	page_cache_ra_order(ractl, ra, 0);
+	page_cache_ra_order(ractl, ra, ra->order);
 }
 EXPORT_SYMBOL_GPL(page_cache_sync_ra);
 
@@ -635,7 +671,7 @@ void page_cache_async_ra(struct readahead_control *ractl,
 	ra->async_size = ra->size;
 readit:
 	ractl->_index = ra->start;
-	page_cache_ra_order(ractl, ra, order);
+	page_cache_ra_order(ractl, ra, max_t(unsigned int, order, ra->order));
 }
 EXPORT_SYMBOL_GPL(page_cache_async_ra);
 
@@ -640,25 +640,26 @@ struct anon_vma *folio_lock_anon_vma_read(struct folio *folio,
  * before any IO is initiated on the page to prevent lost writes. Similarly,
  * it must be flushed before freeing to prevent data leakage.
  */
-void try_to_unmap_flush(void)
+void try_to_unmap_flush(enum tlb_batch_reason reason)
 {
 	struct tlbflush_unmap_batch *tlb_ubc = &current->tlb_ubc;
 
 	if (!tlb_ubc->flush_required)
 		return;
 
+	count_vm_event(TLB_BATCH_FLUSH_RECLAIM + reason);
 	arch_tlbbatch_flush(&tlb_ubc->arch);
 	tlb_ubc->flush_required = false;
 	tlb_ubc->writable = false;
 }
 
 /* Flush iff there are potentially writable TLB entries that can race with IO */
-void try_to_unmap_flush_dirty(void)
+void try_to_unmap_flush_dirty(enum tlb_batch_reason reason)
 {
 	struct tlbflush_unmap_batch *tlb_ubc = &current->tlb_ubc;
 
 	if (tlb_ubc->writable)
-		try_to_unmap_flush();
+		try_to_unmap_flush(reason);
 }
 
 /*
@@ -683,6 +684,7 @@ static void set_tlb_ubc_flush_pending(struct mm_struct *mm, pte_t pteval,
 
 	arch_tlbbatch_add_pending(&tlb_ubc->arch, mm, uaddr);
 	tlb_ubc->flush_required = true;
+	count_vm_event(TLB_BATCH_DEFERRED);
 
 	/*
 	 * Ensure compiler does not re-order the setting of tlb_flush_batched
@@ -746,6 +748,7 @@ void flush_tlb_batched_pending(struct mm_struct *mm)
 	int flushed = batch >> TLB_FLUSH_BATCH_FLUSHED_SHIFT;
 
 	if (pending != flushed) {
+		count_vm_event(TLB_BATCH_FLUSH_PENDING);
 		arch_flush_tlb_batched_pending(mm);
 		/*
 		 * If the new TLB flushing is pending during flushing, leave
@@ -1734,6 +1734,7 @@ static struct folio *shmem_alloc_and_add_folio(struct vm_fault *vmf,
 	struct vm_area_struct *vma = vmf ? vmf->vma : NULL;
 	unsigned long suitable_orders = 0;
 	struct folio *folio = NULL;
+	gfp_t huge_gfp;
 	long pages;
 	int error, order;
 
@@ -1741,7 +1742,7 @@ static struct folio *shmem_alloc_and_add_folio(struct vm_fault *vmf,
 		orders = 0;
 
 	if (orders > 0) {
-		if (vma && vma_is_anon_shmem(vma)) {
+		if (vma) {
 			suitable_orders = shmem_suitable_orders(inode, vmf,
 							mapping, index, orders);
 		} else if (orders & BIT(HPAGE_PMD_ORDER)) {
@@ -1766,9 +1767,12 @@ static struct folio *shmem_alloc_and_add_folio(struct vm_fault *vmf,
 		while (suitable_orders) {
 			pages = 1UL << order;
 			index = round_down(index, pages);
-			folio = shmem_alloc_folio(gfp, order, info, index);
-			if (folio)
+			huge_gfp = limit_gfp_mask(vma_thp_gfp_mask(vma, order), gfp);
+			folio = shmem_alloc_folio(huge_gfp, order, info, index);
+			if (folio) {
+				gfp = huge_gfp;
 				goto allocated;
+			}
 
 			if (pages == HPAGE_PMD_NR)
 				count_vm_event(THP_FILE_FALLBACK);
@@ -2160,18 +2164,17 @@ static int shmem_get_folio_gfp(struct inode *inode, pgoff_t index,
 
 	huge = shmem_is_huge(inode, index, false, fault_mm,
 			     vma ? vma->vm_flags : 0);
-	/* Find hugepage orders that are allowed for anonymous shmem. */
-	if (vma && vma_is_anon_shmem(vma))
+	/*
+	 * Find hugepage orders that are allowed for anonymous shmem, and for
+	 * tmpfs files mounted with a huge= option that allows THP here.
+	 */
+	if (vma && (vma_is_anon_shmem(vma) || huge))
 		orders = shmem_allowable_huge_orders(inode, vma, index, huge);
 	else if (huge)
 		orders = BIT(HPAGE_PMD_ORDER);
 
 	if (orders > 0) {
-		gfp_t huge_gfp;
-
-		huge_gfp = vma_thp_gfp_mask(vma);
-		huge_gfp = limit_gfp_mask(huge_gfp, gfp);
-		folio = shmem_alloc_and_add_folio(vmf, huge_gfp,
+		folio = shmem_alloc_and_add_folio(vmf, gfp,
 				inode, index, fault_mm, orders);
 		if (!IS_ERR(folio)) {
 			if (folio_test_pmd_mappable(folio))
@@ -3107,7 +3110,7 @@ static size_t splice_zeropage_into_pipe(struct pipe_inode_info *pipe,
 
 	size = min_t(size_t, size, PAGE_SIZE - offset);
 
-	if (!pipe_full(pipe->head, pipe->tail, pipe->max_usage)) {
+	if (!pipe_is_full(pipe)) {
 		struct pipe_buffer *buf = pipe_head_buf(pipe);
 
 		*buf = (struct pipe_buffer) {
@@ -3199,7 +3202,7 @@ static ssize_t shmem_file_splice_read(struct file *in, loff_t *ppos,
 		total_spliced += n;
 		*ppos += n;
 		in->f_ra.prev_pos = *ppos;
-		if (pipe_full(pipe->head, pipe->tail, pipe->max_usage))
+		if (pipe_is_full(pipe))
 			break;
 
 		cond_resched();
@@ -253,6 +253,9 @@ struct kmem_cache_order_objects {
 struct kmem_cache {
 #ifndef CONFIG_SLUB_TINY
 	struct kmem_cache_cpu __percpu *cpu_slab;
+	/* Per cpu object arrays, see kmem_cache_setup_sheaves() */
+	struct slub_percpu_sheaves __percpu *cpu_sheaves;
+	unsigned int sheaf_capacity;
 #endif
 	/* Used for retrieving partial slabs, etc. */
 	slab_flags_t flags;
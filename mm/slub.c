@@ -373,6 +373,14 @@ enum stat_item {
 	CPU_PARTIAL_FREE,	/* Refill cpu partial on free */
 	CPU_PARTIAL_NODE,	/* Refill cpu partial from node partial */
 	CPU_PARTIAL_DRAIN,	/* Drain cpu partial to node partial */
+	ALLOC_PCS,		/* Allocation from percpu sheaf */
+	FREE_PCS,		/* Free to percpu sheaf */
+	BARN_GET,		/* Full sheaf taken from the barn */
+	BARN_GET_FAIL,		/* No full sheaf in the barn */
+	BARN_PUT,		/* Full sheaf put to the barn */
+	BARN_PUT_FAIL,		/* Barn could not take a full sheaf */
+	SHEAF_REFILL,		/* Objects refilled to a sheaf from slabs */
+	SHEAF_FLUSH,		/* Objects flushed from a sheaf to slabs */
 	NR_SLUB_STAT_ITEMS
 };
 
@@ -398,8 +406,41 @@ struct kmem_cache_cpu {
 	unsigned int stat[NR_SLUB_STAT_ITEMS];
 #endif
 };
+
+/*
+ * Per cpu arrays of free objects ("sheaves") for caches that enabled them
+ * with kmem_cache_setup_sheaves(). Allocating and freeing only moves a
+ * pointer in or out of the main sheaf. When that runs empty or full it is
+ * swapped with the spare or exchanged with the node's barn, and only
+ * refilling and flushing whole sheaves touches the slabs.
+ */
+struct slab_sheaf {
+	struct list_head barn_list;
+	unsigned int size;
+	void *objects[];
+};
+
+struct slub_percpu_sheaves {
+	local_lock_t lock;
+	struct slab_sheaf *main;	/* Sheaf used for alloc and free */
+	struct slab_sheaf *spare;	/* Empty or full, never partial */
+};
+
+/* Per node depot of full and empty sheaves */
+struct node_barn {
+	spinlock_t lock;
+	struct list_head sheaves_full;
+	struct list_head sheaves_empty;
+	unsigned int nr_full;
+	unsigned int nr_empty;
+};
+
+#define MAX_SHEAF_CAPACITY	128
+#define MAX_BARN_SHEAVES	8
 #endif /* CONFIG_SLUB_TINY */
 
+static DEFINE_STATIC_KEY_FALSE(slub_sheaves_used);
+
 static inline void stat(const struct kmem_cache *s, enum stat_item si)
 {
 #ifdef CONFIG_SLUB_STATS
@@ -431,6 +472,9 @@ struct kmem_cache_node {
 	atomic_long_t total_objects;
 	struct list_head full;
 #endif
+#ifndef CONFIG_SLUB_TINY
+	struct node_barn barn;
+#endif
 };
 
 static inline struct kmem_cache_node *get_node(struct kmem_cache *s, int node)
@@ -3140,6 +3184,408 @@ static inline void put_partials_cpu(struct kmem_cache *s,
 
 #endif	/* CONFIG_SLUB_CPU_PARTIAL */
 
+static int __kmem_cache_alloc_bulk(struct kmem_cache *s, gfp_t flags,
+				   size_t size, void **p);
+static void __kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p);
+
+static inline bool cache_has_sheaves(struct kmem_cache *s)
+{
+	/* Pairs with smp_store_release() in kmem_cache_setup_sheaves() */
+	return smp_load_acquire(&s->cpu_sheaves);
+}
+
+static inline struct node_barn *get_barn(struct kmem_cache *s)
+{
+	struct kmem_cache_node *n = get_node(s, numa_mem_id());
+
+	return n ? &n->barn : NULL;
+}
+
+static struct slab_sheaf *alloc_empty_sheaf(struct kmem_cache *s, gfp_t gfp)
+{
+	struct slab_sheaf *sheaf;
+
+	gfp &= __GFP_RECLAIM | __GFP_IO | __GFP_FS;
+	sheaf = kmalloc(struct_size(sheaf, objects, s->sheaf_capacity),
+			gfp | __GFP_NOWARN);
+	if (sheaf)
+		sheaf->size = 0;
+
+	return sheaf;
+}
+
+/*
+ * Fill the sheaf up from the slabs in one go. Objects from pfmemalloc slabs
+ * must not end up in a sheaf, where any allocation could pick them up.
+ */
+static int refill_sheaf(struct kmem_cache *s, struct slab_sheaf *sheaf,
+			gfp_t gfp)
+{
+	unsigned int to_fill = s->sheaf_capacity - sheaf->size;
+
+	gfp = (gfp & ~__GFP_MEMALLOC) | __GFP_NOMEMALLOC | __GFP_NOWARN;
+	if (!__kmem_cache_alloc_bulk(s, gfp, to_fill,
+				     &sheaf->objects[sheaf->size]))
+		return -ENOMEM;
+
+	sheaf->size = s->sheaf_capacity;
+	stat_add(s, SHEAF_REFILL, to_fill);
+	return 0;
+}
+
+/* The objects went through the free hooks when they were put in the sheaf */
+static void sheaf_flush(struct kmem_cache *s, struct slab_sheaf *sheaf)
+{
+	if (!sheaf->size)
+		return;
+
+	stat_add(s, SHEAF_FLUSH, sheaf->size);
+	__kmem_cache_free_bulk(s, sheaf->size, &sheaf->objects[0]);
+	sheaf->size = 0;
+}
+
+/* Exchange an empty sheaf for a full one, NULL if the barn has none */
+static struct slab_sheaf *barn_replace_empty_sheaf(struct node_barn *barn,
+						   struct slab_sheaf *empty)
+{
+	struct slab_sheaf *full = NULL;
+	unsigned long flags;
+
+	if (!barn || !data_race(barn->nr_full))
+		return NULL;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (likely(barn->nr_full)) {
+		full = list_first_entry(&barn->sheaves_full, struct slab_sheaf,
+					barn_list);
+		list_del(&full->barn_list);
+		barn->nr_full--;
+		list_add(&empty->barn_list, &barn->sheaves_empty);
+		barn->nr_empty++;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return full;
+}
+
+/* Exchange a full sheaf for an empty one, NULL if the barn can't take it */
+static struct slab_sheaf *barn_replace_full_sheaf(struct node_barn *barn,
+						  struct slab_sheaf *full)
+{
+	struct slab_sheaf *empty = NULL;
+	unsigned long flags;
+
+	if (!barn || data_race(barn->nr_full) >= MAX_BARN_SHEAVES ||
+	    !data_race(barn->nr_empty))
+		return NULL;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (likely(barn->nr_full < MAX_BARN_SHEAVES && barn->nr_empty)) {
+		empty = list_first_entry(&barn->sheaves_empty,
+					 struct slab_sheaf, barn_list);
+		list_del(&empty->barn_list);
+		barn->nr_empty--;
+		list_add(&full->barn_list, &barn->sheaves_full);
+		barn->nr_full++;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return empty;
+}
+
+static struct slab_sheaf *barn_get_empty_sheaf(struct node_barn *barn)
+{
+	struct slab_sheaf *empty = NULL;
+	unsigned long flags;
+
+	if (!barn || !data_race(barn->nr_empty))
+		return NULL;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (likely(barn->nr_empty)) {
+		empty = list_first_entry(&barn->sheaves_empty,
+					 struct slab_sheaf, barn_list);
+		list_del(&empty->barn_list);
+		barn->nr_empty--;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return empty;
+}
+
+static void barn_put_empty_sheaf(struct node_barn *barn,
+				 struct slab_sheaf *sheaf)
+{
+	unsigned long flags;
+
+	if (barn) {
+		spin_lock_irqsave(&barn->lock, flags);
+		if (barn->nr_empty < MAX_BARN_SHEAVES) {
+			list_add(&sheaf->barn_list, &barn->sheaves_empty);
+			barn->nr_empty++;
+			sheaf = NULL;
+		}
+		spin_unlock_irqrestore(&barn->lock, flags);
+	}
+
+	kfree(sheaf);
+}
+
+static bool barn_put_full_sheaf(struct node_barn *barn,
+				struct slab_sheaf *sheaf)
+{
+	unsigned long flags;
+	bool ret = false;
+
+	if (!barn)
+		return false;
+
+	spin_lock_irqsave(&barn->lock, flags);
+	if (barn->nr_full < MAX_BARN_SHEAVES) {
+		list_add(&sheaf->barn_list, &barn->sheaves_full);
+		barn->nr_full++;
+		ret = true;
+	}
+	spin_unlock_irqrestore(&barn->lock, flags);
+
+	return ret;
+}
+
+/* Flush the full sheaves of all barns and free their empty sheaves */
+static void barn_shrink(struct kmem_cache *s)
+{
+	struct slab_sheaf *sheaf, *tmp;
+	struct kmem_cache_node *n;
+	unsigned long flags;
+	int node;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	for_each_kmem_cache_node(s, node, n) {
+		LIST_HEAD(full);
+		LIST_HEAD(empty);
+
+		spin_lock_irqsave(&n->barn.lock, flags);
+		list_splice_init(&n->barn.sheaves_full, &full);
+		list_splice_init(&n->barn.sheaves_empty, &empty);
+		n->barn.nr_full = 0;
+		n->barn.nr_empty = 0;
+		spin_unlock_irqrestore(&n->barn.lock, flags);
+
+		list_for_each_entry_safe(sheaf, tmp, &full, barn_list) {
+			sheaf_flush(s, sheaf);
+			kfree(sheaf);
+		}
+		list_for_each_entry_safe(sheaf, tmp, &empty, barn_list)
+			kfree(sheaf);
+	}
+}
+
+/*
+ * Neither the cpu sheaves nor the barn have objects left. Refill a sheaf
+ * from the slabs and make it the main sheaf, unless the sheaves were
+ * refilled while we did not hold the lock.
+ */
+static noinline void *alloc_from_new_sheaf(struct kmem_cache *s, gfp_t gfp)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *sheaf;
+	unsigned long flags;
+	void *object;
+
+	sheaf = barn_get_empty_sheaf(get_barn(s));
+	if (!sheaf)
+		sheaf = alloc_empty_sheaf(s, gfp);
+	if (!sheaf)
+		return NULL;
+
+	if (refill_sheaf(s, sheaf, gfp)) {
+		barn_put_empty_sheaf(get_barn(s), sheaf);
+		return NULL;
+	}
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	if (!pcs->main->size)
+		swap(pcs->main, sheaf);
+	else if (!pcs->spare->size)
+		swap(pcs->spare, sheaf);
+
+	object = pcs->main->objects[--pcs->main->size];
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, ALLOC_PCS);
+
+	/* We are left with an empty sheaf, or a full one nobody had room for */
+	if (!sheaf->size) {
+		barn_put_empty_sheaf(get_barn(s), sheaf);
+	} else if (!barn_put_full_sheaf(get_barn(s), sheaf)) {
+		sheaf_flush(s, sheaf);
+		barn_put_empty_sheaf(get_barn(s), sheaf);
+	}
+
+	return object;
+}
+
+static __fastpath_inline void *alloc_from_pcs(struct kmem_cache *s, gfp_t gfp)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *full;
+	unsigned long flags;
+	void *object;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	if (unlikely(!pcs->main->size)) {
+		if (pcs->spare->size) {
+			swap(pcs->main, pcs->spare);
+		} else {
+			full = barn_replace_empty_sheaf(get_barn(s), pcs->main);
+			if (!full) {
+				local_unlock_irqrestore(&s->cpu_sheaves->lock,
+							flags);
+				stat(s, BARN_GET_FAIL);
+				return alloc_from_new_sheaf(s, gfp);
+			}
+			pcs->main = full;
+			stat(s, BARN_GET);
+		}
+	}
+
+	object = pcs->main->objects[--pcs->main->size];
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, ALLOC_PCS);
+	return object;
+}
+
+static unsigned int alloc_from_pcs_bulk(struct kmem_cache *s, size_t size,
+					void **p)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *main, *full;
+	unsigned long flags;
+	unsigned int batch;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	if (!pcs->main->size) {
+		if (pcs->spare->size) {
+			swap(pcs->main, pcs->spare);
+		} else {
+			full = barn_replace_empty_sheaf(get_barn(s), pcs->main);
+			if (full) {
+				pcs->main = full;
+				stat(s, BARN_GET);
+			}
+		}
+	}
+
+	main = pcs->main;
+	batch = min_t(size_t, size, main->size);
+	main->size -= batch;
+	memcpy(p, &main->objects[main->size], batch * sizeof(void *));
+
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat_add(s, ALLOC_PCS, batch);
+	return batch;
+}
+
+/*
+ * The object passed the free hooks and belongs to the local node. If the main
+ * sheaf is full and the barn can't take it either, flush it to the slabs.
+ */
+static __fastpath_inline void free_to_pcs(struct kmem_cache *s, void *object)
+{
+	struct slub_percpu_sheaves *pcs;
+	struct slab_sheaf *empty;
+	unsigned long flags;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+
+	if (unlikely(pcs->main->size == s->sheaf_capacity)) {
+		if (!pcs->spare->size) {
+			swap(pcs->main, pcs->spare);
+		} else {
+			empty = barn_replace_full_sheaf(get_barn(s), pcs->main);
+			if (empty) {
+				pcs->main = empty;
+				stat(s, BARN_PUT);
+			} else {
+				sheaf_flush(s, pcs->main);
+				stat(s, BARN_PUT_FAIL);
+			}
+		}
+	}
+
+	pcs->main->objects[pcs->main->size++] = object;
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+
+	stat(s, FREE_PCS);
+}
+
+/* Called from CPU work handler with migration disabled. */
+static void pcs_flush_all(struct kmem_cache *s)
+{
+	struct slub_percpu_sheaves *pcs;
+	unsigned long flags;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	local_lock_irqsave(&s->cpu_sheaves->lock, flags);
+	pcs = this_cpu_ptr(s->cpu_sheaves);
+	sheaf_flush(s, pcs->main);
+	sheaf_flush(s, pcs->spare);
+	local_unlock_irqrestore(&s->cpu_sheaves->lock, flags);
+}
+
+static void __pcs_flush_all_cpu(struct kmem_cache *s, int cpu)
+{
+	struct slub_percpu_sheaves *pcs;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+	sheaf_flush(s, pcs->main);
+	sheaf_flush(s, pcs->spare);
+}
+
+static bool pcs_has_objects(int cpu, struct kmem_cache *s)
+{
+	struct slub_percpu_sheaves *pcs;
+
+	if (!s->cpu_sheaves)
+		return false;
+
+	pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+	return data_race(pcs->main->size) || data_race(pcs->spare->size);
+}
+
+static void free_percpu_sheaves(struct kmem_cache *s)
+{
+	int cpu;
+
+	if (!s->cpu_sheaves)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		struct slub_percpu_sheaves *pcs = per_cpu_ptr(s->cpu_sheaves, cpu);
+
+		kfree(pcs->main);
+		kfree(pcs->spare);
+	}
+	free_percpu(s->cpu_sheaves);
+	s->cpu_sheaves = NULL;
+}
+
 static inline void flush_slab(struct kmem_cache *s, struct kmem_cache_cpu *c)
 {
 	unsigned long flags;
@@ -3179,6 +3625,7 @@ static inline void __flush_cpu_slab(struct kmem_cache *s, int cpu)
 	}
 
 	put_partials_cpu(s, c);
+	__pcs_flush_all_cpu(s, cpu);
 }
 
 struct slub_flush_work {
@@ -3207,13 +3654,14 @@ static void flush_cpu_slab(struct work_struct *w)
 		flush_slab(s, c);
 
 	put_partials(s);
+	pcs_flush_all(s);
 }
 
 static bool has_cpu_slab(int cpu, struct kmem_cache *s)
 {
 	struct kmem_cache_cpu *c = per_cpu_ptr(s->cpu_slab, cpu);
 
-	return c->slab || slub_percpu_partial(c);
+	return c->slab || slub_percpu_partial(c) || pcs_has_objects(cpu, s);
 }
 
 static DEFINE_MUTEX(flush_lock);
@@ -3276,6 +3724,19 @@ static inline void flush_all_cpus_locked(struct kmem_cache *s) { }
 static inline void flush_all(struct kmem_cache *s) { }
 static inline void __flush_cpu_slab(struct kmem_cache *s, int cpu) { }
 static inline int slub_cpu_dead(unsigned int cpu) { return 0; }
+static inline bool cache_has_sheaves(struct kmem_cache *s) { return false; }
+static inline void *alloc_from_pcs(struct kmem_cache *s, gfp_t gfp)
+{
+	return NULL;
+}
+static inline unsigned int alloc_from_pcs_bulk(struct kmem_cache *s,
+					       size_t size, void **p)
+{
+	return 0;
+}
+static inline void free_to_pcs(struct kmem_cache *s, void *object) { }
+static inline void barn_shrink(struct kmem_cache *s) { }
+static inline void free_percpu_sheaves(struct kmem_cache *s) { }
 #endif /* CONFIG_SLUB_TINY */
 
 /*
@@ -4026,7 +4487,11 @@ static __fastpath_inline void *slab_alloc_node(struct kmem_cache *s, struct list
 	if (unlikely(object))
 		goto out;
 
-	object = __slab_alloc_node(s, gfpflags, node, addr, orig_size);
+	if (cache_has_sheaves(s) && node == NUMA_NO_NODE)
+		object = alloc_from_pcs(s, gfpflags);
+
+	if (!object)
+		object = __slab_alloc_node(s, gfpflags, node, addr, orig_size);
 
 	maybe_wipe_obj_freeptr(s, object);
 	init = slab_want_init_on_alloc(gfpflags, s);
@@ -4474,8 +4939,16 @@ void slab_free(struct kmem_cache *s, struct slab *slab, void *object,
 	memcg_slab_free_hook(s, slab, &object, 1);
 	alloc_tagging_slab_free_hook(s, slab, &object, 1);
 
-	if (likely(slab_free_hook(s, object, slab_want_init_on_free(s))))
-		do_slab_free(s, slab, object, object, 1, addr);
+	if (unlikely(!slab_free_hook(s, object, slab_want_init_on_free(s))))
+		return;
+
+	if (cache_has_sheaves(s) && slab_nid(slab) == numa_mem_id() &&
+	    likely(!is_kfence_address(object))) {
+		free_to_pcs(s, object);
+		return;
+	}
+
+	do_slab_free(s, slab, object, object, 1, addr);
 }
 
 #ifdef CONFIG_MEMCG
@@ -4702,12 +5175,52 @@ static void __kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p)
 	} while (likely(size));
 }
 
+/*
+ * Free the objects of caches with sheaves one by one through the sheaves and
+ * return the number of remaining objects, which are compacted at the start
+ * of @p. kfree_bulk(), and thus kfree_rcu(), passes a NULL cache.
+ */
+static size_t free_to_pcs_bulk(struct kmem_cache *s, size_t size, void **p)
+{
+	size_t i = 0;
+
+	while (i < size) {
+		void *object = p[i];
+		struct folio *folio = virt_to_folio(object);
+		struct kmem_cache *cache;
+		struct slab *slab;
+
+		if (unlikely(!folio_test_slab(folio))) {
+			i++;
+			continue;
+		}
+
+		slab = folio_slab(folio);
+		cache = s ? cache_from_obj(s, object) : slab->slab_cache;
+		if (!cache || !cache_has_sheaves(cache)) {
+			i++;
+			continue;
+		}
+
+		slab_free(cache, slab, object, _RET_IP_);
+		p[i] = p[--size];
+	}
+
+	return size;
+}
+
 /* Note that interrupts must be enabled when calling this function. */
 void kmem_cache_free_bulk(struct kmem_cache *s, size_t size, void **p)
 {
 	if (!size)
 		return;
 
+	if (s ? cache_has_sheaves(s) : static_branch_unlikely(&slub_sheaves_used)) {
+		size = free_to_pcs_bulk(s, size, p);
+		if (!size)
+			return;
+	}
+
 	do {
 		struct detached_freelist df;
 
@@ -4826,7 +5339,7 @@ static int __kmem_cache_alloc_bulk(struct kmem_cache *s, gfp_t flags,
 int kmem_cache_alloc_bulk_noprof(struct kmem_cache *s, gfp_t flags, size_t size,
 				 void **p)
 {
-	int i;
+	unsigned int i = 0;
 
 	if (!size)
 		return 0;
@@ -4835,9 +5348,15 @@ int kmem_cache_alloc_bulk_noprof(struct kmem_cache *s, gfp_t flags, size_t size,
 	if (unlikely(!s))
 		return 0;
 
-	i = __kmem_cache_alloc_bulk(s, flags, size, p);
-	if (unlikely(i == 0))
+	if (cache_has_sheaves(s))
+		i = alloc_from_pcs_bulk(s, size, p);
+
+	if (i < size &&
+	    unlikely(!__kmem_cache_alloc_bulk(s, flags, size - i, p + i))) {
+		/* The objects from the sheaves did not see the alloc hooks */
+		__kmem_cache_free_bulk(s, i, p);
 		return 0;
+	}
 
 	/*
 	 * memcg and kmem_cache debug support and memory initialization.
@@ -4847,10 +5366,86 @@ int kmem_cache_alloc_bulk_noprof(struct kmem_cache *s, gfp_t flags, size_t size,
 		    slab_want_init_on_alloc(flags, s), s->object_size))) {
 		return 0;
 	}
-	return i;
+	return size;
 }
 EXPORT_SYMBOL(kmem_cache_alloc_bulk_noprof);
 
+/**
+ * kmem_cache_setup_sheaves - Enable per cpu sheaves for a cache
+ * @s: The cache.
+ * @capacity: The number of objects in a sheaf.
+ *
+ * Allocations without a node preference and frees of objects from the local
+ * node then only take a per cpu lock, and bulk allocations and frees move
+ * whole batches at once. Full and empty sheaves are exchanged with a per
+ * node barn, which limits how many objects a cache keeps cached.
+ *
+ * Meant for caches with high alloc and free rates. The sheaves can't be
+ * disabled again and are not supported for caches with debugging enabled.
+ *
+ * Return: 0 on success, -EINVAL for a debug cache or an invalid @capacity,
+ * -EBUSY if the cache already has sheaves, or -ENOMEM.
+ */
+int kmem_cache_setup_sheaves(struct kmem_cache *s, unsigned int capacity)
+{
+#ifndef CONFIG_SLUB_TINY
+	struct slub_percpu_sheaves __percpu *cpu_sheaves;
+	int cpu, ret = 0;
+
+	if (!capacity || capacity > MAX_SHEAF_CAPACITY || kmem_cache_debug(s))
+		return -EINVAL;
+
+	mutex_lock(&slab_mutex);
+	if (s->cpu_sheaves) {
+		ret = -EBUSY;
+		goto out;
+	}
+
+	cpu_sheaves = alloc_percpu(struct slub_percpu_sheaves);
+	if (!cpu_sheaves) {
+		ret = -ENOMEM;
+		goto out;
+	}
+
+	s->sheaf_capacity = capacity;
+	for_each_possible_cpu(cpu) {
+		struct slub_percpu_sheaves *pcs = per_cpu_ptr(cpu_sheaves, cpu);
+
+		local_lock_init(&pcs->lock);
+		pcs->main = alloc_empty_sheaf(s, GFP_KERNEL);
+		pcs->spare = alloc_empty_sheaf(s, GFP_KERNEL);
+		if (!pcs->main || !pcs->spare)
+			ret = -ENOMEM;
+	}
+
+	if (ret) {
+		for_each_possible_cpu(cpu) {
+			struct slub_percpu_sheaves *pcs;
+
+			pcs = per_cpu_ptr(cpu_sheaves, cpu);
+			kfree(pcs->main);
+			kfree(pcs->spare);
+		}
+		free_percpu(cpu_sheaves);
+		s->sheaf_capacity = 0;
+		goto out;
+	}
+
+	/* Pairs with smp_load_acquire() in cache_has_sheaves() */
+	smp_store_release(&s->cpu_sheaves, cpu_sheaves);
+out:
+	mutex_unlock(&slab_mutex);
+
+	/* Takes the cpu hotplug lock, which nests outside of slab_mutex */
+	if (!ret)
+		static_branch_enable(&slub_sheaves_used);
+	return ret;
+#else
+	return -EOPNOTSUPP;
+#endif
+}
+EXPORT_SYMBOL(kmem_cache_setup_sheaves);
+
 
 /*
  * Object placement in a slab is made very easy because we always start at
@@ -4995,6 +5590,13 @@ init_kmem_cache_node(struct kmem_cache_node *n)
 	atomic_long_set(&n->total_objects, 0);
 	INIT_LIST_HEAD(&n->full);
 #endif
+#ifndef CONFIG_SLUB_TINY
+	spin_lock_init(&n->barn.lock);
+	INIT_LIST_HEAD(&n->barn.sheaves_full);
+	INIT_LIST_HEAD(&n->barn.sheaves_empty);
+	n->barn.nr_full = 0;
+	n->barn.nr_empty = 0;
+#endif
 }
 
 #ifndef CONFIG_SLUB_TINY
@@ -5084,6 +5686,7 @@ static void free_kmem_cache_nodes(struct kmem_cache *s)
 void __kmem_cache_release(struct kmem_cache *s)
 {
 	cache_random_seq_destroy(s);
+	free_percpu_sheaves(s);
 #ifndef CONFIG_SLUB_TINY
 	free_percpu(s->cpu_slab);
 #endif
@@ -5417,6 +6020,7 @@ int __kmem_cache_shutdown(struct kmem_cache *s)
 	struct kmem_cache_node *n;
 
 	flush_all_cpus_locked(s);
+	barn_shrink(s);
 	/* Attempt to free all objects */
 	for_each_kmem_cache_node(s, node, n) {
 		free_partial(s, n);
@@ -5654,6 +6258,7 @@ static int __kmem_cache_do_shrink(struct kmem_cache *s)
 int __kmem_cache_shrink(struct kmem_cache *s)
 {
 	flush_all(s);
+	barn_shrink(s);
 	return __kmem_cache_do_shrink(s);
 }
 
@@ -5664,6 +6269,7 @@ static int slab_mem_going_offline_callback(void *arg)
 	mutex_lock(&slab_mutex);
 	list_for_each_entry(s, &slab_caches, list) {
 		flush_all_cpus_locked(s);
+		barn_shrink(s);
 		__kmem_cache_do_shrink(s);
 	}
 	mutex_unlock(&slab_mutex);
@@ -6475,6 +7081,16 @@ static ssize_t slabs_cpu_partial_show(struct kmem_cache *s, char *buf)
 }
 SLAB_ATTR_RO(slabs_cpu_partial);
 
+static ssize_t sheaf_capacity_show(struct kmem_cache *s, char *buf)
+{
+#ifndef CONFIG_SLUB_TINY
+	if (s->cpu_sheaves)
+		return sysfs_emit(buf, "%u\n", s->sheaf_capacity);
+#endif
+	return sysfs_emit(buf, "0\n");
+}
+SLAB_ATTR_RO(sheaf_capacity);
+
 static ssize_t reclaim_account_show(struct kmem_cache *s, char *buf)
 {
 	return sysfs_emit(buf, "%d\n", !!(s->flags & SLAB_RECLAIM_ACCOUNT));
@@ -6727,6 +7343,14 @@ STAT_ATTR(CPU_PARTIAL_ALLOC, cpu_partial_alloc);
 STAT_ATTR(CPU_PARTIAL_FREE, cpu_partial_free);
 STAT_ATTR(CPU_PARTIAL_NODE, cpu_partial_node);
 STAT_ATTR(CPU_PARTIAL_DRAIN, cpu_partial_drain);
+STAT_ATTR(ALLOC_PCS, alloc_cpu_sheaf);
+STAT_ATTR(FREE_PCS, free_cpu_sheaf);
+STAT_ATTR(BARN_GET, barn_get);
+STAT_ATTR(BARN_GET_FAIL, barn_get_fail);
+STAT_ATTR(BARN_PUT, barn_put);
+STAT_ATTR(BARN_PUT_FAIL, barn_put_fail);
+STAT_ATTR(SHEAF_REFILL, sheaf_refill);
+STAT_ATTR(SHEAF_FLUSH, sheaf_flush);
 #endif	/* CONFIG_SLUB_STATS */
 
 #ifdef CONFIG_KFENCE
@@ -6770,6 +7394,7 @@ static struct attribute *slab_attrs[] = {
 	&destroy_by_rcu_attr.attr,
 	&shrink_attr.attr,
 	&slabs_cpu_partial_attr.attr,
+	&sheaf_capacity_attr.attr,
 #ifdef CONFIG_SLUB_DEBUG
 	&total_objects_attr.attr,
 	&objects_attr.attr,
@@ -6814,6 +7439,14 @@ static struct attribute *slab_attrs[] = {
 	&cpu_partial_free_attr.attr,
 	&cpu_partial_node_attr.attr,
 	&cpu_partial_drain_attr.attr,
+	&alloc_cpu_sheaf_attr.attr,
+	&free_cpu_sheaf_attr.attr,
+	&barn_get_attr.attr,
+	&barn_get_fail_attr.attr,
+	&barn_put_attr.attr,
+	&barn_put_fail_attr.attr,
+	&sheaf_refill_attr.attr,
+	&sheaf_flush_attr.attr,
 #endif
 #ifdef CONFIG_FAILSLAB
 	&failslab_attr.attr,
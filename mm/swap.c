@@ -37,6 +37,7 @@
 #include <linux/page_idle.h>
 #include <linux/local_lock.h>
 #include <linux/buffer_head.h>
+#include <linux/sched/isolation.h>
 
 #include "internal.h"
 
@@ -832,7 +833,7 @@ static bool cpu_needs_drain(unsigned int cpu)
  * Calling this function with cpu hotplug locks held can actually lead
  * to obscure indirect dependencies via WQ context.
  */
-static inline void __lru_add_drain_all(bool force_all_cpus)
+static inline void __lru_add_drain_all(bool force_all_cpus, bool skip_isolated)
 {
 	/*
 	 * lru_drain_gen - Global pages generation number
@@ -902,13 +903,26 @@ static inline void __lru_add_drain_all(bool force_all_cpus)
 	 * loop, CPU #x will just exit at (C) and miss flushing out all of its
 	 * added pages.
 	 */
-	WRITE_ONCE(lru_drain_gen, lru_drain_gen + 1);
+	/*
+	 * A drain that skips isolated CPUs does not cover every batch, so it
+	 * must not let callers which need a full drain exit at (C).
+	 */
+	if (!skip_isolated)
+		WRITE_ONCE(lru_drain_gen, lru_drain_gen + 1);
 	smp_mb();
 
 	cpumask_clear(&has_work);
 	for_each_online_cpu(cpu) {
 		struct work_struct *work = &per_cpu(lru_add_drain_work, cpu);
 
+		/*
+		 * Leave strictly isolated CPUs alone if the caller only drains
+		 * opportunistically. Their folios are added to the LRU on
+		 * their next local drain.
+		 */
+		if (skip_isolated && cpu_is_isolated_strict(cpu))
+			continue;
+
 		if (cpu_needs_drain(cpu)) {
 			INIT_WORK(work, lru_add_drain_per_cpu);
 			queue_work_on(cpu, mm_percpu_wq, work);
@@ -925,13 +939,28 @@ static inline void __lru_add_drain_all(bool force_all_cpus)
 
 void lru_add_drain_all(void)
 {
-	__lru_add_drain_all(false);
+	__lru_add_drain_all(false, false);
+}
+
+/*
+ * Like lru_add_drain_all(), but leaves CPUs isolated with isolcpus=strict
+ * alone. Only for callers which merely improve their odds by draining, and
+ * do not depend on every folio batch being empty afterwards.
+ */
+void lru_add_drain_all_besteffort(void)
+{
+	__lru_add_drain_all(false, true);
 }
 #else
 void lru_add_drain_all(void)
 {
 	lru_add_drain();
 }
+
+void lru_add_drain_all_besteffort(void)
+{
+	lru_add_drain();
+}
 #endif /* CONFIG_SMP */
 
 atomic_t lru_disable_count = ATOMIC_INIT(0);
@@ -962,7 +991,7 @@ void lru_cache_disable(void)
 	 */
 	synchronize_rcu_expedited();
 #ifdef CONFIG_SMP
-	__lru_add_drain_all(true);
+	__lru_add_drain_all(true, false);
 #else
 	lru_add_and_bh_lrus_drain();
 #endif
@@ -1092,8 +1092,14 @@ int get_swap_pages(int n_goal, swp_entry_t swp_entries[], int entry_order)
 start_over:
 	node = numa_node_id();
 	plist_for_each_entry_safe(si, next, &swap_avail_heads[node], avail_lists[node]) {
-		/* requeue si to after same-priority siblings */
-		plist_requeue(&si->avail_lists[node], &swap_avail_heads[node]);
+		/*
+		 * requeue si to after same-priority siblings.  A large
+		 * allocation can fail without taking si off the list, so
+		 * requeueing before it succeeds would make the walk cycle
+		 * between same-priority siblings forever.
+		 */
+		if (size == 1)
+			plist_requeue(&si->avail_lists[node], &swap_avail_heads[node]);
 		spin_unlock(&swap_avail_lock);
 		spin_lock(&si->lock);
 		if (!si->highest_bit || !(si->flags & SWP_WRITEOK)) {
@@ -1115,8 +1121,21 @@ int get_swap_pages(int n_goal, swp_entry_t swp_entries[], int entry_order)
 		n_ret = scan_swap_map_slots(si, SWAP_HAS_CACHE,
 					    n_goal, swp_entries, order);
 		spin_unlock(&si->lock);
-		if (n_ret || size > 1)
+		/*
+		 * A large allocation that fails here only means this device
+		 * has no free cluster for it, so try the next device before
+		 * making the caller split the folio.
+		 */
+		if (n_ret) {
+			if (size > 1) {
+				spin_lock(&swap_avail_lock);
+				if (!plist_node_empty(&si->avail_lists[node]))
+					plist_requeue(&si->avail_lists[node],
+						      &swap_avail_heads[node]);
+				spin_unlock(&swap_avail_lock);
+			}
 			goto check_out;
+		}
 		cond_resched();
 
 		spin_lock(&swap_avail_lock);
@@ -1929,8 +1929,12 @@ node_alloc(unsigned long size, unsigned long align,
 	va = node_pool_del_va(id_to_node(*vn_id), size, align, vstart, vend);
 	*vn_id = encode_vn_id(*vn_id);
 
-	if (va)
+	if (va) {
 		*addr = va->va_start;
+		count_vm_event(VMALLOC_POOL_HIT);
+	} else if (size <= MAX_VA_SIZE_PAGES * PAGE_SIZE) {
+		count_vm_event(VMALLOC_POOL_MISS);
+	}
 
 	return va;
 }
@@ -2271,6 +2275,7 @@ static bool __purge_vmap_area_lazy(unsigned long start, unsigned long end,
 	nr_purge_nodes = cpumask_weight(&purge_nodes);
 	if (nr_purge_nodes > 0) {
 		flush_tlb_kernel_range(start, end);
+		count_vm_event(VMALLOC_PURGE_FLUSH);
 
 		/* One extra worker is per a lazy_max_pages() full set minus one. */
 		nr_purge_helpers = atomic_long_read(&vmap_lazy_nr) / lazy_max_pages();
@@ -2305,6 +2310,11 @@ static bool __purge_vmap_area_lazy(unsigned long start, unsigned long end,
 		}
 	}
 
+	if (nr_purged_areas) {
+		count_vm_event(VMALLOC_PURGE);
+		count_vm_events(VMALLOC_PURGED_AREAS, nr_purged_areas);
+	}
+
 	trace_purge_vmap_area_lazy(start, end, nr_purged_areas);
 	return nr_purged_areas > 0;
 }
@@ -150,6 +150,10 @@ struct scan_control {
 	/* Always discard instead of demoting to lower tier memory */
 	unsigned int no_demotion:1;
 
+	/* kswapd thread of the node and how many there are, see kswapd_skip_memcg() */
+	unsigned int kswapd_worker;
+	unsigned int kswapd_nr_workers;
+
 	/* Allocation order */
 	s8 order;
 
@@ -270,6 +274,17 @@ static int sc_swappiness(struct scan_control *sc, struct mem_cgroup *memcg)
 }
 #endif
 
+/*
+ * With several kswapd threads per node, each of them reclaims from its own
+ * share of the memcgs so that they neither contend on the same LRU locks nor
+ * scan the same folios.
+ */
+static bool kswapd_skip_memcg(struct scan_control *sc, struct mem_cgroup *memcg)
+{
+	return sc->kswapd_nr_workers > 1 &&
+	       mem_cgroup_id(memcg) % sc->kswapd_nr_workers != sc->kswapd_worker;
+}
+
 static void set_task_reclaim_state(struct task_struct *task,
 				   struct reclaim_state *rs)
 {
@@ -1356,7 +1371,7 @@ static unsigned int shrink_folio_list(struct list_head *folio_list,
 			 * potentially exists to avoid CPU writes after I/O
 			 * starts and then write it out here.
 			 */
-			try_to_unmap_flush_dirty();
+			try_to_unmap_flush_dirty(TLB_BATCH_RECLAIM);
 			switch (pageout(folio, mapping, &plug)) {
 			case PAGE_KEEP:
 				goto keep_locked;
@@ -1459,7 +1474,7 @@ static unsigned int shrink_folio_list(struct list_head *folio_list,
 		folio_undo_large_rmappable(folio);
 		if (folio_batch_add(&free_folios, folio) == 0) {
 			mem_cgroup_uncharge_folios(&free_folios);
-			try_to_unmap_flush();
+			try_to_unmap_flush(TLB_BATCH_RECLAIM);
 			free_unref_folios(&free_folios);
 		}
 		continue;
@@ -1526,7 +1541,7 @@ static unsigned int shrink_folio_list(struct list_head *folio_list,
 	pgactivate = stat->nr_activate[0] + stat->nr_activate[1];
 
 	mem_cgroup_uncharge_folios(&free_folios);
-	try_to_unmap_flush();
+	try_to_unmap_flush(TLB_BATCH_RECLAIM);
 	free_unref_folios(&free_folios);
 
 	list_splice(&ret_folios, folio_list);
@@ -3662,7 +3677,8 @@ static struct lru_gen_mm_walk *set_mm_walk(struct pglist_data *pgdat, bool force
 {
 	struct lru_gen_mm_walk *walk = current->reclaim_state->mm_walk;
 
-	if (pgdat && current_is_kswapd()) {
+	/* kswapd helpers do without, there is only one per node */
+	if (pgdat && current == pgdat->kswapd) {
 		VM_WARN_ON_ONCE(walk);
 
 		walk = &pgdat->mm_walk;
@@ -4845,6 +4861,11 @@ static void shrink_many(struct pglist_data *pgdat, struct scan_control *sc)
 		lruvec = container_of(lrugen, struct lruvec, lrugen);
 		memcg = lruvec_memcg(lruvec);
 
+		if (kswapd_skip_memcg(sc, memcg)) {
+			memcg = NULL;
+			continue;
+		}
+
 		if (!mem_cgroup_tryget(memcg)) {
 			lru_gen_release_memcg(memcg);
 			memcg = NULL;
@@ -5882,6 +5903,9 @@ static void shrink_node_memcgs(pg_data_t *pgdat, struct scan_control *sc)
 			memcg_memory_event(memcg, MEMCG_LOW);
 		}
 
+		if (kswapd_skip_memcg(sc, memcg))
+			continue;
+
 		reclaimed = sc->nr_reclaimed;
 		scanned = sc->nr_scanned;
 
@@ -6724,6 +6748,7 @@ static bool kswapd_shrink_node(pg_data_t *pgdat,
 	struct zone *zone;
 	int z;
 	unsigned long nr_reclaimed = sc->nr_reclaimed;
+	unsigned long nr_scanned = sc->nr_scanned;
 
 	/* Reclaim a number of pages proportional to the number of zones */
 	sc->nr_to_reclaim = 0;
@@ -6741,6 +6766,11 @@ static bool kswapd_shrink_node(pg_data_t *pgdat,
 	 */
 	shrink_node(pgdat, sc);
 
+	count_vm_events(KSWAPD_WORKER_SCAN_0 + sc->kswapd_worker,
+			sc->nr_scanned - nr_scanned);
+	count_vm_events(KSWAPD_WORKER_STEAL_0 + sc->kswapd_worker,
+			sc->nr_reclaimed - nr_reclaimed);
+
 	/*
 	 * Fragmentation may mean that the system cannot be rebalanced for
 	 * high-order allocations. If twice the allocation size has been
@@ -6787,6 +6817,38 @@ clear_reclaim_active(pg_data_t *pgdat, int highest_zoneidx)
 	update_reclaim_active(pgdat, highest_zoneidx, false);
 }
 
+/*
+ * Let the kswapd helpers of the node join the current balance_pgdat() run at
+ * its current priority and zone index, and with the same writeback policy.
+ */
+static void kswapd_workers_kick(pg_data_t *pgdat, struct scan_control *sc)
+{
+	bool wake;
+
+	if (sc->kswapd_nr_workers <= 1)
+		return;
+
+	wake = !READ_ONCE(pgdat->kswapd_workers_active) ||
+	       READ_ONCE(pgdat->kswapd_workers_priority) != sc->priority;
+
+	WRITE_ONCE(pgdat->kswapd_workers_zoneidx, sc->reclaim_idx);
+	WRITE_ONCE(pgdat->kswapd_workers_may_writepage, sc->may_writepage);
+	WRITE_ONCE(pgdat->kswapd_workers_priority, sc->priority);
+	WRITE_ONCE(pgdat->kswapd_workers_active, true);
+
+	if (wake)
+		wake_up_all(&pgdat->kswapd_workers_wait);
+}
+
+static void kswapd_workers_idle(pg_data_t *pgdat)
+{
+	if (!READ_ONCE(pgdat->kswapd_workers_active))
+		return;
+
+	WRITE_ONCE(pgdat->kswapd_workers_active, false);
+	wake_up_all(&pgdat->kswapd_workers_wait);
+}
+
 /*
  * For kswapd, balance_pgdat() will reclaim pages across a node from zones
  * that are eligible for use by the caller until at least one zone is
@@ -6919,6 +6981,14 @@ static int balance_pgdat(pg_data_t *pgdat, int order, int highest_zoneidx)
 		if (sc.priority < DEF_PRIORITY - 2)
 			sc.may_writepage = 1;
 
+		/*
+		 * Boosted reclaim is meant to be short, keep it to kswapd and
+		 * its full share of memcgs.
+		 */
+		sc.kswapd_nr_workers = nr_boost_reclaim ? 1 :
+				       READ_ONCE(pgdat->kswapd_nr_workers);
+		kswapd_workers_kick(pgdat, &sc);
+
 		/* Call soft limit reclaim before calling shrink_node. */
 		sc.nr_scanned = 0;
 		nr_soft_scanned = 0;
@@ -6983,6 +7053,7 @@ static int balance_pgdat(pg_data_t *pgdat, int order, int highest_zoneidx)
 		pgdat->kswapd_failures++;
 
 out:
+	kswapd_workers_idle(pgdat);
 	clear_reclaim_active(pgdat, highest_zoneidx);
 
 	/* If reclaim was boosted, account for the reclaim done in this pass */
@@ -7211,6 +7282,219 @@ static int kswapd(void *p)
 	return 0;
 }
 
+struct kswapd_worker {
+	struct task_struct *task;
+	pg_data_t *pgdat;
+	unsigned int id;
+};
+
+/* Protects kswapd_nr_workers and starting/stopping kswapd helpers */
+static DEFINE_MUTEX(kswapd_workers_mutex);
+static unsigned int kswapd_nr_workers = 1;
+
+/*
+ * Reclaim from the worker's share of the memcgs for as long as kswapd is
+ * balancing the node. kswapd itself takes care of aging, the priority and
+ * the high-order and boosted reclaim; the helpers follow its priority and
+ * wait for it to be raised when their share of the memcgs is exhausted.
+ */
+static void kswapd_worker_reclaim(struct kswapd_worker *worker)
+{
+	pg_data_t *pgdat = worker->pgdat;
+	struct scan_control sc = {
+		.gfp_mask = GFP_KERNEL,
+		.may_unmap = 1,
+		.may_swap = 1,
+		.kswapd_worker = worker->id,
+	};
+
+	set_task_reclaim_state(current, &sc.reclaim_state);
+
+	while (READ_ONCE(pgdat->kswapd_workers_active) && !kthread_should_stop()) {
+		unsigned long pflags;
+		bool progress;
+
+		sc.priority = READ_ONCE(pgdat->kswapd_workers_priority);
+		sc.reclaim_idx = READ_ONCE(pgdat->kswapd_workers_zoneidx);
+		sc.kswapd_nr_workers = READ_ONCE(pgdat->kswapd_nr_workers);
+		sc.may_writepage = READ_ONCE(pgdat->kswapd_workers_may_writepage);
+
+		if (worker->id >= sc.kswapd_nr_workers ||
+		    pgdat_balanced(pgdat, 0, sc.reclaim_idx))
+			break;
+
+		psi_memstall_enter(&pflags);
+		__fs_reclaim_acquire(_THIS_IP_);
+		sc.nr_scanned = 0;
+		progress = kswapd_shrink_node(pgdat, &sc);
+		__fs_reclaim_release(_THIS_IP_);
+		psi_memstall_leave(&pflags);
+
+		if (waitqueue_active(&pgdat->pfmemalloc_wait) &&
+		    allow_direct_reclaim(pgdat))
+			wake_up_all(&pgdat->pfmemalloc_wait);
+
+		if (!progress)
+			wait_event_freezable(pgdat->kswapd_workers_wait,
+				READ_ONCE(pgdat->kswapd_workers_priority) != sc.priority ||
+				!READ_ONCE(pgdat->kswapd_workers_active) ||
+				kthread_should_stop());
+	}
+
+	set_task_reclaim_state(current, NULL);
+}
+
+static int kswapd_worker(void *p)
+{
+	struct kswapd_worker *worker = p;
+	pg_data_t *pgdat = worker->pgdat;
+	const struct cpumask *cpumask = cpumask_of_node(pgdat->node_id);
+
+	if (!cpumask_empty(cpumask))
+		set_cpus_allowed_ptr(current, cpumask);
+
+	/* same as kswapd, see there */
+	current->flags |= PF_MEMALLOC | PF_KSWAPD;
+	set_freezable();
+
+	while (!kthread_should_stop()) {
+		wait_event_freezable(pgdat->kswapd_workers_wait,
+				     READ_ONCE(pgdat->kswapd_workers_active) ||
+				     kthread_should_stop());
+
+		kswapd_worker_reclaim(worker);
+
+		/* don't spin while kswapd is still finishing its run */
+		wait_event_freezable(pgdat->kswapd_workers_wait,
+				     !READ_ONCE(pgdat->kswapd_workers_active) ||
+				     kthread_should_stop());
+	}
+
+	current->flags &= ~(PF_MEMALLOC | PF_KSWAPD);
+
+	return 0;
+}
+
+/*
+ * Start or stop the kswapd helpers of @pgdat to match kswapd_nr_workers.
+ * Worker 0 is kswapd itself.
+ */
+static void kswapd_workers_update(pg_data_t *pgdat)
+{
+	unsigned int nr = kswapd_nr_workers;
+	struct kswapd_worker *worker;
+	unsigned int i;
+
+	lockdep_assert_held(&kswapd_workers_mutex);
+
+	if (!pgdat->kswapd)
+		return;
+
+	if (!pgdat->kswapd_workers) {
+		if (nr <= 1)
+			return;
+
+		pgdat->kswapd_workers = kcalloc_node(KSWAPD_MAX_WORKERS,
+						     sizeof(*worker), GFP_KERNEL,
+						     pgdat->node_id);
+		if (!pgdat->kswapd_workers)
+			return;
+	}
+
+	/* shrink the memcg partitions before their owners go away */
+	if (READ_ONCE(pgdat->kswapd_nr_workers) > nr)
+		WRITE_ONCE(pgdat->kswapd_nr_workers, nr);
+
+	for (i = KSWAPD_MAX_WORKERS - 1; i >= max(nr, 1U); i--) {
+		worker = &pgdat->kswapd_workers[i];
+		if (worker->task) {
+			kthread_stop(worker->task);
+			worker->task = NULL;
+		}
+	}
+
+	for (i = 1; i < nr; i++) {
+		worker = &pgdat->kswapd_workers[i];
+		if (!worker->task) {
+			struct task_struct *task;
+
+			worker->pgdat = pgdat;
+			worker->id = i;
+			task = kthread_run(kswapd_worker, worker, "kswapd%d.%u",
+					   pgdat->node_id, i);
+			if (IS_ERR(task)) {
+				pr_warn("Failed to start kswapd worker %u on node %d, ret=%ld\n",
+					i, pgdat->node_id, PTR_ERR(task));
+				break;
+			}
+			worker->task = task;
+		}
+		WRITE_ONCE(pgdat->kswapd_nr_workers, i + 1);
+	}
+}
+
+static void kswapd_workers_stop(pg_data_t *pgdat)
+{
+	unsigned int i;
+
+	if (!pgdat->kswapd_workers)
+		return;
+
+	WRITE_ONCE(pgdat->kswapd_nr_workers, 0);
+	for (i = 1; i < KSWAPD_MAX_WORKERS; i++) {
+		if (pgdat->kswapd_workers[i].task)
+			kthread_stop(pgdat->kswapd_workers[i].task);
+	}
+
+	kfree(pgdat->kswapd_workers);
+	pgdat->kswapd_workers = NULL;
+}
+
+static ssize_t nr_workers_show(struct kobject *kobj, struct kobj_attribute *attr,
+			       char *buf)
+{
+	return sysfs_emit(buf, "%u\n", READ_ONCE(kswapd_nr_workers));
+}
+
+static ssize_t nr_workers_store(struct kobject *kobj, struct kobj_attribute *attr,
+				const char *buf, size_t len)
+{
+	unsigned int nr;
+	int nid;
+
+	if (kstrtouint(buf, 0, &nr) || !nr || nr > KSWAPD_MAX_WORKERS)
+		return -EINVAL;
+
+	/* the helpers partition reclaim by memcg */
+	if (nr > 1 && mem_cgroup_disabled())
+		return -EINVAL;
+
+	mutex_lock(&kswapd_workers_mutex);
+	kswapd_nr_workers = nr;
+	for_each_node_state(nid, N_MEMORY) {
+		pg_data_t *pgdat = NODE_DATA(nid);
+
+		pgdat_kswapd_lock(pgdat);
+		kswapd_workers_update(pgdat);
+		pgdat_kswapd_unlock(pgdat);
+	}
+	mutex_unlock(&kswapd_workers_mutex);
+
+	return len;
+}
+
+static struct kobj_attribute kswapd_nr_workers_attr = __ATTR_RW(nr_workers);
+
+static struct attribute *kswapd_attrs[] = {
+	&kswapd_nr_workers_attr.attr,
+	NULL
+};
+
+static const struct attribute_group kswapd_attr_group = {
+	.name = "kswapd",
+	.attrs = kswapd_attrs,
+};
+
 /*
  * A zone is low on free memory or too fragmented for high-order memory.  If
  * kswapd should reclaim (direct reclaim is deferred), wake it up for the zone's
@@ -7309,6 +7593,7 @@ void __meminit kswapd_run(int nid)
 {
 	pg_data_t *pgdat = NODE_DATA(nid);
 
+	mutex_lock(&kswapd_workers_mutex);
 	pgdat_kswapd_lock(pgdat);
 	if (!pgdat->kswapd) {
 		pgdat->kswapd = kthread_run(kswapd, pgdat, "kswapd%d", nid);
@@ -7320,7 +7605,9 @@ void __meminit kswapd_run(int nid)
 			pgdat->kswapd = NULL;
 		}
 	}
+	kswapd_workers_update(pgdat);
 	pgdat_kswapd_unlock(pgdat);
+	mutex_unlock(&kswapd_workers_mutex);
 }
 
 /*
@@ -7332,13 +7619,16 @@ void __meminit kswapd_stop(int nid)
 	pg_data_t *pgdat = NODE_DATA(nid);
 	struct task_struct *kswapd;
 
+	mutex_lock(&kswapd_workers_mutex);
 	pgdat_kswapd_lock(pgdat);
+	kswapd_workers_stop(pgdat);
 	kswapd = pgdat->kswapd;
 	if (kswapd) {
 		kthread_stop(kswapd);
 		pgdat->kswapd = NULL;
 	}
 	pgdat_kswapd_unlock(pgdat);
+	mutex_unlock(&kswapd_workers_mutex);
 }
 
 static int __init kswapd_init(void)
@@ -7348,6 +7638,8 @@ static int __init kswapd_init(void)
 	swap_setup();
 	for_each_node_state(nid, N_MEMORY)
  		kswapd_run(nid);
+	if (sysfs_create_group(mm_kobj, &kswapd_attr_group))
+		pr_err("kswapd: failed to create sysfs group\n");
 	return 0;
 }
 
@@ -1183,6 +1183,19 @@ int fragmentation_index(struct zone *zone, unsigned int order)
 #define TEXT_FOR_DEVICE(xx)
 #endif
 
+#define TEXTS_FOR_KSWAPD_WORKERS(xx) xx "_0", xx "_1", xx "_2", xx "_3", \
+	xx "_4", xx "_5", xx "_6", xx "_7",
+
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+#define TEXTS_FOR_PCP_HIGH_ORDERS(xx) xx "_order4", xx "_order5", \
+	xx "_order6", xx "_order7", xx "_pmd",
+#else
+#define TEXTS_FOR_PCP_HIGH_ORDERS(xx)
+#endif
+
+#define TEXTS_FOR_PCP_ORDERS(xx) xx "_order0", xx "_order1", xx "_order2", \
+	xx "_order3", TEXTS_FOR_PCP_HIGH_ORDERS(xx)
+
 #define TEXTS_FOR_ZONES(xx) TEXT_FOR_DMA(xx) TEXT_FOR_DMA32(xx) xx "_normal", \
 					TEXT_FOR_HIGHMEM(xx) xx "_movable", \
 					TEXT_FOR_DEVICE(xx)
@@ -1294,6 +1307,8 @@ const char * const vmstat_text[] = {
 	"pgactivate",
 	"pgdeactivate",
 	"pglazyfree",
+	TEXTS_FOR_PCP_ORDERS("pcp_alloc")
+	TEXTS_FOR_PCP_ORDERS("pcp_zone_lock")
 
 	"pgfault",
 	"pgmajfault",
@@ -1321,6 +1336,8 @@ const char * const vmstat_text[] = {
 	"kswapd_inodesteal",
 	"kswapd_low_wmark_hit_quickly",
 	"kswapd_high_wmark_hit_quickly",
+	TEXTS_FOR_KSWAPD_WORKERS("kswapd_worker_scan")
+	TEXTS_FOR_KSWAPD_WORKERS("kswapd_worker_steal")
 	"pageoutrun",
 
 	"pgrotated",
@@ -1328,6 +1345,8 @@ const char * const vmstat_text[] = {
 	"drop_pagecache",
 	"drop_slab",
 	"oom_kill",
+	"pgtable_cache_hit",
+	"pgtable_cache_miss",
 
 #ifdef CONFIG_NUMA_BALANCING
 	"numa_pte_updates",
@@ -1335,6 +1354,7 @@ const char * const vmstat_text[] = {
 	"numa_hint_faults",
 	"numa_hint_faults_local",
 	"numa_pages_migrated",
+	"numa_tlb_flush",
 #endif
 #ifdef CONFIG_MIGRATION
 	"pgmigrate_success",
@@ -1388,6 +1408,10 @@ const char * const vmstat_text[] = {
 	"thp_scan_exceed_none_pte",
 	"thp_scan_exceed_swap_pte",
 	"thp_scan_exceed_share_pte",
+	"thp_scan_range",
+	"thp_scan_range_hot",
+	"thp_collapse_range",
+	"thp_collapse_range_hot",
 #ifdef CONFIG_HAVE_ARCH_TRANSPARENT_HUGEPAGE_PUD
 	"thp_split_pud",
 #endif
@@ -1409,6 +1433,14 @@ const char * const vmstat_text[] = {
 	"nr_tlb_local_flush_all",
 	"nr_tlb_local_flush_one",
 #endif /* CONFIG_DEBUG_TLBFLUSH */
+#ifdef CONFIG_ARCH_WANT_BATCHED_UNMAP_TLB_FLUSH
+	"tlb_batch_deferred",
+	"tlb_batch_flush_reclaim",
+	"tlb_batch_flush_migrate",
+	"tlb_batch_flush_khugepaged",
+	"tlb_batch_flush_split",
+	"tlb_batch_flush_pending",
+#endif
 
 #ifdef CONFIG_SWAP
 	"swap_ra",
@@ -1425,6 +1457,18 @@ const char * const vmstat_text[] = {
 	"zswpout",
 	"zswpwb",
 #endif
+#ifdef CONFIG_MEMCG
+	"memcg_stock_hit",
+	"memcg_stock_miss",
+	"memcg_stock_drain",
+#endif
+#ifdef CONFIG_MMU
+	"vmalloc_pool_hit",
+	"vmalloc_pool_miss",
+	"vmalloc_purge",
+	"vmalloc_purge_flush",
+	"vmalloc_purged_areas",
+#endif
 #ifdef CONFIG_X86
 	"direct_map_level2_splits",
 	"direct_map_level3_splits",
@@ -1434,6 +1478,12 @@ const char * const vmstat_text[] = {
 	"vma_lock_abort",
 	"vma_lock_retry",
 	"vma_lock_miss",
+	"vma_lock_retry_io",
+	"vma_lock_retry_swap",
+	"vma_lock_retry_uffd",
+	"vma_lock_fallback_anon",
+	"vma_lock_fallback_fault",
+	"vma_lock_fallback_device",
 #endif
 #endif /* CONFIG_VM_EVENT_COUNTERS || CONFIG_MEMCG */
 };
@@ -181,6 +181,20 @@ static struct dentry *zs_stat_root;
 
 static size_t huge_class_size;
 
+/*
+ * Background compaction: once the pages compaction could free make up
+ * compact_frag_ratio percent of a pool, a worker compacts it, spending at
+ * most compact_budget_us per ZS_COMPACT_INTERVAL. 0 leaves compaction to the
+ * shrinker and to explicit requests.
+ */
+#define ZS_COMPACT_INTERVAL	HZ
+
+static unsigned int zs_compact_frag_ratio;
+module_param_named(compact_frag_ratio, zs_compact_frag_ratio, uint, 0644);
+
+static unsigned int zs_compact_budget_us = 2000;
+module_param_named(compact_budget_us, zs_compact_budget_us, uint, 0644);
+
 struct size_class {
 	spinlock_t lock;
 	struct list_head fullness_list[NR_FULLNESS_GROUPS];
@@ -240,6 +254,11 @@ struct zs_pool {
 	/* protect page/zspage migration */
 	rwlock_t migrate_lock;
 	atomic_t compaction_in_progress;
+
+	/* Background compaction, see zs_compact_frag_ratio */
+	struct delayed_work compact_work;
+	unsigned long compact_runs;
+	unsigned long compact_budget_hits;
 };
 
 struct zspage {
@@ -611,6 +630,27 @@ static int zs_stats_size_show(struct seq_file *s, void *v)
 }
 DEFINE_SHOW_ATTRIBUTE(zs_stats_size);
 
+static unsigned int zs_frag_ratio(struct zs_pool *pool);
+
+static int zs_stats_compaction_show(struct seq_file *s, void *v)
+{
+	struct zs_pool *pool = s->private;
+
+	seq_printf(s, "pages_allocated %ld\n",
+		   atomic_long_read(&pool->pages_allocated));
+	seq_printf(s, "frag_ratio %u\n", zs_frag_ratio(pool));
+	seq_printf(s, "frag_ratio_target %u\n",
+		   READ_ONCE(zs_compact_frag_ratio));
+	seq_printf(s, "pages_compacted %ld\n",
+		   atomic_long_read(&pool->stats.pages_compacted));
+	seq_printf(s, "background_runs %lu\n", READ_ONCE(pool->compact_runs));
+	seq_printf(s, "background_budget_hits %lu\n",
+		   READ_ONCE(pool->compact_budget_hits));
+
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(zs_stats_compaction);
+
 static void zs_pool_stat_create(struct zs_pool *pool, const char *name)
 {
 	if (!zs_stat_root) {
@@ -622,6 +662,8 @@ static void zs_pool_stat_create(struct zs_pool *pool, const char *name)
 
 	debugfs_create_file("classes", S_IFREG | 0444, pool->stat_dentry, pool,
 			    &zs_stats_size_fops);
+	debugfs_create_file("compaction", S_IFREG | 0444, pool->stat_dentry,
+			    pool, &zs_stats_compaction_fops);
 }
 
 static void zs_pool_stat_destroy(struct zs_pool *pool)
@@ -1461,6 +1503,12 @@ void zs_free(struct zs_pool *pool, unsigned long handle)
 
 	spin_unlock(&class->lock);
 	cache_free_handle(pool, handle);
+
+	/* Frees are what fragments the pool; check it again in a while */
+	if (READ_ONCE(zs_compact_frag_ratio) &&
+	    !delayed_work_pending(&pool->compact_work))
+		queue_delayed_work(system_unbound_wq, &pool->compact_work,
+				   ZS_COMPACT_INTERVAL);
 }
 EXPORT_SYMBOL_GPL(zs_free);
 
@@ -1933,8 +1981,9 @@ static unsigned long zs_can_compact(struct size_class *class)
 	return obj_wasted * class->pages_per_zspage;
 }
 
+/* Compact @class, until @deadline in ktime_get_ns() time unless it is 0 */
 static unsigned long __zs_compact(struct zs_pool *pool,
-				  struct size_class *class)
+				  struct size_class *class, u64 deadline)
 {
 	struct zspage *src_zspage = NULL;
 	struct zspage *dst_zspage = NULL;
@@ -1949,6 +1998,9 @@ static unsigned long __zs_compact(struct zs_pool *pool,
 	while (zs_can_compact(class)) {
 		int fg;
 
+		if (deadline && ktime_get_ns() >= deadline)
+			break;
+
 		if (!dst_zspage) {
 			dst_zspage = isolate_dst_zspage(class);
 			if (!dst_zspage)
@@ -2014,7 +2066,7 @@ unsigned long zs_compact(struct zs_pool *pool)
 		class = pool->size_class[i];
 		if (class->index != i)
 			continue;
-		pages_freed += __zs_compact(pool, class);
+		pages_freed += __zs_compact(pool, class, 0);
 	}
 	atomic_long_add(pages_freed, &pool->stats.pages_compacted);
 	atomic_set(&pool->compaction_in_progress, 0);
@@ -2023,6 +2075,75 @@ unsigned long zs_compact(struct zs_pool *pool)
 }
 EXPORT_SYMBOL_GPL(zs_compact);
 
+/* Pages compaction could free, against all pages of the pool */
+static unsigned int zs_frag_ratio(struct zs_pool *pool)
+{
+	unsigned long total = atomic_long_read(&pool->pages_allocated);
+	unsigned long freeable = 0;
+	struct size_class *class;
+	int i;
+
+	if (!total)
+		return 0;
+
+	for (i = ZS_SIZE_CLASSES - 1; i >= 0; i--) {
+		class = pool->size_class[i];
+		if (class->index != i)
+			continue;
+
+		freeable += zs_can_compact(class);
+	}
+
+	return freeable * 100 / total;
+}
+
+static void zs_compact_work(struct work_struct *work)
+{
+	struct zs_pool *pool = container_of(to_delayed_work(work),
+					    struct zs_pool, compact_work);
+	unsigned int ratio = READ_ONCE(zs_compact_frag_ratio);
+	unsigned long pages_freed = 0;
+	bool over_budget = false;
+	struct size_class *class;
+	u64 deadline;
+	int i;
+
+	if (!ratio || zs_frag_ratio(pool) < ratio)
+		return;
+
+	/* Let a running compaction finish and look again later */
+	if (atomic_xchg(&pool->compaction_in_progress, 1)) {
+		queue_delayed_work(system_unbound_wq, &pool->compact_work,
+				   ZS_COMPACT_INTERVAL);
+		return;
+	}
+
+	deadline = ktime_get_ns() +
+		   (u64)READ_ONCE(zs_compact_budget_us) * NSEC_PER_USEC;
+
+	for (i = ZS_SIZE_CLASSES - 1; i >= 0; i--) {
+		class = pool->size_class[i];
+		if (class->index != i)
+			continue;
+
+		pages_freed += __zs_compact(pool, class, deadline);
+		if (ktime_get_ns() >= deadline) {
+			over_budget = true;
+			break;
+		}
+	}
+	atomic_long_add(pages_freed, &pool->stats.pages_compacted);
+	atomic_set(&pool->compaction_in_progress, 0);
+
+	pool->compact_runs++;
+	/* Continue in the next interval, which bounds the time we take */
+	if (over_budget) {
+		pool->compact_budget_hits++;
+		queue_delayed_work(system_unbound_wq, &pool->compact_work,
+				   ZS_COMPACT_INTERVAL);
+	}
+}
+
 void zs_pool_stats(struct zs_pool *pool, struct zs_pool_stats *stats)
 {
 	memcpy(stats, &pool->stats, sizeof(struct zs_pool_stats));
@@ -2129,6 +2250,7 @@ struct zs_pool *zs_create_pool(const char *name)
 	init_deferred_free(pool);
 	rwlock_init(&pool->migrate_lock);
 	atomic_set(&pool->compaction_in_progress, 0);
+	INIT_DELAYED_WORK(&pool->compact_work, zs_compact_work);
 
 	pool->name = kstrdup(name, GFP_KERNEL);
 	if (!pool->name)
@@ -2234,6 +2356,7 @@ void zs_destroy_pool(struct zs_pool *pool)
 {
 	int i;
 
+	cancel_delayed_work_sync(&pool->compact_work);
 	zs_unregister_shrinker(pool);
 	zs_flush_migration(pool);
 	zs_pool_stat_destroy(pool);
@@ -69,6 +69,19 @@ static u64 zswap_reject_alloc_fail;
 /* Store failed because the entry metadata could not be allocated (rare) */
 static u64 zswap_reject_kmemcache_fail;
 
+/*
+ * Latency of compressing and decompressing one batch of pages. Bucket 0
+ * counts batches below 1us, bucket n those below 2^n us.
+ */
+#define ZSWAP_LATENCY_BUCKETS 16
+
+struct zswap_latency {
+	atomic_long_t buckets[ZSWAP_LATENCY_BUCKETS];
+};
+
+static struct zswap_latency zswap_store_latency;
+static struct zswap_latency zswap_load_latency;
+
 /* Shrinker work queue */
 static struct workqueue_struct *shrink_wq;
 /* Pool limit was hit, we need to calm down */
@@ -143,11 +156,17 @@ bool zswap_never_enabled(void)
 * data structures
 **********************************/
 
+/* Pages compressed or decompressed together in one batch */
+#define ZSWAP_MAX_BATCH 8
+
 struct crypto_acomp_ctx {
 	struct crypto_acomp *acomp;
-	struct acomp_req *req;
-	struct crypto_wait wait;
-	u8 *buffer;
+	struct acomp_req *reqs[ZSWAP_MAX_BATCH];
+	struct crypto_wait waits[ZSWAP_MAX_BATCH];
+	u8 *buffers[ZSWAP_MAX_BATCH];
+	struct scatterlist inputs[ZSWAP_MAX_BATCH];
+	struct scatterlist outputs[ZSWAP_MAX_BATCH];
+	unsigned int nr_reqs;
 	struct mutex mutex;
 	bool is_sleepable;
 };
@@ -817,55 +836,77 @@ static void zswap_entry_free(struct zswap_entry *entry)
 /*********************************
 * compressed storage functions
 **********************************/
+static void zswap_acomp_ctx_free(struct crypto_acomp_ctx *acomp_ctx)
+{
+	unsigned int i;
+
+	for (i = 0; i < ZSWAP_MAX_BATCH; i++) {
+		if (!IS_ERR_OR_NULL(acomp_ctx->reqs[i]))
+			acomp_request_free(acomp_ctx->reqs[i]);
+		acomp_ctx->reqs[i] = NULL;
+		kfree(acomp_ctx->buffers[i]);
+		acomp_ctx->buffers[i] = NULL;
+	}
+	if (!IS_ERR_OR_NULL(acomp_ctx->acomp))
+		crypto_free_acomp(acomp_ctx->acomp);
+	acomp_ctx->acomp = NULL;
+}
+
 static int zswap_cpu_comp_prepare(unsigned int cpu, struct hlist_node *node)
 {
 	struct zswap_pool *pool = hlist_entry(node, struct zswap_pool, node);
 	struct crypto_acomp_ctx *acomp_ctx = per_cpu_ptr(pool->acomp_ctx, cpu);
 	struct crypto_acomp *acomp;
-	struct acomp_req *req;
-	int ret;
+	unsigned int i;
 
 	mutex_init(&acomp_ctx->mutex);
 
-	acomp_ctx->buffer = kmalloc_node(PAGE_SIZE * 2, GFP_KERNEL, cpu_to_node(cpu));
-	if (!acomp_ctx->buffer)
-		return -ENOMEM;
-
 	acomp = crypto_alloc_acomp_node(pool->tfm_name, 0, 0, cpu_to_node(cpu));
 	if (IS_ERR(acomp)) {
 		pr_err("could not alloc crypto acomp %s : %ld\n",
 				pool->tfm_name, PTR_ERR(acomp));
-		ret = PTR_ERR(acomp);
-		goto acomp_fail;
+		return PTR_ERR(acomp);
 	}
 	acomp_ctx->acomp = acomp;
 	acomp_ctx->is_sleepable = acomp_is_async(acomp);
 
-	req = acomp_request_alloc(acomp_ctx->acomp);
-	if (!req) {
-		pr_err("could not alloc crypto acomp_request %s\n",
-		       pool->tfm_name);
-		ret = -ENOMEM;
-		goto req_fail;
-	}
-	acomp_ctx->req = req;
-
-	crypto_init_wait(&acomp_ctx->wait);
 	/*
-	 * if the backend of acomp is async zip, crypto_req_done() will wakeup
-	 * crypto_wait_req(); if the backend of acomp is scomp, the callback
-	 * won't be called, crypto_wait_req() will return without blocking.
+	 * An asynchronous (hardware) compressor works on a whole batch of
+	 * pages in parallel, so it gets a request and a buffer per page. A
+	 * synchronous one compresses in the calling context and only needs
+	 * one.
 	 */
-	acomp_request_set_callback(req, CRYPTO_TFM_REQ_MAY_BACKLOG,
-				   crypto_req_done, &acomp_ctx->wait);
+	acomp_ctx->nr_reqs = acomp_is_async(acomp) ? ZSWAP_MAX_BATCH : 1;
+
+	for (i = 0; i < acomp_ctx->nr_reqs; i++) {
+		acomp_ctx->buffers[i] = kmalloc_node(PAGE_SIZE * 2, GFP_KERNEL,
+						     cpu_to_node(cpu));
+		if (!acomp_ctx->buffers[i])
+			goto fail;
+
+		acomp_ctx->reqs[i] = acomp_request_alloc(acomp);
+		if (!acomp_ctx->reqs[i]) {
+			pr_err("could not alloc crypto acomp_request %s\n",
+			       pool->tfm_name);
+			goto fail;
+		}
+
+		crypto_init_wait(&acomp_ctx->waits[i]);
+		/*
+		 * if the backend of acomp is async zip, crypto_req_done() will wakeup
+		 * crypto_wait_req(); if the backend of acomp is scomp, the callback
+		 * won't be called, crypto_wait_req() will return without blocking.
+		 */
+		acomp_request_set_callback(acomp_ctx->reqs[i],
+					   CRYPTO_TFM_REQ_MAY_BACKLOG,
+					   crypto_req_done, &acomp_ctx->waits[i]);
+	}
 
 	return 0;
 
-req_fail:
-	crypto_free_acomp(acomp_ctx->acomp);
-acomp_fail:
-	kfree(acomp_ctx->buffer);
-	return ret;
+fail:
+	zswap_acomp_ctx_free(acomp_ctx);
+	return -ENOMEM;
 }
 
 static int zswap_cpu_comp_dead(unsigned int cpu, struct hlist_node *node)
@@ -873,78 +914,105 @@ static int zswap_cpu_comp_dead(unsigned int cpu, struct hlist_node *node)
 	struct zswap_pool *pool = hlist_entry(node, struct zswap_pool, node);
 	struct crypto_acomp_ctx *acomp_ctx = per_cpu_ptr(pool->acomp_ctx, cpu);
 
-	if (!IS_ERR_OR_NULL(acomp_ctx)) {
-		if (!IS_ERR_OR_NULL(acomp_ctx->req))
-			acomp_request_free(acomp_ctx->req);
-		if (!IS_ERR_OR_NULL(acomp_ctx->acomp))
-			crypto_free_acomp(acomp_ctx->acomp);
-		kfree(acomp_ctx->buffer);
-	}
+	if (!IS_ERR_OR_NULL(acomp_ctx))
+		zswap_acomp_ctx_free(acomp_ctx);
 
 	return 0;
 }
 
-static bool zswap_compress(struct folio *folio, struct zswap_entry *entry)
+static void zswap_account_latency(struct zswap_latency *lat, u64 start)
+{
+	u64 us = div_u64(ktime_get_ns() - start, NSEC_PER_USEC);
+	unsigned int bucket = 0;
+
+	if (us)
+		bucket = min_t(unsigned int, ilog2(us) + 1,
+			       ZSWAP_LATENCY_BUCKETS - 1);
+	atomic_long_inc(&lat->buckets[bucket]);
+}
+
+/*
+ * Compress @nr pages into the zpool of @pool, filling in @entries. Each
+ * entry that got stored takes a pool reference; on failure the caller
+ * releases those with zswap_entry_discard().
+ */
+static bool zswap_compress(struct page **pages, struct zswap_entry **entries,
+			   unsigned int nr, struct zswap_pool *pool)
 {
 	struct crypto_acomp_ctx *acomp_ctx;
-	struct scatterlist input, output;
+	int errs[ZSWAP_MAX_BATCH];
 	int comp_ret = 0, alloc_ret = 0;
-	unsigned int dlen = PAGE_SIZE;
+	struct zpool *zpool = pool->zpool;
+	unsigned int i, j, batch;
+	u64 start = ktime_get_ns();
 	unsigned long handle;
-	struct zpool *zpool;
 	char *buf;
 	gfp_t gfp;
-	u8 *dst;
 
-	acomp_ctx = raw_cpu_ptr(entry->pool->acomp_ctx);
-
-	mutex_lock(&acomp_ctx->mutex);
+	gfp = __GFP_NORETRY | __GFP_NOWARN | __GFP_KSWAPD_RECLAIM;
+	if (zpool_malloc_support_movable(zpool))
+		gfp |= __GFP_HIGHMEM | __GFP_MOVABLE;
 
-	dst = acomp_ctx->buffer;
-	sg_init_table(&input, 1);
-	sg_set_folio(&input, folio, PAGE_SIZE, 0);
+	acomp_ctx = raw_cpu_ptr(pool->acomp_ctx);
 
-	/*
-	 * We need PAGE_SIZE * 2 here since there maybe over-compression case,
-	 * and hardware-accelerators may won't check the dst buffer size, so
-	 * giving the dst buffer with enough length to avoid buffer overflow.
-	 */
-	sg_init_one(&output, dst, PAGE_SIZE * 2);
-	acomp_request_set_params(acomp_ctx->req, &input, &output, PAGE_SIZE, dlen);
+	mutex_lock(&acomp_ctx->mutex);
 
-	/*
-	 * it maybe looks a little bit silly that we send an asynchronous request,
-	 * then wait for its completion synchronously. This makes the process look
-	 * synchronous in fact.
-	 * Theoretically, acomp supports users send multiple acomp requests in one
-	 * acomp instance, then get those requests done simultaneously. but in this
-	 * case, zswap actually does store and load page by page, there is no
-	 * existing method to send the second page before the first page is done
-	 * in one thread doing zwap.
-	 * but in different threads running on different cpu, we have different
-	 * acomp instance, so multiple threads can do (de)compression in parallel.
-	 */
-	comp_ret = crypto_wait_req(crypto_acomp_compress(acomp_ctx->req), &acomp_ctx->wait);
-	dlen = acomp_ctx->req->dlen;
-	if (comp_ret)
-		goto unlock;
+	for (i = 0; i < nr && !comp_ret && !alloc_ret; i += batch) {
+		batch = min(nr - i, acomp_ctx->nr_reqs);
 
-	zpool = entry->pool->zpool;
-	gfp = __GFP_NORETRY | __GFP_NOWARN | __GFP_KSWAPD_RECLAIM;
-	if (zpool_malloc_support_movable(zpool))
-		gfp |= __GFP_HIGHMEM | __GFP_MOVABLE;
-	alloc_ret = zpool_malloc(zpool, dlen, gfp, &handle);
-	if (alloc_ret)
-		goto unlock;
+		/*
+		 * Submit every request of the batch before waiting for any of
+		 * them, so that an asynchronous compressor can work on all pages
+		 * at once. A synchronous one completes each request right away.
+		 *
+		 * We need PAGE_SIZE * 2 here since there maybe over-compression
+		 * case, and hardware-accelerators may won't check the dst buffer
+		 * size, so giving the dst buffer with enough length to avoid
+		 * buffer overflow.
+		 */
+		for (j = 0; j < batch; j++) {
+			sg_init_table(&acomp_ctx->inputs[j], 1);
+			sg_set_page(&acomp_ctx->inputs[j], pages[i + j],
+				    PAGE_SIZE, 0);
+			sg_init_one(&acomp_ctx->outputs[j], acomp_ctx->buffers[j],
+				    PAGE_SIZE * 2);
+			acomp_request_set_params(acomp_ctx->reqs[j],
+						 &acomp_ctx->inputs[j],
+						 &acomp_ctx->outputs[j],
+						 PAGE_SIZE, PAGE_SIZE);
+			errs[j] = crypto_acomp_compress(acomp_ctx->reqs[j]);
+		}
 
-	buf = zpool_map_handle(zpool, handle, ZPOOL_MM_WO);
-	memcpy(buf, dst, dlen);
-	zpool_unmap_handle(zpool, handle);
+		/* Wait for all requests, even after one of them failed */
+		for (j = 0; j < batch; j++) {
+			struct zswap_entry *entry = entries[i + j];
+			unsigned int dlen;
+
+			errs[j] = crypto_wait_req(errs[j], &acomp_ctx->waits[j]);
+			if (!comp_ret)
+				comp_ret = errs[j];
+			if (comp_ret || alloc_ret)
+				continue;
+
+			dlen = acomp_ctx->reqs[j]->dlen;
+			alloc_ret = zpool_malloc(zpool, dlen, gfp, &handle);
+			if (alloc_ret)
+				continue;
+
+			buf = zpool_map_handle(zpool, handle, ZPOOL_MM_WO);
+			memcpy(buf, acomp_ctx->buffers[j], dlen);
+			zpool_unmap_handle(zpool, handle);
+
+			/* The caller holds a reference, this can't fail */
+			WARN_ON_ONCE(!zswap_pool_get(pool));
+			entry->pool = pool;
+			entry->handle = handle;
+			entry->length = dlen;
+		}
+	}
 
-	entry->handle = handle;
-	entry->length = dlen;
+	mutex_unlock(&acomp_ctx->mutex);
 
-unlock:
 	if (comp_ret == -ENOSPC || alloc_ret == -ENOSPC)
 		zswap_reject_compress_poor++;
 	else if (comp_ret)
@@ -952,11 +1020,11 @@ static bool zswap_compress(struct folio *folio, struct zswap_entry *entry)
 	else if (alloc_ret)
 		zswap_reject_alloc_fail++;
 
-	mutex_unlock(&acomp_ctx->mutex);
+	zswap_account_latency(&zswap_store_latency, start);
 	return comp_ret == 0 && alloc_ret == 0;
 }
 
-static void zswap_decompress(struct zswap_entry *entry, struct folio *folio)
+static void zswap_decompress(struct zswap_entry *entry, struct page *page)
 {
 	struct zpool *zpool = entry->pool->zpool;
 	struct scatterlist input, output;
@@ -978,23 +1046,86 @@ static void zswap_decompress(struct zswap_entry *entry, struct folio *folio)
 	 */
 	if ((acomp_ctx->is_sleepable && !zpool_can_sleep_mapped(zpool)) ||
 	    !virt_addr_valid(src)) {
-		memcpy(acomp_ctx->buffer, src, entry->length);
-		src = acomp_ctx->buffer;
+		memcpy(acomp_ctx->buffers[0], src, entry->length);
+		src = acomp_ctx->buffers[0];
 		zpool_unmap_handle(zpool, entry->handle);
 	}
 
 	sg_init_one(&input, src, entry->length);
 	sg_init_table(&output, 1);
-	sg_set_folio(&output, folio, PAGE_SIZE, 0);
-	acomp_request_set_params(acomp_ctx->req, &input, &output, entry->length, PAGE_SIZE);
-	BUG_ON(crypto_wait_req(crypto_acomp_decompress(acomp_ctx->req), &acomp_ctx->wait));
-	BUG_ON(acomp_ctx->req->dlen != PAGE_SIZE);
+	sg_set_page(&output, page, PAGE_SIZE, 0);
+	acomp_request_set_params(acomp_ctx->reqs[0], &input, &output,
+				 entry->length, PAGE_SIZE);
+	BUG_ON(crypto_wait_req(crypto_acomp_decompress(acomp_ctx->reqs[0]),
+			       &acomp_ctx->waits[0]));
+	BUG_ON(acomp_ctx->reqs[0]->dlen != PAGE_SIZE);
 	mutex_unlock(&acomp_ctx->mutex);
 
-	if (src != acomp_ctx->buffer)
+	if (src != acomp_ctx->buffers[0])
 		zpool_unmap_handle(zpool, entry->handle);
 }
 
+/*
+ * Decompress a run of compressed entries from the same pool into the pages
+ * of @folio starting at @index and return how many were done. An
+ * asynchronous compressor gets them submitted as one batch; the compressed
+ * data is copied to its buffers first as only one zpool handle can be mapped
+ * at a time.
+ */
+static unsigned int zswap_decompress_pages(struct zswap_entry **entries,
+					   unsigned int nr, struct folio *folio,
+					   long index)
+{
+	struct zswap_pool *pool = entries[0]->pool;
+	struct zpool *zpool = pool->zpool;
+	struct crypto_acomp_ctx *acomp_ctx;
+	int errs[ZSWAP_MAX_BATCH];
+	unsigned int i, batch;
+	u64 start = ktime_get_ns();
+	u8 *src;
+
+	acomp_ctx = raw_cpu_ptr(pool->acomp_ctx);
+	if (acomp_ctx->nr_reqs == 1) {
+		zswap_decompress(entries[0], folio_page(folio, index));
+		batch = 1;
+		goto out;
+	}
+
+	mutex_lock(&acomp_ctx->mutex);
+
+	for (batch = 0; batch < min(nr, acomp_ctx->nr_reqs); batch++) {
+		struct zswap_entry *entry = entries[batch];
+
+		if (!entry->length || entry->pool != pool)
+			break;
+
+		src = zpool_map_handle(zpool, entry->handle, ZPOOL_MM_RO);
+		memcpy(acomp_ctx->buffers[batch], src, entry->length);
+		zpool_unmap_handle(zpool, entry->handle);
+
+		sg_init_one(&acomp_ctx->inputs[batch], acomp_ctx->buffers[batch],
+			    entry->length);
+		sg_init_table(&acomp_ctx->outputs[batch], 1);
+		sg_set_page(&acomp_ctx->outputs[batch],
+			    folio_page(folio, index + batch), PAGE_SIZE, 0);
+		acomp_request_set_params(acomp_ctx->reqs[batch],
+					 &acomp_ctx->inputs[batch],
+					 &acomp_ctx->outputs[batch],
+					 entry->length, PAGE_SIZE);
+		errs[batch] = crypto_acomp_decompress(acomp_ctx->reqs[batch]);
+	}
+
+	for (i = 0; i < batch; i++) {
+		BUG_ON(crypto_wait_req(errs[i], &acomp_ctx->waits[i]));
+		BUG_ON(acomp_ctx->reqs[i]->dlen != PAGE_SIZE);
+	}
+
+	mutex_unlock(&acomp_ctx->mutex);
+out:
+	zswap_account_latency(&zswap_load_latency, start);
+	return batch;
+}
+
 /*********************************
 * writeback code
 **********************************/
@@ -1058,7 +1189,7 @@ static int zswap_writeback_entry(struct zswap_entry *entry,
 		return -ENOMEM;
 	}
 
-	zswap_decompress(entry, folio);
+	zswap_decompress(entry, &folio->page);
 
 	count_vm_event(ZSWPWB);
 	if (entry->objcg)
@@ -1358,14 +1489,14 @@ static void shrink_worker(struct work_struct *w)
 /*********************************
 * same-filled functions
 **********************************/
-static bool zswap_is_folio_same_filled(struct folio *folio, unsigned long *value)
+static bool zswap_is_page_same_filled(struct page *page, unsigned long *value)
 {
 	unsigned long *data;
 	unsigned long val;
 	unsigned int pos, last_pos = PAGE_SIZE / sizeof(*data) - 1;
 	bool ret = false;
 
-	data = kmap_local_folio(folio, 0);
+	data = kmap_local_page(page);
 	val = data[0];
 
 	if (val != data[last_pos])
@@ -1383,34 +1514,145 @@ static bool zswap_is_folio_same_filled(struct folio *folio, unsigned long *value
 	return ret;
 }
 
-static void zswap_fill_folio(struct folio *folio, unsigned long value)
+static void zswap_fill_page(struct page *page, unsigned long value)
 {
-	unsigned long *data = kmap_local_folio(folio, 0);
+	unsigned long *data = kmap_local_page(page);
 
 	memset_l(data, value, PAGE_SIZE / sizeof(unsigned long));
 	kunmap_local(data);
 }
 
+/* Free an entry that never made it into the tree */
+static void zswap_entry_discard(struct zswap_entry *entry)
+{
+	if (entry->length) {
+		zpool_free(entry->pool->zpool, entry->handle);
+		zswap_pool_put(entry->pool);
+	}
+	zswap_entry_cache_free(entry);
+}
+
+/*
+ * Store @nr pages of @folio starting at @index. Same filled pages are
+ * recorded as such, all others are compressed as one batch. On failure,
+ * entries that already made it into the tree are left for the caller to
+ * invalidate.
+ */
+static bool zswap_store_pages(struct folio *folio, long index, unsigned int nr,
+			      struct obj_cgroup *objcg, struct zswap_pool *pool)
+{
+	struct zswap_entry *entries[ZSWAP_MAX_BATCH];
+	struct zswap_entry *compress[ZSWAP_MAX_BATCH];
+	struct page *pages[ZSWAP_MAX_BATCH];
+	unsigned int i, nr_compress = 0;
+
+	for (i = 0; i < nr; i++) {
+		struct page *page = folio_page(folio, index + i);
+		struct zswap_entry *entry;
+		unsigned long value;
+
+		entry = zswap_entry_cache_alloc(GFP_KERNEL, folio_nid(folio));
+		if (!entry) {
+			zswap_reject_kmemcache_fail++;
+			nr = i;
+			goto discard;
+		}
+
+		entries[i] = entry;
+		entry->length = 0;
+		if (zswap_is_page_same_filled(page, &value)) {
+			entry->value = value;
+		} else {
+			pages[nr_compress] = page;
+			compress[nr_compress++] = entry;
+		}
+	}
+
+	if (nr_compress && !zswap_compress(pages, compress, nr_compress, pool))
+		goto discard;
+
+	for (i = 0; i < nr; i++) {
+		struct zswap_entry *entry = entries[i], *old;
+		swp_entry_t swp = folio->swap;
+
+		swp = swp_entry(swp_type(swp), swp_offset(swp) + index + i);
+		entry->swpentry = swp;
+		entry->objcg = objcg;
+
+		old = xa_store(swap_zswap_tree(swp), swp_offset(swp), entry,
+			       GFP_KERNEL);
+		if (xa_is_err(old)) {
+			int err = xa_err(old);
+
+			WARN_ONCE(err != -ENOMEM, "unexpected xarray error: %d\n", err);
+			zswap_reject_alloc_fail++;
+			goto discard_from;
+		}
+
+		/*
+		 * We may have had an existing entry that became stale when
+		 * the folio was redirtied and now the new version is being
+		 * swapped out. Get rid of the old.
+		 */
+		if (old)
+			zswap_entry_free(old);
+
+		if (objcg) {
+			obj_cgroup_get(objcg);
+			obj_cgroup_charge_zswap(objcg, entry->length);
+			count_objcg_event(objcg, ZSWPOUT);
+		}
+
+		/*
+		 * We finish initializing the entry while it's already in xarray.
+		 * This is safe because:
+		 *
+		 * 1. Concurrent stores and invalidations are excluded by folio lock.
+		 *
+		 * 2. Writeback is excluded by the entry not being on the LRU yet.
+		 *    The publishing order matters to prevent writeback from seeing
+		 *    an incoherent entry.
+		 */
+		if (entry->length) {
+			INIT_LIST_HEAD(&entry->lru);
+			zswap_lru_add(&zswap_list_lru, entry);
+		} else {
+			atomic_inc(&zswap_same_filled_pages);
+		}
+
+		/* update stats */
+		atomic_inc(&zswap_stored_pages);
+		count_vm_event(ZSWPOUT);
+	}
+
+	return true;
+
+discard:
+	i = 0;
+discard_from:
+	for (; i < nr; i++)
+		zswap_entry_discard(entries[i]);
+	return false;
+}
+
 /*********************************
 * main API
 **********************************/
 bool zswap_store(struct folio *folio)
 {
+	long nr_pages = folio_nr_pages(folio);
 	swp_entry_t swp = folio->swap;
 	pgoff_t offset = swp_offset(swp);
 	struct xarray *tree = swap_zswap_tree(swp);
-	struct zswap_entry *entry, *old;
 	struct obj_cgroup *objcg = NULL;
 	struct mem_cgroup *memcg = NULL;
-	unsigned long value;
+	struct zswap_pool *pool;
+	struct zswap_entry *entry;
+	long index;
 
 	VM_WARN_ON_ONCE(!folio_test_locked(folio));
 	VM_WARN_ON_ONCE(!folio_test_swapcache(folio));
 
-	/* Large folios aren't supported */
-	if (folio_test_large(folio))
-		return false;
-
 	if (!zswap_enabled)
 		goto check_old;
 
@@ -1428,24 +1670,10 @@ bool zswap_store(struct folio *folio)
 	if (zswap_check_limits())
 		goto reject;
 
-	/* allocate entry */
-	entry = zswap_entry_cache_alloc(GFP_KERNEL, folio_nid(folio));
-	if (!entry) {
-		zswap_reject_kmemcache_fail++;
+	/* every compressed entry takes its own reference */
+	pool = zswap_pool_current_get();
+	if (!pool)
 		goto reject;
-	}
-
-	if (zswap_is_folio_same_filled(folio, &value)) {
-		entry->length = 0;
-		entry->value = value;
-		atomic_inc(&zswap_same_filled_pages);
-		goto store_entry;
-	}
-
-	/* if entry is successfully added, it keeps the reference */
-	entry->pool = zswap_pool_current_get();
-	if (!entry->pool)
-		goto freepage;
 
 	if (objcg) {
 		memcg = get_mem_cgroup_from_objcg(objcg);
@@ -1456,66 +1684,24 @@ bool zswap_store(struct folio *folio)
 		mem_cgroup_put(memcg);
 	}
 
-	if (!zswap_compress(folio, entry))
-		goto put_pool;
-
-store_entry:
-	entry->swpentry = swp;
-	entry->objcg = objcg;
-
-	old = xa_store(tree, offset, entry, GFP_KERNEL);
-	if (xa_is_err(old)) {
-		int err = xa_err(old);
-
-		WARN_ONCE(err != -ENOMEM, "unexpected xarray error: %d\n", err);
-		zswap_reject_alloc_fail++;
-		goto store_failed;
-	}
-
 	/*
-	 * We may have had an existing entry that became stale when
-	 * the folio was redirtied and now the new version is being
-	 * swapped out. Get rid of the old.
+	 * The subpages of a large folio are stored as separate entries, a
+	 * batch of them at a time. Swap entries of a large folio are
+	 * naturally aligned, so they all live in the same tree.
 	 */
-	if (old)
-		zswap_entry_free(old);
-
-	if (objcg) {
-		obj_cgroup_charge_zswap(objcg, entry->length);
-		count_objcg_event(objcg, ZSWPOUT);
-	}
+	for (index = 0; index < nr_pages; index += ZSWAP_MAX_BATCH) {
+		unsigned int nr = min_t(long, nr_pages - index, ZSWAP_MAX_BATCH);
 
-	/*
-	 * We finish initializing the entry while it's already in xarray.
-	 * This is safe because:
-	 *
-	 * 1. Concurrent stores and invalidations are excluded by folio lock.
-	 *
-	 * 2. Writeback is excluded by the entry not being on the LRU yet.
-	 *    The publishing order matters to prevent writeback from seeing
-	 *    an incoherent entry.
-	 */
-	if (entry->length) {
-		INIT_LIST_HEAD(&entry->lru);
-		zswap_lru_add(&zswap_list_lru, entry);
+		if (!zswap_store_pages(folio, index, nr, objcg, pool))
+			goto put_pool;
 	}
 
-	/* update stats */
-	atomic_inc(&zswap_stored_pages);
-	count_vm_event(ZSWPOUT);
-
+	zswap_pool_put(pool);
+	obj_cgroup_put(objcg);
 	return true;
 
-store_failed:
-	if (!entry->length)
-		atomic_dec(&zswap_same_filled_pages);
-	else {
-		zpool_free(entry->pool->zpool, entry->handle);
 put_pool:
-		zswap_pool_put(entry->pool);
-	}
-freepage:
-	zswap_entry_cache_free(entry);
+	zswap_pool_put(pool);
 reject:
 	obj_cgroup_put(objcg);
 	if (zswap_pool_reached_full)
@@ -1523,22 +1709,51 @@ bool zswap_store(struct folio *folio)
 check_old:
 	/*
 	 * If the zswap store fails or zswap is disabled, we must invalidate the
-	 * possibly stale entry which was previously stored at this offset.
-	 * Otherwise, writeback could overwrite the new data in the swapfile.
+	 * possibly stale entries which were previously stored at the offsets of
+	 * the folio, as well as those stored before the failure. Otherwise,
+	 * writeback could overwrite the new data in the swapfile.
 	 */
-	entry = xa_erase(tree, offset);
-	if (entry)
-		zswap_entry_free(entry);
+	for (index = 0; index < nr_pages; index++) {
+		entry = xa_erase(tree, offset + index);
+		if (entry)
+			zswap_entry_free(entry);
+	}
 	return false;
 }
 
+static void zswap_load_entries(struct zswap_entry **entries, unsigned int nr,
+			       struct folio *folio, long index)
+{
+	unsigned int i, done;
+
+	for (i = 0; i < nr; i += done) {
+		if (!entries[i]->length) {
+			zswap_fill_page(folio_page(folio, index + i),
+					entries[i]->value);
+			done = 1;
+		} else {
+			done = zswap_decompress_pages(&entries[i], nr - i, folio,
+						      index + i);
+		}
+	}
+
+	for (i = 0; i < nr; i++) {
+		count_vm_event(ZSWPIN);
+		if (entries[i]->objcg)
+			count_objcg_event(entries[i]->objcg, ZSWPIN);
+	}
+}
+
 bool zswap_load(struct folio *folio)
 {
+	long nr_pages = folio_nr_pages(folio);
 	swp_entry_t swp = folio->swap;
 	pgoff_t offset = swp_offset(swp);
 	bool swapcache = folio_test_swapcache(folio);
 	struct xarray *tree = swap_zswap_tree(swp);
-	struct zswap_entry *entry;
+	struct zswap_entry *entries[ZSWAP_MAX_BATCH];
+	long index, nr_present = 0;
+	unsigned int i, nr;
 
 	VM_WARN_ON_ONCE(!folio_test_locked(folio));
 
@@ -1546,18 +1761,22 @@ bool zswap_load(struct folio *folio)
 		return false;
 
 	/*
-	 * Large folios should not be swapped in while zswap is being used, as
-	 * they are not properly handled. Zswap does not properly load large
-	 * folios, and a large folio may only be partially in zswap.
+	 * A large folio can only be loaded if all of its subpages are in
+	 * zswap. If only some are, the rest is on the swap device and the
+	 * folio can't be read from either.
 	 *
 	 * Return true without marking the folio uptodate so that an IO error is
 	 * emitted (e.g. do_swap_page() will sigbus).
 	 */
-	if (WARN_ON_ONCE(folio_test_large(folio)))
+	for (index = 0; index < nr_pages; index++)
+		nr_present += !!xa_load(tree, offset + index);
+	if (!nr_present)
+		return false;
+	if (WARN_ON_ONCE(nr_present != nr_pages))
 		return true;
 
 	/*
-	 * When reading into the swapcache, invalidate our entry. The
+	 * When reading into the swapcache, invalidate our entries. The
 	 * swapcache can be the authoritative owner of the page and
 	 * its mappings, and the pressure that results from having two
 	 * in-memory copies outweighs any benefits of caching the
@@ -1568,27 +1787,29 @@ bool zswap_load(struct folio *folio)
 	 * files, which reads into a private page and may free it if
 	 * the fault fails. We remain the primary owner of the entry.)
 	 */
-	if (swapcache)
-		entry = xa_erase(tree, offset);
-	else
-		entry = xa_load(tree, offset);
+	for (index = 0; index < nr_pages; index += nr) {
+		nr = min_t(long, nr_pages - index, ZSWAP_MAX_BATCH);
+
+		for (i = 0; i < nr; i++) {
+			if (swapcache)
+				entries[i] = xa_erase(tree, offset + index + i);
+			else
+				entries[i] = xa_load(tree, offset + index + i);
+			/* The folio lock keeps the entries from going away */
+			if (WARN_ON_ONCE(!entries[i]))
+				return true;
+		}
 
-	if (!entry)
-		return false;
+		zswap_load_entries(entries, nr, folio, index);
 
-	if (entry->length)
-		zswap_decompress(entry, folio);
-	else
-		zswap_fill_folio(folio, entry->value);
-
-	count_vm_event(ZSWPIN);
-	if (entry->objcg)
-		count_objcg_event(entry->objcg, ZSWPIN);
+		if (swapcache) {
+			for (i = 0; i < nr; i++)
+				zswap_entry_free(entries[i]);
+		}
+	}
 
-	if (swapcache) {
-		zswap_entry_free(entry);
+	if (swapcache)
 		folio_mark_dirty(folio);
-	}
 
 	folio_mark_uptodate(folio);
 	return true;
@@ -1657,6 +1878,20 @@ static int debugfs_get_total_size(void *data, u64 *val)
 }
 DEFINE_DEBUGFS_ATTRIBUTE(total_size_fops, debugfs_get_total_size, NULL, "%llu\n");
 
+static int zswap_latency_show(struct seq_file *m, void *v)
+{
+	struct zswap_latency *lat = m->private;
+	int i;
+
+	for (i = 0; i < ZSWAP_LATENCY_BUCKETS - 1; i++)
+		seq_printf(m, "<%lluus %ld\n", 1ULL << i,
+			   atomic_long_read(&lat->buckets[i]));
+	seq_printf(m, ">=%lluus %ld\n", 1ULL << (i - 1),
+		   atomic_long_read(&lat->buckets[i]));
+	return 0;
+}
+DEFINE_SHOW_ATTRIBUTE(zswap_latency);
+
 static int zswap_debugfs_init(void)
 {
 	if (!debugfs_initialized())
@@ -1684,6 +1919,10 @@ static int zswap_debugfs_init(void)
 				zswap_debugfs_root, &zswap_stored_pages);
 	debugfs_create_atomic_t("same_filled_pages", 0444,
 				zswap_debugfs_root, &zswap_same_filled_pages);
+	debugfs_create_file("store_batch_latency", 0444, zswap_debugfs_root,
+			    &zswap_store_latency, &zswap_latency_fops);
+	debugfs_create_file("load_batch_latency", 0444, zswap_debugfs_root,
+			    &zswap_load_latency, &zswap_latency_fops);
 
 	return 0;
 }
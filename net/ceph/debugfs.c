@@ -339,6 +339,23 @@ static void dump_backoffs(struct seq_file *s, struct ceph_osd *osd)
 	mutex_unlock(&osd->lock);
 }
 
+static void dump_latency(struct seq_file *s, struct ceph_osd_client *osdc)
+{
+	int i;
+
+	seq_puts(s, "LATENCY\n");
+	seq_puts(s, "<usecs\tread\twrite\n");
+	for (i = 0; i < CEPH_OSDC_LAT_BUCKETS; i++) {
+		if (i == CEPH_OSDC_LAT_BUCKETS - 1)
+			seq_puts(s, "inf");
+		else
+			seq_printf(s, "%llu", 1ULL << i);
+		seq_printf(s, "\t%lld\t%lld\n",
+			   atomic64_read(&osdc->read_lat_hist[i]),
+			   atomic64_read(&osdc->write_lat_hist[i]));
+	}
+}
+
 static int osdc_show(struct seq_file *s, void *pp)
 {
 	struct ceph_client *client = s->private;
@@ -372,6 +389,8 @@ static int osdc_show(struct seq_file *s, void *pp)
 	}
 
 	up_read(&osdc->lock);
+
+	dump_latency(s, osdc);
 	return 0;
 }
 
@@ -2507,6 +2507,21 @@ static void submit_request(struct ceph_osd_request *req, bool wrlocked)
 	__submit_request(req, wrlocked);
 }
 
+static void account_latency(struct ceph_osd_request *req)
+{
+	struct ceph_osd_client *osdc = req->r_osdc;
+	s64 us = ktime_us_delta(req->r_end_latency, req->r_start_latency);
+	int bucket = 0;
+
+	if (us > 0)
+		bucket = min(ilog2(us) + 1, CEPH_OSDC_LAT_BUCKETS - 1);
+
+	if (req->r_flags & CEPH_OSD_FLAG_WRITE)
+		atomic64_inc(&osdc->write_lat_hist[bucket]);
+	else
+		atomic64_inc(&osdc->read_lat_hist[bucket]);
+}
+
 static void finish_request(struct ceph_osd_request *req)
 {
 	struct ceph_osd_client *osdc = req->r_osdc;
@@ -2515,6 +2530,7 @@ static void finish_request(struct ceph_osd_request *req)
 	dout("%s req %p tid %llu\n", __func__, req, req->r_tid);
 
 	req->r_end_latency = ktime_get();
+	account_latency(req);
 
 	if (req->r_osd) {
 		ceph_init_sparse_read(&req->r_osd->o_sparse_read);
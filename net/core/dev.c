@@ -3778,13 +3778,17 @@ static int dev_qdisc_enqueue(struct sk_buff *skb, struct Qdisc *q,
 	return rc;
 }
 
+/* Max skbs waiting in a qdisc defer_list for the CPU holding its lock */
+#define QDISC_DEFER_MAX		1024
+
 static inline int __dev_xmit_skb(struct sk_buff *skb, struct Qdisc *q,
 				 struct net_device *dev,
 				 struct netdev_queue *txq)
 {
 	spinlock_t *root_lock = qdisc_lock(q);
-	struct sk_buff *to_free = NULL;
-	bool contended;
+	struct llist_node *ll_list, *first_n;
+	struct sk_buff *next, *to_free = NULL;
+	unsigned long defer_count = 0;
 	int rc;
 
 	qdisc_calculate_pkt_len(skb, q);
@@ -3828,63 +3832,85 @@ static inline int __dev_xmit_skb(struct sk_buff *skb, struct Qdisc *q,
 		kfree_skb_reason(skb, SKB_DROP_REASON_TC_RECLASSIFY_LOOP);
 		return NET_XMIT_DROP;
 	}
-	/*
-	 * Heuristic to force contended enqueues to serialize on a
-	 * separate lock before trying to get qdisc main lock.
-	 * This permits qdisc->running owner to get the lock more
-	 * often and dequeue packets faster.
-	 * On PREEMPT_RT it is possible to preempt the qdisc owner during xmit
-	 * and then other tasks will only enqueue packets. The packets will be
-	 * sent after the qdisc owner is scheduled again. To prevent this
-	 * scenario the task always serialize on the lock.
+
+	/* Open code llist_add(&skb->ll_node, &q->defer_list) with a limit.
+	 * Contended senders only push their skb and leave: the CPU that found
+	 * the list empty takes the qdisc lock once and enqueues the whole
+	 * batch, so the lock is not fought over by every sender. Only count
+	 * while the list is not empty, some arches have slow atomics.
 	 */
-	contended = qdisc_is_running(q) || IS_ENABLED(CONFIG_PREEMPT_RT);
-	if (unlikely(contended))
-		spin_lock(&q->busylock);
+	first_n = READ_ONCE(q->defer_list.first);
+	do {
+		if (first_n && !defer_count) {
+			defer_count = atomic_long_inc_return(&q->defer_count);
+			if (unlikely(defer_count > QDISC_DEFER_MAX)) {
+				kfree_skb_reason(skb, SKB_DROP_REASON_QDISC_DROP);
+				return NET_XMIT_DROP;
+			}
+		}
+		skb->ll_node.next = first_n;
+	} while (!try_cmpxchg(&q->defer_list.first, &first_n, &skb->ll_node));
+
+	/* If defer_list was not empty, the CPU which queued the first skb
+	 * will process the whole list for us.
+	 */
+	if (first_n)
+		return NET_XMIT_SUCCESS;
 
 	spin_lock(root_lock);
+
+	ll_list = llist_del_all(&q->defer_list);
+	/* defer_count is not cleared atomically with llist_del_all(), so
+	 * defer_list can grow a little over QDISC_DEFER_MAX.
+	 */
+	atomic_long_set(&q->defer_count, 0);
+
+	ll_list = llist_reverse_order(ll_list);
+
 	if (unlikely(test_bit(__QDISC_STATE_DEACTIVATED, &q->state))) {
-		__qdisc_drop(skb, &to_free);
+		llist_for_each_entry_safe(skb, next, ll_list, ll_node)
+			__qdisc_drop(skb, &to_free);
 		rc = NET_XMIT_DROP;
 	} else if ((q->flags & TCQ_F_CAN_BYPASS) && !qdisc_qlen(q) &&
-		   qdisc_run_begin(q)) {
+		   !llist_next(ll_list) && qdisc_run_begin(q)) {
 		/*
 		 * This is a work-conserving queue; there are no old skbs
 		 * waiting to be sent out; and the qdisc is not running -
 		 * xmit the skb directly.
 		 */
-
+		DEBUG_NET_WARN_ON_ONCE(skb != llist_entry(ll_list,
+							  struct sk_buff,
+							  ll_node));
 		qdisc_bstats_update(q, skb);
 
-		if (sch_direct_xmit(skb, q, dev, txq, root_lock, true)) {
-			if (unlikely(contended)) {
-				spin_unlock(&q->busylock);
-				contended = false;
-			}
+		if (sch_direct_xmit(skb, q, dev, txq, root_lock, true))
 			__qdisc_run(q);
-		}
 
 		qdisc_run_end(q);
 		rc = NET_XMIT_SUCCESS;
 	} else {
+		int count = 0;
+
 		WRITE_ONCE(q->owner, smp_processor_id());
-		rc = dev_qdisc_enqueue(skb, q, &to_free, txq);
+		llist_for_each_entry_safe(skb, next, ll_list, ll_node) {
+			prefetch(next);
+			skb_mark_not_on_list(skb);
+			rc = dev_qdisc_enqueue(skb, q, &to_free, txq);
+			count++;
+		}
 		WRITE_ONCE(q->owner, -1);
 		if (qdisc_run_begin(q)) {
-			if (unlikely(contended)) {
-				spin_unlock(&q->busylock);
-				contended = false;
-			}
 			__qdisc_run(q);
 			qdisc_run_end(q);
 		}
+		/* Other senders already got NET_XMIT_SUCCESS for their skbs */
+		if (count != 1)
+			rc = NET_XMIT_SUCCESS;
 	}
 	spin_unlock(root_lock);
 	if (unlikely(to_free))
 		kfree_skb_list_reason(to_free,
 				      tcf_get_drop_reason(to_free));
-	if (unlikely(contended))
-		spin_unlock(&q->busylock);
 	return rc;
 }
 
@@ -4489,6 +4515,100 @@ int __dev_direct_xmit(struct sk_buff *skb, u16 queue_id)
 }
 EXPORT_SYMBOL(__dev_direct_xmit);
 
+/**
+ * __dev_direct_xmit_bulk - __dev_direct_xmit() for several skbs at once
+ * @skbs: skbs to send, all for the same device
+ * @n: number of skbs
+ * @queue_id: TX queue to send them on
+ * @done: set to the number of skbs consumed, sent or dropped
+ *
+ * Hands the skbs to the driver under a single HARD_TX_LOCK, with xmit_more
+ * set on all but the last one, so that the doorbell is rung once per batch.
+ * Stops at the first skb the driver does not accept; skbs[*done..n) are
+ * still owned by the caller. What is left to the caller is always a tail of
+ * @skbs, so that it can undo its per-skb state in reverse order.
+ *
+ * Return: NET_XMIT_DROP if an skb was dropped, else the status of the last
+ * skb handed to the driver.
+ */
+int __dev_direct_xmit_bulk(struct sk_buff **skbs, unsigned int n, u16 queue_id,
+			   unsigned int *done)
+{
+	struct net_device *dev = skbs[0]->dev;
+	struct sk_buff *skb, *drop = NULL;
+	bool dropped = false, vfail = false;
+	struct netdev_queue *txq;
+	int ret = NETDEV_TX_OK;
+	unsigned int i;
+
+	*done = 0;
+	if (unlikely(!netif_running(dev) ||
+		     !netif_carrier_ok(dev))) {
+		dev_core_stats_tx_dropped_inc(dev);
+		kfree_skb(skbs[0]);
+		*done = 1;
+		return NET_XMIT_DROP;
+	}
+
+	/* Validate before taking the lock, as sch_direct_xmit() does. An skb
+	 * that fails is freed by validation, so only send what precedes it.
+	 */
+	for (i = 0; i < n; i++) {
+		bool again = false;
+
+		skb = validate_xmit_skb_list(skbs[i], dev, &again);
+		if (unlikely(skb != skbs[i])) {
+			drop = skb;
+			vfail = true;
+			n = i;
+			break;
+		}
+		skb_set_queue_mapping(skb, queue_id);
+	}
+
+	txq = netdev_get_tx_queue(dev, queue_id);
+
+	local_bh_disable();
+
+	dev_xmit_recursion_inc();
+	HARD_TX_LOCK(dev, txq, smp_processor_id());
+	for (i = 0; i < n; i++) {
+		int rc = NETDEV_TX_BUSY;
+
+		if (!netif_xmit_frozen_or_drv_stopped(txq))
+			rc = netdev_start_xmit(skbs[i], dev, txq, i + 1 < n);
+		if (!dev_xmit_complete(rc)) {
+			ret = rc;
+			break;
+		}
+		if (rc == NET_XMIT_DROP)
+			dropped = true;
+		ret = rc;
+	}
+	HARD_TX_UNLOCK(dev, txq);
+	dev_xmit_recursion_dec();
+
+	local_bh_enable();
+
+	if (!vfail) {
+		*done = i;
+		return i == n && dropped ? NET_XMIT_DROP : ret;
+	}
+
+	/* Validation already consumed skbs[n], so the caller can't get back
+	 * what the driver did not take: drop it as well.
+	 */
+	for (; i < n; i++) {
+		dev_core_stats_tx_dropped_inc(dev);
+		kfree_skb(skbs[i]);
+	}
+	dev_core_stats_tx_dropped_inc(dev);
+	kfree_skb_list(drop);
+	*done = n + 1;
+	return NET_XMIT_DROP;
+}
+EXPORT_SYMBOL(__dev_direct_xmit_bulk);
+
 /*************************************************************************
  *			Receiver routines
  *************************************************************************/
@@ -4638,8 +4758,11 @@ static int get_rps_cpu(struct net_device *dev, struct sk_buff *skb,
 		 * This READ_ONCE() pairs with WRITE_ONCE() from rps_record_sock_flow().
 		 */
 		ident = READ_ONCE(sock_flow_table->ents[hash & sock_flow_table->mask]);
-		if ((ident ^ hash) & ~net_hotdata.rps_cpu_mask)
+		if ((ident ^ hash) & ~net_hotdata.rps_cpu_mask) {
+			if (ident != RPS_NO_CPU)
+				this_cpu_inc(softnet_data.rfs_collision);
 			goto try_rps;
+		}
 
 		next_cpu = ident & net_hotdata.rps_cpu_mask;
 
@@ -4669,6 +4792,10 @@ static int get_rps_cpu(struct net_device *dev, struct sk_buff *skb,
 		}
 
 		if (tcpu < nr_cpu_ids && cpu_online(tcpu)) {
+			if (tcpu == next_cpu)
+				this_cpu_inc(softnet_data.rfs_steered);
+			else
+				this_cpu_inc(softnet_data.rfs_held);
 			*rflowp = rflow;
 			cpu = tcpu;
 			goto done;
@@ -6498,6 +6625,61 @@ void napi_busy_loop(unsigned int napi_id,
 }
 EXPORT_SYMBOL(napi_busy_loop);
 
+/**
+ * napi_suspend_irqs - keep NAPI IRQs masked while the application polls
+ * @napi_id: NAPI to suspend
+ *
+ * Called by a prefer_busy_poll user after a busy poll found events. With
+ * gro_flush_timeout and napi_defer_hard_irqs set, busy_poll_stop() left the
+ * device IRQs masked; push the watchdog out to irq_suspend_timeout so they
+ * stay masked for as long as the application comes back in time. If it
+ * doesn't, the watchdog reschedules the NAPI, which re-arms the IRQs.
+ */
+void napi_suspend_irqs(unsigned int napi_id)
+{
+	struct napi_struct *napi;
+	unsigned long timeout;
+
+	rcu_read_lock();
+	napi = napi_by_id(napi_id);
+	/* Without deferral, busy_poll_stop() already re-armed the IRQs */
+	if (napi && READ_ONCE(napi->dev->napi_defer_hard_irqs) &&
+	    READ_ONCE(napi->dev->gro_flush_timeout)) {
+		timeout = READ_ONCE(napi->dev->irq_suspend_timeout);
+		if (timeout) {
+			set_bit(NAPI_STATE_IRQ_SUSPENDED, &napi->state);
+			WRITE_ONCE(napi->irq_suspends, napi->irq_suspends + 1);
+			hrtimer_start(&napi->timer, ns_to_ktime(timeout),
+				      HRTIMER_MODE_REL_PINNED);
+		}
+	}
+	rcu_read_unlock();
+}
+EXPORT_SYMBOL(napi_suspend_irqs);
+
+/**
+ * napi_resume_irqs - end an IRQ suspension started by napi_suspend_irqs()
+ * @napi_id: NAPI to resume
+ *
+ * Called when a busy poll found no events and the application is about to
+ * sleep: schedule the NAPI so that its next napi_complete_done() re-arms the
+ * device IRQs, instead of waiting for the safety timeout.
+ */
+void napi_resume_irqs(unsigned int napi_id)
+{
+	struct napi_struct *napi;
+
+	rcu_read_lock();
+	napi = napi_by_id(napi_id);
+	if (napi && test_and_clear_bit(NAPI_STATE_IRQ_SUSPENDED, &napi->state)) {
+		local_bh_disable();
+		napi_schedule(napi);
+		local_bh_enable();
+	}
+	rcu_read_unlock();
+}
+EXPORT_SYMBOL(napi_resume_irqs);
+
 #endif /* CONFIG_NET_RX_BUSY_POLL */
 
 static void napi_hash_add(struct napi_struct *napi)
@@ -6538,6 +6720,10 @@ static enum hrtimer_restart napi_watchdog(struct hrtimer *timer)
 
 	napi = container_of(timer, struct napi_struct, timer);
 
+	if (test_and_clear_bit(NAPI_STATE_IRQ_SUSPENDED, &napi->state))
+		WRITE_ONCE(napi->irq_suspend_timeouts,
+			   napi->irq_suspend_timeouts + 1);
+
 	/* Note : we use a relaxed variant of napi_schedule_prep() not setting
 	 * NAPI_STATE_MISSED, since we do not react to a device IRQ.
 	 */
@@ -6559,6 +6745,9 @@ static void init_gro_hash(struct napi_struct *napi)
 		napi->gro_hash[i].count = 0;
 	}
 	napi->gro_bitmask = 0;
+	napi->gro_merged = 0;
+	napi->gro_held = 0;
+	napi->gro_evicted = 0;
 }
 
 int dev_set_threaded(struct net_device *dev, bool threaded)
@@ -6652,6 +6841,8 @@ void netif_napi_add_weight(struct net_device *dev, struct napi_struct *napi,
 	napi->skb = NULL;
 	INIT_LIST_HEAD(&napi->rx_list);
 	napi->rx_count = 0;
+	napi->irq_suspends = 0;
+	napi->irq_suspend_timeouts = 0;
 	napi->poll = poll;
 	if (weight > NAPI_POLL_WEIGHT)
 		netdev_err_once(dev, "%s() called with weight %d\n", __func__,
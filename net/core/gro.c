@@ -537,16 +537,21 @@ static enum gro_result dev_gro_receive(struct napi_struct *napi, struct sk_buff
 		gro_list->count--;
 	}
 
-	if (same_flow)
+	if (same_flow) {
+		napi->gro_merged++;
 		goto ok;
+	}
 
 	if (NAPI_GRO_CB(skb)->flush)
 		goto normal;
 
-	if (unlikely(gro_list->count >= MAX_GRO_SKBS))
+	if (unlikely(gro_list->count >= MAX_GRO_SKBS)) {
 		gro_flush_oldest(napi, &gro_list->list);
-	else
+		napi->gro_evicted++;
+	} else {
 		gro_list->count++;
+	}
+	napi->gro_held++;
 
 	/* Must be called before setting NAPI_GRO_CB(skb)->{age|last} */
 	gro_try_pull_from_frag0(skb);
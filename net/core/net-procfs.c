@@ -143,14 +143,16 @@ static int softnet_seq_show(struct seq_file *seq, void *v)
 	 */
 	seq_printf(seq,
 		   "%08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x %08x "
-		   "%08x %08x\n",
+		   "%08x %08x %08x %08x %08x\n",
 		   sd->processed, atomic_read(&sd->dropped),
 		   sd->time_squeeze, 0,
 		   0, 0, 0, 0, /* was fastroute */
 		   0,	/* was cpu_collision */
 		   sd->received_rps, flow_limit_count,
 		   input_qlen + process_qlen, (int)seq->index,
-		   input_qlen, process_qlen);
+		   input_qlen, process_qlen,
+		   READ_ONCE(sd->rfs_steered), READ_ONCE(sd->rfs_held),
+		   READ_ONCE(sd->rfs_collision));
 	return 0;
 }
 
@@ -188,6 +188,20 @@ netdev_nl_napi_fill_one(struct sk_buff *rsp, struct napi_struct *napi,
 			goto nla_put_failure;
 	}
 
+	if (nla_put_uint(rsp, NETDEV_A_NAPI_GRO_MERGED,
+			 READ_ONCE(napi->gro_merged)) ||
+	    nla_put_uint(rsp, NETDEV_A_NAPI_GRO_HELD,
+			 READ_ONCE(napi->gro_held)) ||
+	    nla_put_uint(rsp, NETDEV_A_NAPI_GRO_EVICTED,
+			 READ_ONCE(napi->gro_evicted)))
+		goto nla_put_failure;
+
+	if (nla_put_uint(rsp, NETDEV_A_NAPI_IRQ_SUSPENDS,
+			 READ_ONCE(napi->irq_suspends)) ||
+	    nla_put_uint(rsp, NETDEV_A_NAPI_IRQ_SUSPEND_TIMEOUTS,
+			 READ_ONCE(napi->irq_suspend_timeouts)))
+		goto nla_put_failure;
+
 	genlmsg_end(rsp, hdr);
 
 	return 0;
@@ -2030,6 +2030,7 @@ static const struct nla_policy ifla_policy[IFLA_MAX+1] = {
 	[IFLA_ALLMULTI]		= { .type = NLA_REJECT },
 	[IFLA_GSO_IPV4_MAX_SIZE]	= { .type = NLA_U32 },
 	[IFLA_GRO_IPV4_MAX_SIZE]	= { .type = NLA_U32 },
+	[IFLA_DUMP_START_IFINDEX]	= NLA_POLICY_MIN(NLA_U32, 1),
 };
 
 static const struct nla_policy ifla_info_policy[IFLA_INFO_MAX+1] = {
@@ -2262,6 +2263,14 @@ static int rtnl_dump_ifinfo(struct sk_buff *skb, struct netlink_callback *cb)
 		case IFLA_LINKINFO:
 			kind_ops = linkinfo_to_kind_ops(tb[i]);
 			break;
+		case IFLA_DUMP_START_IFINDEX:
+			/* Resume from the cursor, or start at the given index */
+			if (!cb->strict_check)
+				break;
+			ctx->ifindex = max_t(unsigned long, ctx->ifindex,
+					     nla_get_u32(tb[i]));
+			flags |= NLM_F_DUMP_FILTERED;
+			break;
 		default:
 			if (cb->strict_check) {
 				NL_SET_ERR_MSG(extack, "Unsupported attribute in link dump request");
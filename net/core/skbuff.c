@@ -5029,6 +5029,8 @@ void __init skb_init(void)
 					      offsetof(struct sk_buff, cb),
 					      sizeof_field(struct sk_buff, cb),
 					      NULL);
+	/* NAPI allocates and frees skb heads in bulk; failure is harmless */
+	kmem_cache_setup_sheaves(net_hotdata.skbuff_cache, 64);
 	net_hotdata.skbuff_fclone_cache = kmem_cache_create("skbuff_fclone_cache",
 						sizeof(struct sk_buff_fclones),
 						0,
@@ -525,10 +525,13 @@ static struct sock *run_bpf_filter(struct sock_reuseport *reuse, u16 socks,
 	return reuse->socks[index];
 }
 
+/* With SO_INCOMING_CPU listeners: this CPU first, then this NUMA node. */
 static struct sock *reuseport_select_sock_by_hash(struct sock_reuseport *reuse,
 						  u32 hash, u16 num_socks)
 {
-	struct sock *first_valid_sk = NULL;
+	struct sock *first_valid_sk = NULL, *node_sk = NULL;
+	int cpu = raw_smp_processor_id();
+	int node = cpu_to_node(cpu);
 	int i, j;
 
 	i = j = reciprocal_scale(hash, num_socks);
@@ -536,13 +539,23 @@ static struct sock *reuseport_select_sock_by_hash(struct sock_reuseport *reuse,
 		struct sock *sk = reuse->socks[i];
 
 		if (sk->sk_state != TCP_ESTABLISHED) {
+			int sk_cpu;
+
 			/* Paired with WRITE_ONCE() in __reuseport_(get|put)_incoming_cpu(). */
 			if (!READ_ONCE(reuse->incoming_cpu))
 				return sk;
 
 			/* Paired with WRITE_ONCE() in reuseport_update_incoming_cpu(). */
-			if (READ_ONCE(sk->sk_incoming_cpu) == raw_smp_processor_id())
+			sk_cpu = READ_ONCE(sk->sk_incoming_cpu);
+			if (sk_cpu == cpu) {
+				NET_INC_STATS(sock_net(sk),
+						LINUX_MIB_REUSEPORTSELECTCPU);
 				return sk;
+			}
+
+			if (!node_sk && sk_cpu >= 0 && sk_cpu < nr_cpu_ids &&
+			    cpu_to_node(sk_cpu) == node)
+				node_sk = sk;
 
 			if (!first_valid_sk)
 				first_valid_sk = sk;
@@ -553,6 +566,14 @@ static struct sock *reuseport_select_sock_by_hash(struct sock_reuseport *reuse,
 			i = 0;
 	} while (i != j);
 
+	if (node_sk) {
+		NET_INC_STATS(sock_net(node_sk), LINUX_MIB_REUSEPORTSELECTNODE);
+		return node_sk;
+	}
+
+	if (first_valid_sk)
+		NET_INC_STATS(sock_net(first_valid_sk),
+				LINUX_MIB_REUSEPORTSELECTREMOTE);
 	return first_valid_sk;
 }
 
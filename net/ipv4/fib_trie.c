@@ -38,6 +38,7 @@
 #include <linux/cache.h>
 #include <linux/uaccess.h>
 #include <linux/bitops.h>
+#include <linux/hash.h>
 #include <linux/types.h>
 #include <linux/kernel.h>
 #include <linux/mm.h>
@@ -151,6 +152,8 @@ struct trie_use_stats {
 	unsigned int semantic_match_miss;
 	unsigned int null_node_hit;
 	unsigned int resize_node_skipped;
+	unsigned int cache_hit;
+	unsigned int cache_miss;
 };
 #endif
 
@@ -164,11 +167,36 @@ struct trie_stat {
 	unsigned int nodesizes[MAX_STAT_DEPTH];
 };
 
+/* Small per-cpu direct-mapped cache of lookup results, used from BH
+ * context only.  An entry is valid while its genid matches the netns
+ * route genid plus the trie generation, which is bumped each time an
+ * alias is unlinked and before it (or its fib_info or leaf) is freed.
+ */
+#define TRIE_CACHE_BITS	5
+#define TRIE_CACHE_SIZE	(1 << TRIE_CACHE_BITS)
+
+struct trie_cache_entry {
+	__be32			daddr;
+	int			oif;
+	u8			tos;
+	u8			scope;
+	u8			flags;
+	int			genid;
+	struct fib_result	res;
+};
+
+struct trie_cache {
+	struct trie_cache_entry	entries[TRIE_CACHE_SIZE];
+};
+
 struct trie {
 	struct key_vector kv[1];
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 	struct trie_use_stats __percpu *stats;
 #endif
+	struct trie_cache __percpu *cache;
+	struct net *net;
+	unsigned int cache_gen;
 };
 
 static struct key_vector *resize(struct trie *t, struct key_vector *tn);
@@ -303,6 +331,54 @@ static inline void alias_free_mem_rcu(struct fib_alias *fa)
 	call_rcu(&fa->rcu, __alias_free_mem);
 }
 
+/* Caller must hold RTNL and have unlinked the alias that is going away */
+static void trie_cache_flush(struct trie *t)
+{
+	/* Paired with smp_load_acquire() in trie_cache_slot() */
+	smp_store_release(&t->cache_gen, t->cache_gen + 1);
+}
+
+static struct trie_cache_entry *trie_cache_slot(struct trie *t,
+						const struct flowi4 *flp,
+						int *genid)
+{
+	u32 hash;
+
+	/* entries are only written from BH context, so they can't be torn */
+	if (!in_softirq())
+		return NULL;
+
+	*genid = rt_genid_ipv4(t->net) + smp_load_acquire(&t->cache_gen);
+	hash = hash_32((__force u32)flp->daddr ^ flp->flowi4_oif,
+		       TRIE_CACHE_BITS);
+
+	return &this_cpu_ptr(t->cache)->entries[hash];
+}
+
+static bool trie_cache_match(const struct trie_cache_entry *ce,
+			     const struct flowi4 *flp, int fib_flags, int genid)
+{
+	return ce->res.fi && ce->genid == genid &&
+	       ce->daddr == flp->daddr &&
+	       ce->oif == flp->flowi4_oif &&
+	       ce->tos == flp->flowi4_tos &&
+	       ce->scope == flp->flowi4_scope &&
+	       ce->flags == (fib_flags & FIB_LOOKUP_IGNORE_LINKSTATE);
+}
+
+static void trie_cache_fill(struct trie_cache_entry *ce,
+			    const struct flowi4 *flp, int fib_flags, int genid,
+			    const struct fib_result *res)
+{
+	ce->daddr = flp->daddr;
+	ce->oif = flp->flowi4_oif;
+	ce->tos = flp->flowi4_tos;
+	ce->scope = flp->flowi4_scope;
+	ce->flags = fib_flags & FIB_LOOKUP_IGNORE_LINKSTATE;
+	ce->genid = genid;
+	ce->res = *res;
+}
+
 #define TNODE_VMALLOC_MAX \
 	ilog2((SIZE_MAX - TNODE_SIZE(0)) / sizeof(struct key_vector *))
 
@@ -1315,6 +1391,7 @@ int fib_table_insert(struct net *net, struct fib_table *tb,
 			new_fa->offload_failed = 0;
 
 			hlist_replace_rcu(&fa->fa_list, &new_fa->fa_list);
+			trie_cache_flush(t);
 
 			if (fib_find_alias(&l->leaf, fa->fa_slen, 0, 0,
 					   tb->tb_id, true) == new_fa) {
@@ -1327,6 +1404,7 @@ int fib_table_insert(struct net *net, struct fib_table *tb,
 				if (err) {
 					hlist_replace_rcu(&new_fa->fa_list,
 							  &fa->fa_list);
+					trie_cache_flush(t);
 					goto out_free_new_fa;
 				}
 			}
@@ -1450,10 +1528,12 @@ int fib_table_lookup(struct fib_table *tb, const struct flowi4 *flp,
 	struct trie_use_stats __percpu *stats = t->stats;
 #endif
 	const t_key key = ntohl(flp->daddr);
+	struct trie_cache_entry *ce;
 	struct key_vector *n, *pn;
 	struct fib_alias *fa;
 	unsigned long index;
 	t_key cindex;
+	int genid = 0;
 
 	pn = t->kv;
 	cindex = 0;
@@ -1468,6 +1548,33 @@ int fib_table_lookup(struct fib_table *tb, const struct flowi4 *flp,
 	this_cpu_inc(stats->gets);
 #endif
 
+	ce = trie_cache_slot(t, flp, &genid);
+	if (ce) {
+		if (trie_cache_match(ce, flp, fib_flags, genid)) {
+			if (!(fib_flags & FIB_LOOKUP_NOREF))
+				refcount_inc(&ce->res.fi->fib_clntref);
+
+			res->prefix = ce->res.prefix;
+			res->prefixlen = ce->res.prefixlen;
+			res->nh_sel = ce->res.nh_sel;
+			res->nhc = ce->res.nhc;
+			res->type = ce->res.type;
+			res->scope = ce->res.scope;
+			res->dscp = ce->res.dscp;
+			res->fi = ce->res.fi;
+			res->table = tb;
+			res->fa_head = ce->res.fa_head;
+#ifdef CONFIG_IP_FIB_TRIE_STATS
+			this_cpu_inc(stats->cache_hit);
+#endif
+			trace_fib_table_lookup(tb->tb_id, flp, res->nhc, 0);
+			return 0;
+		}
+#ifdef CONFIG_IP_FIB_TRIE_STATS
+		this_cpu_inc(stats->cache_miss);
+#endif
+	}
+
 	/* Step 1: Travel to the longest prefix match in the trie */
 	for (;;) {
 		index = get_cindex(key, n);
@@ -1633,6 +1740,11 @@ int fib_table_lookup(struct fib_table *tb, const struct flowi4 *flp,
 			res->fi = fi;
 			res->table = tb;
 			res->fa_head = &n->leaf;
+			/* nexthop objects can be replaced without a genid bump
+			 * ordered before the free, so don't cache those.
+			 */
+			if (ce && !err && !fi->nh)
+				trie_cache_fill(ce, flp, fib_flags, genid, res);
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 			this_cpu_inc(stats->semantic_match_passed);
 #endif
@@ -1658,6 +1770,7 @@ static void fib_remove_alias(struct trie *t, struct key_vector *tp,
 
 	/* remove the fib_alias from the list */
 	hlist_del_rcu(&old->fa_list);
+	trie_cache_flush(t);
 
 	/* if we emptied the list this leaf will be freed and we can sort
 	 * out parent suffix lengths as a part of trie_rebalance
@@ -1895,6 +2008,7 @@ static void fib_trie_free(struct fib_table *tb)
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 	free_percpu(t->stats);
 #endif
+	free_percpu(t->cache);
 	kfree(tb);
 }
 
@@ -1910,7 +2024,7 @@ struct fib_table *fib_trie_unmerge(struct fib_table *oldtb)
 	if (oldtb->tb_data == oldtb->__data)
 		return oldtb;
 
-	local_tb = fib_trie_table(RT_TABLE_LOCAL, NULL);
+	local_tb = fib_trie_table(ot->net, RT_TABLE_LOCAL, NULL);
 	if (!local_tb)
 		return NULL;
 
@@ -2007,6 +2121,7 @@ void fib_table_flush_external(struct fib_table *tb)
 			 */
 			if (tb->tb_id != fa->tb_id) {
 				hlist_del_rcu(&fa->fa_list);
+				trie_cache_flush(t);
 				alias_free_mem_rcu(fa);
 				continue;
 			}
@@ -2096,6 +2211,7 @@ int fib_table_flush(struct net *net, struct fib_table *tb, bool flush_all)
 				rtmsg_fib(RTM_DELROUTE, htonl(n->key), fa,
 					  KEYLENGTH - fa->fa_slen, tb->tb_id, &info, 0);
 			hlist_del_rcu(&fa->fa_list);
+			trie_cache_flush(t);
 			fib_release_info(fa->fa_info);
 			alias_free_mem_rcu(fa);
 			found++;
@@ -2253,12 +2369,14 @@ int fib_notify(struct net *net, struct notifier_block *nb,
 static void __trie_free_rcu(struct rcu_head *head)
 {
 	struct fib_table *tb = container_of(head, struct fib_table, rcu);
-#ifdef CONFIG_IP_FIB_TRIE_STATS
 	struct trie *t = (struct trie *)tb->tb_data;
 
-	if (tb->tb_data == tb->__data)
+	if (tb->tb_data == tb->__data) {
+#ifdef CONFIG_IP_FIB_TRIE_STATS
 		free_percpu(t->stats);
 #endif /* CONFIG_IP_FIB_TRIE_STATS */
+		free_percpu(t->cache);
+	}
 	kfree(tb);
 }
 
@@ -2409,7 +2527,8 @@ void __init fib_trie_init(void)
 					   0, SLAB_PANIC | SLAB_ACCOUNT, NULL);
 }
 
-struct fib_table *fib_trie_table(u32 id, struct fib_table *alias)
+struct fib_table *fib_trie_table(struct net *net, u32 id,
+				 struct fib_table *alias)
 {
 	struct fib_table *tb;
 	struct trie *t;
@@ -2432,9 +2551,16 @@ struct fib_table *fib_trie_table(u32 id, struct fib_table *alias)
 	t = (struct trie *) tb->tb_data;
 	t->kv[0].pos = KEYLENGTH;
 	t->kv[0].slen = KEYLENGTH;
+	t->net = net;
+	t->cache = alloc_percpu(struct trie_cache);
+	if (!t->cache) {
+		kfree(tb);
+		return NULL;
+	}
 #ifdef CONFIG_IP_FIB_TRIE_STATS
 	t->stats = alloc_percpu(struct trie_use_stats);
 	if (!t->stats) {
+		free_percpu(t->cache);
 		kfree(tb);
 		tb = NULL;
 	}
@@ -2611,6 +2737,8 @@ static void trie_show_usage(struct seq_file *seq,
 		s.semantic_match_miss += pcpu->semantic_match_miss;
 		s.null_node_hit += pcpu->null_node_hit;
 		s.resize_node_skipped += pcpu->resize_node_skipped;
+		s.cache_hit += pcpu->cache_hit;
+		s.cache_miss += pcpu->cache_miss;
 	}
 
 	seq_printf(seq, "\nCounters:\n---------\n");
@@ -2620,7 +2748,9 @@ static void trie_show_usage(struct seq_file *seq,
 		   s.semantic_match_passed);
 	seq_printf(seq, "semantic match miss = %u\n", s.semantic_match_miss);
 	seq_printf(seq, "null node hit= %u\n", s.null_node_hit);
-	seq_printf(seq, "skipped node resize = %u\n\n", s.resize_node_skipped);
+	seq_printf(seq, "skipped node resize = %u\n", s.resize_node_skipped);
+	seq_printf(seq, "cache hits = %u\n", s.cache_hit);
+	seq_printf(seq, "cache misses = %u\n\n", s.cache_miss);
 }
 #endif /*  CONFIG_IP_FIB_TRIE_STATS */
 
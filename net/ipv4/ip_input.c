@@ -313,10 +313,12 @@ static bool ip_can_use_hint(const struct sk_buff *skb, const struct iphdr *iph,
 }
 
 int tcp_v4_early_demux(struct sk_buff *skb);
+int tcp_v4_early_demux_hint(struct sk_buff *skb, const struct sk_buff *hint);
 int udp_v4_early_demux(struct sk_buff *skb);
 static int ip_rcv_finish_core(struct net *net, struct sock *sk,
 			      struct sk_buff *skb, struct net_device *dev,
-			      const struct sk_buff *hint)
+			      const struct sk_buff *hint,
+			      const struct sk_buff *demux_hint)
 {
 	const struct iphdr *iph = ip_hdr(skb);
 	int err, drop_reason;
@@ -338,7 +340,10 @@ static int ip_rcv_finish_core(struct net *net, struct sock *sk,
 		switch (iph->protocol) {
 		case IPPROTO_TCP:
 			if (READ_ONCE(net->ipv4.sysctl_tcp_early_demux)) {
-				tcp_v4_early_demux(skb);
+				if (demux_hint)
+					tcp_v4_early_demux_hint(skb, demux_hint);
+				else
+					tcp_v4_early_demux(skb);
 
 				/* must reload iph, skb->head might have changed */
 				iph = ip_hdr(skb);
@@ -444,7 +449,7 @@ static int ip_rcv_finish(struct net *net, struct sock *sk, struct sk_buff *skb)
 	if (!skb)
 		return NET_RX_SUCCESS;
 
-	ret = ip_rcv_finish_core(net, sk, skb, dev, NULL);
+	ret = ip_rcv_finish_core(net, sk, skb, dev, NULL, NULL);
 	if (ret != NET_RX_DROP)
 		ret = dst_input(skb);
 	return ret;
@@ -594,7 +599,7 @@ static struct sk_buff *ip_extract_route_hint(const struct net *net,
 static void ip_list_rcv_finish(struct net *net, struct sock *sk,
 			       struct list_head *head)
 {
-	struct sk_buff *skb, *next, *hint = NULL;
+	struct sk_buff *skb, *next, *hint = NULL, *demux_hint = NULL;
 	struct dst_entry *curr_dst = NULL;
 	struct list_head sublist;
 
@@ -610,7 +615,8 @@ static void ip_list_rcv_finish(struct net *net, struct sock *sk,
 		skb = l3mdev_ip_rcv(skb);
 		if (!skb)
 			continue;
-		if (ip_rcv_finish_core(net, sk, skb, dev, hint) == NET_RX_DROP)
+		if (ip_rcv_finish_core(net, sk, skb, dev, hint,
+				       demux_hint) == NET_RX_DROP)
 			continue;
 
 		dst = skb_dst(skb);
@@ -626,6 +632,10 @@ static void ip_list_rcv_finish(struct net *net, struct sock *sk,
 			curr_dst = dst;
 		}
 		list_add_tail(&skb->list, &sublist);
+		/* the last skb of the sublist stays queued until the next one
+		 * went through early demux, so it can lend it its socket
+		 */
+		demux_hint = skb;
 	}
 	/* dispatch final sublist */
 	ip_sublist_rcv_finish(&sublist);
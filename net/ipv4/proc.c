@@ -305,6 +305,13 @@ static const struct snmp_mib snmp4_net_list[] = {
 	SNMP_MIB_ITEM("TCPAOKeyNotFound", LINUX_MIB_TCPAOKEYNOTFOUND),
 	SNMP_MIB_ITEM("TCPAOGood", LINUX_MIB_TCPAOGOOD),
 	SNMP_MIB_ITEM("TCPAODroppedIcmps", LINUX_MIB_TCPAODROPPEDICMPS),
+	SNMP_MIB_ITEM("ReuseportSelectCpu", LINUX_MIB_REUSEPORTSELECTCPU),
+	SNMP_MIB_ITEM("ReuseportSelectNode", LINUX_MIB_REUSEPORTSELECTNODE),
+	SNMP_MIB_ITEM("ReuseportSelectRemote", LINUX_MIB_REUSEPORTSELECTREMOTE),
+	SNMP_MIB_ITEM("TCPZeroCopyRxPages", LINUX_MIB_TCPZEROCOPYRXPAGES),
+	SNMP_MIB_ITEM("TCPZeroCopyRxCopy", LINUX_MIB_TCPZEROCOPYRXCOPY),
+	SNMP_MIB_ITEM("TCPZeroCopyRxZap", LINUX_MIB_TCPZEROCOPYRXZAP),
+	SNMP_MIB_ITEM("TCPAckHeld", LINUX_MIB_TCPACKHELD),
 	SNMP_MIB_SENTINEL
 };
 
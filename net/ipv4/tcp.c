@@ -1952,7 +1952,8 @@ static int tcp_zc_handle_leftover(struct tcp_zerocopy_receive *zc,
 	return zc->copybuf_len < 0 ? 0 : copylen;
 }
 
-static int tcp_zerocopy_vm_insert_batch_error(struct vm_area_struct *vma,
+static int tcp_zerocopy_vm_insert_batch_error(struct sock *sk,
+					      struct vm_area_struct *vma,
 					      struct page **pending_pages,
 					      unsigned long pages_remaining,
 					      unsigned long *address,
@@ -1971,6 +1972,7 @@ static int tcp_zerocopy_vm_insert_batch_error(struct vm_area_struct *vma,
 				*length + /* Mapped or pending */
 				(pages_remaining * PAGE_SIZE); /* Failed map. */
 		zap_page_range_single(vma, *address, maybe_zap_len, NULL);
+		NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPZEROCOPYRXZAP);
 		err = 0;
 	}
 
@@ -2000,7 +2002,8 @@ static int tcp_zerocopy_vm_insert_batch_error(struct vm_area_struct *vma,
 	return err;
 }
 
-static int tcp_zerocopy_vm_insert_batch(struct vm_area_struct *vma,
+static int tcp_zerocopy_vm_insert_batch(struct sock *sk,
+					struct vm_area_struct *vma,
 					struct page **pages,
 					unsigned int pages_to_map,
 					unsigned long *address,
@@ -2027,7 +2030,7 @@ static int tcp_zerocopy_vm_insert_batch(struct vm_area_struct *vma,
 		return 0;
 
 	/* Error: maybe zap and retry + rollback state for failed inserts. */
-	return tcp_zerocopy_vm_insert_batch_error(vma, pages + pages_mapped,
+	return tcp_zerocopy_vm_insert_batch_error(sk, vma, pages + pages_mapped,
 		pages_remaining, address, length, seq, zc, total_bytes_to_map,
 		err);
 }
@@ -2115,8 +2118,10 @@ static int tcp_zerocopy_receive(struct sock *sk,
 
 	sock_rps_record_flow(sk);
 
-	if (inq && inq <= copybuf_len)
+	if (inq && inq <= copybuf_len) {
+		NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPZEROCOPYRXCOPY);
 		return receive_fallback_to_copy(sk, zc, inq, tss);
+	}
 
 	if (inq < PAGE_SIZE) {
 		zc->length = 0;
@@ -2134,9 +2139,11 @@ static int tcp_zerocopy_receive(struct sock *sk,
 	avail_len = min_t(u32, vma_len, inq);
 	total_bytes_to_map = avail_len & ~(PAGE_SIZE - 1);
 	if (total_bytes_to_map) {
-		if (!(zc->flags & TCP_RECEIVE_ZEROCOPY_FLAG_TLB_CLEAN_HINT))
+		if (!(zc->flags & TCP_RECEIVE_ZEROCOPY_FLAG_TLB_CLEAN_HINT)) {
 			zap_page_range_single(vma, address, total_bytes_to_map,
 					      NULL);
+			NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPZEROCOPYRXZAP);
+		}
 		zc->length = total_bytes_to_map;
 		zc->recv_skip_hint = 0;
 	} else {
@@ -2187,7 +2194,7 @@ static int tcp_zerocopy_receive(struct sock *sk,
 			/* Either full batch, or we're about to go to next skb
 			 * (and we cannot unroll failed ops across skbs).
 			 */
-			ret = tcp_zerocopy_vm_insert_batch(vma, pages,
+			ret = tcp_zerocopy_vm_insert_batch(sk, vma, pages,
 							   pages_to_map,
 							   &address, &length,
 							   &seq, zc,
@@ -2198,7 +2205,7 @@ static int tcp_zerocopy_receive(struct sock *sk,
 		}
 	}
 	if (pages_to_map) {
-		ret = tcp_zerocopy_vm_insert_batch(vma, pages, pages_to_map,
+		ret = tcp_zerocopy_vm_insert_batch(sk, vma, pages, pages_to_map,
 						   &address, &length, &seq,
 						   zc, total_bytes_to_map);
 	}
@@ -2212,6 +2219,11 @@ static int tcp_zerocopy_receive(struct sock *sk,
 		copylen = tcp_zc_handle_leftover(zc, sk, skb, &seq, copybuf_len, tss);
 
 	if (length + copylen) {
+		if (length)
+			NET_ADD_STATS(sock_net(sk), LINUX_MIB_TCPZEROCOPYRXPAGES,
+				      length >> PAGE_SHIFT);
+		if (copylen)
+			NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPZEROCOPYRXCOPY);
 		WRITE_ONCE(tp->copied_seq, seq);
 		tcp_rcv_space_adjust(sk);
 
@@ -3749,6 +3761,12 @@ int do_tcp_setsockopt(struct sock *sk, int level, int optname,
 			tcp_enable_tx_delay();
 		WRITE_ONCE(tp->tcp_tx_delay, val);
 		break;
+	case TCP_ACK_HOLD:
+		if (val < 0)
+			err = -EINVAL;
+		else
+			WRITE_ONCE(tp->ack_hold, val);
+		break;
 	default:
 		err = -ENOPROTOOPT;
 		break;
@@ -4241,6 +4259,10 @@ int do_tcp_getsockopt(struct sock *sk, int level,
 		val = READ_ONCE(tp->tcp_tx_delay);
 		break;
 
+	case TCP_ACK_HOLD:
+		val = READ_ONCE(tp->ack_hold);
+		break;
+
 	case TCP_TIMESTAMP:
 		val = tcp_clock_ts(tp->tcp_usec_ts) + READ_ONCE(tp->tsoffset);
 		if (tp->tcp_usec_ts)
@@ -5708,23 +5708,50 @@ static inline void tcp_data_snd_check(struct sock *sk)
 	tcp_check_space(sk);
 }
 
+/* TCP_ACK_HOLD lets a bulk receiver ACK every ack_hold bytes instead of
+ * every other segment. Never hold more than a quarter of the receive window,
+ * so the sender keeps enough ACK clock to grow cwnd, and never with data
+ * out of order, where the sender needs every (D)SACK. The delayed ACK timer
+ * still bounds how long an ACK can be held.
+ */
+static bool tcp_ack_held(const struct sock *sk, u32 unacked)
+{
+	const struct tcp_sock *tp = tcp_sk(sk);
+	u32 hold = READ_ONCE(tp->ack_hold);
+
+	if (likely(hold <= inet_csk(sk)->icsk_ack.rcv_mss))
+		return false;
+
+	if (!RB_EMPTY_ROOT(&tp->out_of_order_queue))
+		return false;
+
+	return unacked <= min(hold, tp->rcv_wnd >> 2);
+}
+
 /*
  * Check if sending an ack is needed.
  */
 static void __tcp_ack_snd_check(struct sock *sk, int ofo_possible)
 {
 	struct tcp_sock *tp = tcp_sk(sk);
+	u32 unacked = tp->rcv_nxt - tp->rcv_wup;
 	unsigned long rtt, delay;
-
-	    /* More than one full frame received... */
-	if (((tp->rcv_nxt - tp->rcv_wup) > inet_csk(sk)->icsk_ack.rcv_mss &&
-	     /* ... and right edge of window advances far enough.
-	      * (tcp_recvmsg() will send ACK otherwise).
-	      * If application uses SO_RCVLOWAT, we want send ack now if
-	      * we have not received enough bytes to satisfy the condition.
-	      */
-	    (tp->rcv_nxt - tp->copied_seq < sk->sk_rcvlowat ||
-	     __tcp_select_window(sk) >= tp->rcv_wnd)) ||
+	bool full, held = false;
+
+	/* More than one full frame received... */
+	full = unacked > inet_csk(sk)->icsk_ack.rcv_mss &&
+	       /* ... and right edge of window advances far enough.
+		* (tcp_recvmsg() will send ACK otherwise).
+		* If application uses SO_RCVLOWAT, we want send ack now if
+		* we have not received enough bytes to satisfy the condition.
+		*/
+	       (tp->rcv_nxt - tp->copied_seq < sk->sk_rcvlowat ||
+		__tcp_select_window(sk) >= tp->rcv_wnd);
+	/* ... unless the socket asked to hold ACKs for longer */
+	if (full)
+		held = tcp_ack_held(sk, unacked);
+
+	if ((full && !held) ||
 	    /* We ACK each frame or... */
 	    tcp_in_quickack_mode(sk) ||
 	    /* Protocol state mandates a one-time immediate ACK */
@@ -5743,6 +5770,8 @@ static void __tcp_ack_snd_check(struct sock *sk, int ofo_possible)
 	}
 
 	if (!ofo_possible || RB_EMPTY_ROOT(&tp->out_of_order_queue)) {
+		if (held)
+			NET_INC_STATS(sock_net(sk), LINUX_MIB_TCPACKHELD);
 		tcp_send_delayed_ack(sk);
 		return;
 	}
@@ -1958,6 +1958,21 @@ int tcp_v4_do_rcv(struct sock *sk, struct sk_buff *skb)
 }
 EXPORT_SYMBOL(tcp_v4_do_rcv);
 
+static void tcp_v4_early_demux_set(struct sk_buff *skb, struct sock *sk)
+{
+	skb->sk = sk;
+	skb->destructor = sock_edemux;
+	if (sk_fullsock(sk)) {
+		struct dst_entry *dst = rcu_dereference(sk->sk_rx_dst);
+
+		if (dst)
+			dst = dst_check(dst, 0);
+		if (dst &&
+		    sk->sk_rx_dst_ifindex == skb->skb_iif)
+			skb_dst_set_noref(skb, dst);
+	}
+}
+
 int tcp_v4_early_demux(struct sk_buff *skb)
 {
 	struct net *net = dev_net(skb->dev);
@@ -1981,19 +1996,49 @@ int tcp_v4_early_demux(struct sk_buff *skb)
 				       iph->saddr, th->source,
 				       iph->daddr, ntohs(th->dest),
 				       skb->skb_iif, inet_sdif(skb));
-	if (sk) {
-		skb->sk = sk;
-		skb->destructor = sock_edemux;
-		if (sk_fullsock(sk)) {
-			struct dst_entry *dst = rcu_dereference(sk->sk_rx_dst);
-
-			if (dst)
-				dst = dst_check(dst, 0);
-			if (dst &&
-			    sk->sk_rx_dst_ifindex == skb->skb_iif)
-				skb_dst_set_noref(skb, dst);
-		}
-	}
+	if (sk)
+		tcp_v4_early_demux_set(skb, sk);
+	return 0;
+}
+
+/* Same as tcp_v4_early_demux(), but reuse the socket found for @hint, the
+ * previous skb of a receive list, when @skb belongs to the same flow. Runs
+ * of segments of one flow then only pay for one established hash lookup.
+ * @hint must not have been delivered yet.
+ */
+int tcp_v4_early_demux_hint(struct sk_buff *skb, const struct sk_buff *hint)
+{
+	const struct iphdr *iph;
+	const struct tcphdr *th;
+	struct sock *sk = hint->sk;
+
+	if (!sk || hint->destructor != sock_edemux || !sk_fullsock(sk) ||
+	    sk->sk_protocol != IPPROTO_TCP)
+		return tcp_v4_early_demux(skb);
+
+	if (skb->pkt_type != PACKET_HOST)
+		return 0;
+
+	if (!pskb_may_pull(skb, skb_transport_offset(skb) + sizeof(struct tcphdr)))
+		return 0;
+
+	iph = ip_hdr(skb);
+	th = tcp_hdr(skb);
+
+	if (th->doff < sizeof(struct tcphdr) / 4)
+		return 0;
+
+	/* Match against the socket itself, not the headers of @hint: its
+	 * socket may have been assigned by something other than a lookup.
+	 */
+	if (sk->sk_daddr != iph->saddr || sk->sk_rcv_saddr != iph->daddr ||
+	    sk->sk_dport != th->source || sk->sk_num != ntohs(th->dest) ||
+	    skb->skb_iif != hint->skb_iif ||
+	    inet_sdif(skb) != inet_sdif(hint) ||
+	    !refcount_inc_not_zero(&sk->sk_refcnt))
+		return tcp_v4_early_demux(skb);
+
+	tcp_v4_early_demux_set(skb, sk);
 	return 0;
 }
 
@@ -67,7 +67,9 @@ static int subflow_get_info(struct sock *sk, struct sk_buff *skb)
 			sf->map_data_len) ||
 	    nla_put_u32(skb, MPTCP_SUBFLOW_ATTR_FLAGS, flags) ||
 	    nla_put_u8(skb, MPTCP_SUBFLOW_ATTR_ID_REM, sf->remote_id) ||
-	    nla_put_u8(skb, MPTCP_SUBFLOW_ATTR_ID_LOC, subflow_get_local_id(sf))) {
+	    nla_put_u8(skb, MPTCP_SUBFLOW_ATTR_ID_LOC, subflow_get_local_id(sf)) ||
+	    nla_put_u32(skb, MPTCP_SUBFLOW_ATTR_SCHED_COUNT,
+			READ_ONCE(sf->sched_count))) {
 		err = -EMSGSIZE;
 		goto nla_failure;
 	}
@@ -99,6 +101,7 @@ static size_t subflow_get_info_size(const struct sock *sk)
 		nla_total_size(4) +	/* MPTCP_SUBFLOW_ATTR_FLAGS */
 		nla_total_size(1) +	/* MPTCP_SUBFLOW_ATTR_ID_REM */
 		nla_total_size(1) +	/* MPTCP_SUBFLOW_ATTR_ID_LOC */
+		nla_total_size(4) +	/* MPTCP_SUBFLOW_ATTR_SCHED_COUNT */
 		0;
 	return size;
 }
@@ -140,6 +140,9 @@ void mptcp_release_sched(struct mptcp_sock *msk)
 void mptcp_subflow_set_scheduled(struct mptcp_subflow_context *subflow,
 				 bool scheduled)
 {
+	/* paired with READ_ONCE() in mptcp diag */
+	if (scheduled && !READ_ONCE(subflow->scheduled))
+		WRITE_ONCE(subflow->sched_count, subflow->sched_count + 1);
 	WRITE_ONCE(subflow->scheduled, scheduled);
 }
 
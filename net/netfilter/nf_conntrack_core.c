@@ -1154,7 +1154,7 @@ __nf_conntrack_confirm(struct sk_buff *skb)
 	const struct nf_conntrack_zone *zone;
 	unsigned int hash, reply_hash;
 	struct nf_conntrack_tuple_hash *h;
-	struct nf_conn *ct;
+	struct nf_conn *ct, *expired = NULL;
 	struct nf_conn_help *help;
 	struct hlist_nulls_node *n;
 	enum ip_conntrack_info ctinfo;
@@ -1226,6 +1226,8 @@ __nf_conntrack_confirm(struct sk_buff *skb)
 		if (nf_ct_key_equal(h, &ct->tuplehash[IP_CT_DIR_ORIGINAL].tuple,
 				    zone, net))
 			goto out;
+		if (!expired && nf_ct_is_expired(nf_ct_tuplehash_to_ctrack(h)))
+			expired = nf_ct_tuplehash_to_ctrack(h);
 		if (chainlen++ > max_chainlen)
 			goto chaintoolong;
 	}
@@ -1235,6 +1237,8 @@ __nf_conntrack_confirm(struct sk_buff *skb)
 		if (nf_ct_key_equal(h, &ct->tuplehash[IP_CT_DIR_REPLY].tuple,
 				    zone, net))
 			goto out;
+		if (!expired && nf_ct_is_expired(nf_ct_tuplehash_to_ctrack(h)))
+			expired = nf_ct_tuplehash_to_ctrack(h);
 		if (chainlen++ > max_chainlen) {
 chaintoolong:
 			NF_CT_STAT_INC(net, chaintoolong);
@@ -1260,6 +1264,12 @@ __nf_conntrack_confirm(struct sk_buff *skb)
 	nf_conntrack_double_unlock(hash, reply_hash);
 	local_bh_enable();
 
+	/* Reap a stale entry we walked past rather than leaving it to the
+	 * gc worker; the bucket locks are dropped, so this can't deadlock.
+	 */
+	if (expired)
+		nf_ct_gc_expired(expired);
+
 	/* ext area is still valid (rcu read lock is held,
 	 * but will go out of scope soon, we need to remove
 	 * this conntrack again.
@@ -1283,6 +1293,8 @@ __nf_conntrack_confirm(struct sk_buff *skb)
 dying:
 	nf_conntrack_double_unlock(hash, reply_hash);
 	local_bh_enable();
+	if (expired)
+		nf_ct_gc_expired(expired);
 	return ret;
 }
 EXPORT_SYMBOL_GPL(__nf_conntrack_confirm);
@@ -546,10 +546,16 @@ int nf_flow_table_init(struct nf_flowtable *flowtable)
 	flow_block_init(&flowtable->flow_block);
 	init_rwsem(&flowtable->flow_block_lock);
 
+	flowtable->stats = netdev_alloc_pcpu_stats(struct nf_flowtable_stats);
+	if (!flowtable->stats)
+		return -ENOMEM;
+
 	err = rhashtable_init(&flowtable->rhashtable,
 			      &nf_flow_offload_rhash_params);
-	if (err < 0)
+	if (err < 0) {
+		free_percpu(flowtable->stats);
 		return err;
+	}
 
 	queue_delayed_work(system_power_efficient_wq,
 			   &flowtable->gc_work, HZ);
@@ -610,9 +616,34 @@ void nf_flow_table_free(struct nf_flowtable *flow_table)
 	nf_flow_table_gc_run(flow_table);
 	nf_flow_table_offload_flush_cleanup(flow_table);
 	rhashtable_destroy(&flow_table->rhashtable);
+	free_percpu(flow_table->stats);
 }
 EXPORT_SYMBOL_GPL(nf_flow_table_free);
 
+void nf_flow_table_stats_read(const struct nf_flowtable *flow_table,
+			      u64 *hit, u64 *miss)
+{
+	int cpu;
+
+	*hit = 0;
+	*miss = 0;
+	for_each_possible_cpu(cpu) {
+		const struct nf_flowtable_stats *stats;
+		unsigned int start;
+		u64 h, m;
+
+		stats = per_cpu_ptr(flow_table->stats, cpu);
+		do {
+			start = u64_stats_fetch_begin(&stats->syncp);
+			h = stats->hit;
+			m = stats->miss;
+		} while (u64_stats_fetch_retry(&stats->syncp, start));
+
+		*hit += h;
+		*miss += m;
+	}
+}
+
 static int nf_flow_table_init_net(struct net *net)
 {
 	net->ft.stat = alloc_percpu(struct nf_flow_table_stat);
@@ -427,6 +427,7 @@ nf_flow_offload_ip_hook(void *priv, struct sk_buff *skb,
 	int ret;
 
 	tuplehash = nf_flow_offload_lookup(&ctx, flow_table, skb);
+	nf_flow_table_stats_inc(flow_table, tuplehash);
 	if (!tuplehash)
 		return NF_ACCEPT;
 
@@ -722,6 +723,7 @@ nf_flow_offload_ipv6_hook(void *priv, struct sk_buff *skb,
 	int ret;
 
 	tuplehash = nf_flow_offload_ipv6_lookup(&ctx, flow_table, skb);
+	nf_flow_table_stats_inc(flow_table, tuplehash);
 	if (tuplehash == NULL)
 		return NF_ACCEPT;
 
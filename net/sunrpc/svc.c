@@ -542,6 +542,8 @@ __svc_create(struct svc_program *prog, struct svc_stat *stats,
 		percpu_counter_init(&pool->sp_messages_arrived, 0, GFP_KERNEL);
 		percpu_counter_init(&pool->sp_sockets_queued, 0, GFP_KERNEL);
 		percpu_counter_init(&pool->sp_threads_woken, 0, GFP_KERNEL);
+		percpu_counter_init(&pool->sp_threads_starved, 0, GFP_KERNEL);
+		percpu_counter_init(&pool->sp_queue_time, 0, GFP_KERNEL);
 	}
 
 	return serv;
@@ -624,6 +626,8 @@ svc_destroy(struct svc_serv **servp)
 		percpu_counter_destroy(&pool->sp_messages_arrived);
 		percpu_counter_destroy(&pool->sp_sockets_queued);
 		percpu_counter_destroy(&pool->sp_threads_woken);
+		percpu_counter_destroy(&pool->sp_threads_starved);
+		percpu_counter_destroy(&pool->sp_queue_time);
 	}
 	kfree(serv->sv_pools);
 	kfree(serv);
@@ -731,8 +735,9 @@ svc_prepare_thread(struct svc_serv *serv, struct svc_pool *pool, int node)
  * service thread and marking it BUSY is atomic with respect to
  * other calls to svc_pool_wake_idle_thread().
  *
+ * Return: %false if @pool had no idle thread.
  */
-void svc_pool_wake_idle_thread(struct svc_pool *pool)
+bool svc_pool_wake_idle_thread(struct svc_pool *pool)
 {
 	struct svc_rqst	*rqstp;
 	struct llist_node *ln;
@@ -748,10 +753,11 @@ void svc_pool_wake_idle_thread(struct svc_pool *pool)
 			percpu_counter_inc(&pool->sp_threads_woken);
 		}
 		rcu_read_unlock();
-		return;
+		return true;
 	}
 	rcu_read_unlock();
 
+	return false;
 }
 EXPORT_SYMBOL_GPL(svc_pool_wake_idle_thread);
 
@@ -488,9 +488,11 @@ void svc_xprt_enqueue(struct svc_xprt *xprt)
 	pool = svc_pool_for_cpu(xprt->xpt_server);
 
 	percpu_counter_inc(&pool->sp_sockets_queued);
+	xprt->xpt_qtime = ktime_get();
 	lwq_enqueue(&xprt->xpt_ready, &pool->sp_xprts);
 
-	svc_pool_wake_idle_thread(pool);
+	if (!svc_pool_wake_idle_thread(pool))
+		percpu_counter_inc(&pool->sp_threads_starved);
 }
 EXPORT_SYMBOL_GPL(svc_xprt_enqueue);
 
@@ -502,8 +504,11 @@ static struct svc_xprt *svc_xprt_dequeue(struct svc_pool *pool)
 	struct svc_xprt	*xprt = NULL;
 
 	xprt = lwq_dequeue(&pool->sp_xprts, struct svc_xprt, xpt_ready);
-	if (xprt)
+	if (xprt) {
+		percpu_counter_add(&pool->sp_queue_time,
+				   ktime_us_delta(ktime_get(), xprt->xpt_qtime));
 		svc_xprt_get(xprt);
+	}
 	return xprt;
 }
 
@@ -1467,15 +1472,17 @@ static int svc_pool_stats_show(struct seq_file *m, void *p)
 	struct svc_pool *pool = p;
 
 	if (p == SEQ_START_TOKEN) {
-		seq_puts(m, "# pool packets-arrived sockets-enqueued threads-woken threads-timedout\n");
+		seq_puts(m, "# pool packets-arrived sockets-enqueued threads-woken threads-timedout threads-starved queue-time-us\n");
 		return 0;
 	}
 
-	seq_printf(m, "%u %llu %llu %llu 0\n",
+	seq_printf(m, "%u %llu %llu %llu 0 %llu %llu\n",
 		   pool->sp_id,
 		   percpu_counter_sum_positive(&pool->sp_messages_arrived),
 		   percpu_counter_sum_positive(&pool->sp_sockets_queued),
-		   percpu_counter_sum_positive(&pool->sp_threads_woken));
+		   percpu_counter_sum_positive(&pool->sp_threads_woken),
+		   percpu_counter_sum_positive(&pool->sp_threads_starved),
+		   percpu_counter_sum_positive(&pool->sp_queue_time));
 
 	return 0;
 }
@@ -22,6 +22,9 @@ static const struct snmp_mib tls_mib_list[] = {
 	SNMP_MIB_ITEM("TlsRxDeviceResync", LINUX_MIB_TLSRXDEVICERESYNC),
 	SNMP_MIB_ITEM("TlsDecryptRetry", LINUX_MIB_TLSDECRYPTRETRY),
 	SNMP_MIB_ITEM("TlsRxNoPadViolation", LINUX_MIB_TLSRXNOPADVIOL),
+	SNMP_MIB_ITEM("TlsDecryptZeroCopy", LINUX_MIB_TLSDECRYPTZC),
+	SNMP_MIB_ITEM("TlsDecryptAsync", LINUX_MIB_TLSDECRYPTASYNC),
+	SNMP_MIB_ITEM("TlsDecryptAsyncWait", LINUX_MIB_TLSDECRYPTASYNCWAIT),
 	SNMP_MIB_SENTINEL
 };
 
@@ -2044,6 +2044,10 @@ int tls_sw_recvmsg(struct sock *sk,
 			goto recv_end;
 		}
 
+		if (darg.zc)
+			TLS_INC_STATS(sock_net(sk), LINUX_MIB_TLSDECRYPTZC);
+		if (darg.async)
+			TLS_INC_STATS(sock_net(sk), LINUX_MIB_TLSDECRYPTASYNC);
 		async |= darg.async;
 
 		/* If the type of records being processed is not known yet,
@@ -2141,6 +2145,7 @@ int tls_sw_recvmsg(struct sock *sk,
 		int ret;
 
 		/* Wait for all previously submitted records to be decrypted */
+		TLS_INC_STATS(sock_net(sk), LINUX_MIB_TLSDECRYPTASYNCWAIT);
 		ret = tls_decrypt_async_wait(ctx);
 		__skb_queue_purge(&ctx->async_hold);
 
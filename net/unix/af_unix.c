@@ -2255,6 +2255,8 @@ static int unix_stream_sendmsg(struct socket *sock, struct msghdr *msg,
 	int sent = 0;
 	struct scm_cookie scm;
 	bool fds_sent = false;
+	bool wake_pending = false;
+	bool woken = false;
 	int data_len;
 
 	err = scm_send(sock, msg, &scm, false);
@@ -2349,8 +2351,18 @@ static int unix_stream_sendmsg(struct socket *sock, struct msghdr *msg,
 		scm_stat_add(other, skb);
 		skb_queue_tail(&other->sk_receive_queue, skb);
 		unix_state_unlock(other);
-		other->sk_data_ready(other);
 		sent += size;
+		wake_pending = true;
+
+		/* Wake the peer for the first skb so it starts reading, then
+		 * only when the next allocation may sleep or we are done.
+		 */
+		if (!woken || sent >= len ||
+		    sk_wmem_alloc_get(sk) >= READ_ONCE(sk->sk_sndbuf)) {
+			other->sk_data_ready(other);
+			wake_pending = false;
+			woken = true;
+		}
 	}
 
 #if IS_ENABLED(CONFIG_AF_UNIX_OOB)
@@ -2374,6 +2386,8 @@ static int unix_stream_sendmsg(struct socket *sock, struct msghdr *msg,
 		send_sig(SIGPIPE, current, 0);
 	err = -EPIPE;
 out_err:
+	if (wake_pending)
+		other->sk_data_ready(other);
 	scm_destroy(&scm);
 	return sent ? : err;
 }
@@ -33,6 +33,7 @@
 #include "xsk.h"
 
 #define TX_BATCH_SIZE 32
+#define XSK_GENERIC_XMIT_BULK 16
 #define MAX_PER_SOCKET_BUDGET (TX_BATCH_SIZE)
 
 void xsk_set_rx_need_wakeup(struct xsk_buff_pool *pool)
@@ -771,13 +772,54 @@ static struct sk_buff *xsk_build_skb(struct xdp_sock *xs,
 	return ERR_PTR(err);
 }
 
+/* Hand the skbs built so far to the driver in one go. The skbs the driver
+ * did not take, and a multi-buffer skb still being built after them, are
+ * cancelled so that user-space retries their descriptors.
+ */
+static int xsk_generic_xmit_flush(struct xdp_sock *xs, struct sk_buff **skbs,
+				  unsigned int *nr, bool *sent_frame)
+{
+	unsigned int done, i;
+	int err;
+
+	if (!*nr)
+		return 0;
+
+	err = __dev_direct_xmit_bulk(skbs, *nr, xs->queue_id, &done);
+	if (done)
+		*sent_frame = true;
+
+	if (done < *nr) {
+		if (xs->skb) {
+			xskq_cons_cancel_n(xs->tx, xsk_get_num_desc(xs->skb));
+			xsk_consume_skb(xs->skb);
+		}
+		for (i = *nr; i-- > done; ) {
+			xskq_cons_cancel_n(xs->tx, xsk_get_num_desc(skbs[i]));
+			xsk_consume_skb(skbs[i]);
+		}
+	}
+	*nr = 0;
+
+	/* Tell user-space to retry the send */
+	if (err == NETDEV_TX_BUSY)
+		return -EAGAIN;
+	/* SKB completed but not sent */
+	if (err == NET_XMIT_DROP)
+		return -EBUSY;
+	/* Ignore NET_XMIT_CN as packet might have been sent */
+	return 0;
+}
+
 static int __xsk_generic_xmit(struct sock *sk)
 {
+	struct sk_buff *skbs[XSK_GENERIC_XMIT_BULK];
 	struct xdp_sock *xs = xdp_sk(sk);
 	u32 max_batch = TX_BATCH_SIZE;
 	bool sent_frame = false;
 	struct xdp_desc desc;
 	struct sk_buff *skb;
+	unsigned int nr = 0;
 	int err = 0;
 
 	mutex_lock(&xs->mutex);
@@ -791,7 +833,19 @@ static int __xsk_generic_xmit(struct sock *sk)
 	if (xs->queue_id >= xs->dev->real_num_tx_queues)
 		goto out;
 
-	while (xskq_cons_peek_desc(xs->tx, &desc, xs->pool)) {
+	for (;;) {
+		/* Peeking at new entries publishes the consumer index, after
+		 * which the descriptors of pending skbs can't be cancelled.
+		 */
+		if (nr && xs->tx->cached_prod == xs->tx->cached_cons) {
+			err = xsk_generic_xmit_flush(xs, skbs, &nr, &sent_frame);
+			if (err)
+				goto out;
+		}
+
+		if (!xskq_cons_peek_desc(xs->tx, &desc, xs->pool))
+			break;
+
 		if (max_batch-- == 0) {
 			err = -EAGAIN;
 			goto out;
@@ -821,27 +875,19 @@ static int __xsk_generic_xmit(struct sock *sk)
 			continue;
 		}
 
-		err = __dev_direct_xmit(skb, xs->queue_id);
-		if  (err == NETDEV_TX_BUSY) {
-			/* Tell user-space to retry the send */
-			xskq_cons_cancel_n(xs->tx, xsk_get_num_desc(skb));
-			xsk_consume_skb(skb);
-			err = -EAGAIN;
-			goto out;
-		}
-
-		/* Ignore NET_XMIT_CN as packet might have been sent */
-		if (err == NET_XMIT_DROP) {
-			/* SKB completed but not sent */
-			err = -EBUSY;
-			xs->skb = NULL;
-			goto out;
-		}
-
-		sent_frame = true;
 		xs->skb = NULL;
+		skbs[nr++] = skb;
+		if (nr == XSK_GENERIC_XMIT_BULK) {
+			err = xsk_generic_xmit_flush(xs, skbs, &nr, &sent_frame);
+			if (err)
+				goto out;
+		}
 	}
 
+	err = xsk_generic_xmit_flush(xs, skbs, &nr, &sent_frame);
+	if (err)
+		goto out;
+
 	if (xskq_has_descs(xs->tx)) {
 		if (xs->skb)
 			xsk_drop_skb(xs->skb);
@@ -849,6 +895,13 @@ static int __xsk_generic_xmit(struct sock *sk)
 	}
 
 out:
+	if (nr) {
+		int ret = xsk_generic_xmit_flush(xs, skbs, &nr, &sent_frame);
+
+		if (!err)
+			err = ret;
+	}
+
 	if (sent_frame)
 		if (xsk_tx_writeable(xs))
 			sk->sk_write_space(sk);
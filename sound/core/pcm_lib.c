@@ -333,7 +333,9 @@ static int snd_pcm_update_hw_ptr0(struct snd_pcm_substream *substream,
 		}
 		pos = 0;
 	}
-	pos -= pos % runtime->min_align;
+	/* Most formats have no alignment constraint, skip the division */
+	if (runtime->min_align > 1)
+		pos -= pos % runtime->min_align;
 	trace_hwptr(substream, pos, in_interrupt);
 	hw_base = runtime->hw_ptr_base;
 	new_hw_ptr = hw_base + pos;
@@ -6588,6 +6588,10 @@ struct bpf_prog_info {
 	__u32 verified_insns;
 	__u32 attach_btf_obj_id;
 	__u32 attach_btf_id;
+	__u32 verified_states;
+	__u32 verified_pruned_states;
+	__u32 verified_peak_states;
+	__aligned_u64 verification_time_ns;
 } __attribute__((aligned(8)));
 
 struct bpf_map_info {
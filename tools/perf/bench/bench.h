@@ -26,9 +26,17 @@ int bench_syscall_basic(int argc, const char **argv);
 int bench_syscall_getpgid(int argc, const char **argv);
 int bench_syscall_fork(int argc, const char **argv);
 int bench_syscall_execve(int argc, const char **argv);
+int bench_syscall_spawn(int argc, const char **argv);
 int bench_mem_memcpy(int argc, const char **argv);
 int bench_mem_memset(int argc, const char **argv);
 int bench_mem_find_bit(int argc, const char **argv);
+int bench_mm_fault(int argc, const char **argv);
+int bench_mm_vma(int argc, const char **argv);
+int bench_mm_pagecache(int argc, const char **argv);
+int bench_fs_lookup(int argc, const char **argv);
+int bench_fs_poll(int argc, const char **argv);
+int bench_fs_fd_alloc(int argc, const char **argv);
+int bench_fs_splice(int argc, const char **argv);
 int bench_futex_hash(int argc, const char **argv);
 int bench_futex_wake(int argc, const char **argv);
 int bench_futex_wake_parallel(int argc, const char **argv);
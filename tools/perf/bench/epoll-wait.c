@@ -40,6 +40,10 @@
  * epoll_wait(2) blocking as the lineal writer thread will take "longer",
  * at least at a high level.
  *
+ * With --writers, the fdmaps are split among several writer threads, so
+ * that events are queued on the epoll instance from several CPUs at once,
+ * against the workers harvesting them.
+ *
  * Note that because fds are private to each thread, this workload does
  * not stress scenarios where multiple tasks are awoken per ready IO; ie:
  * EPOLLEXCLUSIVE semantics.
@@ -89,6 +93,7 @@
 	do { if (__verbose) { printf(fmt, ## arg); fflush(stdout); } } while (0)
 
 static unsigned int nthreads = 0;
+static unsigned int nwriters = 1;
 static unsigned int nsecs    = 8;
 static bool wdone, done, __verbose, randomize, nonblocking;
 
@@ -123,9 +128,16 @@ struct worker {
 	int *fdmap;
 };
 
+struct writer {
+	unsigned int id;
+	pthread_t thread;
+	struct worker *worker;
+};
+
 static const struct option options[] = {
 	/* general benchmark options */
 	OPT_UINTEGER('t', "threads", &nthreads, "Specify amount of threads"),
+	OPT_UINTEGER('w', "writers", &nwriters, "Specify amount of writer threads"),
 	OPT_UINTEGER('r', "runtime", &nsecs, "Specify runtime (in seconds)"),
 	OPT_UINTEGER('f', "nfds",    &nfds,  "Specify amount of file descriptors to monitor for each thread"),
 	OPT_BOOLEAN( 'n', "noaffinity",  &noaffinity,   "Disables CPU affinity"),
@@ -377,24 +389,27 @@ static int do_threads(struct worker *worker, struct perf_cpu_map *cpu)
 	return ret;
 }
 
+/* Each writer takes every nwriters-th worker, starting at its id */
 static void *writerfn(void *p)
 {
-	struct worker *worker = p;
+	struct writer *writer = p;
+	struct worker *worker = writer->worker;
 	size_t i, j, iter;
 	const uint64_t val = 1;
 	ssize_t sz;
 	struct timespec ts = { .tv_sec = 0,
 			       .tv_nsec = 500 };
 
-	printinfo("starting writer-thread: doing %s writes ...\n",
-		  randomize? "random":"lineal");
+	printinfo("starting writer-thread %u: doing %s writes ...\n",
+		  writer->id, randomize? "random":"lineal");
 
 	for (iter = 0; !wdone; iter++) {
-		if (randomize) {
+		/* the worker array is shared between writers */
+		if (randomize && nwriters == 1) {
 			shuffle((void *)worker, nthreads, sizeof(*worker));
 		}
 
-		for (i = 0; i < nthreads; i++) {
+		for (i = writer->id; i < nthreads; i += nwriters) {
 			struct worker *w = &worker[i];
 
 			if (randomize) {
@@ -411,7 +426,8 @@ static void *writerfn(void *p)
 		nanosleep(&ts, NULL);
 	}
 
-	printinfo("exiting writer-thread (total full-loops: %zd)\n", iter);
+	printinfo("exiting writer-thread %u (total full-loops: %zd)\n",
+		  writer->id, iter);
 	return NULL;
 }
 
@@ -429,12 +445,12 @@ int bench_epoll_wait(int argc, const char **argv)
 	struct sigaction act;
 	unsigned int i;
 	struct worker *worker = NULL;
+	struct writer *writer = NULL;
 	struct perf_cpu_map *cpu;
-	pthread_t wthread;
 	struct rlimit rl, prevrl;
 
 	argc = parse_options(argc, argv, options, bench_epoll_wait_usage, 0);
-	if (argc) {
+	if (argc || !nwriters) {
 		usage_with_options(bench_epoll_wait_usage, options);
 		exit(EXIT_FAILURE);
 	}
@@ -464,15 +480,23 @@ int bench_epoll_wait(int argc, const char **argv)
 	printinfo("Using %s queue model\n", multiq ? "multi" : "single");
 	printinfo("Nesting level(s): %d\n", nested);
 
-	/* default to the number of CPUs and leave one for the writer pthread */
-	if (!nthreads)
-		nthreads = perf_cpu_map__nr(cpu) - 1;
+	/* default to the number of CPUs and leave one for each writer pthread */
+	if (!nthreads) {
+		if ((unsigned int)perf_cpu_map__nr(cpu) > nwriters)
+			nthreads = perf_cpu_map__nr(cpu) - nwriters;
+		else
+			nthreads = 1;
+	}
 
 	worker = calloc(nthreads, sizeof(*worker));
 	if (!worker) {
 		goto errmem;
 	}
 
+	writer = calloc(nwriters, sizeof(*writer));
+	if (!writer)
+		goto errmem;
+
 	if (getrlimit(RLIMIT_NOFILE, &prevrl))
 		err(EXIT_FAILURE, "getrlimit");
 	rl.rlim_cur = rl.rlim_max = nfds * nthreads * 2 + 50;
@@ -482,8 +506,9 @@ int bench_epoll_wait(int argc, const char **argv)
 		err(EXIT_FAILURE, "setrlimit");
 
 	printf("Run summary [PID %d]: %d threads monitoring%s on "
-	       "%d file-descriptors for %d secs.\n\n",
-	       getpid(), nthreads, oneshot ? " (EPOLLONESHOT semantics)": "", nfds, nsecs);
+	       "%d file-descriptors, %d writer threads, for %d secs.\n\n",
+	       getpid(), nthreads, oneshot ? " (EPOLLONESHOT semantics)": "", nfds,
+	       nwriters, nsecs);
 
 	init_stats(&throughput_stats);
 	mutex_init(&thread_lock);
@@ -504,13 +529,16 @@ int bench_epoll_wait(int argc, const char **argv)
 
 	/*
 	 * At this point the workers should be blocked waiting for read events
-	 * to become ready. Launch the writer which will constantly be writing
+	 * to become ready. Launch the writers which will constantly be writing
 	 * to each thread's fdmap.
 	 */
-	ret = pthread_create(&wthread, NULL, writerfn,
-			     (void *)(struct worker *) worker);
-	if (ret)
-		err(EXIT_FAILURE, "pthread_create");
+	for (i = 0; i < nwriters; i++) {
+		writer[i].id = i;
+		writer[i].worker = worker;
+		ret = pthread_create(&writer[i].thread, NULL, writerfn, &writer[i]);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_create");
+	}
 
 	sleep(nsecs);
 	toggle_done(0, NULL, NULL);
@@ -518,9 +546,11 @@ int bench_epoll_wait(int argc, const char **argv)
 
 	sleep(1); /* meh */
 	wdone = true;
-	ret = pthread_join(wthread, NULL);
-	if (ret)
-		err(EXIT_FAILURE, "pthread_join");
+	for (i = 0; i < nwriters; i++) {
+		ret = pthread_join(writer[i].thread, NULL);
+		if (ret)
+			err(EXIT_FAILURE, "pthread_join");
+	}
 
 	/* cleanup & report results */
 	cond_destroy(&thread_parent);
@@ -553,6 +583,7 @@ int bench_epoll_wait(int argc, const char **argv)
 	for (i = 0; i < nthreads; i++)
 		free(worker[i].fdmap);
 
+	free(writer);
 	free(worker);
 	return ret;
 errmem:
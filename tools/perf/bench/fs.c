@@ -0,0 +1,502 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * fs.c
+ *
+ * fs: Benchmarks for VFS fast paths
+ *
+ *  lookup ... path walk of a deep directory chain
+ *  poll   ... poll() on a large set of fds with a few of them ready
+ *  fd-alloc ... threads dup()ing and closing fds in one file table
+ *  splice ... page cache data spliced through a pipe to /dev/null
+ */
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <linux/compiler.h>
+#include <linux/time64.h>
+#include <linux/types.h>
+
+static unsigned int	depth		= 16;
+static unsigned int	lookup_loops	= 1000000;
+static const char	*dir		= "/tmp";
+
+static const struct option lookup_options[] = {
+	OPT_UINTEGER('d', "depth", &depth, "Number of directories in the chain"),
+	OPT_UINTEGER('l', "loop", &lookup_loops, "Number of lookups for each case"),
+	OPT_STRING('D', "dir", &dir, "/tmp", "Directory to create the chain in"),
+	OPT_END()
+};
+
+static unsigned int	nfds		= 10000;
+static unsigned int	nready		= 1;
+static unsigned int	poll_loops	= 10000;
+
+static const struct option poll_options[] = {
+	OPT_UINTEGER('n', "nfds", &nfds, "Number of fds to poll"),
+	OPT_UINTEGER('r', "ready", &nready, "Number of ready fds, at the end of the set"),
+	OPT_UINTEGER('l', "loop", &poll_loops, "Number of poll() calls for each timeout"),
+	OPT_END()
+};
+
+static unsigned int	nthreads;
+static unsigned int	prefill;
+static unsigned int	fd_loops	= 1000000;
+
+static const struct option fd_alloc_options[] = {
+	OPT_UINTEGER('t', "threads", &nthreads, "Number of threads (default: number of online CPUs)"),
+	OPT_UINTEGER('n', "prefill", &prefill, "Number of fds to open before starting"),
+	OPT_UINTEGER('l', "loop", &fd_loops, "Number of dup() and close() pairs for each thread"),
+	OPT_END()
+};
+
+static unsigned int	splice_mb	= 256;
+static unsigned int	splice_loops	= 16;
+static unsigned int	splice_pipe_size;
+
+static const struct option splice_options[] = {
+	OPT_UINTEGER('s', "size", &splice_mb, "Size of the file in MB"),
+	OPT_UINTEGER('l', "loop", &splice_loops, "Number of times the whole file is spliced"),
+	OPT_UINTEGER('p', "pipe-size", &splice_pipe_size, "Size of the pipe (default: the system default)"),
+	OPT_STRING('D', "dir", &dir, "/tmp", "Directory to create the file in"),
+	OPT_END()
+};
+
+static const char * const bench_fs_lookup_usage[] = {
+	"perf bench fs lookup <options>",
+	NULL
+};
+
+static const char * const bench_fs_poll_usage[] = {
+	"perf bench fs poll <options>",
+	NULL
+};
+
+static const char * const bench_fs_fd_alloc_usage[] = {
+	"perf bench fs fd-alloc <options>",
+	NULL
+};
+
+static const char * const bench_fs_splice_usage[] = {
+	"perf bench fs splice <options>",
+	NULL
+};
+
+static void print_result(const char *what, unsigned long long ops,
+			 struct timeval *diff)
+{
+	u64 usecs = diff->tv_sec * USEC_PER_SEC + diff->tv_usec;
+	double nsecs_per_op = ops ? (double)usecs * NSEC_PER_USEC / ops : 0;
+
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf("# Executed %'llu %s\n", ops, what);
+		printf(" %14s: %lu.%03lu [sec]\n\n", "Total time",
+		       (unsigned long)diff->tv_sec,
+		       (unsigned long)(diff->tv_usec / USEC_PER_MSEC));
+		printf(" %14.3lf nsecs/op\n", nsecs_per_op);
+		printf(" %'14llu ops/sec\n\n",
+		       usecs ? ops * USEC_PER_SEC / usecs : 0);
+		break;
+
+	case BENCH_FORMAT_SIMPLE:
+		printf("%.3lf\n", nsecs_per_op);
+		break;
+
+	default:
+		/* reaching here is something disaster */
+		fprintf(stderr, "Unknown format:%d\n", bench_format);
+		exit(1);
+	}
+}
+
+/* Time @lookup_loops fstatat() calls, which must all succeed or all fail */
+static int run_lookup(const char *what, int dirfd, const char *path,
+		      bool expect_ok)
+{
+	struct timeval start, stop, diff;
+	struct stat st;
+	unsigned int i;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < lookup_loops; i++) {
+		if (!fstatat(dirfd, path, &st, 0) != expect_ok) {
+			fprintf(stderr, "Unexpected result for %s: %s\n", path,
+				strerror(errno));
+			return 1;
+		}
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	print_result(what, lookup_loops, &diff);
+	return 0;
+}
+
+int bench_fs_lookup(int argc, const char **argv)
+{
+	char root[PATH_MAX], path[PATH_MAX];
+	unsigned int i, made = 0;
+	int fd, dirfd, ret = 1;
+	size_t len;
+
+	argc = parse_options(argc, argv, lookup_options, bench_fs_lookup_usage, 0);
+	if (argc || !depth)
+		usage_with_options(bench_fs_lookup_usage, lookup_options);
+
+	snprintf(root, sizeof(root), "%s/perf-bench-fs-XXXXXX", dir);
+	if (!mkdtemp(root)) {
+		fprintf(stderr, "Cannot create a directory in %s: %s\n", dir,
+			strerror(errno));
+		return 1;
+	}
+
+	len = snprintf(path, sizeof(path), "%s", root);
+	for (made = 0; made < depth; made++) {
+		size_t n = snprintf(path + len, sizeof(path) - len, "/d%u", made);
+
+		if (len + n >= sizeof(path) - NAME_MAX) {
+			fprintf(stderr, "Depth %u is too large\n", depth);
+			goto out;
+		}
+		if (mkdir(path, 0755)) {
+			perror("mkdir");
+			goto out;
+		}
+		len += n;
+	}
+
+	snprintf(path + len, sizeof(path) - len, "/file");
+	fd = open(path, O_CREAT | O_WRONLY, 0644);
+	if (fd < 0) {
+		perror("open");
+		goto out;
+	}
+	close(fd);
+
+	/* The whole chain, then a negative dentry at the end of it */
+	if (run_lookup("absolute path lookups", AT_FDCWD, path, true))
+		goto out_file;
+	snprintf(path + len, sizeof(path) - len, "/missing");
+	if (run_lookup("absolute lookups of a missing file", AT_FDCWD, path, false))
+		goto out_file;
+
+	/* A single component from an fd of the parent, for comparison */
+	path[len] = '\0';
+	dirfd = open(path, O_PATH | O_DIRECTORY);
+	if (dirfd < 0) {
+		perror("open");
+		goto out_file;
+	}
+	ret = run_lookup("lookups relative to the parent", dirfd, "file", true);
+	close(dirfd);
+
+out_file:
+	snprintf(path + len, sizeof(path) - len, "/file");
+	unlink(path);
+out:
+	for (i = made; i > 0; i--) {
+		path[len] = '\0';
+		rmdir(path);
+		len = strrchr(path, '/') - path;
+	}
+	rmdir(root);
+	return ret;
+}
+
+/* Time @poll_loops poll() calls, which must each find the @nready fds */
+static int run_poll(const char *what, struct pollfd *pfds, int timeout)
+{
+	struct timeval start, stop, diff;
+	unsigned int i;
+	int ret;
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < poll_loops; i++) {
+		ret = poll(pfds, nfds, timeout);
+		if (ret != (int)nready) {
+			fprintf(stderr, "poll() returned %d, expected %u\n", ret,
+				nready);
+			return 1;
+		}
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	print_result(what, poll_loops, &diff);
+	return 0;
+}
+
+int bench_fs_poll(int argc, const char **argv)
+{
+	struct pollfd *pfds;
+	unsigned int i, made = 0;
+	struct rlimit rl;
+	int fds[2], *wfds, ret = 1;
+
+	argc = parse_options(argc, argv, poll_options, bench_fs_poll_usage, 0);
+	if (argc || !nfds || nready > nfds)
+		usage_with_options(bench_fs_poll_usage, poll_options);
+
+	/* Both ends of each pipe, and stdio */
+	if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < 2 * nfds + 16) {
+		rl.rlim_cur = 2 * nfds + 16;
+		if (rl.rlim_max < rl.rlim_cur)
+			rl.rlim_max = rl.rlim_cur;
+	}
+	if (setrlimit(RLIMIT_NOFILE, &rl)) {
+		fprintf(stderr, "Cannot allow %u fds: %s\n", 2 * nfds + 16,
+			strerror(errno));
+		return 1;
+	}
+
+	pfds = calloc(nfds, sizeof(*pfds));
+	wfds = calloc(nfds, sizeof(*wfds));
+	if (!pfds || !wfds) {
+		fprintf(stderr, "Not enough memory\n");
+		goto out;
+	}
+
+	/* Only the read ends are polled, the write ends keep them from POLLHUP */
+	for (made = 0; made < nfds; made++) {
+		if (pipe(fds)) {
+			perror("pipe");
+			goto out;
+		}
+		pfds[made].fd = fds[0];
+		pfds[made].events = POLLIN;
+		wfds[made] = fds[1];
+		if (made >= nfds - nready && write(fds[1], "x", 1) != 1) {
+			perror("write");
+			made++;
+			goto out;
+		}
+	}
+
+	/*
+	 * A blocking poll() registers a waiter for every fd it looks at until
+	 * it finds one ready, a zero timeout never registers any.
+	 */
+	if (run_poll("blocking poll() calls", pfds, -1))
+		goto out;
+	ret = run_poll("non-blocking poll() calls", pfds, 0);
+out:
+	for (i = 0; i < made; i++) {
+		close(pfds[i].fd);
+		close(wfds[i]);
+	}
+	free(wfds);
+	free(pfds);
+	return ret;
+}
+
+static int base_fd;
+
+static void *fd_alloc_thread(void *arg __maybe_unused)
+{
+	unsigned int i;
+	int fd;
+
+	for (i = 0; i < fd_loops; i++) {
+		fd = dup(base_fd);
+		if (fd < 0) {
+			perror("dup");
+			return (void *)1;
+		}
+		close(fd);
+	}
+	return NULL;
+}
+
+int bench_fs_fd_alloc(int argc, const char **argv)
+{
+	struct timeval start, stop, diff;
+	unsigned int i, started = 0;
+	pthread_t *threads;
+	struct rlimit rl;
+	int ret = 1;
+	void *err;
+
+	argc = parse_options(argc, argv, fd_alloc_options, bench_fs_fd_alloc_usage, 0);
+	if (argc)
+		usage_with_options(bench_fs_fd_alloc_usage, fd_alloc_options);
+	if (!nthreads)
+		nthreads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	if (getrlimit(RLIMIT_NOFILE, &rl) == 0 &&
+	    rl.rlim_cur < prefill + nthreads + 16) {
+		rl.rlim_cur = prefill + nthreads + 16;
+		if (rl.rlim_max < rl.rlim_cur)
+			rl.rlim_max = rl.rlim_cur;
+		if (setrlimit(RLIMIT_NOFILE, &rl)) {
+			fprintf(stderr, "Cannot allow %u fds: %s\n",
+				prefill + nthreads + 16, strerror(errno));
+			return 1;
+		}
+	}
+
+	threads = calloc(nthreads, sizeof(*threads));
+	if (!threads) {
+		fprintf(stderr, "Not enough memory\n");
+		return 1;
+	}
+
+	base_fd = open("/dev/null", O_RDONLY);
+	if (base_fd < 0) {
+		perror("open");
+		goto out_free;
+	}
+	/* Allocation has to search past these, they go away with the process */
+	for (i = 0; i < prefill; i++) {
+		if (dup(base_fd) < 0) {
+			perror("dup");
+			goto out_close;
+		}
+	}
+
+	gettimeofday(&start, NULL);
+	for (started = 0; started < nthreads; started++) {
+		if (pthread_create(&threads[started], NULL, fd_alloc_thread, NULL)) {
+			fprintf(stderr, "Cannot create thread %u\n", started);
+			break;
+		}
+	}
+	ret = started < nthreads;
+	for (i = 0; i < started; i++) {
+		pthread_join(threads[i], &err);
+		if (err)
+			ret = 1;
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	if (!ret) {
+		if (bench_format == BENCH_FORMAT_DEFAULT)
+			printf("# %u threads, %u fds prefilled\n", nthreads, prefill);
+		print_result("dup() and close() pairs",
+			     (unsigned long long)fd_loops * nthreads, &diff);
+	}
+out_close:
+	close(base_fd);
+out_free:
+	free(threads);
+	return ret;
+}
+
+static int splice_create_file(void)
+{
+	char path[PATH_MAX];
+	static char buf[1 << 20];
+	unsigned int i;
+	int fd;
+
+	snprintf(path, sizeof(path), "%s/perf-bench-splice-XXXXXX", dir);
+	fd = mkstemp(path);
+	if (fd < 0) {
+		fprintf(stderr, "Cannot create a file in %s: %s\n", dir,
+			strerror(errno));
+		return -1;
+	}
+	unlink(path);
+
+	memset(buf, 'x', sizeof(buf));
+	for (i = 0; i < splice_mb; i++) {
+		if (write(fd, buf, sizeof(buf)) != sizeof(buf)) {
+			perror("write");
+			close(fd);
+			return -1;
+		}
+	}
+
+	/* Read it back into the page cache, in large folios if it can */
+	posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	lseek(fd, 0, SEEK_SET);
+	while (read(fd, buf, sizeof(buf)) > 0)
+		;
+	return fd;
+}
+
+int bench_fs_splice(int argc, const char **argv)
+{
+	struct timeval start, stop, diff;
+	int fd, null_fd, pfd[2], ret = 1;
+	off_t size;
+	unsigned int i;
+	ssize_t in, out;
+	loff_t off;
+
+	argc = parse_options(argc, argv, splice_options, bench_fs_splice_usage, 0);
+	if (argc || !splice_mb || !splice_loops)
+		usage_with_options(bench_fs_splice_usage, splice_options);
+
+	fd = splice_create_file();
+	if (fd < 0)
+		return 1;
+	size = (off_t)splice_mb << 20;
+
+	null_fd = open("/dev/null", O_WRONLY);
+	if (null_fd < 0) {
+		perror("open");
+		goto out_file;
+	}
+	if (pipe(pfd)) {
+		perror("pipe");
+		goto out_null;
+	}
+	if (splice_pipe_size &&
+	    fcntl(pfd[1], F_SETPIPE_SZ, splice_pipe_size) < 0) {
+		perror("F_SETPIPE_SZ");
+		goto out_pipe;
+	}
+	splice_pipe_size = fcntl(pfd[1], F_GETPIPE_SZ);
+
+	/* /dev/null drops the buffers unread, all the cost is in the pipe */
+	gettimeofday(&start, NULL);
+	for (i = 0; i < splice_loops; i++) {
+		for (off = 0; off < size; ) {
+			in = splice(fd, &off, pfd[1], NULL, size - off, SPLICE_F_MOVE);
+			if (in <= 0) {
+				perror("splice");
+				goto out_pipe;
+			}
+			while (in) {
+				out = splice(pfd[0], NULL, null_fd, NULL, in,
+					     SPLICE_F_MOVE);
+				if (out <= 0) {
+					perror("splice");
+					goto out_pipe;
+				}
+				in -= out;
+			}
+		}
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf("# %u MB file, %u byte pipe\n", splice_mb, splice_pipe_size);
+	print_result("pages spliced",
+		     (unsigned long long)splice_loops * (size / sysconf(_SC_PAGESIZE)),
+		     &diff);
+	ret = 0;
+out_pipe:
+	close(pfd[0]);
+	close(pfd[1]);
+out_null:
+	close(null_fd);
+out_file:
+	close(fd);
+	return ret;
+}
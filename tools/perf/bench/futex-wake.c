@@ -47,6 +47,7 @@ static struct bench_futex_parameters params = {
 	 * Default to 1 in order to make the kernel work more.
 	 */
 	.nwakes  = 1,
+	.nbuckets = -1,
 };
 
 static const struct option options[] = {
@@ -55,6 +56,7 @@ static const struct option options[] = {
 	OPT_BOOLEAN( 's', "silent",  &params.silent, "Silent mode: do not display data/details"),
 	OPT_BOOLEAN( 'S', "shared",  &params.fshared, "Use shared futexes instead of private ones"),
 	OPT_BOOLEAN( 'm', "mlockall", &params.mlockall, "Lock all current and future memory"),
+	OPT_INTEGER( 'b', "buckets", &params.nbuckets, "Size of the private futex hash (0 = global hash)"),
 
 	OPT_END()
 };
@@ -93,6 +95,7 @@ static void print_summary(void)
 	       params.nthreads,
 	       waketime_avg / USEC_PER_MSEC,
 	       rel_stddev_stats(waketime_stddev, waketime_avg));
+	futex_print_nbuckets();
 }
 
 static void block_threads(pthread_t *w, struct perf_cpu_map *cpu)
@@ -173,6 +176,8 @@ int bench_futex_wake(int argc, const char **argv)
 	if (!params.fshared)
 		futex_flag = FUTEX_PRIVATE_FLAG;
 
+	futex_set_nbuckets_param(&params);
+
 	printf("Run summary [PID %d]: blocking on %d threads (at [%s] futex %p), "
 	       "waking up %d at a time.\n\n",
 	       getpid(), params.nthreads, params.fshared ? "shared":"private",
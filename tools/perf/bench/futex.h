@@ -8,11 +8,21 @@
 #ifndef _FUTEX_H
 #define _FUTEX_H
 
+#include <err.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <unistd.h>
+#include <sys/prctl.h>
 #include <sys/syscall.h>
 #include <sys/types.h>
 #include <linux/futex.h>
 
+#ifndef PR_FUTEX_HASH
+#define PR_FUTEX_HASH			78
+# define PR_FUTEX_HASH_SET_SLOTS	1
+# define PR_FUTEX_HASH_GET_SLOTS	2
+#endif
+
 struct bench_futex_parameters {
 	bool silent;
 	bool fshared;
@@ -25,6 +35,7 @@ struct bench_futex_parameters {
 	unsigned int nfutexes;
 	unsigned int nwakes;
 	unsigned int nrequeue;
+	int nbuckets; /* private futex hash size, -1 = kernel default */
 };
 
 /**
@@ -143,4 +154,29 @@ futex_cmp_requeue_pi(u_int32_t *uaddr, u_int32_t val, u_int32_t *uaddr2,
 					val, opflags);
 }
 
+/**
+ * futex_set_nbuckets_param() - size the private futex hash of the process
+ *
+ * Must be called before any thread is created, the kernel only allows
+ * setting the size while the process is single-threaded.
+ */
+static inline void futex_set_nbuckets_param(struct bench_futex_parameters *params)
+{
+	if (params->nbuckets < 0)
+		return;
+
+	if (prctl(PR_FUTEX_HASH, PR_FUTEX_HASH_SET_SLOTS, params->nbuckets, 0, 0))
+		err(EXIT_FAILURE, "prctl(PR_FUTEX_HASH, %d)", params->nbuckets);
+}
+
+static inline void futex_print_nbuckets(void)
+{
+	int ret = prctl(PR_FUTEX_HASH, PR_FUTEX_HASH_GET_SLOTS, 0, 0, 0);
+
+	if (ret > 0)
+		printf("Private futexes use a process hash of %d buckets\n", ret);
+	else
+		printf("Private futexes use the global hash\n");
+}
+
 #endif /* _FUTEX_H */
@@ -0,0 +1,236 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * mm.c
+ *
+ * mm: Benchmarks for memory management fast paths
+ *
+ *  fault     ... anonymous page fault throughput
+ *  vma       ... mmap()/munmap() VMA churn
+ *  pagecache ... read() from a file that is already in the page cache
+ */
+#include <subcmd/parse-options.h>
+#include "../util/string2.h"
+#include "bench.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <linux/time64.h>
+
+static const char	*size_str	= "64MB";
+static unsigned int	loops		= 10;
+static const char	*dir		= "/tmp";
+
+static const struct option fault_options[] = {
+	OPT_STRING('s', "size", &size_str, "64MB",
+		   "Size of the anonymous mapping to fault in (e.g. 1MB, 1GB)"),
+	OPT_UINTEGER('l', "loop", &loops, "Number of times to map, fault in and unmap"),
+	OPT_END()
+};
+
+static unsigned int	vma_loops	= 1000000;
+
+static const struct option vma_options[] = {
+	OPT_UINTEGER('l', "loop", &vma_loops, "Number of mmap()/munmap() pairs"),
+	OPT_END()
+};
+
+static const struct option pagecache_options[] = {
+	OPT_STRING('s', "size", &size_str, "64MB",
+		   "Size of the file to read (e.g. 1MB, 1GB)"),
+	OPT_UINTEGER('l', "loop", &loops, "Number of times to read the whole file"),
+	OPT_STRING('d', "dir", &dir, "/tmp", "Directory to create the file in"),
+	OPT_END()
+};
+
+static const char * const bench_mm_fault_usage[] = {
+	"perf bench mm fault <options>",
+	NULL
+};
+
+static const char * const bench_mm_vma_usage[] = {
+	"perf bench mm vma <options>",
+	NULL
+};
+
+static const char * const bench_mm_pagecache_usage[] = {
+	"perf bench mm pagecache <options>",
+	NULL
+};
+
+static size_t parse_size(const char *str, size_t min)
+{
+	s64 size = perf_atoll(str);
+
+	if (size < (s64)min) {
+		fprintf(stderr, "Invalid size: %s, must be at least %zu bytes\n", str, min);
+		exit(1);
+	}
+	return (size_t)size;
+}
+
+static void print_result(const char *what, unsigned long long ops,
+			 unsigned long long bytes, struct timeval *diff)
+{
+	u64 usecs = diff->tv_sec * USEC_PER_SEC + diff->tv_usec;
+	double nsecs_per_op = ops ? (double)usecs * NSEC_PER_USEC / ops : 0;
+
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf("# Executed %'llu %s\n", ops, what);
+		printf(" %14s: %lu.%03lu [sec]\n\n", "Total time",
+		       (unsigned long)diff->tv_sec,
+		       (unsigned long)(diff->tv_usec / USEC_PER_MSEC));
+		printf(" %14.3lf nsecs/op\n", nsecs_per_op);
+		printf(" %'14llu ops/sec\n",
+		       usecs ? ops * USEC_PER_SEC / usecs : 0);
+		if (bytes)
+			printf(" %14.3lf MB/sec\n",
+			       usecs ? (double)bytes / usecs : 0);
+		break;
+
+	case BENCH_FORMAT_SIMPLE:
+		/* nsecs/op is the one number to track across kernels */
+		printf("%.3lf\n", nsecs_per_op);
+		break;
+
+	default:
+		/* reaching here is something disaster */
+		fprintf(stderr, "Unknown format:%d\n", bench_format);
+		exit(1);
+	}
+}
+
+int bench_mm_fault(int argc, const char **argv)
+{
+	struct timeval start, stop, diff;
+	long page_size = sysconf(_SC_PAGESIZE);
+	size_t size, off;
+	unsigned int i;
+
+	argc = parse_options(argc, argv, fault_options, bench_mm_fault_usage, 0);
+	if (argc)
+		usage_with_options(bench_mm_fault_usage, fault_options);
+
+	size = parse_size(size_str, page_size);
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < loops; i++) {
+		char *p = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (p == MAP_FAILED) {
+			perror("mmap");
+			return 1;
+		}
+		for (off = 0; off < size; off += page_size)
+			p[off] = 1;
+		munmap(p, size);
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	print_result("page faults", (unsigned long long)loops * (size / page_size),
+		     0, &diff);
+	return 0;
+}
+
+int bench_mm_vma(int argc, const char **argv)
+{
+	struct timeval start, stop, diff;
+	long page_size = sysconf(_SC_PAGESIZE);
+	unsigned int i;
+
+	argc = parse_options(argc, argv, vma_options, bench_mm_vma_usage, 0);
+	if (argc)
+		usage_with_options(bench_mm_vma_usage, vma_options);
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < vma_loops; i++) {
+		void *p = mmap(NULL, page_size, PROT_READ | PROT_WRITE,
+			       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (p == MAP_FAILED) {
+			perror("mmap");
+			return 1;
+		}
+		munmap(p, page_size);
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	print_result("mmap()/munmap() pairs", vma_loops, 0, &diff);
+	return 0;
+}
+
+int bench_mm_pagecache(int argc, const char **argv)
+{
+	struct timeval start, stop, diff;
+	const size_t chunk = 64 * 1024;
+	char path[PATH_MAX];
+	size_t size, done;
+	unsigned int i;
+	char *buf;
+	int fd;
+
+	argc = parse_options(argc, argv, pagecache_options, bench_mm_pagecache_usage, 0);
+	if (argc)
+		usage_with_options(bench_mm_pagecache_usage, pagecache_options);
+
+	size = parse_size(size_str, chunk);
+	size -= size % chunk;
+
+	buf = malloc(chunk);
+	if (!buf) {
+		fprintf(stderr, "Not enough memory\n");
+		return 1;
+	}
+	memset(buf, 0x5a, chunk);
+
+	snprintf(path, sizeof(path), "%s/perf-bench-mm-XXXXXX", dir);
+	fd = mkstemp(path);
+	if (fd < 0) {
+		fprintf(stderr, "Cannot create a file in %s: %s\n", dir, strerror(errno));
+		free(buf);
+		return 1;
+	}
+	unlink(path);
+
+	/* Populate the page cache, the timed loop must not hit the disk */
+	for (done = 0; done < size; done += chunk) {
+		if (write(fd, buf, chunk) != (ssize_t)chunk) {
+			perror("write");
+			goto out_err;
+		}
+	}
+
+	gettimeofday(&start, NULL);
+	for (i = 0; i < loops; i++) {
+		for (done = 0; done < size; done += chunk) {
+			if (pread(fd, buf, chunk, done) != (ssize_t)chunk) {
+				perror("pread");
+				goto out_err;
+			}
+		}
+	}
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+
+	close(fd);
+	free(buf);
+
+	print_result("64KB reads", (unsigned long long)loops * (size / chunk),
+		     (unsigned long long)loops * size, &diff);
+	return 0;
+
+out_err:
+	close(fd);
+	free(buf);
+	return 1;
+}
@@ -0,0 +1,180 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * spawn.c
+ *
+ * spawn: Benchmark for starting a new program from a large parent
+ *
+ * Compares fork()+execve(), which copies the parent's page tables in
+ * dup_mmap(), with vfork()+execve() and posix_spawn(), which share the
+ * parent's mm until the child execs and so don't depend on its size.
+ */
+#include <subcmd/parse-options.h>
+#include "bench.h"
+
+#include <errno.h>
+#include <spawn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <linux/kernel.h>
+#include <linux/time64.h>
+
+extern char **environ;
+
+#define LOOPS_DEFAULT 1000
+
+static int loops = LOOPS_DEFAULT;
+static unsigned long parent_mb = 1024;
+static const char *program = "/bin/true";
+
+static const struct option options[] = {
+	OPT_INTEGER('l', "loop", &loops, "Specify number of loops"),
+	OPT_ULONG('s', "size", &parent_mb, "Memory mapped by the parent in MB"),
+	OPT_STRING('p', "program", &program, "path", "Program to spawn"),
+	OPT_END()
+};
+
+static const char * const bench_spawn_usage[] = {
+	"perf bench syscall spawn <options>",
+	NULL
+};
+
+static pid_t spawn_fork(char *const argv[])
+{
+	pid_t pid = fork();
+
+	if (!pid) {
+		execve(argv[0], argv, environ);
+		_exit(127);
+	}
+	return pid;
+}
+
+static pid_t spawn_vfork(char *const argv[])
+{
+	pid_t pid = vfork();
+
+	if (!pid) {
+		execve(argv[0], argv, environ);
+		_exit(127);
+	}
+	return pid;
+}
+
+static pid_t spawn_posix_spawn(char *const argv[])
+{
+	pid_t pid;
+	int err;
+
+	err = posix_spawn(&pid, argv[0], NULL, NULL, argv, environ);
+	if (err) {
+		errno = err;
+		return -1;
+	}
+	return pid;
+}
+
+static const struct spawn_method {
+	const char *name;
+	pid_t (*spawn)(char *const argv[]);
+} methods[] = {
+	{ "fork+execve",	spawn_fork		},
+	{ "vfork+execve",	spawn_vfork		},
+	{ "posix_spawn",	spawn_posix_spawn	},
+};
+
+static int run_method(const struct spawn_method *m, char *const argv[])
+{
+	struct timeval start, stop, diff;
+	unsigned long long result_usec;
+	int i, status;
+
+	gettimeofday(&start, NULL);
+
+	for (i = 0; i < loops; i++) {
+		pid_t pid = m->spawn(argv);
+
+		if (pid < 0) {
+			fprintf(stderr, "%s failed: %s\n", m->name, strerror(errno));
+			return -1;
+		}
+		if (waitpid(pid, &status, 0) < 0) {
+			fprintf(stderr, "waitpid failed: %s\n", strerror(errno));
+			return -1;
+		}
+		if (!WIFEXITED(status) || WEXITSTATUS(status) == 127) {
+			fprintf(stderr, "%s: %s did not run\n", m->name, argv[0]);
+			return -1;
+		}
+	}
+
+	gettimeofday(&stop, NULL);
+	timersub(&stop, &start, &diff);
+	result_usec = diff.tv_sec * USEC_PER_SEC + diff.tv_usec;
+
+	switch (bench_format) {
+	case BENCH_FORMAT_DEFAULT:
+		printf("# %-14s %14lf usecs/op %14d ops/sec\n", m->name,
+		       (double)result_usec / loops,
+		       (int)((double)loops / ((double)result_usec / USEC_PER_SEC)));
+		break;
+	case BENCH_FORMAT_SIMPLE:
+		printf("%s %lf\n", m->name, (double)result_usec / loops);
+		break;
+	default:
+		/* reaching here is something of a disaster */
+		fprintf(stderr, "Unknown format:%d\n", bench_format);
+		return -1;
+	}
+
+	return 0;
+}
+
+int bench_syscall_spawn(int argc, const char **argv)
+{
+	char *const child_argv[] = { (char *)program, NULL };
+	size_t size, off;
+	char *mem = NULL;
+	unsigned int i;
+	long page_size = sysconf(_SC_PAGESIZE);
+
+	argc = parse_options(argc, argv, options, bench_spawn_usage, 0);
+	if (argc)
+		usage_with_options(bench_spawn_usage, options);
+	if (loops <= 0) {
+		fprintf(stderr, "Invalid number of loops: %d\n", loops);
+		return 1;
+	}
+
+	size = parent_mb << 20;
+	if (size) {
+		mem = mmap(NULL, size, PROT_READ | PROT_WRITE,
+			   MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (mem == MAP_FAILED) {
+			fprintf(stderr, "Failed to map %lu MB: %s\n", parent_mb,
+				strerror(errno));
+			return 1;
+		}
+		/* Populate it, so that fork() has page tables to copy. */
+		for (off = 0; off < size; off += page_size)
+			mem[off] = 1;
+	}
+
+	if (bench_format == BENCH_FORMAT_DEFAULT)
+		printf("# Spawning %s %d times from a parent with %lu MB mapped\n\n",
+		       program, loops, parent_mb);
+
+	for (i = 0; i < ARRAY_SIZE(methods); i++) {
+		if (run_method(&methods[i], child_argv))
+			break;
+	}
+
+	if (mem)
+		munmap(mem, size);
+
+	return i == ARRAY_SIZE(methods) ? 0 : 1;
+}
@@ -13,6 +13,8 @@
  *  sched ... scheduler and IPC performance
  *  syscall ... System call performance
  *  mem   ... memory access performance
+ *  mm    ... memory management performance
+ *  fs    ... VFS performance
  *  numa  ... NUMA scheduling and MM performance
  *  futex ... Futex performance
  *  epoll ... Event poll performance
@@ -57,6 +59,7 @@ static struct bench syscall_benchmarks[] = {
 	{ "getpgid",	"Benchmark for getpgid(2) calls",		bench_syscall_getpgid	},
 	{ "fork",	"Benchmark for fork(2) calls",			bench_syscall_fork	},
 	{ "execve",	"Benchmark for execve(2) calls",		bench_syscall_execve	},
+	{ "spawn",	"Benchmark for spawning a program from a large process", bench_syscall_spawn },
 	{ "all",	"Run all syscall benchmarks",			NULL			},
 	{ NULL,		NULL,						NULL			},
 };
@@ -69,6 +72,23 @@ static struct bench mem_benchmarks[] = {
 	{ NULL,		NULL,						NULL			}
 };
 
+static struct bench mm_benchmarks[] = {
+	{ "fault",	"Benchmark for anonymous page faults",		bench_mm_fault		},
+	{ "vma",	"Benchmark for mmap()/munmap() calls",		bench_mm_vma		},
+	{ "pagecache",	"Benchmark for read() from the page cache",	bench_mm_pagecache	},
+	{ "all",	"Run all memory management benchmarks",		NULL			},
+	{ NULL,		NULL,						NULL			}
+};
+
+static struct bench fs_benchmarks[] = {
+	{ "lookup",	"Benchmark for deep path lookups",		bench_fs_lookup		},
+	{ "poll",	"Benchmark for poll() on many fds",		bench_fs_poll		},
+	{ "fd-alloc",	"Benchmark for fd allocation in a shared table",	bench_fs_fd_alloc	},
+	{ "splice",	"Benchmark for splicing page cache data through a pipe",	bench_fs_splice	},
+	{ "all",	"Run all VFS benchmarks",			NULL			},
+	{ NULL,		NULL,						NULL			}
+};
+
 static struct bench futex_benchmarks[] = {
 	{ "hash",	"Benchmark for futex hash table",               bench_futex_hash	},
 	{ "wake",	"Benchmark for futex wake calls",               bench_futex_wake	},
@@ -124,6 +144,8 @@ static struct collection collections[] = {
 	{ "sched",	"Scheduler and IPC benchmarks",			sched_benchmarks	},
 	{ "syscall",	"System call benchmarks",			syscall_benchmarks	},
 	{ "mem",	"Memory access benchmarks",			mem_benchmarks		},
+	{ "mm",		"Memory management benchmarks",			mm_benchmarks		},
+	{ "fs",		"VFS benchmarks",				fs_benchmarks		},
 #ifdef HAVE_LIBNUMA_SUPPORT
 	{ "numa",	"NUMA scheduling and MM benchmarks",		numa_benchmarks		},
 #endif
@@ -50,6 +50,7 @@
 #include "util/pmus.h"
 #include "util/clockid.h"
 #include "util/off_cpu.h"
+#include "util/sample_aggr.h"
 #include "util/bpf-filter.h"
 #include "asm/bug.h"
 #include "perf.h"
@@ -171,6 +172,7 @@ struct record {
 	bool			timestamp_filename;
 	bool			timestamp_boundary;
 	bool			off_cpu;
+	bool			aggregate;
 	struct switch_output	switch_output;
 	unsigned long long	samples;
 	unsigned long		output_max_size;	/* = 0: unlimited */
@@ -916,6 +918,19 @@ static int record__config_off_cpu(struct record *rec)
 	return off_cpu_prepare(rec->evlist, &rec->opts.target, &rec->opts);
 }
 
+static int record__config_aggregate_callchain(void)
+{
+	/* the aggregated samples are keyed by their frame pointer callchain */
+	if (!callchain_param.enabled) {
+		callchain_param.enabled = true;
+		callchain_param.record_mode = CALLCHAIN_FP;
+	} else if (callchain_param.record_mode != CALLCHAIN_FP) {
+		pr_err("--aggregate only works with --call-graph fp\n");
+		return -EINVAL;
+	}
+	return 0;
+}
+
 static bool record__tracking_system_wide(struct record *rec)
 {
 	struct evlist *evlist = rec->evlist;
@@ -2475,6 +2490,11 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 	}
 	/* Debug message used by test scripts */
 	pr_debug3("perf record done opening and mmapping events\n");
+
+	if (rec->aggregate && sample_aggr_attach(rec->evlist) < 0) {
+		err = -1;
+		goto out_free_threads;
+	}
 	session->header.env.comp_mmap_len = session->evlist->core.mmap_len;
 
 	if (rec->opts.kcore) {
@@ -2813,6 +2833,8 @@ static int __cmd_record(struct record *rec, int argc, const char **argv)
 
 	if (rec->off_cpu)
 		rec->bytes_written += off_cpu_write(rec->session);
+	if (rec->aggregate)
+		rec->bytes_written += sample_aggr_write(rec->session);
 
 	record__read_lost_samples(rec);
 	record__synthesize(rec, true);
@@ -3557,6 +3579,8 @@ static struct option __record_options[] = {
 			    "write collected trace data into several data files using parallel threads",
 			    record__parse_threads),
 	OPT_BOOLEAN(0, "off-cpu", &record.off_cpu, "Enable off-cpu analysis"),
+	OPT_BOOLEAN(0, "aggregate", &record.aggregate,
+		    "Count samples per callchain in the kernel and write one sample per callchain at the end"),
 	OPT_END()
 };
 
@@ -3974,6 +3998,7 @@ int cmd_record(int argc, const char **argv)
 #ifndef HAVE_BPF_SKEL
 # define set_nobuild(s, l, m, c) set_option_nobuild(record_options, s, l, m, c)
 	set_nobuild('\0', "off-cpu", "no BUILD_BPF_SKEL=1", true);
+	set_nobuild('\0', "aggregate", "no BUILD_BPF_SKEL=1", true);
 # undef set_nobuild
 #endif
 
@@ -4170,6 +4195,12 @@ int cmd_record(int argc, const char **argv)
 
 	evlist__warn_user_requested_cpus(rec->evlist, rec->opts.target.cpu_list);
 
+	if (rec->aggregate) {
+		err = record__config_aggregate_callchain();
+		if (err)
+			goto out;
+	}
+
 	if (callchain_param.enabled && callchain_param.record_mode == CALLCHAIN_FP)
 		arch__add_leaf_frame_record_opts(&rec->opts);
 
@@ -4212,6 +4243,15 @@ int cmd_record(int argc, const char **argv)
 		}
 	}
 
+	/* after off-cpu, whose record_end hook is chained from ours */
+	if (rec->aggregate) {
+		err = sample_aggr_prepare();
+		if (err) {
+			pr_err("sample_aggr_prepare failed, error %d\n", err);
+			goto out;
+		}
+	}
+
 	if (record_opts__config(&rec->opts)) {
 		err = -EINVAL;
 		goto out;
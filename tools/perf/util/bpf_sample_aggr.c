@@ -0,0 +1,240 @@
+// SPDX-License-Identifier: GPL-2.0
+#include "util/bpf_counter.h"
+#include "util/debug.h"
+#include "util/event.h"
+#include "util/evsel.h"
+#include "util/evlist.h"
+#include "util/perf-hooks.h"
+#include "util/sample.h"
+#include "util/sample_aggr.h"
+#include "util/session.h"
+#include "util/synthetic-events.h"
+#include <bpf/bpf.h>
+#include <bpf/libbpf.h>
+#include <internal/xyarray.h>
+#include <linux/err.h>
+#include <linux/zalloc.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bpf_skel/sample_aggr_data.h"
+#include "bpf_skel/sample_aggr.skel.h"
+
+#define FD(e, x, y) (*(int *)xyarray__entry(e->core.fd, x, y))
+
+/* like off-cpu samples, put the aggregated samples after everything else */
+#define SAMPLE_AGGR_TIMESTAMP  (~0ull << 32)
+
+static struct sample_aggr_bpf *skel;
+
+/* record_end hook set before ours, e.g. by off-cpu, called from ours */
+static perf_hook_func_t prev_record_end;
+static void *prev_record_end_ctx;
+
+static void sample_aggr_finish(void *arg __maybe_unused)
+{
+	sample_aggr_bpf__destroy(skel);
+	skel = NULL;
+
+	if (prev_record_end)
+		prev_record_end(prev_record_end_ctx);
+}
+
+int sample_aggr_prepare(void)
+{
+	skel = sample_aggr_bpf__open();
+	if (!skel) {
+		pr_err("Failed to open sample aggregation BPF skeleton\n");
+		return -1;
+	}
+
+	set_max_rlimit();
+
+	if (sample_aggr_bpf__load(skel)) {
+		pr_err("Failed to load sample aggregation BPF skeleton\n");
+		goto out;
+	}
+
+	prev_record_end = perf_hooks__get_hook("record_end");
+	if (IS_ERR(prev_record_end)) {
+		pr_err("Failed to get record_end hook\n");
+		goto out;
+	}
+	prev_record_end_ctx = perf_hooks__get_hook_ctx("record_end");
+
+	/* clear it first, it is chained rather than overwritten */
+	perf_hooks__set_hook("record_end", NULL, NULL);
+	if (perf_hooks__set_hook("record_end", sample_aggr_finish, NULL)) {
+		pr_err("Failed to set sample aggregation hook\n");
+		goto out;
+	}
+	return 0;
+
+out:
+	sample_aggr_bpf__destroy(skel);
+	skel = NULL;
+	return -1;
+}
+
+static bool sample_aggr_evsel(struct evsel *evsel)
+{
+	struct perf_event_attr *attr = &evsel->core.attr;
+
+	if (!attr->sample_period || attr->type == PERF_TYPE_TRACEPOINT)
+		return false;
+
+	/* tracking and BPF output events are not aggregated */
+	if (attr->type == PERF_TYPE_SOFTWARE &&
+	    (attr->config == PERF_COUNT_SW_DUMMY ||
+	     attr->config == PERF_COUNT_SW_BPF_OUTPUT))
+		return false;
+
+	if (attr->sample_type & ~SAMPLE_AGGR_SAMPLE_TYPES) {
+		pr_warning("%s: sample type %#llx can't be aggregated, recording samples as usual\n",
+			   evsel__name(evsel), (unsigned long long)attr->sample_type);
+		return false;
+	}
+	return true;
+}
+
+int sample_aggr_attach(struct evlist *evlist)
+{
+	struct bpf_program *prog = skel->progs.perf_sample_aggr;
+	struct bpf_link *link;
+	struct evsel *evsel;
+	int x, y;
+
+	evlist__for_each_entry(evlist, evsel) {
+		LIBBPF_OPTS(bpf_perf_event_opts, opts,
+			.bpf_cookie = evsel->core.idx,
+		);
+
+		if (!sample_aggr_evsel(evsel))
+			continue;
+
+		for (x = 0; x < xyarray__max_x(evsel->core.fd); x++) {
+			for (y = 0; y < xyarray__max_y(evsel->core.fd); y++) {
+				link = bpf_program__attach_perf_event_opts(prog, FD(evsel, x, y),
+									   &opts);
+				if (!link) {
+					pr_err("Failed to attach sample aggregation program to %s\n",
+					       evsel__name(evsel));
+					return -errno;
+				}
+			}
+		}
+	}
+	return 0;
+}
+
+/*
+ * Append one stack from the stack map to @chain, preceded by its @context
+ * marker. Nothing is added for an empty stack, so markers never follow each
+ * other. Set *@leaf to the first address if it is not set yet. Return the new
+ * length.
+ */
+static u64 sample_aggr_add_stack(struct ip_callchain *chain, u64 nr, u64 context,
+				 int stack_fd, int stack_id, u64 *ips, u64 *leaf)
+{
+	int i;
+
+	memset(ips, 0, SAMPLE_AGGR_MAX_STACKS * sizeof(u64));
+	if (bpf_map_lookup_elem(stack_fd, &stack_id, ips) || !ips[0])
+		return nr;
+
+	if (!*leaf)
+		*leaf = ips[0];
+
+	chain->ips[nr++] = context;
+	for (i = 0; i < SAMPLE_AGGR_MAX_STACKS && ips[i]; i++)
+		chain->ips[nr++] = ips[i];
+	return nr;
+}
+
+int sample_aggr_write(struct perf_session *session)
+{
+	struct perf_data_file *file = &session->data->file;
+	struct sample_aggr_key prev, key, *prev_key = NULL;
+	struct sample_aggr_data val;
+	u64 tstamp = SAMPLE_AGGR_TIMESTAMP;
+	u64 nr_samples = 0, nr_entries = 0;
+	struct ip_callchain *chain;
+	union perf_event *event;
+	int fd, stack_fd;
+	int bytes = 0;
+	u64 *ips;
+
+	event = zalloc(PERF_SAMPLE_MAX_SIZE);
+	chain = zalloc(sizeof(*chain) + (2 * SAMPLE_AGGR_MAX_STACKS + 2) * sizeof(u64));
+	ips = calloc(SAMPLE_AGGR_MAX_STACKS, sizeof(u64));
+	if (!event || !chain || !ips) {
+		pr_err("Failed to allocate memory for aggregated samples\n");
+		goto out;
+	}
+
+	fd = bpf_map__fd(skel->maps.samples);
+	stack_fd = bpf_map__fd(skel->maps.stacks);
+
+	while (!bpf_map_get_next_key(fd, prev_key, &key)) {
+		struct perf_sample sample = {};
+		struct evsel *evsel;
+		u64 sample_type;
+		u64 leaf = 0;
+		size_t size;
+		u64 nr = 0;
+
+		prev = key;
+		prev_key = &prev;
+
+		evsel = evlist__find_evsel(session->evlist, key.evsel_idx);
+		if (!evsel || bpf_map_lookup_elem(fd, &key, &val))
+			continue;
+
+		if (key.kernel_stack_id >= 0)
+			nr = sample_aggr_add_stack(chain, nr, PERF_CONTEXT_KERNEL,
+						   stack_fd, key.kernel_stack_id, ips, &leaf);
+		if (key.user_stack_id >= 0)
+			nr = sample_aggr_add_stack(chain, nr, PERF_CONTEXT_USER,
+						   stack_fd, key.user_stack_id, ips, &leaf);
+		chain->nr = nr;
+
+		sample.ip = leaf;
+		sample.cpumode = nr && chain->ips[0] == PERF_CONTEXT_KERNEL ?
+				 PERF_RECORD_MISC_KERNEL : PERF_RECORD_MISC_USER;
+		sample.cpu = key.cpu;
+		sample.pid = key.tgid;
+		sample.tid = key.pid;
+		sample.time = tstamp++;
+		if (evsel->core.id)
+			sample.id = evsel->core.id[0];
+		sample.period = val.period;
+		sample.callchain = chain;
+
+		sample_type = evsel->core.attr.sample_type;
+		size = perf_event__sample_event_size(&sample, sample_type, 0);
+
+		event->sample.header.type = PERF_RECORD_SAMPLE;
+		event->sample.header.misc = sample.cpumode;
+		event->sample.header.size = size;
+		if (perf_event__synthesize_sample(event, sample_type, 0, &sample))
+			continue;
+
+		if (perf_data_file__write(file, event, size) < 0) {
+			pr_err("failed to write perf data, error: %m\n");
+			goto out;
+		}
+		bytes += size;
+		nr_entries++;
+		nr_samples += val.count;
+	}
+
+	pr_debug("aggregated %" PRIu64 " samples into %" PRIu64 " entries, %d not aggregated\n",
+		 nr_samples, nr_entries, skel->bss->not_aggregated);
+out:
+	free(ips);
+	free(chain);
+	free(event);
+	return bytes;
+}
@@ -0,0 +1,77 @@
+// SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause)
+/*
+ * Count samples per (task, kernel stack, user stack) in a hash map and drop
+ * them instead of writing every one with its callchain to the ring buffer.
+ * The aggregated samples are written to the perf data file at the end.
+ */
+#include "vmlinux.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+#include "sample_aggr_data.h"
+
+#define EFAULT  14
+
+struct {
+	__uint(type, BPF_MAP_TYPE_STACK_TRACE);
+	__uint(key_size, sizeof(__u32));
+	__uint(value_size, SAMPLE_AGGR_MAX_STACKS * sizeof(__u64));
+	__uint(max_entries, SAMPLE_AGGR_MAX_ENTRIES);
+} stacks SEC(".maps");
+
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__type(key, struct sample_aggr_key);
+	__type(value, struct sample_aggr_data);
+	__uint(max_entries, SAMPLE_AGGR_MAX_ENTRIES);
+} samples SEC(".maps");
+
+/* samples which could not be aggregated and were written out as usual */
+int not_aggregated;
+
+/* -EFAULT just means there is no such part of the stack, e.g. no kernel stack */
+static inline bool stack_failed(int stack_id)
+{
+	return stack_id < 0 && stack_id != -EFAULT;
+}
+
+SEC("perf_event")
+int perf_sample_aggr(struct bpf_perf_event_data *ctx)
+{
+	__u64 pid_tgid = bpf_get_current_pid_tgid();
+	struct sample_aggr_key key = {};
+	struct sample_aggr_data *data;
+
+	/* the cookie is the evsel index, set by perf when attaching */
+	key.evsel_idx = bpf_get_attach_cookie(ctx);
+	key.cpu = bpf_get_smp_processor_id();
+	key.pid = pid_tgid;
+	key.tgid = pid_tgid >> 32;
+	key.kernel_stack_id = bpf_get_stackid(ctx, &stacks, 0);
+	key.user_stack_id = bpf_get_stackid(ctx, &stacks, BPF_F_USER_STACK);
+
+	if (stack_failed(key.kernel_stack_id) || stack_failed(key.user_stack_id))
+		goto fallback;
+
+	data = bpf_map_lookup_elem(&samples, &key);
+	if (!data) {
+		struct sample_aggr_data init = {};
+
+		bpf_map_update_elem(&samples, &key, &init, BPF_NOEXIST);
+		data = bpf_map_lookup_elem(&samples, &key);
+		if (!data)
+			goto fallback;
+	}
+
+	__sync_fetch_and_add(&data->count, 1);
+	__sync_fetch_and_add(&data->period, ctx->sample_period);
+
+	/* don't generate the sample, it is written out from the map */
+	return 0;
+
+fallback:
+	__sync_fetch_and_add(&not_aggregated, 1);
+	return 1;
+}
+
+char LICENSE[] SEC("license") = "Dual BSD/GPL";
@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: (GPL-2.0-only OR BSD-2-Clause) */
+/* Data structures shared between BPF and tools. */
+#ifndef PERF_SAMPLE_AGGR_DATA_H
+#define PERF_SAMPLE_AGGR_DATA_H
+
+#define SAMPLE_AGGR_MAX_STACKS   64
+#define SAMPLE_AGGR_MAX_ENTRIES  16384
+
+struct sample_aggr_key {
+	__u32 evsel_idx;
+	__u32 cpu;
+	__u32 pid;
+	__u32 tgid;
+	/* negative if the sample has no kernel or no user part */
+	__s32 kernel_stack_id;
+	__s32 user_stack_id;
+};
+
+struct sample_aggr_data {
+	__u64 count;
+	__u64 period;
+};
+
+#endif /* PERF_SAMPLE_AGGR_DATA_H */
@@ -88,3 +88,16 @@ perf_hook_func_t perf_hooks__get_hook(const char *hook_name)
 	}
 	return ERR_PTR(-ENOENT);
 }
+
+void *perf_hooks__get_hook_ctx(const char *hook_name)
+{
+	unsigned int i;
+
+	for (i = 0; i < ARRAY_SIZE(perf_hooks); i++) {
+		if (strcmp(hook_name, perf_hooks[i]->hook_name) != 0)
+			continue;
+
+		return perf_hooks[i]->hook_ctx;
+	}
+	return NULL;
+}
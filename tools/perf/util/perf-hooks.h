@@ -34,6 +34,9 @@ perf_hooks__set_hook(const char *hook_name,
 extern perf_hook_func_t
 perf_hooks__get_hook(const char *hook_name);
 
+extern void *
+perf_hooks__get_hook_ctx(const char *hook_name);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,37 @@
+#ifndef PERF_UTIL_SAMPLE_AGGR_H
+#define PERF_UTIL_SAMPLE_AGGR_H
+
+#include <linux/compiler.h>
+#include <linux/perf_event.h>
+
+struct evlist;
+struct perf_session;
+
+/* sample types which can be synthesized from the aggregated data */
+#define SAMPLE_AGGR_SAMPLE_TYPES  (PERF_SAMPLE_IDENTIFIER | PERF_SAMPLE_IP | \
+				   PERF_SAMPLE_TID | PERF_SAMPLE_TIME | \
+				   PERF_SAMPLE_ID | PERF_SAMPLE_CPU | \
+				   PERF_SAMPLE_PERIOD | PERF_SAMPLE_CALLCHAIN)
+
+#ifdef HAVE_BPF_SKEL
+int sample_aggr_prepare(void);
+int sample_aggr_attach(struct evlist *evlist);
+int sample_aggr_write(struct perf_session *session);
+#else
+static inline int sample_aggr_prepare(void)
+{
+	return -1;
+}
+
+static inline int sample_aggr_attach(struct evlist *evlist __maybe_unused)
+{
+	return -1;
+}
+
+static inline int sample_aggr_write(struct perf_session *session __maybe_unused)
+{
+	return -1;
+}
+#endif
+
+#endif  /* PERF_UTIL_SAMPLE_AGGR_H */
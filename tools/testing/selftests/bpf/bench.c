@@ -282,6 +282,9 @@ extern struct argp bench_local_storage_create_argp;
 extern struct argp bench_htab_mem_argp;
 extern struct argp bench_trigger_batch_argp;
 extern struct argp bench_crypto_argp;
+extern struct argp bench_htab_lookup_elems_argp;
+extern struct argp bench_lpm_trie_lookup_argp;
+extern struct argp bench_ringbuf_percpu_argp;
 
 static const struct argp_child bench_parsers[] = {
 	{ &bench_ringbufs_argp, 0, "Ring buffers benchmark", 0 },
@@ -296,6 +299,9 @@ static const struct argp_child bench_parsers[] = {
 	{ &bench_htab_mem_argp, 0, "hash map memory benchmark", 0 },
 	{ &bench_trigger_batch_argp, 0, "BPF triggering benchmark", 0 },
 	{ &bench_crypto_argp, 0, "bpf crypto benchmark", 0 },
+	{ &bench_htab_lookup_elems_argp, 0, "hash map batched lookup benchmark", 0 },
+	{ &bench_lpm_trie_lookup_argp, 0, "LPM trie lookup benchmark", 0 },
+	{ &bench_ringbuf_percpu_argp, 0, "Per-CPU ring buffers benchmark", 0 },
 	{},
 };
 
@@ -542,6 +548,12 @@ extern const struct bench bench_local_storage_create;
 extern const struct bench bench_htab_mem;
 extern const struct bench bench_crypto_encrypt;
 extern const struct bench bench_crypto_decrypt;
+extern const struct bench bench_htab_lookup_single;
+extern const struct bench bench_htab_lookup_batch;
+extern const struct bench bench_lpm_trie_lookup;
+extern const struct bench bench_lpm_trie_htab_lookup;
+extern const struct bench bench_rb_shared;
+extern const struct bench bench_rb_percpu;
 
 static const struct bench *benchs[] = {
 	&bench_count_global,
@@ -596,6 +608,12 @@ static const struct bench *benchs[] = {
 	&bench_htab_mem,
 	&bench_crypto_encrypt,
 	&bench_crypto_decrypt,
+	&bench_htab_lookup_single,
+	&bench_htab_lookup_batch,
+	&bench_lpm_trie_lookup,
+	&bench_lpm_trie_htab_lookup,
+	&bench_rb_shared,
+	&bench_rb_percpu,
 };
 
 static void find_benchmark(void)
@@ -0,0 +1,150 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Compare looking up keys in a large hash map one by one with
+ * bpf_map_lookup_elem() against looking them up in batches with the
+ * bpf_map_lookup_elems() kfunc, which overlaps the cache misses of the
+ * individual lookups. Reports lookups per second.
+ */
+#include <argp.h>
+#include "bench.h"
+#include "htab_lookup_elems_bench.skel.h"
+
+static struct htab_lookup_elems_ctx {
+	struct htab_lookup_elems_bench *skel;
+} ctx;
+
+static struct {
+	__u32 nr_entries;
+} args = {
+	.nr_entries = 1 << 20,
+};
+
+enum {
+	ARG_NR_ENTRIES = 10000,
+};
+
+static const struct argp_option opts[] = {
+	{ "nr_entries", ARG_NR_ENTRIES, "NR_ENTRIES", 0,
+	  "Number of keys in the hash map (at most 1048576)" },
+	{},
+};
+
+static error_t parse_arg(int key, char *arg, struct argp_state *state)
+{
+	long ret;
+
+	switch (key) {
+	case ARG_NR_ENTRIES:
+		ret = strtol(arg, NULL, 10);
+		if (ret < 1 || ret > 1 << 20) {
+			fprintf(stderr, "invalid nr_entries\n");
+			argp_usage(state);
+		}
+		args.nr_entries = ret;
+		break;
+	default:
+		return ARGP_ERR_UNKNOWN;
+	}
+
+	return 0;
+}
+
+const struct argp bench_htab_lookup_elems_argp = {
+	.options = opts,
+	.parser = parse_arg,
+};
+
+static void validate(void)
+{
+	if (env.consumer_cnt != 0) {
+		fprintf(stderr, "benchmark doesn't support consumer!\n");
+		exit(1);
+	}
+}
+
+static void *producer(void *input)
+{
+	while (true)
+		/* trigger the bpf program */
+		syscall(__NR_getpgid);
+
+	return NULL;
+}
+
+static void measure(struct bench_res *res)
+{
+	res->hits = atomic_swap(&ctx.skel->bss->hits, 0);
+}
+
+static void setup(bool batch)
+{
+	struct bpf_link *link;
+	__u64 value = 0;
+	int map_fd;
+	__u32 i;
+
+	setup_libbpf();
+
+	ctx.skel = htab_lookup_elems_bench__open();
+	if (!ctx.skel) {
+		fprintf(stderr, "failed to open skeleton\n");
+		exit(1);
+	}
+
+	ctx.skel->bss->nr_entries = args.nr_entries;
+	bpf_program__set_autoload(batch ? ctx.skel->progs.lookup_single :
+					  ctx.skel->progs.lookup_batch, false);
+
+	if (htab_lookup_elems_bench__load(ctx.skel)) {
+		fprintf(stderr, "failed to load skeleton\n");
+		exit(1);
+	}
+
+	map_fd = bpf_map__fd(ctx.skel->maps.htab);
+	for (i = 0; i < args.nr_entries; i++) {
+		value = i;
+		if (bpf_map_update_elem(map_fd, &i, &value, BPF_ANY)) {
+			fprintf(stderr, "failed to populate the map\n");
+			exit(1);
+		}
+	}
+
+	link = bpf_program__attach(batch ? ctx.skel->progs.lookup_batch :
+					   ctx.skel->progs.lookup_single);
+	if (!link) {
+		fprintf(stderr, "failed to attach program!\n");
+		exit(1);
+	}
+}
+
+static void htab_lookup_single_setup(void)
+{
+	setup(false);
+}
+
+static void htab_lookup_batch_setup(void)
+{
+	setup(true);
+}
+
+const struct bench bench_htab_lookup_single = {
+	.name = "htab-lookup-single",
+	.argp = &bench_htab_lookup_elems_argp,
+	.validate = validate,
+	.setup = htab_lookup_single_setup,
+	.producer_thread = producer,
+	.measure = measure,
+	.report_progress = hits_drops_report_progress,
+	.report_final = hits_drops_report_final,
+};
+
+const struct bench bench_htab_lookup_batch = {
+	.name = "htab-lookup-batch",
+	.argp = &bench_htab_lookup_elems_argp,
+	.validate = validate,
+	.setup = htab_lookup_batch_setup,
+	.producer_thread = producer,
+	.measure = measure,
+	.report_progress = hits_drops_report_progress,
+	.report_final = hits_drops_report_final,
+};
@@ -0,0 +1,227 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Measure IPv6 lookups in an LPM trie filled with random prefixes, and
+ * the same prefixes looked up as exact keys in a hash map of the same
+ * size for comparison. Every lookup should match: they are reported as
+ * hits, and any miss as a drop.
+ */
+#include <argp.h>
+#include <string.h>
+#include "bench.h"
+#include "lpm_trie_lookup_bench.skel.h"
+
+#define NR_ADDRS	(1 << 16)
+
+struct lpm_v6_key {
+	__u32 prefixlen;
+	__u8 addr[16];
+};
+
+static struct lpm_trie_lookup_ctx {
+	struct lpm_trie_lookup_bench *skel;
+} ctx;
+
+static struct {
+	__u32 nr_entries;
+	__u32 min_prefixlen;
+	__u32 max_prefixlen;
+} args = {
+	.nr_entries = 1 << 16,
+	.min_prefixlen = 16,
+	.max_prefixlen = 64,
+};
+
+enum {
+	ARG_NR_ENTRIES = 10100,
+	ARG_MIN_PREFIXLEN,
+	ARG_MAX_PREFIXLEN,
+};
+
+static const struct argp_option opts[] = {
+	{ "nr_entries", ARG_NR_ENTRIES, "NR_ENTRIES", 0,
+	  "Number of prefixes in the trie (at most 1048576)" },
+	{ "min_prefixlen", ARG_MIN_PREFIXLEN, "LEN", 0,
+	  "Shortest prefix length" },
+	{ "max_prefixlen", ARG_MAX_PREFIXLEN, "LEN", 0,
+	  "Longest prefix length" },
+	{},
+};
+
+static error_t parse_arg(int key, char *arg, struct argp_state *state)
+{
+	long ret = strtol(arg, NULL, 10);
+
+	switch (key) {
+	case ARG_NR_ENTRIES:
+		if (ret < 1 || ret > 1 << 20) {
+			fprintf(stderr, "invalid nr_entries\n");
+			argp_usage(state);
+		}
+		args.nr_entries = ret;
+		break;
+	case ARG_MIN_PREFIXLEN:
+	case ARG_MAX_PREFIXLEN:
+		if (ret < 1 || ret > 128) {
+			fprintf(stderr, "invalid prefix length\n");
+			argp_usage(state);
+		}
+		if (key == ARG_MIN_PREFIXLEN)
+			args.min_prefixlen = ret;
+		else
+			args.max_prefixlen = ret;
+		break;
+	default:
+		return ARGP_ERR_UNKNOWN;
+	}
+
+	return 0;
+}
+
+const struct argp bench_lpm_trie_lookup_argp = {
+	.options = opts,
+	.parser = parse_arg,
+};
+
+static void validate(void)
+{
+	if (env.consumer_cnt != 0) {
+		fprintf(stderr, "benchmark doesn't support consumer!\n");
+		exit(1);
+	}
+	if (args.min_prefixlen > args.max_prefixlen) {
+		fprintf(stderr, "min_prefixlen larger than max_prefixlen\n");
+		exit(1);
+	}
+}
+
+static void *producer(void *input)
+{
+	while (true)
+		/* trigger the bpf program */
+		syscall(__NR_getpgid);
+
+	return NULL;
+}
+
+static void measure(struct bench_res *res)
+{
+	res->hits = atomic_swap(&ctx.skel->bss->hits, 0);
+	res->drops = atomic_swap(&ctx.skel->bss->drops, 0);
+}
+
+static void random_prefix(struct lpm_v6_key *key, __u32 prefixlen)
+{
+	int i;
+
+	key->prefixlen = prefixlen;
+	for (i = 0; i < 16; i++)
+		key->addr[i] = i * 8 < prefixlen ? random() : 0;
+	if (prefixlen % 8 && prefixlen < 128)
+		key->addr[prefixlen / 8] &= 0xff << (8 - prefixlen % 8);
+}
+
+/* Turn a prefix into a full length address with random host bits */
+static void random_address(struct lpm_v6_key *key)
+{
+	__u32 prefixlen = key->prefixlen;
+	int i;
+
+	for (i = prefixlen / 8; i < 16; i++) {
+		__u8 host = random();
+
+		if (i == prefixlen / 8)
+			host &= 0xff >> (prefixlen % 8);
+		key->addr[i] |= host;
+	}
+	key->prefixlen = 128;
+}
+
+static void setup(bool trie)
+{
+	__u32 span = args.max_prefixlen - args.min_prefixlen + 1;
+	struct lpm_v6_key key;
+	int trie_fd, htab_fd;
+	struct bpf_link *link;
+	__u32 i, value;
+
+	setup_libbpf();
+	srandom(1);
+
+	ctx.skel = lpm_trie_lookup_bench__open();
+	if (!ctx.skel) {
+		fprintf(stderr, "failed to open skeleton\n");
+		exit(1);
+	}
+
+	bpf_program__set_autoload(trie ? ctx.skel->progs.lookup_htab :
+					 ctx.skel->progs.lookup_trie, false);
+
+	if (lpm_trie_lookup_bench__load(ctx.skel)) {
+		fprintf(stderr, "failed to load skeleton\n");
+		exit(1);
+	}
+
+	trie_fd = bpf_map__fd(ctx.skel->maps.trie);
+	htab_fd = bpf_map__fd(ctx.skel->maps.htab);
+	for (i = 0; i < args.nr_entries; i++) {
+		random_prefix(&key, args.min_prefixlen + random() % span);
+		value = i;
+		if (bpf_map_update_elem(trie_fd, &key, &value, BPF_ANY) ||
+		    bpf_map_update_elem(htab_fd, &key, &value, BPF_ANY)) {
+			fprintf(stderr, "failed to populate the maps\n");
+			exit(1);
+		}
+		if (i >= NR_ADDRS)
+			continue;
+		/*
+		 * The trie is looked up with an address within the prefix,
+		 * the hash map with the exact key it holds.
+		 */
+		if (trie)
+			random_address(&key);
+		memcpy(&ctx.skel->bss->addrs[i], &key, sizeof(key));
+	}
+	/* Fewer prefixes than addresses, look them up again */
+	for (; i < NR_ADDRS; i++)
+		memcpy(&ctx.skel->bss->addrs[i],
+		       &ctx.skel->bss->addrs[i % args.nr_entries], sizeof(key));
+
+	link = bpf_program__attach(trie ? ctx.skel->progs.lookup_trie :
+					  ctx.skel->progs.lookup_htab);
+	if (!link) {
+		fprintf(stderr, "failed to attach program!\n");
+		exit(1);
+	}
+}
+
+static void lpm_trie_lookup_setup(void)
+{
+	setup(true);
+}
+
+static void lpm_trie_htab_lookup_setup(void)
+{
+	setup(false);
+}
+
+const struct bench bench_lpm_trie_lookup = {
+	.name = "lpm-trie-lookup",
+	.argp = &bench_lpm_trie_lookup_argp,
+	.validate = validate,
+	.setup = lpm_trie_lookup_setup,
+	.producer_thread = producer,
+	.measure = measure,
+	.report_progress = hits_drops_report_progress,
+	.report_final = hits_drops_report_final,
+};
+
+const struct bench bench_lpm_trie_htab_lookup = {
+	.name = "lpm-trie-htab-lookup",
+	.argp = &bench_lpm_trie_lookup_argp,
+	.validate = validate,
+	.setup = lpm_trie_htab_lookup_setup,
+	.producer_thread = producer,
+	.measure = measure,
+	.report_progress = hits_drops_report_progress,
+	.report_final = hits_drops_report_final,
+};
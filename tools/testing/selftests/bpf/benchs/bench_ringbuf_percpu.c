@@ -0,0 +1,206 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Compare many producers sharing one BPF ring buffer with one ring buffer
+ * per CPU, looked up from an array of maps by the producing CPU and all
+ * consumed through a single libbpf ring_buffer (one epoll fd). Reports
+ * consumed samples and drops per second.
+ */
+#include <argp.h>
+#include <linux/err.h>
+#include <sys/sysinfo.h>
+#include "bench.h"
+#include "ringbuf_percpu_bench.skel.h"
+
+static struct {
+	int batch_cnt;
+	int ringbuf_sz;
+} args = {
+	.batch_cnt = 500,
+	.ringbuf_sz = 512 * 1024,
+};
+
+enum {
+	ARG_RB_PERCPU_BATCH_CNT = 10200,
+	ARG_RB_PERCPU_SZ,
+};
+
+static const struct argp_option opts[] = {
+	{ "rb-percpu-batch-cnt", ARG_RB_PERCPU_BATCH_CNT, "CNT", 0,
+	  "Set BPF-side record batch count" },
+	{ "rb-percpu-size", ARG_RB_PERCPU_SZ, "SIZE", 0,
+	  "Size of each ring buffer in bytes, a power of 2 multiple of the page size" },
+	{},
+};
+
+static error_t parse_arg(int key, char *arg, struct argp_state *state)
+{
+	switch (key) {
+	case ARG_RB_PERCPU_BATCH_CNT:
+		args.batch_cnt = strtol(arg, NULL, 10);
+		if (args.batch_cnt < 0) {
+			fprintf(stderr, "Invalid batch count.");
+			argp_usage(state);
+		}
+		break;
+	case ARG_RB_PERCPU_SZ:
+		args.ringbuf_sz = strtol(arg, NULL, 10);
+		break;
+	default:
+		return ARGP_ERR_UNKNOWN;
+	}
+
+	return 0;
+}
+
+const struct argp bench_ringbuf_percpu_argp = {
+	.options = opts,
+	.parser = parse_arg,
+};
+
+static struct ringbuf_percpu_ctx {
+	struct ringbuf_percpu_bench *skel;
+	struct ring_buffer *ringbuf;
+	struct counter hits;
+} ctx;
+
+static void validate(void)
+{
+	if (env.consumer_cnt != 1) {
+		fprintf(stderr, "benchmark needs exactly one consumer!\n");
+		exit(1);
+	}
+}
+
+static void *producer(void *input)
+{
+	while (true)
+		/* trigger the bpf program */
+		syscall(__NR_getpgid);
+
+	return NULL;
+}
+
+static int process_sample(void *ctx_, void *data, size_t len)
+{
+	atomic_inc(&ctx.hits.value);
+	return 0;
+}
+
+static void *consumer(void *input)
+{
+	while (ring_buffer__poll(ctx.ringbuf, -1) >= 0)
+		;
+
+	fprintf(stderr, "ring_buffer__poll failed\n");
+	return NULL;
+}
+
+static void measure(struct bench_res *res)
+{
+	res->hits = atomic_swap(&ctx.hits.value, 0);
+	res->drops = atomic_swap(&ctx.skel->bss->dropped, 0);
+}
+
+static void setup(bool per_cpu)
+{
+	int nr_cpus = get_nprocs_conf();
+	struct bpf_link *link;
+	int i, fd, proto_fd;
+
+	setup_libbpf();
+
+	ctx.skel = ringbuf_percpu_bench__open();
+	if (!ctx.skel) {
+		fprintf(stderr, "failed to open skeleton\n");
+		exit(1);
+	}
+
+	ctx.skel->rodata->batch_cnt = args.batch_cnt;
+	ctx.skel->rodata->per_cpu = per_cpu;
+
+	bpf_map__set_max_entries(ctx.skel->maps.ringbuf, args.ringbuf_sz);
+	bpf_map__set_max_entries(ctx.skel->maps.ringbuf_arr, nr_cpus);
+
+	proto_fd = bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0,
+				  args.ringbuf_sz, NULL);
+	if (proto_fd < 0 ||
+	    bpf_map__set_inner_map_fd(ctx.skel->maps.ringbuf_arr, proto_fd)) {
+		fprintf(stderr, "failed to create ring buffer template\n");
+		exit(1);
+	}
+
+	if (ringbuf_percpu_bench__load(ctx.skel)) {
+		fprintf(stderr, "failed to load skeleton\n");
+		exit(1);
+	}
+	close(proto_fd);
+
+	if (!per_cpu) {
+		ctx.ringbuf = ring_buffer__new(bpf_map__fd(ctx.skel->maps.ringbuf),
+					       process_sample, NULL, NULL);
+	} else {
+		for (i = 0; i < nr_cpus; i++) {
+			fd = bpf_map_create(BPF_MAP_TYPE_RINGBUF, NULL, 0, 0,
+					    args.ringbuf_sz, NULL);
+			if (fd < 0 ||
+			    bpf_map_update_elem(bpf_map__fd(ctx.skel->maps.ringbuf_arr),
+						&i, &fd, BPF_ANY)) {
+				fprintf(stderr, "failed to set up ring buffer %d\n", i);
+				exit(1);
+			}
+
+			if (!i)
+				ctx.ringbuf = ring_buffer__new(fd, process_sample,
+							       NULL, NULL);
+			else if (ctx.ringbuf &&
+				 ring_buffer__add(ctx.ringbuf, fd, process_sample, NULL)) {
+				fprintf(stderr, "failed to add ring buffer %d\n", i);
+				exit(1);
+			}
+		}
+	}
+	if (!ctx.ringbuf) {
+		fprintf(stderr, "failed to create ringbuf manager\n");
+		exit(1);
+	}
+
+	link = bpf_program__attach(ctx.skel->progs.bench_ringbuf_percpu);
+	if (!link) {
+		fprintf(stderr, "failed to attach program!\n");
+		exit(1);
+	}
+}
+
+static void ringbuf_shared_setup(void)
+{
+	setup(false);
+}
+
+static void ringbuf_percpu_setup(void)
+{
+	setup(true);
+}
+
+const struct bench bench_rb_shared = {
+	.name = "rb-shared",
+	.argp = &bench_ringbuf_percpu_argp,
+	.validate = validate,
+	.setup = ringbuf_shared_setup,
+	.producer_thread = producer,
+	.consumer_thread = consumer,
+	.measure = measure,
+	.report_progress = hits_drops_report_progress,
+	.report_final = hits_drops_report_final,
+};
+
+const struct bench bench_rb_percpu = {
+	.name = "rb-percpu",
+	.argp = &bench_ringbuf_percpu_argp,
+	.validate = validate,
+	.setup = ringbuf_percpu_setup,
+	.producer_thread = producer,
+	.consumer_thread = consumer,
+	.measure = measure,
+	.report_progress = hits_drops_report_progress,
+	.report_final = hits_drops_report_final,
+};
@@ -10,6 +10,30 @@
 #define round_up(x, y) ((((x)-1) | __round_mask(x, y))+1)
 #endif
 
+/*
+ * Size class allocator on top of bpf_alloc(). Requests are rounded up to a
+ * power of two between ARENA_SC_MIN and ARENA_SC_MAX bytes. Freed objects go
+ * onto a per-CPU free list of their class and are handed out again by the
+ * next allocation of that class on that CPU, so long lived and short lived
+ * objects sharing a page don't pin it. Pages holding size class objects are
+ * not given back to the arena.
+ */
+#define ARENA_SC_MIN_SHIFT	4
+#define ARENA_SC_NR		8
+#define ARENA_SC_MIN		(1U << ARENA_SC_MIN_SHIFT)
+#define ARENA_SC_MAX		(ARENA_SC_MIN << (ARENA_SC_NR - 1))
+
+struct arena_free_obj {
+	struct arena_free_obj __arena *next;
+};
+
+/* (free - reuse) * class size is what sits on the free lists */
+struct arena_sc_stats {
+	__u64 alloc;	/* objects handed out */
+	__u64 reuse;	/* of which taken from a free list */
+	__u64 free;	/* objects put on a free list */
+};
+
 #ifdef __BPF__
 #define NR_CPUS (sizeof(struct cpumask) * 8)
 
@@ -61,7 +85,66 @@ static inline void bpf_free(void __arena *addr)
 	if (--(*obj_cnt) == 0)
 		bpf_arena_free_pages(&arena, addr, 1);
 }
+
+static struct arena_free_obj __arena * __arena arena_free_list[NR_CPUS][ARENA_SC_NR];
+#ifdef __BPF_FEATURE_ADDR_SPACE_CAST
+struct arena_sc_stats __arena arena_sc_stats[ARENA_SC_NR];
+#else
+struct arena_sc_stats arena_sc_stats[ARENA_SC_NR] SEC(".addr_space.1");
+#endif
+
+static inline int arena_sc_index(unsigned int size)
+{
+	int i;
+
+	for (i = 0; i < ARENA_SC_NR; i++)
+		if (size <= ARENA_SC_MIN << i)
+			return i;
+	return -1;
+}
+
+static inline void __arena* bpf_alloc_sc(unsigned int size)
+{
+	__u32 cpu = bpf_get_smp_processor_id();
+	struct arena_free_obj __arena *obj;
+	int sc = arena_sc_index(size);
+
+	if (sc < 0 || cpu >= NR_CPUS)
+		return NULL;
+
+	obj = arena_free_list[cpu][sc];
+	if (obj) {
+		cast_kern(obj);
+		arena_free_list[cpu][sc] = obj->next;
+		arena_sc_stats[sc].reuse++;
+	} else {
+		obj = bpf_alloc(ARENA_SC_MIN << sc);
+		if (!obj)
+			return NULL;
+	}
+	arena_sc_stats[sc].alloc++;
+	return obj;
+}
+
+/* @size has to be the size @addr was allocated with */
+static inline void bpf_free_sc(void __arena *addr, unsigned int size)
+{
+	__u32 cpu = bpf_get_smp_processor_id();
+	struct arena_free_obj __arena *obj = addr;
+	int sc = arena_sc_index(size);
+
+	if (!addr || sc < 0 || cpu >= NR_CPUS)
+		return;
+
+	cast_kern(obj);
+	obj->next = arena_free_list[cpu][sc];
+	cast_user(obj);
+	arena_free_list[cpu][sc] = obj;
+	arena_sc_stats[sc].free++;
+}
 #else
 static inline void __arena* bpf_alloc(unsigned int size) { return NULL; }
 static inline void bpf_free(void __arena *addr) {}
+static inline void __arena* bpf_alloc_sc(unsigned int size) { return NULL; }
+static inline void bpf_free_sc(void __arena *addr, unsigned int size) {}
 #endif
@@ -0,0 +1,42 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <test_progs.h>
+#include <sys/user.h>
+#ifndef PAGE_SIZE /* on some archs it comes in sys/user.h */
+#include <unistd.h>
+#define PAGE_SIZE getpagesize()
+#endif
+
+#include "bpf_arena_alloc.h"
+#include "arena_alloc_sc.skel.h"
+
+#define NR_OBJS 64
+
+void test_arena_alloc_sc(void)
+{
+	LIBBPF_OPTS(bpf_test_run_opts, opts);
+	struct arena_alloc_sc *skel;
+	struct arena_sc_stats *st;
+	int ret;
+
+	skel = arena_alloc_sc__open_and_load();
+	if (!ASSERT_OK_PTR(skel, "arena_alloc_sc__open_and_load"))
+		return;
+
+	ret = bpf_prog_test_run_opts(bpf_program__fd(skel->progs.arena_alloc_sc), &opts);
+	ASSERT_OK(ret, "ret");
+	if (skel->bss->skip) {
+		printf("%s:SKIP:compiler doesn't support arena_cast\n", __func__);
+		test__skip();
+		goto out;
+	}
+	ASSERT_OK(opts.retval, "retval");
+	ASSERT_EQ(skel->bss->reused, NR_OBJS, "reused");
+
+	/* 24 byte objects are in the 32 byte class */
+	st = &skel->arena->arena_sc_stats[1];
+	ASSERT_EQ(st->alloc, 2 * NR_OBJS, "alloc");
+	ASSERT_EQ(st->free, NR_OBJS, "free");
+	ASSERT_EQ(st->reuse, NR_OBJS, "reuse");
+out:
+	arena_alloc_sc__destroy(skel);
+}
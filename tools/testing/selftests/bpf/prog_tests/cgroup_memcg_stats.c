@@ -0,0 +1,110 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#include <sys/mman.h>
+#include <test_progs.h>
+#include <bpf/libbpf.h>
+#include "cgroup_helpers.h"
+#include "cgroup_memcg_stats.skel.h"
+
+#define PARENT		"/memcg_stats"
+#define CHILD		"/memcg_stats/child"
+#define ANON_SIZE	(8 << 20)
+
+struct memcg_stats_rec {
+	__u64 id;
+	__u64 usage;
+	__u64 anon;
+	__u64 file;
+	__u64 pgfault;
+	__u64 invalid;
+};
+
+void test_cgroup_memcg_stats(void)
+{
+	DECLARE_LIBBPF_OPTS(bpf_iter_attach_opts, opts);
+	struct memcg_stats_rec recs[4], *child_rec = NULL;
+	struct cgroup_memcg_stats *skel = NULL;
+	int parent_fd = -1, child_fd = -1;
+	unsigned long long child_id;
+	union bpf_iter_link_info linfo;
+	struct bpf_link *link = NULL;
+	int iter_fd = -1, len, i, n;
+	char *mem = MAP_FAILED;
+
+	if (setup_cgroup_environment())
+		return;
+
+	parent_fd = create_and_get_cgroup(PARENT);
+	if (!ASSERT_GE(parent_fd, 0, "create_parent"))
+		goto out;
+	if (!ASSERT_OK(enable_controllers(PARENT, "memory"), "enable_memory"))
+		goto out;
+	child_fd = create_and_get_cgroup(CHILD);
+	if (!ASSERT_GE(child_fd, 0, "create_child"))
+		goto out;
+	child_id = get_cgroup_id(CHILD);
+
+	/* Charge some anonymous memory to the child */
+	if (!ASSERT_OK(join_cgroup(CHILD), "join_child"))
+		goto out;
+	mem = mmap(NULL, ANON_SIZE, PROT_READ | PROT_WRITE,
+		   MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+	if (!ASSERT_NEQ(mem, MAP_FAILED, "mmap"))
+		goto out;
+	memset(mem, 1, ANON_SIZE);
+
+	skel = cgroup_memcg_stats__open_and_load();
+	if (!ASSERT_OK_PTR(skel, "open_and_load"))
+		goto out;
+
+	memset(&linfo, 0, sizeof(linfo));
+	linfo.cgroup.cgroup_fd = parent_fd;
+	linfo.cgroup.order = BPF_CGROUP_ITER_DESCENDANTS_PRE;
+	opts.link_info = &linfo;
+	opts.link_info_len = sizeof(linfo);
+
+	link = bpf_program__attach_iter(skel->progs.dump_memcg_stats, &opts);
+	if (!ASSERT_OK_PTR(link, "attach_iter"))
+		goto out;
+
+	iter_fd = bpf_iter_create(bpf_link__fd(link));
+	if (!ASSERT_GE(iter_fd, 0, "iter_create"))
+		goto out;
+
+	n = 0;
+	while ((len = read(iter_fd, (char *)recs + n, sizeof(recs) - n)) > 0)
+		n += len;
+	if (!ASSERT_GE(len, 0, "read"))
+		goto out;
+
+	/* Pre-order: the parent first, then the child */
+	if (!ASSERT_EQ(n, 2 * sizeof(recs[0]), "nr_records"))
+		goto out;
+
+	for (i = 0; i < n / sizeof(recs[0]); i++) {
+		ASSERT_EQ(recs[i].invalid, 0, "invalid_item");
+		if (recs[i].id == child_id)
+			child_rec = &recs[i];
+	}
+	if (!ASSERT_OK_PTR(child_rec, "child_record"))
+		goto out;
+
+	ASSERT_GE(child_rec->anon, ANON_SIZE, "child_anon");
+	ASSERT_GE(child_rec->usage, child_rec->anon, "child_usage");
+	ASSERT_GT(child_rec->pgfault, 0, "child_pgfault");
+	/* Hierarchical: the parent includes the child */
+	ASSERT_GE(recs[0].anon, child_rec->anon, "parent_anon");
+
+out:
+	if (iter_fd >= 0)
+		close(iter_fd);
+	bpf_link__destroy(link);
+	cgroup_memcg_stats__destroy(skel);
+	if (mem != MAP_FAILED)
+		munmap(mem, ANON_SIZE);
+	if (child_fd >= 0)
+		close(child_fd);
+	if (parent_fd >= 0)
+		close(parent_fd);
+	cleanup_cgroup_environment();
+}
@@ -0,0 +1,153 @@
+// SPDX-License-Identifier: GPL-2.0
+#include <test_progs.h>
+#include "htab_lookup_elems.skel.h"
+
+enum {
+	MAP_HTAB,
+	MAP_LRU_HTAB,
+	MAP_ARRAY,
+	MAP_LOCK_HTAB,
+};
+
+#define NR_ELEMS	32
+
+static int lookup(struct htab_lookup_elems *skel, int map_sel,
+		  __u32 keys_sz, __u32 values_sz)
+{
+	LIBBPF_OPTS(bpf_test_run_opts, opts);
+	int err;
+
+	skel->bss->map_sel = map_sel;
+	skel->bss->keys_sz = keys_sz;
+	skel->bss->values_sz = values_sz;
+	skel->bss->ret = INT_MIN;
+	memset(skel->bss->values, 0xff, sizeof(skel->bss->values));
+
+	err = bpf_prog_test_run_opts(bpf_program__fd(skel->progs.lookup), &opts);
+	if (!ASSERT_OK(err, "test_run") || !ASSERT_OK(opts.retval, "retval"))
+		return INT_MIN;
+	return skel->bss->ret;
+}
+
+static int fill(struct bpf_map *map)
+{
+	__u32 key;
+	__u64 value;
+	int err;
+
+	for (key = 0; key < NR_ELEMS; key++) {
+		value = key * 10 + 1;
+		err = bpf_map__update_elem(map, &key, sizeof(key), &value,
+					   sizeof(value), BPF_ANY);
+		if (!ASSERT_OK(err, "update_elem"))
+			return err;
+	}
+	return 0;
+}
+
+/* Every key is in the map and gets its own value */
+static void test_hits(struct htab_lookup_elems *skel, int map_sel)
+{
+	__u32 *keys = skel->bss->keys;
+	__u64 *values = skel->bss->values;
+	int i, nr = 16;
+
+	for (i = 0; i < nr; i++)
+		keys[i] = NR_ELEMS - 1 - i;
+
+	ASSERT_EQ(lookup(skel, map_sel, nr * sizeof(*keys),
+			 nr * sizeof(*values)), nr, "found");
+	for (i = 0; i < nr; i++)
+		ASSERT_EQ(values[i], keys[i] * 10 + 1, "value");
+	ASSERT_EQ(values[nr], ~0ULL, "untouched past the batch");
+}
+
+/* No key is in the map, every slot is zeroed */
+static void test_misses(struct htab_lookup_elems *skel)
+{
+	__u32 *keys = skel->bss->keys;
+	__u64 *values = skel->bss->values;
+	int i, nr = 8;
+
+	for (i = 0; i < nr; i++)
+		keys[i] = NR_ELEMS + i * 1000;
+
+	ASSERT_EQ(lookup(skel, MAP_HTAB, nr * sizeof(*keys),
+			 nr * sizeof(*values)), 0, "found");
+	for (i = 0; i < nr; i++)
+		ASSERT_EQ(values[i], 0, "zeroed");
+}
+
+/* A short batch mixing hits and misses, including a full 64 key batch */
+static void test_partial(struct htab_lookup_elems *skel)
+{
+	__u32 *keys = skel->bss->keys;
+	__u64 *values = skel->bss->values;
+	int i, nr;
+
+	keys[0] = 3;
+	keys[1] = NR_ELEMS + 3;
+	keys[2] = 5;
+	keys[3] = 3;
+	keys[4] = NR_ELEMS + 5;
+	ASSERT_EQ(lookup(skel, MAP_HTAB, 5 * sizeof(*keys),
+			 5 * sizeof(*values)), 3, "found");
+	ASSERT_EQ(values[0], 31, "hit");
+	ASSERT_EQ(values[1], 0, "miss");
+	ASSERT_EQ(values[2], 51, "hit");
+	ASSERT_EQ(values[3], 31, "duplicate hit");
+	ASSERT_EQ(values[4], 0, "miss");
+
+	nr = 64;
+	for (i = 0; i < nr; i++)
+		keys[i] = i;
+	ASSERT_EQ(lookup(skel, MAP_HTAB, nr * sizeof(*keys),
+			 nr * sizeof(*values)), NR_ELEMS, "found");
+	for (i = 0; i < nr; i++)
+		ASSERT_EQ(values[i], i < NR_ELEMS ? i * 10 + 1 : 0, "value");
+}
+
+static void test_invalid(struct htab_lookup_elems *skel)
+{
+	__u32 *keys = skel->bss->keys;
+	int i;
+
+	for (i = 0; i < 65; i++)
+		keys[i] = i;
+
+	ASSERT_EQ(lookup(skel, MAP_ARRAY, 4 * sizeof(__u32),
+			 4 * sizeof(__u64)), -EINVAL, "array map");
+	ASSERT_EQ(lookup(skel, MAP_LOCK_HTAB, 4 * sizeof(__u32),
+			 8 * sizeof(__u64)), -EINVAL, "special fields");
+	ASSERT_EQ(lookup(skel, MAP_HTAB, 4 * sizeof(__u32) + 2,
+			 8 * sizeof(__u64)), -EINVAL, "partial key");
+	ASSERT_EQ(lookup(skel, MAP_HTAB, 4 * sizeof(__u32),
+			 4 * sizeof(__u64) - 1), -EINVAL, "values too small");
+	ASSERT_EQ(lookup(skel, MAP_HTAB, 65 * sizeof(__u32),
+			 65 * sizeof(__u64)), -E2BIG, "too many keys");
+}
+
+void test_htab_lookup_elems(void)
+{
+	struct htab_lookup_elems *skel;
+
+	skel = htab_lookup_elems__open_and_load();
+	if (!ASSERT_OK_PTR(skel, "open_and_load"))
+		return;
+
+	if (fill(skel->maps.htab) || fill(skel->maps.lru_htab))
+		goto out;
+
+	if (test__start_subtest("hits"))
+		test_hits(skel, MAP_HTAB);
+	if (test__start_subtest("lru_hits"))
+		test_hits(skel, MAP_LRU_HTAB);
+	if (test__start_subtest("misses"))
+		test_misses(skel);
+	if (test__start_subtest("partial"))
+		test_partial(skel);
+	if (test__start_subtest("invalid"))
+		test_invalid(skel);
+out:
+	htab_lookup_elems__destroy(skel);
+}
@@ -24,6 +24,11 @@ void test_verif_stats(void)
 	if (!ASSERT_GT(info.verified_insns, 0, "verified_insns"))
 		goto cleanup;
 
+	ASSERT_GT(info.verified_states, 0, "verified_states");
+	ASSERT_LE(info.verified_peak_states, info.verified_states, "verified_peak_states");
+	ASSERT_LE(info.verified_pruned_states, info.verified_insns, "verified_pruned_states");
+	ASSERT_GT(info.verification_time_ns, 0, "verification_time_ns");
+
 cleanup:
 	trace_vprintk_lskel__destroy(skel);
 }
@@ -0,0 +1,73 @@
+// SPDX-License-Identifier: GPL-2.0
+#define BPF_NO_KFUNC_PROTOTYPES
+#include <vmlinux.h>
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+#include "bpf_experimental.h"
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARENA);
+	__uint(map_flags, BPF_F_MMAPABLE);
+	__uint(max_entries, 1000); /* number of pages */
+#ifdef __TARGET_ARCH_arm64
+	__ulong(map_extra, 0x1ull << 32); /* start of mmap() region */
+#else
+	__ulong(map_extra, 0x1ull << 44); /* start of mmap() region */
+#endif
+} arena SEC(".maps");
+
+#include "bpf_arena_alloc.h"
+
+#define NR_OBJS 64
+
+struct obj {
+	__u64 a, b, c;	/* 24 bytes, 32 byte class */
+};
+
+#ifdef __BPF_FEATURE_ADDR_SPACE_CAST
+struct obj __arena * __arena objs[NR_OBJS];
+#endif
+
+int reused;
+bool skip = false;
+
+SEC("syscall")
+int arena_alloc_sc(void *ctx)
+{
+#ifdef __BPF_FEATURE_ADDR_SPACE_CAST
+	struct obj __arena *o;
+	int i, j;
+
+	for (i = 0; i < NR_OBJS && can_loop; i++) {
+		o = bpf_alloc_sc(sizeof(*o));
+		if (!o)
+			return 1;
+		o->a = i;
+		objs[i] = o;
+	}
+
+	for (i = 0; i < NR_OBJS && can_loop; i++)
+		bpf_free_sc(objs[i], sizeof(struct obj));
+
+	/* all of these have to come from the free list */
+	for (i = 0; i < NR_OBJS && can_loop; i++) {
+		o = bpf_alloc_sc(sizeof(*o));
+		if (!o)
+			return 2;
+		for (j = 0; j < NR_OBJS && can_loop; j++) {
+			if (objs[j] == o) {
+				reused++;
+				break;
+			}
+		}
+	}
+
+	if (bpf_alloc_sc(ARENA_SC_MAX + 1))
+		return 3;
+#else
+	skip = true;
+#endif
+	return 0;
+}
+
+char _license[] SEC("license") = "GPL";
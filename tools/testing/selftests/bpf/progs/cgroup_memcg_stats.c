@@ -0,0 +1,48 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#include "bpf_iter.h"
+#include <bpf/bpf_helpers.h>
+#include <bpf/bpf_tracing.h>
+
+char _license[] SEC("license") = "GPL";
+
+extern void bpf_mem_cgroup_flush_stats(struct cgroup *cgrp) __ksym;
+extern u64 bpf_mem_cgroup_usage(struct cgroup *cgrp) __ksym;
+extern u64 bpf_mem_cgroup_page_state(struct cgroup *cgrp, int idx) __ksym;
+extern u64 bpf_mem_cgroup_vm_events(struct cgroup *cgrp, int event) __ksym;
+
+/* Keep in sync with prog_tests/cgroup_memcg_stats.c */
+struct memcg_stats_rec {
+	u64 id;
+	u64 usage;
+	u64 anon;
+	u64 file;
+	u64 pgfault;
+	u64 invalid;
+};
+
+/* One fixed size binary record per cgroup of the walk */
+SEC("iter.s/cgroup")
+int dump_memcg_stats(struct bpf_iter__cgroup *ctx)
+{
+	struct seq_file *seq = ctx->meta->seq;
+	struct cgroup *cgrp = ctx->cgroup;
+	struct memcg_stats_rec rec;
+
+	if (!cgrp)
+		return 0;
+
+	/* The first cgroup of a pre-order walk is the root of the subtree */
+	if (ctx->meta->seq_num == 0)
+		bpf_mem_cgroup_flush_stats(cgrp);
+
+	rec.id = cgrp->kn->id;
+	rec.usage = bpf_mem_cgroup_usage(cgrp);
+	rec.anon = bpf_mem_cgroup_page_state(cgrp, NR_ANON_MAPPED);
+	rec.file = bpf_mem_cgroup_page_state(cgrp, NR_FILE_PAGES);
+	rec.pgfault = bpf_mem_cgroup_vm_events(cgrp, PGFAULT);
+	rec.invalid = bpf_mem_cgroup_page_state(cgrp, -1);
+
+	bpf_seq_write(seq, &rec, sizeof(rec));
+	return 0;
+}
@@ -0,0 +1,91 @@
+// SPDX-License-Identifier: GPL-2.0
+#include "vmlinux.h"
+
+#include <bpf/bpf_helpers.h>
+
+char _license[] SEC("license") = "GPL";
+
+/* One more than bpf_map_lookup_elems() accepts */
+#define MAX_KEYS	65
+
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, 128);
+	__type(key, __u32);
+	__type(value, __u64);
+} htab SEC(".maps");
+
+struct {
+	__uint(type, BPF_MAP_TYPE_LRU_HASH);
+	/* Large enough that filling it never evicts */
+	__uint(max_entries, 4096);
+	__type(key, __u32);
+	__type(value, __u64);
+} lru_htab SEC(".maps");
+
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY);
+	__uint(max_entries, 128);
+	__type(key, __u32);
+	__type(value, __u64);
+} array SEC(".maps");
+
+struct lock_val {
+	struct bpf_spin_lock lock;
+	__u64 data;
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, 128);
+	__type(key, __u32);
+	__type(value, struct lock_val);
+} lock_htab SEC(".maps");
+
+int bpf_map_lookup_elems(void *map, const void *keys, __u32 keys__sz,
+			 void *values, __u32 values__sz) __ksym;
+
+enum {
+	MAP_HTAB,
+	MAP_LRU_HTAB,
+	MAP_ARRAY,
+	MAP_LOCK_HTAB,
+};
+
+/* Set by userspace */
+__u32 keys[MAX_KEYS];
+__u32 keys_sz;
+__u32 values_sz;
+int map_sel;
+
+/* Filled by us, large enough for MAX_KEYS lock_val */
+__u64 values[2 * MAX_KEYS];
+int ret;
+
+SEC("syscall")
+int lookup(void *ctx)
+{
+	__u32 ksz = keys_sz, vsz = values_sz;
+
+	if (!ksz || ksz > sizeof(keys) || !vsz || vsz > sizeof(values))
+		return 1;
+
+	switch (map_sel) {
+	case MAP_HTAB:
+		ret = bpf_map_lookup_elems(&htab, keys, ksz, values, vsz);
+		break;
+	case MAP_LRU_HTAB:
+		ret = bpf_map_lookup_elems(&lru_htab, keys, ksz, values, vsz);
+		break;
+	case MAP_ARRAY:
+		ret = bpf_map_lookup_elems(&array, keys, ksz, values, vsz);
+		break;
+	case MAP_LOCK_HTAB:
+		ret = bpf_map_lookup_elems(&lock_htab, keys, ksz, values, vsz);
+		break;
+	default:
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: GPL-2.0
+#include "vmlinux.h"
+
+#include <bpf/bpf_helpers.h>
+#include "bpf_misc.h"
+
+char _license[] SEC("license") = "GPL";
+
+#define NR_ENTRIES	(1 << 20)
+#define BATCH		16
+
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, NR_ENTRIES);
+	__type(key, __u32);
+	__type(value, __u64);
+} htab SEC(".maps");
+
+int bpf_map_lookup_elems(void *map, const void *keys, __u32 keys__sz,
+			 void *values, __u32 values__sz) __ksym;
+
+/* Configured by userspace, at most NR_ENTRIES */
+__u32 nr_entries;
+
+/* Filled by us */
+long hits;
+
+SEC("fentry/" SYS_PREFIX "sys_getpgid")
+int lookup_single(void *ctx)
+{
+	long found = 0;
+	__u32 key;
+	int i;
+
+	for (i = 0; i < BATCH; i++) {
+		key = bpf_get_prandom_u32() % nr_entries;
+		if (bpf_map_lookup_elem(&htab, &key))
+			found++;
+	}
+
+	__sync_add_and_fetch(&hits, found);
+	return 0;
+}
+
+SEC("fentry/" SYS_PREFIX "sys_getpgid")
+int lookup_batch(void *ctx)
+{
+	__u64 values[BATCH];
+	__u32 keys[BATCH];
+	int i, found;
+
+	for (i = 0; i < BATCH; i++)
+		keys[i] = bpf_get_prandom_u32() % nr_entries;
+
+	found = bpf_map_lookup_elems(&htab, keys, sizeof(keys), values,
+				     sizeof(values));
+	if (found > 0)
+		__sync_add_and_fetch(&hits, found);
+	return 0;
+}
@@ -0,0 +1,69 @@
+// SPDX-License-Identifier: GPL-2.0
+#include "vmlinux.h"
+
+#include <bpf/bpf_helpers.h>
+#include "bpf_misc.h"
+
+char _license[] SEC("license") = "GPL";
+
+#define NR_ENTRIES	(1 << 20)
+#define NR_ADDRS	(1 << 16)
+#define BATCH		16
+
+struct lpm_key_v6 {
+	__u32 prefixlen;
+	__u8 addr[16];
+};
+
+struct {
+	__uint(type, BPF_MAP_TYPE_LPM_TRIE);
+	__uint(max_entries, NR_ENTRIES);
+	__uint(map_flags, BPF_F_NO_PREALLOC);
+	__type(key, struct lpm_key_v6);
+	__type(value, __u32);
+} trie SEC(".maps");
+
+/* An exact match hash map of the same prefixes as the cost floor */
+struct {
+	__uint(type, BPF_MAP_TYPE_HASH);
+	__uint(max_entries, NR_ENTRIES);
+	__type(key, struct lpm_key_v6);
+	__type(value, __u32);
+} htab SEC(".maps");
+
+/* Addresses to look up, filled by userspace */
+struct lpm_key_v6 addrs[NR_ADDRS];
+
+/* Filled by us: number of lookups that matched and that missed */
+long hits;
+long drops;
+
+static __always_inline void lookup(void *map)
+{
+	long found = 0;
+	__u32 idx;
+	int i;
+
+	for (i = 0; i < BATCH; i++) {
+		idx = bpf_get_prandom_u32() & (NR_ADDRS - 1);
+		if (bpf_map_lookup_elem(map, &addrs[idx]))
+			found++;
+	}
+
+	__sync_add_and_fetch(&hits, found);
+	__sync_add_and_fetch(&drops, BATCH - found);
+}
+
+SEC("fentry/" SYS_PREFIX "sys_getpgid")
+int lookup_trie(void *ctx)
+{
+	lookup(&trie);
+	return 0;
+}
+
+SEC("fentry/" SYS_PREFIX "sys_getpgid")
+int lookup_htab(void *ctx)
+{
+	lookup(&htab);
+	return 0;
+}
@@ -0,0 +1,56 @@
+// SPDX-License-Identifier: GPL-2.0
+
+#include <linux/bpf.h>
+#include <stdint.h>
+#include <bpf/bpf_helpers.h>
+#include "bpf_misc.h"
+
+char _license[] SEC("license") = "GPL";
+
+struct ringbuf_map {
+	__uint(type, BPF_MAP_TYPE_RINGBUF);
+} ringbuf SEC(".maps");
+
+/* One ring per CPU, created and inserted by userspace */
+struct {
+	__uint(type, BPF_MAP_TYPE_ARRAY_OF_MAPS);
+	__uint(max_entries, 1);
+	__type(key, int);
+	__array(values, struct ringbuf_map);
+} ringbuf_arr SEC(".maps");
+
+const volatile int batch_cnt = 0;
+const volatile bool per_cpu = false;
+
+long sample_val = 42;
+long dropped __attribute__((aligned(128))) = 0;
+
+SEC("fentry/" SYS_PREFIX "sys_getpgid")
+int bench_ringbuf_percpu(void *ctx)
+{
+	int cpu = bpf_get_smp_processor_id();
+	long *sample;
+	void *rb;
+	int i;
+
+	if (per_cpu) {
+		rb = bpf_map_lookup_elem(&ringbuf_arr, &cpu);
+		if (!rb) {
+			__sync_add_and_fetch(&dropped, batch_cnt);
+			return 0;
+		}
+	} else {
+		rb = &ringbuf;
+	}
+
+	for (i = 0; i < batch_cnt; i++) {
+		sample = bpf_ringbuf_reserve(rb, sizeof(sample_val), 0);
+		if (!sample) {
+			__sync_add_and_fetch(&dropped, 1);
+		} else {
+			*sample = sample_val;
+			bpf_ringbuf_submit(sample, 0);
+		}
+	}
+	return 0;
+}
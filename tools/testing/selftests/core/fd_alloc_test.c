@@ -0,0 +1,159 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * File descriptor allocation must return the lowest free fd at or above the
+ * requested start, whether that is in the word holding the start, further
+ * up the table, or past the end of the table so that it has to grow.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <sys/resource.h>
+
+#include "../kselftest_harness.h"
+
+/* A multiple of BITS_PER_LONG, so the offsets below fall on word edges */
+#define FD_BASE		512
+#define FD_NR		256
+
+static void close_from(int first, int nr)
+{
+	int i;
+
+	for (i = 0; i < nr; i++)
+		close(first + i);
+}
+
+TEST(lowest_free)
+{
+	static const int holes[] = { 150, 5, 128, 63, 65, 127, 64 };
+	static const int sorted[] = { 5, 63, 64, 65, 127, 128, 150 };
+	int base, i;
+
+	base = open("/dev/null", O_RDONLY);
+	ASSERT_GE(base, 0) {
+		if (errno == ENOENT)
+			SKIP(return, "Skipping test since /dev/null does not exist");
+	}
+	close_from(FD_BASE, FD_NR + 1);
+
+	for (i = 0; i < FD_NR; i++)
+		ASSERT_EQ(FD_BASE + i, fcntl(base, F_DUPFD, FD_BASE));
+
+	for (i = 0; i < ARRAY_SIZE(holes); i++)
+		ASSERT_EQ(0, close(FD_BASE + holes[i]));
+	for (i = 0; i < ARRAY_SIZE(sorted); i++)
+		EXPECT_EQ(FD_BASE + sorted[i], fcntl(base, F_DUPFD, FD_BASE));
+
+	/* Every slot is taken now, so the next one is past them all */
+	EXPECT_EQ(FD_BASE + FD_NR, fcntl(base, F_DUPFD, FD_BASE));
+
+	/* Starting in a full word must find a hole in a later one */
+	ASSERT_EQ(0, close(FD_BASE + 150));
+	EXPECT_EQ(FD_BASE + 150, fcntl(base, F_DUPFD, FD_BASE + 66));
+
+	/* And a hole just below the start must not be returned */
+	ASSERT_EQ(0, close(FD_BASE + 65));
+	EXPECT_EQ(FD_BASE + FD_NR + 1, fcntl(base, F_DUPFD, FD_BASE + 66));
+	EXPECT_EQ(FD_BASE + 65, fcntl(base, F_DUPFD, FD_BASE));
+
+	close_from(FD_BASE, FD_NR + 2);
+	close(base);
+}
+
+/* Sequential allocation far enough up that the table has to grow */
+TEST(table_expansion)
+{
+	struct rlimit rl;
+	int base, i, fd;
+
+	ASSERT_EQ(0, getrlimit(RLIMIT_NOFILE, &rl));
+	if (rl.rlim_cur < 4 * FD_BASE + FD_NR) {
+		rl.rlim_cur = 4 * FD_BASE + FD_NR;
+		if (rl.rlim_max < rl.rlim_cur || setrlimit(RLIMIT_NOFILE, &rl))
+			SKIP(return, "cannot raise RLIMIT_NOFILE to %lu",
+			     (unsigned long)rl.rlim_cur);
+	}
+
+	base = open("/dev/null", O_RDONLY);
+	ASSERT_GE(base, 0) {
+		if (errno == ENOENT)
+			SKIP(return, "Skipping test since /dev/null does not exist");
+	}
+	close_from(4 * FD_BASE - FD_NR, 2 * FD_NR);
+
+	for (i = 0; i < 2 * FD_NR; i++) {
+		fd = fcntl(base, F_DUPFD, 4 * FD_BASE - FD_NR);
+		ASSERT_EQ(4 * FD_BASE - FD_NR + i, fd);
+		EXPECT_EQ(0, fcntl(fd, F_GETFD));
+	}
+
+	close_from(4 * FD_BASE - FD_NR, 2 * FD_NR);
+	close(base);
+}
+
+#define NR_THREADS	8
+#define NR_LOOPS	20000
+
+struct dup_thread {
+	pthread_t thread;
+	int base;
+	int limit;
+	bool bad;
+};
+
+static void *dup_close_fn(void *arg)
+{
+	struct dup_thread *t = arg;
+	int i, fd;
+
+	for (i = 0; i < NR_LOOPS; i++) {
+		fd = dup(t->base);
+		if (fd < 0 || fd >= t->limit)
+			t->bad = true;
+		if (fd >= 0)
+			close(fd);
+	}
+	return NULL;
+}
+
+/*
+ * Threads sharing the table never have more than one fd each open, so the
+ * lowest free fd can never be more than NR_THREADS above the first one.
+ */
+TEST(concurrent_dup_close)
+{
+	struct dup_thread threads[NR_THREADS];
+	int base, first, i;
+
+	base = open("/dev/null", O_RDONLY);
+	ASSERT_GE(base, 0) {
+		if (errno == ENOENT)
+			SKIP(return, "Skipping test since /dev/null does not exist");
+	}
+	first = dup(base);
+	ASSERT_GE(first, 0);
+	ASSERT_EQ(0, close(first));
+
+	for (i = 0; i < NR_THREADS; i++) {
+		threads[i].base = base;
+		threads[i].limit = first + NR_THREADS;
+		threads[i].bad = false;
+		ASSERT_EQ(0, pthread_create(&threads[i].thread, NULL,
+					    dup_close_fn, &threads[i]));
+	}
+	for (i = 0; i < NR_THREADS; i++) {
+		ASSERT_EQ(0, pthread_join(threads[i].thread, NULL));
+		EXPECT_FALSE(threads[i].bad)
+			TH_LOG("thread %d got an fd at or above %d", i,
+			       first + NR_THREADS);
+	}
+
+	EXPECT_EQ(first, dup(base));
+	close(first);
+	close(base);
+}
+
+TEST_HARNESS_MAIN
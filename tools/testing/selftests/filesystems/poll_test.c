@@ -0,0 +1,178 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * poll() on sets of pipes large enough for do_poll() to look for ready fds
+ * before registering any waiters, and on a small set which doesn't.
+ */
+#define _GNU_SOURCE
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../kselftest_harness.h"
+
+/* Above POLL_PRESCAN_MIN in fs/select.c */
+#define NR_PIPES	200
+
+struct pipes {
+	struct pollfd pfds[NR_PIPES];
+	int wfds[NR_PIPES];
+	int nr;
+};
+
+static int pipes_open(struct pipes *p, int nr)
+{
+	int fds[2];
+
+	for (p->nr = 0; p->nr < nr; p->nr++) {
+		if (pipe(fds))
+			return -1;
+		p->pfds[p->nr].fd = fds[0];
+		p->pfds[p->nr].events = POLLIN;
+		p->pfds[p->nr].revents = 0;
+		p->wfds[p->nr] = fds[1];
+	}
+	return 0;
+}
+
+static void pipes_close(struct pipes *p)
+{
+	int i;
+
+	for (i = 0; i < p->nr; i++) {
+		close(p->pfds[i].fd);
+		close(p->wfds[i]);
+	}
+}
+
+static long elapsed_ms(struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1000 +
+	       (now.tv_nsec - start->tv_nsec) / 1000000;
+}
+
+/* Exactly the ready fds are reported, at the start, middle and end */
+TEST(ready_fds_reported)
+{
+	static const int ready[] = { 0, 100, NR_PIPES - 1 };
+	struct pipes p;
+	int i, j;
+
+	ASSERT_EQ(0, pipes_open(&p, NR_PIPES));
+	for (i = 0; i < ARRAY_SIZE(ready); i++)
+		ASSERT_EQ(1, write(p.wfds[ready[i]], "x", 1));
+
+	EXPECT_EQ(ARRAY_SIZE(ready), poll(p.pfds, NR_PIPES, 5000));
+	for (i = 0; i < NR_PIPES; i++) {
+		short expect = 0;
+
+		for (j = 0; j < ARRAY_SIZE(ready); j++)
+			if (i == ready[j])
+				expect = POLLIN;
+		EXPECT_EQ(expect, p.pfds[i].revents)
+			TH_LOG("fd %d of the set", i);
+	}
+
+	pipes_close(&p);
+}
+
+/* A hung up pipe is ready too, without asking for POLLHUP */
+TEST(hangup_reported)
+{
+	struct pipes p;
+
+	ASSERT_EQ(0, pipes_open(&p, NR_PIPES));
+	close(p.wfds[150]);
+	p.wfds[150] = -1;
+
+	EXPECT_EQ(1, poll(p.pfds, NR_PIPES, 5000));
+	EXPECT_EQ(POLLHUP, p.pfds[150].revents);
+
+	pipes_close(&p);
+}
+
+struct writer {
+	int fd;
+	int delay_ms;
+};
+
+static void *writer_fn(void *arg)
+{
+	struct writer *w = arg;
+
+	usleep(w->delay_ms * 1000);
+	if (write(w->fd, "x", 1) != 1)
+		return (void *)1;
+	return NULL;
+}
+
+/*
+ * Nothing is ready when poll() is called, so it must register and then
+ * be woken by a write that comes later. A lost wakeup shows as a timeout.
+ */
+TEST(wakeup_after_sleep)
+{
+	struct writer w = { .delay_ms = 100 };
+	struct timespec start;
+	struct pipes p;
+	pthread_t thread;
+	void *res;
+
+	ASSERT_EQ(0, pipes_open(&p, NR_PIPES));
+	w.fd = p.wfds[150];
+	ASSERT_EQ(0, pthread_create(&thread, NULL, writer_fn, &w));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	EXPECT_EQ(1, poll(p.pfds, NR_PIPES, 10000));
+	EXPECT_LT(elapsed_ms(&start), 5000);
+	EXPECT_EQ(POLLIN, p.pfds[150].revents);
+
+	ASSERT_EQ(0, pthread_join(thread, &res));
+	EXPECT_EQ(NULL, res);
+	pipes_close(&p);
+}
+
+/* Nothing ever becomes ready, so poll() times out with nothing reported */
+TEST(timeout_none_ready)
+{
+	struct timespec start;
+	struct pipes p;
+	int i;
+
+	ASSERT_EQ(0, pipes_open(&p, NR_PIPES));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	EXPECT_EQ(0, poll(p.pfds, NR_PIPES, 100));
+	EXPECT_GE(elapsed_ms(&start), 100);
+	for (i = 0; i < NR_PIPES; i++)
+		EXPECT_EQ(0, p.pfds[i].revents);
+
+	pipes_close(&p);
+}
+
+/* Below POLL_PRESCAN_MIN, both ready and sleeping cases */
+TEST(small_set)
+{
+	struct writer w = { .delay_ms = 100 };
+	struct pipes p;
+	pthread_t thread;
+
+	ASSERT_EQ(0, pipes_open(&p, 8));
+	ASSERT_EQ(1, write(p.wfds[3], "x", 1));
+	EXPECT_EQ(1, poll(p.pfds, 8, 5000));
+	EXPECT_EQ(POLLIN, p.pfds[3].revents);
+	pipes_close(&p);
+
+	ASSERT_EQ(0, pipes_open(&p, 8));
+	w.fd = p.wfds[5];
+	ASSERT_EQ(0, pthread_create(&thread, NULL, writer_fn, &w));
+	EXPECT_EQ(1, poll(p.pfds, 8, 10000));
+	EXPECT_EQ(POLLIN, p.pfds[5].revents);
+	ASSERT_EQ(0, pthread_join(thread, NULL));
+	pipes_close(&p);
+}
+
+TEST_HARNESS_MAIN
@@ -0,0 +1,273 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * IORING_OP_FUTEX_WAKEV test
+ *
+ * Waiters sleep on one futex each, and a single IORING_OP_FUTEX_WAKEV
+ * request wakes all of them. The request must report every waiter it woke,
+ * and a vector with an invalid first entry must fail with -EINVAL. The time
+ * from the wake to the last waiter running is reported for FUTEX_WAKEV and
+ * for one FUTEX_WAKE syscall per futex.
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#include "futextest.h"
+#include "logging.h"
+
+#define TEST_NAME "futex-wakev-uring"
+#define WAKE_WAIT_US 10000
+#define NR_WAITERS 16
+#define NR_ROUNDS 10
+
+static struct futex_waitv waitv[NR_WAITERS];
+static futex_t futexes[NR_WAITERS];
+static unsigned long long woken_at[NR_WAITERS];
+static unsigned int nr_waiting, nr_woken, round_nr;
+
+static struct {
+	int fd;
+	unsigned int *sq_tail, *sq_mask, *sq_array;
+	unsigned int *cq_head, *cq_tail, *cq_mask;
+	struct io_uring_sqe *sqes;
+	struct io_uring_cqe *cqes;
+} ring;
+
+void usage(char *prog)
+{
+	printf("Usage: %s\n", prog);
+	printf("  -c	Use color\n");
+	printf("  -h	Display this help message\n");
+	printf("  -v L	Verbosity level: %d=QUIET %d=CRITICAL %d=INFO\n",
+	       VQUIET, VCRITICAL, VINFO);
+}
+
+static unsigned long long now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int ring_setup(void)
+{
+	struct io_uring_params p = { };
+	void *sq, *cq;
+
+	ring.fd = syscall(__NR_io_uring_setup, 4, &p);
+	if (ring.fd < 0)
+		return -errno;
+
+	sq = mmap(NULL, p.sq_off.array + p.sq_entries * sizeof(unsigned int),
+		  PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd,
+		  IORING_OFF_SQ_RING);
+	cq = mmap(NULL, p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe),
+		  PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring.fd,
+		  IORING_OFF_CQ_RING);
+	ring.sqes = mmap(NULL, p.sq_entries * sizeof(struct io_uring_sqe),
+			 PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			 ring.fd, IORING_OFF_SQES);
+	if (sq == MAP_FAILED || cq == MAP_FAILED || ring.sqes == MAP_FAILED)
+		return -errno;
+
+	ring.sq_tail = sq + p.sq_off.tail;
+	ring.sq_mask = sq + p.sq_off.ring_mask;
+	ring.sq_array = sq + p.sq_off.array;
+	ring.cq_head = cq + p.cq_off.head;
+	ring.cq_tail = cq + p.cq_off.tail;
+	ring.cq_mask = cq + p.cq_off.ring_mask;
+	ring.cqes = cq + p.cq_off.cqes;
+	return 0;
+}
+
+/* Submit one FUTEX_WAKEV of @nr entries of @vec and return its result */
+static int futex_wakev_uring(struct futex_waitv *vec, unsigned int nr)
+{
+	unsigned int tail = *ring.sq_tail, head, idx = tail & *ring.sq_mask;
+	struct io_uring_sqe *sqe = &ring.sqes[idx];
+	int res;
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = IORING_OP_FUTEX_WAKEV;
+	sqe->addr = (uintptr_t)vec;
+	sqe->addr2 = 1;
+	sqe->len = nr;
+	ring.sq_array[idx] = idx;
+	__atomic_store_n(ring.sq_tail, tail + 1, __ATOMIC_RELEASE);
+
+	if (syscall(__NR_io_uring_enter, ring.fd, 1, 1,
+		    IORING_ENTER_GETEVENTS, NULL, 0) < 0)
+		return -errno;
+
+	head = *ring.cq_head;
+	if (head == __atomic_load_n(ring.cq_tail, __ATOMIC_ACQUIRE))
+		return -EAGAIN;
+	res = ring.cqes[head & *ring.cq_mask].res;
+	__atomic_store_n(ring.cq_head, head + 1, __ATOMIC_RELEASE);
+	return res;
+}
+
+static void *waiterfn(void *arg)
+{
+	unsigned int i = (uintptr_t)arg, r;
+
+	for (r = 1; r <= NR_ROUNDS * 2; r++) {
+		__atomic_add_fetch(&nr_waiting, 1, __ATOMIC_SEQ_CST);
+		while (__atomic_load_n(&futexes[i], __ATOMIC_ACQUIRE) < r)
+			futex_wait(&futexes[i], r - 1, NULL, FUTEX_PRIVATE_FLAG);
+		woken_at[i] = now_ns();
+		__atomic_add_fetch(&nr_woken, 1, __ATOMIC_SEQ_CST);
+	}
+	return NULL;
+}
+
+/*
+ * Wake every waiter once, with FUTEX_WAKEV or one FUTEX_WAKE per futex.
+ * Returns the number of waiters woken, and the time until the last of them
+ * ran in @lat_ns.
+ */
+static int wake_round(int uring, unsigned long long *lat_ns)
+{
+	unsigned long long start, last = 0;
+	int i, res = 0, woken = 0;
+
+	/* Let the waiters that arrived go to sleep */
+	while (__atomic_load_n(&nr_waiting, __ATOMIC_SEQ_CST) < NR_WAITERS)
+		usleep(100);
+	usleep(WAKE_WAIT_US);
+	__atomic_store_n(&nr_waiting, 0, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&nr_woken, 0, __ATOMIC_SEQ_CST);
+
+	round_nr++;
+	for (i = 0; i < NR_WAITERS; i++)
+		__atomic_store_n(&futexes[i], round_nr, __ATOMIC_RELEASE);
+
+	start = now_ns();
+	if (uring)
+		res = futex_wakev_uring(waitv, NR_WAITERS);
+	/* Don't leave the waiters behind if FUTEX_WAKEV failed */
+	if (!uring || res < 0) {
+		for (i = 0; i < NR_WAITERS; i++)
+			woken += futex_wake(&futexes[i], 1, FUTEX_PRIVATE_FLAG);
+		if (!uring)
+			res = woken;
+	}
+
+	while (__atomic_load_n(&nr_woken, __ATOMIC_SEQ_CST) < NR_WAITERS)
+		usleep(100);
+	for (i = 0; i < NR_WAITERS; i++)
+		if (woken_at[i] > last)
+			last = woken_at[i];
+	*lat_ns = last > start ? last - start : 0;
+	return res;
+}
+
+int main(int argc, char *argv[])
+{
+	unsigned long long lat, lat_wakev = 0, lat_wake = 0;
+	pthread_t waiters[NR_WAITERS];
+	struct futex_waitv bad;
+	int c, i, res, ret = RET_PASS;
+	bool all_woken = true;
+
+	while ((c = getopt(argc, argv, "chv:")) != -1) {
+		switch (c) {
+		case 'c':
+			log_color(1);
+			break;
+		case 'h':
+			usage(basename(argv[0]));
+			exit(0);
+		case 'v':
+			log_verbosity(atoi(optarg));
+			break;
+		default:
+			usage(basename(argv[0]));
+			exit(1);
+		}
+	}
+
+	ksft_print_header();
+	ksft_set_plan(2);
+	ksft_print_msg("%s: Test IORING_OP_FUTEX_WAKEV\n", basename(argv[0]));
+
+	res = ring_setup();
+	if (res == -ENOSYS || res == -EPERM)
+		ksft_exit_skip("io_uring not available: %s\n", strerror(-res));
+	if (res)
+		ksft_exit_fail_msg("io_uring setup failed: %s\n", strerror(-res));
+
+	for (i = 0; i < NR_WAITERS; i++) {
+		waitv[i].uaddr = (uintptr_t)&futexes[i];
+		waitv[i].flags = FUTEX2_SIZE_U32 | FUTEX2_PRIVATE;
+		waitv[i].val = 0;
+		waitv[i].__reserved = 0;
+	}
+
+	/* Nobody waits yet, so this only checks that the opcode is known */
+	res = futex_wakev_uring(waitv, NR_WAITERS);
+	if (res < 0)
+		ksft_exit_skip("IORING_OP_FUTEX_WAKEV not supported: %s\n",
+			       strerror(-res));
+
+	bad.uaddr = (uintptr_t)&futexes[0];
+	bad.flags = FUTEX2_SIZE_U32 | FUTEX2_PRIVATE;
+	bad.val = 0;
+	bad.__reserved = 1;
+	res = futex_wakev_uring(&bad, 1);
+	if (res != -EINVAL) {
+		ksft_test_result_fail("futex_wakev returned %d for an invalid entry\n",
+				      res);
+		ret = RET_FAIL;
+	} else {
+		ksft_test_result_pass("futex_wakev rejects an invalid entry\n");
+	}
+
+	for (i = 0; i < NR_WAITERS; i++) {
+		if (pthread_create(&waiters[i], NULL, waiterfn,
+				   (void *)(uintptr_t)i))
+			ksft_exit_fail_msg("pthread_create failed\n");
+	}
+
+	/* Alternate so that both see the same system state */
+	for (i = 0; i < NR_ROUNDS; i++) {
+		res = wake_round(1, &lat);
+		if (res != NR_WAITERS) {
+			ksft_print_msg("futex_wakev woke %d of %d waiters\n",
+				       res, NR_WAITERS);
+			all_woken = false;
+		}
+		lat_wakev += lat;
+
+		wake_round(0, &lat);
+		lat_wake += lat;
+	}
+
+	for (i = 0; i < NR_WAITERS; i++)
+		pthread_join(waiters[i], NULL);
+
+	if (all_woken) {
+		ksft_test_result_pass("futex_wakev woke all waiters\n");
+	} else {
+		ksft_test_result_fail("futex_wakev missed waiters\n");
+		ret = RET_FAIL;
+	}
+
+	ksft_print_msg("%d waiters, wake to last waiter running: futex_wakev %llu ns, %d x futex_wake %llu ns\n",
+		       NR_WAITERS, lat_wakev / NR_ROUNDS, NR_WAITERS,
+		       lat_wake / NR_ROUNDS);
+
+	ksft_print_cnts();
+	return ret;
+}
@@ -82,3 +82,6 @@ echo
 
 echo
 ./futex_waitv $COLOR
+
+echo
+./futex_wakev_uring $COLOR
@@ -134,7 +134,7 @@ static void test_create_guest_memfd_invalid(struct kvm_vm *vm)
 			    size);
 	}
 
-	for (flag = 0; flag; flag <<= 1) {
+	for (flag = BIT(1); flag; flag <<= 1) {
 		fd = __vm_create_guest_memfd(vm, page_size, flag);
 		TEST_ASSERT(fd == -1 && errno == EINVAL,
 			    "guest_memfd() with flag '0x%lx' should fail with EINVAL",
@@ -142,6 +142,38 @@ static void test_create_guest_memfd_invalid(struct kvm_vm *vm)
 	}
 }
 
+static void test_create_guest_memfd_hugepage(struct kvm_vm *vm)
+{
+	const size_t huge_size = 2 * 1024 * 1024;
+	size_t page_size = getpagesize();
+	int fd, ret;
+
+	fd = __vm_create_guest_memfd(vm, huge_size, KVM_GUEST_MEMFD_ALLOW_HUGEPAGE);
+	if (fd == -1 && errno == EINVAL) {
+		ksft_print_msg("KVM_GUEST_MEMFD_ALLOW_HUGEPAGE not supported\n");
+		return;
+	}
+	TEST_ASSERT(fd != -1, "guest_memfd() with huge pages should succeed");
+
+	ret = fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, huge_size);
+	TEST_ASSERT(!ret, "fallocate the whole huge page should succeed");
+
+	/* Punching out part of the file splits the huge folio. */
+	ret = fallocate(fd, FALLOC_FL_KEEP_SIZE | FALLOC_FL_PUNCH_HOLE,
+			page_size, page_size);
+	TEST_ASSERT(!ret, "punch hole inside a huge page should succeed");
+
+	ret = fallocate(fd, FALLOC_FL_KEEP_SIZE, page_size, page_size);
+	TEST_ASSERT(!ret, "fallocate into a split huge page should succeed");
+
+	close(fd);
+
+	fd = __vm_create_guest_memfd(vm, huge_size + page_size,
+				     KVM_GUEST_MEMFD_ALLOW_HUGEPAGE);
+	TEST_ASSERT(fd == -1 && errno == EINVAL,
+		    "guest_memfd() with huge pages and unaligned size should fail with EINVAL");
+}
+
 static void test_create_guest_memfd_multiple(struct kvm_vm *vm)
 {
 	int fd1, fd2, ret;
@@ -185,6 +217,7 @@ int main(int argc, char *argv[])
 	vm = vm_create_barebones();
 
 	test_create_guest_memfd_invalid(vm);
+	test_create_guest_memfd_hugepage(vm);
 	test_create_guest_memfd_multiple(vm);
 
 	fd = vm_create_guest_memfd(vm, total_size, 0);
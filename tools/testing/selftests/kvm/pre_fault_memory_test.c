@@ -73,6 +73,7 @@ static void __test_pre_fault_memory(unsigned long vm_type, bool private)
 	struct kvm_run *run;
 	struct kvm_vm *vm;
 	struct ucall uc;
+	uint64_t mapped;
 
 	uint64_t guest_test_phys_mem;
 	uint64_t guest_test_virt_mem;
@@ -101,6 +102,14 @@ static void __test_pre_fault_memory(unsigned long vm_type, bool private)
 	pre_fault_memory(vcpu, guest_test_phys_mem + SZ_2M, PAGE_SIZE * 2, PAGE_SIZE);
 	pre_fault_memory(vcpu, guest_test_phys_mem + TEST_SIZE, PAGE_SIZE, PAGE_SIZE);
 
+	/* Every mapping covers at least the part of the range it was made for */
+	mapped = vm_get_stat(vm, "pre_fault_4k") * SZ_4K +
+		 vm_get_stat(vm, "pre_fault_2m") * SZ_2M +
+		 vm_get_stat(vm, "pre_fault_1g") * SZ_1G;
+	TEST_ASSERT(mapped >= TEST_SIZE,
+		    "Pre-fault stats account for %" PRIu64 " bytes, expected at least %lu",
+		    mapped, (unsigned long)TEST_SIZE);
+
 	vcpu_args_set(vcpu, 1, guest_test_virt_mem);
 	vcpu_run(vcpu);
 
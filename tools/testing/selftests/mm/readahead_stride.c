@@ -0,0 +1,125 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Check that a strided stream of small reads gets large folios from
+ * readahead, like a sequential stream does.
+ *
+ * The file is created in the directory given as the first argument, or in
+ * the current directory. That filesystem has to support large folios in the
+ * page cache (e.g. XFS), otherwise the test is skipped.
+ */
+#define _GNU_SOURCE
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "../kselftest.h"
+#include "vm_util.h"
+
+#define KPF_COMPOUND_HEAD	(1UL << 15)
+#define KPF_COMPOUND_TAIL	(1UL << 16)
+
+#define FILE_SIZE	(64UL << 20)
+#define STRIDE		(1UL << 20)
+#define READ_SIZE	(16UL << 10)
+
+static int pagemap_fd, kpageflags_fd;
+
+/* Is the page cache page at @off of @map part of a large folio? */
+static int is_large_folio(char *map, size_t off)
+{
+	unsigned long pfn;
+	uint64_t flags;
+
+	/* The page is cached already, this only maps it */
+	(void)*(volatile char *)(map + off);
+	pfn = pagemap_get_pfn(pagemap_fd, map + off);
+	if (pfn == -1UL)
+		return -1;
+	if (pread(kpageflags_fd, &flags, sizeof(flags),
+		  pfn * sizeof(flags)) != sizeof(flags))
+		return -1;
+
+	return !!(flags & (KPF_COMPOUND_HEAD | KPF_COMPOUND_TAIL));
+}
+
+static int drop_file_cache(int fd)
+{
+	if (fsync(fd))
+		return -1;
+	return posix_fadvise(fd, 0, FILE_SIZE, POSIX_FADV_DONTNEED);
+}
+
+int main(int argc, char **argv)
+{
+	const char *dir = argc > 1 ? argv[1] : ".";
+	unsigned long off, large = 0, nr = 0;
+	char path[4096], *buf, *map;
+	int fd, ret;
+
+	ksft_print_header();
+	ksft_set_plan(1);
+
+	pagemap_fd = open("/proc/self/pagemap", O_RDONLY);
+	kpageflags_fd = open("/proc/kpageflags", O_RDONLY);
+	if (pagemap_fd < 0 || kpageflags_fd < 0)
+		ksft_exit_skip("Cannot open pagemap or kpageflags, run as root\n");
+
+	buf = malloc(STRIDE);
+	if (!buf)
+		ksft_exit_fail_msg("malloc failed\n");
+	memset(buf, 0x5a, STRIDE);
+
+	snprintf(path, sizeof(path), "%s/readahead_stride_XXXXXX", dir);
+	fd = mkstemp(path);
+	if (fd < 0)
+		ksft_exit_fail_msg("Cannot create a file in %s\n", dir);
+	unlink(path);
+
+	for (off = 0; off < FILE_SIZE; off += STRIDE)
+		if (write(fd, buf, STRIDE) != STRIDE)
+			ksft_exit_fail_msg("write failed\n");
+
+	map = mmap(NULL, FILE_SIZE, PROT_READ, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		ksft_exit_fail_msg("mmap failed\n");
+
+	/* A sequential read tells whether this filesystem can do it at all */
+	if (drop_file_cache(fd))
+		ksft_exit_fail_msg("Cannot drop the page cache of the file\n");
+	for (off = 0; off < FILE_SIZE; off += STRIDE)
+		if (pread(fd, buf, STRIDE, off) != STRIDE)
+			ksft_exit_fail_msg("pread failed\n");
+	ret = is_large_folio(map, FILE_SIZE / 2);
+	if (ret < 0)
+		ksft_exit_fail_msg("Cannot read the page flags\n");
+	if (!ret)
+		ksft_exit_skip("No large folios for sequential reads on %s\n", dir);
+
+	if (drop_file_cache(fd))
+		ksft_exit_fail_msg("Cannot drop the page cache of the file\n");
+	for (off = 0; off < FILE_SIZE; off += STRIDE)
+		if (pread(fd, buf, READ_SIZE, off) != READ_SIZE)
+			ksft_exit_fail_msg("pread failed\n");
+
+	/* The first two reads only establish the stride */
+	for (off = 2 * STRIDE; off < FILE_SIZE; off += STRIDE) {
+		ret = is_large_folio(map, off);
+		if (ret < 0)
+			ksft_exit_fail_msg("Cannot read the page flags\n");
+		large += ret;
+		nr++;
+	}
+
+	ksft_print_msg("%lu of %lu strided reads got a large folio\n",
+		       large, nr);
+	ksft_test_result(large == nr, "strided reads get large folios\n");
+
+	munmap(map, FILE_SIZE);
+	close(fd);
+	free(buf);
+	ksft_finished();
+}
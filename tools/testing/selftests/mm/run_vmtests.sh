@@ -443,6 +443,7 @@ if [ -z "${SPLIT_HUGE_PAGE_TEST_XFS_PATH}" ]; then
 fi
 
 CATEGORY="thp" run_test ./split_huge_page_test ${SPLIT_HUGE_PAGE_TEST_XFS_PATH}
+CATEGORY="thp" run_test ./readahead_stride ${SPLIT_HUGE_PAGE_TEST_XFS_PATH}
 
 if [ -n "${MOUNTED_XFS}" ]; then
     umount ${SPLIT_HUGE_PAGE_TEST_XFS_PATH}
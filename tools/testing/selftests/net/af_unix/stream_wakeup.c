@@ -0,0 +1,203 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * unix_stream_sendmsg() only wakes the peer for the first skb of a send,
+ * before it could block and when it returns. A reader sleeping in recv()
+ * must still see every byte of a send, in order, without waiting for a
+ * later one.
+ */
+
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include "../../kselftest_harness.h"
+
+#define RECV_TIMEOUT_SEC	5
+#define STREAM_BYTES		(64 << 20)
+
+struct reader {
+	pthread_t thread;
+	int fd;
+	size_t expect;
+	size_t received;
+	int err;
+	bool corrupt;
+};
+
+/* A byte pattern that doesn't line up with skb or send sizes */
+static void fill(char *buf, size_t len, size_t off)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		buf[i] = (off + i) % 251;
+}
+
+static void *reader_fn(void *arg)
+{
+	struct reader *r = arg;
+	char buf[64 << 10];
+	ssize_t ret, i;
+
+	while (r->received < r->expect) {
+		ret = recv(r->fd, buf, sizeof(buf), 0);
+		if (ret <= 0) {
+			r->err = ret ? errno : EPIPE;
+			break;
+		}
+		for (i = 0; i < ret; i++)
+			if (buf[i] != (char)((r->received + i) % 251))
+				r->corrupt = true;
+		r->received += ret;
+	}
+
+	return NULL;
+}
+
+/* Send all of @buf, waiting for room if the socket is non-blocking */
+static int send_all(int fd, const char *buf, size_t len, int flags)
+{
+	struct pollfd pfd = { .fd = fd, .events = POLLOUT };
+	ssize_t ret;
+
+	while (len) {
+		ret = send(fd, buf, len, flags);
+		if (ret < 0 && errno == EAGAIN) {
+			if (poll(&pfd, 1, RECV_TIMEOUT_SEC * 1000) != 1)
+				return -ETIMEDOUT;
+			continue;
+		}
+		if (ret < 0)
+			return -errno;
+		buf += ret;
+		len -= ret;
+	}
+
+	return 0;
+}
+
+FIXTURE(stream_wakeup)
+{
+	int fd[2];
+	struct reader reader;
+};
+
+FIXTURE_VARIANT(stream_wakeup)
+{
+	size_t send_size;
+	int flags;
+};
+
+FIXTURE_VARIANT_ADD(stream_wakeup, small)
+{
+	.send_size = 100,
+};
+
+FIXTURE_VARIANT_ADD(stream_wakeup, page)
+{
+	.send_size = 4096,
+};
+
+FIXTURE_VARIANT_ADD(stream_wakeup, large)
+{
+	.send_size = 64 << 10,
+};
+
+/* More than the default sndbuf, so the sender sleeps in the middle */
+FIXTURE_VARIANT_ADD(stream_wakeup, above_sndbuf)
+{
+	.send_size = 1 << 20,
+};
+
+/* And bails out with -EAGAIN in the middle */
+FIXTURE_VARIANT_ADD(stream_wakeup, above_sndbuf_dontwait)
+{
+	.send_size = 1 << 20,
+	.flags = MSG_DONTWAIT,
+};
+
+FIXTURE_SETUP(stream_wakeup)
+{
+	struct timeval tv = { .tv_sec = RECV_TIMEOUT_SEC };
+
+	ASSERT_EQ(0, socketpair(AF_UNIX, SOCK_STREAM, 0, self->fd));
+	/* A lost wakeup makes recv() time out rather than hang */
+	ASSERT_EQ(0, setsockopt(self->fd[1], SOL_SOCKET, SO_RCVTIMEO,
+				&tv, sizeof(tv)));
+
+	memset(&self->reader, 0, sizeof(self->reader));
+	self->reader.fd = self->fd[1];
+}
+
+FIXTURE_TEARDOWN(stream_wakeup)
+{
+	close(self->fd[0]);
+	close(self->fd[1]);
+}
+
+static void start_reader(struct __test_metadata *_metadata,
+			 struct reader *reader, size_t expect)
+{
+	reader->expect = expect;
+	ASSERT_EQ(0, pthread_create(&reader->thread, NULL, reader_fn, reader));
+	/* Let it go to sleep in recv() */
+	usleep(50000);
+}
+
+static void check_reader(struct __test_metadata *_metadata,
+			 struct reader *reader)
+{
+	ASSERT_EQ(0, pthread_join(reader->thread, NULL));
+	EXPECT_EQ(0, reader->err);
+	EXPECT_EQ(reader->expect, reader->received);
+	EXPECT_FALSE(reader->corrupt);
+}
+
+/* One send, with the socket left open: its last skb must wake the reader */
+TEST_F(stream_wakeup, single_send)
+{
+	size_t size = variant->send_size;
+	char *buf;
+
+	buf = malloc(size);
+	ASSERT_NE(NULL, buf);
+	fill(buf, size, 0);
+
+	start_reader(_metadata, &self->reader, size);
+	EXPECT_EQ(0, send_all(self->fd[0], buf, size, variant->flags));
+	check_reader(_metadata, &self->reader);
+
+	free(buf);
+}
+
+/* Many sends, all of which must arrive intact and in order */
+TEST_F(stream_wakeup, stream)
+{
+	size_t size = variant->send_size, off;
+	char *buf;
+
+	buf = malloc(size);
+	ASSERT_NE(NULL, buf);
+
+	start_reader(_metadata, &self->reader, STREAM_BYTES);
+	for (off = 0; off < STREAM_BYTES; off += size) {
+		size_t len = STREAM_BYTES - off < size ? STREAM_BYTES - off : size;
+
+		fill(buf, len, off);
+		if (send_all(self->fd[0], buf, len, variant->flags)) {
+			TH_LOG("send failed at offset %zu", off);
+			break;
+		}
+	}
+	check_reader(_metadata, &self->reader);
+
+	free(buf);
+}
+
+TEST_HARNESS_MAIN
@@ -0,0 +1,212 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Confirm new conntrack entries while expired ones pile up in the table.
+ *
+ * Each sender thread sends one UDP datagram per flow to a distinct
+ * 127.x.y.z:port destination, so every packet creates and confirms a new
+ * conntrack entry. With a UDP timeout shorter than the run, the hash
+ * chains fill with expired entries that confirming walks past and reaps.
+ * Every datagram sent must have been inserted, and no insertion may fail
+ * or find its chain too long. The new-connection rate is reported.
+ *
+ * Run it from conntrack_churn.sh, which sets up a netns with a conntrack
+ * rule on the output path and a short UDP timeout.
+ */
+#define _GNU_SOURCE
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../../kselftest.h"
+
+#define CT_COUNT	"/proc/sys/net/netfilter/nf_conntrack_count"
+#define CT_STAT		"/proc/net/stat/nf_conntrack"
+#define DEFAULT_SECS	5
+#define PORT_BASE	1024
+#define NR_PORTS	(65536 - PORT_BASE)
+
+struct sender {
+	pthread_t thread;
+	unsigned int id;
+	unsigned long sent;
+};
+
+struct ct_stat {
+	unsigned long chaintoolong;
+	unsigned long insert;
+	unsigned long insert_failed;
+	unsigned long drop;
+};
+
+static unsigned int nr_threads;
+static volatile bool stop;
+
+static void *sender_fn(void *arg)
+{
+	struct sender *s = arg;
+	struct sockaddr_in sin = {
+		.sin_family = AF_INET,
+	};
+	unsigned long flow;
+	cpu_set_t cpus;
+	char c = 0;
+	int fd;
+
+	CPU_ZERO(&cpus);
+	CPU_SET(s->id, &cpus);
+	sched_setaffinity(0, sizeof(cpus), &cpus);
+
+	fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (fd < 0)
+		ksft_exit_fail_msg("socket: %s\n", strerror(errno));
+
+	/* interleave the threads over the 127.0.0.0/8 x port space */
+	for (flow = s->id; !stop; flow += nr_threads) {
+		unsigned long addr = flow / NR_PORTS % 0xfffffe + 1;
+
+		sin.sin_addr.s_addr = htonl(0x7f000000 | addr);
+		sin.sin_port = htons(PORT_BASE + flow % NR_PORTS);
+
+		if (sendto(fd, &c, 1, 0, (struct sockaddr *)&sin, sizeof(sin)) == 1)
+			s->sent++;
+	}
+
+	close(fd);
+	return NULL;
+}
+
+static long read_ct_count(void)
+{
+	long count = -1;
+	FILE *f;
+
+	f = fopen(CT_COUNT, "r");
+	if (!f)
+		return -1;
+	if (fscanf(f, "%ld", &count) != 1)
+		count = -1;
+	fclose(f);
+
+	return count;
+}
+
+/* Sum the per-CPU counters of the netns */
+static int read_ct_stat(struct ct_stat *st)
+{
+	unsigned long v[17];
+	char line[512];
+	FILE *f;
+	int i;
+
+	f = fopen(CT_STAT, "r");
+	if (!f)
+		return -1;
+
+	memset(st, 0, sizeof(*st));
+	/* skip the header */
+	if (!fgets(line, sizeof(line), f)) {
+		fclose(f);
+		return -1;
+	}
+	while (fgets(line, sizeof(line), f)) {
+		char *p = line;
+
+		for (i = 0; i < 17; i++)
+			v[i] = strtoul(p, &p, 16);
+		st->chaintoolong += v[7];
+		st->insert += v[8];
+		st->insert_failed += v[9];
+		st->drop += v[10];
+	}
+	fclose(f);
+
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int secs = DEFAULT_SECS, i;
+	struct ct_stat before, after;
+	struct timespec start, end;
+	unsigned long total = 0;
+	struct sender *senders;
+	double elapsed;
+	int opt;
+
+	nr_threads = sysconf(_SC_NPROCESSORS_ONLN);
+
+	while ((opt = getopt(argc, argv, "t:s:")) != -1) {
+		switch (opt) {
+		case 't':
+			nr_threads = atoi(optarg);
+			break;
+		case 's':
+			secs = atoi(optarg);
+			break;
+		default:
+			fprintf(stderr, "usage: %s [-t threads] [-s seconds]\n", argv[0]);
+			return KSFT_FAIL;
+		}
+	}
+
+	ksft_print_header();
+
+	if (read_ct_count() < 0 || read_ct_stat(&before))
+		ksft_exit_skip("nf_conntrack not loaded\n");
+
+	if (!nr_threads)
+		nr_threads = 1;
+
+	senders = calloc(nr_threads, sizeof(*senders));
+	if (!senders)
+		ksft_exit_fail_msg("out of memory\n");
+
+	ksft_set_plan(2);
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < nr_threads; i++) {
+		senders[i].id = i;
+		if (pthread_create(&senders[i].thread, NULL, sender_fn, &senders[i]))
+			ksft_exit_fail_msg("pthread_create: %s\n", strerror(errno));
+	}
+
+	sleep(secs);
+	stop = true;
+
+	for (i = 0; i < nr_threads; i++) {
+		pthread_join(senders[i].thread, NULL);
+		total += senders[i].sent;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	elapsed = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) / 1e9;
+
+	if (read_ct_stat(&after))
+		ksft_exit_fail_msg("cannot read " CT_STAT "\n");
+
+	ksft_print_msg("%u threads: %.0f new conns/s, %ld entries in table\n",
+		       nr_threads, total / elapsed, read_ct_count());
+
+	ksft_test_result(total && after.insert - before.insert >= total,
+			 "%lu datagrams, %lu entries inserted\n",
+			 total, after.insert - before.insert);
+	ksft_test_result(after.chaintoolong == before.chaintoolong &&
+			 after.insert_failed == before.insert_failed &&
+			 after.drop == before.drop,
+			 "%lu chain too long, %lu insert failed, %lu dropped\n",
+			 after.chaintoolong - before.chaintoolong,
+			 after.insert_failed - before.insert_failed,
+			 after.drop - before.drop);
+
+	free(senders);
+	ksft_finished();
+}
@@ -0,0 +1,49 @@
+#!/bin/bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Create conntrack entries at a high rate with a short UDP timeout, so that
+# the table churns and expired entries have to be reaped while new ones are
+# confirmed. conntrack_churn checks that every insertion succeeds.
+
+ksft_skip=4
+ns="ctchurn-$(mktemp -u XXXXXX)"
+timeout=${CT_UDP_TIMEOUT:-2}
+secs=${CHURN_SECS:-5}
+
+cleanup() {
+	ip netns del "$ns" 2>/dev/null
+}
+
+if [ "$(id -u)" -ne 0 ]; then
+	echo "SKIP: must be run as root"
+	exit $ksft_skip
+fi
+
+if ! nft --version > /dev/null 2>&1; then
+	echo "SKIP: could not run test without nft tool"
+	exit $ksft_skip
+fi
+
+if [ ! -x ./conntrack_churn ]; then
+	echo "SKIP: conntrack_churn not built"
+	exit $ksft_skip
+fi
+
+trap cleanup EXIT
+
+ip netns add "$ns" || exit $ksft_skip
+ip -net "$ns" link set lo up
+
+ip netns exec "$ns" nft -f - <<EOF
+table inet ctchurn {
+	chain output {
+		type filter hook output priority 0; policy accept;
+		ct state new counter
+	}
+}
+EOF
+[ $? -ne 0 ] && echo "SKIP: could not add conntrack rule" && exit $ksft_skip
+
+ip netns exec "$ns" sysctl -q net.netfilter.nf_conntrack_udp_timeout="$timeout"
+
+ip netns exec "$ns" ./conntrack_churn -s "$secs"
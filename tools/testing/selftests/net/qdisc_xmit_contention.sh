@@ -0,0 +1,103 @@
+#!/bin/bash
+# SPDX-License-Identifier: GPL-2.0
+#
+# Measure how qdisc enqueue scales when many CPUs send through one TX queue.
+#
+# A dummy device with a single TX queue gets fq as root qdisc. One pktgen
+# thread per CPU, on 1, 2, 4, ... CPUs, sends through dev_queue_xmit(), so all
+# senders contend on the same fq instance whatever skb_tx_hash() picks. The
+# rate at each step is reported. The test fails if pktgen fails, if a step
+# sends nothing, or if the rate on all CPUs collapses to less than
+# MIN_SCALE_PCT percent of the single CPU rate.
+
+readonly PG=/proc/net/pktgen
+readonly DEV=dummy0
+readonly DURATION=2
+readonly MIN_SCALE_PCT=50
+readonly KSFT_FAIL=1
+readonly KSFT_SKIP=4
+
+# run inside private netns
+if [[ $# -eq 0 ]]; then
+	./in_netns.sh "$0" __subprocess
+	exit
+fi
+
+pgset() {
+	echo "$2" > "$1" || { echo "FAIL: pktgen: '$2' > $1"; exit "${KSFT_FAIL}"; }
+}
+
+if [[ ! -d "${PG}" ]]; then
+	modprobe pktgen 2>/dev/null
+	if [[ ! -d "${PG}" ]]; then
+		echo "SKIP: pktgen not available"
+		exit "${KSFT_SKIP}"
+	fi
+fi
+
+ip link add "${DEV}" numtxqueues 1 type dummy || exit "${KSFT_SKIP}"
+ip link set dev "${DEV}" up
+tc qdisc replace dev "${DEV}" root fq limit 100000 || exit "${KSFT_SKIP}"
+
+nr_cpus=$(nproc)
+
+run() {
+	local cpus=$1 cpu sent
+
+	pgset "${PG}/pgctrl" "reset"
+	for ((cpu = 0; cpu < cpus; cpu++)); do
+		pgset "${PG}/kpktgend_${cpu}" "rem_device_all"
+		pgset "${PG}/kpktgend_${cpu}" "add_device ${DEV}@${cpu}"
+
+		local pgdev="${PG}/${DEV}@${cpu}"
+		pgset "${pgdev}" "xmit_mode queue_xmit"
+		pgset "${pgdev}" "pkt_size 60"
+		pgset "${pgdev}" "count 0"
+		pgset "${pgdev}" "dst 198.18.0.1"
+		pgset "${pgdev}" "dst_mac 02:00:00:00:00:01"
+		pgset "${pgdev}" "flows 1024"
+		pgset "${pgdev}" "flowlen 8"
+		pgset "${pgdev}" "udp_src_min 1024"
+		pgset "${pgdev}" "udp_src_max 65535"
+	done
+
+	pgset "${PG}/pgctrl" "start" &
+	sleep "${DURATION}"
+	pgset "${PG}/pgctrl" "stop"
+	wait $! || exit "${KSFT_FAIL}"
+
+	sent=0
+	for ((cpu = 0; cpu < cpus; cpu++)); do
+		local pkts
+
+		pkts=$(sed -n 's/.*pkts-sofar: \([0-9]*\).*/\1/p' \
+			"${PG}/${DEV}@${cpu}")
+		sent=$((sent + ${pkts:-0}))
+	done
+
+	pps=$((sent / DURATION))
+	printf "cpus %3d: %10d pps\n" "${cpus}" "${pps}"
+	if [[ ${pps} -eq 0 ]]; then
+		echo "FAIL: nothing sent on ${cpus} CPUs"
+		exit "${KSFT_FAIL}"
+	fi
+}
+
+cpus=1
+while :; do
+	run "${cpus}"
+	[[ ${cpus} -eq 1 ]] && pps_one=${pps}
+	[[ ${cpus} -ge ${nr_cpus} ]] && break
+	cpus=$((cpus * 2))
+	[[ ${cpus} -gt ${nr_cpus} ]] && cpus=${nr_cpus}
+done
+
+pgset "${PG}/pgctrl" "reset"
+tc -s qdisc show dev "${DEV}"
+
+if [[ $((pps * 100)) -lt $((pps_one * MIN_SCALE_PCT)) ]]; then
+	echo "FAIL: ${nr_cpus} CPUs send ${pps} pps, 1 CPU sends ${pps_one} pps"
+	exit "${KSFT_FAIL}"
+fi
+echo "PASS"
+exit 0
@@ -578,6 +578,43 @@ int main(void)
 		assert(err == -ENOENT);
 	}
 
+	/* Test PROCMAP_MEMSTAT ioctl() for /proc/$PID/maps */
+	{
+		char path_buf[256];
+		struct procmap_memstat ms;
+		int fd, err;
+
+		snprintf(path_buf, sizeof(path_buf), "/proc/%u/maps", pid);
+		fd = open(path_buf, O_RDONLY);
+		if (fd == -1)
+			return 1;
+
+		/* The only mapping is the single executable page at VADDR */
+		memset(&ms, 0, sizeof(ms));
+		ms.size = sizeof(ms);
+		ms.mask = PROCMAP_MEMSTAT_VM | PROCMAP_MEMSTAT_SEGMENTS | (1ULL << 63);
+
+		err = ioctl(fd, PROCMAP_MEMSTAT, &ms);
+		assert(err == 0);
+
+		assert(ms.mask == (PROCMAP_MEMSTAT_VM | PROCMAP_MEMSTAT_SEGMENTS));
+		assert(ms.vm_size == PAGE_SIZE);
+		assert(ms.vm_peak >= PAGE_SIZE);
+		assert(ms.exec == PAGE_SIZE);
+		assert(ms.data == 0);
+		assert(ms.stack == 0);
+		/* not requested */
+		assert(ms.rss_anon == 0 && ms.rss_file == 0 && ms.pgtables == 0);
+
+		/* Too small to hold the mask */
+		memset(&ms, 0, sizeof(ms));
+		ms.size = sizeof(ms.size);
+
+		err = ioctl(fd, PROCMAP_MEMSTAT, &ms);
+		err = err < 0 ? -errno : 0;
+		assert(err == -EINVAL);
+	}
+
 	return 0;
 }
 #else
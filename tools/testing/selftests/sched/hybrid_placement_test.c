@@ -0,0 +1,369 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Check task placement on hybrid x86 parts with asymmetric CPU capacity
+ * scheduling, or with ITMT when booted with intel_pstate=no_cas.
+ *
+ * The sched domains must carry SD_ASYM_CPUCAPACITY with asym capacity, and
+ * SD_ASYM_PACKING without it with ITMT.
+ *
+ * Latency threads wake up every millisecond, run for a short burst and record
+ * their wakeup latency and the core type they ran on. Throughput threads spin
+ * and count loops, sampling the core type they run on. With asym capacity,
+ * latency threads get uclamp_min = 1024 and throughput threads get
+ * uclamp_max = 512, and most latency samples must be on P-cores. The
+ * latency and throughput figures of both modes are reported for comparison.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../kselftest.h"
+
+#define P_CORE_CPUS	"/sys/devices/cpu_core/cpus"
+#define E_CORE_CPUS	"/sys/devices/cpu_atom/cpus"
+#define ITMT_SYSCTL	"/proc/sys/kernel/sched_itmt_enabled"
+#define SCHED_DEBUG	"/sys/kernel/debug/sched"
+
+#define RUN_SECS	5
+#define PERIOD_NS	1000000ULL
+#define BURST_NS	200000ULL
+#define MAX_SAMPLES	(RUN_SECS * 1000 + 1000)
+
+#define SCHED_FLAG_KEEP_ALL		0x18
+#define SCHED_FLAG_UTIL_CLAMP_MIN	0x20
+#define SCHED_FLAG_UTIL_CLAMP_MAX	0x40
+
+struct sched_attr {
+	uint32_t size;
+	uint32_t sched_policy;
+	uint64_t sched_flags;
+	int32_t  sched_nice;
+	uint32_t sched_priority;
+	uint64_t sched_runtime;
+	uint64_t sched_deadline;
+	uint64_t sched_period;
+	uint32_t sched_util_min;
+	uint32_t sched_util_max;
+};
+
+struct thread_data {
+	pthread_t thread;
+	bool latency;
+	unsigned long nr_samples;
+	unsigned long on_pcore;
+	unsigned long loops;
+	uint64_t *lat;
+};
+
+static cpu_set_t pcores, ecores;
+static volatile bool stop;
+static bool use_uclamp;
+
+static int parse_cpulist(const char *path, cpu_set_t *set)
+{
+	char buf[4096], *tok, *save;
+	FILE *f;
+
+	f = fopen(path, "r");
+	if (!f)
+		return -errno;
+
+	if (!fgets(buf, sizeof(buf), f)) {
+		fclose(f);
+		return -EINVAL;
+	}
+	fclose(f);
+
+	CPU_ZERO(set);
+	for (tok = strtok_r(buf, ",\n", &save); tok;
+	     tok = strtok_r(NULL, ",\n", &save)) {
+		int first, last, cpu;
+
+		if (sscanf(tok, "%d-%d", &first, &last) != 2)
+			last = first = atoi(tok);
+		for (cpu = first; cpu <= last; cpu++)
+			CPU_SET(cpu, set);
+	}
+
+	return 0;
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int sched_set_uclamp(uint64_t flag, uint32_t min, uint32_t max)
+{
+	struct sched_attr attr = {
+		.size		= sizeof(attr),
+		.sched_flags	= SCHED_FLAG_KEEP_ALL | flag,
+		.sched_util_min	= min,
+		.sched_util_max	= max,
+	};
+
+	return syscall(SYS_sched_setattr, 0, &attr, 0) ? -errno : 0;
+}
+
+static void set_uclamp(bool latency)
+{
+	int ret;
+
+	if (latency)
+		ret = sched_set_uclamp(SCHED_FLAG_UTIL_CLAMP_MIN, 1024, 0);
+	else
+		ret = sched_set_uclamp(SCHED_FLAG_UTIL_CLAMP_MAX, 0, 512);
+	if (ret)
+		ksft_exit_fail_msg("sched_setattr: %s\n", strerror(-ret));
+}
+
+static void sample_cpu(struct thread_data *td)
+{
+	td->nr_samples++;
+	if (CPU_ISSET(sched_getcpu(), &pcores))
+		td->on_pcore++;
+}
+
+static void *latency_fn(void *arg)
+{
+	struct thread_data *td = arg;
+	uint64_t next = now_ns() + PERIOD_NS;
+
+	if (use_uclamp)
+		set_uclamp(true);
+
+	while (!stop && td->nr_samples < MAX_SAMPLES) {
+		struct timespec ts = {
+			.tv_sec		= next / 1000000000ULL,
+			.tv_nsec	= next % 1000000000ULL,
+		};
+		uint64_t t;
+
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL);
+		t = now_ns();
+		td->lat[td->nr_samples] = t - next;
+		sample_cpu(td);
+
+		while (now_ns() - t < BURST_NS)
+			;
+		next += PERIOD_NS;
+	}
+
+	return NULL;
+}
+
+static void *throughput_fn(void *arg)
+{
+	struct thread_data *td = arg;
+
+	if (use_uclamp)
+		set_uclamp(false);
+
+	while (!stop) {
+		if (!(++td->loops % (1 << 20)))
+			sample_cpu(td);
+	}
+
+	return NULL;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a, y = *(const uint64_t *)b;
+
+	return x < y ? -1 : x > y;
+}
+
+/* The ITMT sysctl only exists when ITMT priorities were registered */
+static bool itmt_enabled(void)
+{
+	FILE *f = fopen(ITMT_SYSCTL, "r");
+	int enabled = 0;
+
+	if (!f)
+		return false;
+	if (fscanf(f, "%d", &enabled) != 1)
+		enabled = 0;
+	fclose(f);
+
+	return enabled;
+}
+
+static int write_str(const char *path, const char *str)
+{
+	FILE *f = fopen(path, "w");
+	int ret;
+
+	if (!f)
+		return -errno;
+	ret = fputs(str, f) < 0 ? -EIO : 0;
+	if (fclose(f) && !ret)
+		ret = -errno;
+	return ret;
+}
+
+/*
+ * Look for SD_ASYM_CPUCAPACITY and SD_ASYM_PACKING in the sched domains of
+ * @cpu. The domains only show up in debugfs with sched verbose set, so set
+ * it for the time of the lookup.
+ */
+static int sched_domain_flags(int cpu, bool *asym_cap, bool *asym_packing)
+{
+	char path[128], flags[1024], verbose[4] = "";
+	int level, ret;
+	FILE *f;
+
+	f = fopen(SCHED_DEBUG "/verbose", "r");
+	if (!f)
+		return -errno;
+	if (!fgets(verbose, sizeof(verbose), f))
+		verbose[0] = 'N';
+	fclose(f);
+
+	if (verbose[0] != 'Y') {
+		ret = write_str(SCHED_DEBUG "/verbose", "Y");
+		if (ret)
+			return ret;
+	}
+
+	*asym_cap = *asym_packing = false;
+	for (level = 0; ; level++) {
+		snprintf(path, sizeof(path), SCHED_DEBUG "/domains/cpu%d/domain%d/flags",
+			 cpu, level);
+		f = fopen(path, "r");
+		if (!f)
+			break;
+		if (fgets(flags, sizeof(flags), f)) {
+			if (strstr(flags, "SD_ASYM_CPUCAPACITY "))
+				*asym_cap = true;
+			if (strstr(flags, "SD_ASYM_PACKING "))
+				*asym_packing = true;
+		}
+		fclose(f);
+	}
+
+	if (verbose[0] != 'Y')
+		write_str(SCHED_DEBUG "/verbose", "N");
+
+	return level ? 0 : -ENOENT;
+}
+
+static int first_cpu(cpu_set_t *set)
+{
+	int cpu;
+
+	for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+		if (CPU_ISSET(cpu, set))
+			return cpu;
+	return -1;
+}
+
+int main(void)
+{
+	unsigned long lat_samples = 0, lat_pcore = 0, tput_samples = 0;
+	unsigned long tput_pcore = 0, loops = 0;
+	bool asym_cap, asym_packing, itmt;
+	int nr_lat, nr_tput, nr, i, ret;
+	struct thread_data *td;
+	uint64_t *lat;
+
+	ksft_print_header();
+
+	if (parse_cpulist(P_CORE_CPUS, &pcores) ||
+	    parse_cpulist(E_CORE_CPUS, &ecores))
+		ksft_exit_skip("not a hybrid system\n");
+	ksft_set_plan(2);
+
+	itmt = itmt_enabled();
+	ret = sched_domain_flags(first_cpu(&pcores), &asym_cap, &asym_packing);
+	if (ret)
+		ksft_test_result_skip("sched domains not readable: %s\n",
+				      strerror(-ret));
+	else if (itmt)
+		ksft_test_result(!asym_cap && asym_packing,
+				 "ITMT: asym packing and no asym capacity domain\n");
+	else
+		ksft_test_result(asym_cap,
+				 "asym capacity: SD_ASYM_CPUCAPACITY domain\n");
+
+	/* Check that uclamp is there before the threads rely on it */
+	use_uclamp = !itmt && !sched_set_uclamp(SCHED_FLAG_UTIL_CLAMP_MIN, 0, 0);
+
+	/* One latency thread per P-core CPU, one throughput thread per E-core CPU */
+	nr_lat = CPU_COUNT(&pcores);
+	nr_tput = CPU_COUNT(&ecores);
+	nr = nr_lat + nr_tput;
+
+	td = calloc(nr, sizeof(*td));
+	lat = calloc((size_t)nr_lat * MAX_SAMPLES, sizeof(*lat));
+	if (!td || !lat)
+		ksft_exit_fail_msg("out of memory\n");
+
+	ksft_print_msg("placement: %s%s, %d latency and %d throughput threads\n",
+		       itmt ? "ITMT" : "asym capacity",
+		       use_uclamp ? " + uclamp" : "", nr_lat, nr_tput);
+
+	for (i = 0; i < nr; i++) {
+		td[i].latency = i < nr_lat;
+		td[i].lat = lat + (size_t)i * MAX_SAMPLES;
+		if (pthread_create(&td[i].thread, NULL,
+				   td[i].latency ? latency_fn : throughput_fn,
+				   &td[i]))
+			ksft_exit_fail_msg("pthread_create: %s\n", strerror(errno));
+	}
+
+	sleep(RUN_SECS);
+	stop = true;
+
+	for (i = 0; i < nr; i++) {
+		pthread_join(td[i].thread, NULL);
+
+		if (td[i].latency) {
+			/* compact the samples for the percentiles */
+			memmove(lat + lat_samples, td[i].lat,
+				td[i].nr_samples * sizeof(*lat));
+			lat_samples += td[i].nr_samples;
+			lat_pcore += td[i].on_pcore;
+		} else {
+			tput_samples += td[i].nr_samples;
+			tput_pcore += td[i].on_pcore;
+			loops += td[i].loops;
+		}
+	}
+
+	if (!lat_samples)
+		ksft_exit_fail_msg("no latency samples\n");
+
+	qsort(lat, lat_samples, sizeof(*lat), cmp_u64);
+
+	ksft_print_msg("latency: p50 %lu us, p99 %lu us, %.1f%% on P-cores\n",
+		       (unsigned long)(lat[lat_samples / 2] / 1000),
+		       (unsigned long)(lat[lat_samples * 99 / 100] / 1000),
+		       100.0 * lat_pcore / lat_samples);
+	ksft_print_msg("throughput: %.1f Mloops/s, %.1f%% on E-cores\n",
+		       loops / 1e6 / RUN_SECS, tput_samples ?
+		       100.0 * (tput_samples - tput_pcore) / tput_samples : 0.0);
+
+	/* uclamp_min = 1024 only fits the biggest CPUs */
+	if (use_uclamp)
+		ksft_test_result(lat_pcore * 2 > lat_samples,
+				 "uclamp_min 1024 threads mostly on P-cores\n");
+	else
+		ksft_test_result_skip("uclamp placement needs asym capacity and uclamp\n");
+
+	free(lat);
+	free(td);
+	ksft_finished();
+}
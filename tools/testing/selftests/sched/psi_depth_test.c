@@ -0,0 +1,249 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Check that PSI accounts CPU pressure at every level of a cgroup hierarchy.
+ *
+ * Every task state change walks all cgroup levels of the task to update
+ * their PSI state. At increasing depths, two threads pinned to one CPU spin
+ * in the deepest cgroup, so that one of them is always waiting for the
+ * CPU, and the "some" CPU stall total of every level up to the top of the
+ * test hierarchy must grow by most of that time. The per-switch cost of a
+ * ping-pong between the two threads is reported at each depth.
+ *
+ * Requires root and cgroup2 mounted at /sys/fs/cgroup.
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "../kselftest.h"
+
+#define CGROUP_ROOT	"/sys/fs/cgroup"
+#define TEST_NAME	"psi_depth_test"
+#define MAX_DEPTH	8
+#define NR_LOOPS	200000
+/* Both threads spin this long, and at least half of it must be a stall */
+#define SPIN_MS		500
+#define MIN_STALL_US	(SPIN_MS * 1000 / 2)
+
+static int ping[2], pong[2];
+
+static int write_file(const char *path, const char *buf)
+{
+	int fd, ret;
+
+	fd = open(path, O_WRONLY);
+	if (fd < 0)
+		return -errno;
+
+	ret = write(fd, buf, strlen(buf));
+	close(fd);
+
+	return ret < 0 ? -errno : 0;
+}
+
+static int move_self(const char *cgroup)
+{
+	char path[PATH_MAX], pid[32];
+
+	snprintf(path, sizeof(path), "%s/cgroup.procs", cgroup);
+	snprintf(pid, sizeof(pid), "%d", getpid());
+
+	return write_file(path, pid);
+}
+
+static void cgroup_path(char *buf, size_t size, int depth)
+{
+	int i, len;
+
+	len = snprintf(buf, size, "%s/%s", CGROUP_ROOT, TEST_NAME);
+	for (i = 1; i <= depth; i++)
+		len += snprintf(buf + len, size - len, "/l%d", i);
+}
+
+static void cleanup(void)
+{
+	char path[PATH_MAX];
+	int depth;
+
+	move_self(CGROUP_ROOT);
+	for (depth = MAX_DEPTH; depth >= 0; depth--) {
+		cgroup_path(path, sizeof(path), depth);
+		rmdir(path);
+	}
+}
+
+/* The "some" CPU stall total of a cgroup, in microseconds */
+static long long cpu_some_total(const char *cgroup)
+{
+	char path[PATH_MAX];
+	long long total;
+	FILE *f;
+	int ret;
+
+	snprintf(path, sizeof(path), "%s/cpu.pressure", cgroup);
+	f = fopen(path, "r");
+	if (!f)
+		ksft_exit_fail_msg("open %s: %s\n", path, strerror(errno));
+	ret = fscanf(f, "some avg10=%*f avg60=%*f avg300=%*f total=%lld", &total);
+	fclose(f);
+	if (ret != 1)
+		ksft_exit_fail_msg("cannot parse %s\n", path);
+
+	return total;
+}
+
+static double elapsed_ns(struct timespec *start)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (now.tv_sec - start->tv_sec) * 1e9 +
+	       (now.tv_nsec - start->tv_nsec);
+}
+
+static void *spinner(void *arg)
+{
+	struct timespec start;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	while (elapsed_ns(&start) < SPIN_MS * 1e6)
+		;
+
+	return NULL;
+}
+
+/* Returns true if every level from the top down to @depth saw the stall */
+static bool check_pressure(int depth)
+{
+	long long before[MAX_DEPTH + 1], delta;
+	char path[PATH_MAX];
+	pthread_t threads[2];
+	bool ok = true;
+	int i;
+
+	for (i = 0; i <= depth; i++) {
+		cgroup_path(path, sizeof(path), i);
+		before[i] = cpu_some_total(path);
+	}
+
+	for (i = 0; i < 2; i++) {
+		if (pthread_create(&threads[i], NULL, spinner, NULL))
+			ksft_exit_fail_msg("pthread_create: %s\n", strerror(errno));
+	}
+	for (i = 0; i < 2; i++)
+		pthread_join(threads[i], NULL);
+
+	for (i = 0; i <= depth; i++) {
+		cgroup_path(path, sizeof(path), i);
+		delta = cpu_some_total(path) - before[i];
+		if (delta < MIN_STALL_US) {
+			ksft_print_msg("level %d: cpu some total grew by %lld us, expected at least %d\n",
+				       i + 1, delta, MIN_STALL_US);
+			ok = false;
+		}
+	}
+
+	return ok;
+}
+
+static void *ponger(void *arg)
+{
+	char c;
+	int i;
+
+	for (i = 0; i < NR_LOOPS; i++) {
+		if (read(ping[0], &c, 1) != 1 || write(pong[1], &c, 1) != 1)
+			break;
+	}
+
+	return NULL;
+}
+
+static double run_pingpong(void)
+{
+	struct timespec start;
+	pthread_t thread;
+	double ns;
+	char c = 0;
+	int i;
+
+	if (pthread_create(&thread, NULL, ponger, NULL))
+		ksft_exit_fail_msg("pthread_create: %s\n", strerror(errno));
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (i = 0; i < NR_LOOPS; i++) {
+		if (write(ping[1], &c, 1) != 1 || read(pong[0], &c, 1) != 1)
+			ksft_exit_fail_msg("pipe: %s\n", strerror(errno));
+	}
+	ns = elapsed_ns(&start);
+
+	pthread_join(thread, NULL);
+
+	/* Two switches per round trip */
+	return ns / (2.0 * NR_LOOPS);
+}
+
+int main(void)
+{
+	char path[PATH_MAX];
+	cpu_set_t cpus;
+	double base = 0;
+	int depth;
+
+	ksft_print_header();
+
+	if (geteuid())
+		ksft_exit_skip("must be run as root\n");
+
+	if (access(CGROUP_ROOT "/cgroup.procs", W_OK))
+		ksft_exit_skip("cgroup2 not mounted at " CGROUP_ROOT "\n");
+
+	if (access(CGROUP_ROOT "/cpu.pressure", R_OK))
+		ksft_exit_skip("PSI not available\n");
+
+	CPU_ZERO(&cpus);
+	CPU_SET(sched_getcpu(), &cpus);
+	if (sched_setaffinity(0, sizeof(cpus), &cpus))
+		ksft_exit_fail_msg("sched_setaffinity: %s\n", strerror(errno));
+
+	if (pipe(ping) || pipe(pong))
+		ksft_exit_fail_msg("pipe: %s\n", strerror(errno));
+
+	atexit(cleanup);
+
+	ksft_set_plan(MAX_DEPTH + 1);
+
+	for (depth = 0; depth <= MAX_DEPTH; depth++) {
+		double ns;
+
+		cgroup_path(path, sizeof(path), depth);
+		if (mkdir(path, 0755) && errno != EEXIST)
+			ksft_exit_fail_msg("mkdir %s: %s\n", path, strerror(errno));
+
+		if (move_self(path))
+			ksft_exit_fail_msg("move to %s: %s\n", path, strerror(errno));
+
+		ksft_test_result(check_pressure(depth),
+				 "depth %d: cpu pressure seen at every level\n",
+				 depth + 1);
+
+		ns = run_pingpong();
+		if (!depth)
+			base = ns;
+		ksft_print_msg("depth %d: %.1f ns/switch (%+.1f ns vs depth 1)\n",
+			       depth + 1, ns, ns - base);
+	}
+
+	ksft_finished();
+}
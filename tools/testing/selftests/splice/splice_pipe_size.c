@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0
+/*
+ * Splicing page cache data into a pipe may use one pipe buffer for several
+ * pages of a large folio. Such a buffer must still count for all its pages:
+ * a pipe never holds more than its size, can't be shrunk below what it
+ * holds, and passes the data on intact through read(), splice() and tee().
+ */
+#define _GNU_SOURCE
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <sys/ioctl.h>
+
+#include "../kselftest_harness.h"
+
+#define FILE_SIZE	(4 << 20)
+
+static char pattern(size_t off)
+{
+	return off % 251;
+}
+
+static bool check_data(const char *buf, size_t len, size_t off)
+{
+	size_t i;
+
+	for (i = 0; i < len; i++)
+		if (buf[i] != pattern(off + i))
+			return false;
+	return true;
+}
+
+FIXTURE(splice_pipe)
+{
+	int fd;
+	int pipe[2];
+	int pipe_size;
+	long page_size;
+};
+
+FIXTURE_SETUP(splice_pipe)
+{
+	char path[] = "splice_pipe_size.XXXXXX";
+	static char buf[1 << 16];
+	size_t off, i;
+
+	self->page_size = sysconf(_SC_PAGESIZE);
+
+	self->fd = mkstemp(path);
+	ASSERT_GE(self->fd, 0);
+	unlink(path);
+
+	for (off = 0; off < FILE_SIZE; off += sizeof(buf)) {
+		for (i = 0; i < sizeof(buf); i++)
+			buf[i] = pattern(off + i);
+		ASSERT_EQ(sizeof(buf), write(self->fd, buf, sizeof(buf)));
+	}
+	/* Read it back so that readahead can use large folios */
+	posix_fadvise(self->fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+	ASSERT_EQ(0, lseek(self->fd, 0, SEEK_SET));
+	while (read(self->fd, buf, sizeof(buf)) > 0)
+		;
+
+	ASSERT_EQ(0, pipe2(self->pipe, O_NONBLOCK));
+	self->pipe_size = fcntl(self->pipe[1], F_GETPIPE_SZ);
+	ASSERT_GT(self->pipe_size, 0);
+}
+
+FIXTURE_TEARDOWN(splice_pipe)
+{
+	close(self->pipe[0]);
+	close(self->pipe[1]);
+	close(self->fd);
+}
+
+/* Splice from @off until the pipe or the file is full, return the bytes */
+static ssize_t fill_pipe(int fd, loff_t off, int pipe_fd)
+{
+	ssize_t total = 0, ret;
+
+	while (off < FILE_SIZE) {
+		ret = splice(fd, &off, pipe_fd, NULL, FILE_SIZE - off,
+			     SPLICE_F_NONBLOCK);
+		if (ret < 0 && errno == EAGAIN)
+			return total;
+		if (ret <= 0)
+			return -1;
+		total += ret;
+	}
+	return total;
+}
+
+/* A full pipe holds at most its size */
+TEST_F(splice_pipe, capacity)
+{
+	ssize_t spliced;
+	int queued;
+
+	spliced = fill_pipe(self->fd, 0, self->pipe[1]);
+	ASSERT_GT(spliced, 0);
+	EXPECT_LE(spliced, self->pipe_size);
+	ASSERT_EQ(0, ioctl(self->pipe[0], FIONREAD, &queued));
+	EXPECT_EQ(spliced, queued);
+
+	/* Not even a write of a single byte fits any more */
+	EXPECT_EQ(-1, write(self->pipe[1], "x", 1));
+	EXPECT_EQ(EAGAIN, errno);
+}
+
+/* The pipe can't be shrunk below what it holds, only after draining it */
+TEST_F(splice_pipe, shrink)
+{
+	char buf[1 << 16];
+	ssize_t spliced;
+
+	ASSERT_EQ(self->pipe_size, fcntl(self->pipe[1], F_SETPIPE_SZ,
+					 self->pipe_size));
+	spliced = fill_pipe(self->fd, 0, self->pipe[1]);
+	ASSERT_GT(spliced, 2 * self->page_size);
+
+	EXPECT_EQ(-1, fcntl(self->pipe[1], F_SETPIPE_SZ, 2 * self->page_size));
+	EXPECT_EQ(EBUSY, errno);
+
+	while (read(self->pipe[0], buf, sizeof(buf)) > 0)
+		;
+	EXPECT_EQ(2 * self->page_size,
+		  fcntl(self->pipe[1], F_SETPIPE_SZ, 2 * self->page_size));
+}
+
+/* Read the whole file through the pipe in pieces that split buffers */
+TEST_F(splice_pipe, read_in_pieces)
+{
+	size_t off = 0, done = 0;
+	char buf[1000];
+	ssize_t ret;
+
+	while (done < FILE_SIZE) {
+		if (off < FILE_SIZE) {
+			ret = fill_pipe(self->fd, off, self->pipe[1]);
+			ASSERT_GE(ret, 0);
+			off += ret;
+		}
+		ret = read(self->pipe[0], buf, sizeof(buf));
+		ASSERT_GT(ret, 0);
+		ASSERT_TRUE(check_data(buf, ret, done))
+			TH_LOG("bad data at offset %zu", done);
+		done += ret;
+	}
+}
+
+/* tee() and splice() between pipes charge the receiving pipe as well */
+TEST_F(splice_pipe, pipe_to_pipe)
+{
+	char buf[1 << 16];
+	int out[2], queued;
+	ssize_t spliced, ret;
+	size_t done;
+
+	ASSERT_EQ(0, pipe2(out, O_NONBLOCK));
+	ASSERT_EQ(2 * self->page_size,
+		  fcntl(out[1], F_SETPIPE_SZ, 2 * self->page_size));
+
+	spliced = fill_pipe(self->fd, 0, self->pipe[1]);
+	ASSERT_GT(spliced, 2 * self->page_size);
+
+	ret = tee(self->pipe[0], out[1], spliced, SPLICE_F_NONBLOCK);
+	EXPECT_GT(ret, 0);
+	EXPECT_LE(ret, 2 * self->page_size);
+	ASSERT_EQ(0, ioctl(out[0], FIONREAD, &queued));
+	EXPECT_EQ(ret, queued);
+	ASSERT_EQ(queued, read(out[0], buf, sizeof(buf)));
+	EXPECT_TRUE(check_data(buf, queued, 0));
+
+	/* The tee left the source alone, move it all over now */
+	for (done = 0; done < spliced; done += ret) {
+		ret = splice(self->pipe[0], NULL, out[1], NULL, spliced - done,
+			     SPLICE_F_NONBLOCK);
+		ASSERT_GT(ret, 0);
+		ASSERT_EQ(0, ioctl(out[0], FIONREAD, &queued));
+		EXPECT_LE(queued, 2 * self->page_size);
+		ASSERT_EQ(ret, read(out[0], buf, sizeof(buf)));
+		ASSERT_TRUE(check_data(buf, ret, done))
+			TH_LOG("bad data at offset %zu", done);
+	}
+
+	close(out[0]);
+	close(out[1]);
+}
+
+TEST_HARNESS_MAIN
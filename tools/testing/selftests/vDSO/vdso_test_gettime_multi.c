@@ -0,0 +1,99 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * vdso_test_gettime_multi.c: Check __vdso_clock_gettime_multi() against
+ * clock_gettime() and compare the cost of one batched read with reading
+ * the clocks one by one.
+ */
+
+#define _GNU_SOURCE
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/auxv.h>
+#include <time.h>
+
+#include "../kselftest.h"
+#include "parse_vdso.h"
+
+#define LOOPS	1000000
+
+typedef int (*gettime_multi_t)(const clockid_t *clocks, struct timespec *ts,
+			       unsigned int nr);
+
+static const clockid_t clocks[] = {
+	CLOCK_REALTIME, CLOCK_MONOTONIC, CLOCK_MONOTONIC_RAW, CLOCK_BOOTTIME,
+	CLOCK_TAI, CLOCK_REALTIME_COARSE, CLOCK_MONOTONIC_COARSE,
+	/* Not handled in the vDSO, needs the fallback */
+	CLOCK_PROCESS_CPUTIME_ID,
+};
+
+#define NR_CLOCKS	(sizeof(clocks) / sizeof(clocks[0]))
+
+static long long ts_ns(const struct timespec *ts)
+{
+	return ts->tv_sec * 1000000000LL + ts->tv_nsec;
+}
+
+static double elapsed_ns(const struct timespec *start, const struct timespec *end)
+{
+	return ts_ns(end) - ts_ns(start);
+}
+
+int main(int argc, char **argv)
+{
+	struct timespec before[NR_CLOCKS], multi[NR_CLOCKS], after[NR_CLOCKS];
+	struct timespec start, end;
+	gettime_multi_t gettime_multi;
+	unsigned long sysinfo_ehdr;
+	unsigned int i, j;
+	double seq, batch;
+
+	sysinfo_ehdr = getauxval(AT_SYSINFO_EHDR);
+	if (!sysinfo_ehdr)
+		ksft_exit_skip("AT_SYSINFO_EHDR is not present!\n");
+
+	vdso_init_from_sysinfo_ehdr(sysinfo_ehdr);
+
+	gettime_multi = (gettime_multi_t)vdso_sym("LINUX_2.6",
+						  "__vdso_clock_gettime_multi");
+	if (!gettime_multi)
+		ksft_exit_skip("Could not find __vdso_clock_gettime_multi\n");
+
+	ksft_print_header();
+	ksft_set_plan(NR_CLOCKS);
+
+	for (i = 0; i < NR_CLOCKS; i++)
+		clock_gettime(clocks[i], &before[i]);
+	if (gettime_multi(clocks, multi, NR_CLOCKS))
+		ksft_exit_fail_msg("__vdso_clock_gettime_multi failed\n");
+	for (i = 0; i < NR_CLOCKS; i++)
+		clock_gettime(clocks[i], &after[i]);
+
+	for (i = 0; i < NR_CLOCKS; i++) {
+		ksft_test_result(multi[i].tv_nsec >= 0 &&
+				 multi[i].tv_nsec < 1000000000 &&
+				 ts_ns(&multi[i]) >= ts_ns(&before[i]) &&
+				 ts_ns(&multi[i]) <= ts_ns(&after[i]),
+				 "clock %d within clock_gettime() bounds\n",
+				 clocks[i]);
+	}
+
+	/* Leave out the clock which is not handled in the vDSO */
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (j = 0; j < LOOPS; j++) {
+		for (i = 0; i < NR_CLOCKS - 1; i++)
+			clock_gettime(clocks[i], &multi[i]);
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	seq = elapsed_ns(&start, &end) / LOOPS;
+
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	for (j = 0; j < LOOPS; j++)
+		gettime_multi(clocks, multi, NR_CLOCKS - 1);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	batch = elapsed_ns(&start, &end) / LOOPS;
+
+	ksft_print_msg("%u clocks: %.1f ns one by one, %.1f ns batched\n",
+		       (unsigned int)NR_CLOCKS - 1, seq, batch);
+
+	ksft_finished();
+}
@@ -20,6 +20,7 @@
 int runcycles = 10000000;
 int max_outstanding = INT_MAX;
 int batch = 1;
+int get_batch = 1;
 int param = 0;
 
 bool do_sleep = false;
@@ -97,6 +98,18 @@ void set_affinity(const char *arg)
 	assert(!ret);
 }
 
+/* Rings without a batched implementation get one buffer at a time. */
+unsigned __attribute__((weak)) get_buf_batch(unsigned *lens, void **bufs,
+					     unsigned max)
+{
+	unsigned i;
+
+	for (i = 0; i < max; i++)
+		if (!get_buf(&lens[i], &bufs[i]))
+			break;
+	return i;
+}
+
 void poll_used(void)
 {
 	while (used_empty())
@@ -111,8 +124,8 @@ static void __attribute__((__flatten__)) run_guest(void)
 	int bufs = runcycles;
 	int spurious = 0;
 	int r;
-	unsigned len;
-	void *buf;
+	unsigned len, batch_lens[get_batch];
+	void *buf, *batch_bufs[get_batch];
 	int tokick = batch;
 
 	for (;;) {
@@ -136,7 +149,17 @@ static void __attribute__((__flatten__)) run_guest(void)
 				r = -1;
 
 			/* Flush out completed bufs if any */
-			if (get_buf(&len, &buf)) {
+			if (get_batch > 1) {
+				unsigned n = get_buf_batch(batch_lens, batch_bufs,
+							   get_batch);
+
+				if (n) {
+					completed += n;
+					if (__builtin_expect(completed == bufs, false))
+						return;
+					r = 0;
+				}
+			} else if (get_buf(&len, &buf)) {
 				++completed;
 				if (__builtin_expect(completed == bufs, false))
 					return;
@@ -247,6 +270,11 @@ static const struct option longopts[] = {
 		.has_arg = required_argument,
 		.val = 'b',
 	},
+	{
+		.name = "get-batch",
+		.has_arg = required_argument,
+		.val = 'g',
+	},
 	{
 		.name = "param",
 		.has_arg = required_argument,
@@ -279,6 +307,7 @@ static void help(void)
 		" [--ring-size R (default: %d)]"
 		" [--run-cycles C (default: %d)]"
 		" [--batch b]"
+		" [--get-batch g]"
 		" [--outstanding o]"
 		" [--param p]"
 		" [--sleep]"
@@ -347,6 +376,12 @@ int main(int argc, char **argv)
 			assert(c > 0 && c < INT_MAX);
 			batch = c;
 			break;
+		case 'g':
+			c = strtol(optarg, &endptr, 0);
+			assert(!*endptr);
+			assert(c > 0 && c <= 1024);
+			get_batch = c;
+			break;
 		case 's':
 			do_sleep = true;
 			break;
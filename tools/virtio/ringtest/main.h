@@ -68,6 +68,7 @@ void alloc_ring(void);
 /* guest side */
 int add_inbuf(unsigned, void *, void *);
 void *get_buf(unsigned *, void **);
+unsigned get_buf_batch(unsigned *, void **, unsigned);
 void disable_call();
 bool used_empty();
 bool enable_call();
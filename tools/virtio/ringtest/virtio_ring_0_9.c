@@ -194,6 +194,54 @@ void *get_buf(unsigned *lenp, void **bufp)
 	return datap;
 }
 
+/*
+ * Get up to max used buffers, reading used->idx and issuing the barrier
+ * once for the whole batch instead of once per buffer.
+ */
+unsigned get_buf_batch(unsigned *lens, void **bufs, unsigned max)
+{
+#ifdef RING_POLL
+	unsigned i;
+
+	/* Every entry carries its own valid bit, there is nothing to share. */
+	for (i = 0; i < max; i++)
+		if (!get_buf(&lens[i], &bufs[i]))
+			break;
+	return i;
+#else
+	unsigned short used_idx = ring.used->idx;
+	unsigned short n = used_idx - guest.last_used_idx;
+	unsigned head, index, i;
+
+	if (!n)
+		return 0;
+	if (n > max)
+		n = max;
+	/* Barrier B (for pairing) */
+	smp_acquire();
+
+	for (i = 0; i < n; i++) {
+		head = (ring_size - 1) & guest.last_used_idx;
+#ifdef INORDER
+		index = head;
+		lens[i] = ring.desc[index].len;
+#else
+		index = ring.used->ring[head].id;
+		lens[i] = ring.used->ring[head].len;
+#endif
+		bufs[i] = (void *)(unsigned long)ring.desc[index].addr;
+		data[index].data = NULL;
+#ifndef INORDER
+		ring.desc[index].next = guest.free_head;
+		guest.free_head = index;
+#endif
+		guest.last_used_idx++;
+	}
+	guest.num_free += n;
+	return n;
+#endif
+}
+
 bool used_empty()
 {
 	unsigned short last_used_idx = guest.last_used_idx;
@@ -68,14 +68,11 @@ static int kvm_gmem_prepare_folio(struct kvm *kvm, struct kvm_memory_slot *slot,
 	 * Preparing huge folios should always be safe, since it should
 	 * be possible to split them later if needed.
 	 *
-	 * Right now the folio order is always going to be zero, but the
-	 * code is ready for huge folios.  The only assumption is that
-	 * the base pgoff of memslots is naturally aligned with the
-	 * requested page order, ensuring that huge folios can also use
-	 * huge page table entries for GPA->HPA mapping.
-	 *
-	 * The order will be passed when creating the guest_memfd, and
-	 * checked when creating memslots.
+	 * The only assumption is that the base pgoff of memslots is
+	 * naturally aligned with the folio order, ensuring that huge
+	 * folios can also use huge page table entries for GPA->HPA
+	 * mapping.  This is checked by kvm_gmem_bind() for guest_memfds
+	 * that allow huge pages.
 	 */
 	WARN_ON(!IS_ALIGNED(slot->gmem.pgoff, 1 << folio_order(folio)));
 	index = gfn - slot->base_gfn + slot->gmem.pgoff;
@@ -96,9 +93,56 @@ static int kvm_gmem_prepare_folio(struct kvm *kvm, struct kvm_memory_slot *slot,
  * Ignore accessed, referenced, and dirty flags.  The memory is
  * unevictable and there is no storage to write back to.
  */
-static struct folio *kvm_gmem_get_folio(struct inode *inode, pgoff_t index)
+static struct folio *kvm_gmem_get_huge_folio(struct inode *inode, pgoff_t index)
+{
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	unsigned long huge_index = round_down(index, HPAGE_PMD_NR);
+	unsigned long flags = (unsigned long)inode->i_private;
+	struct address_space *mapping = inode->i_mapping;
+	gfp_t gfp = mapping_gfp_mask(mapping);
+	struct folio *folio;
+
+	if (!(flags & KVM_GUEST_MEMFD_ALLOW_HUGEPAGE))
+		return NULL;
+
+	if (filemap_range_has_page(mapping, (loff_t)huge_index << PAGE_SHIFT,
+				   ((loff_t)(huge_index + HPAGE_PMD_NR) << PAGE_SHIFT) - 1))
+		return NULL;
+
+	folio = filemap_alloc_folio(gfp | __GFP_NORETRY | __GFP_NOWARN,
+				    HPAGE_PMD_ORDER);
+	if (!folio)
+		return NULL;
+
+	if (filemap_add_folio(mapping, folio, huge_index, gfp)) {
+		folio_put(folio);
+		return NULL;
+	}
+
+	/*
+	 * A clean large folio that cannot be split when part of it is
+	 * punched out, e.g. on conversion to shared, is truncated as a
+	 * whole.  Keep it dirty so that truncation leaves it in place
+	 * instead of discarding the rest of the guest's private memory.
+	 */
+	folio_mark_dirty(folio);
+	return folio;
+#else
+	return NULL;
+#endif
+}
+
+static struct folio *kvm_gmem_get_folio(struct inode *inode, pgoff_t index,
+					bool allow_huge)
 {
-	/* TODO: Support huge pages. */
+	struct folio *folio;
+
+	if (allow_huge) {
+		folio = kvm_gmem_get_huge_folio(inode, index);
+		if (folio)
+			return folio;
+	}
+
 	return filemap_grab_folio(inode->i_mapping, index);
 }
 
@@ -199,7 +243,7 @@ static long kvm_gmem_allocate(struct inode *inode, loff_t offset, loff_t len)
 			break;
 		}
 
-		folio = kvm_gmem_get_folio(inode, index);
+		folio = kvm_gmem_get_folio(inode, index, true);
 		if (IS_ERR(folio)) {
 			r = PTR_ERR(folio);
 			break;
@@ -429,6 +473,8 @@ static int __kvm_gmem_create(struct kvm *kvm, loff_t size, u64 flags)
 	inode->i_size = size;
 	mapping_set_gfp_mask(inode->i_mapping, GFP_HIGHUSER);
 	mapping_set_inaccessible(inode->i_mapping);
+	if (flags & KVM_GUEST_MEMFD_ALLOW_HUGEPAGE)
+		mapping_set_large_folios(inode->i_mapping);
 	/* Unmovable mappings are supposed to be marked unevictable as well. */
 	WARN_ON_ONCE(!mapping_unevictable(inode->i_mapping));
 
@@ -453,12 +499,21 @@ int kvm_gmem_create(struct kvm *kvm, struct kvm_create_guest_memfd *args)
 	u64 flags = args->flags;
 	u64 valid_flags = 0;
 
+	if (IS_ENABLED(CONFIG_TRANSPARENT_HUGEPAGE))
+		valid_flags |= KVM_GUEST_MEMFD_ALLOW_HUGEPAGE;
+
 	if (flags & ~valid_flags)
 		return -EINVAL;
 
 	if (size <= 0 || !PAGE_ALIGNED(size))
 		return -EINVAL;
 
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	if ((flags & KVM_GUEST_MEMFD_ALLOW_HUGEPAGE) &&
+	    !IS_ALIGNED(size, HPAGE_PMD_SIZE))
+		return -EINVAL;
+#endif
+
 	return __kvm_gmem_create(kvm, size, flags);
 }
 
@@ -491,6 +546,16 @@ int kvm_gmem_bind(struct kvm *kvm, struct kvm_memory_slot *slot,
 	    offset + size > i_size_read(inode))
 		goto err;
 
+#ifdef CONFIG_TRANSPARENT_HUGEPAGE
+	/*
+	 * A huge folio is prepared and mapped as a whole, so it must not be
+	 * shared between memslots or stick out of one.
+	 */
+	if (((unsigned long)inode->i_private & KVM_GUEST_MEMFD_ALLOW_HUGEPAGE) &&
+	    (!IS_ALIGNED(offset, HPAGE_PMD_SIZE) || !IS_ALIGNED(size, HPAGE_PMD_SIZE)))
+		goto err;
+#endif
+
 	filemap_invalidate_lock(inode->i_mapping);
 
 	start = offset >> PAGE_SHIFT;
@@ -554,7 +619,7 @@ void kvm_gmem_unbind(struct kvm_memory_slot *slot)
 static struct folio *
 __kvm_gmem_get_pfn(struct file *file, struct kvm_memory_slot *slot,
 		   gfn_t gfn, kvm_pfn_t *pfn, bool *is_prepared,
-		   int *max_order)
+		   bool allow_huge, int *max_order)
 {
 	pgoff_t index = gfn - slot->base_gfn + slot->gmem.pgoff;
 	struct kvm_gmem *gmem = file->private_data;
@@ -571,7 +636,7 @@ __kvm_gmem_get_pfn(struct file *file, struct kvm_memory_slot *slot,
 		return ERR_PTR(-EIO);
 	}
 
-	folio = kvm_gmem_get_folio(file_inode(file), index);
+	folio = kvm_gmem_get_folio(file_inode(file), index, allow_huge);
 	if (IS_ERR(folio))
 		return folio;
 
@@ -582,8 +647,18 @@ __kvm_gmem_get_pfn(struct file *file, struct kvm_memory_slot *slot,
 	}
 
 	*pfn = folio_file_pfn(folio, index);
-	if (max_order)
-		*max_order = 0;
+	if (max_order) {
+		/*
+		 * The folio can be mapped huge only if the gfn and the file
+		 * offset are equally aligned within it, and only from an
+		 * index that is aligned to the mapping size.
+		 */
+		if (IS_ALIGNED(gfn - index, folio_nr_pages(folio)))
+			*max_order = min_t(int, folio_order(folio),
+					   index ? __ffs(index) : folio_order(folio));
+		else
+			*max_order = 0;
+	}
 
 	*is_prepared = folio_test_uptodate(folio);
 	return folio;
@@ -600,7 +675,7 @@ int kvm_gmem_get_pfn(struct kvm *kvm, struct kvm_memory_slot *slot,
 	if (!file)
 		return -EFAULT;
 
-	folio = __kvm_gmem_get_pfn(file, slot, gfn, pfn, &is_prepared, max_order);
+	folio = __kvm_gmem_get_pfn(file, slot, gfn, pfn, &is_prepared, true, max_order);
 	if (IS_ERR(folio)) {
 		r = PTR_ERR(folio);
 		goto out;
@@ -656,7 +731,13 @@ long kvm_gmem_populate(struct kvm *kvm, gfn_t start_gfn, void __user *src, long
 			break;
 		}
 
-		folio = __kvm_gmem_get_pfn(file, slot, gfn, &pfn, &is_prepared, &max_order);
+		/*
+		 * Preparedness is tracked per folio, so only allocate small
+		 * folios here; populating part of a huge one would make the
+		 * rest of it look prepared as well.
+		 */
+		folio = __kvm_gmem_get_pfn(file, slot, gfn, &pfn, &is_prepared,
+					   false, &max_order);
 		if (IS_ERR(folio)) {
 			ret = PTR_ERR(folio);
 			break;
@@ -670,17 +751,20 @@ long kvm_gmem_populate(struct kvm *kvm, gfn_t start_gfn, void __user *src, long
 		}
 
 		folio_unlock(folio);
-		WARN_ON(!IS_ALIGNED(gfn, 1 << max_order) ||
-			(npages - i) < (1 << max_order));
 
+		/*
+		 * A huge folio that already exists, e.g. one allocated by
+		 * fallocate(), can only be populated as a whole.
+		 */
 		ret = -EINVAL;
-		while (!kvm_range_has_memory_attributes(kvm, gfn, gfn + (1 << max_order),
-							KVM_MEMORY_ATTRIBUTE_PRIVATE,
-							KVM_MEMORY_ATTRIBUTE_PRIVATE)) {
-			if (!max_order)
-				goto put_folio_and_exit;
-			max_order--;
-		}
+		if (max_order != folio_order(folio) ||
+		    (npages - i) < (1 << max_order))
+			goto put_folio_and_exit;
+
+		if (!kvm_range_has_memory_attributes(kvm, gfn, gfn + (1 << max_order),
+						     KVM_MEMORY_ATTRIBUTE_PRIVATE,
+						     KVM_MEMORY_ATTRIBUTE_PRIVATE))
+			goto put_folio_and_exit;
 
 		p = src ? src + i * PAGE_SIZE : NULL;
 		ret = post_populate(kvm, gfn, pfn, p, max_order, opaque);